@@ -15,6 +15,11 @@ check_struct_has_member("struct __res_state" _u._ext.nsaddrs "netinet/in.h;resol
 
 check_symbol_exists(MSG_NOSIGNAL "sys/socket.h" HAVE_MSG_NOSIGNAL)
 
+# --- reactor backend checks --------------------------------------------------
+
+check_symbol_exists(epoll_create1 "sys/epoll.h" HAVE_EPOLL)
+check_symbol_exists(kqueue "sys/types.h;sys/event.h;sys/time.h" HAVE_KQUEUE)
+
 # --- std::format availability ------------------------------------------------
 
 check_cxx_source_compiles(
@@ -110,13 +110,11 @@ namespace {
 DEFINE_DRIVER_FACTORY(AlibabaCloudDriver)
 
 // =============================================================================
-//  AlibabaCloudDriver::generate_request
+//  AlibabaCloudDriver::build_request
 // =============================================================================
 
-DriverRequestContext AlibabaCloudDriver::generate_request(const DriverConfig &config,
-                                                          const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<AlibabaParams>(config);
-
+DriverRequestContext AlibabaCloudDriver::build_request(const AlibabaParams &cfg,
+                                                       const DriverUpdateParams &ctx) const {
     auto ttl = cfg.ttl.value_or(600);
 
     // Build the common parameters (all RPC requests include these).
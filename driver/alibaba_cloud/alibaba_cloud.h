@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_ALIBABA_CLOUD_ALIBABA_CLOUD_H
 #define YADDNSC_DRV_ALIBABA_CLOUD_ALIBABA_CLOUD_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// Alibaba Cloud DNS (Alidns) driver for updating A and AAAA records.
@@ -17,13 +18,13 @@
 ///
 /// Signing:
 ///   https://www.alibabacloud.com/help/en/sdk/request-signature
-class AlibabaCloudDriver final : public BaseDriver {
+class AlibabaCloudDriver final : public TypedDriver<AlibabaParams> {
 public:
     ~AlibabaCloudDriver() override = default;
 
     /// Build an Alibaba Cloud DNS UpdateDomainRecord request with RPC signature.
-    [[nodiscard]] DriverRequestContext generate_request(
-        const DriverConfig &config, const DriverUpdateParams &ctx
+    [[nodiscard]] DriverRequestContext build_request(
+        const AlibabaParams &cfg, const DriverUpdateParams &ctx
     ) const override;
 
     /// Validate the Alibaba Cloud DNS API response.
@@ -3,6 +3,10 @@
 //
 #include "cloudflare.h"
 
+#include <map>
+#include <string_view>
+#include <utility>
+
 #include "fmt.hpp"
 #include "config.hpp"
 #include "response.hpp"
@@ -11,13 +15,22 @@
 
 namespace {
     constexpr std::string_view API_URL = "https://api.cloudflare.com/client/v4/zones/{ZONE_ID}/dns_records/{RECORD_ID}";
+    constexpr std::string_view BATCH_API_URL = "https://api.cloudflare.com/client/v4/zones/{ZONE_ID}/dns_records/batch";
+
+    void log_errors(const std::vector<CloudflareErrorDetail> &errors) {
+        for (const auto &error: errors) {
+            if (error.source.has_value()) {
+                CORE_LOG_ERROR("Cloudflare API error ({}): {} [{}]", error.code, error.message, error.source->pointer);
+            } else {
+                CORE_LOG_ERROR("Cloudflare API error ({}): {}", error.code, error.message);
+            }
+        }
+    }
 }
 
 DEFINE_DRIVER_FACTORY(CloudflareDriver)
 
-DriverRequestContext CloudflareDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<CloudflareParams>(config);
-
+DriverRequestContext CloudflareDriver::build_request(const CloudflareParams &cfg, const DriverUpdateParams &ctx) const {
     auto url = fmt::format(API_URL, fmt::arg("ZONE_ID", cfg.zone_id), fmt::arg("RECORD_ID", cfg.record_id));
 
     DriverRequest request{};
@@ -40,13 +53,7 @@ bool CloudflareDriver::check_response(const HttpResponse &response) const {
 
     auto &resp = result.value();
     if (!resp.success) {
-        for (const auto &error: resp.errors) {
-            if (error.source.has_value()) {
-                CORE_LOG_ERROR("Cloudflare API error ({}): {} [{}]", error.code, error.message, error.source->pointer);
-            } else {
-                CORE_LOG_ERROR("Cloudflare API error ({}): {}", error.code, error.message);
-            }
-        }
+        log_errors(resp.errors);
         return false;
     }
 
@@ -68,6 +75,102 @@ DriverDetail CloudflareDriver::get_detail() const noexcept {
     };
 }
 
+std::vector<bool> CloudflareDriver::execute_typed_batch(std::span<const TypedItem> items, HttpClient &http) const {
+    std::vector<bool> results(items.size(), false);
+
+    // The batch endpoint is per zone, and the token must be valid for that zone,
+    // so items are grouped by (zone_id, token) and each group is one request.
+    std::map<std::pair<std::string_view, std::string_view>, std::vector<std::size_t>> zones;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const auto &cfg = items[i].params;
+        zones[{cfg.zone_id, cfg.token}].push_back(i);
+    }
+
+    for (const auto &[zone, indices]: zones) {
+        if (indices.size() == 1) {
+            const auto &item = items[indices.front()];
+            results[indices.front()] = execute_typed(item.params, item.ctx, http);
+            continue;
+        }
+
+        std::vector<TypedItem> zone_items;
+        zone_items.reserve(indices.size());
+        for (const auto idx: indices) {
+            zone_items.push_back(items[idx]);
+        }
+
+        const auto [url, request] = generate_batch_request(zone_items);
+        CORE_LOG_DEBUG("Sending batch update of {} records for zone {}", indices.size(), zone.first);
+
+        const auto response = http.exchange(url, request);
+        if (!response) {
+            CORE_LOG_WARN("Batch update of zone {} failed (HTTP error: {})", zone.first, response.error());
+            continue;
+        }
+
+        // The batch is applied atomically: either every record changed or none did.
+        const auto accepted = check_batch_response(*response);
+        for (const auto idx: indices) {
+            results[idx] = accepted;
+        }
+    }
+
+    return results;
+}
+
+DriverRequestContext CloudflareDriver::generate_batch_request(std::span<const TypedItem> items) {
+    const auto &head = items.front().params;
+    auto url = fmt::format(BATCH_API_URL, fmt::arg("ZONE_ID", head.zone_id));
+
+    CloudflareBatchRequestBody body{};
+    body.puts.reserve(items.size());
+    for (const auto &[cfg, ctx]: items) {
+        body.puts.push_back(CloudflareBatchRecord{
+            .id = cfg.record_id,
+            .type = ctx.rd_type,
+            .name = ctx.subdomain,
+            .content = ctx.ip_addr,
+            .ttl = cfg.ttl.value_or(30),
+            .proxied = cfg.proxied.value_or(false)
+        });
+    }
+
+    DriverRequest request{};
+    request.headers.insert({"Authorization", fmt::format("Bearer {}", head.token)});
+    request.body = glz::write_json(body).value_or("{}");
+    request.content_type = "application/json";
+    request.method = DriverHttpMethod::POST;
+
+    return {std::move(url), std::move(request)};
+}
+
+bool CloudflareDriver::check_batch_response(const HttpResponse &response) {
+    CORE_LOG_TRACE("Got {} from server.", response.body);
+
+    // The batch result also carries empty deletes/patches/posts arrays and
+    // record metadata we do not model, so unknown keys are tolerated here.
+    CloudflareBatchResponse resp{};
+    const auto ec = glz::read<glz::opts{.error_on_unknown_keys = false}>(resp, response.body);
+    if (ec != glz::error_code::none) {
+        CORE_LOG_ERROR("Failed to parse Cloudflare batch API response");
+        return false;
+    }
+
+    if (!resp.success) {
+        log_errors(resp.errors);
+        return false;
+    }
+
+    if (resp.result.has_value()) {
+        for (const auto &record: resp.result->puts) {
+            CORE_LOG_DEBUG("DNS record updated successfully: {} {} -> {} (TTL: {}, proxied: {})", record.type,
+                           record.name, record.content, record.ttl, record.proxied ? "yes" : "no");
+        }
+    }
+
+    return true;
+}
+
 std::string CloudflareDriver::generate_body(const CloudflareParams &cfg, const DriverUpdateParams &ctx) {
     auto body = CloudflareRequestBody{
         .type = ctx.rd_type,
@@ -5,19 +5,24 @@
 #ifndef YADDNSC_DRV_CLOUDFLARE_CLOUDFLARE_H
 #define YADDNSC_DRV_CLOUDFLARE_CLOUDFLARE_H
 
+#include <cstddef>
+#include <span>
+#include <vector>
+
 #include "config.hpp"
 #include "driver/base.h"
 
 /// Cloudflare API driver for DNS record updates.
 ///
 /// Implements the Cloudflare API v4 for updating A, AAAA, and TXT records
-/// via their DNS Records endpoint.
-class CloudflareDriver final : public BaseDriver {
+/// via their DNS Records endpoint.  Batched updates use the batch DNS
+/// records endpoint, which applies every change of a zone in one transaction.
+class CloudflareDriver final : public TypedDriver<CloudflareParams> {
 public:
     ~CloudflareDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const CloudflareParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the Cloudflare API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
@@ -25,9 +30,20 @@ public:
     /// Return static metadata about this driver.
     [[nodiscard]] DriverDetail get_detail() const noexcept override;
 
+    /// Update all records of the same zone (and token) with one batch request.
+    [[nodiscard]] std::vector<bool> execute_typed_batch(std::span<const TypedItem> items,
+                                                        HttpClient &http) const override;
+
 private:
     /// Build the JSON request body for a Cloudflare DNS record update.
     static std::string generate_body(const CloudflareParams &cfg, const DriverUpdateParams &ctx);
+
+    /// Build the batch request overwriting the given records of one zone.
+    /// @param items  Records to update; all share zone_id and token.
+    [[nodiscard]] static DriverRequestContext generate_batch_request(std::span<const TypedItem> items);
+
+    /// Validate the batch API response.
+    [[nodiscard]] static bool check_batch_response(const HttpResponse &response);
 };
 
 #endif //YADDNSC_DRV_CLOUDFLARE_CLOUDFLARE_H
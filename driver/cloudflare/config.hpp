@@ -6,6 +6,7 @@
 #define YADDNSC_DRV_CLOUDFLARE_CONFIG_HPP
 
 #include <string>
+#include <vector>
 #include <glaze/glaze.hpp>
 
 /// Cloudflare API driver configuration parameters.
@@ -26,6 +27,24 @@ struct CloudflareRequestBody {
     bool proxied;        ///< Whether proxied through Cloudflare
 };
 
+/// One record of a Cloudflare batch request (`puts` entry).
+struct CloudflareBatchRecord {
+    std::string id;      ///< DNS Record ID to overwrite
+    std::string type;    ///< DNS record type (A, AAAA, TXT, etc.)
+    std::string name;    ///< Full domain name
+    std::string content; ///< Record value (IP address, etc.)
+    int ttl;             ///< Time-to-live in seconds
+    bool proxied;        ///< Whether proxied through Cloudflare
+};
+
+/// Cloudflare batch DNS records request body.
+///
+/// Only `puts` is used: every entry overwrites an existing record, matching
+/// the PUT semantics of the single-record endpoint.
+struct CloudflareBatchRequestBody {
+    std::vector<CloudflareBatchRecord> puts; ///< Records to overwrite
+};
+
 template<>
 struct glz::meta<CloudflareParams> {
     using T = CloudflareParams;
@@ -50,4 +69,25 @@ struct glz::meta<CloudflareRequestBody> {
     );
 };
 
+template<>
+struct glz::meta<CloudflareBatchRecord> {
+    using T = CloudflareBatchRecord;
+    static constexpr auto value = object(
+        "id", &T::id,
+        "type", &T::type,
+        "name", &T::name,
+        "content", &T::content,
+        "ttl", &T::ttl,
+        "proxied", &T::proxied
+    );
+};
+
+template<>
+struct glz::meta<CloudflareBatchRequestBody> {
+    using T = CloudflareBatchRequestBody;
+    static constexpr auto value = object(
+        "puts", &T::puts
+    );
+};
+
 #endif // YADDNSC_DRV_CLOUDFLARE_CONFIG_HPP
@@ -54,6 +54,19 @@ struct CloudflareResponse {
     std::optional<CloudflareDnsRecord> result;     ///< DNS record data (present on success)
 };
 
+/// Result section of a batch DNS records response.
+struct CloudflareBatchResult {
+    std::vector<CloudflareDnsRecord> puts; ///< Records overwritten by the batch
+};
+
+/// Top-level Cloudflare batch DNS records response.
+struct CloudflareBatchResponse {
+    bool success = false;                          ///< Whether the whole batch was applied
+    std::vector<CloudflareErrorDetail> errors;     ///< Error details
+    std::vector<CloudflareMessage> messages;       ///< Informational messages
+    std::optional<CloudflareBatchResult> result;   ///< Applied records (present on success)
+};
+
 template<>
 struct glz::meta<CloudflareSource> {
     using T = CloudflareSource;
@@ -112,4 +125,23 @@ struct glz::meta<CloudflareResponse> {
     );
 };
 
+template<>
+struct glz::meta<CloudflareBatchResult> {
+    using T = CloudflareBatchResult;
+    static constexpr auto value = object(
+        "puts", &T::puts
+    );
+};
+
+template<>
+struct glz::meta<CloudflareBatchResponse> {
+    using T = CloudflareBatchResponse;
+    static constexpr auto value = object(
+        "success", &T::success,
+        "errors", &T::errors,
+        "messages", &T::messages,
+        "result", &T::result
+    );
+};
+
 #endif // YADDNSC_DRV_CLOUDFLARE_RESPONSE_H
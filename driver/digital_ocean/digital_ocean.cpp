@@ -16,9 +16,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY(DigitalOceanDriver)
 
-DriverRequestContext DigitalOceanDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<DigitalOceanParams>(config);
-
+DriverRequestContext DigitalOceanDriver::build_request(const DigitalOceanParams &cfg, const DriverUpdateParams &ctx) const {
     auto url = fmt::format(API_URL, fmt::arg("DOMAIN", ctx.domain), fmt::arg("RECORD_ID", cfg.record_id));
 
     DriverRequest request{};
@@ -5,18 +5,19 @@
 #ifndef YADDNSC_DRV_DIGITALOCEAN_DIGITALOCEAN_H
 #define YADDNSC_DRV_DIGITALOCEAN_DIGITALOCEAN_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// DigitalOcean API driver for DNS record updates.
 ///
 /// Implements the DigitalOcean API v2 for updating DNS records
 /// via their Domain Records endpoint.
-class DigitalOceanDriver final : public BaseDriver {
+class DigitalOceanDriver final : public TypedDriver<DigitalOceanParams> {
 public:
     ~DigitalOceanDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const DigitalOceanParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the DigitalOcean API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
@@ -45,9 +45,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY (DNSPodDriver)
 
-DriverRequestContext DNSPodDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<DNSPodParams>(config);
-
+DriverRequestContext DNSPodDriver::build_request(const DNSPodParams &cfg, const DriverUpdateParams &ctx) const {
     // record_line: optional, with dynamic default based on global flag
     auto record_line = cfg.record_line.value_or(cfg.global ? "default" : "默认");
 
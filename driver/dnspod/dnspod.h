@@ -5,16 +5,17 @@
 #ifndef YADDNSC_DRV_DNSPOD_DNSPOD_H
 #define YADDNSC_DRV_DNSPOD_DNSPOD_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// DNSPod API driver for DNS record updates.
 ///
 /// Implements the DNSPod API for updating DNS records via their
 /// Record.Modify endpoint.
-class DNSPodDriver final : public BaseDriver {
+class DNSPodDriver final : public TypedDriver<DNSPodParams> {
 public:
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const DNSPodParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the DNSPod API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
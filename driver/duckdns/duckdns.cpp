@@ -17,9 +17,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY(DuckDnsDriver)
 
-DriverRequestContext DuckDnsDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<DuckDnsParams>(config);
-
+DriverRequestContext DuckDnsDriver::build_request(const DuckDnsParams &cfg, const DriverUpdateParams &ctx) const {
     // Use ipv6 param for AAAA records, ip param for A records
     auto ip_param = (ctx.rd_type == "AAAA") ? "ipv6" : "ip";
 
@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_DUCKDNS_DUCKDNS_H
 #define YADDNSC_DRV_DUCKDNS_DUCKDNS_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// DuckDNS API driver for DDNS record updates.
@@ -13,12 +14,12 @@
 /// via their simple GET-based update endpoint.
 ///
 /// API reference: https://www.duckdns.org/spec.jsp
-class DuckDnsDriver final : public BaseDriver {
+class DuckDnsDriver final : public TypedDriver<DuckDnsParams> {
 public:
     ~DuckDnsDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const DuckDnsParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the DuckDNS API response (expects "OK" or "KO").
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
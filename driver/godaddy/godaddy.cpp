@@ -34,9 +34,7 @@ struct glz::meta<GoDaddyRecordBody> {
 
 DEFINE_DRIVER_FACTORY(GoDaddyDriver)
 
-DriverRequestContext GoDaddyDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<GoDaddyParams>(config);
-
+DriverRequestContext GoDaddyDriver::build_request(const GoDaddyParams &cfg, const DriverUpdateParams &ctx) const {
     auto url = fmt::format(API_URL,
                            fmt::arg("DOMAIN", ctx.domain),
                            fmt::arg("TYPE", ctx.rd_type),
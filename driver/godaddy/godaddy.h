@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_GODADDY_GODADDY_H
 #define YADDNSC_DRV_GODADDY_GODADDY_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// GoDaddy API driver for DNS record updates.
@@ -13,12 +14,12 @@
 /// via their record replacement endpoint.
 ///
 /// API reference: https://developer.godaddy.com/doc/endpoint/domains
-class GoDaddyDriver final : public BaseDriver {
+class GoDaddyDriver final : public TypedDriver<GoDaddyParams> {
 public:
     ~GoDaddyDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const GoDaddyParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the GoDaddy API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
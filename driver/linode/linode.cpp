@@ -16,9 +16,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY(LinodeDriver)
 
-DriverRequestContext LinodeDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<LinodeParams>(config);
-
+DriverRequestContext LinodeDriver::build_request(const LinodeParams &cfg, const DriverUpdateParams &ctx) const {
     auto url = fmt::format(API_URL,
                            fmt::arg("DOMAIN_ID", cfg.domain_id),
                            fmt::arg("RECORD_ID", cfg.record_id));
@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_LINODE_LINODE_H
 #define YADDNSC_DRV_LINODE_LINODE_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// Linode API v4 driver for DNS record updates.
@@ -13,12 +14,12 @@
 /// via their domain records endpoint.
 ///
 /// API reference: https://techdocs.akamai.com/linode-api/reference/put-domain-record
-class LinodeDriver final : public BaseDriver {
+class LinodeDriver final : public TypedDriver<LinodeParams> {
 public:
     ~LinodeDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const LinodeParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the Linode API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
@@ -22,11 +22,11 @@ constexpr std::string_view API_URL = "https://dynamicdns.park-your-domain.com/up
 DEFINE_DRIVER_FACTORY(NamecheapDriver)
 
 // =============================================================================
-//  NamecheapDriver::generate_request
+//  NamecheapDriver::build_request
 // =============================================================================
 
-DriverRequestContext NamecheapDriver::generate_request(const DriverConfig& config,
-                                                       const DriverUpdateParams& ctx) const {
+DriverRequestContext NamecheapDriver::build_request(const NamecheapParams& cfg,
+                                                    const DriverUpdateParams& ctx) const {
     // Namecheap DDNS only supports A records.
     if (ctx.rd_type == "AAAA") {
         throw ParamParseException(
@@ -35,8 +35,6 @@ DriverRequestContext NamecheapDriver::generate_request(const DriverConfig& confi
                         ctx.fqdn));
     }
 
-    auto cfg = parse_config<NamecheapParams>(config);
-
     // Build URL:
     //   https://dynamicdns.park-your-domain.com/update
     //   ?host=HOST&domain=DOMAIN&password=PASS&ip=IP
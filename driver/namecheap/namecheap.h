@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_NAMECHEAP_NAMECHEAP_H
 #define YADDNSC_DRV_NAMECHEAP_NAMECHEAP_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// Namecheap Dynamic DNS driver for updating A records.
@@ -15,7 +16,7 @@
 ///
 /// API reference:
 ///   https://www.namecheap.com/support/knowledgebase/article.aspx/29/11/how-to-configure-your-dns-dynamic-dns-update-url/
-class NamecheapDriver final : public BaseDriver {
+class NamecheapDriver final : public TypedDriver<NamecheapParams> {
 public:
     ~NamecheapDriver() override = default;
 
@@ -23,8 +24,8 @@ public:
     ///
     /// @throws ParamParseException  When attempting to update an AAAA record
     ///                              (unsupported by the Namecheap DDNS API).
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig& config,
-                                                        const DriverUpdateParams& ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const NamecheapParams& cfg,
+                                                     const DriverUpdateParams& ctx) const override;
 
     /// Validate the Namecheap API response XML using libxml2.
     [[nodiscard]] bool check_response(const HttpResponse& response) const override;
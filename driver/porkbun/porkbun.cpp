@@ -16,9 +16,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY(PorkbunDriver)
 
-DriverRequestContext PorkbunDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<PorkbunParams>(config);
-
+DriverRequestContext PorkbunDriver::build_request(const PorkbunParams &cfg, const DriverUpdateParams &ctx) const {
     // Porkbun's editByNameType uses subdomain (not FQDN). Empty subdomain for root domain.
     auto subdomain = (ctx.subdomain == "@" || ctx.subdomain.empty()) ? "" : ctx.subdomain;
 
@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_PORKBUN_PORKBUN_H
 #define YADDNSC_DRV_PORKBUN_PORKBUN_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// Porkbun API v3 driver for DNS record updates.
@@ -13,12 +14,12 @@
 /// via their edit by name and type endpoint.
 ///
 /// API reference: https://porkbun.com/api/json/v3/documentation
-class PorkbunDriver final : public BaseDriver {
+class PorkbunDriver final : public TypedDriver<PorkbunParams> {
 public:
     ~PorkbunDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const PorkbunParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the Porkbun API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
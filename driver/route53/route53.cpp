@@ -5,8 +5,10 @@
 #include "route53.h"
 
 #include <cstdint>
+#include <map>
 #include <span>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include <libxml/parser.h>
@@ -74,20 +76,82 @@ namespace {
 DEFINE_DRIVER_FACTORY(Route53Driver)
 
 // =============================================================================
-//  Route53Driver::generate_request
+//  Route53Driver::build_request
 // =============================================================================
 
-DriverRequestContext Route53Driver::generate_request(const DriverConfig &config,
-                                                     const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<Route53Params>(config);
-
+DriverRequestContext Route53Driver::build_request(const Route53Params &cfg,
+                                                  const DriverUpdateParams &ctx) const {
     // Route 53 requires the FQDN with a trailing dot.
-    auto fqdn = ensure_trailing_dot(ctx.fqdn);
+    const Change change{
+        .fqdn = ensure_trailing_dot(ctx.fqdn),
+        .rd_type = ctx.rd_type,
+        .ip_addr = ctx.ip_addr,
+        .ttl = cfg.ttl.value_or(300),
+    };
+
+    return build_signed_request(cfg, build_xml_body({&change, 1}));
+}
+
+// =============================================================================
+//  Route53Driver::execute_typed_batch
+// =============================================================================
+
+std::vector<bool> Route53Driver::execute_typed_batch(std::span<const TypedItem> items, HttpClient &http) const {
+    std::vector<bool> results(items.size(), false);
+
+    // A ChangeBatch targets one hosted zone and is signed with one key pair,
+    // so items are grouped by zone + credentials; each group is one request.
+    using ZoneKey = std::tuple<std::string, std::string, std::string, std::string>;
+    std::map<ZoneKey, std::vector<std::size_t>> zones;
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const auto &cfg = items[i].params;
+        zones[{cfg.hosted_zone_id, cfg.region, cfg.access_key_id, cfg.secret_access_key}].push_back(i);
+    }
+
+    for (const auto &[zone, indices]: zones) {
+        if (indices.size() == 1) {
+            const auto &item = items[indices.front()];
+            results[indices.front()] = execute_typed(item.params, item.ctx, http);
+            continue;
+        }
+
+        std::vector<Change> changes;
+        changes.reserve(indices.size());
+        for (const auto idx: indices) {
+            const auto &ctx = items[idx].ctx;
+            changes.push_back({
+                .fqdn = ensure_trailing_dot(ctx.fqdn),
+                .rd_type = ctx.rd_type,
+                .ip_addr = ctx.ip_addr,
+                .ttl = items[idx].params.ttl.value_or(300),
+            });
+        }
+
+        const auto &zone_id = std::get<0>(zone);
+        const auto [url, request] = build_signed_request(items[indices.front()].params, build_xml_body(changes));
+        CORE_LOG_DEBUG("Sending change batch of {} records for hosted zone {}", changes.size(), zone_id);
 
-    // Build the XML request body.
-    auto ttl = cfg.ttl.value_or(300);
-    auto body = build_xml_body(fqdn, ctx.rd_type, ctx.ip_addr, ttl);
+        const auto response = http.exchange(url, request);
+        if (!response) {
+            CORE_LOG_WARN("Change batch for hosted zone {} failed (HTTP error: {})", zone_id, response.error());
+            continue;
+        }
 
+        // Route 53 applies a ChangeBatch atomically: all changes or none.
+        const auto accepted = check_response(*response);
+        for (const auto idx: indices) {
+            results[idx] = accepted;
+        }
+    }
+
+    return results;
+}
+
+// =============================================================================
+//  Route53Driver::build_signed_request
+// =============================================================================
+
+DriverRequestContext Route53Driver::build_signed_request(const Route53Params &cfg, std::string body) {
     // URL path (used for both the request URL and the SigV4 canonical URI).
     constexpr std::string_view URI_PATH_PREFIX = "/2013-04-01/hostedzone/";
     auto url_path = fmt::format("{}{}/rrset", URI_PATH_PREFIX, cfg.hosted_zone_id);
@@ -279,10 +343,7 @@ DriverDetail Route53Driver::get_detail() const noexcept {
 //  Route53Driver::build_xml_body
 // =============================================================================
 
-std::string Route53Driver::build_xml_body(const std::string &fqdn,
-                                          std::string_view rd_type,
-                                          std::string_view ip_addr,
-                                          int ttl) {
+std::string Route53Driver::build_xml_body(std::span<const Change> changes) {
     // Build the UPSERT XML document using libxml2's tree API.
     // This ensures proper XML escaping, namespace handling, and encoding.
     xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
@@ -306,21 +367,24 @@ std::string Route53Driver::build_xml_body(const std::string &fqdn,
 
     // Build the nested element hierarchy.
     xmlNodePtr batch = xmlNewChild(root, ns, BAD_CAST "ChangeBatch", nullptr);
-    xmlNodePtr changes = xmlNewChild(batch, ns, BAD_CAST "Changes", nullptr);
-    xmlNodePtr change = xmlNewChild(changes, ns, BAD_CAST "Change", nullptr);
+    xmlNodePtr changes_node = xmlNewChild(batch, ns, BAD_CAST "Changes", nullptr);
+
+    for (const auto &[fqdn, rd_type, ip_addr, ttl]: changes) {
+        xmlNodePtr change = xmlNewChild(changes_node, ns, BAD_CAST "Change", nullptr);
 
-    xmlNewTextChild(change, ns, BAD_CAST "Action", BAD_CAST "UPSERT");
+        xmlNewTextChild(change, ns, BAD_CAST "Action", BAD_CAST "UPSERT");
 
-    xmlNodePtr rrset = xmlNewChild(change, ns, BAD_CAST "ResourceRecordSet", nullptr);
-    xmlNewTextChild(rrset, ns, BAD_CAST "Name", BAD_CAST fqdn.data());
-    xmlNewTextChild(rrset, ns, BAD_CAST "Type", BAD_CAST rd_type.data());
+        xmlNodePtr rrset = xmlNewChild(change, ns, BAD_CAST "ResourceRecordSet", nullptr);
+        xmlNewTextChild(rrset, ns, BAD_CAST "Name", BAD_CAST fqdn.data());
+        xmlNewTextChild(rrset, ns, BAD_CAST "Type", BAD_CAST rd_type.data());
 
-    auto ttl_str = std::to_string(ttl);
-    xmlNewTextChild(rrset, ns, BAD_CAST "TTL", BAD_CAST ttl_str.data());
+        auto ttl_str = std::to_string(ttl);
+        xmlNewTextChild(rrset, ns, BAD_CAST "TTL", BAD_CAST ttl_str.data());
 
-    xmlNodePtr records = xmlNewChild(rrset, ns, BAD_CAST "ResourceRecords", nullptr);
-    xmlNodePtr record = xmlNewChild(records, ns, BAD_CAST "ResourceRecord", nullptr);
-    xmlNewTextChild(record, ns, BAD_CAST "Value", BAD_CAST ip_addr.data());
+        xmlNodePtr records = xmlNewChild(rrset, ns, BAD_CAST "ResourceRecords", nullptr);
+        xmlNodePtr record = xmlNewChild(records, ns, BAD_CAST "ResourceRecord", nullptr);
+        xmlNewTextChild(record, ns, BAD_CAST "Value", BAD_CAST ip_addr.data());
+    }
 
     // Serialise the document to a string.
     xmlChar *xml_buf = nullptr;
@@ -5,26 +5,33 @@
 #ifndef YADDNSC_DRV_ROUTE53_ROUTE53_H
 #define YADDNSC_DRV_ROUTE53_ROUTE53_H
 
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "config.hpp"
 #include "driver/base.h"
 
 /// AWS Route 53 DNS driver for updating A and AAAA records.
 ///
 /// Implements the Route 53 ChangeResourceRecordSets API using AWS SigV4
 /// request signing for authentication.  Request bodies are XML and responses
-/// are parsed via libxml2.
+/// are parsed via libxml2.  Batched updates put one `Change` per record into
+/// a single ChangeBatch, which Route 53 applies atomically.
 ///
 /// API reference:
 ///   https://docs.aws.amazon.com/Route53/latest/APIReference/API_ChangeResourceRecordSets.html
 ///
 /// Authentication:
 ///   https://docs.aws.amazon.com/general/latest/gr/sigv4_signing.html
-class Route53Driver final : public BaseDriver {
+class Route53Driver final : public TypedDriver<Route53Params> {
 public:
     ~Route53Driver() override = default;
 
     /// Build a Route 53 ChangeResourceRecordSets request with SigV4 headers.
-    [[nodiscard]] DriverRequestContext generate_request(
-        const DriverConfig &config, const DriverUpdateParams &ctx
+    [[nodiscard]] DriverRequestContext build_request(
+        const Route53Params &cfg, const DriverUpdateParams &ctx
     ) const override;
 
     /// Validate the Route 53 API response (XML with libxml2).
@@ -33,12 +40,25 @@ public:
     /// Return static metadata about this driver.
     [[nodiscard]] DriverDetail get_detail() const noexcept override;
 
+    /// Update all records of the same hosted zone (and credentials) with one
+    /// ChangeResourceRecordSets request.
+    [[nodiscard]] std::vector<bool> execute_typed_batch(std::span<const TypedItem> items,
+                                                        HttpClient &http) const override;
+
 private:
+    /// One UPSERT entry of a change batch.
+    struct Change {
+        std::string fqdn;         ///< Record name with trailing dot
+        std::string_view rd_type; ///< Record type ("A", "AAAA", ...)
+        std::string_view ip_addr; ///< Record value
+        int ttl;                  ///< TTL in seconds
+    };
+
     /// Build the XML request body for a Route 53 UPSERT change batch.
-    static std::string build_xml_body(const std::string &fqdn,
-                                      std::string_view rd_type,
-                                      std::string_view ip_addr,
-                                      int ttl);
+    static std::string build_xml_body(std::span<const Change> changes);
+
+    /// Sign the XML body with SigV4 and assemble the request for the hosted zone.
+    static DriverRequestContext build_signed_request(const Route53Params &cfg, std::string body);
 };
 
 #endif // YADDNSC_DRV_ROUTE53_ROUTE53_H
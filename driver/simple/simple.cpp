@@ -4,23 +4,48 @@
 
 #include "simple.h"
 
+#include <stdexcept>
+#include <string>
+
 #include <glaze/glaze.hpp>
 
 #include "fmt.hpp"
 #include "string_util.hpp"
+#include "uri.h"
 #include "driver/factory.h"
 #include "interface/core_logger.h"
 
 DEFINE_DRIVER_FACTORY (SimpleDriver)
 
-DriverRequestContext SimpleDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto full = parse_config<glz::generic>(config);
-    if (!full.is_object() || !full.contains("url") || !full["url"].is_string()) {
+namespace {
+    /// The "url" template of @p params.
+    /// @throws ParamParseException  When it is missing or not a string.
+    const std::string &url_template(const glz::generic &params) {
+        if (params.is_object()) {
+            const auto &obj = params.get_object();
+            if (const auto url_it = obj.find("url"); url_it != obj.end() && url_it->second.is_string()) {
+                return url_it->second.get_string();
+            }
+        }
+
         throw ParamParseException(fmt::format("Missing required parameter \"url\" in driver config"));
     }
+} // anonymous namespace
+
+void SimpleDriver::validate_params(const glz::generic &params) const {
+    const auto &url = url_template(params);
+    try {
+        if (const auto uri = Uri::parse(url); uri.get_host().empty() || uri.get_port() == 0) {
+            throw std::runtime_error("missing host or port");
+        }
+    } catch (const std::exception &e) {
+        throw ParamParseException(fmt::format("Invalid parameter \"url\" '{}' in driver config: {}", url, e.what()));
+    }
+}
 
-    auto &obj = full.get_object();
-    auto url = obj["url"].get_string();
+DriverRequestContext SimpleDriver::build_request(const glz::generic &params, const DriverUpdateParams &ctx) const {
+    auto url = url_template(params);
+    const auto &obj = params.get_object();
 
     // Substitute all keys into the URL template: config params first, then context
     const auto substitute = [&](std::string_view key, std::string_view val) {
@@ -28,7 +53,7 @@ DriverRequestContext SimpleDriver::generate_request(const DriverConfig &config,
         StringUtil::replace_all(url, target, val);
     };
 
-    for (auto &[key, val]: obj) {
+    for (const auto &[key, val]: obj) {
         if (key != "url" && val.is_string()) {
             substitute(key, val.get_string());
         }
@@ -5,19 +5,25 @@
 #ifndef YADDNSC_DRV_SIMPLE_SIMPLE_H
 #define YADDNSC_DRV_SIMPLE_SIMPLE_H
 
+#include <glaze/glaze.hpp>
+
 #include "driver/base.h"
 
 /// Simple HTTP GET/POST driver for DNS record updates.
 ///
 /// The simplest driver implementation — it embeds the IP address into
 /// the URL or request body and doesn't parse the response beyond checking
-/// the HTTP status code.
-class SimpleDriver final : public BaseDriver {
+/// the HTTP status code.  Its config is free-form, so it is kept as a
+/// parsed generic JSON object rather than a fixed struct.
+class SimpleDriver final : public TypedDriver<glz::generic> {
 public:
     ~SimpleDriver() override = default;
 
+    /// Require a string "url" parameter that parses as a URI with a host.
+    void validate_params(const glz::generic &params) const override;
+
     /// Build a simple HTTP request with the IP address embedded.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const glz::generic &params, const DriverUpdateParams &ctx) const override;
 
     /// Return static metadata about this driver.
     [[nodiscard]] DriverDetail get_detail() const noexcept override;
@@ -16,9 +16,7 @@ namespace {
 
 DEFINE_DRIVER_FACTORY(VultrDriver)
 
-DriverRequestContext VultrDriver::generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const {
-    auto cfg = parse_config<VultrParams>(config);
-
+DriverRequestContext VultrDriver::build_request(const VultrParams &cfg, const DriverUpdateParams &ctx) const {
     auto url = fmt::format(API_URL,
                            fmt::arg("DOMAIN", ctx.domain),
                            fmt::arg("RECORD_ID", cfg.record_id));
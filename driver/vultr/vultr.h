@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DRV_VULTR_VULTR_H
 #define YADDNSC_DRV_VULTR_VULTR_H
 
+#include "config.hpp"
 #include "driver/base.h"
 
 /// Vultr API v2 driver for DNS record updates.
@@ -13,12 +14,12 @@
 /// via their domain records endpoint.
 ///
 /// API reference: https://www.vultr.com/api/#tag/dns
-class VultrDriver final : public BaseDriver {
+class VultrDriver final : public TypedDriver<VultrParams> {
 public:
     ~VultrDriver() override = default;
 
     /// Build the API request from config and update params.
-    [[nodiscard]] DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const override;
+    [[nodiscard]] DriverRequestContext build_request(const VultrParams &cfg, const DriverUpdateParams &ctx) const override;
 
     /// Validate the Vultr API response.
     [[nodiscard]] bool check_response(const HttpResponse &response) const override;
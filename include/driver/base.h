@@ -5,6 +5,10 @@
 #ifndef YADDNSC_DRIVER_BASE_H
 #define YADDNSC_DRIVER_BASE_H
 
+#include <memory>
+#include <span>
+#include <vector>
+
 #include <glaze/glaze.hpp>
 
 #include "interface/driver.h"
@@ -22,6 +26,11 @@
 /// Provides:
 ///   - A default `execute()` implementation that follows the standard
 ///     generate-request → HTTP exchange → check-response pipeline.
+///   - A default `execute_batch()` that falls back to one `execute()` per item.
+///   - Default `prepare()` / `execute_prepared()` / `execute_batch_prepared()`
+///     that keep the raw JSON and forward to the methods above, so a driver
+///     written against ABI 1.1 builds unchanged.  Drivers with a typed config
+///     should derive from TypedDriver instead, which parses it only once.
 ///   - `parse_config<T>()` for type-safe JSON config deserialisation with
 ///     built-in error reporting.
 ///   - Automatic ABI version reporting via `get_abi_version()`.
@@ -43,7 +52,60 @@ public:
     /// Logs each step via CORE_LOG_* macros. Returns false on HTTP error
     /// or upstream rejection rather than throwing.
     bool execute(const DriverConfig &config, const DriverUpdateParams &ctx, HttpClient &http) const override {
-        const auto [url, request] = generate_request(config, ctx);
+        return send(generate_request(config, ctx), ctx, http);
+    }
+
+    /// Default execute_batch: run execute() for each item in order.
+    ///
+    /// Drivers whose provider supports bulk record changes should override
+    /// this to issue a single request per zone.
+    std::vector<bool> execute_batch(std::span<const DriverBatchItem> items, HttpClient &http) const override {
+        std::vector<bool> results;
+        results.reserve(items.size());
+        for (const auto &[config, ctx]: items) {
+            results.push_back(execute(config, ctx, http));
+        }
+
+        return results;
+    }
+
+    /// Default prepare: keep the raw JSON for execute().
+    DriverHandlePtr prepare(const DriverConfig &config) const override {
+        return std::make_shared<const RawConfig>(config);
+    }
+
+    /// Default execute_prepared: forward the raw JSON to execute().
+    bool execute_prepared(const DriverHandle &handle, const DriverUpdateParams &ctx, HttpClient &http) const override {
+        return execute(static_cast<const RawConfig &>(handle).config, ctx, http);
+    }
+
+    /// Default execute_batch_prepared: forward the raw JSON to execute_batch().
+    std::vector<bool> execute_batch_prepared(std::span<const DriverPreparedItem> items,
+                                             HttpClient &http) const override {
+        std::vector<DriverBatchItem> raw;
+        raw.reserve(items.size());
+        for (const auto &[handle, ctx]: items) {
+            raw.push_back(DriverBatchItem{.config = static_cast<const RawConfig &>(handle).config, .ctx = ctx});
+        }
+
+        return execute_batch(raw, http);
+    }
+
+protected:
+    /// Handle produced by the default prepare(): the unparsed JSON.
+    struct RawConfig final : DriverHandle {
+        explicit RawConfig(DriverConfig value) : config(std::move(value)) {
+        }
+
+        const DriverConfig config;
+    };
+
+    /// Send one generated request and check the response.
+    ///
+    /// Logs each step via CORE_LOG_* macros. Returns false on HTTP error
+    /// or upstream rejection rather than throwing.
+    bool send(const DriverRequestContext &generated, const DriverUpdateParams &ctx, HttpClient &http) const {
+        const auto &[url, request] = generated;
         CORE_LOG_DEBUG("Domain {} ({}) received DNS record update request from driver {}, {}", ctx.fqdn, ctx.rd_type,
                        get_detail().name, request);
 
@@ -61,7 +123,6 @@ public:
         return true;
     }
 
-protected:
     /// Parse driver config JSON into a typed struct with built-in validation.
     ///
     /// Requires `glz::meta` specialisation for `T`. On failure, logs the
@@ -84,6 +145,116 @@ protected:
     }
 };
 
+/// BaseDriver for drivers whose configuration maps onto a struct.
+///
+/// prepare() parses the JSON into a `Params` once and keeps it in the handle,
+/// so the prepared entry points never touch JSON again.  The string-based
+/// entry points still work and parse on every call.
+///
+/// Driver plugins override:
+///   - `build_request()`  — build the API request from typed params
+///   - `check_response()` and `get_detail()`, as for BaseDriver
+///   - optionally `validate_params()` for checks the struct cannot express
+///   - optionally `execute_typed_batch()` for providers with a bulk endpoint
+///
+/// @tparam Params  Config struct with a glz::meta specialisation.
+template<typename Params>
+class TypedDriver : public BaseDriver {
+public:
+    /// One record of a typed batch.
+    struct TypedItem {
+        const Params &params;
+        const DriverUpdateParams &ctx;
+    };
+
+    DriverRequestContext generate_request(const DriverConfig &config, const DriverUpdateParams &ctx) const final {
+        return build_request(parse_params(config), ctx);
+    }
+
+    DriverHandlePtr prepare(const DriverConfig &config) const final {
+        return std::make_shared<const Prepared>(parse_params(config));
+    }
+
+    bool execute_prepared(const DriverHandle &handle, const DriverUpdateParams &ctx, HttpClient &http) const final {
+        return execute_typed(params_of(handle), ctx, http);
+    }
+
+    std::vector<bool> execute_batch(std::span<const DriverBatchItem> items, HttpClient &http) const final {
+        std::vector<Params> parsed;
+        parsed.reserve(items.size());
+        for (const auto &item: items) {
+            parsed.push_back(parse_params(item.config));
+        }
+
+        std::vector<TypedItem> typed;
+        typed.reserve(items.size());
+        for (std::size_t i = 0; i < items.size(); ++i) {
+            typed.push_back(TypedItem{.params = parsed[i], .ctx = items[i].ctx});
+        }
+
+        return execute_typed_batch(typed, http);
+    }
+
+    std::vector<bool> execute_batch_prepared(std::span<const DriverPreparedItem> items,
+                                             HttpClient &http) const final {
+        std::vector<TypedItem> typed;
+        typed.reserve(items.size());
+        for (const auto &[handle, ctx]: items) {
+            typed.push_back(TypedItem{.params = params_of(handle), .ctx = ctx});
+        }
+
+        return execute_typed_batch(typed, http);
+    }
+
+protected:
+    /// Check parsed params beyond what parsing into `Params` enforces; the
+    /// default accepts them.  Runs on every parse, so prepare() rejects a bad
+    /// config at startup.
+    /// @throws ParamParseException  When the params are invalid.
+    virtual void validate_params([[maybe_unused]] const Params &params) const {
+    }
+
+    /// Build the API request for one record from its parsed config.
+    [[nodiscard]] virtual DriverRequestContext build_request(const Params &params,
+                                                             const DriverUpdateParams &ctx) const = 0;
+
+    /// Update several records; the default sends one request per record.
+    [[nodiscard]] virtual std::vector<bool> execute_typed_batch(std::span<const TypedItem> items,
+                                                                HttpClient &http) const {
+        std::vector<bool> results;
+        results.reserve(items.size());
+        for (const auto &[params, ctx]: items) {
+            results.push_back(execute_typed(params, ctx, http));
+        }
+
+        return results;
+    }
+
+    /// Update one record from its parsed config.
+    bool execute_typed(const Params &params, const DriverUpdateParams &ctx, HttpClient &http) const {
+        return send(build_request(params, ctx), ctx, http);
+    }
+
+private:
+    [[nodiscard]] Params parse_params(const DriverConfig &config) const {
+        auto params = parse_config<Params>(config);
+        validate_params(params);
+        return params;
+    }
+
+    struct Prepared final : DriverHandle {
+        explicit Prepared(Params value) : params(std::move(value)) {
+        }
+
+        const Params params;
+    };
+
+    /// The host only passes back handles created by this driver's prepare().
+    [[nodiscard]] static const Params &params_of(const DriverHandle &handle) noexcept {
+        return static_cast<const Prepared &>(handle).params;
+    }
+};
+
 extern "C" Driver *create();
 
 #endif //YADDNSC_DRIVER_BASE_H
@@ -5,8 +5,11 @@
 #ifndef YADDNSC_DRIVER_INTERFACE_H
 #define YADDNSC_DRIVER_INTERFACE_H
 
+#include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "abi_version.h"
 #include "http_client.h"
@@ -53,15 +56,60 @@ struct DriverUpdateParams final {
     const std::string fqdn;      ///< Fully qualified domain name (subdomain.domain)
 };
 
+/// One entry of a batched update: a driver config paired with its update params.
+///
+/// Immutable after construction; the updater builds one item per task that
+/// needs an update and hands the whole span to Driver::execute_batch().
+struct DriverBatchItem final {
+    const DriverConfig config;    ///< Driver-specific JSON configuration string
+    const DriverUpdateParams ctx; ///< Per-update parameters (IP, domain, etc.)
+};
+
+/// Driver configuration parsed and validated once by Driver::prepare().
+///
+/// Owned by the driver that created it and opaque to the host, which only
+/// keeps it alive and hands it back to that same driver.  Added in ABI 1.2.
+class DriverHandle {
+public:
+    DriverHandle() = default;
+
+    virtual ~DriverHandle() = default;
+
+    DriverHandle(const DriverHandle &) = delete;
+
+    DriverHandle &operator=(const DriverHandle &) = delete;
+
+    DriverHandle(DriverHandle &&) = delete;
+
+    DriverHandle &operator=(DriverHandle &&) = delete;
+};
+
+/// Shared ownership of a prepared configuration; tasks with identical
+/// driver parameters may share one handle.
+using DriverHandlePtr = std::shared_ptr<const DriverHandle>;
+
+/// One entry of a batched update that uses a prepared configuration.
+///
+/// The prepared counterpart of DriverBatchItem: the handle replaces the raw
+/// JSON string and must have been returned by the same driver's prepare().
+struct DriverPreparedItem final {
+    const DriverHandle &handle;   ///< Prepared driver configuration
+    const DriverUpdateParams ctx; ///< Per-update parameters (IP, domain, etc.)
+};
+
 /// Driver interface — every DNS backend must implement this.
 ///
 /// A driver encapsulates the logic to:
 ///   1. Build an API request from config and update params (`generate_request`).
 ///   2. Validate the upstream response (`check_response`).
 ///   3. (Optionally) orchestrate the full HTTP flow (`execute`).
+///   4. (Optionally) push several records in one API call (`execute_batch`).
+///   5. Parse its configuration once ahead of time (`prepare`) and run
+///      updates against the result (`execute_prepared`,
+///      `execute_batch_prepared`).
 ///
-/// Implementations should inherit from BaseDriver which provides a default
-/// `execute()` and `get_abi_version()`.
+/// Implementations should inherit from TypedDriver (or BaseDriver), which
+/// provide every method except the request/response hooks and metadata.
 class Driver {
 public:
     Driver() = default;
@@ -105,6 +153,54 @@ public:
     [[nodiscard]] virtual bool execute(
         const DriverConfig &config, const DriverUpdateParams &ctx, HttpClient &http
     ) const = 0;
+
+    /// Execute several updates that belong to the same domain in as few
+    /// upstream API calls as the provider allows.
+    ///
+    /// Added in ABI 1.1. The default implementation in BaseDriver calls
+    /// `execute()` once per item. Providers with a bulk-change endpoint
+    /// override it to send one request per zone instead.
+    ///
+    /// @param items  Updates to apply; never empty.
+    /// @param http   HTTP client shared by every request of the batch.
+    /// @return       One flag per item, in input order: true if the upstream
+    ///               service accepted that record.
+    [[nodiscard]] virtual std::vector<bool> execute_batch(
+        std::span<const DriverBatchItem> items, HttpClient &http
+    ) const = 0;
+
+    /// Parse and validate a driver configuration once, ahead of any update.
+    ///
+    /// Added in ABI 1.2. The host calls it for every configured record at
+    /// startup, so invalid parameters are reported before the first update,
+    /// and then passes the handle to execute_prepared() on every update
+    /// instead of re-serialising the JSON each time.
+    ///
+    /// @param config  Driver-specific JSON configuration string.
+    /// @return        Handle to the parsed configuration; never null.
+    /// @throws ParamParseException  When the configuration is invalid.
+    [[nodiscard]] virtual DriverHandlePtr prepare(const DriverConfig &config) const = 0;
+
+    /// execute() against a configuration returned by prepare().
+    ///
+    /// Added in ABI 1.2.
+    /// @param handle  Handle returned by this driver's prepare().
+    /// @param ctx     Per-update parameters (IP, domain, etc.).
+    /// @param http    HTTP client for the upstream API call.
+    /// @return        true if the update was accepted by the upstream service.
+    [[nodiscard]] virtual bool execute_prepared(
+        const DriverHandle &handle, const DriverUpdateParams &ctx, HttpClient &http
+    ) const = 0;
+
+    /// execute_batch() against configurations returned by prepare().
+    ///
+    /// Added in ABI 1.2.
+    /// @param items  Updates to apply; never empty.
+    /// @param http   HTTP client shared by every request of the batch.
+    /// @return       One flag per item, in input order.
+    [[nodiscard]] virtual std::vector<bool> execute_batch_prepared(
+        std::span<const DriverPreparedItem> items, HttpClient &http
+    ) const = 0;
 };
 
 #endif // YADDNSC_DRIVER_INTERFACE_H
@@ -39,6 +39,14 @@ namespace Config {
         unsigned short port{53};                     ///< Port for the single address (default: 53)
         std::vector<DnsServer> servers;            ///< List of custom resolver servers
         ResolverStrategy strategy{ResolverStrategy::CONCURRENT}; ///< Domain Resolve strategy
+        bool cache{false};                           ///< Cache answers for their TTL (native DNS backend only)
+    };
+
+    /// Task scheduling configuration (load spreading across update cycles).
+    struct SchedulerConfig {
+        int startup_spread{};    ///< Spread first runs over up to this many seconds (0 = all start at once)
+        int jitter{};            ///< Re-queue jitter in percent of the update interval (0–50, 0 = disabled)
+        int max_dispatch_rate{}; ///< Maximum tasks dispatched per second (0 = unlimited)
     };
 
     /// Per-subdomain configuration from the config file.
@@ -62,6 +70,8 @@ namespace Config {
         int force_update{};                    ///< Force-update interval in seconds (0 = disabled)
         std::string driver;                    ///< Name of the driver plugin to use
         std::vector<SubdomainConfig> subdomains; ///< Subdomains to update
+        int verify_interval{};                 ///< Re-check an unchanged, already published IP against DNS
+                                               ///< at most this often, in seconds (0 = every update)
     };
 
     /// Top-level application configuration.
@@ -69,6 +79,8 @@ namespace Config {
         DriverConfig driver;               ///< Driver loading configuration
         ResolverConfig resolver;           ///< DNS resolver configuration
         std::vector<DomainConfig> domains; ///< Domains to manage
+        SchedulerConfig scheduler;         ///< Task scheduling settings (optional)
+        std::optional<std::string> state_file; ///< Runtime state kept across restarts (optional, disabled when unset)
     };
 
     /// Load the application configuration from a JSON file.
@@ -10,16 +10,24 @@
 
 /// DNS-related configuration types.
 namespace Config {
+    /// Transport used to reach a plain (non-DoH/DoT) DNS server.
+    enum class DnsTransport {
+        UDP, ///< UDP, retried over TCP when the answer is truncated
+        TCP ///< TCP only, over a persistent pipelined connection (RFC 7766)
+    };
+
     /// DNS server endpoint (configuration value object).
     struct DnsServer {
         std::string address; ///< Hostname or IP address of the DNS server
         std::uint16_t port{53}; ///< UDP/TCP port (default: 53)
+        DnsTransport transport{DnsTransport::UDP}; ///< Plain DNS only; ignored by DoH/DoT
     };
 
     /// DNS resolution strategy used by ResolverDispatcher.
     enum class ResolverStrategy {
         FALLBACK, ///< Try resolvers sequentially until one succeeds
-        CONCURRENT ///< Query all resolvers concurrently and take the first result
+        CONCURRENT, ///< Query all resolvers concurrently and take the first result
+        HEDGED ///< Query the best-scoring resolver; hedge to the next one if it is slow
     };
 }
 
@@ -28,7 +28,18 @@ struct glz::meta<Config::DnsServer> {
     static constexpr auto value = object(
         "address", &T::address,
         "ipaddress", &T::address,
-        "port", &T::port
+        "port", &T::port,
+        "transport", &T::transport
+    );
+};
+
+/// glz::meta specialisation for Config::DnsTransport enum JSON mapping.
+template<>
+struct glz::meta<Config::DnsTransport> {
+    using enum Config::DnsTransport;
+    static constexpr auto value = enumerate(
+        "udp", UDP,
+        "tcp", TCP
     );
 };
 
@@ -42,7 +53,8 @@ struct glz::meta<Config::ResolverConfig> {
         "ipaddress", &T::address,
         "port", &T::port,
         "servers", &T::servers,
-        "strategy", &T::strategy
+        "strategy", &T::strategy,
+        "cache", &T::cache
     );
 };
 
@@ -52,7 +64,19 @@ struct glz::meta<Config::ResolverStrategy> {
     using enum Config::ResolverStrategy;
     static constexpr auto value = enumerate(
         "fallback", FALLBACK,
-        "concurrent", CONCURRENT
+        "concurrent", CONCURRENT,
+        "hedged", HEDGED
+    );
+};
+
+/// glz::meta specialisation for Config::SchedulerConfig JSON mapping.
+template<>
+struct glz::meta<Config::SchedulerConfig> {
+    using T = Config::SchedulerConfig;
+    static constexpr auto value = object(
+        "startup_spread", &T::startup_spread,
+        "jitter", &T::jitter,
+        "max_dispatch_rate", &T::max_dispatch_rate
     );
 };
 
@@ -83,7 +107,8 @@ struct glz::meta<Config::DomainConfig> {
         "update_interval", &T::update_interval,
         "force_update", &T::force_update,
         "driver", &T::driver,
-        "subdomains", &T::subdomains
+        "subdomains", &T::subdomains,
+        "verify_interval", &T::verify_interval
     );
 };
 
@@ -94,7 +119,9 @@ struct glz::meta<Config::AppConfig> {
     static constexpr auto value = object(
         "driver", &T::driver,
         "resolver", &T::resolver,
-        "domains", &T::domains
+        "domains", &T::domains,
+        "scheduler", &T::scheduler,
+        "state_file", &T::state_file
     );
 };
 
@@ -121,6 +121,19 @@ namespace detail {
         }
 #endif
     }
+
+    /// Reject a transport that does not apply to the server's address:
+    /// DoH and DoT always run over their own TLS connection.
+    inline void validate_resolver_transport(const Config::DnsServer &server) {
+        const auto uri = Uri::parse(server.address);
+        if (server.transport != Config::DnsTransport::UDP &&
+            (uri.get_schema() == "https" || uri.get_schema() == "tls")) {
+            throw ConfigVerificationException(
+                fmt::format(R"(Resolver "{}" is DoH/DoT; "transport" applies only to plain DNS servers)",
+                            server.address)
+            );
+        }
+    }
 } // namespace detail
 
 /// ConfigValidator — performs all pre-flight checks on the parsed configuration
@@ -147,7 +160,9 @@ public:
     void validate(const Config::AppConfig &cfg) const {
         const auto &drivers = loaded_drivers_;
 
-        for (const auto &[name, update_interval, force_update, driver, subdomains]: cfg.domains) {
+        for (const auto &domain: cfg.domains) {
+            const auto &[name, update_interval, force_update, driver, subdomains, verify_interval] = domain;
+
             // --- Check domain name is not empty. ---------------------------------
             if (name.empty()) {
                 throw ConfigVerificationException("Domain name must not be empty");
@@ -181,8 +196,14 @@ public:
                 );
             }
 
+            // --- Check DNS verification interval. ---------------------------------
+            if (verify_interval < 0) {
+                throw ConfigVerificationException(
+                    fmt::format("Verify interval for domain {} must not be negative", name)
+                );
+            }
+
             // --- Check that every referenced interface exists. -------------------
-            const Config::DomainConfig domain{name, update_interval, force_update, driver, subdomains};
             for (const auto &subdomain: subdomains) {
                 if (subdomain.name.empty()) {
                     throw ConfigVerificationException(
@@ -212,12 +233,30 @@ public:
             }
         }
 
+        // --- Validate scheduler load-spreading settings. --------------------------
+        const auto &[startup_spread, jitter, max_dispatch_rate] = cfg.scheduler;
+        if (startup_spread < 0 || max_dispatch_rate < 0) {
+            throw ConfigVerificationException("Scheduler startup_spread and max_dispatch_rate must not be negative");
+        }
+
+        if (jitter < 0 || jitter > 50) {
+            throw ConfigVerificationException(
+                fmt::format("Scheduler jitter must be between 0 and 50 percent, got {}", jitter)
+            );
+        }
+
+        // --- Validate the runtime state file path. --------------------------------
+        if (cfg.state_file && cfg.state_file->empty()) {
+            throw ConfigVerificationException("State file path must not be empty; omit state_file to disable it");
+        }
+
         // --- Validate custom resolver address(es). --------------------------------
 #if defined(HAVE_RES_NQUERY) || defined(YADDNSC_USE_NATIVE_DNS)
         if (cfg.resolver.use_custom_server) {
             if (!cfg.resolver.servers.empty()) {
                 for (const auto &server: cfg.resolver.servers) {
                     detail::validate_resolver_address(server.address);
+                    detail::validate_resolver_transport(server);
                 }
             } else if (!cfg.resolver.address.empty()) {
                 detail::validate_resolver_address(cfg.resolver.address);
@@ -4,9 +4,17 @@
 
 #include "manager.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "config/config.h"
 #include "config/validator.hpp"
@@ -14,13 +22,18 @@
 #include "dns/factory.h"
 #include "ip_source/iface_util.h"
 #include "network/http_client.h"
+#include "network/net_devices.h"
 
 #include "driver_loader.h"
 #include "driver_manager.h"
 #include "scheduler.h"
+#include "state_store.h"
 #include "updater.h"
 #include "update_task.h"
 #include "min_update_interval.h"
+#include "util/task.hpp"
+#include "exception/config_verification.h"
+#include "exception/driver.h"
 #include "exception/driver_not_found.h"
 
 #include <BS_thread_pool.hpp>
@@ -50,6 +63,29 @@ namespace {
         return std::min(thread_count, 4U);
     }
 
+    /// Open the configured state file.  The state only saves work after a
+    /// restart, so a file that cannot be opened is reported and skipped.
+    [[nodiscard]] std::unique_ptr<StateStore> open_state_store(const Config::AppConfig &config) noexcept {
+        if (!config.state_file) {
+            return nullptr;
+        }
+
+        try {
+            return std::make_unique<StateStore>(*config.state_file);
+        } catch (const std::exception &e) {
+            SPDLOG_WARN("Runtime state will not be kept across restarts: {}", e.what());
+        }
+        return nullptr;
+    }
+
+    [[nodiscard]] bool uses_interface_source(const Config::AppConfig &config) noexcept {
+        return std::ranges::any_of(config.domains, [](const auto &domain) {
+            return std::ranges::any_of(domain.subdomains, [](const auto &subdomain) {
+                return subdomain.ip_source == Config::IpSource::INTERFACE;
+            });
+        });
+    }
+
 } // anonymous namespace
 
 // ---------------------------------------------------------------------------
@@ -64,32 +100,59 @@ struct Manager::Impl {
 
     void load_drivers();
 
-    void validate_config() const;
+    void validate_config();
+
+    /// Parse the driver parameters of every task once, through its driver's
+    /// prepare(), and store the resulting handle in the task.  Tasks with the
+    /// same driver and parameters share one handle.
+    /// @throws ConfigVerificationException  If a driver rejects its parameters.
+    void prepare_driver_handles();
 
     void run();
 
+    /// Run one (domain, driver) group through the coroutine pipeline, with
+    /// its blocking stages on thread_pool_.  While it awaits a DNS lookup
+    /// the group has no pool job queued, so it is counted in
+    /// groups_in_flight_ for run() to drain.
+    [[nodiscard]] Utils::Task<> process_group(std::vector<DueTask> group, const Driver &driver);
+
+    /// Start the interface address monitor when any task reads its address
+    /// from a local interface, and route its change events to the scheduler.
+    void start_address_monitor();
+
+    void stop_address_monitor() noexcept;
+
     // IMPORTANT: destruction order is the reverse of declaration order.
     // config_ is declared first because it's needed by dispatcher_'s constructor.
+    // state_store_ is shared by updater_ and scheduler_, so it outlives both.
+    // scheduler_ owns the task arena that queued jobs point into, so it is
+    // declared before thread_pool_ and therefore outlives every worker.
     Config::AppConfig config_;
+    std::unique_ptr<StateStore> state_store_;
     DriverManager driver_manager_;
     ResolverDispatcher dispatcher_;
     Updater updater_;
-    BS::thread_pool<> thread_pool_;
     Scheduler scheduler_;
+    BS::thread_pool<> thread_pool_;
+    std::atomic<std::size_t> groups_in_flight_{0};
     std::stop_source stop_source_;
     HttpClientFactory http_client_factory_;
+    // Declared last: its callback targets scheduler_, so it must stop first.
+    std::unique_ptr<NetDevices::AddressMonitor> address_monitor_;
 };
 
 Manager::Impl::Impl(Config::AppConfig config, std::stop_source stop_source)
-    : config_(std::move(config)), dispatcher_(DnsResolverFactory::create(config_)), updater_(dispatcher_),
-      thread_pool_(estimate_pool_size(config_)), scheduler_(config_, stop_source.get_token()),
+    : config_(std::move(config)), state_store_(open_state_store(config_)),
+      dispatcher_(DnsResolverFactory::create(config_)), updater_(dispatcher_, state_store_.get()),
+      scheduler_(config_, stop_source.get_token(), state_store_.get()), thread_pool_(estimate_pool_size(config_)),
       stop_source_(std::move(stop_source)), http_client_factory_(default_http_client_factory) {
 }
 
 Manager::Impl::Impl(Config::AppConfig config, std::stop_source stop_source, ResolverDispatcher dispatcher,
                     HttpClientFactory http_factory)
-    : config_(std::move(config)), dispatcher_(std::move(dispatcher)), updater_(dispatcher_),
-      thread_pool_(estimate_pool_size(config_)), scheduler_(config_, stop_source.get_token()),
+    : config_(std::move(config)), state_store_(open_state_store(config_)), dispatcher_(std::move(dispatcher)),
+      updater_(dispatcher_, state_store_.get()), scheduler_(config_, stop_source.get_token(), state_store_.get()),
+      thread_pool_(estimate_pool_size(config_)),
       stop_source_(std::move(stop_source)), http_client_factory_(std::move(http_factory)) {
 }
 
@@ -97,29 +160,106 @@ void Manager::Impl::load_drivers() {
     DriverLoader::load(driver_manager_, config_);
 }
 
-void Manager::Impl::validate_config() const {
+void Manager::Impl::validate_config() {
     const auto interfaces = InterfaceUtil::get_interfaces();
     const ConfigValidator<YADDNSC_MIN_UPDATE_INTERVAL> validator(driver_manager_.get_loaded_drivers(), interfaces);
     validator.validate(config_);
+
+    prepare_driver_handles();
+}
+
+void Manager::Impl::prepare_driver_handles() {
+    std::map<std::pair<std::string, DriverConfig>, DriverHandlePtr> handles;
+    scheduler_.prepare_tasks([&](UpdateTask &task) {
+        const auto parameters = task.config.driver_param.dump().value_or("{}");
+        auto [it, inserted] = handles.try_emplace({task.driver_name, parameters});
+        if (inserted) {
+            const auto &driver = driver_manager_.get_driver(task.driver_name);
+            try {
+                it->second = driver.prepare(parameters);
+            } catch (const DriverException &e) {
+                throw ConfigVerificationException(
+                    fmt::format("Invalid driver parameters for {} (driver {}): {}", task.fqdn, task.driver_name,
+                                e.what()));
+            }
+        }
+        task.driver_handle = it->second;
+    });
+}
+
+void Manager::Impl::start_address_monitor() {
+    if (!uses_interface_source(config_)) {
+        return;
+    }
+
+    try {
+        address_monitor_ = std::make_unique<NetDevices::AddressMonitor>([this](const std::string &interface_name) {
+            scheduler_.notify_interface_changed(interface_name);
+        });
+        InterfaceUtil::attach_monitor(address_monitor_.get());
+        SPDLOG_INFO("Watching interface addresses ({})",
+                    address_monitor_->is_event_driven() ? "rtnetlink events" : "polling");
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Interface address monitor unavailable, falling back to per-update lookups: {}", e.what());
+    }
+}
+
+void Manager::Impl::stop_address_monitor() noexcept {
+    InterfaceUtil::attach_monitor(nullptr);
+    address_monitor_.reset();
+}
+
+Utils::Task<> Manager::Impl::process_group(std::vector<DueTask> group, const Driver &driver) {
+    groups_in_flight_.fetch_add(1, std::memory_order_relaxed);
+
+    // The updater logs its own errors; only the client factory can throw here.
+    try {
+        const auto http_client = http_client_factory_();
+        co_await updater_.process_batch_async(group, driver, *http_client,
+                                              [this](std::function<void()> stage) {
+                                                  thread_pool_.detach_task(std::move(stage));
+                                              });
+    } catch (const std::exception &e) {
+        SPDLOG_ERROR("Failed to start the update of {}: {}", group.front().task->domain_name, e.what());
+    }
+
+    // An interface change that arrived meanwhile may now run the tasks again.
+    scheduler_.complete(group);
+
+    if (groups_in_flight_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        groups_in_flight_.notify_all();
+    }
 }
 
 void Manager::Impl::run() {
     const auto interfaces = InterfaceUtil::get_interfaces();
     SPDLOG_INFO("All available interfaces: {}", fmt::join(interfaces, ", "));
 
+    start_address_monitor();
+
+    // Reused across ticks, so an idle tick allocates nothing.
+    std::vector<DueTask> due;
+
     while (!stop_source_.stop_requested()) {
-        auto tasks = scheduler_.pop_all_due();
+        // Group due tasks by (domain, driver) so that every group reaches the
+        // driver as one batch; providers with a bulk endpoint then need a
+        // single API call per zone instead of one per record.  The handles
+        // point into the scheduler's arena, so the keys can be views.
+        scheduler_.pop_all_due(due);
+        std::map<std::pair<std::string_view, std::string_view>, std::vector<DueTask> > groups;
+        for (const auto &handle: due) {
+            groups[{handle.task->domain_name, handle.task->driver_name}].push_back(handle);
+        }
 
-        for (auto &task: tasks) {
+        for (auto &[key, group]: groups) {
+            const auto &[domain_name, driver_name] = key;
             try {
-                auto driver = &driver_manager_.get_driver(task.driver_name);
-                thread_pool_.detach_task([this, driver, t = std::move(task)] {
-                    auto http_client = http_client_factory_();
-                    updater_.process(t, *driver, *http_client);
-                });
+                const auto &driver = driver_manager_.get_driver(std::string(driver_name));
+                Utils::start_detached(process_group(std::move(group), driver));
             } catch (const DriverNotFoundException &e) {
-                SPDLOG_ERROR("Driver '{}' not found for task '{}', skipping: {}", task.driver_name, task.fqdn,
-                             e.what());
+                SPDLOG_ERROR("Driver '{}' not found for {} task(s) of '{}', skipping: {}", driver_name, group.size(),
+                             domain_name, e.what());
+                scheduler_.complete(group);
             }
         }
 
@@ -128,7 +268,12 @@ void Manager::Impl::run() {
         }
     }
 
+    for (auto in_flight = groups_in_flight_.load(std::memory_order_acquire); in_flight != 0;
+         in_flight = groups_in_flight_.load(std::memory_order_acquire)) {
+        groups_in_flight_.wait(in_flight);
+    }
     thread_pool_.wait();
+    stop_address_monitor();
     SPDLOG_INFO("All tasks drained, shutting down");
 }
 
@@ -152,7 +297,7 @@ void Manager::load_drivers() const {
     impl_->load_drivers();
 }
 
-void Manager::validate_config() const {
+void Manager::validate_config() {
     impl_->validate_config();
 }
 
@@ -45,9 +45,11 @@ public:
     /// Load all driver shared libraries specified in the configuration.
     void load_drivers() const;
 
-    /// Run pre-flight validation on the loaded configuration.
-    /// @throws ConfigVerificationException  On the first violated constraint.
-    void validate_config() const;
+    /// Run pre-flight validation on the loaded configuration, and parse every
+    /// task's driver parameters once through its driver.
+    /// @throws ConfigVerificationException  On the first violated constraint,
+    ///                                      including rejected driver parameters.
+    void validate_config();
 
     /// Run the scheduler loop.  Blocks until a stop is requested.
     void run() const;
@@ -4,36 +4,94 @@
 
 #include "scheduler.h"
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <mutex>
-#include <queue>
+#include <random>
+#include <span>
 #include <stop_token>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 #include "config/config.h"
+#include "util/random.hpp"
 
+#include "state_store.h"
 #include "update_task.h"
 
 #include "fmt.hpp"
 #include <spdlog/spdlog.h>
 
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    /// Fan-out of the timer heap.  A 4-ary heap is half as deep as a binary
+    /// one and keeps the children of a node in one cache line.
+    constexpr std::size_t HEAP_ARITY = 4;
+
+    /// Length of the window over which max_dispatch_rate is enforced.
+    constexpr auto RATE_WINDOW = std::chrono::seconds(1);
+
+    /// FNV-1a (64-bit).  Stable across runs and platforms, unlike std::hash,
+    /// so a task keeps the same startup phase after every restart.
+    [[nodiscard]] constexpr std::uint64_t fnv1a(std::string_view text) noexcept {
+        std::uint64_t hash = 0xcbf29ce484222325ULL;
+        for (const auto ch: text) {
+            hash ^= static_cast<unsigned char>(ch);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    /// Deterministic first-run offset in [0, min(spread, interval)) seconds,
+    /// at millisecond resolution.
+    [[nodiscard]] Clock::duration initial_offset(std::string_view fqdn, int interval, int spread) noexcept {
+        const auto window = interval > 0 ? std::min(spread, interval) : spread;
+        if (window <= 0) {
+            return Clock::duration::zero();
+        }
+
+        const auto window_ms = static_cast<std::uint64_t>(window) * 1000;
+        return std::chrono::milliseconds(fnv1a(fqdn) % window_ms);
+    }
+
+    [[nodiscard]] StateStore::WallClock::time_point to_wall_clock(Clock::time_point tp, Clock::time_point now,
+                                                                  StateStore::WallClock::time_point wall_now) noexcept {
+        return wall_now + std::chrono::duration_cast<StateStore::WallClock::duration>(tp - now);
+    }
+
+    [[nodiscard]] Clock::time_point from_wall_clock(StateStore::WallClock::time_point tp,
+                                                    StateStore::WallClock::time_point wall_now,
+                                                    Clock::time_point now) noexcept {
+        return now + std::chrono::duration_cast<Clock::duration>(tp - wall_now);
+    }
+}
+
 // ---------------------------------------------------------------------------
-// ScheduleEntry — a single node in the scheduling min-heap.
+// TaskTimer — per-task scheduling state, stored next to the task arena.
 // Kept private inside the .cpp; never exposed to callers.
 // ---------------------------------------------------------------------------
-struct ScheduleEntry {
-    std::chrono::steady_clock::time_point deadline;
+struct TaskTimer {
     int update_interval{};
     int force_update_interval{};
-    std::chrono::steady_clock::time_point last_force_update;
-    UpdateTask task;
+    Clock::time_point last_force_update;
+    /// Runs handed out by pop_all_due() and not yet reported by complete().
+    std::uint32_t runs_in_flight{0};
+    /// The task's interface changed while it ran: run again once it ends.
+    bool changed_again{false};
+};
 
-    // std::priority_queue is a max-heap by default, so we invert the comparison.
-    bool operator>(const ScheduleEntry &other) const {
-        return deadline > other.deadline;
-    }
+// ---------------------------------------------------------------------------
+// HeapNode — a single node of the scheduling min-heap: the deadline plus the
+// index of the task in the arena.  Trivially copyable, 16 bytes.
+// ---------------------------------------------------------------------------
+struct HeapNode {
+    Clock::time_point deadline;
+    std::uint32_t index{};
 };
 
 // ---------------------------------------------------------------------------
@@ -41,41 +99,88 @@ struct ScheduleEntry {
 // ---------------------------------------------------------------------------
 
 struct Scheduler::Impl {
-    Impl(Config::AppConfig config, std::stop_token stop_token);
+    Impl(const Config::AppConfig &config, std::stop_token stop_token, StateStore *state);
 
     [[nodiscard]]
-    static bool check_force_update(ScheduleEntry &entry, std::chrono::steady_clock::time_point now) noexcept;
+    static bool check_force_update(TaskTimer &timer, Clock::time_point now) noexcept;
 
-    std::vector<UpdateTask> pop_all_due();
+    void pop_all_due(std::vector<DueTask> &due);
 
     bool wait_for_next();
 
+    void notify_interface_changed(std::string_view interface_name);
+
+    void complete(std::span<const DueTask> tasks);
+
+    void prepare_tasks(const std::function<void(UpdateTask &)> &visitor);
+
     [[nodiscard]] bool has_pending() const;
 
-    // ---- config ------------------------------------------------------------
-    Config::AppConfig config_;
+    void sift_down(std::size_t pos) noexcept;
+
+    void heapify() noexcept;
+
+    /// Next deadline of a task that was just dispatched at @p now, with the
+    /// configured jitter applied.
+    [[nodiscard]] Clock::time_point next_deadline(const TaskTimer &timer, Clock::time_point now) const;
+
+    /// Number of tasks that may still be dispatched in the current rate
+    /// window (resets the window once it has elapsed).
+    [[nodiscard]] std::size_t dispatch_budget(Clock::time_point now) noexcept;
+
+    /// Apply a saved schedule to a freshly built task, clamped so that a
+    /// shortened interval or a clock change cannot push it too far out.
+    static void restore(const StateStore::Schedule &saved, TaskTimer &timer, HeapNode &node, Clock::time_point now,
+                        StateStore::WallClock::time_point wall_now) noexcept;
+
+    /// Phase of a task that was just re-queued, as the state store keeps it.
+    [[nodiscard]] StateStore::Schedule schedule_of(const HeapNode &node, Clock::time_point now,
+                                                   StateStore::WallClock::time_point wall_now) const;
+
+    /// Save the phases of the tasks of one dispatch round.  Called without
+    /// mtx_ held, so that file I/O never stalls other scheduler calls.
+    /// Failures are logged and otherwise ignored: persistence is best effort.
+    void persist(std::span<const StateStore::Schedule> schedules) const noexcept;
 
     // ---- stop --------------------------------------------------------------
     std::stop_token stop_token_;
 
+    // ---- persistence (optional, non-owning) --------------------------------
+    StateStore *state_;
+
+    // ---- load spreading ----------------------------------------------------
+    int jitter_percent_;
+    std::size_t max_dispatch_rate_;
+    Clock::time_point window_start_;
+    std::size_t window_dispatched_{0};
+
+    // ---- task arena (immutable once prepare_tasks() has run) ---------------
+    std::vector<UpdateTask> tasks_;
+    std::vector<TaskTimer> timers_; // parallel to tasks_
+
     // ---- scheduling state --------------------------------------------------
-    std::priority_queue<ScheduleEntry, std::vector<ScheduleEntry>, std::greater<> > heap_;
+    std::vector<HeapNode> heap_;
 
     // ---- synchronisation ---------------------------------------------------
     mutable std::mutex mtx_;
     std::condition_variable cv_;
+    bool wake_pending_{false}; // set by notify_interface_changed(), consumed by wait_for_next()
     std::stop_callback<std::function<void()> > stop_cb_; // notifies cv_ when stop fires
 };
 
-Scheduler::Impl::Impl(Config::AppConfig config, std::stop_token stop_token)
-    : config_(std::move(config)), stop_token_(std::move(stop_token)),
+Scheduler::Impl::Impl(const Config::AppConfig &config, std::stop_token stop_token, StateStore *state)
+    : stop_token_(std::move(stop_token)), state_(state), jitter_percent_(config.scheduler.jitter),
+      max_dispatch_rate_(static_cast<std::size_t>(std::max(config.scheduler.max_dispatch_rate, 0))),
       stop_cb_(stop_token_, [this] { cv_.notify_all(); }) {
-    for (const auto &[name, update_interval, force_update, driver, subdomains]: config_.domains) {
+    const auto startup_spread = config.scheduler.startup_spread;
+    const auto wall_now = StateStore::WallClock::now();
+    std::size_t restored = 0;
+    for (const auto &[name, update_interval, force_update, driver, subdomains, verify_interval]: config.domains) {
         for (const auto &subdomain: subdomains) {
             const auto fqdn = fmt::format("{}.{}", subdomain.name, name);
             const auto effective_interval = subdomain.update_interval > 0 ? subdomain.update_interval : update_interval;
 
-            const auto now = std::chrono::steady_clock::now();
+            const auto now = Clock::now();
 
             // Initialise last_force_update far enough in the past so that the
             // first pop_all_due() call always triggers force_update when the
@@ -84,62 +189,198 @@ Scheduler::Impl::Impl(Config::AppConfig config, std::stop_token stop_token)
             // shorter than the force_update_interval.
             const auto force_update_past = force_update > 0
                 ? now - std::chrono::seconds(force_update)
-                : std::chrono::steady_clock::time_point{};
-
-            heap_.push(ScheduleEntry{
-                .deadline = now,
+                : Clock::time_point{};
+
+            tasks_.push_back(UpdateTask{
+                .config = subdomain,
+                .domain_name = name,
+                .driver_name = driver,
+                .fqdn = fqdn,
+                .force_update = false,
+                .verify_interval = verify_interval,
+            });
+            timers_.push_back(TaskTimer{
                 .update_interval = effective_interval,
                 .force_update_interval = force_update,
                 .last_force_update = force_update_past,
-                .task = {
-                    .config = subdomain,
-                    .domain_name = name,
-                    .driver_name = driver,
-                    .fqdn = fqdn,
-                    .force_update = false,
-                },
             });
+            // Tasks sharing an interval would otherwise fire in the same
+            // burst forever; a per-fqdn phase offset spreads them out.
+            heap_.push_back(HeapNode{
+                .deadline = now + initial_offset(fqdn, effective_interval, startup_spread),
+                .index = static_cast<std::uint32_t>(tasks_.size() - 1),
+            });
+
+            if (state_ == nullptr) {
+                continue;
+            }
+            if (const auto saved = state_->schedule(fqdn, subdomain.type)) {
+                restore(*saved, timers_.back(), heap_.back(), now, wall_now);
+                ++restored;
+            }
         }
     }
 
-    SPDLOG_INFO("Scheduler initialised with {} tasks", heap_.size());
+    heapify();
+    SPDLOG_INFO("Scheduler initialised with {} tasks (startup spread {}s, jitter {}%, max rate {}/s)", heap_.size(),
+                startup_spread, jitter_percent_, max_dispatch_rate_);
+    if (restored > 0) {
+        SPDLOG_INFO("Resumed the saved schedule of {} tasks", restored);
+    }
 }
 
-bool Scheduler::Impl::check_force_update(ScheduleEntry &entry, std::chrono::steady_clock::time_point now) noexcept {
-    if (entry.force_update_interval <= 0) {
+bool Scheduler::Impl::check_force_update(TaskTimer &timer, Clock::time_point now) noexcept {
+    if (timer.force_update_interval <= 0) {
         return false;
     }
 
-    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - entry.last_force_update).count();
+    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - timer.last_force_update).count();
 
-    if (elapsed >= entry.force_update_interval) {
-        entry.last_force_update = now;
+    if (elapsed >= timer.force_update_interval) {
+        timer.last_force_update = now;
         return true;
     }
 
     return false;
 }
 
-std::vector<UpdateTask> Scheduler::Impl::pop_all_due() {
-    std::lock_guard lock(mtx_);
-    const auto now = std::chrono::steady_clock::now();
+void Scheduler::Impl::sift_down(std::size_t pos) noexcept {
+    const auto size = heap_.size();
+    const auto node = heap_[pos];
 
-    std::vector<UpdateTask> due;
-    while (!heap_.empty() && now >= heap_.top().deadline) {
-        auto entry = heap_.top();
-        heap_.pop();
+    while (true) {
+        const auto first_child = pos * HEAP_ARITY + 1;
+        if (first_child >= size) {
+            break;
+        }
 
-        entry.task.force_update = check_force_update(entry, now);
-        due.push_back(entry.task); // copy — entry stays intact for re-queue
+        const auto last_child = std::min(first_child + HEAP_ARITY, size);
+        auto best = first_child;
+        for (auto child = first_child + 1; child < last_child; ++child) {
+            if (heap_[child].deadline < heap_[best].deadline) {
+                best = child;
+            }
+        }
 
-        // Re-queue the entry with its next deadline for the next cycle.
-        entry.deadline = now + std::chrono::seconds(entry.update_interval);
-        entry.task.force_update = false;
-        heap_.push(std::move(entry));
-        cv_.notify_one();
+        if (heap_[best].deadline >= node.deadline) {
+            break;
+        }
+
+        heap_[pos] = heap_[best];
+        pos = best;
     }
 
-    return due;
+    heap_[pos] = node;
+}
+
+void Scheduler::Impl::heapify() noexcept {
+    if (heap_.size() < 2) {
+        return;
+    }
+
+    for (auto pos = (heap_.size() - 2) / HEAP_ARITY + 1; pos-- > 0;) {
+        sift_down(pos);
+    }
+}
+
+Clock::time_point Scheduler::Impl::next_deadline(const TaskTimer &timer, Clock::time_point now) const {
+    const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::seconds(timer.update_interval));
+    if (jitter_percent_ <= 0 || timer.update_interval <= 0) {
+        return now + interval;
+    }
+
+    const auto bound = interval.count() * jitter_percent_ / 100;
+    std::uniform_int_distribution<Clock::rep> dist(-bound, bound);
+    return now + interval + Clock::duration(dist(Utils::Random::engine()));
+}
+
+std::size_t Scheduler::Impl::dispatch_budget(Clock::time_point now) noexcept {
+    if (max_dispatch_rate_ == 0) {
+        return heap_.size();
+    }
+
+    if (now - window_start_ >= RATE_WINDOW) {
+        window_start_ = now;
+        window_dispatched_ = 0;
+    }
+
+    return std::min(heap_.size(), max_dispatch_rate_ - window_dispatched_);
+}
+
+void Scheduler::Impl::restore(const StateStore::Schedule &saved, TaskTimer &timer, HeapNode &node,
+                              Clock::time_point now, StateStore::WallClock::time_point wall_now) noexcept {
+    // A deadline in the past means the task fell due while we were down.
+    auto deadline = std::max(from_wall_clock(saved.next_deadline, wall_now, now), now);
+    if (timer.update_interval > 0) {
+        deadline = std::min(deadline, now + std::chrono::seconds(timer.update_interval));
+    }
+    node.deadline = deadline;
+
+    // Never credit a forced update that lies in the future.
+    timer.last_force_update = std::min(from_wall_clock(saved.last_force_update, wall_now, now), now);
+}
+
+StateStore::Schedule Scheduler::Impl::schedule_of(const HeapNode &node, Clock::time_point now,
+                                                  StateStore::WallClock::time_point wall_now) const {
+    const auto &task = tasks_[node.index];
+    return StateStore::Schedule{
+        .fqdn = task.fqdn,
+        .type = task.config.type,
+        .last_force_update = to_wall_clock(timers_[node.index].last_force_update, now, wall_now),
+        .next_deadline = to_wall_clock(node.deadline, now, wall_now),
+    };
+}
+
+void Scheduler::Impl::persist(std::span<const StateStore::Schedule> schedules) const noexcept {
+    try {
+        state_->put_schedules(schedules);
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to save the schedule of {} task(s): {}", schedules.size(), e.what());
+    }
+}
+
+void Scheduler::Impl::pop_all_due(std::vector<DueTask> &due) {
+    std::vector<StateStore::Schedule> schedules;
+    {
+        std::lock_guard lock(mtx_);
+        const auto now = Clock::now();
+        const auto wall_now = StateStore::WallClock::now();
+
+        due.clear();
+
+        // Every task is re-queued as soon as it is popped, so the heap never
+        // shrinks.  Bounding the loop by the heap size guarantees termination
+        // even for a zero interval (the re-queued deadline would still be due).
+        // With a dispatch rate the bound shrinks further; the tasks left over
+        // stay due and go out once the rate window rolls over.
+        const auto budget = dispatch_budget(now);
+        for (std::size_t popped = 0; popped < budget && now >= heap_.front().deadline; ++popped) {
+            auto &top = heap_.front();
+            auto &timer = timers_[top.index];
+
+            due.push_back(DueTask{
+                .task = &tasks_[top.index],
+                .force_update = check_force_update(timer, now),
+            });
+            ++timer.runs_in_flight;
+
+            // Re-queue in place with the next deadline for the next cycle.
+            top.deadline = next_deadline(timer, now);
+            if (state_ != nullptr) {
+                schedules.push_back(schedule_of(top, now, wall_now));
+            }
+            sift_down(0);
+        }
+
+        window_dispatched_ += due.size();
+        if (!due.empty()) {
+            cv_.notify_one();
+        }
+    }
+
+    if (!schedules.empty()) {
+        persist(schedules);
+    }
 }
 
 bool Scheduler::Impl::wait_for_next() {
@@ -148,12 +389,86 @@ bool Scheduler::Impl::wait_for_next() {
     if (heap_.empty()) {
         cv_.wait(lock, [this] { return stop_token_.stop_requested(); });
     } else {
-        cv_.wait_until(lock, heap_.top().deadline, [this] { return stop_token_.stop_requested(); });
+        // Once the rate window is exhausted, due tasks must wait for the
+        // next window rather than spinning on an already-passed deadline.
+        auto wake = heap_.front().deadline;
+        if (max_dispatch_rate_ > 0 && window_dispatched_ >= max_dispatch_rate_) {
+            wake = std::max(wake, window_start_ + RATE_WINDOW);
+        }
+        cv_.wait_until(lock, wake, [this] { return stop_token_.stop_requested() || wake_pending_; });
     }
 
+    wake_pending_ = false;
     return !stop_token_.stop_requested();
 }
 
+void Scheduler::Impl::notify_interface_changed(std::string_view interface_name) {
+    std::lock_guard lock(mtx_);
+    const auto now = Clock::now();
+
+    bool changed = false;
+    for (auto &node: heap_) {
+        const auto &config = tasks_[node.index].config;
+        if (config.ip_source != Config::IpSource::INTERFACE || config.interface != interface_name) {
+            continue;
+        }
+
+        // Changes come in bursts (an address removed, then its successor
+        // added): a task still running is made due once it ends, so that
+        // one record never has two updates in flight.
+        if (auto &timer = timers_[node.index]; timer.runs_in_flight > 0) {
+            timer.changed_again = true;
+        } else if (node.deadline > now) {
+            node.deadline = now;
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    heapify();
+    wake_pending_ = true;
+    cv_.notify_all();
+}
+
+void Scheduler::Impl::complete(std::span<const DueTask> tasks) {
+    std::lock_guard lock(mtx_);
+    const auto now = Clock::now();
+
+    bool changed = false;
+    for (const auto &handle: tasks) {
+        const auto index = static_cast<std::size_t>(handle.task - tasks_.data());
+        auto &timer = timers_[index];
+        if (timer.runs_in_flight == 0 || --timer.runs_in_flight > 0 || !timer.changed_again) {
+            continue;
+        }
+
+        timer.changed_again = false;
+        const auto node = std::ranges::find(heap_, static_cast<std::uint32_t>(index), &HeapNode::index);
+        if (node->deadline > now) {
+            node->deadline = now;
+            changed = true;
+        }
+    }
+
+    if (!changed) {
+        return;
+    }
+
+    heapify();
+    wake_pending_ = true;
+    cv_.notify_all();
+}
+
+void Scheduler::Impl::prepare_tasks(const std::function<void(UpdateTask &)> &visitor) {
+    std::lock_guard lock(mtx_);
+    for (auto &task: tasks_) {
+        visitor(task);
+    }
+}
+
 bool Scheduler::Impl::has_pending() const {
     std::lock_guard lock(mtx_);
     return !heap_.empty();
@@ -163,20 +478,38 @@ bool Scheduler::Impl::has_pending() const {
 // Scheduler public API — thin delegation to Impl
 // ---------------------------------------------------------------------------
 
-Scheduler::Scheduler(const Config::AppConfig &config, std::stop_token stop_token)
-    : impl_(std::make_unique<Impl>(config, std::move(stop_token))) {
+Scheduler::Scheduler(const Config::AppConfig &config, std::stop_token stop_token, StateStore *state)
+    : impl_(std::make_unique<Impl>(config, std::move(stop_token), state)) {
 }
 
 Scheduler::~Scheduler() = default;
 
-std::vector<UpdateTask> Scheduler::pop_all_due() {
-    return impl_->pop_all_due();
+std::vector<DueTask> Scheduler::pop_all_due() {
+    std::vector<DueTask> due;
+    impl_->pop_all_due(due);
+    return due;
+}
+
+void Scheduler::pop_all_due(std::vector<DueTask> &due) {
+    impl_->pop_all_due(due);
 }
 
 bool Scheduler::wait_for_next() {
     return impl_->wait_for_next();
 }
 
+void Scheduler::notify_interface_changed(std::string_view interface_name) {
+    impl_->notify_interface_changed(interface_name);
+}
+
+void Scheduler::complete(std::span<const DueTask> tasks) {
+    impl_->complete(tasks);
+}
+
+void Scheduler::prepare_tasks(const std::function<void(UpdateTask &)> &visitor) {
+    impl_->prepare_tasks(visitor);
+}
+
 bool Scheduler::has_pending() const {
     return impl_->has_pending();
 }
@@ -5,9 +5,12 @@
 #ifndef YADDNSC_CORE_SCHEDULER_H
 #define YADDNSC_CORE_SCHEDULER_H
 
+#include <functional>
 #include <memory>
+#include <span>
 #include <vector>
 #include <stop_token>
+#include <string_view>
 
 #include "mixin.h"
 
@@ -15,43 +18,98 @@ namespace Config {
     struct AppConfig;
 }
 
+struct DueTask;
 struct UpdateTask;
+class StateStore;
 
 /// Scheduler — pure timer queue for periodic DDNS update tasks.
 ///
-/// Maintains a min-heap of internal nodes sorted by deadline.
-///   - Constructor populates the heap from the config.
-///   - pop_all_due()  returns tasks whose deadline has passed,
-///                    and automatically re-queues each one with
-///                    its next deadline.
-///   - wait_for_next() blocks until the nearest deadline or stop.
+/// Every task is stored once in an arena that is built by the constructor
+/// and never resized afterwards.  The timer queue itself is a compact 4-ary
+/// min-heap of (deadline, arena index) nodes.
+///   - Constructor populates the arena and the heap from the config.
+///   - pop_all_due()  returns handles to tasks whose deadline has passed,
+///                    and re-queues each one with its next deadline by
+///                    updating its heap node in place.
+///   - wait_for_next() blocks until the nearest deadline, an interface
+///                    change (notify_interface_changed()) or stop.
+///   - complete()     reports that dispatched tasks have finished running.
+///
+/// A tick costs O(due · log n) and, with the buffer overload of
+/// pop_all_due(), performs no heap allocation once the buffer has grown.
+///
+/// Load spreading (Config::SchedulerConfig, all disabled by default):
+///   - startup_spread     gives each task a stable, fqdn-hashed first-run
+///                        offset so equal intervals do not fire together.
+///   - jitter             randomises every re-queued deadline by up to
+///                        ±jitter% of the task's interval.
+///   - max_dispatch_rate  caps the tasks handed out per second; the rest
+///                        stay due and wait_for_next() sleeps until the
+///                        next window.
+///
+/// With a StateStore, the scheduling phase (next deadline and last forced
+/// update) of every task is saved each time it is dispatched and restored
+/// by the constructor, so a restart resumes the previous schedule instead
+/// of running every task at once.
 ///
 /// Holds no reference to the Updater or any thread pool — the caller
 /// (Manager) is responsible for executing the returned tasks.
 ///
 /// @note Thread-safe: all public methods acquire an internal mutex.
 ///       wait_for_next() and pop_all_due() must not be called concurrently
-///       (the caller's loop owns the scheduling sequence).
+///       (the caller's loop owns the scheduling sequence).  Returned
+///       DueTask handles stay valid for the lifetime of the Scheduler.
 class Scheduler {
 public:
     /// Construct and populate the schedule from config.
     /// @param config      Application config with domain/subdomain definitions.
     /// @param stop_token  Token used to wake the scheduler on shutdown.
-    explicit Scheduler(const Config::AppConfig &config, std::stop_token stop_token);
+    /// @param state       Optional persistent state (non-owning, must outlive
+    ///                    the Scheduler); nullptr disables persistence.
+    explicit Scheduler(const Config::AppConfig &config, std::stop_token stop_token, StateStore *state = nullptr);
 
     ~Scheduler();
 
-    /// Return all tasks whose deadline has passed.
+    /// Return handles to all tasks whose deadline has passed.
     ///
     /// Each returned task is automatically re-queued with its next deadline
     /// internally. The force_update flag is evaluated before returning.
-    /// @return  A vector of tasks ready to execute.
-    [[nodiscard]] std::vector<UpdateTask> pop_all_due();
+    /// @return  A vector of handles to the tasks ready to execute.
+    [[nodiscard]] std::vector<DueTask> pop_all_due();
+
+    /// Allocation-free variant of pop_all_due().
+    ///
+    /// Clears @p due and fills it with the handles of all due tasks, reusing
+    /// the buffer's existing capacity.
+    /// @param due  Caller-owned output buffer.
+    void pop_all_due(std::vector<DueTask> &due);
 
-    /// Block until the nearest task deadline is reached or stop is requested.
+    /// Block until the nearest task deadline is reached, an interface change
+    /// is reported, or stop is requested.
     /// @return false if stop was requested (caller should exit the loop).
     [[nodiscard]] bool wait_for_next();
 
+    /// Make every task that reads its address from @p interface_name due
+    /// now and wake wait_for_next().  Tasks on other interfaces keep their
+    /// deadlines.  A task whose run has not been complete()d yet is made due
+    /// when it is, however many changes arrive meanwhile, so a burst of
+    /// changes never overlaps two runs of one record.  Safe to call from any
+    /// thread.
+    /// @param interface_name  Interface whose address list changed.
+    void notify_interface_changed(std::string_view interface_name);
+
+    /// Report that the runs of @p tasks, handed out by pop_all_due(), have
+    /// finished.  A task whose interface changed while it ran is made due
+    /// now, waking wait_for_next().  Safe to call from any thread.
+    /// @param tasks  Handles returned by pop_all_due(), each reported once.
+    void complete(std::span<const DueTask> tasks);
+
+    /// Visit every task once so the caller can attach per-task state
+    /// (such as the prepared driver handle).  Must be called before the
+    /// first pop_all_due(), while no DueTask handle is outstanding.
+    /// @param visitor  Called once per task; exceptions propagate.
+    void prepare_tasks(const std::function<void(UpdateTask &)> &visitor);
+
     /// Check if there are any pending tasks in the heap.
     /// @return true if at least one task is scheduled.
     [[nodiscard]] bool has_pending() const;
@@ -0,0 +1,556 @@
+//
+// Created by Kotarou on 2026/7/21.
+//
+
+#include "state_store.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "util/bytes.hpp"
+#include "util/fd.hpp"
+
+#include "fmt.hpp"
+#include <spdlog/spdlog.h>
+
+namespace {
+    constexpr std::array<std::uint8_t, 8> MAGIC{'Y', 'D', 'N', 'S', 'S', 'T', 0x00, 0x01};
+
+    /// Frame header: u32 payload length + u32 payload checksum.
+    constexpr std::size_t FRAME_HEADER = 8;
+
+    /// Upper bound of a single payload; anything larger is a corrupt length.
+    constexpr std::size_t MAX_PAYLOAD = 4096;
+
+    /// The log is compacted once it holds at least this many records and
+    /// more than COMPACT_RATIO times the number of live entries.
+    constexpr std::size_t COMPACT_MIN_RECORDS = 256;
+    constexpr std::size_t COMPACT_RATIO = 4;
+
+    enum class RecordTag : std::uint8_t {
+        PUBLISHED = 1,
+        SCHEDULE = 2,
+    };
+
+    using Key = std::pair<std::string, RecordKind>;
+
+    /// FNV-1a (32-bit), used as the per-record checksum.
+    [[nodiscard]] std::uint32_t checksum(std::span<const std::uint8_t> data) noexcept {
+        std::uint32_t hash = 0x811c9dc5U;
+        for (const auto byte: data) {
+            hash ^= byte;
+            hash *= 0x01000193U;
+        }
+        return hash;
+    }
+
+    [[nodiscard]] std::int64_t to_millis(StateStore::WallClock::time_point tp) noexcept {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count();
+    }
+
+    [[nodiscard]] StateStore::WallClock::time_point from_millis(std::int64_t ms) noexcept {
+        return StateStore::WallClock::time_point(
+            std::chrono::duration_cast<StateStore::WallClock::duration>(std::chrono::milliseconds(ms)));
+    }
+
+    // ---- encoding ----------------------------------------------------------
+
+    class Encoder {
+    public:
+        void u8(std::uint8_t value) {
+            buf_.push_back(value);
+        }
+
+        void u16(std::uint16_t value) {
+            const auto pos = grow(2);
+            Utils::Bytes::write_u16_be(buf_.data() + pos, value);
+        }
+
+        void u32(std::uint32_t value) {
+            const auto pos = grow(4);
+            Utils::Bytes::write_u32_be(buf_.data() + pos, value);
+        }
+
+        void i64(std::int64_t value) {
+            const auto bits = static_cast<std::uint64_t>(value);
+            u32(static_cast<std::uint32_t>(bits >> 32));
+            u32(static_cast<std::uint32_t>(bits));
+        }
+
+        void str(std::string_view value) {
+            if (value.size() > MAX_PAYLOAD) {
+                throw std::runtime_error(fmt::format("State entry too long ({} bytes)", value.size()));
+            }
+            u16(static_cast<std::uint16_t>(value.size()));
+            buf_.insert(buf_.end(), value.begin(), value.end());
+        }
+
+        [[nodiscard]] const std::vector<std::uint8_t> &bytes() const noexcept {
+            return buf_;
+        }
+
+    private:
+        std::size_t grow(std::size_t n) {
+            const auto pos = buf_.size();
+            buf_.resize(pos + n);
+            return pos;
+        }
+
+        std::vector<std::uint8_t> buf_;
+    };
+
+    /// Bounds-checked reader; once a read overruns, every later read fails too.
+    class Decoder {
+    public:
+        explicit Decoder(std::span<const std::uint8_t> data) noexcept : data_(data) {
+        }
+
+        [[nodiscard]] std::optional<std::uint8_t> u8() noexcept {
+            if (!take(1)) {
+                return std::nullopt;
+            }
+            return data_[pos_ - 1];
+        }
+
+        [[nodiscard]] std::optional<std::int64_t> i64() noexcept {
+            if (!take(8)) {
+                return std::nullopt;
+            }
+            const auto *p = data_.data() + pos_ - 8;
+            const auto bits = static_cast<std::uint64_t>(Utils::Bytes::read_u32_be(p)) << 32 |
+                              Utils::Bytes::read_u32_be(p + 4);
+            return static_cast<std::int64_t>(bits);
+        }
+
+        [[nodiscard]] std::optional<std::string> str() noexcept {
+            if (!take(2)) {
+                return std::nullopt;
+            }
+            const auto len = Utils::Bytes::read_u16_be(data_.data() + pos_ - 2);
+            if (!take(len)) {
+                return std::nullopt;
+            }
+            return std::string(reinterpret_cast<const char *>(data_.data() + pos_ - len), len);
+        }
+
+        [[nodiscard]] bool at_end() const noexcept {
+            return pos_ == data_.size();
+        }
+
+    private:
+        [[nodiscard]] bool take(std::size_t n) noexcept {
+            if (data_.size() - pos_ < n) {
+                pos_ = data_.size();
+                return false;
+            }
+            pos_ += n;
+            return true;
+        }
+
+        std::span<const std::uint8_t> data_;
+        std::size_t pos_{0};
+    };
+
+    [[nodiscard]] std::optional<RecordKind> to_record_kind(std::uint8_t value) noexcept {
+        switch (value) {
+            case static_cast<std::uint8_t>(RecordKind::A):
+                return RecordKind::A;
+            case static_cast<std::uint8_t>(RecordKind::AAAA):
+                return RecordKind::AAAA;
+            case static_cast<std::uint8_t>(RecordKind::TXT):
+                return RecordKind::TXT;
+            default:
+                return std::nullopt;
+        }
+    }
+
+    void encode(Encoder &enc, const StateStore::Published &state) {
+        enc.u8(static_cast<std::uint8_t>(RecordTag::PUBLISHED));
+        enc.u8(static_cast<std::uint8_t>(state.type));
+        enc.str(state.fqdn);
+        enc.str(state.ip_addr);
+        enc.i64(to_millis(state.confirmed_at));
+    }
+
+    void encode(Encoder &enc, const StateStore::Schedule &state) {
+        enc.u8(static_cast<std::uint8_t>(RecordTag::SCHEDULE));
+        enc.u8(static_cast<std::uint8_t>(state.type));
+        enc.str(state.fqdn);
+        enc.i64(to_millis(state.last_force_update));
+        enc.i64(to_millis(state.next_deadline));
+    }
+
+    /// Append one framed record to @p out.
+    template<typename T>
+    void append_frame(std::vector<std::uint8_t> &out, const T &state) {
+        Encoder payload;
+        encode(payload, state);
+        const auto &bytes = payload.bytes();
+
+        Encoder header;
+        header.u32(static_cast<std::uint32_t>(bytes.size()));
+        header.u32(checksum(bytes));
+
+        out.insert(out.end(), header.bytes().begin(), header.bytes().end());
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    void write_all(int fd, std::span<const std::uint8_t> data, const std::filesystem::path &path) {
+        while (!data.empty()) {
+            const auto written = ::write(fd, data.data(), data.size());
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error(fmt::format(R"(Failed to write state file "{}": {})", path.string(),
+                                                     std::strerror(errno)));
+            }
+            data = data.subspan(static_cast<std::size_t>(written));
+        }
+    }
+
+    [[nodiscard]] Utils::UniqueFd open_log(const std::filesystem::path &path, int extra_flags) {
+        Utils::UniqueFd fd(::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC | extra_flags, 0600));
+        if (!fd) {
+            throw std::runtime_error(fmt::format(R"(Failed to open state file "{}": {})", path.string(),
+                                                 std::strerror(errno)));
+        }
+        return fd;
+    }
+
+    /// fsync() the directory holding @p path, so that a rename() into it
+    /// survives a crash.
+    void sync_parent_directory(const std::filesystem::path &path) {
+        auto dir_path = path.parent_path();
+        if (dir_path.empty()) {
+            dir_path = ".";
+        }
+
+        const Utils::UniqueFd dir(::open(dir_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        if (!dir || ::fsync(dir.get()) != 0) {
+            throw std::runtime_error(fmt::format(R"(Failed to sync state directory "{}": {})", dir_path.string(),
+                                                 std::strerror(errno)));
+        }
+    }
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// StateStore::Impl
+// ---------------------------------------------------------------------------
+
+struct StateStore::Impl {
+    explicit Impl(std::filesystem::path path);
+
+    /// Map the file read-only and replay every intact record.
+    /// @return Offset just past the last intact record.
+    std::size_t load();
+
+    /// Decode and apply a single record payload.
+    /// @return false if the payload is of an unknown type (written by another
+    ///         version) or does not decode; the record is then skipped.
+    bool apply(std::span<const std::uint8_t> payload);
+
+    template<typename T>
+    void append(const T &state);
+
+    template<typename T>
+    void append_all(std::span<const T> states);
+
+    void compact();
+
+    void maybe_compact();
+
+    std::filesystem::path path_;
+    Utils::UniqueFd fd_;
+    std::size_t record_count_{0}; // records currently in the log, live or superseded
+
+    std::map<Key, Published> published_;
+    std::map<Key, Schedule> schedules_;
+
+    mutable std::mutex mtx_;
+};
+
+StateStore::Impl::Impl(std::filesystem::path path) : path_(std::move(path)) {
+    fd_ = open_log(path_, O_APPEND);
+
+    const auto good_end = load();
+
+    struct stat st{};
+    if (::fstat(fd_.get(), &st) == 0 && static_cast<std::size_t>(st.st_size) != good_end) {
+        // Drop a torn tail so that new records are appended right after the
+        // last intact one.
+        if (::ftruncate(fd_.get(), static_cast<off_t>(good_end)) != 0) {
+            throw std::runtime_error(fmt::format(R"(Failed to truncate state file "{}": {})", path_.string(),
+                                                 std::strerror(errno)));
+        }
+    }
+
+    if (good_end == 0) {
+        write_all(fd_.get(), MAGIC, path_);
+    }
+
+    SPDLOG_INFO(R"(Loaded runtime state from "{}" ({} published, {} scheduled))", path_.string(), published_.size(),
+                schedules_.size());
+}
+
+std::size_t StateStore::Impl::load() {
+    struct stat st{};
+    if (::fstat(fd_.get(), &st) != 0) {
+        throw std::runtime_error(fmt::format(R"(Failed to stat state file "{}": {})", path_.string(),
+                                             std::strerror(errno)));
+    }
+
+    const auto size = static_cast<std::size_t>(st.st_size);
+    if (size == 0) {
+        return 0;
+    }
+
+    auto *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd_.get(), 0);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(fmt::format(R"(Failed to map state file "{}": {})", path_.string(),
+                                             std::strerror(errno)));
+    }
+
+    const std::span data(static_cast<const std::uint8_t *>(addr), size);
+
+    // Only a file that starts with our magic is ours to append to (or, cut
+    // short inside it, to initialise).  Anything else is likely a mistyped
+    // path to some other file, which must be left alone.
+    const auto magic_size = std::min(size, MAGIC.size());
+    if (std::memcmp(data.data(), MAGIC.data(), magic_size) != 0) {
+        ::munmap(addr, size);
+        throw std::runtime_error(fmt::format(R"(State file "{}" is not a yaddnsc state file, leaving it untouched)",
+                                             path_.string()));
+    }
+
+    std::size_t pos = 0;
+    std::size_t skipped = 0;
+    if (size >= MAGIC.size()) {
+        pos = MAGIC.size();
+        while (data.size() - pos >= FRAME_HEADER) {
+            const auto length = Utils::Bytes::read_u32_be(data, pos);
+            const auto expected = Utils::Bytes::read_u32_be(data, pos + 4);
+            if (length > MAX_PAYLOAD || data.size() - pos - FRAME_HEADER < length) {
+                break;
+            }
+
+            const auto payload = data.subspan(pos + FRAME_HEADER, length);
+            if (checksum(payload) != expected) {
+                break;
+            }
+
+            // An intact record this version does not understand, such as a
+            // newer record type after a downgrade, is skipped, not treated
+            // as the end of the log: the records after it are still good.
+            if (!apply(payload)) {
+                ++skipped;
+            }
+
+            pos += FRAME_HEADER + length;
+            ++record_count_;
+        }
+
+        if (skipped != 0) {
+            SPDLOG_WARN(R"(State file "{}" has {} record(s) this version cannot read, skipping them)", path_.string(),
+                        skipped);
+        }
+
+        if (pos != size) {
+            SPDLOG_WARN(R"(State file "{}" has {} trailing bytes that are not intact records, dropping them)",
+                        path_.string(), size - pos);
+        }
+    }
+
+    ::munmap(addr, size);
+    return pos;
+}
+
+bool StateStore::Impl::apply(std::span<const std::uint8_t> payload) {
+    Decoder dec(payload);
+
+    // Check the tag first: another record type may lay out the rest differently.
+    const auto tag = dec.u8();
+    if (!tag || (*tag != std::to_underlying(RecordTag::PUBLISHED) && *tag != std::to_underlying(RecordTag::SCHEDULE))) {
+        return false;
+    }
+
+    const auto kind = dec.u8().and_then(to_record_kind);
+    auto fqdn = dec.str();
+    if (!kind || !fqdn) {
+        return false;
+    }
+
+    switch (static_cast<RecordTag>(*tag)) {
+        case RecordTag::PUBLISHED: {
+            auto ip_addr = dec.str();
+            const auto confirmed_at = dec.i64();
+            if (!ip_addr || !confirmed_at || !dec.at_end()) {
+                return false;
+            }
+            published_.insert_or_assign(Key{*fqdn, *kind}, Published{
+                                            .fqdn = *fqdn,
+                                            .type = *kind,
+                                            .ip_addr = std::move(*ip_addr),
+                                            .confirmed_at = from_millis(*confirmed_at),
+                                        });
+            return true;
+        }
+        case RecordTag::SCHEDULE: {
+            const auto last_force_update = dec.i64();
+            const auto next_deadline = dec.i64();
+            if (!last_force_update || !next_deadline || !dec.at_end()) {
+                return false;
+            }
+            schedules_.insert_or_assign(Key{*fqdn, *kind}, Schedule{
+                                            .fqdn = *fqdn,
+                                            .type = *kind,
+                                            .last_force_update = from_millis(*last_force_update),
+                                            .next_deadline = from_millis(*next_deadline),
+                                        });
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename T>
+void StateStore::Impl::append(const T &state) {
+    std::vector<std::uint8_t> frame;
+    append_frame(frame, state);
+    // One write(2) per record on an O_APPEND descriptor: a crash leaves at
+    // most this record torn, which the next load() discards.
+    write_all(fd_.get(), frame, path_);
+    ++record_count_;
+    maybe_compact();
+}
+
+template<typename T>
+void StateStore::Impl::append_all(std::span<const T> states) {
+    std::vector<std::uint8_t> frames;
+    for (const auto &state: states) {
+        append_frame(frames, state);
+    }
+    // One write(2) for the whole batch: a crash leaves at most a torn tail,
+    // which the next load() discards.
+    write_all(fd_.get(), frames, path_);
+    record_count_ += states.size();
+    maybe_compact();
+}
+
+void StateStore::Impl::maybe_compact() {
+    const auto live = published_.size() + schedules_.size();
+    if (record_count_ >= COMPACT_MIN_RECORDS && record_count_ > live * COMPACT_RATIO) {
+        compact();
+    }
+}
+
+void StateStore::Impl::compact() {
+    std::vector<std::uint8_t> buf(MAGIC.begin(), MAGIC.end());
+    for (const auto &state: published_ | std::views::values) {
+        append_frame(buf, state);
+    }
+    for (const auto &state: schedules_ | std::views::values) {
+        append_frame(buf, state);
+    }
+
+    auto tmp_path = path_;
+    tmp_path += ".tmp";
+
+    {
+        auto tmp = open_log(tmp_path, O_TRUNC);
+        write_all(tmp.get(), buf, tmp_path);
+        if (::fsync(tmp.get()) != 0) {
+            throw std::runtime_error(fmt::format(R"(Failed to sync state file "{}": {})", tmp_path.string(),
+                                                 std::strerror(errno)));
+        }
+    }
+
+    std::filesystem::rename(tmp_path, path_);
+    fd_ = open_log(path_, O_APPEND);
+    sync_parent_directory(path_);
+
+    SPDLOG_DEBUG("Compacted state file from {} to {} records", record_count_,
+                 published_.size() + schedules_.size());
+    record_count_ = published_.size() + schedules_.size();
+}
+
+// ---------------------------------------------------------------------------
+// StateStore public API
+// ---------------------------------------------------------------------------
+
+StateStore::StateStore(std::filesystem::path path) : impl_(std::make_unique<Impl>(std::move(path))) {
+}
+
+StateStore::~StateStore() = default;
+
+std::optional<StateStore::Published> StateStore::published(std::string_view fqdn, RecordKind type) const {
+    std::lock_guard lock(impl_->mtx_);
+    const auto it = impl_->published_.find(Key{std::string(fqdn), type});
+    if (it == impl_->published_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+std::vector<StateStore::Published> StateStore::all_published() const {
+    std::lock_guard lock(impl_->mtx_);
+    const auto values = impl_->published_ | std::views::values;
+    return std::vector<Published>(values.begin(), values.end());
+}
+
+std::optional<StateStore::Schedule> StateStore::schedule(std::string_view fqdn, RecordKind type) const {
+    std::lock_guard lock(impl_->mtx_);
+    const auto it = impl_->schedules_.find(Key{std::string(fqdn), type});
+    if (it == impl_->schedules_.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+void StateStore::put_published(const Published &state) {
+    std::lock_guard lock(impl_->mtx_);
+    impl_->published_.insert_or_assign(Key{state.fqdn, state.type}, state);
+    impl_->append(state);
+}
+
+void StateStore::put_schedule(const Schedule &state) {
+    std::lock_guard lock(impl_->mtx_);
+    impl_->schedules_.insert_or_assign(Key{state.fqdn, state.type}, state);
+    impl_->append(state);
+}
+
+void StateStore::put_schedules(std::span<const Schedule> states) {
+    if (states.empty()) {
+        return;
+    }
+
+    std::lock_guard lock(impl_->mtx_);
+    for (const auto &state: states) {
+        impl_->schedules_.insert_or_assign(Key{state.fqdn, state.type}, state);
+    }
+    impl_->append_all(states);
+}
+
+void StateStore::compact() {
+    std::lock_guard lock(impl_->mtx_);
+    impl_->compact();
+}
+
+const std::filesystem::path &StateStore::path() const noexcept {
+    return impl_->path_;
+}
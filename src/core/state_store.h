@@ -0,0 +1,107 @@
+//
+// Created by Kotarou on 2026/7/21.
+//
+
+#ifndef YADDNSC_CORE_STATE_STORE_H
+#define YADDNSC_CORE_STATE_STORE_H
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mixin.h"
+#include "record_kind.h"
+
+/// StateStore — persistent runtime state that survives a restart.
+///
+/// Holds, per (fqdn, record kind):
+///   - the last address known to be published, and when it was confirmed;
+///   - the scheduling phase: the last forced update and the next deadline.
+///
+/// All timestamps are wall-clock (system_clock) so that they remain
+/// meaningful across a reboot; callers convert to and from steady_clock.
+///
+/// On-disk format: an 8-byte magic header followed by append-only records,
+/// each framed as [u32 length][u32 FNV-1a checksum][payload].  An update
+/// appends one record, so a crash can at worst tear the last record; the
+/// loader (which reads the file through mmap) stops at the first record
+/// that fails its length or checksum test and truncates the tail away.  An
+/// intact record of a type it does not know (written by another version) is
+/// skipped, and the records after it are still read.
+/// Once the log holds many superseded records it is compacted: the live
+/// state is written to a temporary file, fsync'ed and renamed over the
+/// original, which is atomic on POSIX file systems.
+///
+/// @note Thread-safe: every method acquires an internal mutex.
+class StateStore {
+public:
+    using WallClock = std::chrono::system_clock;
+
+    /// Last confirmed address of one record.
+    struct Published {
+        std::string fqdn;
+        RecordKind type{};
+        std::string ip_addr;
+        WallClock::time_point confirmed_at;
+    };
+
+    /// Scheduling phase of one task.
+    struct Schedule {
+        std::string fqdn;
+        RecordKind type{};
+        WallClock::time_point last_force_update;
+        WallClock::time_point next_deadline;
+    };
+
+    /// Open (creating if necessary) the state file and load its contents.
+    /// @param path  Location of the state file; the parent directory must exist.
+    /// @throws std::runtime_error if the file cannot be opened or created, or
+    ///         is a non-empty file that is not a state file (it is left as is).
+    explicit StateStore(std::filesystem::path path);
+
+    ~StateStore();
+
+    /// @return The stored published state for the record, if any.
+    [[nodiscard]] std::optional<Published> published(std::string_view fqdn, RecordKind type) const;
+
+    /// @return Every stored published state.
+    [[nodiscard]] std::vector<Published> all_published() const;
+
+    /// @return The stored schedule for the task, if any.
+    [[nodiscard]] std::optional<Schedule> schedule(std::string_view fqdn, RecordKind type) const;
+
+    /// Record a newly confirmed address and append it to the log.
+    /// @throws std::runtime_error if the record cannot be written.
+    void put_published(const Published &state);
+
+    /// Record the scheduling phase of a task and append it to the log.
+    /// @throws std::runtime_error if the record cannot be written.
+    void put_schedule(const Schedule &state);
+
+    /// Record the scheduling phase of several tasks, appended to the log with
+    /// a single write.
+    /// @throws std::runtime_error if the records cannot be written.
+    void put_schedules(std::span<const Schedule> states);
+
+    /// Rewrite the file with only the live state.
+    /// @throws std::runtime_error if the new file cannot be written.
+    void compact();
+
+    /// @return Path of the state file.
+    [[nodiscard]] const std::filesystem::path &path() const noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_CORE_STATE_STORE_H
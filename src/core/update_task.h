@@ -5,9 +5,11 @@
 #ifndef YADDNSC_CORE_UPDATE_TASK_H
 #define YADDNSC_CORE_UPDATE_TASK_H
 
+#include <cstdint>
 #include <string>
 
 #include "config/config.h"
+#include "interface/driver.h"
 
 /// UpdateTask — a self-contained value type describing one DNS record update
 ///              that the Updater should carry out.
@@ -17,6 +19,18 @@ struct UpdateTask {
     std::string driver_name;        ///< Name of the driver plugin to use
     std::string fqdn;               ///< Fully qualified domain name
     bool force_update{false};       ///< Skip IP-change check; always send update
+    int verify_interval{0};         ///< Seconds an unchanged published IP is trusted without a DNS check
+    DriverHandlePtr driver_handle;  ///< Parsed driver parameters; null until prepared by the Manager
+};
+
+/// DueTask — a lightweight handle to a scheduled UpdateTask that is due now.
+///
+/// The referenced task lives in the Scheduler's task arena and stays valid
+/// (and unchanged) for the Scheduler's whole lifetime, so handing out a
+/// handle never copies the task's configuration.
+struct DueTask {
+    const UpdateTask *task{nullptr}; ///< Non-owning; owned by the Scheduler
+    bool force_update{false};        ///< Skip IP-change check for this run
 };
 
 #endif // YADDNSC_CORE_UPDATE_TASK_H
@@ -4,12 +4,26 @@
 
 #include "updater.h"
 
+#include <algorithm>
+#include <chrono>
+#include <expected>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "dns/dispatcher.h"
 #include "interface/driver.h"
 #include "ip_source/base.h"
 #include "ip_source/factory.h"
+#include "ip_source/registry.h"
 
+#include "state_store.h"
 #include "update_task.h"
+#include "util/task.hpp"
 
 #include <glaze/json/generic.hpp>
 #include <magic_enum/magic_enum.hpp>
@@ -26,6 +40,12 @@ namespace {
         }
     }
 
+    // Whether two addresses are the same, ignoring the IPv6 scope ID (a DNS
+    // record has none).
+    [[nodiscard]] bool same_address(const InetAddress &a, const InetAddress &b) {
+        return a.get_family() == b.get_family() && a.get_address() == b.get_address();
+    }
+
     [[nodiscard]] std::unique_ptr<IpSourceBase> default_ip_source_factory(const Config::SubdomainConfig &cfg) {
         return IpSourceFactory::create(cfg);
     }
@@ -36,20 +56,88 @@ namespace {
 // ===========================================================================
 
 struct Updater::Impl {
+    /// Last address known to be live for one (fqdn, record type): either
+    /// confirmed by a DNS lookup or accepted by the driver.
+    struct PublishedState {
+        std::string ip_addr;
+        std::chrono::steady_clock::time_point confirmed_at;
+    };
+
+    using PublishedKey = std::pair<std::string, RecordKind>;
+
+    /// Driver input of one task that needs an update.
+    struct PreparedUpdate {
+        DriverHandlePtr handle;
+        DriverUpdateParams ctx;
+    };
+
     using IpSourceFactoryFunc = std::function<std::unique_ptr<IpSourceBase>(const Config::SubdomainConfig &)>;
 
-    explicit Impl(const ResolverDispatcher &resolver_dispatcher, IpSourceFactoryFunc factory);
+    Impl(const ResolverDispatcher &resolver_dispatcher, IpSourceFactoryFunc factory, StateStore *state);
 
     /// Execute a single update task: resolve local IP, compare with DNS
     /// record, and invoke the driver if the IP has changed.
-    void process(const UpdateTask &task, const Driver &driver, HttpClient &http_client) const;
+    [[nodiscard]] Utils::Task<> process(const UpdateTask &task, const Driver &driver, HttpClient &http_client,
+                                        const Utils::Executor &executor) const;
+
+    /// Prepare every task of a group and push the changed ones through a
+    /// single Driver::execute_batch_prepared() call.
+    [[nodiscard]] Utils::Task<> process_batch(std::span<const DueTask> tasks, const Driver &driver,
+                                              HttpClient &http_client, const Utils::Executor &executor) const;
+
+    /// Resolve the local IP and compare it with the DNS record.
+    /// @param force_update  Skip the DNS comparison and always update.
+    /// @return The driver input for this task, or std::nullopt when no
+    ///         update is needed (or no usable local address was found).
+    [[nodiscard]] Utils::Task<std::optional<PreparedUpdate>> prepare(const UpdateTask &task, bool force_update,
+                                                                     const Driver &driver,
+                                                                     const Utils::Executor &executor) const;
+
+    /// prepare() wrapped in a per-task catch-all, so that one failing task
+    /// does not drop the rest of its batch.
+    [[nodiscard]] Utils::Task<std::optional<PreparedUpdate>> try_prepare(const DueTask &due, const Driver &driver,
+                                                                         const Utils::Executor &executor) const;
+
+    /// resolve_local_address() on @p executor.
+    [[nodiscard]] Utils::Task<std::optional<InetAddress>> fetch_local_address(const Config::SubdomainConfig &config,
+                                                                              const Utils::Executor &executor) const;
+
+    /// The published addresses of @p task.  With an executor the lookup
+    /// holds no pool thread while queries are in flight, and the task
+    /// resumes on @p executor; without one it is dns_lookup(), inline.
+    [[nodiscard]] Utils::Task<AddressList> fetch_dns_records(const UpdateTask &task,
+                                                             const Utils::Executor &executor) const;
 
     /// Perform a DNS lookup for the given host and record type.
-    [[nodiscard]] std::vector<std::string> dns_lookup(const std::string &host, RecordKind type) const;
+    [[nodiscard]] AddressList dns_lookup(const std::string &host, RecordKind type) const;
+
+    /// The addresses of a lookup, or empty (logged) if it failed.
+    [[nodiscard]] static AddressList records_or_empty(const std::string &host,
+                                                      std::expected<AddressList, DnsErrorInfo> result);
 
     /// Resolve the local IP address from the configured IP source.
     [[nodiscard]] std::optional<InetAddress> resolve_local_address(const Config::SubdomainConfig &config) const;
 
+    /// True when @p ip_addr was confirmed for this record less than
+    /// task.verify_interval seconds ago, so the DNS comparison can be skipped.
+    [[nodiscard]] bool recently_confirmed(const UpdateTask &task, const std::string &ip_addr) const;
+
+    /// True when any address was confirmed for this record less than
+    /// task.verify_interval seconds ago, i.e. the DNS lookup will likely
+    /// be skipped and is not worth starting before the local IP is known.
+    [[nodiscard]] bool recently_confirmed(const UpdateTask &task) const;
+
+    /// Remember that @p ip_addr is now the published address of the record,
+    /// and save it to the state store if there is one.
+    void mark_published(const std::string &fqdn, RecordKind type, const std::string &ip_addr) const;
+
+    /// Seed the published-state cache from the state store.
+    void restore_published();
+
+    /// The task's driver handle, prepared by the Manager at startup; tasks
+    /// built without one (tests, direct callers) are prepared on demand.
+    [[nodiscard]] static DriverHandlePtr driver_handle(const UpdateTask &task, const Driver &driver);
+
     /// Build the driver configuration string from the update task.
     [[nodiscard]] static DriverConfig build_driver_parameters(const UpdateTask &task);
 
@@ -60,40 +148,148 @@ struct Updater::Impl {
     /// Non-owning reference to the resolver dispatcher (owned by Manager::Impl).
     const ResolverDispatcher &dispatcher_;
 
-    /// IP source factory (injectable for testing).
-    IpSourceFactoryFunc ip_factory_;
+    /// Shared, single-flight IP sources built by the (injectable) factory.
+    IpSourceRegistry ip_sources_;
+
+    /// Optional persistent state (owned by Manager::Impl).
+    StateStore *state_;
+
+    /// Published-state cache, keyed by (fqdn, record kind).
+    mutable std::mutex published_mtx_;
+    mutable std::map<PublishedKey, PublishedState> published_;
 };
 
-Updater::Impl::Impl(const ResolverDispatcher &resolver_dispatcher, IpSourceFactoryFunc factory)
-    : dispatcher_(resolver_dispatcher), ip_factory_(std::move(factory)) {
+Updater::Impl::Impl(const ResolverDispatcher &resolver_dispatcher, IpSourceFactoryFunc factory, StateStore *state)
+    : dispatcher_(resolver_dispatcher), ip_sources_(std::move(factory)), state_(state) {
+    if (state_ != nullptr) {
+        restore_published();
+    }
+}
+
+Utils::Task<> Updater::Impl::process(const UpdateTask &task, const Driver &driver, HttpClient &http_client,
+                                     const Utils::Executor &executor) const {
+    const auto item = co_await prepare(task, task.force_update, driver, executor);
+    if (!item) {
+        co_return;
+    }
+
+    // --- Step 4: delegate to driver via HttpClient --------------------------
+
+    const auto &[handle, ctx] = *item;
+    const bool accepted = co_await Utils::offload(executor, [&] {
+        return driver.execute_prepared(*handle, ctx, http_client);
+    });
+    if (!accepted) {
+        co_return;
+    }
+
+    mark_published(ctx.fqdn, task.config.type, ctx.ip_addr);
+    // The cached answer is the value just replaced.
+    dispatcher_.invalidate(ctx.fqdn);
+
+    SPDLOG_INFO("Domain {} ({}) updated to {}", ctx.fqdn, ctx.rd_type, ctx.ip_addr);
 }
 
-void Updater::Impl::process(const UpdateTask &task, const Driver &driver, HttpClient &http_client) const {
+Utils::Task<> Updater::Impl::process_batch(std::span<const DueTask> tasks, const Driver &driver,
+                                           HttpClient &http_client, const Utils::Executor &executor) const {
+    // The tasks of a group are independent until the driver call, so they
+    // are all prepared concurrently.
+    std::vector<Utils::Task<std::optional<PreparedUpdate> > > preparing;
+    preparing.reserve(tasks.size());
+    for (const auto &due: tasks) {
+        preparing.push_back(try_prepare(due, driver, executor));
+    }
+    auto prepared = co_await Utils::when_all(std::move(preparing));
+
+    std::vector<PreparedUpdate> updates;
+    std::vector<RecordKind> kinds; // parallel to updates
+    updates.reserve(tasks.size());
+    kinds.reserve(tasks.size());
+    for (std::size_t i = 0; i < tasks.size(); ++i) {
+        if (prepared[i]) {
+            updates.push_back(std::move(*prepared[i]));
+            kinds.push_back(tasks[i].task->config.type);
+        }
+    }
+
+    if (updates.empty()) {
+        co_return;
+    }
+
+    // --- Step 4: delegate the whole group to the driver ---------------------
+
+    // The items borrow from updates, which keeps the handles alive.
+    std::vector<DriverPreparedItem> items;
+    items.reserve(updates.size());
+    for (const auto &[handle, ctx]: updates) {
+        items.push_back(DriverPreparedItem{.handle = *handle, .ctx = ctx});
+    }
+
+    SPDLOG_DEBUG("Sending {} of {} records of {} to driver {} as one batch", items.size(), tasks.size(),
+                 tasks.front().task->domain_name, tasks.front().task->driver_name);
+    const auto results = co_await Utils::offload(executor, [&] {
+        return driver.execute_batch_prepared(items, http_client);
+    });
+
+    for (std::size_t i = 0; i < items.size(); ++i) {
+        const auto &ctx = items[i].ctx;
+        if (i < results.size() && results[i]) {
+            mark_published(ctx.fqdn, kinds[i], ctx.ip_addr);
+            dispatcher_.invalidate(ctx.fqdn);
+            SPDLOG_INFO("Domain {} ({}) updated to {}", ctx.fqdn, ctx.rd_type, ctx.ip_addr);
+        }
+    }
+}
+
+Utils::Task<std::optional<Updater::Impl::PreparedUpdate> > Updater::Impl::prepare(
+    const UpdateTask &task, bool force_update, const Driver &driver, const Utils::Executor &executor) const {
     auto rd_type_name = magic_enum::enum_name(task.config.type);
     const auto rd_type = rd_type_name.empty() ? "UNKNOWN" : rd_type_name;
 
-    // --- Step 1: local IP ---------------------------------------------------
+    // --- Step 1: local IP, overlapped with the DNS lookup -------------------
+
+    // The lookup does not depend on the local address, so when an executor
+    // can run the two at once it is started alongside the IP source.  It is
+    // only started early when its answer will be needed: not for a forced
+    // update, and not when a recent confirmation will likely skip it.
+    std::optional<InetAddress> local_ip;
+    std::optional<AddressList> early_records;
+    if (executor && !force_update && !recently_confirmed(task)) {
+        auto [ip, records] = co_await Utils::when_all(fetch_local_address(task.config, executor),
+                                                      fetch_dns_records(task, executor));
+        local_ip = std::move(ip);
+        early_records = std::move(records);
+    } else {
+        local_ip = co_await fetch_local_address(task.config, executor);
+    }
 
-    const auto local_ip = resolve_local_address(task.config);
     if (!local_ip) {
         SPDLOG_WARN("No valid IP address found for {}, skipping the update", task.fqdn);
-        return;
+        co_return std::nullopt;
     }
 
     // --- Step 2: skip if unchanged (unless force_update) --------------------
 
-    if (!task.force_update) {
-        const auto records = dns_lookup(task.fqdn, task.config.type);
+    if (!force_update) {
+        const auto local_ip_str = local_ip->to_string();
+        if (!early_records && recently_confirmed(task, local_ip_str)) {
+            SPDLOG_DEBUG("Domain {} ({}) unchanged ({}) and recently verified, skipping DNS lookup", task.fqdn,
+                         rd_type, local_ip_str);
+            co_return std::nullopt;
+        }
+
+        const auto records = early_records ? std::move(*early_records) : co_await fetch_dns_records(task, executor);
 
         if (!records.empty()) {
-            const auto &first = records.front();
-            if (first == local_ip->to_string()) {
-                SPDLOG_DEBUG("Domain {} ({}) unchanged ({}), skipping update", task.fqdn, rd_type, first);
-                return;
+            // Any of them: servers rotate round-robin records.
+            if (std::ranges::any_of(records, [&](const auto &record) { return same_address(record, *local_ip); })) {
+                SPDLOG_DEBUG("Domain {} ({}) unchanged ({}), skipping update", task.fqdn, rd_type, local_ip_str);
+                mark_published(task.fqdn, task.config.type, local_ip_str);
+                co_return std::nullopt;
             }
 
-            SPDLOG_DEBUG("Domain {} ({}) will be updated to {} (was {})", task.fqdn, rd_type, local_ip->to_string(),
-                         first);
+            SPDLOG_DEBUG("Domain {} ({}) will be updated to {} (was {})", task.fqdn, rd_type, local_ip_str,
+                         records.front().to_string());
         }
     } else {
         SPDLOG_INFO("Force update triggered for {}", task.fqdn);
@@ -101,31 +297,57 @@ void Updater::Impl::process(const UpdateTask &task, const Driver &driver, HttpCl
 
     // --- Step 3: build parameters & generate request ------------------------
 
-    const auto parameters = build_driver_parameters(task);
-    const auto ctx = build_update_context(task, *local_ip, rd_type);
+    co_return PreparedUpdate{
+        .handle = driver_handle(task, driver),
+        .ctx = build_update_context(task, *local_ip, rd_type),
+    };
+}
 
-    // --- Step 4: delegate to driver via HttpClient --------------------------
+Utils::Task<std::optional<Updater::Impl::PreparedUpdate> > Updater::Impl::try_prepare(
+    const DueTask &due, const Driver &driver, const Utils::Executor &executor) const {
+    try {
+        co_return co_await prepare(*due.task, due.force_update, driver, executor);
+    } catch (const std::exception &e) {
+        SPDLOG_ERROR("Unhandled exception during update of {}. {}", due.task->fqdn, e.what());
+    } catch (...) {
+        SPDLOG_ERROR("Unknown non-standard exception during update for {}", due.task->fqdn);
+    }
 
-    if (!driver.execute(parameters, ctx, http_client)) {
-        return;
+    co_return std::nullopt;
+}
+
+Utils::Task<std::optional<InetAddress> > Updater::Impl::fetch_local_address(const Config::SubdomainConfig &config,
+                                                                            const Utils::Executor &executor) const {
+    co_return co_await Utils::offload(executor, [&] { return resolve_local_address(config); });
+}
+
+Utils::Task<AddressList> Updater::Impl::fetch_dns_records(const UpdateTask &task,
+                                                          const Utils::Executor &executor) const {
+    if (!executor) {
+        co_return dns_lookup(task.fqdn, task.config.type);
     }
 
-    SPDLOG_INFO("Domain {} ({}) updated to {}", task.fqdn, rd_type, local_ip->to_string());
+    // The dispatcher resumes us on its engine thread; leave it at once.
+    auto result = co_await dispatcher_.resolve_addresses_async(task.fqdn, task.config.type);
+    co_await Utils::schedule(executor);
+    co_return records_or_empty(task.fqdn, std::move(result));
 }
 
-std::vector<std::string> Updater::Impl::dns_lookup(const std::string &host, RecordKind type) const {
-    auto result = dispatcher_.resolve(host, type);
+AddressList Updater::Impl::dns_lookup(const std::string &host, RecordKind type) const {
+    return records_or_empty(host, dispatcher_.resolve_addresses(host, type));
+}
+
+AddressList Updater::Impl::records_or_empty(const std::string &host, std::expected<AddressList, DnsErrorInfo> result) {
     if (!result) {
         SPDLOG_DEBUG(R"(DNS lookup for "{}" failed: {} ({})", host, result.error().message,
                      error_to_str(result.error().code));
     }
     // Keep backward-compatible return type: callers check .empty().
-    return result.value_or(std::vector<std::string>{});
+    return result.value_or(AddressList{});
 }
 
 std::optional<InetAddress> Updater::Impl::resolve_local_address(const Config::SubdomainConfig &config) const {
-    auto ip_source = ip_factory_(config);
-    auto candidates = ip_source->resolve();
+    auto candidates = ip_sources_.resolve(config);
 
     if (candidates.empty()) {
         return std::nullopt;
@@ -143,6 +365,79 @@ std::optional<InetAddress> Updater::Impl::resolve_local_address(const Config::Su
     return candidates.front();
 }
 
+bool Updater::Impl::recently_confirmed(const UpdateTask &task, const std::string &ip_addr) const {
+    if (task.verify_interval <= 0) {
+        return false;
+    }
+
+    std::lock_guard lock(published_mtx_);
+    const auto it = published_.find(PublishedKey{task.fqdn, task.config.type});
+    if (it == published_.end() || it->second.ip_addr != ip_addr) {
+        return false;
+    }
+
+    return std::chrono::steady_clock::now() - it->second.confirmed_at < std::chrono::seconds(task.verify_interval);
+}
+
+bool Updater::Impl::recently_confirmed(const UpdateTask &task) const {
+    if (task.verify_interval <= 0) {
+        return false;
+    }
+
+    std::lock_guard lock(published_mtx_);
+    const auto it = published_.find(PublishedKey{task.fqdn, task.config.type});
+    return it != published_.end() &&
+           std::chrono::steady_clock::now() - it->second.confirmed_at < std::chrono::seconds(task.verify_interval);
+}
+
+void Updater::Impl::mark_published(const std::string &fqdn, RecordKind type, const std::string &ip_addr) const {
+    {
+        std::lock_guard lock(published_mtx_);
+        published_.insert_or_assign(PublishedKey{fqdn, type},
+                                    PublishedState{ip_addr, std::chrono::steady_clock::now()});
+    }
+
+    if (state_ == nullptr) {
+        return;
+    }
+
+    // Persistence is best effort: a full disk must not fail the update.
+    try {
+        state_->put_published(StateStore::Published{
+            .fqdn = fqdn,
+            .type = type,
+            .ip_addr = ip_addr,
+            .confirmed_at = StateStore::WallClock::now(),
+        });
+    } catch (const std::exception &e) {
+        SPDLOG_WARN("Failed to save the published state of {}: {}", fqdn, e.what());
+    }
+}
+
+void Updater::Impl::restore_published() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto wall_now = StateStore::WallClock::now();
+
+    std::lock_guard lock(published_mtx_);
+    for (auto &saved: state_->all_published()) {
+        // Skip entries from the future (the wall clock was set back).
+        if (saved.confirmed_at > wall_now) {
+            continue;
+        }
+        const auto age = std::chrono::duration_cast<std::chrono::steady_clock::duration>(wall_now - saved.confirmed_at);
+        published_.insert_or_assign(PublishedKey{std::move(saved.fqdn), saved.type},
+                                    PublishedState{std::move(saved.ip_addr), now - age});
+    }
+}
+
+DriverHandlePtr Updater::Impl::driver_handle(const UpdateTask &task, const Driver &driver) {
+    if (task.driver_handle) {
+        return task.driver_handle;
+    }
+
+    return driver.prepare(build_driver_parameters(task));
+}
+
 DriverConfig Updater::Impl::build_driver_parameters(const UpdateTask &task) {
     return task.config.driver_param.dump().value_or("{}");
 }
@@ -162,21 +457,47 @@ DriverUpdateParams Updater::Impl::build_update_context(const UpdateTask &task, c
 //  Updater public API — thin delegation to Impl
 // ===========================================================================
 
-Updater::Updater(const ResolverDispatcher &resolver_pool) : Updater(resolver_pool, default_ip_source_factory) {
+Updater::Updater(const ResolverDispatcher &resolver_pool, StateStore *state)
+    : Updater(resolver_pool, default_ip_source_factory, state) {
 }
 
-Updater::Updater(const ResolverDispatcher &resolver_pool, IpSourceFactory ip_factory)
-    : impl_(std::make_unique<Impl>(resolver_pool, std::move(ip_factory))) {
+Updater::Updater(const ResolverDispatcher &resolver_pool, IpSourceFactory ip_factory, StateStore *state)
+    : impl_(std::make_unique<Impl>(resolver_pool, std::move(ip_factory), state)) {
 }
 
 Updater::~Updater() = default;
 
 void Updater::process(const UpdateTask &task, const Driver &driver, HttpClient &http_client) const noexcept {
+    Utils::sync_wait(process_async(task, driver, http_client, {}));
+}
+
+void Updater::process_batch(std::span<const DueTask> tasks, const Driver &driver,
+                            HttpClient &http_client) const noexcept {
+    Utils::sync_wait(process_batch_async(tasks, driver, http_client, {}));
+}
+
+Utils::Task<> Updater::process_async(const UpdateTask &task, const Driver &driver, HttpClient &http_client,
+                                     Utils::Executor executor) const {
     try {
-        impl_->process(task, driver, http_client);
+        co_await impl_->process(task, driver, http_client, executor);
     } catch (const std::exception &e) {
         SPDLOG_ERROR("Unhandled exception during update of {}. {}", task.fqdn, e.what());
     } catch (...) {
         SPDLOG_ERROR("Unknown non-standard exception during update for {}", task.fqdn);
     }
 }
+
+Utils::Task<> Updater::process_batch_async(std::span<const DueTask> tasks, const Driver &driver,
+                                           HttpClient &http_client, Utils::Executor executor) const {
+    if (tasks.empty()) {
+        co_return;
+    }
+
+    try {
+        co_await impl_->process_batch(tasks, driver, http_client, executor);
+    } catch (const std::exception &e) {
+        SPDLOG_ERROR("Unhandled exception during batch update of {}. {}", tasks.front().task->domain_name, e.what());
+    } catch (...) {
+        SPDLOG_ERROR("Unknown non-standard exception during batch update for {}", tasks.front().task->domain_name);
+    }
+}
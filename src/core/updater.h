@@ -7,14 +7,18 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 
 #include "mixin.h"
+#include "util/task.hpp"
 
 class Driver;
 class HttpClient;
 class IpSourceBase;
+struct DueTask;
 struct UpdateTask;
 class ResolverDispatcher;
+class StateStore;
 
 namespace Config {
     struct SubdomainConfig;
@@ -25,9 +29,25 @@ namespace Config {
 /// Holds a non-owning reference to the ResolverDispatcher (initialised before
 /// any call to process()). The Driver is pre-resolved by the caller and passed
 /// directly into process(), eliminating the need for runtime string lookups.
+/// Likewise the driver parameters are passed as the handle the Manager
+/// prepared at startup (UpdateTask::driver_handle), so no JSON is serialised
+/// or parsed per update; a task without a handle is prepared on demand.
 ///
-/// @note process() is thread-safe: it is marked const, owns no mutable state,
-///       and may be called concurrently from multiple pool threads.
+/// The pipeline is written as coroutines (process_async(),
+/// process_batch_async()): each blocking stage (IP source, DNS lookup,
+/// driver exchange) is handed to an Utils::Executor, so with a thread-pool
+/// executor a task holds a pool thread only while one of its stages runs and
+/// the stages of different tasks interleave.  The IP-source fetch and the DNS
+/// lookup of a task are independent and run concurrently.  process() and
+/// process_batch() are blocking adapters that run every stage inline.
+///
+/// Remembers the last address published for every record (see
+/// DomainConfig::verify_interval); with a StateStore this memory is saved
+/// and restored across restarts.
+///
+/// @note process() is thread-safe: it is marked const, guards its only
+///       mutable state with a mutex, and may be called concurrently from
+///       multiple pool threads.
 class Updater {
 public:
     /// Factory type for creating IP source instances.
@@ -35,12 +55,17 @@ public:
 
     /// Construct with a reference to the resolver dispatcher.
     /// @param resolver_pool  Resolver used to look up current DNS records.
-    explicit Updater(const ResolverDispatcher &resolver_pool);
+    /// @param state          Optional persistent state (non-owning, must
+    ///                       outlive the Updater); nullptr disables persistence.
+    explicit Updater(const ResolverDispatcher &resolver_pool, StateStore *state = nullptr);
 
     /// Construct with injected IP source factory (for testing).
     /// @param resolver_pool  Resolver used to look up current DNS records.
-    /// @param ip_factory     Factory that creates IpSourceBase instances on demand.
-    Updater(const ResolverDispatcher &resolver_pool, IpSourceFactory ip_factory);
+    /// @param ip_factory     Factory that creates one IpSourceBase per distinct
+    ///                       source on first use; instances are then shared by
+    ///                       every task with the same source settings.
+    /// @param state          Optional persistent state (non-owning).
+    Updater(const ResolverDispatcher &resolver_pool, IpSourceFactory ip_factory, StateStore *state = nullptr);
 
     ~Updater();
 
@@ -52,17 +77,18 @@ public:
     ///
     /// Exception handling architecture:
     ///   ┌─────────────────────────────────────────────────────────────┐
-    ///   │ Updater::process() noexcept  ←  catch-all (log + swallow)  │
-    ///   │   └── Impl::process()         ←  no try-catch              │
-    ///   │         └── resolve_local_address()  ←  no try-catch       │
-    ///   │               └── ip_source->resolve()  ←  throws on err   │
+    ///   │ Updater::process() noexcept  ←  sync_wait(process_async())  │
+    ///   │   └── process_async()         ←  catch-all (log + swallow)  │
+    ///   │         └── Impl::process()   ←  no try-catch               │
+    ///   │               └── resolve_local_address()  ←  no try-catch  │
+    ///   │                     └── ip_source->resolve()  ←  throws     │
     ///   └─────────────────────────────────────────────────────────────┘
     ///
     /// IpSourceBase implementations throw std::runtime_error on failure.
     /// The exception aborts the current resolution operation and propagates
     /// uncaught through the intermediate layers (Impl::process and
-    /// resolve_local_address have no try-catch).  It is caught only at this
-    /// noexcept boundary, where it is logged via SPDLOG_ERROR and swallowed.
+    /// resolve_local_address have no try-catch).  It is caught only at the
+    /// outermost coroutine, where it is logged via SPDLOG_ERROR and swallowed.
     /// There is no retry, fallback, or error-type branching in any catch
     /// block — the catch is a pure observation point per the project's error
     /// handling guideline.
@@ -74,6 +100,53 @@ public:
     /// @note Never throws — all errors and outcomes are logged internally.
     void process(const UpdateTask &task, const Driver &driver, HttpClient &http_client) const noexcept;
 
+    /// Execute several update tasks that share a domain and a driver.
+    ///
+    /// Takes the Scheduler's DueTask handles, so no task is copied.  Each
+    /// task goes through the same IP resolution and DNS comparison as
+    /// process(); the tasks that need an update are then handed to the driver
+    /// in a single Driver::execute_batch_prepared() call, so providers with a
+    /// bulk endpoint issue one API request per zone instead of one per record.
+    ///
+    /// A task whose preparation throws is logged and dropped from the batch;
+    /// the remaining tasks are still sent.
+    ///
+    /// @param tasks        Due tasks of one (domain, driver) group.
+    /// @param driver       The driver plugin to use.
+    /// @param http_client  HTTP client shared by every request of the batch.
+    ///
+    /// @note Never throws — all errors and outcomes are logged internally.
+    void process_batch(std::span<const DueTask> tasks, const Driver &driver,
+                       HttpClient &http_client) const noexcept;
+
+    /// Coroutine form of process().
+    ///
+    /// Every blocking stage runs on @p executor and the coroutine resumes
+    /// on the thread that ran it.  With an executor, the IP-source fetch
+    /// and the DNS lookup are started together (unless the update is forced
+    /// or the record was confirmed within its verify_interval, in which
+    /// case the lookup is likely not needed).  A null executor runs every
+    /// stage inline, in order.
+    ///
+    /// @param task         Must outlive the returned Task.
+    /// @param driver       Must outlive the returned Task.
+    /// @param http_client  Must outlive the returned Task.
+    /// @param executor     Runs the blocking stages; null for inline.
+    ///
+    /// @note The returned Task never throws — errors are logged as in
+    ///       process().
+    [[nodiscard]] Utils::Task<> process_async(const UpdateTask &task, const Driver &driver, HttpClient &http_client,
+                                              Utils::Executor executor) const;
+
+    /// Coroutine form of process_batch().  The tasks of the group are
+    /// prepared concurrently, then sent in one driver call on @p executor.
+    /// Arguments must outlive the returned Task, as for process_async().
+    ///
+    /// @note The returned Task never throws — errors are logged as in
+    ///       process_batch().
+    [[nodiscard]] Utils::Task<> process_batch_async(std::span<const DueTask> tasks, const Driver &driver,
+                                                    HttpClient &http_client, Utils::Executor executor) const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -0,0 +1,126 @@
+//
+// Created by Kotarou on 2026/8/18.
+//
+
+#include "dns/answer_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <utility>
+
+#include "util/byte_scan.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+#include <magic_enum/magic_enum.hpp>
+#include <spdlog/spdlog.h>
+
+namespace {
+    /// Whether @p result is an answer the servers vouched for: records, or
+    /// the name or record type not existing.
+    [[nodiscard]] bool cacheable(const AnswerCache::Result &result) noexcept {
+        return result || result.error().code == DnsError::NX_DOMAIN || result.error().code == DnsError::NODATA;
+    }
+} // anonymous namespace
+
+struct AnswerCache::Impl {
+    struct Entry {
+        Result result;
+        Clock::time_point expires;
+    };
+
+    explicit Impl(std::function<Clock::time_point()> now) : now_(std::move(now)) {
+    }
+
+    /// Drop expired entries, then the one expiring first while the cache is
+    /// over capacity.  The caller holds mutex_.
+    void evict() {
+        const auto now = now_();
+        std::erase_if(entries_, [now](const auto &entry) { return entry.second.expires <= now; });
+        while (entries_.size() > MAX_ENTRIES) {
+            entries_.erase(std::ranges::min_element(entries_, {},
+                                                    [](const auto &entry) { return entry.second.expires; }));
+        }
+    }
+
+    std::function<Clock::time_point()> now_;
+
+    mutable std::mutex mutex_;
+    mutable std::unordered_map<std::string, Entry> entries_;
+    std::atomic<std::uint64_t> epoch_{0};
+};
+
+AnswerCache::AnswerCache(std::function<Clock::time_point()> now) : impl_(std::make_unique<Impl>(std::move(now))) {
+}
+
+AnswerCache::~AnswerCache() = default;
+
+std::string AnswerCache::make_key(std::string_view host, RecordKind type) {
+    if (host.ends_with('.')) {
+        host.remove_suffix(1);
+    }
+    auto key = fmt::format("{}|{}", host, magic_enum::enum_name(type));
+    Utils::ByteScan::to_lower(std::span(key).first(host.size()));
+    return key;
+}
+
+std::optional<AnswerCache::Result> AnswerCache::find(const std::string &key) const {
+    std::lock_guard lock(impl_->mutex_);
+    const auto it = impl_->entries_.find(key);
+    if (it == impl_->entries_.end()) {
+        return std::nullopt;
+    }
+
+    if (it->second.expires <= impl_->now_()) {
+        impl_->entries_.erase(it);
+        return std::nullopt;
+    }
+
+    return it->second.result;
+}
+
+void AnswerCache::store(const std::string &key, const Result &result, std::uint32_t ttl, std::uint64_t epoch) {
+    if (ttl == 0 || !cacheable(result)) {
+        return;
+    }
+
+    ttl = std::min(ttl, result ? MAX_TTL : MAX_NEGATIVE_TTL);
+
+    std::lock_guard lock(impl_->mutex_);
+    if (epoch != impl_->epoch_.load(std::memory_order_relaxed)) {
+        SPDLOG_TRACE(R"(Not caching the answer for "{}": invalidated while in flight)", key);
+        return;
+    }
+
+    impl_->entries_.insert_or_assign(key, Impl::Entry{result, impl_->now_() + std::chrono::seconds(ttl)});
+    if (impl_->entries_.size() > MAX_ENTRIES) {
+        impl_->evict();
+    }
+}
+
+std::uint64_t AnswerCache::epoch() const noexcept {
+    return impl_->epoch_.load(std::memory_order_relaxed);
+}
+
+void AnswerCache::invalidate(std::string_view host) {
+    std::lock_guard lock(impl_->mutex_);
+    impl_->epoch_.fetch_add(1, std::memory_order_relaxed);
+    for (const auto type: magic_enum::enum_values<RecordKind>()) {
+        impl_->entries_.erase(make_key(host, type));
+    }
+}
+
+void AnswerCache::clear() {
+    std::lock_guard lock(impl_->mutex_);
+    impl_->epoch_.fetch_add(1, std::memory_order_relaxed);
+    impl_->entries_.clear();
+}
+
+std::size_t AnswerCache::size() const {
+    std::lock_guard lock(impl_->mutex_);
+    return impl_->entries_.size();
+}
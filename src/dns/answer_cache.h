@@ -0,0 +1,97 @@
+//
+// Created by Kotarou on 2026/8/18.
+//
+
+#ifndef YADDNSC_DNS_ANSWER_CACHE_H
+#define YADDNSC_DNS_ANSWER_CACHE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mixin.h"
+#include "record_kind.h"
+#include "dns/dns_error_info.h"
+#include "network/inet_address.h"
+
+/// AnswerCache — the answers of past lookups, kept for as long as their
+/// records say (the TTL), so a repeated lookup does not go to the network.
+///
+/// Unlike Utils::Cache::TtlCache, every entry has its own lifetime: the
+/// lowest TTL of the answer records, or for NXDOMAIN and NODATA the negative
+/// TTL of the zone's SOA (RFC 2308 §5).  Answers with a TTL of 0, negative
+/// answers without an SOA, and every other error are not cached.  TTLs are
+/// capped at MAX_TTL (MAX_NEGATIVE_TTL for negative answers), and the entry
+/// that expires first is evicted when MAX_ENTRIES is exceeded.
+///
+/// Each invalidation starts a new epoch; store() drops an answer whose
+/// lookup began in an earlier one, so a lookup that was in flight while a
+/// record was updated cannot put the old value back.
+///
+/// @note Thread-safe.
+class AnswerCache {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /// The records of an answer, as text and, for A and AAAA, as addresses.
+    struct Records {
+        std::vector<std::string> values;
+        AddressList addresses;
+
+        bool operator==(const Records &) const = default;
+    };
+
+    using Result = std::expected<Records, DnsErrorInfo>;
+
+    static constexpr std::size_t MAX_ENTRIES = 1024;
+
+    /// One day.
+    static constexpr std::uint32_t MAX_TTL = 86400;
+
+    /// Three hours, the upper end suggested by RFC 2308 §5.
+    static constexpr std::uint32_t MAX_NEGATIVE_TTL = 10800;
+
+    /// @param now  Time source; replaced in tests.
+    explicit AnswerCache(std::function<Clock::time_point()> now = Clock::now);
+
+    ~AnswerCache();
+
+    /// The key of a lookup (the host name is case-insensitive).
+    [[nodiscard]] static std::string make_key(std::string_view host, RecordKind type);
+
+    /// The cached answer for @p key, or std::nullopt if there is none or it
+    /// has expired.
+    [[nodiscard]] std::optional<Result> find(const std::string &key) const;
+
+    /// Cache @p result for @p ttl seconds, unless it is not cacheable or the
+    /// cache has been invalidated since @p epoch.
+    void store(const std::string &key, const Result &result, std::uint32_t ttl, std::uint64_t epoch);
+
+    /// The current epoch; take it before starting a lookup to store.
+    [[nodiscard]] std::uint64_t epoch() const noexcept;
+
+    /// Forget the answers for @p host (every record type).
+    void invalidate(std::string_view host);
+
+    /// Forget every answer.
+    void clear();
+
+    /// Number of answers cached, including expired ones not yet dropped.
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_DNS_ANSWER_CACHE_H
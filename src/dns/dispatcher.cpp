@@ -1,8 +1,9 @@
 //
 // Created by Kotarou on 2026/6/28.
 //
-// Native resolver dispatcher — jthread-based concurrent dispatch with
-// per-thread cancellation pipes and no shared mutable state.
+// Native resolver dispatcher — strategies run as coroutines on a persistent
+// ResolverEngine: a batch is sent from one thread, replies are multiplexed by
+// its reactor, and first-wins / cancellation are resolved in-process.
 //
 // Compiled when YADDNSC_USE_NATIVE_DNS=1.
 //
@@ -10,22 +11,22 @@
 #include "dispatcher.h"
 
 #include <algorithm>
-#include <atomic>
+#include <chrono>
 #include <functional>
-#include <future>
+#include <memory>
+#include <mutex>
 #include <numeric>
-#include <stop_token>
-#include <thread>
+#include <optional>
+#include <span>
+#include <unordered_map>
 #include <utility>
 
-#include "dns/parser/parser.h"
+#include "dns/answer_cache.h"
 #include "dns/resolver/base.h"
+#include "dns/resolver_engine.h"
+#include "dns/resolver_health.h"
 #include "dns/dns_error_info.h"
-#include "exception/dns_lookup.h"
-#include "util/cancellation_token.hpp"
-#include "util/fd.hpp"
 #include "util/random.hpp"
-#include "util/retry_util.hpp"
 
 #include "dns_error.h"
 
@@ -33,7 +34,12 @@
 #include <expected>
 #include <magic_enum/magic_enum.hpp>
 #include <spdlog/spdlog.h>
-#include <unistd.h>
+
+/// What the runners produce: the answer together with its TTL.
+using DispatchResult = ResolverEngine::Result;
+
+/// What a lookup produces, and the cache keeps: the records without their TTL.
+using LookupResult = AnswerCache::Result;
 
 // ===========================================================================
 //  Anonymous namespace  —  stateless utility functions
@@ -45,90 +51,53 @@ namespace {
         return error == DnsError::RETRY || error == DnsError::UNKNOWN || error == DnsError::CONNECTION;
     }
 
-    /// Query a single resolver, parse the response, and classify the result.
-    /// Handles transport errors, parse exceptions, and all RCODE values uniformly.
-    ///
-    /// @note  The outer try-catch is a safety barrier at the dispatcher boundary.
-    ///        Unexpected exceptions from the resolver/parser layer are caught here
-    ///        to prevent std::terminate — this is NOT catch-to-convert for flow control.
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
-    try_resolve(const ResolverBase &resolver, const std::string &host, RecordKind type,
-                const Utils::CancellationToken &cancel_token) {
-        try {
-            // ── 1. Query the resolver (transport layer) ──
-            auto raw = resolver.query(host, type, cancel_token);
-            if (!raw) {
-                return std::unexpected(std::move(raw.error()));
-            }
+    /// The records of @p result, without the TTL.
+    [[nodiscard]] LookupResult records_of(DispatchResult result) {
+        if (!result) {
+            return std::unexpected(std::move(result.error()));
+        }
+        return AnswerCache::Records{std::move(result->records), std::move(result->addresses)};
+    }
 
-            // ── 2. Parse the raw response ──
-            // RecordParser::parse_strings forms a deep call chain (5+ levels) where all
-            // errors are DnsLookupException(PARSE).  Caught by the first outer catch below.
-            auto parsed = DNS::RecordParser::parse_strings(*raw, host);
-
-            // ── 3. Classify by RCODE ──
-            switch (parsed.rcode) {
-                case DNS::Rcode::NOERROR:
-                    if (!parsed.records.empty()) {
-                        return std::move(parsed.records);
-                    }
-                    return std::unexpected(DnsErrorInfo{
-                        DnsError::NODATA,
-                        fmt::format(R"(DNS lookup for domain "{}" returned no records)", host)
-                    });
-
-                case DNS::Rcode::NXDOMAIN:
-                    return std::unexpected(DnsErrorInfo{
-                        DnsError::NX_DOMAIN,
-                        fmt::format(R"(Domain "{}" does not exist (NXDOMAIN))", host)
-                    });
-
-                case DNS::Rcode::SERVFAIL:
-                    return std::unexpected(DnsErrorInfo{
-                        DnsError::RETRY,
-                        fmt::format(R"(DNS server returned SERVFAIL for "{}")", host)
-                    });
-
-                case DNS::Rcode::REFUSED:
-                    return std::unexpected(DnsErrorInfo{
-                        DnsError::SERVER_REFUSED,
-                        fmt::format(R"(DNS server refused query for "{}")", host)
-                    });
-
-                default:
-                    return std::unexpected(DnsErrorInfo{
-                        DnsError::UNKNOWN,
-                        fmt::format(R"(DNS lookup for "{}" returned RCODE {})", host,
-                                    magic_enum::enum_name(parsed.rcode))
-                    });
-            }
-        } catch (const DnsLookupException &e) {
-            // Deep-call-chain boundary translation: parser internals (5+ levels)
-            // throw DnsLookupException(PARSE).  Preserve the error code.
-            return std::unexpected(DnsErrorInfo{e.get_error(), e.what()});
-        } catch (const std::exception &e) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::UNKNOWN,
-                fmt::format(R"(DNS lookup for "{}" failed: {})", host, e.what())
-            });
+    /// The records of @p result as text.
+    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo> values_of(LookupResult result) {
+        if (!result) {
+            return std::unexpected(std::move(result.error()));
         }
+        return std::move(result->values);
+    }
+
+    /// The addresses among the records of @p result.
+    [[nodiscard]] std::expected<AddressList, DnsErrorInfo> addresses_of(LookupResult result) {
+        if (!result) {
+            return std::unexpected(std::move(result.error()));
+        }
+        return std::move(result->addresses);
+    }
+
+    /// How long @p result may be cached, in seconds.
+    [[nodiscard]] std::uint32_t ttl_of(const DispatchResult &result) noexcept {
+        return result ? result->ttl : result.error().ttl;
     }
 } // anonymous namespace
 
 // ===========================================================================
 //  Class declarations  —  SingleResolverRunner, FallbackRunner, BatchRunner,
-//                          ConcurrentRunner
+//                          ConcurrentRunner, HedgedRunner
+//
+//  Every run() is a coroutine that must be started on the engine thread.
 // ===========================================================================
 
 /// Single-resolver dispatch with retry.
 class SingleResolverRunner {
 public:
-    explicit SingleResolverRunner(const ResolverBase &resolver);
+    SingleResolverRunner(ResolverEngine &engine, const ResolverBase &resolver);
 
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
+    [[nodiscard]] Utils::Task<DispatchResult>
     run(const std::string &host, RecordKind type, std::uint32_t max_retries, std::uint32_t backoff_ms) const;
 
 private:
+    ResolverEngine &engine_;
     const ResolverBase &resolver_;
 };
 
@@ -139,64 +108,111 @@ private:
 /// stops immediately and the error is propagated via std::expected.
 class FallbackRunner {
 public:
-    explicit FallbackRunner(const std::vector<std::unique_ptr<ResolverBase> > &resolvers);
+    FallbackRunner(ResolverEngine &engine, const std::vector<std::unique_ptr<ResolverBase> > &resolvers);
 
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo> run(
-        const std::string &host, RecordKind type) const;
+    [[nodiscard]] Utils::Task<DispatchResult> run(const std::string &host, RecordKind type) const;
 
 private:
+    ResolverEngine &engine_;
     const std::vector<std::unique_ptr<ResolverBase> > &resolvers_;
 };
 
-/// Executes one batch of concurrent resolver queries with cancellation pipes.
+/// Executes one batch of concurrent resolver queries on the engine.
 ///
-/// On success returns the resolved records (non-empty vector).  On failure
+/// The first success wins and cancels the rest of the batch.  On failure
 /// returns std::unexpected with the appropriate DnsErrorInfo — callers
 /// should check the error code to distinguish definitive errors
 /// (NXDOMAIN, PARSE, CONFIG) from transient ones (RETRY, CONNECTION).
 class BatchRunner {
 public:
-    explicit BatchRunner(const std::string &host, RecordKind type) noexcept;
+    BatchRunner(ResolverEngine &engine, const std::string &host, RecordKind type) noexcept;
 
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
-    run(std::span<const std::unique_ptr<ResolverBase>> batch);
+    [[nodiscard]] Utils::Task<DispatchResult> run(std::span<const std::unique_ptr<ResolverBase> > batch) const;
 
 private:
-    void resolve_one(const std::stop_token &st, const ResolverBase &resolver);
+    /// State of one batch, shared by its query callbacks.
+    struct Race {
+        std::vector<ResolverEngine::QueryId> queries;
+        std::size_t remaining{0};
+        bool has_nxdomain{false};
+        bool has_definitive{false};
+        DnsError batch_error{DnsError::NODATA};
+        /// Negative TTLs of the NXDOMAIN and NODATA answers (RFC 2308).
+        std::uint32_t nxdomain_ttl{0};
+        std::uint32_t nodata_ttl{0};
+        ResolverEngine::Callback on_done;
+    };
+
+    /// Start every query of @p batch; @p on_done receives the batch result.
+    void start(std::span<const std::unique_ptr<ResolverBase> > batch, ResolverEngine::Callback on_done) const;
 
-    /// Signal completion by setting the promise to an empty vector when the
-    /// last in-flight resolver finishes (prev reaches batch_count_ - 1).
-    /// Safe to call multiple times — future_error is caught if the promise
-    /// was already satisfied by set_promise_value().
-    void signal_completion(int prev) noexcept;
+    void on_result(Race &race, std::uint64_t resolver_id, DispatchResult result) const;
 
-    /// Set the promise value, catching future_error if another thread
-    /// already set it (e.g. a faster resolver answered first).
-    void set_promise_value(std::vector<std::string> value) noexcept;
+    /// The batch error once every query has failed.
+    [[nodiscard]] DnsErrorInfo batch_failure(const Race &race) const;
 
+    ResolverEngine &engine_;
     const std::string &host_;
     RecordKind type_;
-
-    // ── Per-batch state (reset at the start of each run()) ──
-    std::atomic<int> completed_{0};
-    std::atomic<bool> has_nxdomain_{false};
-    std::atomic<bool> has_definitive_{false};
-    std::atomic<DnsError> batch_error_{DnsError::NODATA};
-    std::shared_ptr<std::promise<std::vector<std::string> > > promise_;
-    int batch_count_{0};
 };
 
-/// Batched concurrent dispatch with cancellation pipes.
+/// Batched concurrent dispatch.
 class ConcurrentRunner {
 public:
     static constexpr size_t MAX_CONCURRENT_RESOLVERS = 3;
 
-    explicit ConcurrentRunner(const std::vector<std::unique_ptr<ResolverBase> > &resolvers);
+    ConcurrentRunner(ResolverEngine &engine, const std::vector<std::unique_ptr<ResolverBase> > &resolvers);
 
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
-    run(const std::string &host, RecordKind type) const;
+    [[nodiscard]] Utils::Task<DispatchResult> run(const std::string &host, RecordKind type) const;
 
 private:
+    ResolverEngine &engine_;
+    const std::vector<std::unique_ptr<ResolverBase> > &resolvers_;
+};
+
+/// Latency-scored dispatch with hedged requests.
+///
+/// Queries the resolver with the best ResolverHealth score first.  If it
+/// has not answered within its hedge delay (a high percentile of its recent
+/// RTTs), or fails, the next best is queried as well, and so on; the first
+/// answer wins and cancels the rest.  Definitive errors (NXDOMAIN, PARSE,
+/// CONFIG) end the lookup as in FallbackRunner.  Every outcome is recorded
+/// in the health stats.
+class HedgedRunner {
+public:
+    HedgedRunner(ResolverEngine &engine, ResolverHealth &health,
+                 const std::vector<std::unique_ptr<ResolverBase> > &resolvers);
+
+    [[nodiscard]] Utils::Task<DispatchResult> run(const std::string &host, RecordKind type) const;
+
+private:
+    /// State of one lookup, shared by its query and timer callbacks.
+    struct Hedge {
+        const std::string &host;
+        RecordKind type;
+        /// Indices into resolvers_, best first.
+        std::vector<std::size_t> order;
+        /// Position in order of the next resolver to query.
+        std::size_t next{0};
+        std::size_t in_flight{0};
+        std::vector<ResolverEngine::QueryId> queries;
+        std::optional<Reactor::TimerId> timer;
+        DnsErrorInfo last_error;
+        ResolverEngine::Callback on_done;
+    };
+
+    /// Query the next resolver in line, and arm the hedge timer if there is
+    /// another one after it.
+    void launch(const std::shared_ptr<Hedge> &hedge) const;
+
+    void on_result(const std::shared_ptr<Hedge> &hedge, const ResolverBase &resolver,
+                   std::chrono::steady_clock::time_point sent, DispatchResult result) const;
+
+    /// Cancel the timer and every query still in flight, then report @p result.
+    void finish(Hedge &hedge, DispatchResult result) const;
+
+    ResolverEngine &engine_;
+    ResolverHealth &health_;
     const std::vector<std::unique_ptr<ResolverBase> > &resolvers_;
 };
 
@@ -204,46 +220,50 @@ private:
 //  SingleResolverRunner  —  implementations
 // ===========================================================================
 
-SingleResolverRunner::SingleResolverRunner(const ResolverBase &resolver) : resolver_(resolver) {
+SingleResolverRunner::SingleResolverRunner(ResolverEngine &engine, const ResolverBase &resolver)
+    : engine_(engine), resolver_(resolver) {
 }
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
+Utils::Task<DispatchResult>
 SingleResolverRunner::run(const std::string &host, RecordKind type, std::uint32_t max_retries,
                           std::uint32_t backoff_ms) const {
-    unsigned actual_retries = 0;
-    auto result = Utils::Retry::retry_on_error<std::vector<std::string>, DnsErrorInfo>(
-        [this, &host, &type]() -> std::expected<std::vector<std::string>, DnsErrorInfo> {
-            return try_resolve(resolver_, host, type, {});
-        },
-        max_retries, [](const DnsErrorInfo &e) { return is_retryable(e.code); },
-        backoff_ms, &actual_retries);
+    // Same schedule as Utils::Retry::retry_on_error (linear backoff), but the
+    // backoff is an engine timer rather than a sleeping thread.
+    std::uint32_t retries = 0;
+    auto result = co_await engine_.query(resolver_, host, type);
+    while (!result && is_retryable(result.error().code) && retries < max_retries) {
+        ++retries;
+        co_await engine_.sleep_for(std::chrono::milliseconds(std::uint64_t{backoff_ms} * retries));
+        SPDLOG_DEBUG("retrying... (counter {})", retries);
+        result = co_await engine_.query(resolver_, host, type);
+    }
 
     if (!result) {
         if (result.error().code == DnsError::NODATA) {
             SPDLOG_DEBUG(R"(DNS lookup for "{}" returned no records)", host);
         } else {
             SPDLOG_WARN(R"(DNS lookup for domain "{}" type: {} failed after {} retries. Error: {})", host,
-                        magic_enum::enum_name(type), actual_retries, error_to_str(result.error().code));
+                        magic_enum::enum_name(type), retries, error_to_str(result.error().code));
         }
-        return std::unexpected(std::move(result.error()));
+        co_return std::unexpected(std::move(result.error()));
     }
 
-    if (result->size() > 1) {
-        SPDLOG_WARN(R"(Domain "{}" resolved to more than one address (count: {}))", host, result->size());
+    if (result->records.size() > 1) {
+        SPDLOG_WARN(R"(Domain "{}" resolved to more than one address (count: {}))", host, result->records.size());
     }
 
-    return std::move(*result);
+    co_return std::move(*result);
 }
 
 // ===========================================================================
 //  FallbackRunner  —  implementations
 // ===========================================================================
 
-FallbackRunner::FallbackRunner(const std::vector<std::unique_ptr<ResolverBase> > &resolvers) : resolvers_(resolvers) {
+FallbackRunner::FallbackRunner(ResolverEngine &engine, const std::vector<std::unique_ptr<ResolverBase> > &resolvers)
+    : engine_(engine), resolvers_(resolvers) {
 }
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
-FallbackRunner::run(const std::string &host, RecordKind type) const {
+Utils::Task<DispatchResult> FallbackRunner::run(const std::string &host, RecordKind type) const {
     DnsErrorInfo last_error{
         DnsError::NODATA,
         fmt::format(R"(DNS lookup for domain "{}" returned no records)", host)
@@ -260,15 +280,15 @@ FallbackRunner::run(const std::string &host, RecordKind type) const {
         const auto &resolver = resolvers_[idx];
         const auto id = resolver->get_id();
 
-        auto result = try_resolve(*resolver, host, type, {});
+        auto result = co_await engine_.query(*resolver, host, type);
         if (result) {
-            if (result->size() > 1) {
+            if (result->records.size() > 1) {
                 SPDLOG_WARN(R"(Resolver #{} Domain "{}" resolved to more than one address (count: {}))", id, host,
-                            result->size());
+                            result->records.size());
             }
-            SPDLOG_DEBUG(R"(Fallback resolver #{} returned {} record(s) for "{}": {})", id, result->size(), host,
-                         fmt::join(*result, ", "));
-            return std::move(*result);
+            SPDLOG_DEBUG(R"(Fallback resolver #{} returned {} record(s) for "{}": {})", id, result->records.size(),
+                         host, fmt::join(result->records, ", "));
+            co_return std::move(*result);
         }
 
         // Error path — classify by DnsErrorInfo error code.
@@ -283,7 +303,7 @@ FallbackRunner::run(const std::string &host, RecordKind type) const {
             case DnsError::PARSE:
             case DnsError::CONFIG:
                 // Non-retryable error — stop iteration immediately.
-                return std::unexpected(error);
+                co_return std::unexpected(error);
             case DnsError::NODATA:
             case DnsError::RETRY:
             case DnsError::UNKNOWN:
@@ -300,142 +320,114 @@ FallbackRunner::run(const std::string &host, RecordKind type) const {
                      host, error_to_str(last_error.code));
     }
 
-    return std::unexpected(std::move(last_error));
+    co_return std::unexpected(std::move(last_error));
 }
 
 // ===========================================================================
 //  BatchRunner  —  implementations
 // ===========================================================================
 
-BatchRunner::BatchRunner(const std::string &host, RecordKind type) noexcept
-    : host_(host), type_(type) {
+BatchRunner::BatchRunner(ResolverEngine &engine, const std::string &host, RecordKind type) noexcept
+    : engine_(engine), host_(host), type_(type) {
 }
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
-BatchRunner::run(std::span<const std::unique_ptr<ResolverBase>> batch) {
-    completed_ = 0;
-    has_nxdomain_ = false;
-    has_definitive_ = false;
-    batch_error_ = DnsError::NODATA;
-
-    batch_count_ = static_cast<int>(batch.size());
-    promise_ = std::make_shared<std::promise<std::vector<std::string> > >();
-    auto future = promise_->get_future();
-
-    SPDLOG_DEBUG(R"(Launching batch of {} resolver(s) for "{}")", batch_count_, host_);
-
-    {
-        std::vector<std::jthread> threads;
-        threads.reserve(static_cast<size_t>(batch_count_));
-
-        for (const auto &resolver: batch) {
-            threads.emplace_back(std::bind_front(&BatchRunner::resolve_one, this), std::ref(*resolver));
-        }
-
-        auto batch_result = future.get();
-        if (!batch_result.empty()) {
-            return batch_result;
-        }
-    }
-
-    // ── All resolvers in this batch finished without a valid result ──
-    if (has_nxdomain_.load()) {
-        return std::unexpected(DnsErrorInfo{
-            DnsError::NX_DOMAIN,
-            fmt::format(R"(Domain "{}" does not exist (NXDOMAIN))", host_)
-        });
-    }
-
-    if (has_definitive_.load()) {
-        auto err = batch_error_.load();
-        return std::unexpected(DnsErrorInfo{
-            err,
-            fmt::format(R"(DNS lookup for "{}" failed: {})", host_, error_to_str(err))
+Utils::Task<DispatchResult> BatchRunner::run(std::span<const std::unique_ptr<ResolverBase> > batch) const {
+    co_return co_await Utils::await_callback<DispatchResult>(
+        [this, batch](ResolverEngine::Callback on_done) -> std::optional<DispatchResult> {
+            start(batch, std::move(on_done));
+            return std::nullopt;
         });
-    }
-
-    auto err = batch_error_.load();
-    return std::unexpected(DnsErrorInfo{
-        err,
-        fmt::format(R"(DNS lookup for "{}" returned {})", host_, error_to_str(err))
-    });
 }
 
-void BatchRunner::resolve_one(const std::stop_token &st, const ResolverBase &resolver) {
-    auto [read, write] = Utils::make_pipe();
-
-    std::stop_callback cb(st, [&write] {
-        if (write) [[likely]] {
-            alignas(std::uint64_t) char buf[8] = {};
-            [[maybe_unused]] auto _ = ::write(write.get(), buf, sizeof(buf));
-        }
-    });
-
-    if (st.stop_requested()) {
-        return;
+void BatchRunner::start(std::span<const std::unique_ptr<ResolverBase> > batch,
+                        ResolverEngine::Callback on_done) const {
+    SPDLOG_DEBUG(R"(Launching batch of {} resolver(s) for "{}")", batch.size(), host_);
+
+    auto race = std::make_shared<Race>();
+    race->remaining = batch.size();
+    race->on_done = std::move(on_done);
+    race->queries.reserve(batch.size());
+
+    // Query callbacks never run from within start(), so the whole batch is
+    // sent before the first reply is handled.
+    for (const auto &resolver: batch) {
+        race->queries.push_back(engine_.start(*resolver, host_, type_,
+                                              [this, race, id = resolver->get_id()](DispatchResult result) {
+                                                  on_result(*race, id, std::move(result));
+                                              }));
     }
+}
 
-    Utils::CancellationToken cancel_token(read.get());
-    auto result = try_resolve(resolver, host_, type_, cancel_token);
-    const auto id = resolver.get_id();
-
+void BatchRunner::on_result(Race &race, [[maybe_unused]] std::uint64_t resolver_id, DispatchResult result) const {
     if (result) {
-        SPDLOG_DEBUG(R"(Resolver #{} returned {} record(s) for "{}")", id, result->size(), host_);
+        SPDLOG_DEBUG(R"(Resolver #{} returned {} record(s) for "{}")", resolver_id, result->records.size(), host_);
 
-        [[maybe_unused]] int prev = completed_.fetch_add(1, std::memory_order_acq_rel);
-        set_promise_value(std::move(*result));
+        // First answer wins: the rest of the batch is abandoned.
+        for (const auto query: race.queries) {
+            engine_.cancel(query);
+        }
+        // Resuming the dispatch may destroy this runner, so it comes last.
+        std::exchange(race.on_done, nullptr)(std::move(*result));
         return;
     }
 
-    const auto &error = result.error();
-    const auto err_code = error.code;
-
+    const auto err_code = result.error().code;
     if (err_code == DnsError::CANCELLED) {
-        SPDLOG_TRACE(R"(Resolver #{} cancelled for "{}" — another resolver answered first)", id, host_);
-
-        signal_completion(completed_.fetch_add(1, std::memory_order_acq_rel));
-        return;
-    }
-
-    if (err_code == DnsError::NX_DOMAIN) {
-        SPDLOG_DEBUG(R"(Resolver #{} returned NXDOMAIN for "{}")", id, host_);
-        has_nxdomain_.store(true, std::memory_order_relaxed);
+        SPDLOG_TRACE(R"(Resolver #{} cancelled for "{}")", resolver_id, host_);
+    } else if (err_code == DnsError::NX_DOMAIN) {
+        SPDLOG_DEBUG(R"(Resolver #{} returned NXDOMAIN for "{}")", resolver_id, host_);
+        race.has_nxdomain = true;
+        race.nxdomain_ttl = result.error().ttl;
     } else if (err_code == DnsError::PARSE || err_code == DnsError::CONFIG) {
-        SPDLOG_TRACE(R"(Resolver #{} failed for "{}": {})", id, host_, error_to_str(err_code));
-        has_definitive_.store(true, std::memory_order_relaxed);
-        batch_error_.store(err_code, std::memory_order_relaxed);
+        SPDLOG_TRACE(R"(Resolver #{} failed for "{}": {})", resolver_id, host_, error_to_str(err_code));
+        race.has_definitive = true;
+        race.batch_error = err_code;
     } else {
-        SPDLOG_TRACE(R"(Resolver #{} returned {} for "{}")", id, host_, error_to_str(err_code));
-        batch_error_.store(err_code, std::memory_order_relaxed);
+        SPDLOG_TRACE(R"(Resolver #{} returned {} for "{}")", resolver_id, host_, error_to_str(err_code));
+        race.batch_error = err_code;
+        if (err_code == DnsError::NODATA) {
+            race.nodata_ttl = result.error().ttl;
+        }
     }
 
-    signal_completion(completed_.fetch_add(1, std::memory_order_acq_rel));
+    if (--race.remaining == 0) {
+        std::exchange(race.on_done, nullptr)(std::unexpected(batch_failure(race)));
+    }
 }
 
-void BatchRunner::signal_completion(int prev) noexcept {
-    if (prev + 1 == batch_count_) {
-        set_promise_value({});
+DnsErrorInfo BatchRunner::batch_failure(const Race &race) const {
+    if (race.has_nxdomain) {
+        return DnsErrorInfo{
+            DnsError::NX_DOMAIN,
+            fmt::format(R"(Domain "{}" does not exist (NXDOMAIN))", host_),
+            race.nxdomain_ttl
+        };
     }
-}
 
-void BatchRunner::set_promise_value(std::vector<std::string> value) noexcept {
-    try {
-        promise_->set_value(std::move(value));
-    } catch (const std::future_error &) {
-        // Another resolver already set the promise — fine.
+    if (race.has_definitive) {
+        return DnsErrorInfo{
+            race.batch_error,
+            fmt::format(R"(DNS lookup for "{}" failed: {})", host_, error_to_str(race.batch_error))
+        };
     }
+
+    return DnsErrorInfo{
+        race.batch_error,
+        fmt::format(R"(DNS lookup for "{}" returned {})", host_, error_to_str(race.batch_error)),
+        race.batch_error == DnsError::NODATA ? race.nodata_ttl : 0
+    };
 }
 
 // ===========================================================================
 //  ConcurrentRunner  —  implementations
 // ===========================================================================
 
-ConcurrentRunner::ConcurrentRunner(
-    const std::vector<std::unique_ptr<ResolverBase> > &resolvers) : resolvers_(resolvers) {
+ConcurrentRunner::ConcurrentRunner(ResolverEngine &engine,
+                                   const std::vector<std::unique_ptr<ResolverBase> > &resolvers)
+    : engine_(engine), resolvers_(resolvers) {
 }
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
-ConcurrentRunner::run(const std::string &host, RecordKind type) const {
+Utils::Task<DispatchResult> ConcurrentRunner::run(const std::string &host, RecordKind type) const {
     const auto total = resolvers_.size();
     SPDLOG_DEBUG(R"(Concurrent mode: {} resolver(s) for "{}", {} per batch)", total, host, MAX_CONCURRENT_RESOLVERS);
 
@@ -443,27 +435,25 @@ ConcurrentRunner::run(const std::string &host, RecordKind type) const {
         DnsError::NODATA,
         fmt::format(R"(DNS lookup for domain "{}" returned no records)", host)
     };
-    BatchRunner batch_runner(host, type);
+    const BatchRunner batch_runner(engine_, host, type);
 
     for (size_t offset = 0; offset < total; offset += MAX_CONCURRENT_RESOLVERS) {
         const auto batch_end = std::min(offset + MAX_CONCURRENT_RESOLVERS, total);
         auto batch = std::span(resolvers_).subspan(offset, batch_end - offset);
 
-        auto result = batch_runner.run(batch);
-        if (result && !result->empty()) {
-            return std::move(*result);
+        auto result = co_await batch_runner.run(batch);
+        if (result) {
+            co_return std::move(*result);
         }
 
-        if (!result) {
-            const auto &err = result.error();
-            // Definitive errors — stop iterating batches.
-            if (err.code == DnsError::NX_DOMAIN ||
-                err.code == DnsError::PARSE ||
-                err.code == DnsError::CONFIG) {
-                return result;
-            }
-            last_error = err;
+        const auto &err = result.error();
+        // Definitive errors — stop iterating batches.
+        if (err.code == DnsError::NX_DOMAIN ||
+            err.code == DnsError::PARSE ||
+            err.code == DnsError::CONFIG) {
+            co_return std::unexpected(err);
         }
+        last_error = err;
     }
 
     if (total > 1) {
@@ -471,7 +461,140 @@ ConcurrentRunner::run(const std::string &host, RecordKind type) const {
                      error_to_str(last_error.code));
     }
 
-    return std::unexpected(std::move(last_error));
+    co_return std::unexpected(std::move(last_error));
+}
+
+// ===========================================================================
+//  HedgedRunner  —  implementations
+// ===========================================================================
+
+HedgedRunner::HedgedRunner(ResolverEngine &engine, ResolverHealth &health,
+                           const std::vector<std::unique_ptr<ResolverBase> > &resolvers)
+    : engine_(engine), health_(health), resolvers_(resolvers) {
+}
+
+Utils::Task<DispatchResult> HedgedRunner::run(const std::string &host, RecordKind type) const {
+    std::vector<std::uint64_t> ids;
+    ids.reserve(resolvers_.size());
+    for (const auto &resolver: resolvers_) {
+        ids.push_back(resolver->get_id());
+    }
+
+    auto hedge = std::make_shared<Hedge>(Hedge{
+        .host = host,
+        .type = type,
+        .order = health_.rank(ids),
+        .next = 0,
+        .in_flight = 0,
+        .queries = {},
+        .timer = std::nullopt,
+        .last_error = DnsErrorInfo{
+            DnsError::NODATA,
+            fmt::format(R"(DNS lookup for domain "{}" returned no records)", host)
+        },
+        .on_done = nullptr
+    });
+    hedge->queries.reserve(resolvers_.size());
+
+    co_return co_await Utils::await_callback<DispatchResult>(
+        [this, &hedge](ResolverEngine::Callback on_done) -> std::optional<DispatchResult> {
+            hedge->on_done = std::move(on_done);
+            launch(hedge);
+            return std::nullopt;
+        });
+}
+
+void HedgedRunner::launch(const std::shared_ptr<Hedge> &hedge) const {
+    const auto &resolver = *resolvers_[hedge->order[hedge->next++]];
+    SPDLOG_DEBUG(R"(Hedged mode: querying resolver #{} (score {:.1f}) for "{}")", resolver.get_id(),
+                 health_.score(resolver.get_id()), hedge->host);
+
+    auto on_done = [this, hedge, &resolver, sent = std::chrono::steady_clock::now()](DispatchResult result) {
+        on_result(hedge, resolver, sent, std::move(result));
+    };
+    ++hedge->in_flight;
+    hedge->queries.push_back(engine_.start(resolver, hedge->host, hedge->type, std::move(on_done)));
+
+    if (hedge->next == hedge->order.size()) {
+        return;
+    }
+
+    const auto delay = health_.hedge_delay(resolver.get_id());
+    hedge->timer = engine_.reactor().add_timer(delay, [this, hedge, &resolver, delay] {
+        hedge->timer.reset();
+        SPDLOG_DEBUG(R"(Resolver #{} has not answered "{}" within {}ms, hedging)", resolver.get_id(),
+                     hedge->host, delay.count());
+        launch(hedge);
+    });
+}
+
+void HedgedRunner::on_result(const std::shared_ptr<Hedge> &hedge, const ResolverBase &resolver,
+                             std::chrono::steady_clock::time_point sent, DispatchResult result) const {
+    const auto id = resolver.get_id();
+    --hedge->in_flight;
+
+    if (result) {
+        health_.record_success(id, std::chrono::duration_cast<std::chrono::microseconds>(
+                                   std::chrono::steady_clock::now() - sent));
+        SPDLOG_DEBUG(R"(Resolver #{} returned {} record(s) for "{}")", id, result->records.size(), hedge->host);
+        finish(*hedge, std::move(result));
+        return;
+    }
+
+    const auto &error = result.error();
+    switch (error.code) {
+        case DnsError::CANCELLED:
+            SPDLOG_TRACE(R"(Resolver #{} cancelled for "{}")", id, hedge->host);
+            break;
+        case DnsError::NX_DOMAIN:
+        case DnsError::NODATA:
+            // An answer all the same: the resolver is as healthy as it is fast.
+            health_.record_success(id, std::chrono::duration_cast<std::chrono::microseconds>(
+                                       std::chrono::steady_clock::now() - sent));
+            break;
+        case DnsError::PARSE:
+        case DnsError::CONFIG:
+        case DnsError::RETRY:
+        case DnsError::UNKNOWN:
+        case DnsError::CONNECTION:
+        case DnsError::SERVER_REFUSED:
+            health_.record_failure(id);
+            break;
+    }
+
+    SPDLOG_DEBUG(R"(Hedged resolver #{} failed for "{}": {})", id, hedge->host, error_to_str(error.code));
+    if (error.code == DnsError::NX_DOMAIN || error.code == DnsError::PARSE || error.code == DnsError::CONFIG) {
+        // Non-retryable error — no other resolver will do better.
+        finish(*hedge, std::move(result));
+        return;
+    }
+    hedge->last_error = error;
+
+    // Retryable: ask the next resolver now rather than when the timer fires.
+    if (hedge->next < hedge->order.size()) {
+        if (hedge->timer) {
+            engine_.reactor().cancel_timer(*std::exchange(hedge->timer, std::nullopt));
+        }
+        launch(hedge);
+        return;
+    }
+
+    if (hedge->in_flight == 0) {
+        SPDLOG_ERROR(R"(All {} hedged resolver(s) failed for domain "{}", last error: {})", resolvers_.size(),
+                     hedge->host, error_to_str(hedge->last_error.code));
+        finish(*hedge, std::unexpected(hedge->last_error));
+    }
+}
+
+void HedgedRunner::finish(Hedge &hedge, DispatchResult result) const {
+    if (hedge.timer) {
+        engine_.reactor().cancel_timer(*std::exchange(hedge.timer, std::nullopt));
+    }
+    for (const auto query: hedge.queries) {
+        engine_.cancel(query);
+    }
+    // Resuming the dispatch may destroy this runner, so it comes last.
+    std::exchange(hedge.on_done, nullptr)(std::move(result));
 }
 
 // ===========================================================================
@@ -479,61 +602,186 @@ ConcurrentRunner::run(const std::string &host, RecordKind type) const {
 // ===========================================================================
 
 struct ResolverDispatcher::Impl {
-    Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy);
+    /// A lookup in flight, which later lookups of the same key join.
+    struct Flight {
+        /// The cache epoch the lookup started in.
+        std::uint64_t epoch{0};
+        std::vector<std::function<void(LookupResult)> > waiters;
+    };
+
+    Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy, bool cache);
 
     ~Impl();
 
+    /// Resolve a hostname, from the cache when enabled.
+    /// @return  Resolved addresses on success, or a categorised error on failure.
+    [[nodiscard]] Utils::Task<LookupResult>
+    resolve(std::string host, RecordKind type, std::uint32_t max_retries, std::uint32_t backoff_ms) const;
+
+    /// resolve() with the cache: a cached answer is returned as is, and a
+    /// lookup of a key already in flight waits for that one.
+    [[nodiscard]] Utils::Task<LookupResult>
+    resolve_cached(ResolverEngine &engine, const std::string &host, RecordKind type, std::uint32_t max_retries,
+                   std::uint32_t backoff_ms) const;
+
+    /// The cached answer for @p host, if the cache is enabled and has one.
+    [[nodiscard]] std::optional<LookupResult> cached(const std::string &host, RecordKind type) const;
+
     /// Resolve a hostname with retry support (single-resolver mode only).
     /// For multi-resolver mode, delegates to resolve_multi() without retry
     /// — resolver redundancy provides fault tolerance.
-    /// @return  Resolved addresses on success, or a categorised error on failure.
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
-    resolve(const std::string &host, RecordKind type, std::uint32_t max_retries, std::uint32_t backoff_ms) const;
+    [[nodiscard]] Utils::Task<DispatchResult>
+    dispatch(ResolverEngine &engine, const std::string &host, RecordKind type, std::uint32_t max_retries,
+             std::uint32_t backoff_ms) const;
 
-    /// Resolve a hostname across multiple resolvers (fallback or concurrent).
-    /// Dispatches to FallbackRunner or ConcurrentRunner based on the strategy.
+    /// Resolve a hostname across multiple resolvers (fallback, concurrent or
+    /// hedged).  Dispatches to the runner of the strategy.
     /// @return  Resolved addresses on success, or a categorised error on failure.
-    [[nodiscard]] std::expected<std::vector<std::string>, DnsErrorInfo>
-    resolve_multi(const std::string &host, RecordKind type) const;
+    [[nodiscard]] Utils::Task<DispatchResult>
+    resolve_multi(ResolverEngine &engine, const std::string &host, RecordKind type) const;
+
+    /// The engine, started by the first lookup.
+    [[nodiscard]] ResolverEngine &engine() const;
 
     std::vector<std::unique_ptr<ResolverBase> > resolvers_;
     Config::ResolverStrategy strategy_{Config::ResolverStrategy::CONCURRENT};
+
+    /// Null when caching is disabled.
+    std::unique_ptr<AnswerCache> cache_;
+
+    /// Latency and error stats of the resolvers, for the hedged strategy.
+    /// Engine thread only.
+    mutable ResolverHealth health_;
+
+    /// Lookups in flight, by cache key.  Engine thread only.
+    mutable std::unordered_map<std::string, std::shared_ptr<Flight> > flights_;
+
+    // Declared after resolvers_: the engine is stopped before the resolvers
+    // its workers may still be using are destroyed.
+    mutable std::once_flag engine_once_;
+    mutable std::unique_ptr<ResolverEngine> engine_;
 };
 
 // ===========================================================================
 //  ResolverDispatcher::Impl  —  implementations
 // ===========================================================================
 
-ResolverDispatcher::Impl::Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy)
-    : resolvers_(std::move(resolvers)), strategy_(strategy) {
+ResolverDispatcher::Impl::Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy,
+                               bool cache)
+    : resolvers_(std::move(resolvers)), strategy_(strategy),
+      cache_(cache ? std::make_unique<AnswerCache>() : nullptr) {
 }
 
 ResolverDispatcher::Impl::~Impl() = default;
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
-ResolverDispatcher::Impl::resolve(const std::string &host, RecordKind type, std::uint32_t max_retries,
+ResolverEngine &ResolverDispatcher::Impl::engine() const {
+    std::call_once(engine_once_, [this] { engine_ = std::make_unique<ResolverEngine>(); });
+    return *engine_;
+}
+
+Utils::Task<LookupResult>
+ResolverDispatcher::Impl::resolve(std::string host, RecordKind type, std::uint32_t max_retries,
                                   std::uint32_t backoff_ms) const {
+    auto &engine = this->engine();
+    co_await engine.schedule();
+
+    if (cache_) {
+        co_return co_await resolve_cached(engine, host, type, max_retries, backoff_ms);
+    }
+    co_return records_of(co_await dispatch(engine, host, type, max_retries, backoff_ms));
+}
+
+Utils::Task<LookupResult>
+ResolverDispatcher::Impl::resolve_cached(ResolverEngine &engine, const std::string &host, RecordKind type,
+                                         std::uint32_t max_retries, std::uint32_t backoff_ms) const {
+    const auto key = AnswerCache::make_key(host, type);
+    if (auto answer = cache_->find(key)) {
+        SPDLOG_DEBUG(R"(DNS lookup for "{}" ({}) answered from the cache)", host, magic_enum::enum_name(type));
+        co_return std::move(*answer);
+    }
+
+    // Join a lookup of the same key, unless the cache was invalidated after
+    // it started: its answer may predate the record's update.
+    const auto epoch = cache_->epoch();
+    if (const auto it = flights_.find(key); it != flights_.end() && it->second->epoch == epoch) {
+        SPDLOG_DEBUG(R"(DNS lookup for "{}" ({}) joins the one in flight)", host, magic_enum::enum_name(type));
+        // The lookup that owns the flight keeps it until its waiters resume.
+        auto *flight = it->second.get();
+        co_return co_await Utils::await_callback<LookupResult>(
+            [flight](auto on_done) -> std::optional<LookupResult> {
+                flight->waiters.emplace_back(std::move(on_done));
+                return std::nullopt;
+            });
+    }
+
+    const auto flight = std::make_shared<Flight>(Flight{.epoch = epoch, .waiters = {}});
+    flights_.insert_or_assign(key, flight);
+
+    // Lands the flight: the joined lookups would wait forever otherwise.
+    // Resuming them may start new lookups of the key, so it comes last.
+    const auto land = [this, &key, &flight](const LookupResult &result) {
+        if (const auto it = flights_.find(key); it != flights_.end() && it->second == flight) {
+            flights_.erase(it);
+        }
+        for (const auto &waiter: std::exchange(flight->waiters, {})) {
+            waiter(result);
+        }
+    };
+
+    DispatchResult result;
+    try {
+        result = co_await dispatch(engine, host, type, max_retries, backoff_ms);
+    } catch (const std::exception &e) {
+        land(std::unexpected(DnsErrorInfo{
+            DnsError::UNKNOWN,
+            fmt::format(R"(DNS lookup for "{}" failed: {})", host, e.what())
+        }));
+        throw;
+    }
+
+    const auto ttl = ttl_of(result);
+    auto records = records_of(std::move(result));
+    cache_->store(key, records, ttl, epoch);
+    land(records);
+    co_return records;
+}
+
+std::optional<LookupResult> ResolverDispatcher::Impl::cached(const std::string &host, RecordKind type) const {
+    if (!cache_) {
+        return std::nullopt;
+    }
+    return cache_->find(AnswerCache::make_key(host, type));
+}
+
+Utils::Task<DispatchResult>
+ResolverDispatcher::Impl::dispatch(ResolverEngine &engine, const std::string &host, RecordKind type,
+                                   std::uint32_t max_retries, std::uint32_t backoff_ms) const {
     // Retry is only applied in single-resolver modes (exactly one resolver).
     // Multi-resolver mode (size > 1) runs without retry — the redundancy of multiple resolvers
     // provides fault tolerance, and retrying the entire multi-resolver round is not desired.
     if (resolvers_.size() == 1) {
-        SingleResolverRunner runner(*resolvers_[0]);
-        return runner.run(host, type, max_retries, backoff_ms);
+        const SingleResolverRunner runner(engine, *resolvers_[0]);
+        co_return co_await runner.run(host, type, max_retries, backoff_ms);
     }
 
-    return resolve_multi(host, type);
+    co_return co_await resolve_multi(engine, host, type);
 }
 
-std::expected<std::vector<std::string>, DnsErrorInfo>
-ResolverDispatcher::Impl::resolve_multi(const std::string &host, RecordKind type) const {
+Utils::Task<DispatchResult>
+ResolverDispatcher::Impl::resolve_multi(ResolverEngine &engine, const std::string &host, RecordKind type) const {
     if (strategy_ == Config::ResolverStrategy::FALLBACK) {
         SPDLOG_DEBUG(R"(Fallback mode: trying {} resolver(s) sequentially for "{}")", resolvers_.size(), host);
-        FallbackRunner runner(resolvers_);
-        return runner.run(host, type);
+        const FallbackRunner runner(engine, resolvers_);
+        co_return co_await runner.run(host, type);
     }
 
-    ConcurrentRunner runner(resolvers_);
-    return runner.run(host, type);
+    if (strategy_ == Config::ResolverStrategy::HEDGED) {
+        const HedgedRunner runner(engine, health_, resolvers_);
+        co_return co_await runner.run(host, type);
+    }
+
+    const ConcurrentRunner runner(engine, resolvers_);
+    co_return co_await runner.run(host, type);
 }
 
 // ===========================================================================
@@ -541,8 +789,8 @@ ResolverDispatcher::Impl::resolve_multi(const std::string &host, RecordKind type
 // ===========================================================================
 
 ResolverDispatcher::ResolverDispatcher(std::vector<std::unique_ptr<ResolverBase> > resolvers,
-                                       Config::ResolverStrategy strategy)
-    : impl_(std::make_unique<Impl>(std::move(resolvers), strategy)) {
+                                       Config::ResolverStrategy strategy, bool cache)
+    : impl_(std::make_unique<Impl>(std::move(resolvers), strategy, cache)) {
 }
 
 ResolverDispatcher::~ResolverDispatcher() = default;
@@ -554,5 +802,43 @@ ResolverDispatcher &ResolverDispatcher::operator=(ResolverDispatcher &&) noexcep
 std::expected<std::vector<std::string>, DnsErrorInfo>
 ResolverDispatcher::resolve(const std::string &host, RecordKind type, std::uint32_t max_retries,
                             std::uint32_t backoff_ms) const {
-    return impl_->resolve(host, type, max_retries, backoff_ms);
+    // A cached answer needs no trip through the engine thread.
+    if (auto answer = impl_->cached(host, type)) {
+        return values_of(std::move(*answer));
+    }
+    return values_of(Utils::sync_wait(impl_->resolve(host, type, max_retries, backoff_ms)));
+}
+
+Utils::Task<std::expected<std::vector<std::string>, DnsErrorInfo> >
+ResolverDispatcher::resolve_async(std::string host, RecordKind type, std::uint32_t max_retries,
+                                  std::uint32_t backoff_ms) const {
+    co_return values_of(co_await impl_->resolve(std::move(host), type, max_retries, backoff_ms));
+}
+
+std::expected<AddressList, DnsErrorInfo>
+ResolverDispatcher::resolve_addresses(const std::string &host, RecordKind type, std::uint32_t max_retries,
+                                      std::uint32_t backoff_ms) const {
+    if (auto answer = impl_->cached(host, type)) {
+        return addresses_of(std::move(*answer));
+    }
+    return addresses_of(Utils::sync_wait(impl_->resolve(host, type, max_retries, backoff_ms)));
+}
+
+Utils::Task<std::expected<AddressList, DnsErrorInfo> >
+ResolverDispatcher::resolve_addresses_async(std::string host, RecordKind type, std::uint32_t max_retries,
+                                            std::uint32_t backoff_ms) const {
+    co_return addresses_of(co_await impl_->resolve(std::move(host), type, max_retries, backoff_ms));
+}
+
+void ResolverDispatcher::invalidate(const std::string &host) const {
+    if (impl_->cache_) {
+        SPDLOG_DEBUG(R"(Dropping the cached answers for "{}")", host);
+        impl_->cache_->invalidate(host);
+    }
+}
+
+void ResolverDispatcher::clear_cache() const {
+    if (impl_->cache_) {
+        impl_->cache_->clear();
+    }
 }
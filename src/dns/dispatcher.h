@@ -14,23 +14,51 @@
 #include "config/dns_config.h"
 
 #include "dns/dns_error_info.h"
+#include "network/inet_address.h"
 #include "record_kind.h"
+#include "util/task.hpp"
 
 class ResolverBase;
 
 /// ResolverDispatcher — dispatches DNS queries across one or more backend
 ///                      resolvers using a configurable strategy (fallback /
-///                      concurrent), with automatic retry on transient errors.
+///                      concurrent / hedged), with automatic retry on
+///                      transient errors.
 ///
 /// Eliminates the need to pass resolver vectors through every layer.
-/// @note Thread-safe: resolve() is const and does not mutate shared state.
+///
+/// With the native backend, queries run on a persistent engine thread that
+/// is started by the first lookup: a concurrent batch is sent from that one
+/// thread and its replies are multiplexed, instead of spawning a thread per
+/// resolver per lookup.
+///
+/// The hedged strategy (native backend only) keeps latency and error stats
+/// per resolver and queries the best one first, hedging to the next only
+/// when it is slower than usual.  See ResolverHealth.
+///
+/// With the answer cache enabled (native backend only), an answer is reused
+/// for as long as its TTL allows, NXDOMAIN and NODATA included (RFC 2308),
+/// and a lookup of a name and type already in flight waits for that one
+/// instead of querying again.  See AnswerCache.
+///
+/// resolve() returns every record as text, as the CLI prints it;
+/// resolve_addresses() returns the A and AAAA records as addresses, decoded
+/// straight from the response, for callers that compare them.
+///
+/// @note Thread-safe: the resolve methods may be called from any number of
+///       threads at once.
 class ResolverDispatcher {
 public:
     /// Construct with a list of resolver backends and a dispatch strategy.
     /// @param resolvers  Vector of resolver backends to query.
-    /// @param strategy   Dispatch strategy (fallback or concurrent).
+    /// @param strategy   Dispatch strategy (fallback, concurrent or hedged;
+    ///                   the deprecated system backend runs hedged as
+    ///                   concurrent).
+    /// @param cache      Enable the answer cache (ignored by the deprecated
+    ///                   system backend).
     explicit ResolverDispatcher(std::vector<std::unique_ptr<ResolverBase> > resolvers,
-                                Config::ResolverStrategy strategy = Config::ResolverStrategy::CONCURRENT);
+                                Config::ResolverStrategy strategy = Config::ResolverStrategy::CONCURRENT,
+                                bool cache = false);
 
     ~ResolverDispatcher();
 
@@ -60,6 +88,45 @@ public:
     resolve(const std::string &host, RecordKind type, std::uint32_t max_retries = 1,
             std::uint32_t backoff_ms = 50) const;
 
+    /// resolve(), as a coroutine that does not hold up a thread while the
+    /// queries are in flight.
+    ///
+    /// The lookup does not start until the task is awaited; the awaiting
+    /// coroutine is resumed on the engine thread, and should move on (see
+    /// Utils::schedule()) before doing any blocking work.  The dispatcher
+    /// must outlive the task.
+    ///
+    /// @note resolve() must not be called from the engine thread itself,
+    ///       i.e. from a coroutine resumed by resolve_async() that has not
+    ///       moved on yet; it would wait on itself.
+    [[nodiscard]] Utils::Task<std::expected<std::vector<std::string>, DnsErrorInfo> >
+    resolve_async(std::string host, RecordKind type, std::uint32_t max_retries = 1,
+                  std::uint32_t backoff_ms = 50) const;
+
+    /// resolve(), returning the addresses of the A and AAAA records rather
+    /// than the text of every record.
+    ///
+    /// Other records in the answer, such as the CNAME chain that led to the
+    /// addresses, are left out, so the list may be empty.  Addresses are in
+    /// the order of the answer; compare them as a set, since servers rotate
+    /// round-robin records.
+    [[nodiscard]] std::expected<AddressList, DnsErrorInfo>
+    resolve_addresses(const std::string &host, RecordKind type, std::uint32_t max_retries = 1,
+                      std::uint32_t backoff_ms = 50) const;
+
+    /// resolve_addresses(), as a coroutine; see resolve_async().
+    [[nodiscard]] Utils::Task<std::expected<AddressList, DnsErrorInfo> >
+    resolve_addresses_async(std::string host, RecordKind type, std::uint32_t max_retries = 1,
+                            std::uint32_t backoff_ms = 50) const;
+
+    /// Forget the cached answers for @p host, e.g. once its record has been
+    /// updated.  A lookup in flight is not joined or cached afterwards.
+    /// A no-op without the cache.
+    void invalidate(const std::string &host) const;
+
+    /// Forget every cached answer.  A no-op without the cache.
+    void clear_cache() const;
+
 private:
     struct Impl;
     std::unique_ptr<Impl> impl_;
@@ -92,8 +92,15 @@ struct ResolverDispatcher::Impl {
                                const Utils::CancellationToken &cancel_token);
 
     // ── Constructor / Destructor ──
-    Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy)
+    Impl(std::vector<std::unique_ptr<ResolverBase> > resolvers, Config::ResolverStrategy strategy, bool cache)
         : strategy_(strategy) {
+        if (cache) {
+            SPDLOG_WARN("The DNS answer cache is not supported by the system resolver backend; it stays disabled");
+        }
+        if (strategy_ == Config::ResolverStrategy::HEDGED) {
+            SPDLOG_WARN("The hedged strategy is not supported by the system resolver backend; using concurrent");
+            strategy_ = Config::ResolverStrategy::CONCURRENT;
+        }
         resolvers_.reserve(resolvers.size());
         for (auto &r: resolvers) {
             resolvers_.push_back(std::move(r)); // unique_ptr → shared_ptr
@@ -469,8 +476,8 @@ std::vector<std::string> ResolverDispatcher::Impl::resolve_concurrent(const std:
 // ===========================================================================
 
 ResolverDispatcher::ResolverDispatcher(std::vector<std::unique_ptr<ResolverBase> > resolvers,
-                                       Config::ResolverStrategy strategy)
-    : impl_(std::make_unique<Impl>(std::move(resolvers), strategy)) {
+                                       Config::ResolverStrategy strategy, bool cache)
+    : impl_(std::make_unique<Impl>(std::move(resolvers), strategy, cache)) {
 }
 
 ResolverDispatcher::~ResolverDispatcher() = default;
@@ -484,3 +491,42 @@ ResolverDispatcher::resolve(const std::string &host, RecordKind type, std::uint3
                             std::uint32_t backoff_ms) const {
     return impl_->resolve(host, type, max_retries, backoff_ms);
 }
+
+// The legacy backend has no engine: the lookup blocks the awaiting thread.
+Utils::Task<std::expected<std::vector<std::string>, DnsErrorInfo> >
+ResolverDispatcher::resolve_async(std::string host, RecordKind type, std::uint32_t max_retries,
+                                  std::uint32_t backoff_ms) const {
+    co_return resolve(host, type, max_retries, backoff_ms);
+}
+
+// The legacy backend only keeps the text of the records; the addresses are
+// parsed back from it, skipping the records that are not addresses.
+std::expected<AddressList, DnsErrorInfo>
+ResolverDispatcher::resolve_addresses(const std::string &host, RecordKind type, std::uint32_t max_retries,
+                                      std::uint32_t backoff_ms) const {
+    auto records = resolve(host, type, max_retries, backoff_ms);
+    if (!records) {
+        return std::unexpected(std::move(records.error()));
+    }
+
+    AddressList addresses;
+    for (const auto &record: *records) {
+        if (const auto address = InetAddress::parse(record)) {
+            addresses.push_back(*address);
+        }
+    }
+    return addresses;
+}
+
+Utils::Task<std::expected<AddressList, DnsErrorInfo> >
+ResolverDispatcher::resolve_addresses_async(std::string host, RecordKind type, std::uint32_t max_retries,
+                                            std::uint32_t backoff_ms) const {
+    co_return resolve_addresses(host, type, max_retries, backoff_ms);
+}
+
+// The legacy backend has no answer cache.
+void ResolverDispatcher::invalidate(const std::string &) const {
+}
+
+void ResolverDispatcher::clear_cache() const {
+}
@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DNS_ERROR_INFO_H
 #define YADDNSC_DNS_ERROR_INFO_H
 
+#include <cstdint>
 #include <string>
 #include <string_view>
 
@@ -21,6 +22,9 @@
 struct DnsErrorInfo {
     DnsError code{DnsError::UNKNOWN};
     std::string message;
+    /// Seconds a NX_DOMAIN or NODATA answer may be cached (RFC 2308); 0 for
+    /// every other error.
+    std::uint32_t ttl{0};
 
     [[nodiscard]] std::string_view error_name() const noexcept {
         return error_to_str(code);
@@ -17,6 +17,21 @@
 
 #include <spdlog/spdlog.h>
 
+namespace {
+    /// The config spelling of @p strategy.
+    [[nodiscard]] const char *strategy_name(Config::ResolverStrategy strategy) noexcept {
+        switch (strategy) {
+            case Config::ResolverStrategy::FALLBACK:
+                return "fallback";
+            case Config::ResolverStrategy::CONCURRENT:
+                return "concurrent";
+            case Config::ResolverStrategy::HEDGED:
+                return "hedged";
+        }
+        return "unknown";
+    }
+} // anonymous namespace
+
 // ===========================================================================
 // DnsResolverFactory::create — build a ResolverDispatcher from app config.
 // ===========================================================================
@@ -53,8 +68,12 @@ ResolverDispatcher DnsResolverFactory::create(const Config::AppConfig &config) {
     // Log configured custom resolver count and strategy — once at startup.
     if (dns_servers.size() > 1) {
         SPDLOG_INFO("Configured {} custom resolver(s) in {} mode", dns_servers.size(),
-                    config.resolver.strategy == Config::ResolverStrategy::FALLBACK ? "fallback" : "concurrent");
+                    strategy_name(config.resolver.strategy));
+    }
+
+    if (config.resolver.cache) {
+        SPDLOG_INFO("DNS answer cache enabled");
     }
 
-    return ResolverDispatcher(std::move(resolvers), config.resolver.strategy);
+    return ResolverDispatcher(std::move(resolvers), config.resolver.strategy, config.resolver.cache);
 }
@@ -0,0 +1,321 @@
+//
+// Created by Kotarou on 2026/8/29.
+//
+
+#include "dns/parser/message_view.h"
+
+#include <array>
+#include <cstring>
+#include <string>
+
+#include "exception/dns_lookup.h"
+#include "util/byte_scan.hpp"
+#include "util/bytes.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+
+namespace {
+    constexpr std::uint8_t MAX_LABEL_LENGTH = 63; // RFC 1035 §2.3.4
+    constexpr size_t MAX_NAME_TEXT_LENGTH = 253; // A 255-octet name in dotted form, RFC 1035 §2.3.4
+    constexpr int MAX_POINTER_DEPTH = 7; // Cycle / indirection limit
+    constexpr size_t QUESTION_FIXED_SIZE = 4; // QTYPE(2) + QCLASS(2)
+    constexpr size_t RR_FIXED_SIZE = 10; // TYPE(2) + CLASS(2) + TTL(4) + RDLENGTH(2)
+
+    constexpr std::uint8_t FLAGS_QR = 0x80; // byte 2
+    constexpr std::uint8_t FLAGS_AA = 0x04; // byte 2
+    constexpr std::uint8_t FLAGS_TC = 0x02; // byte 2
+    constexpr std::uint8_t FLAGS3_RA = 0x80; // byte 3
+    constexpr std::uint8_t FLAGS3_RCODE = 0x0F; // byte 3, lower 4 bits
+
+    constexpr bool is_pointer(std::uint8_t label_len) noexcept {
+        return (label_len & 0xC0) == 0xC0;
+    }
+
+    /// Follow the name at @p offset, calling @p on_label with each label in
+    /// order until it returns false or the root label is reached.
+    template<typename OnLabel>
+    void walk_name(const std::span<const std::uint8_t> wire, size_t offset, OnLabel &&on_label) {
+        // Offsets already jumped to, for cycle detection: the chain is short,
+        // so a linear scan of a stack array beats any set.
+        const auto wire_len = wire.size();
+        std::array<size_t, MAX_POINTER_DEPTH> visited{};
+        size_t visited_count = 0;
+
+        size_t current = offset;
+        while (true) {
+            if (current >= wire_len) {
+                throw DnsLookupException(
+                    fmt::format("DNS name decompression: offset {} beyond wire length {}", current, wire_len),
+                    DnsError::PARSE
+                );
+            }
+
+            const auto label_len = wire[current];
+            if (is_pointer(label_len)) {
+                if (current + 2 > wire_len) {
+                    throw DnsLookupException(
+                        fmt::format("DNS name decompression: pointer at offset {} truncated", current),
+                        DnsError::PARSE
+                    );
+                }
+                if (visited_count == MAX_POINTER_DEPTH) {
+                    throw DnsLookupException(
+                        fmt::format("DNS name decompression: too many indirections ({})", MAX_POINTER_DEPTH),
+                        DnsError::PARSE
+                    );
+                }
+
+                const auto ptr_offset = static_cast<size_t>(((label_len & 0x3F) << 8) | wire[current + 1]);
+                for (size_t i = 0; i < visited_count; ++i) {
+                    if (visited[i] == ptr_offset) {
+                        throw DnsLookupException(
+                            fmt::format("DNS name decompression: repeated pointer to offset {} (cycle)", ptr_offset),
+                            DnsError::PARSE
+                        );
+                    }
+                }
+                visited[visited_count++] = ptr_offset;
+                current = ptr_offset;
+                continue;
+            }
+
+            if (label_len == 0) [[likely]] {
+                return;
+            }
+
+            if (label_len > MAX_LABEL_LENGTH) {
+                throw DnsLookupException(
+                    fmt::format("DNS name decompression: invalid label length {} at offset {}", label_len, current),
+                    DnsError::PARSE
+                );
+            }
+
+            ++current;
+            if (current + label_len > wire_len) {
+                throw DnsLookupException(
+                    fmt::format("DNS name decompression: label of length {} extends past wire end", label_len),
+                    DnsError::PARSE
+                );
+            }
+
+            if (!on_label(std::string_view(reinterpret_cast<const char *>(wire.data() + current), label_len))) {
+                return;
+            }
+            current += label_len;
+        }
+    }
+} // anonymous namespace
+
+// =============================================================================
+// NameView
+// =============================================================================
+
+std::string DNS::NameView::to_string() const {
+    // Decompress into a stack buffer first, so that the result is allocated
+    // once at its final size rather than grown a label at a time.
+    std::array<char, MAX_NAME_TEXT_LENGTH> buffer;
+    size_t size = 0;
+    walk_name(wire_, offset_, [&](std::string_view label) {
+        const auto separator = size != 0 ? 1U : 0U;
+        if (size + separator + label.size() > buffer.size()) {
+            throw DnsLookupException(
+                fmt::format("DNS name decompression: name longer than {} characters", MAX_NAME_TEXT_LENGTH),
+                DnsError::PARSE
+            );
+        }
+        if (separator != 0) {
+            buffer[size++] = '.';
+        }
+        std::memcpy(buffer.data() + size, label.data(), label.size());
+        size += label.size();
+        return true;
+    });
+    return {buffer.data(), size};
+}
+
+bool DNS::NameView::equals(std::string_view name) const {
+    if (name.ends_with('.')) {
+        name.remove_suffix(1);
+    }
+
+    // Each label must match the next dot-separated part of `name`, and the
+    // labels must use all of it.
+    size_t pos = 0;
+    bool matched = true;
+    walk_name(wire_, offset_, [&](std::string_view label) {
+        if (pos != 0) {
+            if (pos >= name.size() || name[pos] != '.') {
+                matched = false;
+                return false;
+            }
+            ++pos;
+        }
+        if (!Utils::ByteScan::iequals(name.substr(pos, label.size()), label)) {
+            matched = false;
+            return false;
+        }
+        pos += label.size();
+        return true;
+    });
+    return matched && pos == name.size();
+}
+
+size_t DNS::NameView::skip(const std::span<const std::uint8_t> wire, size_t offset) {
+    const auto wire_len = wire.size();
+    while (true) {
+        if (offset >= wire_len) {
+            throw DnsLookupException(
+                fmt::format("DNS name decompression: offset {} beyond wire length {}", offset, wire_len),
+                DnsError::PARSE
+            );
+        }
+
+        const auto label_len = wire[offset];
+        if (is_pointer(label_len)) {
+            if (offset + 2 > wire_len) {
+                throw DnsLookupException(
+                    fmt::format("DNS name decompression: pointer at offset {} truncated", offset),
+                    DnsError::PARSE
+                );
+            }
+            const auto ptr_offset = static_cast<size_t>(((label_len & 0x3F) << 8) | wire[offset + 1]);
+            if (ptr_offset >= wire_len) {
+                throw DnsLookupException(
+                    fmt::format("DNS name decompression: pointer to offset {} beyond wire length {}", ptr_offset,
+                                wire_len),
+                    DnsError::PARSE
+                );
+            }
+            return offset + 2;
+        }
+
+        if (label_len == 0) [[likely]] {
+            return offset + 1;
+        }
+
+        if (label_len > MAX_LABEL_LENGTH) {
+            throw DnsLookupException(
+                fmt::format("DNS name decompression: invalid label length {} at offset {}", label_len, offset),
+                DnsError::PARSE
+            );
+        }
+        if (offset + 1 + label_len > wire_len) {
+            throw DnsLookupException(
+                fmt::format("DNS name decompression: label of length {} extends past wire end", label_len),
+                DnsError::PARSE
+            );
+        }
+        offset += 1 + label_len;
+    }
+}
+
+// =============================================================================
+// MessageView
+// =============================================================================
+
+bool DNS::MessageView::fits(const std::span<const std::uint8_t> data) noexcept {
+    if (data.size() < HEADER_SIZE) {
+        return true;
+    }
+
+    const size_t records = static_cast<size_t>(Utils::Bytes::read_u16_be(data, 6)) +
+                           Utils::Bytes::read_u16_be(data, 8) + Utils::Bytes::read_u16_be(data, 10);
+    return Utils::Bytes::read_u16_be(data, 4) <= MAX_QUESTIONS && records <= MAX_RECORDS;
+}
+
+DNS::MessageView::MessageView(const std::span<const std::uint8_t> data) : wire_(data) {
+    if (data.size() < HEADER_SIZE) [[unlikely]] {
+        throw DnsLookupException(
+            fmt::format("DNS packet too short: {} bytes (minimum {} bytes)", data.size(), HEADER_SIZE),
+            DnsError::PARSE
+        );
+    }
+    if (!fits(data)) [[unlikely]] {
+        throw DnsLookupException(
+            fmt::format("DNS message has more entries than a view holds ({} questions, {} records)",
+                        MAX_QUESTIONS, MAX_RECORDS),
+            DnsError::PARSE
+        );
+    }
+
+    // ── Header (12 bytes) ──
+    id_ = Utils::Bytes::read_u16_be(data);
+    qr_ = (data[2] & FLAGS_QR) != 0;
+    aa_ = (data[2] & FLAGS_AA) != 0;
+    tc_ = (data[2] & FLAGS_TC) != 0;
+    ra_ = (data[3] & FLAGS3_RA) != 0;
+    rcode_ = static_cast<Rcode>(data[3] & FLAGS3_RCODE);
+
+    qdcount_ = Utils::Bytes::read_u16_be(data, 4);
+    ancount_ = Utils::Bytes::read_u16_be(data, 6);
+    nscount_ = Utils::Bytes::read_u16_be(data, 8);
+    arcount_ = Utils::Bytes::read_u16_be(data, 10);
+
+    size_t offset = HEADER_SIZE;
+
+    // ── Question section ──
+    for (size_t i = 0; i < qdcount_; ++i) {
+        auto &q = questions_[i];
+        q.qname = NameView(data, offset);
+        offset = NameView::skip(data, offset);
+        if (offset + QUESTION_FIXED_SIZE > data.size()) [[unlikely]] {
+            throw DnsLookupException(
+                fmt::format("DNS question section truncated at offset {}", offset),
+                DnsError::PARSE
+            );
+        }
+        q.qtype = Utils::Bytes::read_u16_be(data, offset);
+        q.qclass = Utils::Bytes::read_u16_be(data, offset + 2);
+        offset += QUESTION_FIXED_SIZE;
+    }
+
+    // ── Answer, authority and additional records, back to back ──
+    const auto record_count = ancount_ + nscount_ + arcount_;
+    for (size_t i = 0; i < record_count; ++i) {
+        auto &rr = records_[i];
+        rr.name = NameView(data, offset);
+        offset = NameView::skip(data, offset);
+        if (offset + RR_FIXED_SIZE > data.size()) [[unlikely]] {
+            throw DnsLookupException(
+                fmt::format("DNS RR header truncated at offset {}", offset),
+                DnsError::PARSE
+            );
+        }
+        rr.type = Utils::Bytes::read_u16_be(data, offset);
+        rr.qclass = Utils::Bytes::read_u16_be(data, offset + 2);
+        rr.ttl = Utils::Bytes::read_u32_be(data, offset + 4);
+        const auto rd_length = static_cast<size_t>(Utils::Bytes::read_u16_be(data, offset + 8));
+        offset += RR_FIXED_SIZE;
+        if (offset + rd_length > data.size()) [[unlikely]] {
+            throw DnsLookupException(
+                fmt::format("DNS RDATA truncated at offset {} (declared {})", offset, rd_length),
+                DnsError::PARSE
+            );
+        }
+        rr.rdata = data.subspan(offset, rd_length);
+        rr.rdata_offset = offset;
+        offset += rd_length;
+
+        // EDNS0 OPT pseudo-record (RFC 6891 §6.1): root NAME in the
+        // additional section, CLASS carrying a non-zero UDP payload size.
+        if (i >= ancount_ + nscount_ && rr.type == static_cast<std::uint16_t>(RecordType::OPT) &&
+            data[rr.name.offset()] == 0 && rr.qclass > 0) [[unlikely]] {
+            opt_index_ = i;
+        }
+    }
+
+    // ── Combine RCODE with EDNS0 extended RCODE (upper 8 bits of the TTL) ──
+    if (opt_index_) [[unlikely]] {
+        const auto extended_rcode = static_cast<std::uint8_t>(records_[*opt_index_].ttl >> 24);
+        rcode_ = static_cast<Rcode>(static_cast<std::uint8_t>(rcode_) | (extended_rcode << 4));
+    }
+}
+
+std::optional<DNS::RecordView> DNS::MessageView::opt() const noexcept {
+    if (!opt_index_) {
+        return std::nullopt;
+    }
+    return records_[*opt_index_];
+}
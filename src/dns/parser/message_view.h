@@ -0,0 +1,199 @@
+//
+// Created by Kotarou on 2026/8/29.
+//
+
+#ifndef YADDNSC_DNS_MESSAGE_VIEW_H
+#define YADDNSC_DNS_MESSAGE_VIEW_H
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "dns/types.h"
+
+namespace DNS {
+    // =============================================================================
+    // NameView — a domain name left in the wire buffer
+    // =============================================================================
+
+    /// A domain name inside a wire-format message, decompressed only when asked.
+    ///
+    /// Compression pointers (RFC 1035 §4.1.4) may point anywhere earlier in the
+    /// message, so the view keeps the whole message plus the offset the name
+    /// starts at.  Pointer chains are followed, and checked for cycles, by
+    /// to_string() and equals(); building the view itself does no work.
+    class NameView {
+    public:
+        NameView() = default;
+
+        NameView(std::span<const std::uint8_t> wire, size_t offset) noexcept : wire_(wire), offset_(offset) {
+        }
+
+        /// Offset of the first byte of the name within the message.
+        [[nodiscard]] size_t offset() const noexcept {
+            return offset_;
+        }
+
+        /// Decompress into dotted form ("www.example.com"; "" for the root).
+        /// @throws DnsLookupException on malformed names.
+        [[nodiscard]] std::string to_string() const;
+
+        /// Compare with a dotted name, ignoring ASCII case (RFC 4343) and a
+        /// trailing dot, without decompressing into a string.
+        /// @throws DnsLookupException on malformed names.
+        [[nodiscard]] bool equals(std::string_view name) const;
+
+        /// Offset just past the name starting at @p offset: past its root
+        /// label, or past the first compression pointer.  Only the labels up
+        /// to that point are validated; pointers are checked to stay inside
+        /// the message but not followed.
+        /// @throws DnsLookupException on malformed names.
+        [[nodiscard]] static size_t skip(std::span<const std::uint8_t> wire, size_t offset);
+
+    private:
+        std::span<const std::uint8_t> wire_;
+        size_t offset_{0};
+    };
+
+    // =============================================================================
+    // Section entry views
+    // =============================================================================
+
+    /// A question section entry; see Question.
+    struct QuestionView {
+        NameView qname;
+        std::uint16_t qtype{0};
+        std::uint16_t qclass{0};
+    };
+
+    /// A resource record whose name and RDATA stay in the wire buffer; see
+    /// ResourceRecord.
+    struct RecordView {
+        NameView name;
+        std::uint16_t type{0};
+        std::uint16_t qclass{0};
+        std::uint32_t ttl{0};
+        std::span<const std::uint8_t> rdata;
+
+        /// Offset of RDATA within the message, for domain names in RDATA.
+        size_t rdata_offset{0};
+    };
+
+    // =============================================================================
+    // MessageView — allocation-free DNS message parser
+    // =============================================================================
+
+    /// Zero-copy view of a DNS response (RFC 1035 §4.1).
+    ///
+    /// Reads the header and walks every section once, recording each entry's
+    /// fixed fields and where its name and RDATA lie in the buffer.  Entries
+    /// are kept in fixed-capacity inline storage and nothing is copied or
+    /// decompressed, so parsing never allocates: the A/AAAA hot path reads
+    /// RDATA straight from the buffer and never needs a name at all.
+    ///
+    /// The EDNS0 OPT pseudo-record (RFC 6891) is located and its extended
+    /// RCODE folded into rcode(); its options are not parsed.
+    ///
+    /// Messages with more entries than the inline storage holds are rejected;
+    /// check fits() first and fall back to RecordParser for those.
+    ///
+    /// @note The view, and every NameView, QuestionView and RecordView taken
+    ///       from it, points into the buffer it was built from, which must
+    ///       outlive them.
+    class MessageView {
+    public:
+        static constexpr size_t MAX_QUESTIONS = 4;
+
+        /// Answer, authority and additional records together.  Ample for the
+        /// responses a DDNS client sees; a larger round-robin set is rare.
+        static constexpr size_t MAX_RECORDS = 32;
+
+        /// Whether the section counts in @p data's header fit the inline storage.
+        /// A buffer too short to hold a header "fits" (and fails to parse).
+        [[nodiscard]] static bool fits(std::span<const std::uint8_t> data) noexcept;
+
+        /// Parse a raw DNS message.
+        /// @param data  Span covering the raw packet bytes.
+        /// @throws DnsLookupException on malformed packets, or ones that do not fit().
+        explicit MessageView(std::span<const std::uint8_t> data);
+
+        // ── Header ──
+
+        [[nodiscard]] std::uint16_t id() const noexcept {
+            return id_;
+        }
+
+        [[nodiscard]] bool qr() const noexcept {
+            return qr_;
+        }
+
+        [[nodiscard]] bool aa() const noexcept {
+            return aa_;
+        }
+
+        [[nodiscard]] bool tc() const noexcept {
+            return tc_;
+        }
+
+        [[nodiscard]] bool ra() const noexcept {
+            return ra_;
+        }
+
+        /// The response code, including the EDNS0 extended RCODE bits.
+        [[nodiscard]] Rcode rcode() const noexcept {
+            return rcode_;
+        }
+
+        // ── Sections ──
+
+        [[nodiscard]] std::span<const QuestionView> questions() const noexcept {
+            return std::span(questions_).first(qdcount_);
+        }
+
+        [[nodiscard]] std::span<const RecordView> answers() const noexcept {
+            return std::span(records_).first(ancount_);
+        }
+
+        [[nodiscard]] std::span<const RecordView> authorities() const noexcept {
+            return std::span(records_).subspan(ancount_, nscount_);
+        }
+
+        [[nodiscard]] std::span<const RecordView> additionals() const noexcept {
+            return std::span(records_).subspan(ancount_ + nscount_, arcount_);
+        }
+
+        /// The EDNS0 OPT pseudo-record, if present.
+        [[nodiscard]] std::optional<RecordView> opt() const noexcept;
+
+        /// The message the view was built from.
+        [[nodiscard]] std::span<const std::uint8_t> wire() const noexcept {
+            return wire_;
+        }
+
+    private:
+        std::span<const std::uint8_t> wire_;
+
+        std::uint16_t id_{0};
+        bool qr_{false};
+        bool aa_{false};
+        bool tc_{false};
+        bool ra_{false};
+        Rcode rcode_{Rcode::NOERROR};
+
+        size_t qdcount_{0};
+        size_t ancount_{0};
+        size_t nscount_{0};
+        size_t arcount_{0};
+
+        // Index into records_ of the OPT record, if any.
+        std::optional<size_t> opt_index_;
+
+        std::array<QuestionView, MAX_QUESTIONS> questions_{};
+        std::array<RecordView, MAX_RECORDS> records_{};
+    };
+} // namespace DNS
+
+#endif  // YADDNSC_DNS_MESSAGE_VIEW_H
@@ -6,13 +6,16 @@
 //
 #include "dns/parser/parser_native.h"
 
+#include <algorithm>
 #include <array>
 #include <limits>
+#include <optional>
 #include <ranges>
 #include <string>
 #include <system_error>
 #include <vector>
 
+#include "dns/parser/message_view.h"
 #include "exception/dns_lookup.h"
 #include "util/bytes.hpp"
 
@@ -29,11 +32,9 @@
 // =============================================================================
 
 namespace {
-    constexpr size_t NAME_MAX_BYTES = 255; // RFC 1035 §2.3.4
-    constexpr uint8_t MAX_LABEL_LENGTH = 63; // RFC 1035 §2.3.4
-    constexpr int MAX_POINTER_DEPTH = 7; // Cycle / indirection limit
     constexpr size_t QUESTION_FIXED_SIZE = 4; // QTYPE(2) + QCLASS(2)
     constexpr size_t RR_FIXED_SIZE = 10; // TYPE(2) + CLASS(2) + TTL(4) + RDLENGTH(2)
+    constexpr size_t SOA_MINIMUM_OFFSET = 16; // SERIAL, REFRESH, RETRY, EXPIRE precede it
 
     // EDNS0 constants
     constexpr size_t OPT_NAME_SIZE = 1; // Root label (0x00)
@@ -51,108 +52,60 @@ namespace {
     constexpr uint32_t EDNS_TTL_RCODE_MASK = 0xFF000000U;
     constexpr uint32_t EDNS_TTL_VERSION_MASK = 0x00FF0000U;
     constexpr uint32_t EDNS_TTL_DO_MASK = 0x00008000U;
-} // anonymous namespace
-
-// =============================================================================
-// Name decompression (RFC 1035 §4.1.4)
-// =============================================================================
-
-std::string DNS::RecordParser::decompress_name(const std::span<const std::uint8_t> wire, size_t &offset) {
-    // Track visited offsets to detect pointer cycles.
-    // Fixed-size array on the stack: zero allocation, cache-friendly.
-    // MAX_POINTER_DEPTH (16) bounds the worst-case chain length, so
-    // a simple linear scan is both simpler and faster than a hash set.
-    const auto wire_len = wire.size();
-    std::array<size_t, MAX_POINTER_DEPTH> visited{};
-    size_t visited_count = 0;
-    std::string result;
-    result.reserve(NAME_MAX_BYTES);
 
-    size_t current = offset;
-    int indirections = 0;
-    bool jumped = false;
-
-    while (true) {
-        if (current >= wire_len) {
-            throw DnsLookupException(
-                fmt::format("DNS name decompression: offset {} beyond wire length {}", current, wire_len),
-                DnsError::PARSE);
+    /// MINIMUM field of the SOA whose RDATA starts at @p rdata_offset, or
+    /// std::nullopt when the RDATA is truncated or its names are malformed.
+    std::optional<std::uint32_t> soa_minimum(const std::span<const std::uint8_t> wire, const size_t rdata_offset) {
+        const size_t rdata_end = rdata_offset + Utils::Bytes::read_u16_be(wire, rdata_offset - 2);
+        size_t offset;
+        try {
+            offset = DNS::NameView::skip(wire, rdata_offset); // MNAME
+            offset = DNS::NameView::skip(wire, offset); // RNAME
+        } catch (const DnsLookupException &e) {
+            SPDLOG_DEBUG("DNS SOA record has a malformed name: {}", e.what());
+            return std::nullopt;
         }
-
-        const auto label_len = wire[current];
-
-        // Detect pointer (top two bits set: 0xC0).
-        if ((label_len & 0xC0) == 0xC0) {
-            if (current + 2 > wire_len) {
-                throw DnsLookupException(
-                    fmt::format("DNS name decompression: pointer at offset {} truncated", current),
-                    DnsError::PARSE
-                );
-            }
-
-            const auto ptr_offset = static_cast<size_t>(
-                ((static_cast<size_t>(label_len) & 0x3F) << 8) | wire[current + 1]);
-
-            if (indirections++ >= MAX_POINTER_DEPTH) {
-                throw DnsLookupException(
-                    fmt::format("DNS name decompression: too many indirections ({})", MAX_POINTER_DEPTH),
-                    DnsError::PARSE
-                );
-            }
-
-            // Linear scan of visited offsets (max 16 iterations, no allocation).
-            for (size_t i = 0; i < visited_count; ++i) {
-                if (visited[i] == ptr_offset) {
-                    throw DnsLookupException(
-                        fmt::format("DNS name decompression: repeated pointer to offset {} (cycle)", ptr_offset),
-                        DnsError::PARSE
-                    );
-                }
-            }
-            visited[visited_count++] = ptr_offset;
-
-            if (!jumped) {
-                // First pointer: advance the caller's offset past the pointer.
-                offset = current + 2;
-                jumped = true;
-            }
-            current = ptr_offset;
-            continue;
-        }
-
-        // Normal label.
-        if (label_len == 0) [[likely]] {
-            // Root label — end of name.
-            if (!jumped) {
-                offset = current + 1;
-            }
-            break;
+        if (offset + SOA_MINIMUM_OFFSET + sizeof(std::uint32_t) > rdata_end) [[unlikely]] {
+            SPDLOG_DEBUG("DNS SOA record truncated at offset {}", offset);
+            return std::nullopt;
         }
+        return Utils::Bytes::read_u32_be(wire, offset + SOA_MINIMUM_OFFSET);
+    }
 
-        if (label_len > MAX_LABEL_LENGTH) {
-            throw DnsLookupException(
-                fmt::format("DNS name decompression: invalid label length {} at offset {}", label_len, current),
-                DnsError::PARSE
-            );
+    /// Seconds a response may be cached (see FormattedResponse::ttl).
+    /// @p Section is std::vector<ResourceRecord> or std::span<const RecordView>.
+    template<typename Section>
+    std::uint32_t cache_ttl(const DNS::Rcode rcode, const Section &answers, const Section &authorities,
+                            const std::span<const std::uint8_t> wire) {
+        if (rcode == DNS::Rcode::NOERROR && !answers.empty()) {
+            return std::ranges::min(answers | std::views::transform([](const auto &rr) { return rr.ttl; }));
         }
-
-        if (!result.empty()) {
-            result += '.';
+        if (rcode != DNS::Rcode::NOERROR && rcode != DNS::Rcode::NXDOMAIN) {
+            return 0;
         }
 
-        current++;
-        if (current + label_len > wire_len) {
-            throw DnsLookupException(
-                fmt::format("DNS name decompression: label of length {} extends past wire end", label_len),
-                DnsError::PARSE
-            );
+        // A negative answer lasts min(SOA TTL, SOA MINIMUM) (RFC 2308 §5).
+        const auto soa = std::ranges::find_if(authorities, [](const auto &rr) {
+            return rr.type == magic_enum::enum_integer(DNS::RecordType::SOA);
+        });
+        if (soa == std::ranges::end(authorities)) {
+            return 0;
         }
 
-        result.append(reinterpret_cast<const char *>(wire.data() + current), label_len);
-        current += label_len;
+        // A malformed SOA only makes the answer uncacheable; the rcode still stands.
+        const auto minimum = soa_minimum(wire, soa->rdata_offset);
+        return minimum ? std::min(soa->ttl, *minimum) : 0;
     }
+} // anonymous namespace
 
-    return result;
+// =============================================================================
+// Name decompression (RFC 1035 §4.1.4)
+// =============================================================================
+
+std::string DNS::RecordParser::decompress_name(const std::span<const std::uint8_t> wire, size_t &offset) {
+    auto name = NameView(wire, offset).to_string();
+    offset = NameView::skip(wire, offset);
+    return name;
 }
 
 // =============================================================================
@@ -311,17 +264,18 @@ std::optional<DNS::EdnsInfo> DNS::RecordParser::parse_edns(const ResourceRecord
 // RDATA dispatch
 // =============================================================================
 
-std::string DNS::RecordParser::rdata_to_string(const ResourceRecord &rr, const std::span<const std::uint8_t> wire) {
+std::string DNS::RecordParser::rdata_to_string(const std::uint16_t type, const size_t rdata_offset,
+                                               const std::span<const std::uint8_t> wire) {
     // Read RDATA length from the wire buffer (the 2-byte rdlength field
     // always precedes RDATA at rdata_offset - 2 in a valid DNS packet).
-    // This works regardless of whether rr.rdata was populated, and avoids
-    // depending on the copied vector size.
+    // This works for ResourceRecord and RecordView alike, whether or not
+    // the RDATA was copied.
     const auto rdlen = static_cast<size_t>(
-        (static_cast<size_t>(wire[rr.rdata_offset - 2]) << 8) |
-        wire[rr.rdata_offset - 1]);
-    const auto rdata = wire.subspan(rr.rdata_offset, rdlen);
+        (static_cast<size_t>(wire[rdata_offset - 2]) << 8) |
+        wire[rdata_offset - 1]);
+    const auto rdata = wire.subspan(rdata_offset, rdlen);
 
-    switch (rr.type) {
+    switch (type) {
         case static_cast<std::uint16_t>(RecordType::A):
             if (rdlen != 4) [[unlikely]] {
                 throw DnsLookupException(
@@ -346,23 +300,23 @@ std::string DNS::RecordParser::rdata_to_string(const ResourceRecord &rr, const s
         case static_cast<std::uint16_t>(RecordType::CNAME):
         case static_cast<std::uint16_t>(RecordType::NS):
         case static_cast<std::uint16_t>(RecordType::PTR):
-            return format_domain_name(wire, rr.rdata_offset);
+            return format_domain_name(wire, rdata_offset);
 
         case static_cast<std::uint16_t>(RecordType::MX):
-            return format_mx(wire, rr.rdata_offset);
+            return format_mx(wire, rdata_offset);
 
         case static_cast<std::uint16_t>(RecordType::SOA):
-            return format_soa(wire, rr.rdata_offset);
+            return format_soa(wire, rdata_offset);
 
         case static_cast<std::uint16_t>(RecordType::SRV):
-            return format_srv(wire, rr.rdata_offset);
+            return format_srv(wire, rdata_offset);
 
         default: {
-            const auto type_name = magic_enum::enum_name(static_cast<RecordType>(rr.type));
+            const auto type_name = magic_enum::enum_name(static_cast<RecordType>(type));
             const auto type_str = type_name.empty() ? "?" : type_name.data();
             throw DnsLookupException(
                 fmt::format("DNS parsing: record type {} ({}) is not supported yet", type_str,
-                            static_cast<std::uint16_t>(rr.type)),
+                            type),
                 DnsError::PARSE
             );
         }
@@ -513,7 +467,7 @@ std::string DNS::RecordParser::parse_record(size_t index) const {
                  type_name.empty() ? "?" : type_name.data(),
                  magic_enum::enum_integer(rr.type), rr.name);
 
-    return rdata_to_string(rr, wire_);
+    return rdata_to_string(rr.type, rr.rdata_offset, wire_);
 }
 
 DNS::ParsedResponse DNS::RecordParser::parse_response(const std::span<const std::uint8_t> data,
@@ -521,6 +475,7 @@ DNS::ParsedResponse DNS::RecordParser::parse_response(const std::span<const std:
     RecordParser parser(data);
     ParsedResponse response;
     response.rcode = parser.message().rcode;
+    response.ttl = cache_ttl(response.rcode, parser.message().answers, parser.message().authorities, data);
 
     if (response.rcode == Rcode::NOERROR) {
         response.answers = parser.message().answers;
@@ -531,19 +486,45 @@ DNS::ParsedResponse DNS::RecordParser::parse_response(const std::span<const std:
 
 DNS::FormattedResponse DNS::RecordParser::parse_strings(const std::span<const std::uint8_t> data,
                                                         [[maybe_unused]] const std::string &host) {
-    // Fast path: parse without copying RDATA — rdata_to_string reads
-    // directly from the wire buffer via rdata_offset.
-    auto msg = parse_message(data, false);
+    // rdata_to_string reads RDATA straight from the wire buffer, so neither
+    // path below copies it.
     FormattedResponse response;
-    response.rcode = msg.rcode;
-
-    if (response.rcode == Rcode::NOERROR) [[likely]] {
-        response.records.reserve(msg.answers.size());
-        for (size_t i = 0; i < msg.answers.size(); ++i) {
-            auto record = rdata_to_string(msg.answers[i], data);
+    auto format_answers = [&](const auto &answers) {
+        response.records.reserve(answers.size());
+        for (size_t i = 0; i < answers.size(); ++i) {
+            const auto &rr = answers[i];
+            auto record = rdata_to_string(rr.type, rr.rdata_offset, data);
             SPDLOG_TRACE(R"(DNS answer #{} for "{}": {})", i, host, record);
             response.records.push_back(std::move(record));
+
+            // rdata_to_string has checked the RDATA length of an address.
+            if (rr.type == magic_enum::enum_integer(RecordType::A) ||
+                rr.type == magic_enum::enum_integer(RecordType::AAAA)) {
+                const auto rdlen = Utils::Bytes::read_u16_be(data, rr.rdata_offset - 2);
+                if (const auto address = InetAddress::from_bytes(data.subspan(rr.rdata_offset, rdlen))) {
+                    response.addresses.push_back(*address);
+                }
+            }
+        }
+    };
+
+    if (!MessageView::fits(data)) [[unlikely]] {
+        // More records than a MessageView holds inline.
+        const auto msg = parse_message(data, false);
+        response.rcode = msg.rcode;
+        response.ttl = cache_ttl(msg.rcode, msg.answers, msg.authorities, data);
+        if (response.rcode == Rcode::NOERROR) {
+            format_answers(msg.answers);
         }
+        return response;
+    }
+
+    // Fast path: the view parses without allocating or decompressing names.
+    const MessageView view(data);
+    response.rcode = view.rcode();
+    response.ttl = cache_ttl(view.rcode(), view.answers(), view.authorities(), data);
+    if (response.rcode == Rcode::NOERROR) [[likely]] {
+        format_answers(view.answers());
     }
 
     return response;
@@ -57,7 +57,8 @@ namespace DNS {
         /// string values (IPs, hostnames, text, etc.).
         ///
         /// Preferred entry point for callers that only need the RCODE and
-        /// formatted values.
+        /// formatted values.  Parses through MessageView, so the only
+        /// allocations are the formatted values themselves.
         ///
         /// @param data  Span covering the raw packet bytes.
         /// @param host  Optional hostname for sanity checking (CNAME chain detection).
@@ -90,7 +91,8 @@ namespace DNS {
         [[nodiscard]] static std::string decompress_name(std::span<const std::uint8_t> wire, size_t &offset);
 
         // ── RDATA formatting ──
-        [[nodiscard]] static std::string rdata_to_string(const ResourceRecord &rr, std::span<const std::uint8_t> wire);
+        [[nodiscard]] static std::string rdata_to_string(std::uint16_t type, size_t rdata_offset,
+                                                         std::span<const std::uint8_t> wire);
 
         [[nodiscard]] static std::string format_a(std::span<const std::uint8_t> rdata) noexcept;
 
@@ -213,6 +213,18 @@ DNS::FormattedResponse DNS::RecordParser::parse_strings(const std::span<const st
             auto record = parser.parse_record(i);
             SPDLOG_TRACE(R"(DNS answer #{} for "{}": {})", i, host, record);
             response.records.push_back(std::move(record));
+
+            // parse_record has parsed this record once already, so it cannot fail.
+            ns_rr dns_resource{};
+            static_cast<void>(ns_parserr(&parser.message_, ns_s_an, static_cast<int>(i), &dns_resource));
+            if (ns_rr_type(dns_resource) == ns_t_a || ns_rr_type(dns_resource) == ns_t_aaaa) {
+                const std::span<const std::uint8_t> rdata{
+                    ns_rr_rdata(dns_resource), static_cast<size_t>(ns_rr_rdlen(dns_resource))
+                };
+                if (const auto address = InetAddress::from_bytes(rdata)) {
+                    response.addresses.push_back(*address);
+                }
+            }
         }
     }
 
@@ -7,6 +7,8 @@
 
 #include <atomic>
 #include <expected>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -22,6 +24,19 @@ namespace Utils {
 class CancellationToken;
 }
 
+class Reactor;
+
+/// A query started by ResolverBase::start_query().
+///
+/// Destroying it abandons the query: its callback will not be called
+/// afterwards, and every fd and timer it registered is released.  It must
+/// be destroyed on the reactor thread, and may be destroyed from within its
+/// own callback.
+class PendingQuery {
+public:
+    virtual ~PendingQuery() = default;
+};
+
 /// ResolverBase — common interface for all DNS resolvers.
 ///
 /// Provides the shared contract (query + non-copyable semantics) so that
@@ -53,6 +68,31 @@ public:
     query(const std::string &host, RecordKind type,
           const Utils::CancellationToken &cancel_token) const = 0;
 
+    using QueryResult = std::expected<std::vector<std::uint8_t>, DnsErrorInfo>;
+
+    using QueryCallback = std::function<void(QueryResult)>;
+
+    /// Start a query without blocking, driven by @p reactor.
+    ///
+    /// Resolvers that can run a query as a non-blocking state machine
+    /// override this so that many queries share one thread; the default
+    /// returns nullptr, and the caller falls back to query() on a thread of
+    /// its own.
+    ///
+    /// @param reactor  Drives the query; this is called on its thread.
+    /// @param on_done  Called exactly once on the reactor thread, never from
+    ///                 within start_query() itself, with the same result
+    ///                 query() would have returned — unless the returned
+    ///                 PendingQuery is destroyed first.
+    /// @return The in-flight query, or nullptr if this resolver only
+    ///         supports blocking queries.
+    [[nodiscard]] virtual std::unique_ptr<PendingQuery> start_query([[maybe_unused]] Reactor &reactor,
+                                                                    [[maybe_unused]] const std::string &host,
+                                                                    [[maybe_unused]] RecordKind type,
+                                                                    [[maybe_unused]] QueryCallback on_done) const {
+        return nullptr;
+    }
+
     /// Return a human-readable resolver type name (e.g. "Classic", "DNS-Over-HTTPS").
     [[nodiscard]] virtual std::string_view get_type() const noexcept = 0;
 
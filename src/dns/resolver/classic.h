@@ -37,6 +37,12 @@ public:
     query(const std::string &host, RecordKind type,
           const Utils::CancellationToken &cancel_token) const override;
 
+    /// Non-blocking UDP (and TCP on truncation) exchange driven by
+    /// @p reactor.  The libresolv backend returns nullptr: it can only
+    /// run blocking queries.
+    [[nodiscard]] std::unique_ptr<PendingQuery> start_query(Reactor &reactor, const std::string &host,
+                                                            RecordKind type, QueryCallback on_done) const override;
+
     [[nodiscard]] std::string_view get_type() const noexcept override { return TYPE; }
 
 private:
@@ -4,42 +4,66 @@
 // Self-contained UDP/TCP resolver (no libresolv).
 // This is now the default resolver backend.
 //
-#include <cerrno>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <cstdint>
-#include <cstring>
 #include <memory>
+#include <optional>
+#include <random>
+#include <span>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <expected>
 
 #include "dns/resolver_registry.h"
+#include "dns/resolver/rtt_estimator.h"
+#include "dns/resolver/tcp_pipeline.h"
+#include "dns/resolver/udp_pool.h"
 #include "dns/util.hpp"
 #include "dns/validator.h"
-#include "dns/wire/query_util.h"
+#include "dns/wire/query_template.h"
 #include "dns/dns_error_info.h"
 #include "exception/dns_lookup.h"
 #include "exception/dns_packet.h"
 #include "exception/socket.h"
 #include "network/inet_address.h"
-#include "network/socket.h"
+#include "network/reactor.h"
+#include "network/socket_addr.h"
+#include "util/bytes.hpp"
+#include "util/random.hpp"
 
 #include "classic.h"
 #include "dns_error.h"
 #include "uri.h"
 
 #include "fmt.hpp"
-#include <arpa/inet.h>
 #include <netinet/in.h>
-#include <netinet/tcp.h>
-#include <poll.h>
 #include <spdlog/spdlog.h>
 
 namespace {
     // ── Constants ──
-    constexpr int UDP_TIMEOUT_SEC = 1;
-    constexpr int TCP_CONNECT_TIMEOUT_SEC = 1;
-    constexpr int MAX_DNS_PACKET_SIZE = 4096;
+    /// Overall limit for a UDP query.  Within it, a query left unanswered
+    /// for the resolver's RTO is sent again, with the wait doubled each time.
+    constexpr std::chrono::seconds UDP_DEADLINE{3};
+    /// Covers connecting, when the pipeline has to open its connection.
+    constexpr int TCP_TIMEOUT_SEC = 2;
+    /// A query whose connection is lost is sent once more, on a new one:
+    /// the server may have closed an idle connection just as it was reused.
+    constexpr int TCP_ATTEMPTS = 2;
+
+    /// Give @p packet a new random transaction ID, different from its own.
+    void renew_id(std::span<std::uint8_t> packet) {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 0xFFFF);
+        const auto old_id = Utils::Bytes::read_u16_be(packet);
+        auto id = old_id;
+        while (id == old_id) {
+            id = static_cast<std::uint16_t>(dist(Utils::Random::engine()));
+        }
+        Utils::Bytes::write_u16_be(packet.data(), id);
+    }
 
     // ── Build SocketAddr from DNS::Server ──
     struct AddrResult {
@@ -69,181 +93,268 @@ namespace {
         return result;
     }
 
-    // ── Helpers to translate Socket error conditions ──
-
-    /// Translate wait_for / connect timeout into DnsError.
-    [[nodiscard]] DnsError classify_socket_error(int errnum) {
-        if (errnum == ETIMEDOUT || errnum == EAGAIN)
-            return DnsError::RETRY;
-        if (errnum == ECANCELED)
-            return DnsError::CANCELLED;
-        return DnsError::CONNECTION;
-    }
-
-    [[nodiscard]] std::string socket_error_msg(std::uint64_t resolver_id, const char *context, int errnum) {
-        return fmt::format(R"(Resolver #{} {}: {})", resolver_id, context, std::strerror(errnum));
+    // ── Check TC (Truncation) bit in DNS header ──
+    [[nodiscard]] bool is_truncated(const std::vector<std::uint8_t> &response) {
+        // TC is bit 2 of the second byte in the flags field (byte 2 of the header, 0-indexed).
+        return response.size() >= DNS::HEADER_SIZE && (response[2] & 0x02) != 0;
     }
 
-    // ── UDP query ──
-    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo> query_udp(
-        const AddrResult &addr, std::span<const uint8_t> query_packet,
-        const Utils::CancellationToken &cancel_token, std::uint64_t resolver_id) {
-        // Socket constructor may throw SocketException on OS resource
-        // exhaustion — let it propagate.
-        Socket sock(addr.family, SOCK_DGRAM);
-
-        auto data = std::as_bytes(std::span{query_packet});
-        if (auto sent = sock.send_to(data, addr.addr); sent != static_cast<ssize_t>(data.size())) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::CONNECTION,
-                fmt::format(R"(Resolver #{} UDP sendto failed: {})", resolver_id, std::strerror(errno))
-            });
+    // ── Asynchronous query (ResolverBase::start_query) ──
+
+    /// A pooled UDP exchange, then a pipelined TCP one on truncation (or TCP
+    /// only), as a state machine driven by a Reactor: each step registers a
+    /// query or a timer and returns, so any number of exchanges share the
+    /// reactor thread.
+    ///
+    /// A UDP query unanswered for the RTO is sent again, with the wait
+    /// doubled each time, until UDP_DEADLINE.  Earlier transmissions stay
+    /// registered: whichever reply comes first is taken.
+    ///
+    /// The exchange is kept alive by the callbacks it registers.  Every step
+    /// is a no-op once the exchange has finished or been abandoned.
+    class AsyncExchange : public std::enable_shared_from_this<AsyncExchange> {
+    public:
+        AsyncExchange(Reactor &reactor, UdpSocketPool &udp_pool, TcpPipeline &tcp_pipeline, RttEstimator &rtt,
+                      bool tcp_only, std::vector<std::uint8_t> query_packet, std::uint64_t resolver_id,
+                      ResolverBase::QueryCallback on_done)
+            : reactor_(reactor), udp_pool_(udp_pool), tcp_pipeline_(tcp_pipeline), rtt_(rtt), tcp_only_(tcp_only),
+              query_packet_(std::move(query_packet)), resolver_id_(resolver_id), on_done_(std::move(on_done)) {
         }
 
-        auto wait_res = sock.wait_for(POLLIN, UDP_TIMEOUT_SEC * 1000, cancel_token);
-        if (!wait_res) {
-            const auto ec = classify_socket_error(wait_res.error());
-            return std::unexpected(DnsErrorInfo{ec, socket_error_msg(resolver_id, "UDP wait_for", wait_res.error())});
+        /// Send the query.  Failures are reported through the reactor, never
+        /// from here.
+        void start() {
+            try {
+                if (tcp_only_) {
+                    send_tcp();
+                } else {
+                    udp_deadline_ = std::chrono::steady_clock::now() + UDP_DEADLINE;
+                    udp_interval_ = rtt_.rto();
+                    send_udp();
+                }
+            } catch (const SocketException &e) {
+                fail_later(DnsError::CONNECTION,
+                           fmt::format(R"(Resolver #{} query failed: {})", resolver_id_, e.what()));
+            } catch (const std::exception &e) {
+                fail_later(DnsError::UNKNOWN, fmt::format(R"(Resolver #{} query failed: {})", resolver_id_, e.what()));
+            }
         }
-        if (*wait_res == 0) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::RETRY,
-                fmt::format(R"(Resolver #{} UDP query timed out)", resolver_id)
-            });
+
+        /// Finish with @p error, unless abandoned first.
+        void report(DnsErrorInfo error) { finish(std::unexpected(std::move(error))); }
+
+        /// Stop without calling back.
+        void abandon() noexcept {
+            if (!finished_) {
+                finished_ = true;
+                on_done_ = nullptr;
+                release();
+            }
         }
 
-        std::vector<std::uint8_t> response(MAX_DNS_PACKET_SIZE);
-        auto buf = std::as_writable_bytes(std::span{response});
-        auto received = sock.recv_from(buf);
-        if (received < 0) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::CONNECTION,
-                fmt::format(R"(Resolver #{} UDP recvfrom failed: {})", resolver_id, std::strerror(errno))
+    private:
+        /// One transmission of the UDP query.
+        struct UdpAttempt {
+            UdpSocketPool::Ticket ticket;
+            /// The query as sent: the pool may have given it a new ID.
+            std::vector<std::uint8_t> packet;
+            std::chrono::steady_clock::time_point sent;
+        };
+
+        /// Send the UDP query (again), and time the wait for its reply.
+        void send_udp() {
+            const auto index = udp_attempts_.size();
+            auto &attempt = udp_attempts_.emplace_back(UdpAttempt{
+                .ticket = {}, .packet = query_packet_, .sent = std::chrono::steady_clock::now()
             });
+            auto ticket = udp_pool_.send_async(reactor_, attempt.packet,
+                                               [self = shared_from_this(), index](UdpSocketPool::Reply reply) {
+                                                   self->guarded([&] { self->on_udp_reply(index, std::move(reply)); });
+                                               });
+            if (!ticket) {
+                fail_later(ticket.error().code, std::move(ticket.error().message));
+                return;
+            }
+            attempt.ticket = std::move(*ticket);
+
+            const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+                udp_deadline_ - std::chrono::steady_clock::now());
+            arm_timer(std::clamp(remaining, std::chrono::milliseconds(1), udp_interval_),
+                      &AsyncExchange::on_udp_timeout);
         }
-        response.resize(static_cast<size_t>(received));
-        return response;
-    }
 
-    // ── TCP query (fallback for truncated responses) ──
-    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo> query_tcp(
-        const AddrResult &addr, std::span<const uint8_t> query_packet,
-        const Utils::CancellationToken &cancel_token, std::uint64_t resolver_id) {
-        // Socket constructor may throw SocketException on OS resource
-        // exhaustion — let it propagate.
-        Socket sock(addr.family, SOCK_STREAM);
-
-        // connect returns expected<void, ConnectError> — handle inline.
-        auto conn = sock.connect(addr.addr, TCP_CONNECT_TIMEOUT_SEC);
-        if (!conn) {
-            DnsError ec;
-            switch (conn.error()) {
-                case ConnectError::TIMED_OUT:
-                    ec = DnsError::RETRY;
-                    break;
-                case ConnectError::CANCELLED:
-                    ec = DnsError::CANCELLED;
-                    break;
-                default:
-                    ec = DnsError::CONNECTION;
-                    break;
+        void send_tcp() {
+            ++tcp_attempts_;
+            auto ticket = tcp_pipeline_.send_async(reactor_, query_packet_,
+                                                   [self = shared_from_this()](TcpPipeline::Reply reply) {
+                                                       self->guarded([&] { self->on_tcp_reply(std::move(reply)); });
+                                                   });
+            if (!ticket) {
+                fail_later(ticket.error().code, std::move(ticket.error().message));
+                return;
             }
-            return std::unexpected(DnsErrorInfo{ec, fmt::format(R"(Resolver #{} TCP connect failed)", resolver_id)});
+            tcp_ = std::move(*ticket);
+            arm_timer(std::chrono::seconds(TCP_TIMEOUT_SEC), &AsyncExchange::on_tcp_timeout);
         }
 
-        // Enable TCP_NODELAY to disable Nagle's algorithm — DNS queries are
-        // typically small and latency-sensitive; batching via Nagle adds
-        // unnecessary delay.
-        sock.set_option(IPPROTO_TCP, TCP_NODELAY, 1).value();
-
-        // Send: 2-byte big-endian length prefix + query packet (RFC 1035 §4.2.2).
-        const std::uint16_t be_len = htons(static_cast<std::uint16_t>(query_packet.size()));
-        std::vector<std::uint8_t> tcp_query(sizeof(be_len));
-        std::ranges::copy_n(reinterpret_cast<const std::uint8_t *>(&be_len), sizeof(be_len), tcp_query.begin());
-        tcp_query.insert(tcp_query.end(), query_packet.begin(), query_packet.end());
-
-        auto data = std::as_bytes(std::span{tcp_query});
-        if (sock.send(data) < 0) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::CONNECTION,
-                fmt::format(R"(Resolver #{} TCP send failed: {})", resolver_id, std::strerror(errno))
-            });
+        /// Run a step, turning an escaping exception into a failure, as the
+        /// blocking query() does.
+        template<typename Fn>
+        void guarded(Fn &&fn) {
+            if (finished_) {
+                return;
+            }
+            try {
+                fn();
+            } catch (const SocketException &e) {
+                fail(DnsError::CONNECTION, fmt::format(R"(Resolver #{} query failed: {})", resolver_id_, e.what()));
+            } catch (const std::exception &e) {
+                fail(DnsError::UNKNOWN, fmt::format(R"(Resolver #{} query failed: {})", resolver_id_, e.what()));
+            }
         }
 
-        // Receive helper: wait with poll, then recv.
-        auto recv_with_timeout = [&sock, &cancel_token, resolver_id](std::span<std::byte> buf)
-            -> std::expected<size_t, DnsErrorInfo> {
-            auto wait_res = sock.wait_for(POLLIN, TCP_CONNECT_TIMEOUT_SEC * 1000, cancel_token);
-            if (!wait_res) {
-                const auto ec = classify_socket_error(wait_res.error());
-                return std::unexpected(DnsErrorInfo{ec, socket_error_msg(resolver_id, "TCP wait_for", wait_res.error())});
+        void on_udp_reply(std::size_t index, UdpSocketPool::Reply reply) {
+            if (!reply) {
+                finish(std::unexpected(std::move(reply.error())));
+                return;
             }
-            if (*wait_res == 0) {
-                return std::unexpected(DnsErrorInfo{
-                    DnsError::RETRY,
-                    fmt::format(R"(Resolver #{} TCP recv timed out)", resolver_id)
-                });
+            auto response = std::move(*reply);
+            const auto &attempt = udp_attempts_[index];
+            rtt_.sample(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - attempt.sent));
+
+            if (auto valid = DNS::Validator::validate_response(attempt.packet, response); !valid) {
+                finish(std::unexpected(std::move(valid.error())));
+                return;
             }
 
-            auto n = sock.recv(buf);
-            if (n == 0) {
-                return std::unexpected(DnsErrorInfo{
-                    DnsError::CONNECTION,
-                    fmt::format(R"(Resolver #{} TCP connection reset by peer)", resolver_id)
-                });
+            if (is_truncated(response)) {
+                SPDLOG_TRACE(R"(Resolver #{} UDP response truncated, falling back to TCP)", resolver_id_);
+                udp_attempts_.clear();
+                send_tcp();
+                return;
             }
-            if (n < 0) {
-                return std::unexpected(DnsErrorInfo{
-                    DnsError::CONNECTION,
-                    fmt::format(R"(Resolver #{} TCP recv failed: {})", resolver_id, std::strerror(errno))
-                });
+            finish(std::move(response));
+        }
+
+        void on_udp_timeout() {
+            if (std::chrono::steady_clock::now() >= udp_deadline_) {
+                for (auto &attempt: udp_attempts_) {
+                    attempt.ticket.expire();
+                }
+                fail(DnsError::RETRY, fmt::format(R"(Resolver #{} UDP query timed out after {} attempt(s))",
+                                                  resolver_id_, udp_attempts_.size()));
+                return;
             }
-            return static_cast<size_t>(n);
-        };
 
-        // Receive: 2-byte big-endian length prefix.
-        std::uint16_t be_rsp_len = 0;
-        auto len_buf = std::as_writable_bytes(std::span{&be_rsp_len, 1});
-        {
-            size_t total = 0;
-            while (total < len_buf.size()) {
-                auto n = recv_with_timeout(len_buf.subspan(total));
-                if (!n) {
-                    return std::unexpected(std::move(n.error()));
+            rtt_.backoff(udp_interval_);
+            udp_interval_ = std::min(udp_interval_ * 2, RttEstimator::MAX_RTO);
+            SPDLOG_TRACE(R"(Resolver #{} UDP query unanswered, retransmitting (attempt {}))", resolver_id_,
+                         udp_attempts_.size() + 1);
+            send_udp();
+        }
+
+        void on_tcp_timeout() {
+            // An unanswered TCP query retires its connection.
+            tcp_.expire();
+            fail(DnsError::RETRY, fmt::format(R"(Resolver #{} TCP query timed out)", resolver_id_));
+        }
+
+        void on_tcp_reply(TcpPipeline::Reply reply) {
+            tcp_.reset();
+            if (!reply) {
+                if (reply.error().code == DnsError::CONNECTION && tcp_attempts_ < TCP_ATTEMPTS) {
+                    SPDLOG_TRACE(R"(Resolver #{} TCP connection lost, retrying)", resolver_id_);
+                    send_tcp();
+                    return;
                 }
-                total += *n;
+                finish(std::unexpected(std::move(reply.error())));
+                return;
             }
+            auto response = std::move(*reply);
+
+            if (auto valid = DNS::Validator::validate_response(query_packet_, response); !valid) {
+                finish(std::unexpected(std::move(valid.error())));
+                return;
+            }
+            finish(std::move(response));
         }
 
-        const size_t rsp_len = ntohs(be_rsp_len);
-        if (rsp_len == 0 || rsp_len > MAX_DNS_PACKET_SIZE) {
-            return std::unexpected(DnsErrorInfo{
-                DnsError::PARSE,
-                fmt::format("Invalid DNS response length: {}", rsp_len)
+        /// Replace the pending timeout with one running @p on_timeout
+        /// @p timeout from now.
+        void arm_timer(std::chrono::milliseconds timeout, void (AsyncExchange::*on_timeout)()) {
+            if (timer_) {
+                reactor_.cancel_timer(*timer_);
+            }
+            timer_ = reactor_.add_timer(timeout, [self = shared_from_this(), on_timeout] {
+                self->timer_.reset();
+                self->guarded([&] { (self.get()->*on_timeout)(); });
             });
         }
 
-        // Receive response body.
-        std::vector<std::uint8_t> response(rsp_len);
-        auto rsp_buf = std::as_writable_bytes(std::span{response});
-        {
-            size_t total = 0;
-            while (total < rsp_buf.size()) {
-                auto n = recv_with_timeout(rsp_buf.subspan(total));
-                if (!n) {
-                    return std::unexpected(std::move(n.error()));
-                }
-                total += *n;
+        void fail(DnsError code, std::string message) {
+            finish(std::unexpected(DnsErrorInfo{code, std::move(message)}));
+        }
+
+        void fail_later(DnsError code, std::string message) {
+            reactor_.post([self = shared_from_this(), error = DnsErrorInfo{code, std::move(message)}] {
+                self->finish(std::unexpected(error));
+            });
+        }
+
+        void finish(ResolverBase::QueryResult result) {
+            if (finished_) {
+                return;
             }
+            finished_ = true;
+            release();
+            std::exchange(on_done_, nullptr)(std::move(result));
         }
-        return response;
-    }
 
-    // ── Check TC (Truncation) bit in DNS header ──
-    [[nodiscard]] bool is_truncated(const std::vector<std::uint8_t> &response) {
-        // TC is bit 2 of the second byte in the flags field (byte 2 of the header, 0-indexed).
-        return response.size() >= DNS::HEADER_SIZE && (response[2] & 0x02) != 0;
-    }
+        /// Withdraw the pending queries and drop the timer.
+        void release() noexcept {
+            udp_attempts_.clear();
+            tcp_.reset();
+            if (timer_) {
+                reactor_.cancel_timer(*timer_);
+                timer_.reset();
+            }
+        }
+
+        Reactor &reactor_;
+        UdpSocketPool &udp_pool_;
+        TcpPipeline &tcp_pipeline_;
+        RttEstimator &rtt_;
+        bool tcp_only_;
+        std::vector<std::uint8_t> query_packet_;
+        std::uint64_t resolver_id_;
+        ResolverBase::QueryCallback on_done_;
+
+        std::vector<UdpAttempt> udp_attempts_;
+        std::chrono::steady_clock::time_point udp_deadline_;
+        /// Wait before the next retransmission.
+        std::chrono::milliseconds udp_interval_{0};
+        TcpPipeline::Ticket tcp_;
+        int tcp_attempts_{0};
+        std::optional<Reactor::TimerId> timer_;
+        bool finished_{false};
+    };
+
+    /// Abandons its exchange when the engine drops the query.
+    class AsyncPendingQuery final : public PendingQuery {
+    public:
+        explicit AsyncPendingQuery(std::shared_ptr<AsyncExchange> exchange) : exchange_(std::move(exchange)) {
+        }
+
+        ~AsyncPendingQuery() override { exchange_->abandon(); }
+
+        AsyncPendingQuery(const AsyncPendingQuery &) = delete;
+
+        AsyncPendingQuery &operator=(const AsyncPendingQuery &) = delete;
+
+    private:
+        std::shared_ptr<AsyncExchange> exchange_;
+    };
 } // anonymous namespace
 
 // ===========================================================================
@@ -259,14 +370,80 @@ struct ClassicResolver::Impl {
     query(const std::string &host_str, RecordKind type,
           const Utils::CancellationToken &cancel_token) const;
 
+    [[nodiscard]] std::unique_ptr<PendingQuery> start_query(Reactor &reactor, const std::string &host_str,
+                                                            RecordKind type,
+                                                            ResolverBase::QueryCallback on_done) const;
+
+    /// Exchange @p query_packet over the UDP pool, retransmitting it after
+    /// the RTO (doubled on each attempt) until UDP_DEADLINE.  Each
+    /// retransmission gets a new transaction ID, written to @p query_packet.
+    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
+    query_udp(std::span<std::uint8_t> query_packet, const Utils::CancellationToken &cancel_token) const;
+
+    /// Exchange @p query_packet over the TCP pipeline, once more on a new
+    /// connection if the one used is lost.
+    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
+    query_tcp(std::span<std::uint8_t> query_packet, const Utils::CancellationToken &cancel_token) const;
+
+    [[nodiscard]] bool tcp_only() const noexcept { return server_.transport == Config::DnsTransport::TCP; }
+
     std::uint64_t id_;
     Config::DnsServer server_;
     Uri uri_;
     AddrResult addr_;
+    /// Shared by query() and start_query(), from any thread.
+    mutable UdpSocketPool udp_pool_;
+    mutable TcpPipeline tcp_pipeline_;
+    /// Round-trip time to the server, sampled by every UDP query.
+    mutable RttEstimator rtt_;
+    /// The encoded query of each name and type looked up.
+    mutable DNS::QueryTemplateCache templates_;
 };
 
 ClassicResolver::Impl::Impl(Config::DnsServer server, std::uint64_t id)
-    : id_(id), server_(std::move(server)), uri_(Uri::parse(server_.address)), addr_(make_addr(server_)) {
+    : id_(id), server_(std::move(server)), uri_(Uri::parse(server_.address)), addr_(make_addr(server_)),
+      udp_pool_(addr_.addr, addr_.family, id_), tcp_pipeline_(addr_.addr, addr_.family, id_) {
+}
+
+std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
+ClassicResolver::Impl::query_udp(std::span<std::uint8_t> query_packet,
+                                 const Utils::CancellationToken &cancel_token) const {
+    // Each attempt is a new exchange, so the reply to a withdrawn one is
+    // dropped; the reactor-driven AsyncExchange keeps them all instead.
+    // Withdrawing frees the ID, so a retransmission takes a new one: a late
+    // reply to an earlier attempt must not be timed against the last send.
+    const auto deadline = std::chrono::steady_clock::now() + UDP_DEADLINE;
+    auto interval = rtt_.rto();
+    for (int attempt = 1;; ++attempt) {
+        const auto sent = std::chrono::steady_clock::now();
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - sent);
+        auto response = udp_pool_.exchange(query_packet, std::clamp(remaining, std::chrono::milliseconds(1), interval),
+                                           cancel_token);
+        if (response) {
+            rtt_.sample(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sent));
+            return response;
+        }
+        if (response.error().code != DnsError::RETRY || std::chrono::steady_clock::now() >= deadline) {
+            return response;
+        }
+
+        rtt_.backoff(interval);
+        interval = std::min(interval * 2, RttEstimator::MAX_RTO);
+        renew_id(query_packet);
+        SPDLOG_TRACE(R"(Resolver #{} UDP query unanswered, retransmitting (attempt {}))", id_, attempt + 1);
+    }
+}
+
+std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
+ClassicResolver::Impl::query_tcp(std::span<std::uint8_t> query_packet,
+                                 const Utils::CancellationToken &cancel_token) const {
+    for (int attempt = 1;; ++attempt) {
+        auto response = tcp_pipeline_.exchange(query_packet, std::chrono::seconds(TCP_TIMEOUT_SEC), cancel_token);
+        if (response || response.error().code != DnsError::CONNECTION || attempt == TCP_ATTEMPTS) {
+            return response;
+        }
+        SPDLOG_TRACE(R"(Resolver #{} TCP connection lost, retrying)", id_);
+    }
 }
 
 std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
@@ -276,17 +453,33 @@ ClassicResolver::Impl::query(const std::string &host_str, RecordKind type,
         SPDLOG_TRACE(R"(Resolver #{} DNS lookup for "{}")", id_, host_str);
 
         const auto record_type = DNS::Util::type_to_record_type(type);
-        SPDLOG_DEBUG(R"(Resolver #{} Resolving "{}" (type {}) via {}:{})",
-                     id_, host_str, static_cast<std::uint16_t>(record_type), uri_.get_host_literal(), server_.port
+        SPDLOG_DEBUG(R"(Resolver #{} Resolving "{}" (type {}) via {}:{}{})",
+                     id_, host_str, static_cast<std::uint16_t>(record_type), uri_.get_host_literal(), server_.port,
+                     tcp_only() ? " (TCP)" : ""
         );
 
-        // Build query packet using the native wire-format builder.
-        auto query_packet = DNS::build_query(host_str, record_type);
+        // Stamp the query out of its template, encoded on first use, into
+        // a buffer that takes any name: nothing is allocated to send it.
+        std::array<std::uint8_t, DNS::QueryTemplate::max_size({})> buffer;
+        const auto query_packet = templates_.get(host_str, record_type)->write_to(buffer);
+
+        // TCP only, or UDP first on a pooled socket.  Either transport may
+        // give the query a new transaction ID, so validate against
+        // query_packet afterwards.  Exchanges return std::expected for I/O
+        // errors; opening a socket may throw SocketException (OS resource
+        // exhaustion, or a TCP connect refused outright).
+        if (tcp_only()) {
+            auto response = query_tcp(query_packet, cancel_token);
+            if (!response) {
+                return std::unexpected(std::move(response.error()));
+            }
+            if (auto valid = DNS::Validator::validate_response(query_packet, *response); !valid) {
+                return std::unexpected(std::move(valid.error()));
+            }
+            return response;
+        }
 
-        // Try UDP first.
-        // query_udp returns std::expected for I/O errors.  Socket constructor
-        // failure may throw SocketException (OS resource exhaustion).
-        auto response = query_udp(addr_, query_packet, cancel_token, id_);
+        auto response = query_udp(query_packet, cancel_token);
         if (!response) {
             return std::unexpected(std::move(response.error()));
         }
@@ -304,7 +497,7 @@ ClassicResolver::Impl::query(const std::string &host_str, RecordKind type,
         // Fall back to TCP if response is truncated.
         if (is_truncated(resp_data)) {
             SPDLOG_TRACE(R"(Resolver #{} UDP response truncated for "{}", falling back to TCP)", id_, host_str);
-            auto tcp_response = query_tcp(addr_, query_packet, cancel_token, id_);
+            auto tcp_response = query_tcp(query_packet, cancel_token);
             if (!tcp_response) {
                 return std::unexpected(std::move(tcp_response.error()));
             }
@@ -340,6 +533,33 @@ ClassicResolver::Impl::query(const std::string &host_str, RecordKind type,
     }
 }
 
+std::unique_ptr<PendingQuery> ClassicResolver::Impl::start_query(Reactor &reactor, const std::string &host_str,
+                                                                RecordKind type,
+                                                                ResolverBase::QueryCallback on_done) const {
+    SPDLOG_DEBUG(R"(Resolver #{} Resolving "{}" asynchronously via {}:{})", id_, host_str, uri_.get_host_literal(),
+                 server_.port);
+
+    std::vector<std::uint8_t> query_packet;
+    std::optional<DnsErrorInfo> build_error;
+    try {
+        query_packet = templates_.get(host_str, DNS::Util::type_to_record_type(type))->build();
+    } catch (const DnsLookupException &e) {
+        build_error.emplace(e.get_error(), e.what());
+    } catch (const DnsPacketException &e) {
+        build_error.emplace(DnsError::PARSE,
+                            fmt::format(R"(Query packet construction for "{}" failed: {})", host_str, e.what()));
+    }
+
+    auto exchange = std::make_shared<AsyncExchange>(reactor, udp_pool_, tcp_pipeline_, rtt_, tcp_only(),
+                                                    std::move(query_packet), id_, std::move(on_done));
+    if (build_error) {
+        reactor.post([exchange, error = std::move(*build_error)] { exchange->report(error); });
+    } else {
+        exchange->start();
+    }
+    return std::make_unique<AsyncPendingQuery>(std::move(exchange));
+}
+
 ClassicResolver::ClassicResolver(Config::DnsServer server) : impl_(
     std::make_unique<Impl>(std::move(server), get_id())) {
 }
@@ -351,6 +571,11 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> ClassicResolver::query(
     return impl_->query(host, type, cancel_token);
 }
 
+std::unique_ptr<PendingQuery> ClassicResolver::start_query(Reactor &reactor, const std::string &host,
+                                                          RecordKind type, QueryCallback on_done) const {
+    return impl_->start_query(reactor, host, type, std::move(on_done));
+}
+
 // ===========================================================================
 //  Self-registration
 // ===========================================================================
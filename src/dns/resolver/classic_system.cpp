@@ -85,6 +85,11 @@ namespace {
         }
 
         void set_nameserver(const Config::DnsServer &server) {
+            // TCP-only: libresolv has no pipelining, so each query opens
+            // its own connection.
+            if (server.transport == Config::DnsTransport::TCP) {
+                state.options |= RES_USEVC;
+            }
             if (Inet4Address::parse(server.address)) {
                 state.nscount = 1;
                 state.nsaddr_list[0].sin_family = AF_INET;
@@ -161,7 +166,7 @@ namespace {
         }
 
         void set_nameserver([[maybe_unused]] const Config::DnsServer &server) {
-            // Custom DNS server not supported without res_ninit
+            // Custom DNS server (and its transport) not supported without res_ninit
         }
 #endif
     };
@@ -268,6 +273,12 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> ClassicResolver::query(
     return impl_->query(host, type, cancel_token);
 }
 
+// libresolv only blocks: callers fall back to query().
+std::unique_ptr<PendingQuery> ClassicResolver::start_query(Reactor &, const std::string &, RecordKind,
+                                                          QueryCallback) const {
+    return nullptr;
+}
+
 // ===========================================================================
 //  Self-registration
 // ===========================================================================
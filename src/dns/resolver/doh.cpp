@@ -3,23 +3,38 @@
 //
 #include "doh.h"
 
+#include <array>
+#include <cerrno>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstring>
 #include <mutex>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
 #include "dns/util.hpp"
 #include "dns/validator.h"
-#include "dns/wire/query_util.h"
+#include "dns/wire/query_template.h"
 #include "dns/dns_error_info.h"
 #include "exception/dns_lookup.h"
+#include "exception/socket.h"
 #include "network/tls_connection.h"
 #include "dns/resolver_registry.h"
 #include "http/http.h"
+#include "http/http2.h"
 #include "network/transport/tls_stream.h"
+#include "util/cancellation_token.hpp"
+#include "util/fd.hpp"
 
 #include "dns_error.h"
 #include "uri.h"
@@ -38,6 +53,9 @@ namespace {
     case Http::Error::CONNECTION_FAILED:
         return {DnsError::CONNECTION,
                 fmt::format(R"(Failed to read response from "{}")", label)};
+    case Http::Error::STREAM_RESET:
+        return {DnsError::RETRY,
+                fmt::format(R"(Server "{}" reset the request)", label)};
     default:
         return {DnsError::PARSE,
                 fmt::format(R"(Server "{}" returned malformed HTTP response)", label)};
@@ -67,9 +85,15 @@ struct DohResolver::Impl {
     // ── Constants ──
     static constexpr auto IDLE_TIMEOUT = 30s;
     static constexpr auto CONNECT_TIMEOUT = 1s;
-    static constexpr unsigned char ALPN_HTTP[] = {8, 'h', 't', 't', 'p', '/', '1', '.', '1'};
+    /// How long an HTTP/2 request waits for a stream and its response.
+    static constexpr auto QUERY_TIMEOUT = 1500ms;
+    /// "h2" preferred, "http/1.1" as fallback (RFC 7301 §3.1).
+    static constexpr unsigned char ALPN_DOH[] = {2, 'h', '2', 8, 'h', 't', 't', 'p', '/', '1', '.', '1'};
+
+    using Reply = std::expected<Http::Response, DnsErrorInfo>;
 
     // ── Constructor ──
+    /// @throws SocketException if the wake pipe cannot be created.
     explicit Impl(std::string server, std::uint16_t port, std::string path, std::uint64_t id, std::string label,
                   std::unique_ptr<TlsConnectionBase> conn = nullptr);
 
@@ -79,9 +103,48 @@ struct DohResolver::Impl {
           const Utils::CancellationToken &cancel_token) const;
 
     // ── Private helpers ──
-    /// Ensure a persistent TLS connection exists (create or reuse).
+    /// An HTTP/2 request in flight on the connection.
+    struct Waiter {
+        /// The response (or the error that ended the stream), once read.
+        std::optional<Http::H2::Result> result;
+        /// A wake byte was written for this result.
+        bool woken{false};
+    };
+
+    /// Send @p req on the persistent connection and read its response:
+    /// multiplexed with other threads' requests over HTTP/2, one at a time
+    /// over HTTP/1.1.
+    [[nodiscard]] Reply exchange(const HttpRequest &req, const Utils::CancellationToken &cancel_token) const;
+
+    /// exchange() over HTTP/2.
+    /// @param io_lock  Holds io_mutex_; released once the request is sent.
+    [[nodiscard]] Reply exchange_h2(const HttpRequest &req, std::unique_lock<std::mutex> &io_lock,
+                                    const Utils::CancellationToken &cancel_token) const;
+
+    /// Ensure a persistent TLS connection exists (create or reuse).  An
+    /// HTTP/2 connection with requests in flight is reused as is.
+    /// @param io_lock  Holds io_mutex_; released while waiting for the
+    ///                 requests of a failed or closing connection to finish.
     /// @return  std::expected<void, DnsErrorInfo> — empty on success, error on failure.
-    [[nodiscard]] std::expected<void, DnsErrorInfo> ensure_connection() const;
+    [[nodiscard]] std::expected<void, DnsErrorInfo> ensure_connection(std::unique_lock<std::mutex> &io_lock) const;
+
+    /// Read what the HTTP/2 connection holds and hand every response to its
+    /// waiter.  Takes io_mutex_.
+    void service() const;
+
+    /// Reset the streams of requests that gave up.  Caller holds io_mutex_.
+    void reset_abandoned() const;
+
+    /// End every request still waiting with @p error; the connection is
+    /// replaced once they are gone.  Caller holds mutex_.
+    void fail_all(Http::Error error) const;
+
+    /// Hand @p result to the waiter of @p stream_id.  Caller holds mutex_.
+    void deliver(std::uint32_t stream_id, Http::H2::Result result) const;
+
+    /// Remove a waiter, returning its result if one arrived.  Caller holds
+    /// mutex_.
+    std::optional<Http::H2::Result> take(std::uint32_t stream_id) const;
 
     // ── Data members ──
     const std::string server_;
@@ -89,10 +152,38 @@ struct DohResolver::Impl {
     const std::string path_;
     const std::string host_header_;
     const std::string label_;   // display label for log / error messages
+    /// The encoded query of each name and type looked up.
+    mutable DNS::QueryTemplateCache templates_;
     const std::uint64_t id_;
-    mutable std::mutex mutex_;
+    Utils::UniqueFd wake_read_;
+    Utils::UniqueFd wake_write_;
+
+    /// Serialises use of the TLS session: handshake, writes and reads.
+    /// Held for a whole exchange over HTTP/1.1; over HTTP/2 never while
+    /// waiting for a response.
+    mutable std::mutex io_mutex_;
     mutable std::unique_ptr<TlsConnectionBase> persistent_conn_;
+    mutable std::unique_ptr<Transport::TlsStream> stream_;
+    /// The HTTP/2 session, if the server negotiated "h2".
+    mutable std::unique_ptr<Http::H2::Session> session_;
     mutable std::chrono::steady_clock::time_point last_use_;
+
+    /// Guards the HTTP/2 requests in flight and the connection state below.
+    /// Taken after io_mutex_ when both are held.
+    mutable std::mutex mutex_;
+    /// Signalled whenever a waiter is gone.
+    mutable std::condition_variable released_;
+    /// Waiters removed so far, to wait for a stream to free up.
+    mutable std::uint64_t released_count_{0};
+    mutable std::unordered_map<std::uint32_t, Waiter> waiters_;
+    /// Streams of requests that gave up (timeout, cancellation), to reset.
+    mutable std::vector<std::uint32_t> abandoned_;
+    /// Socket of the connection, stable while any request is in flight.
+    mutable int fd_{-1};
+    /// A read or write failed: every request in flight has been ended.
+    mutable bool broken_{false};
+    /// A request timed out without a response.
+    mutable bool stalled_{false};
 };
 
 DohResolver::Impl::Impl(std::string server, std::uint16_t port, std::string path, std::uint64_t id, std::string label,
@@ -101,6 +192,14 @@ DohResolver::Impl::Impl(std::string server, std::uint16_t port, std::string path
       host_header_(build_host_header(server_, port_)), label_(std::move(label)), id_(id),
       persistent_conn_(std::move(conn)),
       last_use_(std::chrono::steady_clock::now()) {
+    // Wakes a waiting request whose response was read by another thread.
+    auto [read_end, write_end] = Utils::make_pipe();
+    if (!read_end || ::fcntl(read_end.get(), F_SETFL, O_NONBLOCK) < 0 ||
+        ::fcntl(write_end.get(), F_SETFL, O_NONBLOCK) < 0) {
+        throw SocketException(errno, "DoH wake pipe");
+    }
+    wake_read_ = std::move(read_end);
+    wake_write_ = std::move(write_end);
 }
 
 // ===========================================================================
@@ -116,49 +215,38 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DohResolver::Impl::query(
         SPDLOG_DEBUG(R"(Resolver #{} lookup for domain "{}" (type {}))", id_, host,
                      static_cast<std::uint16_t>(record_type));
 
-        // ---- 1. Build the raw DNS query packet ----
-        const auto query_bytes = DNS::build_query(host, record_type);
-
-        // ---- 2. Build HTTP POST request (RFC 8484) ----
+        // ---- 1. Build HTTP POST request (RFC 8484) ----
         HttpRequest req;
         req.method = HttpMethod::POST;
         req.content_type = "application/dns-message";
         req.headers.emplace("Accept", "application/dns-message");
         req.headers.emplace("Connection", "keep-alive");
-        req.body = std::string(reinterpret_cast<const char *>(query_bytes.data()), query_bytes.size());
 
-        // ---- 3. I/O under mutex for shared connection -------
-        // Retry once with reconnection on transient I/O failure.
+        // ---- 2. Stamp the raw DNS query packet out of its template, straight into the body ----
+        const auto query = templates_.get(host, record_type);
+        auto &body = req.body.emplace(query->size(), '\0');
+        const auto query_bytes = query->write_to(std::span(reinterpret_cast<std::uint8_t *>(body.data()), body.size()));
+
+        // ---- 3. Exchange it on the shared connection ----
+        // Retry once on a new connection on transient I/O failure.
         constexpr int MAX_ATTEMPTS = 2;
         for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-            std::lock_guard lock(mutex_);
-
             if (attempt == 1) {
                 SPDLOG_DEBUG(R"(Connection to "{}" failed, reconnecting)", label_);
-                persistent_conn_->close();
             }
 
-            // Ensure connection before exchange.
-            if (auto res = ensure_connection(); !res) {
-                if (attempt < MAX_ATTEMPTS - 1) continue;
-                return std::unexpected(std::move(res.error()));
-            }
-
-            // Execute full HTTP exchange: build → send → read.
-            Transport::TlsStream stream(*persistent_conn_);
-            auto response = Http::exchange(stream, path_, req, host_header_, YADDNSC::get_full_version(), cancel_token);
+            auto response = exchange(req, cancel_token);
             if (!response) {
-                persistent_conn_->close();
-                if (response.error() == Http::Error::CANCELLED) {
-                    return std::unexpected(to_dns_error(response.error(), label_));
+                // CANCELLED should not be retried — abort immediately.
+                if (response.error().code == DnsError::CANCELLED) {
+                    return std::unexpected(std::move(response.error()));
                 }
                 if (attempt < MAX_ATTEMPTS - 1) continue;
-                return std::unexpected(to_dns_error(response.error(), label_));
+                return std::unexpected(std::move(response.error()));
             }
 
             // Check HTTP status code (RFC 8484 §4.2.1 — only 200 is valid).
             if (response->status_code != 200) {
-                persistent_conn_->close();
                 return std::unexpected(DnsErrorInfo{
                     response->status_code >= 500 ? DnsError::RETRY : DnsError::SERVER_REFUSED,
                     fmt::format(R"(Server "{}" returned HTTP status {})", label_, response->status_code)
@@ -171,7 +259,6 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DohResolver::Impl::query(
                 return std::unexpected(std::move(valid.error()));
             }
 
-            last_use_ = std::chrono::steady_clock::now();
             SPDLOG_DEBUG(R"(Resolver #{} query succeeded ({} bytes) for "{}"))", id_, response->body.size(), host);
 
             return std::move(response->body);
@@ -189,6 +276,236 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DohResolver::Impl::query(
     }
 }
 
+// ---------------------------------------------------------------------------
+//  exchange  —  one request on the persistent connection
+// ---------------------------------------------------------------------------
+
+DohResolver::Impl::Reply DohResolver::Impl::exchange(const HttpRequest &req,
+                                                     const Utils::CancellationToken &cancel_token) const {
+    std::unique_lock io_lock(io_mutex_);
+    if (auto res = ensure_connection(io_lock); !res) {
+        return std::unexpected(std::move(res.error()));
+    }
+    if (session_) {
+        return exchange_h2(req, io_lock, cancel_token);
+    }
+
+    // HTTP/1.1: build → send → read, with the connection to ourselves.
+    auto response = Http::exchange(*stream_, path_, req, host_header_, YADDNSC::get_full_version(), cancel_token);
+    if (!response) {
+        persistent_conn_->close();
+        return std::unexpected(to_dns_error(response.error(), label_));
+    }
+    if (response->status_code != 200) {
+        // The body of an error response may not have been read in full.
+        persistent_conn_->close();
+    }
+    last_use_ = std::chrono::steady_clock::now();
+    return std::move(*response);
+}
+
+// ---------------------------------------------------------------------------
+//  exchange_h2  —  one stream among those multiplexed on the connection
+//
+//  Requests are written as they come, under io_mutex_ only for the write
+//  itself.  While waiting, every request polls the socket; whichever finds
+//  it readable reads the frames under io_mutex_ and hands each completed
+//  response to its request, waking that request's thread.
+// ---------------------------------------------------------------------------
+
+DohResolver::Impl::Reply DohResolver::Impl::exchange_h2(const HttpRequest &req, std::unique_lock<std::mutex> &io_lock,
+                                                        const Utils::CancellationToken &cancel_token) const {
+    const auto deadline = std::chrono::steady_clock::now() + QUERY_TIMEOUT;
+    reset_abandoned();
+
+    // Wait for a stream to free up if the server's limit is reached.
+    while (!session_ || !session_->can_open()) {
+        if (!session_ || !session_->usable()) {
+            // Closing (GOAWAY, failure): the retry waits for a new connection.
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Connection to "{}" is closing)", label_)
+            });
+        }
+        std::unique_lock lock(mutex_);
+        const auto seen = released_count_;
+        io_lock.unlock();
+        const auto freed = released_.wait_until(lock, deadline, [this, seen] { return released_count_ != seen; });
+        lock.unlock();
+        io_lock.lock();
+        if (!freed) {
+            return std::unexpected(DnsErrorInfo{
+                DnsError::RETRY,
+                fmt::format(R"(Query to "{}" timed out waiting for a stream)", label_)
+            });
+        }
+    }
+
+    const auto stream_id = session_->submit(path_, req, host_header_, YADDNSC::get_full_version());
+    if (!stream_id) {
+        if (session_->failed()) {
+            std::lock_guard lock(mutex_);
+            fail_all(stream_id.error());
+        }
+        return std::unexpected(to_dns_error(stream_id.error(), label_));
+    }
+    {
+        std::lock_guard lock(mutex_);
+        waiters_.emplace(*stream_id, Waiter{});
+    }
+    last_use_ = std::chrono::steady_clock::now();
+    io_lock.unlock();
+
+    const auto to_reply = [this](Http::H2::Result result) -> Reply {
+        if (!result) {
+            return std::unexpected(to_dns_error(result.error(), label_));
+        }
+        return std::move(*result);
+    };
+
+    while (true) {
+        int fd;
+        {
+            std::lock_guard lock(mutex_);
+            if (waiters_.at(*stream_id).result) {
+                return to_reply(std::move(*take(*stream_id)));
+            }
+            fd = fd_;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            std::lock_guard lock(mutex_);
+            if (auto result = take(*stream_id)) {
+                return to_reply(std::move(*result));
+            }
+            abandoned_.push_back(*stream_id);
+            stalled_ = true;
+            return std::unexpected(DnsErrorInfo{
+                DnsError::RETRY,
+                fmt::format(R"(Query to "{}" timed out)", label_)
+            });
+        }
+
+        // A connection without a pollable socket is read directly.
+        if (fd < 0) {
+            service();
+            continue;
+        }
+
+        std::array<pollfd, 3> fds{{
+            {fd, POLLIN, 0},
+            {wake_read_.get(), POLLIN, 0},
+            {cancel_token.native_handle(), POLLIN, 0},
+        }};
+        const auto nfds = cancel_token ? fds.size() : fds.size() - 1;
+        // Round up, so a sub-millisecond remainder does not busy-loop.
+        const auto rc = ::poll(fds.data(), nfds, static_cast<int>(remaining.count()) + 1);
+        if (rc < 0 && errno != EINTR) {
+            const auto errnum = errno;
+            std::lock_guard lock(mutex_);
+            if (!take(*stream_id)) {
+                abandoned_.push_back(*stream_id);
+            }
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Poll on connection to "{}" failed: {})", label_, std::strerror(errnum))
+            });
+        }
+
+        if (cancel_token && fds[2].revents != 0) {
+            std::lock_guard lock(mutex_);
+            if (!take(*stream_id)) {
+                abandoned_.push_back(*stream_id);
+            }
+            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "Query cancelled"});
+        }
+        if (fds[0].revents != 0) {
+            service();
+        } else if (fds[1].revents != 0) {
+            // Another request's response was handed over; let its thread run.
+            std::this_thread::yield();
+        }
+    }
+}
+
+void DohResolver::Impl::service() const {
+    std::lock_guard io_lock(io_mutex_);
+    {
+        std::lock_guard lock(mutex_);
+        if (broken_ || waiters_.empty()) {
+            // Read by another thread meanwhile; nothing to read for.
+            return;
+        }
+    }
+    reset_abandoned();
+
+    // One TLS record may carry several frames: drain what OpenSSL
+    // buffered, which the next poll() would not see.
+    do {
+        auto status = session_->receive([this](std::uint32_t stream_id, Http::H2::Result result) {
+            std::lock_guard lock(mutex_);
+            deliver(stream_id, std::move(result));
+        });
+        if (!status) {
+            std::lock_guard lock(mutex_);
+            fail_all(status.error());
+            return;
+        }
+    } while (persistent_conn_->has_pending());
+}
+
+void DohResolver::Impl::reset_abandoned() const {
+    std::vector<std::uint32_t> abandoned;
+    {
+        std::lock_guard lock(mutex_);
+        abandoned.swap(abandoned_);
+    }
+    if (session_) {
+        for (const auto stream_id: abandoned) {
+            session_->reset(stream_id);
+        }
+    }
+}
+
+void DohResolver::Impl::deliver(std::uint32_t stream_id, Http::H2::Result result) const {
+    const auto it = waiters_.find(stream_id);
+    if (it == waiters_.end() || it->second.result) {
+        // Gave up meanwhile; its reset is queued.
+        return;
+    }
+    it->second.result = std::move(result);
+    it->second.woken = true;
+    const std::uint8_t byte = 1;
+    [[maybe_unused]] auto _ = ::write(wake_write_.get(), &byte, sizeof(byte));
+}
+
+void DohResolver::Impl::fail_all(Http::Error error) const {
+    broken_ = true;
+    for (auto &[stream_id, waiter]: waiters_) {
+        if (!waiter.result) {
+            waiter.result = std::unexpected(error);
+            waiter.woken = true;
+            const std::uint8_t byte = 1;
+            [[maybe_unused]] auto _ = ::write(wake_write_.get(), &byte, sizeof(byte));
+        }
+    }
+}
+
+std::optional<Http::H2::Result> DohResolver::Impl::take(std::uint32_t stream_id) const {
+    const auto it = waiters_.find(stream_id);
+    auto result = std::move(it->second.result);
+    if (it->second.woken) {
+        std::uint8_t byte = 0;
+        [[maybe_unused]] auto _ = ::read(wake_read_.get(), &byte, sizeof(byte));
+    }
+    waiters_.erase(it);
+    ++released_count_;
+    released_.notify_all();
+    return result;
+}
+
 // ===========================================================================
 //  Helper implementations
 // ===========================================================================
@@ -199,9 +516,33 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DohResolver::Impl::query(
 //  Returns std::expected<void, DnsErrorInfo> — empty on success, error on failure.
 // ---------------------------------------------------------------------------
 
-std::expected<void, DnsErrorInfo> DohResolver::Impl::ensure_connection() const {
+std::expected<void, DnsErrorInfo> DohResolver::Impl::ensure_connection(std::unique_lock<std::mutex> &io_lock) const {
     const auto now = std::chrono::steady_clock::now();
 
+    {
+        std::unique_lock lock(mutex_);
+        // A failed or closing connection is replaced once the requests it
+        // carries are gone: they may still be polling its socket.
+        while ((broken_ || (session_ && !session_->usable())) && !waiters_.empty()) {
+            io_lock.unlock();
+            released_.wait(lock, [this] { return waiters_.empty(); });
+            lock.unlock();
+            io_lock.lock();
+            lock.lock();
+        }
+        // In use, so alive.  A stalled connection is kept for the requests
+        // still waiting on it, and replaced after them.
+        if (!waiters_.empty()) {
+            return {};
+        }
+
+        if (broken_ || stalled_ || (session_ && !session_->usable())) {
+            SPDLOG_TRACE(R"(Connection to "{}" {}, reconnecting)", label_,
+                         broken_ ? "failed" : stalled_ ? "stalled" : "closing");
+            persistent_conn_->close();
+        }
+    }
+
     if (persistent_conn_ && persistent_conn_->is_connected()) {
         const auto idle = std::chrono::duration_cast<std::chrono::seconds>(now - last_use_);
         if (idle < IDLE_TIMEOUT) [[likely]] {
@@ -217,12 +558,26 @@ std::expected<void, DnsErrorInfo> DohResolver::Impl::ensure_connection() const {
     }
 
     if (!persistent_conn_) {
+        // DNS queries are idempotent: after a reconnect, the first ones go
+        // out as 0-RTT early data when the resumed session allows it.
         persistent_conn_ = std::make_unique<TlsConnection>(
-            server_, port_, TlsOptions{.alpn_proto = ALPN_HTTP, .connect_timeout = CONNECT_TIMEOUT}
+            server_, port_, TlsOptions{.alpn_proto = ALPN_DOH, .connect_timeout = CONNECT_TIMEOUT, .early_data = true}
         );
     }
+    if (!stream_) {
+        stream_ = std::make_unique<Transport::TlsStream>(*persistent_conn_);
+    }
 
+    // Whatever was in flight or abandoned belonged to the old connection.
+    session_.reset();
     auto result = persistent_conn_->connect();
+    {
+        std::lock_guard lock(mutex_);
+        fd_ = result ? persistent_conn_->native_fd() : -1;
+        broken_ = false;
+        stalled_ = false;
+        abandoned_.clear();
+    }
     if (!result) {
         if (result.error() == TlsConnection::IoStatus::TIMEOUT) {
             return std::unexpected(DnsErrorInfo{DnsError::RETRY,
@@ -232,6 +587,16 @@ std::expected<void, DnsErrorInfo> DohResolver::Impl::ensure_connection() const {
             fmt::format(R"(Connection to "{}" failed)", label_)});
     }
 
+    if (persistent_conn_->negotiated_alpn() == "h2") {
+        session_ = std::make_unique<Http::H2::Session>(*stream_);
+        if (auto started = session_->start(); !started) {
+            session_.reset();
+            persistent_conn_->close();
+            return std::unexpected(to_dns_error(started.error(), label_));
+        }
+        SPDLOG_TRACE(R"(Using HTTP/2 for "{}")", label_);
+    }
+
     last_use_ = now;
     return {};
 }
@@ -20,11 +20,14 @@ class TlsConnectionBase;
 ///
 /// Uses a TLS connection (via TlsConnectionBase) to send DNS queries to a
 /// DNS-over-HTTPS server.  Queries are sent as HTTP POST requests with
-/// Content-Type: application/dns-message and responses are parsed with
-/// picohttpparser.  Supports cancellation via CancellationToken.
+/// Content-Type: application/dns-message.  Supports cancellation via
+/// CancellationToken.
 ///
-/// @note Thread-safe: query() acquires an internal mutex around the
-///       persistent TLS connection.
+/// HTTP/2 is preferred (ALPN "h2"): concurrent queries are then multiplexed
+/// on the persistent connection, one stream each, and a slow response holds
+/// up no other.  Over HTTP/1.1 they take turns on it.
+///
+/// @note Thread-safe: any number of threads may query at once.
 class DohResolver final : public ResolverBase {
 public:
     /// Construct with server hostname, port, and URL path.
@@ -5,26 +5,42 @@
 #include "dot.h"
 
 #include <chrono>
+#include <condition_variable>
+#include <cerrno>
 #include <cstdint>
+#include <cstring>
 #include <mutex>
+#include <optional>
 #include "util/random.hpp"
+#include <random>
 #include <span>
 #include <string>
 #include <algorithm>
 #include <array>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
 #include "exception/dns_lookup.h"
 #include "exception/dns_packet.h"
+#include "exception/socket.h"
 #include "exception/tls.h"
 #include "dns/dns_error_info.h"
 #include "dns/resolver_registry.h"
 #include "dns/util.hpp"
+#include "dns/types.h"
 #include "dns/validator.h"
-#include "dns/wire/builder.h"
+#include "dns/wire/query_template.h"
 #include "network/tls_connection.h"
 #include "util/bytes.hpp"
+#include "util/cancellation_token.hpp"
+#include "util/fd.hpp"
 
 #include "dns_error.h"
 #include "uri.h"
@@ -34,6 +50,39 @@
 
 namespace {
     using namespace std::chrono_literals;
+
+    [[nodiscard]] std::uint16_t random_id() {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 0xFFFF);
+        return static_cast<std::uint16_t>(dist(Utils::Random::engine()));
+    }
+
+    /// Offset past the question of @p packet, or 0 if it has none.
+    /// Questions sent by us, and their echoes, are never compressed.
+    [[nodiscard]] std::size_t question_end(std::span<const std::uint8_t> packet) noexcept {
+        if (packet.size() < DNS::HEADER_SIZE || Utils::Bytes::read_u16_be(packet, 4) != 1) {
+            return 0;
+        }
+        std::size_t offset = DNS::HEADER_SIZE;
+        while (offset < packet.size()) {
+            const auto label_len = packet[offset];
+            if (label_len == 0) {
+                offset += 1 + 4; // terminator, QTYPE + QCLASS
+                return offset <= packet.size() ? offset : 0;
+            }
+            if ((label_len & 0xC0) != 0) {
+                return 0;
+            }
+            offset += 1 + label_len;
+        }
+        return 0;
+    }
+
+    [[nodiscard]] DnsErrorInfo io_error(TlsConnectionBase::IoStatus status, std::string message) {
+        if (status == TlsConnectionBase::IoStatus::CANCELLED) {
+            return {DnsError::CANCELLED, "Query cancelled"};
+        }
+        return {DnsError::CONNECTION, std::move(message)};
+    }
 } // anonymous namespace
 
 // ===========================================================================
@@ -44,48 +93,115 @@ struct DotResolver::Impl {
     // ── Constants ──
     static constexpr auto IDLE_TIMEOUT = 30s;
     static constexpr auto CONNECT_TIMEOUT = 1s;
+    /// How long a query waits for its response once sent.
+    static constexpr auto QUERY_TIMEOUT = 1500ms;
+    /// RFC 7830 / RFC 7858 §3.5: pad DoT queries to a block boundary to
+    /// obscure query length and reduce traffic-analysis risk.  A 128-octet
+    /// block size is a reasonable trade-off between overhead and protection.
+    static constexpr std::size_t PAD_BLOCK = 128;
+    /// Queries padded to PAD_BLOCK, with a 512-octet EDNS0 payload size.
+    static constexpr DNS::QueryTemplate::Layout QUERY_LAYOUT{.udp_payload_size = 512, .pad_block = PAD_BLOCK};
+    /// A query for any name, behind its length prefix (RFC 7858 §3.3).
+    static constexpr std::size_t MAX_FRAMED_QUERY =
+            DNS::LENGTH_PREFIX_SIZE + DNS::QueryTemplate::max_size(QUERY_LAYOUT);
     static constexpr unsigned char ALPN_DOT[] = {3, 'd', 'o', 't'};
 
+    using Reply = std::expected<std::vector<std::uint8_t>, DnsErrorInfo>;
+
     // ── Constructor ──
+    /// @throws SocketException if the wake pipe cannot be created.
     explicit Impl(std::string server, std::uint16_t port, std::uint64_t id, std::string label,
                   std::unique_ptr<TlsConnectionBase> conn = nullptr);
 
     // ── Public member functions ──
-    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo> query(
-        const std::string &host, RecordKind type,
-        const Utils::CancellationToken &cancel_token) const;
+    [[nodiscard]] Reply query(const std::string &host, RecordKind type,
+                              const Utils::CancellationToken &cancel_token) const;
 
     // ── Private helpers ──
-    /// Ensure a persistent TLS connection exists (create or reuse).
+    /// A query in flight on the connection.
+    struct Waiter {
+        /// Question section of the query, to match against the echo in the
+        /// response.
+        std::vector<std::uint8_t> question;
+        /// The response (or the error that ended the query), once read.
+        std::optional<Reply> reply;
+        /// A wake byte was written for this reply.
+        bool woken{false};
+    };
+
+    /// Send @p framed (a query behind its 2-byte length prefix) on the
+    /// shared connection and wait for its response, while other threads'
+    /// queries are in flight on it too.
+    ///
+    /// The transaction ID of the query is rewritten if another query in
+    /// flight already uses it.
+    /// @return The response, or RETRY on timeout, CANCELLED, CONNECTION or
+    ///         PARSE (the server broke framing or sent an unsolicited
+    ///         response).
+    [[nodiscard]] Reply exchange(std::span<std::uint8_t> framed, const Utils::CancellationToken &cancel_token) const;
+
+    /// Ensure a persistent TLS connection exists (create or reuse).  A
+    /// connection with queries in flight is reused as is.
+    /// @param io_lock  Holds io_mutex_; released while waiting for the
+    ///                 queries of a failed connection to finish.
     /// @return  std::expected<void, DnsErrorInfo> — empty on success, error on failure.
-    [[nodiscard]] std::expected<void, DnsErrorInfo> ensure_connection() const;
+    [[nodiscard]] std::expected<void, DnsErrorInfo> ensure_connection(std::unique_lock<std::mutex> &io_lock) const;
 
-    /// Build a padded DNS query for DoT (RFC 7858 §3.5 / RFC 7830).
-    /// @throws  DnsPacketException on invalid input (programming error).
-    [[nodiscard]] static std::vector<std::uint8_t> build_padded_query(const std::string &host, DNS::RecordType type);
+    /// Read one response (2-byte length prefix + DNS message).  Caller holds
+    /// io_mutex_.
+    /// @return  The message on success, or an I/O/parse error.
+    ///          Does NOT throw.
+    [[nodiscard]] Reply read_response() const;
 
-    [[nodiscard]] static std::vector<std::uint8_t> build_wire_format(const std::vector<std::uint8_t> &query_bytes);
+    /// Read every response available on the connection and route each to
+    /// its waiter.  Takes io_mutex_.
+    void service() const;
 
-    /// Send the wire-format query with one automatic reconnect.
-    /// @return  std::expected on success or I/O error (timeout, cancellation).
-    [[nodiscard]] std::expected<void, DnsErrorInfo> send_query(std::span<const std::uint8_t> wire,
-                                                             const Utils::CancellationToken &cancel_token) const;
+    /// Route a response to the query with the same ID and question.
+    /// Caller holds mutex_.
+    /// @return false if the response belongs to no query.
+    bool dispatch(std::vector<std::uint8_t> response) const;
 
-    /// Read the response (2-byte length prefix + DNS message).
-    /// @return  Parsed DNS response on success, or an I/O/parse error.
-    ///          Does NOT throw.
-    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo> read_response(
-        const Utils::CancellationToken &cancel_token) const;
+    /// End every query still waiting with @p error; the connection is
+    /// replaced once they are gone.  Caller holds mutex_.
+    void fail_all(const DnsErrorInfo &error) const;
+
+    /// Remove a waiter, returning its reply if one arrived.  Caller holds
+    /// mutex_.
+    std::optional<Reply> take(std::uint16_t id) const;
 
     // ── Data members ──
     const std::uint64_t id_;
     const std::string server_;
     const std::uint16_t port_;
     const std::string label_;   // display label for log / error messages
-    mutable std::mutex mutex_;
+    /// The encoded query of each name and type looked up.
+    mutable DNS::QueryTemplateCache templates_{QUERY_LAYOUT};
+    Utils::UniqueFd wake_read_;
+    Utils::UniqueFd wake_write_;
+
+    /// Serialises use of the TLS session: handshake, writes and reads.
+    /// Never held while waiting for a response.
+    mutable std::mutex io_mutex_;
     mutable std::unique_ptr<TlsConnectionBase> persistent_conn_;
     mutable std::chrono::steady_clock::time_point last_use_;
     mutable bool alpn_warned_{false};
+
+    /// Guards the queries in flight and the connection state below.  Taken
+    /// after io_mutex_ when both are held.
+    mutable std::mutex mutex_;
+    /// Signalled when the last waiter is gone.
+    mutable std::condition_variable idle_;
+    mutable std::unordered_map<std::uint16_t, Waiter> waiters_;
+    /// IDs of queries that gave up (timeout, cancellation): their late
+    /// responses are dropped.
+    mutable std::unordered_set<std::uint16_t> abandoned_;
+    /// Socket of the connection, stable while any query is in flight.
+    mutable int fd_{-1};
+    /// A read or write failed: every query in flight has been ended.
+    mutable bool broken_{false};
+    /// A query timed out without a response.
+    mutable bool stalled_{false};
 };
 
 DotResolver::Impl::Impl(std::string server, std::uint16_t port, std::uint64_t id, std::string label,
@@ -93,9 +209,17 @@ DotResolver::Impl::Impl(std::string server, std::uint16_t port, std::uint64_t id
     : id_(id), server_(std::move(server)), port_(port), label_(std::move(label)),
       persistent_conn_(std::move(conn)),
       last_use_(std::chrono::steady_clock::now()) {
+    // Wakes a waiting query whose response was read by another thread.
+    auto [read_end, write_end] = Utils::make_pipe();
+    if (!read_end || ::fcntl(read_end.get(), F_SETFL, O_NONBLOCK) < 0 ||
+        ::fcntl(write_end.get(), F_SETFL, O_NONBLOCK) < 0) {
+        throw SocketException(errno, "DoT wake pipe");
+    }
+    wake_read_ = std::move(read_end);
+    wake_write_ = std::move(write_end);
 }
 
-std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::query(
+DotResolver::Impl::Reply DotResolver::Impl::query(
     const std::string &host, RecordKind type,
     const Utils::CancellationToken &cancel_token) const {
     try {
@@ -104,38 +228,20 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::query(
         SPDLOG_DEBUG(R"(Resolver #{} lookup for domain "{}" (type {}))", id_, host,
                      static_cast<std::uint16_t>(record_type));
 
-        // ---- 1. Build the padded DNS query packet (RFC 7830) ----
-        const auto query_bytes = build_padded_query(host, record_type);
-
-        // ---- 2. Build DoT wire format (2-byte length prefix + DNS message) ----
-        const auto wire = build_wire_format(query_bytes);
+        // ---- 1. Stamp out the padded DNS query packet (RFC 7830) behind its length prefix ----
+        std::array<std::uint8_t, MAX_FRAMED_QUERY> buffer;
+        const auto framed = templates_.get(host, record_type)->write_to(buffer, DNS::Framing::LENGTH_PREFIXED);
+        const auto query_bytes = framed.subspan(DNS::LENGTH_PREFIX_SIZE);
 
-        // ---- 3. I/O under mutex for shared connection -------
-        // Retry once with reconnection on transient I/O failure.
+        // ---- 2. Exchange it on the shared connection ----
+        // Retry once on a new connection on transient I/O failure.
         constexpr int MAX_ATTEMPTS = 2;
         for (int attempt = 0; attempt < MAX_ATTEMPTS; ++attempt) {
-            std::lock_guard lock(mutex_);
-
             if (attempt == 1) {
                 SPDLOG_DEBUG(R"(Connection to "{}" failed, reconnecting)", label_);
-                // No graceful TLS shutdown needed — we are about to reconnect.
-                // The connection may already be in an inconsistent state (e.g.
-                // connect timed out mid-handshake).
-                // Just close and let ensure_connection() rebuild from scratch.
-                persistent_conn_->close();
             }
 
-            auto send_result = send_query(wire, cancel_token);
-            if (!send_result) {
-                // CANCELLED should not be retried — abort immediately.
-                if (send_result.error().code == DnsError::CANCELLED) {
-                    return std::unexpected(std::move(send_result.error()));
-                }
-                if (attempt < MAX_ATTEMPTS - 1) continue;
-                return std::unexpected(std::move(send_result.error()));
-            }
-
-            auto response = read_response(cancel_token);
+            auto response = exchange(framed, cancel_token);
             if (!response) {
                 // CANCELLED should not be retried — abort immediately.
                 if (response.error().code == DnsError::CANCELLED) {
@@ -145,13 +251,12 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::query(
                 return std::unexpected(std::move(response.error()));
             }
 
-            // ---- 4. Validate DNS response header (RFC 1035 §4.1.1) ----
+            // ---- 3. Validate DNS response header (RFC 1035 §4.1.1) ----
             auto valid = DNS::Validator::validate_response(query_bytes, *response);
             if (!valid) {
                 return std::unexpected(std::move(valid.error()));
             }
 
-            last_use_ = std::chrono::steady_clock::now();
             SPDLOG_DEBUG(R"(Resolver #{} query succeeded ({} bytes) for "{}")", id_, response->size(), host);
 
             return std::move(*response);
@@ -174,122 +279,230 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::query(
     }
 }
 
-// ===========================================================================
-//  Helper implementations
-// ===========================================================================
-
 // ---------------------------------------------------------------------------
-//  build_padded_query  —  build DNS query with EDNS(0) padding (RFC 7830)
+//  exchange  —  one query among those pipelined on the connection
+//
+//  Queries are written as they come (RFC 7858 §3.3), under io_mutex_ only
+//  for the write itself.  While waiting, every query polls the socket;
+//  whichever finds it readable reads the responses under io_mutex_ and hands
+//  each to its query, waking that query's thread.
 // ---------------------------------------------------------------------------
 
-std::vector<std::uint8_t> DotResolver::Impl::build_padded_query(
-    const std::string &host, DNS::RecordType type) {
-    // RFC 7830 / RFC 7858 §3.5: pad DoT queries to a block boundary to
-    // obscure query length and reduce traffic-analysis risk.  A 128-octet
-    // block size is a reasonable trade-off between overhead and protection.
-    constexpr size_t PAD_BLOCK = 128;
-
-    // EDNS0 OPT pseudo-record + padding-option overhead (excluding the
-    // padding bytes themselves):
-    //   NAME     1  (root label)
-    //   TYPE     2  (OPT = 41)
-    //   CLASS    2  (UDP payload size)
-    //   TTL      4
-    //   RDLENGTH 2
-    //   + padding-option code (2) + length (2)  =  4
-    //   ─────────────────────────────────────────
-    //   Total   15 bytes overhead
-    constexpr size_t EDNS_PAD_OVERHEAD = 15;
-
-    // Step 1: build the base query without EDNS0 to know its wire size.
-    const auto base = DNS::QueryBuilder{}.add_question(host, type).build();
-
-    // Step 2: calculate padding length needed to reach the next block boundary.
-    const size_t raw_size = base.size() + EDNS_PAD_OVERHEAD;
-    const size_t pad_len = (raw_size % PAD_BLOCK == 0) ? PAD_BLOCK : PAD_BLOCK - raw_size % PAD_BLOCK;
-    // pad_len is guaranteed to be >= 1 because (PAD_BLOCK - raw_size % PAD_BLOCK)
-    // is in [1, PAD_BLOCK] when raw_size % PAD_BLOCK != 0, and we substitute
-    // PAD_BLOCK (>= 1) when the remainder is zero.
-
-    // Step 3: rebuild with EDNS0 padding option (code 12, RFC 7830).
-    // Padding bytes SHOULD be unpredictable (RFC 7830 §3).
-    std::vector<std::uint8_t> padding_data(pad_len);
-    std::ranges::generate(padding_data, [] { return static_cast<std::uint8_t>(Utils::Random::engine()()); });
-    const DNS::EdnsOption pad_opt{12, padding_data};
-
-    return DNS::QueryBuilder{}
-            .add_question(host, type)
-            .add_edns(512, 0, false, std::span(&pad_opt, 1))
-            .build();
+DotResolver::Impl::Reply DotResolver::Impl::exchange(std::span<std::uint8_t> framed,
+                                                     const Utils::CancellationToken &cancel_token) const {
+    const auto query = framed.subspan(DNS::LENGTH_PREFIX_SIZE);
+    std::uint16_t id;
+    {
+        std::unique_lock io_lock(io_mutex_);
+        if (auto res = ensure_connection(io_lock); !res) {
+            return std::unexpected(std::move(res.error()));
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            id = Utils::Bytes::read_u16_be(query, 0);
+            while (waiters_.contains(id) || abandoned_.contains(id)) {
+                id = random_id();
+            }
+            Utils::Bytes::write_u16_be(query.data(), id);
+
+            Waiter waiter;
+            if (const auto end = question_end(query); end != 0) {
+                waiter.question.assign(query.begin() + DNS::HEADER_SIZE,
+                                       query.begin() + static_cast<std::ptrdiff_t>(end));
+            }
+            waiters_.emplace(id, std::move(waiter));
+        }
+
+        // ---- DoT wire format (2-byte length prefix + DNS message), sent as built ----
+        if (auto status = persistent_conn_->send_all(framed, cancel_token); !status) {
+            // Part of the message may be on the wire: the stream cannot be
+            // resumed, so every query on it fails.
+            std::lock_guard lock(mutex_);
+            fail_all(io_error(status.error(), fmt::format(R"(Failed to send query to "{}")", label_)));
+            return std::move(*take(id));
+        }
+        last_use_ = std::chrono::steady_clock::now();
+        SPDLOG_TRACE(R"(Sent {} bytes to "{}")", framed.size(), label_);
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + QUERY_TIMEOUT;
+    while (true) {
+        int fd;
+        {
+            std::lock_guard lock(mutex_);
+            if (waiters_.at(id).reply) {
+                return std::move(*take(id));
+            }
+            fd = fd_;
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            std::lock_guard lock(mutex_);
+            if (auto reply = take(id)) {
+                return std::move(*reply);
+            }
+            abandoned_.insert(id);
+            stalled_ = true;
+            return std::unexpected(DnsErrorInfo{
+                DnsError::RETRY,
+                fmt::format(R"(Query to "{}" timed out)", label_)
+            });
+        }
+
+        // A connection without a pollable socket is read directly.
+        if (fd < 0) {
+            service();
+            continue;
+        }
+
+        std::array<pollfd, 3> fds{{
+            {fd, POLLIN, 0},
+            {wake_read_.get(), POLLIN, 0},
+            {cancel_token.native_handle(), POLLIN, 0},
+        }};
+        const auto nfds = cancel_token ? fds.size() : fds.size() - 1;
+        // Round up, so a sub-millisecond remainder does not busy-loop.
+        const auto rc = ::poll(fds.data(), nfds, static_cast<int>(remaining.count()) + 1);
+        if (rc < 0 && errno != EINTR) {
+            const auto errnum = errno;
+            std::lock_guard lock(mutex_);
+            if (!take(id)) {
+                abandoned_.insert(id);
+            }
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Poll on connection to "{}" failed: {})", label_, std::strerror(errnum))
+            });
+        }
+
+        if (cancel_token && fds[2].revents != 0) {
+            std::lock_guard lock(mutex_);
+            if (!take(id)) {
+                abandoned_.insert(id);
+            }
+            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "Query cancelled"});
+        }
+        if (fds[0].revents != 0) {
+            service();
+        } else if (fds[1].revents != 0) {
+            // Another query's response was handed over; let its thread run.
+            std::this_thread::yield();
+        }
+    }
 }
 
-// ---------------------------------------------------------------------------
-//  build_wire_format  —  2-byte length prefix + DNS message
-// ---------------------------------------------------------------------------
+void DotResolver::Impl::service() const {
+    std::lock_guard io_lock(io_mutex_);
+    {
+        std::lock_guard lock(mutex_);
+        if (broken_ || waiters_.empty()) {
+            // Read by another thread meanwhile; nothing to read for.
+            return;
+        }
+    }
 
-std::vector<std::uint8_t> DotResolver::Impl::build_wire_format(const std::vector<std::uint8_t> &query_bytes) {
-    std::vector<std::uint8_t> wire(2 + query_bytes.size());
-    Utils::Bytes::write_u16_be(wire, static_cast<std::uint16_t>(query_bytes.size()));
-    std::ranges::copy(query_bytes, wire.begin() + 2);
-    return wire;
+    // One record may carry several responses: drain what OpenSSL buffered,
+    // which the next poll() would not see.
+    do {
+        // Not cancellable: stopping mid-message would break the framing for
+        // every other query on the connection.
+        auto response = read_response();
+
+        std::lock_guard lock(mutex_);
+        if (!response) {
+            fail_all(response.error());
+            return;
+        }
+        if (!dispatch(std::move(*response))) {
+            // Not a late response to a query that gave up: the server is
+            // out of step with us (RFC 7858 §3.3), so nothing on the
+            // connection can be trusted.
+            fail_all(DnsErrorInfo{
+                DnsError::PARSE,
+                fmt::format(R"(Server "{}" sent a response matching no query)", label_)
+            });
+            return;
+        }
+    } while (persistent_conn_->has_pending());
 }
 
-// ---------------------------------------------------------------------------
-//  send_query  —  sends with one automatic reconnect + TLS close_notify
-//
-//  Returns std::expected for I/O errors (cancellation, send failure).
-// ---------------------------------------------------------------------------
+bool DotResolver::Impl::dispatch(std::vector<std::uint8_t> response) const {
+    if (response.size() < DNS::HEADER_SIZE) {
+        return false;
+    }
+    const auto id = Utils::Bytes::read_u16_be(response, 0);
+    if (abandoned_.erase(id) != 0) {
+        SPDLOG_TRACE(R"(Dropped late response from "{}")", label_);
+        return true;
+    }
 
-std::expected<void, DnsErrorInfo> DotResolver::Impl::send_query(
-    std::span<const std::uint8_t> wire,
-    const Utils::CancellationToken &cancel_token) const {
-    if (auto res = ensure_connection(); !res) {
-        return std::unexpected(std::move(res.error()));
+    const auto it = waiters_.find(id);
+    if (it == waiters_.end() || it->second.reply) {
+        return false;
+    }
+    const auto &question = it->second.question;
+    if (const auto end = question_end(response); end != 0 &&
+        !std::ranges::equal(std::span{response}.subspan(DNS::HEADER_SIZE, end - DNS::HEADER_SIZE), question)) {
+        return false;
     }
-    auto status = persistent_conn_->send_all(wire, cancel_token);
+    // Anything else wrong with it is for the validator to report.
+    it->second.reply = std::move(response);
+    it->second.woken = true;
+    const std::uint8_t byte = 1;
+    [[maybe_unused]] auto _ = ::write(wake_write_.get(), &byte, sizeof(byte));
+    return true;
+}
 
-    if (!status) {
-        if (status.error() == TlsConnection::IoStatus::CANCELLED) {
-            [[maybe_unused]] const auto _ = persistent_conn_->shutdown();
-            persistent_conn_->close();
-            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "Query cancelled"});
+void DotResolver::Impl::fail_all(const DnsErrorInfo &error) const {
+    broken_ = true;
+    for (auto &[id, waiter]: waiters_) {
+        if (!waiter.reply) {
+            waiter.reply = std::unexpected(error);
+            waiter.woken = true;
+            const std::uint8_t byte = 1;
+            [[maybe_unused]] auto _ = ::write(wake_write_.get(), &byte, sizeof(byte));
         }
-        [[maybe_unused]] const auto _ = persistent_conn_->shutdown();
-        persistent_conn_->close();
-        return std::unexpected(DnsErrorInfo{
-            DnsError::CONNECTION,
-            fmt::format(R"(Failed to send query to "{}")", label_)
-        });
     }
+}
 
-    SPDLOG_TRACE(R"(Sent {} bytes to "{}")", wire.size(), label_);
-    return {};
+std::optional<DotResolver::Impl::Reply> DotResolver::Impl::take(std::uint16_t id) const {
+    const auto it = waiters_.find(id);
+    auto reply = std::move(it->second.reply);
+    if (it->second.woken) {
+        std::uint8_t byte = 0;
+        [[maybe_unused]] auto _ = ::read(wake_read_.get(), &byte, sizeof(byte));
+    }
+    waiters_.erase(it);
+    if (waiters_.empty()) {
+        idle_.notify_all();
+    }
+    return reply;
 }
 
+// ===========================================================================
+//  Helper implementations
+// ===========================================================================
+
 // ---------------------------------------------------------------------------
 //  read_response  —  read 2-byte length prefix + body
 //
 //  Returns std::expected for all errors — I/O and parse errors are expected
 //  conditions.  Does NOT throw.
 //
-//  On error the connection is NOT closed here — the caller propagates the
-//  error and ensure_connection() will detect the stale state on the
-//  next query and reconnect if needed.
+//  Any error leaves the stream out of step; the caller ends every query on
+//  the connection, and ensure_connection() replaces it.
 // ---------------------------------------------------------------------------
 
-std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::read_response(
-    const Utils::CancellationToken &cancel_token) const {
+DotResolver::Impl::Reply DotResolver::Impl::read_response() const {
     // Read 2-byte response length prefix (big-endian).
     std::array<std::uint8_t, 2> length_buffer{};
-    auto status = persistent_conn_->read_exact(length_buffer, cancel_token);
+    auto status = persistent_conn_->read_exact(length_buffer, {});
     if (!status) {
-        if (status.error() == TlsConnection::IoStatus::CANCELLED) {
-            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "Query cancelled"});
-        }
-        return std::unexpected(DnsErrorInfo{
-            DnsError::CONNECTION,
-            fmt::format(R"(Failed to read response length from "{}")", label_)
-        });
+        return std::unexpected(io_error(status.error(),
+                                        fmt::format(R"(Failed to read response length from "{}")", label_)));
     }
 
     const auto resp_len = Utils::Bytes::read_u16_be(length_buffer);
@@ -299,25 +512,13 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::read_r
             fmt::format(R"(Server "{}" returned zero-length response)", label_)
         });
     }
-    constexpr size_t MAX_DOT_RESPONSE_SIZE = 65535;
-    if (resp_len > MAX_DOT_RESPONSE_SIZE) {
-        return std::unexpected(DnsErrorInfo{
-            DnsError::PARSE,
-            fmt::format(R"(Server "{}" response too large: {} bytes)", label_, resp_len)
-        });
-    }
 
     // Read response body.
     std::vector<std::uint8_t> response(resp_len, 0);
-    status = persistent_conn_->read_exact(std::span{response}, cancel_token);
+    status = persistent_conn_->read_exact(std::span{response}, {});
     if (!status) {
-        if (status.error() == TlsConnection::IoStatus::CANCELLED) {
-            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "Query cancelled"});
-        }
-        return std::unexpected(DnsErrorInfo{
-            DnsError::CONNECTION,
-            fmt::format(R"(Failed to read response body from "{}")", label_)
-        });
+        return std::unexpected(io_error(status.error(),
+                                        fmt::format(R"(Failed to read response body from "{}")", label_)));
     }
 
     return response;
@@ -329,9 +530,35 @@ std::expected<std::vector<std::uint8_t>, DnsErrorInfo> DotResolver::Impl::read_r
 //  Returns std::expected<void, DnsErrorInfo> — empty on success, error on failure.
 // ---------------------------------------------------------------------------
 
-std::expected<void, DnsErrorInfo> DotResolver::Impl::ensure_connection() const {
+std::expected<void, DnsErrorInfo> DotResolver::Impl::ensure_connection(std::unique_lock<std::mutex> &io_lock) const {
     const auto now = std::chrono::steady_clock::now();
 
+    {
+        std::unique_lock lock(mutex_);
+        // A failed connection is replaced once the queries it ended are
+        // gone: they may still be polling its socket.
+        while (broken_ && !waiters_.empty()) {
+            io_lock.unlock();
+            idle_.wait(lock, [this] { return !broken_ || waiters_.empty(); });
+            lock.unlock();
+            io_lock.lock();
+            lock.lock();
+        }
+        // In use, so alive.  A stalled connection is kept for the queries
+        // still waiting on it, and replaced after them.
+        if (!waiters_.empty()) {
+            return {};
+        }
+
+        if (broken_ || stalled_) {
+            SPDLOG_TRACE(R"(Connection to "{}" {}, reconnecting)", label_, broken_ ? "failed" : "stalled");
+            if (!broken_) {
+                [[maybe_unused]] auto _ = persistent_conn_->shutdown();
+            }
+            persistent_conn_->close();
+        }
+    }
+
     if (persistent_conn_ && persistent_conn_->is_connected()) {
         const auto idle = std::chrono::duration_cast<std::chrono::seconds>(now - last_use_);
         if (idle < IDLE_TIMEOUT) [[likely]] {
@@ -350,12 +577,22 @@ std::expected<void, DnsErrorInfo> DotResolver::Impl::ensure_connection() const {
     }
 
     if (!persistent_conn_) {
+        // DNS queries are idempotent: after a reconnect, the first ones go
+        // out as 0-RTT early data when the resumed session allows it.
         persistent_conn_ = std::make_unique<TlsConnection>(
-            server_, port_, TlsOptions{.alpn_proto = ALPN_DOT, .connect_timeout = CONNECT_TIMEOUT}
+            server_, port_, TlsOptions{.alpn_proto = ALPN_DOT, .connect_timeout = CONNECT_TIMEOUT, .early_data = true}
         );
     }
 
     auto connect_result = persistent_conn_->connect();
+    {
+        // Whatever was in flight or dropped belonged to the old connection.
+        std::lock_guard lock(mutex_);
+        fd_ = connect_result ? persistent_conn_->native_fd() : -1;
+        broken_ = false;
+        stalled_ = false;
+        abandoned_.clear();
+    }
     if (!connect_result) {
         if (connect_result.error() == TlsConnection::IoStatus::TIMEOUT) {
             return std::unexpected(DnsErrorInfo{DnsError::RETRY,
@@ -22,16 +22,24 @@ class TlsConnectionBase;
 /// DNS-over-TLS server on port 853 (default).  DNS messages are framed with a
 /// 2-byte big-endian length prefix as specified in RFC 7858 §3.3.
 ///
+/// Concurrent queries are pipelined on one persistent connection: each is
+/// written as soon as it is issued, without waiting for the responses of
+/// those before it, and responses are matched back to their query by
+/// transaction ID and question, in whatever order the server sends them.
+/// A response matching no query means the server is out of step, and ends
+/// every query on the connection.
+///
 /// Input:  Server hostname/IP and port (default 853).
 /// Output: Raw DNS response bytes (wire format), ready for DnsRecordParser.
 ///
-/// @attention Currently, when cancel_fd is signalled, the in-flight query is
-///            aborted with a CANCELLED error (via poll() on both the TLS socket
-///            and the cancel fd).  This is a best-effort mechanism — the query
-///            may have already been sent and the server may still process it.
+/// @attention When cancel_fd is signalled, the query is abandoned with a
+///            CANCELLED error: its late response, if any, is dropped.  This
+///            is a best-effort mechanism — the query may have already been
+///            sent and the server may still process it.
 ///
-/// @note Thread-safe: query() acquires an internal mutex around the persistent
-///       TLS connection.  Distinct DotResolver objects are independent.
+/// @note Thread-safe: the TLS session is locked only while a query is
+///       written or responses are read, never while waiting for them.
+///       Distinct DotResolver objects are independent.
 class DotResolver final : public ResolverBase {
 public:
     /// Construct with server address and optional port.
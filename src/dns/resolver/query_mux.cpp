@@ -0,0 +1,401 @@
+//
+// Created by Kotarou on 2026/8/2.
+//
+// Routing of DNS replies read from one shared socket to the queries waiting
+// on it, for the UDP socket pool and the pipelined TCP connection.
+//
+// Compiled when YADDNSC_USE_NATIVE_DNS=1.
+//
+
+#include "dns/resolver/query_mux.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "dns/types.h"
+#include "exception/socket.h"
+#include "network/reactor.h"
+#include "util/bytes.hpp"
+#include "util/cancellation_token.hpp"
+#include "util/random.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+#include <poll.h>
+#include <spdlog/spdlog.h>
+
+namespace {
+    [[nodiscard]] std::uint16_t random_id() {
+        std::uniform_int_distribution<std::uint32_t> dist(0, 0xFFFF);
+        return static_cast<std::uint16_t>(dist(Utils::Random::engine()));
+    }
+
+    /// Offset past the question of @p packet, or 0 if it has none.
+    /// Questions sent by us, and their echoes, are never compressed.
+    [[nodiscard]] std::size_t question_end(std::span<const std::uint8_t> packet) noexcept {
+        if (packet.size() < DNS::HEADER_SIZE || Utils::Bytes::read_u16_be(packet, 4) != 1) {
+            return 0;
+        }
+        std::size_t offset = DNS::HEADER_SIZE;
+        while (offset < packet.size()) {
+            const auto label_len = packet[offset];
+            if (label_len == 0) {
+                offset += 1 + 4; // terminator, QTYPE + QCLASS
+                return offset <= packet.size() ? offset : 0;
+            }
+            if ((label_len & 0xC0) != 0) {
+                return 0;
+            }
+            offset += 1 + label_len;
+        }
+        return 0;
+    }
+} // anonymous namespace
+
+// ===========================================================================
+//  QueryMux
+// ===========================================================================
+
+QueryMux::QueryMux(Socket sock, std::uint64_t resolver_id, const char *transport)
+    : sock_(std::move(sock)), resolver_id_(resolver_id), transport_(transport) {
+    // Wakes a blocked exchange() whose reply was read by another thread.
+    auto [read_end, write_end] = Utils::make_pipe();
+    if (!read_end || ::fcntl(read_end.get(), F_SETFL, O_NONBLOCK) < 0 ||
+        ::fcntl(write_end.get(), F_SETFL, O_NONBLOCK) < 0) {
+        throw SocketException(errno, fmt::format("{} wake pipe", transport_));
+    }
+    wake_read_ = std::move(read_end);
+    wake_write_ = std::move(write_end);
+}
+
+QueryMux::~QueryMux() = default;
+
+std::uint16_t QueryMux::add_waiter(std::span<std::uint8_t> query, Waiter waiter) {
+    auto id = Utils::Bytes::read_u16_be(query);
+    while (waiters_.contains(id)) {
+        id = random_id();
+    }
+    Utils::Bytes::write_u16_be(query.data(), id);
+
+    if (const auto end = question_end(query); end != 0) {
+        waiter.question.assign(query.begin() + DNS::HEADER_SIZE, query.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+    waiters_.emplace(id, std::move(waiter));
+    return id;
+}
+
+QueryMux::Reply QueryMux::exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                   const Utils::CancellationToken &cancel_token) {
+    std::uint16_t id;
+    {
+        std::lock_guard lock(mtx_);
+        id = add_waiter(query, {});
+        if (auto sent = transmit(query); !sent) {
+            take(id);
+            return std::unexpected(std::move(sent.error()));
+        }
+    }
+
+    const auto withdraw = [this, id] {
+        std::lock_guard lock(mtx_);
+        return take(id);
+    };
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true) {
+        short events;
+        {
+            std::lock_guard lock(mtx_);
+            if (waiters_.at(id).reply) {
+                return *take(id);
+            }
+            events = poll_events();
+        }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            std::lock_guard lock(mtx_);
+            if (auto reply = take(id)) {
+                return std::move(*reply);
+            }
+            stalled_ = true;
+            return std::unexpected(DnsErrorInfo{
+                DnsError::RETRY,
+                fmt::format(R"(Resolver #{} {} query timed out)", resolver_id_, transport_)
+            });
+        }
+
+        std::array<pollfd, 3> fds{{
+            {sock_.native_handle(), events, 0},
+            {wake_read_.get(), POLLIN, 0},
+            {cancel_token.native_handle(), POLLIN, 0},
+        }};
+        const auto nfds = cancel_token ? fds.size() : fds.size() - 1;
+        // Round up, so a sub-millisecond remainder does not busy-loop.
+        const auto rc = ::poll(fds.data(), nfds, static_cast<int>(remaining.count()) + 1);
+        if (rc < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            const auto errnum = errno;
+            withdraw();
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Resolver #{} {} poll failed: {})", resolver_id_, transport_, std::strerror(errnum))
+            });
+        }
+
+        if (cancel_token && fds[2].revents != 0) {
+            withdraw();
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CANCELLED,
+                fmt::format(R"(Resolver #{} {} query cancelled)", resolver_id_, transport_)
+            });
+        }
+        if (fds[0].revents != 0) {
+            service(fds[0].revents, nullptr, id);
+        } else if (fds[1].revents != 0) {
+            // Another query's reply was handed over; let its thread run.
+            std::this_thread::yield();
+        }
+    }
+}
+
+std::expected<QueryMux::Ticket, DnsErrorInfo> QueryMux::send_async(Reactor &reactor, std::span<std::uint8_t> query,
+                                                                   ReplyCallback on_reply) {
+    std::lock_guard lock(mtx_);
+    Waiter waiter;
+    waiter.reactor = &reactor;
+    waiter.on_reply = std::move(on_reply);
+    const auto id = add_waiter(query, std::move(waiter));
+
+    if (auto sent = transmit(query); !sent) {
+        waiters_.erase(id);
+        return std::unexpected(std::move(sent.error()));
+    }
+
+    auto &watch = watchers_[&reactor];
+    if (watch.queries == 0) {
+        watch.events = poll_events();
+        auto watched = reactor.add(sock_.native_handle(), watch.events,
+                                   [self = shared_from_this(), &reactor](short revents) {
+                                       self->service(revents, &reactor, std::nullopt);
+                                   });
+        if (!watched) {
+            waiters_.erase(id);
+            watchers_.erase(&reactor);
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Resolver #{} {} watch failed: {})", resolver_id_, transport_,
+                            std::strerror(watched.error()))
+            });
+        }
+    } else {
+        update_watch(reactor);
+    }
+    ++watch.queries;
+    return Ticket(shared_from_this(), id, &reactor);
+}
+
+std::size_t QueryMux::pending() const {
+    std::lock_guard lock(mtx_);
+    return waiters_.size();
+}
+
+bool QueryMux::failed() const {
+    std::lock_guard lock(mtx_);
+    return failed_;
+}
+
+bool QueryMux::stalled() const {
+    std::lock_guard lock(mtx_);
+    return stalled_;
+}
+
+short QueryMux::poll_events() const {
+    return static_cast<short>(POLLIN | (wants_write() ? POLLOUT : 0));
+}
+
+void QueryMux::service(short revents, Reactor *reader, std::optional<std::uint16_t> self) {
+    Deliveries deliveries;
+    {
+        std::lock_guard lock(mtx_);
+        if ((revents & (POLLOUT | POLLERR | POLLHUP)) != 0 && wants_write()) {
+            if (auto flushed = flush(); !flushed) {
+                fail_all(flushed.error(), reader, self, deliveries);
+            }
+        }
+        if ((revents & (POLLIN | POLLERR | POLLHUP)) != 0) {
+            auto received = receive([&](std::span<const std::uint8_t> message) {
+                dispatch(message, reader, self, deliveries);
+            });
+            if (!received) {
+                // A socket error concerns the server, so every query on
+                // this socket fails with it.
+                fail_all(received.error(), reader, self, deliveries);
+            }
+        }
+        if (reader) {
+            update_watch(*reader);
+        }
+    }
+
+    for (auto &[on_reply, reply]: deliveries) {
+        on_reply(std::move(reply));
+    }
+}
+
+void QueryMux::dispatch(std::span<const std::uint8_t> message, const Reactor *reader,
+                        std::optional<std::uint16_t> self, Deliveries &deliveries) {
+    if (message.size() < DNS::HEADER_SIZE) {
+        return;
+    }
+    const auto it = waiters_.find(Utils::Bytes::read_u16_be(message));
+    if (it == waiters_.end() || it->second.reply) {
+        SPDLOG_TRACE("Resolver #{} dropped unmatched {} reply", resolver_id_, transport_);
+        return;
+    }
+    // A reply without a parsable question still goes to its query, whose
+    // validation rejects it.
+    const auto &question = it->second.question;
+    if (const auto end = question_end(message); end != 0 &&
+        !std::ranges::equal(message.subspan(DNS::HEADER_SIZE, end - DNS::HEADER_SIZE), question)) {
+        SPDLOG_TRACE("Resolver #{} dropped {} reply with a foreign question", resolver_id_, transport_);
+        return;
+    }
+    route(it, std::vector(message.begin(), message.end()), reader, self, deliveries);
+}
+
+void QueryMux::route(Waiters::iterator it, Reply reply, const Reactor *reader, std::optional<std::uint16_t> self,
+                     Deliveries &deliveries) {
+    auto &waiter = it->second;
+    if (!waiter.reactor) {
+        waiter.reply = std::move(reply);
+        if (it->first != self) {
+            waiter.woken = true;
+            const std::uint8_t byte = 1;
+            [[maybe_unused]] auto _ = ::write(wake_write_.get(), &byte, sizeof(byte));
+        }
+        return;
+    }
+
+    if (waiter.reactor == reader) {
+        deliveries.emplace_back(std::move(waiter.on_reply), std::move(reply));
+        waiters_.erase(it);
+        return;
+    }
+    waiter.reply = std::move(reply);
+    waiter.reactor->post([mux = shared_from_this(), id = it->first] { mux->hand_off(id); });
+}
+
+void QueryMux::fail_all(const DnsErrorInfo &error, const Reactor *reader, std::optional<std::uint16_t> self,
+                        Deliveries &deliveries) {
+    failed_ = true;
+    for (auto it = waiters_.begin(); it != waiters_.end();) {
+        auto next = std::next(it);
+        if (!it->second.reply) {
+            route(it, std::unexpected(error), reader, self, deliveries);
+        }
+        it = next;
+    }
+}
+
+std::optional<QueryMux::Reply> QueryMux::take(std::uint16_t id) {
+    const auto it = waiters_.find(id);
+    auto reply = std::move(it->second.reply);
+    if (it->second.woken) {
+        std::uint8_t byte = 0;
+        [[maybe_unused]] auto _ = ::read(wake_read_.get(), &byte, sizeof(byte));
+    }
+    waiters_.erase(it);
+    return reply;
+}
+
+void QueryMux::hand_off(std::uint16_t id) {
+    std::unique_lock lock(mtx_);
+    const auto it = waiters_.find(id);
+    if (it == waiters_.end() || !it->second.reply) {
+        return; // withdrawn
+    }
+    auto on_reply = std::move(it->second.on_reply);
+    auto reply = std::move(*it->second.reply);
+    waiters_.erase(it);
+    lock.unlock();
+
+    on_reply(std::move(reply));
+}
+
+void QueryMux::withdraw(std::uint16_t id, Reactor &reactor, bool expired) noexcept {
+    std::lock_guard lock(mtx_);
+    if (const auto it = waiters_.find(id); it != waiters_.end()) {
+        stalled_ = stalled_ || (expired && !it->second.reply);
+        waiters_.erase(it);
+    }
+    unwatch(reactor);
+}
+
+void QueryMux::update_watch(Reactor &reactor) noexcept {
+    const auto it = watchers_.find(&reactor);
+    if (it == watchers_.end()) {
+        return;
+    }
+    if (const auto events = poll_events(); events != it->second.events &&
+                                           reactor.modify(sock_.native_handle(), events)) {
+        it->second.events = events;
+    }
+}
+
+void QueryMux::unwatch(Reactor &reactor) noexcept {
+    const auto it = watchers_.find(&reactor);
+    if (it != watchers_.end() && --it->second.queries == 0) {
+        watchers_.erase(it);
+        reactor.remove(sock_.native_handle());
+    }
+}
+
+// ===========================================================================
+//  QueryMux::Ticket
+// ===========================================================================
+
+QueryMux::Ticket::Ticket(std::shared_ptr<QueryMux> mux, std::uint16_t id, Reactor *reactor) noexcept
+    : mux_(std::move(mux)), id_(id), reactor_(reactor) {
+}
+
+QueryMux::Ticket::~Ticket() {
+    reset();
+}
+
+QueryMux::Ticket::Ticket(Ticket &&other) noexcept
+    : mux_(std::move(other.mux_)), id_(other.id_), reactor_(other.reactor_) {
+}
+
+QueryMux::Ticket &QueryMux::Ticket::operator=(Ticket &&other) noexcept {
+    if (this != &other) {
+        reset();
+        mux_ = std::move(other.mux_);
+        id_ = other.id_;
+        reactor_ = other.reactor_;
+    }
+    return *this;
+}
+
+void QueryMux::Ticket::reset() noexcept {
+    if (mux_) {
+        mux_->withdraw(id_, *reactor_, false);
+        mux_.reset();
+    }
+}
+
+void QueryMux::Ticket::expire() noexcept {
+    if (mux_) {
+        mux_->withdraw(id_, *reactor_, true);
+        mux_.reset();
+    }
+}
@@ -0,0 +1,249 @@
+//
+// Created by Kotarou on 2026/8/2.
+//
+
+#ifndef YADDNSC_DNS_QUERY_MUX_H
+#define YADDNSC_DNS_QUERY_MUX_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dns/dns_error_info.h"
+#include "network/socket.h"
+#include "util/fd.hpp"
+
+class Reactor;
+
+namespace Utils {
+class CancellationToken;
+}
+
+/// QueryMux — the queries in flight on one socket to a DNS server, and the
+/// routing of each reply read from it to its query.
+///
+/// A transport (a pooled UDP socket, a pipelined TCP connection) derives
+/// from it and supplies how a query is written and how reply messages are
+/// read; the mux does the rest.  Any number of queries may share the
+/// socket — blocking ones from several threads, and reactor-driven ones —
+/// each holding a distinct transaction ID.  A reply is routed to its query
+/// by ID and echoed question, in whatever order it arrives; messages that
+/// match no query (late replies to timed-out queries, spoofing attempts)
+/// are dropped.
+///
+/// Whichever thread finds the socket readable reads it, under the mux lock,
+/// and hands each reply to its query: directly to a blocked exchange() (and
+/// a wake byte if that is another thread), through a post to the reactor of
+/// a send_async() query.
+///
+/// @note Thread-safe.  Owned through std::shared_ptr.
+class QueryMux : public std::enable_shared_from_this<QueryMux> {
+public:
+    using Reply = std::expected<std::vector<std::uint8_t>, DnsErrorInfo>;
+
+    using ReplyCallback = std::function<void(Reply)>;
+
+    /// A query registered by send_async().  Destroying it withdraws the
+    /// query: its callback is not called afterwards.
+    ///
+    /// @note Must be destroyed on the thread of the reactor passed to
+    ///       send_async(); it may be destroyed from within its own callback.
+    class Ticket {
+    public:
+        Ticket() noexcept = default;
+
+        ~Ticket();
+
+        Ticket(Ticket &&other) noexcept;
+
+        Ticket &operator=(Ticket &&other) noexcept;
+
+        Ticket(const Ticket &) = delete;
+
+        Ticket &operator=(const Ticket &) = delete;
+
+        /// Withdraw the query now.
+        void reset() noexcept;
+
+        /// Withdraw the query because it timed out: the socket is marked
+        /// stalled if its reply never arrived.
+        void expire() noexcept;
+
+        explicit operator bool() const noexcept { return mux_ != nullptr; }
+
+    private:
+        friend class QueryMux;
+
+        Ticket(std::shared_ptr<QueryMux> mux, std::uint16_t id, Reactor *reactor) noexcept;
+
+        std::shared_ptr<QueryMux> mux_;
+        std::uint16_t id_{0};
+        Reactor *reactor_{nullptr};
+    };
+
+    virtual ~QueryMux();
+
+    QueryMux(const QueryMux &) = delete;
+
+    QueryMux &operator=(const QueryMux &) = delete;
+
+    /// Send @p query and block until its reply arrives.
+    ///
+    /// The transaction ID of @p query is rewritten if another query on the
+    /// socket already uses it, so @p query is what the reply must be
+    /// validated against.
+    /// @return The reply, or RETRY on timeout, CANCELLED, or the transport's
+    ///         error (CONNECTION, PARSE).
+    [[nodiscard]] Reply exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                 const Utils::CancellationToken &cancel_token);
+
+    /// Send @p query and call @p on_reply with its reply on @p reactor's
+    /// thread, never from within send_async().  The caller enforces its own
+    /// timeout by destroying (or expiring) the ticket.
+    ///
+    /// Rewrites the transaction ID of @p query as exchange() does.
+    /// Must be called on @p reactor's thread.
+    /// @return The registration, or CONNECTION if the query cannot be sent.
+    [[nodiscard]] std::expected<Ticket, DnsErrorInfo> send_async(Reactor &reactor, std::span<std::uint8_t> query,
+                                                                 ReplyCallback on_reply);
+
+    /// Number of queries in flight.
+    [[nodiscard]] std::size_t pending() const;
+
+    /// Whether a read or write error ended every query in flight.
+    [[nodiscard]] bool failed() const;
+
+    /// Whether a query timed out without a reply.
+    [[nodiscard]] bool stalled() const;
+
+protected:
+    /// @param transport  "UDP" or "TCP", for messages.
+    /// @throws SocketException if the wake pipe cannot be created.
+    QueryMux(Socket sock, std::uint64_t resolver_id, const char *transport);
+
+    using MessageSink = std::function<void(std::span<const std::uint8_t>)>;
+
+    /// Write (or queue) a registered query.  Called with the mux locked.
+    [[nodiscard]] virtual std::expected<void, DnsErrorInfo> transmit(std::span<const std::uint8_t> query) = 0;
+
+    /// Read what the socket holds, passing each complete reply message to
+    /// @p sink.  Called with the mux locked.
+    /// @return An error, which ends every query in flight.
+    [[nodiscard]] virtual std::expected<void, DnsErrorInfo> receive(const MessageSink &sink) = 0;
+
+    /// Whether queued output waits for the socket to become writable.
+    /// Called with the mux locked.
+    [[nodiscard]] virtual bool wants_write() const { return false; }
+
+    /// Write queued output.  Called with the mux locked.
+    /// @return An error, which ends every query in flight.
+    [[nodiscard]] virtual std::expected<void, DnsErrorInfo> flush() { return {}; }
+
+    [[nodiscard]] Socket &socket() noexcept { return sock_; }
+
+    [[nodiscard]] const Socket &socket() const noexcept { return sock_; }
+
+    [[nodiscard]] std::uint64_t resolver_id() const noexcept { return resolver_id_; }
+
+    [[nodiscard]] const char *transport() const noexcept { return transport_; }
+
+private:
+    /// A query in flight.
+    struct Waiter {
+        /// Question section of the query (after the header), to match
+        /// against the echo in the reply.
+        std::vector<std::uint8_t> question;
+
+        /// The reply, once read: kept here for a blocking exchange() until
+        /// its thread picks it up, and for a send_async() on another
+        /// reactor until the posted hand-off runs.
+        std::optional<Reply> reply;
+        /// A wake byte was written for this reply.
+        bool woken{false};
+
+        /// send_async() only.
+        Reactor *reactor{nullptr};
+        ReplyCallback on_reply;
+    };
+
+    using Waiters = std::unordered_map<std::uint16_t, Waiter>;
+
+    /// Replies read on a reactor thread for queries of that same reactor:
+    /// delivered once the lock is released.
+    using Deliveries = std::vector<std::pair<ReplyCallback, Reply> >;
+
+    /// A reactor watching the socket for its async queries.
+    struct Watch {
+        std::size_t queries{0};
+        short events{0};
+    };
+
+    /// Register a query, giving it a fresh transaction ID if its own is in
+    /// use on this socket.  Caller holds mtx_.
+    /// @return The ID the query now carries.
+    std::uint16_t add_waiter(std::span<std::uint8_t> query, Waiter waiter);
+
+    /// Flush and read as @p revents allow, routing every reply read.
+    /// @param reader  The reactor doing so, or null for a thread in
+    ///                exchange().
+    /// @param self    The ID of the exchange() doing so, if any.
+    void service(short revents, Reactor *reader, std::optional<std::uint16_t> self);
+
+    /// Route a message read from the socket to its query.  Caller holds mtx_.
+    void dispatch(std::span<const std::uint8_t> message, const Reactor *reader, std::optional<std::uint16_t> self,
+                  Deliveries &deliveries);
+
+    /// Hand @p reply to waiter @p it.  Caller holds mtx_.
+    void route(Waiters::iterator it, Reply reply, const Reactor *reader, std::optional<std::uint16_t> self,
+               Deliveries &deliveries);
+
+    /// End every query still waiting with @p error.  Caller holds mtx_.
+    void fail_all(const DnsErrorInfo &error, const Reactor *reader, std::optional<std::uint16_t> self,
+                  Deliveries &deliveries);
+
+    /// Remove a blocking waiter, returning its reply if one arrived.
+    /// Caller holds mtx_.
+    std::optional<Reply> take(std::uint16_t id);
+
+    /// Run the callback of an async waiter whose reply was read by another
+    /// thread.  Runs on the waiter's reactor.
+    void hand_off(std::uint16_t id);
+
+    /// Withdraw an async query.
+    void withdraw(std::uint16_t id, Reactor &reactor, bool expired) noexcept;
+
+    /// Bring @p reactor's watch in line with wants_write().  Caller holds
+    /// mtx_ and runs on @p reactor's thread.
+    void update_watch(Reactor &reactor) noexcept;
+
+    /// Stop watching the socket on @p reactor once its last query is gone.
+    /// Caller holds mtx_.
+    void unwatch(Reactor &reactor) noexcept;
+
+    /// POLLIN, plus POLLOUT while output is queued.  Caller holds mtx_.
+    [[nodiscard]] short poll_events() const;
+
+    Socket sock_;
+    std::uint64_t resolver_id_;
+    const char *transport_;
+    Utils::UniqueFd wake_read_;
+    Utils::UniqueFd wake_write_;
+
+    mutable std::mutex mtx_;
+    Waiters waiters_;
+    /// Reactors watching the socket for their async queries.
+    std::unordered_map<Reactor *, Watch> watchers_;
+    bool failed_{false};
+    bool stalled_{false};
+};
+
+#endif // YADDNSC_DNS_QUERY_MUX_H
@@ -0,0 +1,46 @@
+//
+// Created by Kotarou on 2026/8/27.
+//
+
+#include "dns/resolver/rtt_estimator.h"
+
+#include <algorithm>
+
+namespace {
+    /// RFC 6298 §2: K, and G (the granularity of our clock, the reactor's
+    /// timers being in milliseconds).
+    constexpr int RTTVAR_FACTOR = 4;
+    constexpr std::chrono::microseconds CLOCK_GRANULARITY{1000};
+} // anonymous namespace
+
+void RttEstimator::sample(std::chrono::microseconds rtt) {
+    std::lock_guard lock(mutex_);
+    if (!srtt_) {
+        // RFC 6298 §2.2.
+        srtt_ = rtt;
+        rttvar_ = rtt / 2;
+    } else {
+        // RFC 6298 §2.3: RTTVAR first, from the SRTT before this sample.
+        const auto deviation = *srtt_ > rtt ? *srtt_ - rtt : rtt - *srtt_;
+        rttvar_ += (deviation - rttvar_) / 4;
+        *srtt_ += (rtt - *srtt_) / 8;
+    }
+
+    const auto rto = *srtt_ + std::max(CLOCK_GRANULARITY, RTTVAR_FACTOR * rttvar_);
+    rto_ = std::clamp(std::chrono::ceil<std::chrono::milliseconds>(rto), MIN_RTO, MAX_RTO);
+}
+
+void RttEstimator::backoff(std::chrono::milliseconds expired) {
+    std::lock_guard lock(mutex_);
+    rto_ = std::max(rto_, std::min(expired * 2, MAX_RTO));
+}
+
+std::chrono::milliseconds RttEstimator::rto() const {
+    std::lock_guard lock(mutex_);
+    return rto_;
+}
+
+std::optional<std::chrono::microseconds> RttEstimator::srtt() const {
+    std::lock_guard lock(mutex_);
+    return srtt_;
+}
@@ -0,0 +1,61 @@
+//
+// Created by Kotarou on 2026/8/27.
+//
+
+#ifndef YADDNSC_DNS_RTT_ESTIMATOR_H
+#define YADDNSC_DNS_RTT_ESTIMATOR_H
+
+#include <chrono>
+#include <mutex>
+#include <optional>
+
+/// RttEstimator — the smoothed round-trip time to one DNS server and the
+/// retransmission timeout (RTO) derived from it, as TCP computes them
+/// (Jacobson/Karels, RFC 6298 §2).
+///
+/// Every answered UDP query contributes a sample: SRTT and RTTVAR follow it
+/// with gains of 1/8 and 1/4, and RTO = SRTT + 4 * RTTVAR, clamped to
+/// [MIN_RTO, MAX_RTO].  Until the first sample, RTO is INITIAL_RTO.  A query
+/// that times out backs the RTO off (doubles it); the next sample replaces
+/// the backed-off value (RFC 6298 §5.5).
+///
+/// Every retransmission carries a transaction ID of its own: a blocking
+/// query gives it a new one, and the reactor-driven query keeps the earlier
+/// transmissions registered, so the retransmission's ID is rewritten as
+/// taken.  The reply thus says which transmission it answers and its RTT is
+/// unambiguous (the concern of Karn's algorithm): every reply may be
+/// sampled.
+///
+/// @note Thread-safe.
+class RttEstimator {
+public:
+    /// RFC 6298 §2.1.
+    static constexpr std::chrono::milliseconds INITIAL_RTO{1000};
+
+    /// Lower than TCP's 1 s: a DNS server on the LAN answers in well under
+    /// a millisecond, and a lost datagram should cost little more.
+    static constexpr std::chrono::milliseconds MIN_RTO{50};
+
+    static constexpr std::chrono::milliseconds MAX_RTO{2000};
+
+    /// Record the round-trip time of an answered query.
+    void sample(std::chrono::microseconds rtt);
+
+    /// Record that a query sent with timeout @p expired went unanswered.
+    /// Concurrent queries timing out together back off once, not once each.
+    void backoff(std::chrono::milliseconds expired);
+
+    /// How long to wait for a reply before retransmitting.
+    [[nodiscard]] std::chrono::milliseconds rto() const;
+
+    /// The smoothed RTT, or std::nullopt before the first sample.
+    [[nodiscard]] std::optional<std::chrono::microseconds> srtt() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::optional<std::chrono::microseconds> srtt_;
+    std::chrono::microseconds rttvar_{0};
+    std::chrono::milliseconds rto_{INITIAL_RTO};
+};
+
+#endif // YADDNSC_DNS_RTT_ESTIMATOR_H
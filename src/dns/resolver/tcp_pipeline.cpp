@@ -0,0 +1,263 @@
+//
+// Created by Kotarou on 2026/8/2.
+//
+// Persistent, pipelined TCP connection shared by the queries of a native
+// ClassicResolver (RFC 7766).
+//
+// Compiled when YADDNSC_USE_NATIVE_DNS=1.
+//
+
+#include "dns/resolver/tcp_pipeline.h"
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <utility>
+
+#include "exception/socket.h"
+#include "network/socket.h"
+#include "network/socket_addr.h"
+#include "util/bytes.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <spdlog/spdlog.h>
+
+namespace {
+    // ── Constants ──
+
+    /// Bytes read from the connection per recv().
+    constexpr std::size_t RECV_CHUNK_SIZE = 16384;
+
+    /// Size of the length prefix of every message (RFC 1035 §4.2.2).
+    constexpr std::size_t LENGTH_PREFIX_SIZE = sizeof(std::uint16_t);
+
+    /// Whether a non-blocking send or recv must wait: ENOTCONN while the
+    /// connect is still in progress.
+    [[nodiscard]] bool would_block(int errnum) {
+        return errnum == EAGAIN || errnum == EWOULDBLOCK || errnum == ENOTCONN;
+    }
+} // anonymous namespace
+
+// ===========================================================================
+//  TcpPipeline::Connection  —  the connection and its queries
+// ===========================================================================
+
+class TcpPipeline::Connection final : public QueryMux {
+public:
+    /// Open a non-blocking socket and start connecting.
+    /// @throws SocketException if the socket cannot be opened, or the
+    ///         connect fails outright.
+    Connection(const SocketAddr &server, int family, std::uint64_t owner_id);
+
+    /// Whether the next query may use this connection.
+    [[nodiscard]] bool reusable(std::chrono::steady_clock::time_point now) const;
+
+    /// Guarded by Impl::mtx_.
+    std::chrono::steady_clock::time_point last_used{std::chrono::steady_clock::now()};
+
+private:
+    /// Queue the length-prefixed query, and write what the socket takes.
+    [[nodiscard]] std::expected<void, DnsErrorInfo> transmit(std::span<const std::uint8_t> query) override;
+
+    /// Read what the socket holds, and pass on every complete message.
+    [[nodiscard]] std::expected<void, DnsErrorInfo> receive(const MessageSink &sink) override;
+
+    [[nodiscard]] bool wants_write() const override { return out_sent_ < out_.size(); }
+
+    [[nodiscard]] std::expected<void, DnsErrorInfo> flush() override;
+
+    /// Queries not yet (fully) written, length-prefixed.
+    std::vector<std::uint8_t> out_;
+    std::size_t out_sent_{0};
+    /// Bytes read but not yet forming a complete message.
+    std::vector<std::uint8_t> in_;
+};
+
+TcpPipeline::Connection::Connection(const SocketAddr &server, int family, std::uint64_t owner_id)
+    : QueryMux(Socket(family, SOCK_STREAM), owner_id, "TCP") {
+    if (!socket().set_nonblocking(true)) {
+        throw SocketException(errno, "TCP set_nonblocking");
+    }
+    // DNS messages are small and latency-sensitive; batching via Nagle
+    // would hold back every pipelined query behind an unacknowledged one.
+    if (!socket().set_option(IPPROTO_TCP, TCP_NODELAY, 1)) {
+        SPDLOG_DEBUG("Resolver #{} could not set TCP_NODELAY", owner_id);
+    }
+
+    int rc;
+    do {
+        rc = ::connect(socket().native_handle(), server.raw(), server.raw_len());
+    } while (rc < 0 && errno == EINTR);
+    if (rc < 0 && errno != EINPROGRESS) {
+        throw SocketException(errno, "TCP connect");
+    }
+
+    SPDLOG_DEBUG("Resolver #{} opening TCP connection to {}", owner_id, server.to_string());
+}
+
+bool TcpPipeline::Connection::reusable(std::chrono::steady_clock::time_point now) const {
+    if (failed() || stalled()) {
+        return false;
+    }
+    if (pending() != 0) {
+        return true;
+    }
+    if (now - last_used >= IDLE_TIMEOUT) {
+        return false;
+    }
+    // Nothing is expected on an idle connection: if it is readable, the
+    // server has closed it (RFC 7766 §6.2.3).
+    pollfd fd{socket().native_handle(), POLLIN, 0};
+    return ::poll(&fd, 1, 0) == 0;
+}
+
+std::expected<void, DnsErrorInfo> TcpPipeline::Connection::transmit(std::span<const std::uint8_t> query) {
+    const auto offset = out_.size();
+    out_.resize(offset + LENGTH_PREFIX_SIZE);
+    Utils::Bytes::write_u16_be(out_.data() + offset, static_cast<std::uint16_t>(query.size()));
+    out_.insert(out_.end(), query.begin(), query.end());
+
+    auto flushed = flush();
+    if (!flushed) {
+        // Part of a message may be on the wire: the stream cannot be
+        // resumed, so every other query on it fails too.
+        socket().shutdown_both();
+    }
+    return flushed;
+}
+
+std::expected<void, DnsErrorInfo> TcpPipeline::Connection::flush() {
+    while (out_sent_ < out_.size()) {
+        const auto sent = socket().send(std::as_bytes(std::span{out_}.subspan(out_sent_)));
+        if (sent < 0) {
+            if (would_block(errno)) {
+                return {};
+            }
+            return std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Resolver #{} TCP send failed: {})", resolver_id(), std::strerror(errno))
+            });
+        }
+        out_sent_ += static_cast<std::size_t>(sent);
+    }
+    out_.clear();
+    out_sent_ = 0;
+    return {};
+}
+
+std::expected<void, DnsErrorInfo> TcpPipeline::Connection::receive(const MessageSink &sink) {
+    std::expected<void, DnsErrorInfo> status;
+    std::array<std::uint8_t, RECV_CHUNK_SIZE> buffer{};
+    while (true) {
+        const auto received = socket().recv(std::as_writable_bytes(std::span{buffer}));
+        if (received > 0) {
+            in_.insert(in_.end(), buffer.begin(), buffer.begin() + received);
+            continue;
+        }
+        if (received == 0) {
+            status = std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Resolver #{} TCP connection closed by server)", resolver_id())
+            });
+        } else if (!would_block(errno)) {
+            status = std::unexpected(DnsErrorInfo{
+                DnsError::CONNECTION,
+                fmt::format(R"(Resolver #{} TCP recv failed: {})", resolver_id(), std::strerror(errno))
+            });
+        }
+        break;
+    }
+
+    // Replies that arrived before the connection closed still count.
+    std::size_t offset = 0;
+    while (in_.size() - offset >= LENGTH_PREFIX_SIZE) {
+        const std::size_t length = Utils::Bytes::read_u16_be(in_, offset);
+        if (length == 0) {
+            status = std::unexpected(DnsErrorInfo{
+                DnsError::PARSE,
+                fmt::format("Invalid DNS response length: {}", length)
+            });
+            socket().shutdown_both();
+            break;
+        }
+        if (in_.size() - offset - LENGTH_PREFIX_SIZE < length) {
+            break;
+        }
+        sink(std::span{in_}.subspan(offset + LENGTH_PREFIX_SIZE, length));
+        offset += LENGTH_PREFIX_SIZE + length;
+    }
+    in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(offset));
+    return status;
+}
+
+// ===========================================================================
+//  TcpPipeline::Impl  —  private implementation
+// ===========================================================================
+
+struct TcpPipeline::Impl {
+    Impl(const SocketAddr &server, int family, std::uint64_t resolver_id);
+
+    /// The current connection, replaced first if it is no longer reusable.
+    [[nodiscard]] std::shared_ptr<Connection> acquire();
+
+    SocketAddr server_;
+    int family_;
+    std::uint64_t resolver_id_;
+
+    mutable std::mutex mtx_;
+    std::shared_ptr<Connection> connection_;
+    std::uint64_t opened_{0};
+};
+
+TcpPipeline::Impl::Impl(const SocketAddr &server, int family, std::uint64_t resolver_id)
+    : server_(server), family_(family), resolver_id_(resolver_id) {
+}
+
+std::shared_ptr<TcpPipeline::Connection> TcpPipeline::Impl::acquire() {
+    std::lock_guard lock(mtx_);
+    const auto now = std::chrono::steady_clock::now();
+
+    // A replaced connection lives on until its last query releases it.
+    if (connection_ && !connection_->reusable(now)) {
+        SPDLOG_TRACE("Resolver #{} replacing TCP connection", resolver_id_);
+        connection_.reset();
+    }
+    if (!connection_) {
+        connection_ = std::make_shared<Connection>(server_, family_, resolver_id_);
+        ++opened_;
+    }
+    connection_->last_used = now;
+    return connection_;
+}
+
+// ===========================================================================
+//  TcpPipeline public API
+// ===========================================================================
+
+TcpPipeline::TcpPipeline(const SocketAddr &server, int family, std::uint64_t resolver_id)
+    : impl_(std::make_unique<Impl>(server, family, resolver_id)) {
+}
+
+TcpPipeline::~TcpPipeline() = default;
+
+TcpPipeline::Reply TcpPipeline::exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                         const Utils::CancellationToken &cancel_token) {
+    return impl_->acquire()->exchange(query, timeout, cancel_token);
+}
+
+std::expected<TcpPipeline::Ticket, DnsErrorInfo> TcpPipeline::send_async(
+    Reactor &reactor, std::span<std::uint8_t> query, ReplyCallback on_reply) {
+    return impl_->acquire()->send_async(reactor, query, std::move(on_reply));
+}
+
+std::uint64_t TcpPipeline::connections_opened() const {
+    std::lock_guard lock(impl_->mtx_);
+    return impl_->opened_;
+}
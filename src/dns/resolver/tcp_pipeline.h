@@ -0,0 +1,99 @@
+//
+// Created by Kotarou on 2026/8/2.
+//
+
+#ifndef YADDNSC_DNS_TCP_PIPELINE_H
+#define YADDNSC_DNS_TCP_PIPELINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "mixin.h"
+#include "dns/dns_error_info.h"
+#include "dns/resolver/query_mux.h"
+
+class SocketAddr;
+class Reactor;
+
+namespace Utils {
+class CancellationToken;
+}
+
+/// TcpPipeline — a persistent TCP connection to one DNS server (RFC 7766),
+/// shared by every TCP query of a ClassicResolver.
+///
+/// Queries are pipelined: each is written as soon as it is issued, without
+/// waiting for the replies of those before it, and the connection is a
+/// QueryMux, so replies are matched back by transaction ID in whatever order
+/// the server sends them.  The connection is opened without blocking by the
+/// first query that needs it; queries written meanwhile are queued until it
+/// is established.
+///
+/// The connection is kept open between queries, and replaced by the next
+/// query when it:
+///   - has been idle for IDLE_TIMEOUT,
+///   - was closed by the server, or failed,
+///   - left a query unanswered until its timeout (the server may be stuck
+///     on it).
+/// A replaced connection stays open until its last query finishes.
+///
+/// @note Thread-safe.
+class TcpPipeline {
+    /// The connection and the queries in flight on it.
+    class Connection;
+
+public:
+    using Reply = QueryMux::Reply;
+
+    using ReplyCallback = QueryMux::ReplyCallback;
+
+    /// A query registered by send_async(); see QueryMux::Ticket.  Expire it
+    /// when the query times out, so a stuck connection is replaced.
+    using Ticket = QueryMux::Ticket;
+
+    static constexpr std::chrono::seconds IDLE_TIMEOUT{30};
+
+    /// The connection is opened lazily, by the first query.
+    /// @param family  AF_INET or AF_INET6, matching @p server.
+    TcpPipeline(const SocketAddr &server, int family, std::uint64_t resolver_id);
+
+    ~TcpPipeline();
+
+    /// Send @p query and block until its reply arrives.
+    ///
+    /// The transaction ID of @p query is rewritten if another query on the
+    /// connection already uses it, so @p query is what the reply must be
+    /// validated against.
+    /// @return The reply, or RETRY on timeout, CANCELLED, CONNECTION if the
+    ///         connection is lost, or PARSE if the server breaks framing.
+    /// @throws SocketException if the connection cannot be opened.
+    [[nodiscard]] Reply exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                 const Utils::CancellationToken &cancel_token);
+
+    /// Send @p query and call @p on_reply with its reply on @p reactor's
+    /// thread, never from within send_async().  The caller enforces its own
+    /// timeout by expiring the ticket.
+    ///
+    /// Rewrites the transaction ID of @p query as exchange() does.
+    /// Must be called on @p reactor's thread.
+    /// @return The registration, or CONNECTION if the query cannot be sent.
+    /// @throws SocketException if the connection cannot be opened.
+    [[nodiscard]] std::expected<Ticket, DnsErrorInfo> send_async(Reactor &reactor, std::span<std::uint8_t> query,
+                                                                 ReplyCallback on_reply);
+
+    /// Number of connections opened so far.
+    [[nodiscard]] std::uint64_t connections_opened() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_DNS_TCP_PIPELINE_H
@@ -0,0 +1,193 @@
+//
+// Created by Kotarou on 2026/7/30.
+//
+// Connected UDP sockets shared by the queries of a native ClassicResolver.
+//
+// Compiled when YADDNSC_USE_NATIVE_DNS=1.
+//
+
+#include "dns/resolver/udp_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <span>
+#include <utility>
+
+#include "exception/socket.h"
+#include "network/inet_address.h"
+#include "network/socket.h"
+#include "network/socket_addr.h"
+#include "util/random.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+#include <spdlog/spdlog.h>
+
+namespace {
+    // ── Constants ──
+    constexpr std::size_t MAX_DNS_PACKET_SIZE = 4096;
+
+    /// Source ports are drawn from [MIN_SOURCE_PORT, 65535].
+    constexpr std::uint16_t MIN_SOURCE_PORT = 1024;
+
+    /// Random ports tried before leaving the choice to the kernel.
+    constexpr int BIND_ATTEMPTS = 8;
+
+    [[nodiscard]] bool would_block(int errnum) {
+        return errnum == EAGAIN || errnum == EWOULDBLOCK;
+    }
+
+    [[nodiscard]] std::uint16_t random_port() {
+        std::uniform_int_distribution<std::uint32_t> dist(MIN_SOURCE_PORT, 0xFFFF);
+        return static_cast<std::uint16_t>(dist(Utils::Random::engine()));
+    }
+
+    /// Bind @p sock to a random port, so the source port cannot be guessed
+    /// from the kernel's allocation order.  Falls back to the kernel's choice
+    /// (at connect) if every attempt is taken.
+    void bind_random_port(const Socket &sock, int family) {
+        const auto any = InetAddress::parse(family == AF_INET ? "0.0.0.0" : "::");
+        for (int attempt = 0; any && attempt < BIND_ATTEMPTS; ++attempt) {
+            const auto local = SocketAddr::from_inet(*any, random_port());
+            if (local && sock.bind(*local)) {
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] DnsErrorInfo recv_error(std::uint64_t resolver_id, int errnum) {
+        return DnsErrorInfo{
+            DnsError::CONNECTION,
+            fmt::format(R"(Resolver #{} UDP recv failed: {})", resolver_id, std::strerror(errnum))
+        };
+    }
+} // anonymous namespace
+
+// ===========================================================================
+//  UdpSocketPool::Channel  —  one pooled socket
+// ===========================================================================
+
+class UdpSocketPool::Channel final : public QueryMux {
+public:
+    /// Open, bind to a random port and connect.
+    /// @throws SocketException on failure.
+    Channel(const SocketAddr &server, int family, std::uint64_t owner_id);
+
+    std::chrono::steady_clock::time_point opened{std::chrono::steady_clock::now()};
+    /// Queries handed this socket.  Guarded by Impl::sockets_mtx_.
+    std::size_t assigned{0};
+
+private:
+    [[nodiscard]] std::expected<void, DnsErrorInfo> transmit(std::span<const std::uint8_t> query) override;
+
+    /// Read every queued datagram.
+    [[nodiscard]] std::expected<void, DnsErrorInfo> receive(const MessageSink &sink) override;
+};
+
+UdpSocketPool::Channel::Channel(const SocketAddr &server, int family, std::uint64_t owner_id)
+    : QueryMux(Socket(family, SOCK_DGRAM), owner_id, "UDP") {
+    bind_random_port(socket(), family);
+
+    if (!socket().connect(server)) {
+        throw SocketException(errno, "UDP connect");
+    }
+    if (!socket().set_nonblocking(true)) {
+        throw SocketException(errno, "UDP set_nonblocking");
+    }
+
+    SPDLOG_DEBUG("Resolver #{} opened UDP socket {}", resolver_id(), socket().get_sockname().to_string());
+}
+
+std::expected<void, DnsErrorInfo> UdpSocketPool::Channel::transmit(std::span<const std::uint8_t> query) {
+    const auto data = std::as_bytes(query);
+    if (socket().send(data) != static_cast<ssize_t>(data.size())) {
+        return std::unexpected(DnsErrorInfo{
+            DnsError::CONNECTION,
+            fmt::format(R"(Resolver #{} UDP send failed: {})", resolver_id(), std::strerror(errno))
+        });
+    }
+    return {};
+}
+
+std::expected<void, DnsErrorInfo> UdpSocketPool::Channel::receive(const MessageSink &sink) {
+    std::array<std::uint8_t, MAX_DNS_PACKET_SIZE> buffer{};
+    while (true) {
+        const auto received = socket().recv(std::as_writable_bytes(std::span{buffer}));
+        if (received < 0) {
+            if (would_block(errno)) {
+                return {};
+            }
+            // An ICMP error, reported on the connected socket.
+            return std::unexpected(recv_error(resolver_id(), errno));
+        }
+        sink(std::span{buffer}.first(static_cast<std::size_t>(received)));
+    }
+}
+
+// ===========================================================================
+//  UdpSocketPool::Impl  —  private implementation
+// ===========================================================================
+
+struct UdpSocketPool::Impl {
+    Impl(const SocketAddr &server, int family, std::uint64_t resolver_id, std::size_t pool_size);
+
+    [[nodiscard]] std::shared_ptr<Channel> acquire();
+
+    SocketAddr server_;
+    int family_;
+    std::uint64_t resolver_id_;
+
+    mutable std::mutex sockets_mtx_;
+    std::vector<std::shared_ptr<Channel> > sockets_;
+    std::size_t next_{0};
+};
+
+UdpSocketPool::Impl::Impl(const SocketAddr &server, int family, std::uint64_t resolver_id, std::size_t pool_size)
+    : server_(server), family_(family), resolver_id_(resolver_id), sockets_(std::max<std::size_t>(pool_size, 1)) {
+}
+
+std::shared_ptr<UdpSocketPool::Channel> UdpSocketPool::Impl::acquire() {
+    std::lock_guard lock(sockets_mtx_);
+    auto &slot = sockets_[next_];
+    next_ = (next_ + 1) % sockets_.size();
+
+    // A retired socket lives on until its last query releases it.
+    if (!slot || slot->assigned >= MAX_QUERIES_PER_SOCKET ||
+        std::chrono::steady_clock::now() - slot->opened >= MAX_SOCKET_AGE) {
+        slot = std::make_shared<Channel>(server_, family_, resolver_id_);
+    }
+    ++slot->assigned;
+    return slot;
+}
+
+// ===========================================================================
+//  UdpSocketPool public API
+// ===========================================================================
+
+UdpSocketPool::UdpSocketPool(const SocketAddr &server, int family, std::uint64_t resolver_id, std::size_t pool_size)
+    : impl_(std::make_unique<Impl>(server, family, resolver_id, pool_size)) {
+}
+
+UdpSocketPool::~UdpSocketPool() = default;
+
+UdpSocketPool::Reply UdpSocketPool::exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                             const Utils::CancellationToken &cancel_token) {
+    return impl_->acquire()->exchange(query, timeout, cancel_token);
+}
+
+std::expected<UdpSocketPool::Ticket, DnsErrorInfo> UdpSocketPool::send_async(
+    Reactor &reactor, std::span<std::uint8_t> query, ReplyCallback on_reply) {
+    return impl_->acquire()->send_async(reactor, query, std::move(on_reply));
+}
+
+std::size_t UdpSocketPool::socket_count() const {
+    std::lock_guard lock(impl_->sockets_mtx_);
+    return static_cast<std::size_t>(std::ranges::count_if(impl_->sockets_, [](const auto &slot) {
+        return slot != nullptr;
+    }));
+}
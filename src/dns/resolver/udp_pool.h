@@ -0,0 +1,100 @@
+//
+// Created by Kotarou on 2026/7/30.
+//
+
+#ifndef YADDNSC_DNS_UDP_POOL_H
+#define YADDNSC_DNS_UDP_POOL_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "mixin.h"
+#include "dns/dns_error_info.h"
+#include "dns/resolver/query_mux.h"
+
+class SocketAddr;
+class Reactor;
+
+namespace Utils {
+class CancellationToken;
+}
+
+/// UdpSocketPool — a few connected UDP sockets to one DNS server, shared by
+/// every query of a ClassicResolver.
+///
+/// Each socket is bound to a random source port and connected to the
+/// server, so the kernel only delivers datagrams from that server, and an
+/// ICMP port-unreachable surfaces at once as ECONNREFUSED instead of a
+/// timeout.  Any number of queries may be in flight on a socket at once;
+/// each socket is a QueryMux, which routes every datagram to its query by
+/// transaction ID and echoed question, and drops those matching none.
+///
+/// Sockets are handed out round-robin and rotated after
+/// MAX_QUERIES_PER_SOCKET queries or MAX_SOCKET_AGE, so the source port
+/// keeps changing.  A retired socket stays open until its last query
+/// finishes.
+///
+/// @note Thread-safe.
+class UdpSocketPool {
+    /// One pooled socket.
+    class Channel;
+
+public:
+    using Reply = QueryMux::Reply;
+
+    using ReplyCallback = QueryMux::ReplyCallback;
+
+    /// A query registered by send_async(); see QueryMux::Ticket.
+    using Ticket = QueryMux::Ticket;
+
+    static constexpr std::size_t DEFAULT_POOL_SIZE = 4;
+
+    static constexpr std::size_t MAX_QUERIES_PER_SOCKET = 512;
+
+    static constexpr std::chrono::seconds MAX_SOCKET_AGE{60};
+
+    /// Sockets are opened lazily, by the first queries that need them.
+    /// @param family  AF_INET or AF_INET6, matching @p server.
+    UdpSocketPool(const SocketAddr &server, int family, std::uint64_t resolver_id,
+                  std::size_t pool_size = DEFAULT_POOL_SIZE);
+
+    ~UdpSocketPool();
+
+    /// Send @p query and block until its reply arrives.
+    ///
+    /// The transaction ID of @p query is rewritten if another query on the
+    /// chosen socket already uses it, so @p query is what the reply must be
+    /// validated against.
+    /// @return The reply, or RETRY on timeout, CANCELLED, or CONNECTION.
+    /// @throws SocketException if a socket cannot be opened.
+    [[nodiscard]] Reply exchange(std::span<std::uint8_t> query, std::chrono::milliseconds timeout,
+                                 const Utils::CancellationToken &cancel_token);
+
+    /// Send @p query and call @p on_reply with its reply on @p reactor's
+    /// thread, never from within send_async().  The caller enforces its own
+    /// timeout by destroying the ticket.
+    ///
+    /// Rewrites the transaction ID of @p query as exchange() does.
+    /// Must be called on @p reactor's thread.
+    /// @return The registration, or CONNECTION if the query cannot be sent.
+    /// @throws SocketException if a socket cannot be opened.
+    [[nodiscard]] std::expected<Ticket, DnsErrorInfo> send_async(Reactor &reactor, std::span<std::uint8_t> query,
+                                                                 ReplyCallback on_reply);
+
+    /// Number of sockets currently in rotation.
+    [[nodiscard]] std::size_t socket_count() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_DNS_UDP_POOL_H
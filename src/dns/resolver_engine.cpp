@@ -0,0 +1,396 @@
+//
+// Created by Kotarou on 2026/7/29.
+//
+// Persistent query engine behind the native ResolverDispatcher: one reactor
+// thread for non-blocking resolvers, plus on-demand persistent workers with
+// long-lived cancellation pipes for blocking ones.
+//
+// Compiled when YADDNSC_USE_NATIVE_DNS=1.
+//
+
+#include "dns/resolver_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "dns/parser/parser.h"
+#include "dns/resolver/base.h"
+#include "exception/dns_lookup.h"
+#include "util/cancellation_token.hpp"
+
+#include "dns_error.h"
+
+#include "fmt.hpp"
+#include <magic_enum/magic_enum.hpp>
+#include <spdlog/spdlog.h>
+
+// ===========================================================================
+//  Anonymous namespace  —  stateless utility functions
+// ===========================================================================
+
+namespace {
+    /// Run a blocking query.
+    ///
+    /// @note  The try-catch is a safety barrier at the worker-thread
+    ///        boundary: an exception escaping here would terminate the
+    ///        process.
+    [[nodiscard]] ResolverBase::QueryResult run_blocking(const ResolverBase &resolver, const std::string &host,
+                                                         RecordKind type,
+                                                         const Utils::CancellationToken &cancel_token) {
+        try {
+            return resolver.query(host, type, cancel_token);
+        } catch (const DnsLookupException &e) {
+            return std::unexpected(DnsErrorInfo{e.get_error(), e.what()});
+        } catch (const std::exception &e) {
+            return std::unexpected(DnsErrorInfo{
+                DnsError::UNKNOWN,
+                fmt::format(R"(DNS lookup for "{}" failed: {})", host, e.what())
+            });
+        }
+    }
+
+    /// Parse a raw response and classify the result by RCODE.
+    ///
+    /// @note  The try-catch is a safety barrier at the engine boundary:
+    ///        RecordParser::parse_strings forms a deep call chain (5+ levels)
+    ///        where all errors are DnsLookupException(PARSE).
+    [[nodiscard]] ResolverEngine::Result classify(ResolverBase::QueryResult raw, const std::string &host) {
+        if (!raw) {
+            return std::unexpected(std::move(raw.error()));
+        }
+
+        try {
+            auto parsed = DNS::RecordParser::parse_strings(*raw, host);
+
+            switch (parsed.rcode) {
+                case DNS::Rcode::NOERROR:
+                    if (!parsed.records.empty()) {
+                        return ResolverEngine::Answer{
+                            std::move(parsed.records), std::move(parsed.addresses), parsed.ttl
+                        };
+                    }
+                    return std::unexpected(DnsErrorInfo{
+                        DnsError::NODATA,
+                        fmt::format(R"(DNS lookup for domain "{}" returned no records)", host),
+                        parsed.ttl
+                    });
+
+                case DNS::Rcode::NXDOMAIN:
+                    return std::unexpected(DnsErrorInfo{
+                        DnsError::NX_DOMAIN,
+                        fmt::format(R"(Domain "{}" does not exist (NXDOMAIN))", host),
+                        parsed.ttl
+                    });
+
+                case DNS::Rcode::SERVFAIL:
+                    return std::unexpected(DnsErrorInfo{
+                        DnsError::RETRY,
+                        fmt::format(R"(DNS server returned SERVFAIL for "{}")", host)
+                    });
+
+                case DNS::Rcode::REFUSED:
+                    return std::unexpected(DnsErrorInfo{
+                        DnsError::SERVER_REFUSED,
+                        fmt::format(R"(DNS server refused query for "{}")", host)
+                    });
+
+                default:
+                    return std::unexpected(DnsErrorInfo{
+                        DnsError::UNKNOWN,
+                        fmt::format(R"(DNS lookup for "{}" returned RCODE {})", host,
+                                    magic_enum::enum_name(parsed.rcode))
+                    });
+            }
+        } catch (const DnsLookupException &e) {
+            return std::unexpected(DnsErrorInfo{e.get_error(), e.what()});
+        } catch (const std::exception &e) {
+            return std::unexpected(DnsErrorInfo{
+                DnsError::UNKNOWN,
+                fmt::format(R"(DNS lookup for "{}" failed: {})", host, e.what())
+            });
+        }
+    }
+} // anonymous namespace
+
+// ===========================================================================
+//  ResolverEngine::Impl  —  private implementation
+// ===========================================================================
+
+struct ResolverEngine::Impl {
+    explicit Impl(std::size_t max_workers);
+
+    ~Impl();
+
+    /// A query that has been started and not yet delivered.
+    struct Query {
+        std::string host;
+        Callback on_done;
+        /// Null while the query runs on (or waits for) a worker.
+        std::unique_ptr<PendingQuery> pending;
+    };
+
+    /// A blocking query waiting for a worker.
+    struct Job {
+        QueryId id{0};
+        const ResolverBase *resolver{nullptr};
+        std::string host;
+        RecordKind type{RecordKind::A};
+    };
+
+    struct Worker {
+        Utils::CancellationSource cancel;
+        /// The job being run, and whether cancel was triggered for it.
+        /// Guarded by jobs_mtx_.
+        std::optional<QueryId> running;
+        bool cancelled{false};
+        /// Declared last so it is joined before the pipe is closed.
+        std::jthread thread;
+    };
+
+    QueryId start(const ResolverBase &resolver, const std::string &host, RecordKind type, Callback on_done);
+
+    void cancel(QueryId id) noexcept;
+
+    /// Deliver the result of query @p id, unless it was cancelled.
+    void complete(QueryId id, ResolverBase::QueryResult raw);
+
+    /// Queue a blocking query, spawning a worker if none is free.
+    void enqueue(Job job);
+
+    /// Remove a queued job, or wake the worker running it.
+    void cancel_job(QueryId id) noexcept;
+
+    void work(Worker &self, const std::stop_token &stop_token);
+
+    void run_loop(const std::stop_token &stop_token);
+
+    Reactor reactor_;
+    Utils::Executor executor_;
+    std::size_t max_workers_;
+
+    // ── Engine thread only ──
+    std::unordered_map<QueryId, Query> queries_;
+    QueryId next_id_{0};
+
+    // ── Worker pool ──
+    std::mutex jobs_mtx_;
+    std::condition_variable_any jobs_cv_;
+    std::deque<Job> jobs_;
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::size_t idle_workers_{0};
+    std::atomic<std::size_t> worker_count_{0};
+
+    /// Started last, once everything it touches exists.
+    std::jthread loop_;
+};
+
+ResolverEngine::Impl::Impl(std::size_t max_workers)
+    : executor_([this](std::function<void()> task) { reactor_.post(std::move(task)); }),
+      max_workers_(std::max<std::size_t>(max_workers, 1)),
+      loop_([this](const std::stop_token &stop_token) { run_loop(stop_token); }) {
+}
+
+ResolverEngine::Impl::~Impl() {
+    // Stop the loop first, so no callback runs while the rest is torn down.
+    loop_.request_stop();
+    if (loop_.joinable()) {
+        loop_.join();
+    }
+
+    {
+        std::lock_guard lock(jobs_mtx_);
+        jobs_.clear();
+        for (const auto &worker: workers_) {
+            if (worker->running) {
+                worker->cancel.trigger();
+            }
+            worker->thread.request_stop();
+        }
+    }
+    workers_.clear();
+
+    // Pending queries release their fds and timers while the reactor is
+    // still alive.
+    queries_.clear();
+}
+
+void ResolverEngine::Impl::run_loop(const std::stop_token &stop_token) {
+    while (!stop_token.stop_requested()) {
+        try {
+            reactor_.run(stop_token);
+        } catch (const std::exception &e) {
+            SPDLOG_ERROR("Resolver engine loop error: {}", e.what());
+        }
+    }
+}
+
+ResolverEngine::QueryId ResolverEngine::Impl::start(const ResolverBase &resolver, const std::string &host,
+                                                    RecordKind type, Callback on_done) {
+    const auto id = ++next_id_;
+    auto &query = queries_[id];
+    query.host = host;
+    query.on_done = std::move(on_done);
+
+    try {
+        query.pending = resolver.start_query(reactor_, host, type, [this, id](ResolverBase::QueryResult raw) {
+            complete(id, std::move(raw));
+        });
+    } catch (const std::exception &e) {
+        // Safety barrier, as in run_blocking(): report the failure later,
+        // never from within start().
+        reactor_.post([this, id, error = DnsErrorInfo{
+                           DnsError::UNKNOWN,
+                           fmt::format(R"(DNS lookup for "{}" failed: {})", host, e.what())
+                       }] {
+            complete(id, std::unexpected(error));
+        });
+        return id;
+    }
+
+    if (!query.pending) {
+        enqueue(Job{.id = id, .resolver = &resolver, .host = host, .type = type});
+    }
+    return id;
+}
+
+void ResolverEngine::Impl::cancel(QueryId id) noexcept {
+    const auto it = queries_.find(id);
+    if (it == queries_.end()) {
+        return;
+    }
+
+    const bool blocking = !it->second.pending;
+    // Destroying the PendingQuery abandons a non-blocking query.
+    queries_.erase(it);
+    if (blocking) {
+        cancel_job(id);
+    }
+}
+
+void ResolverEngine::Impl::complete(QueryId id, ResolverBase::QueryResult raw) {
+    const auto it = queries_.find(id);
+    if (it == queries_.end()) {
+        // Cancelled — a winner was already chosen.
+        return;
+    }
+
+    auto query = std::move(it->second);
+    queries_.erase(it);
+    query.on_done(classify(std::move(raw), query.host));
+}
+
+void ResolverEngine::Impl::enqueue(Job job) {
+    std::lock_guard lock(jobs_mtx_);
+    jobs_.push_back(std::move(job));
+
+    if (idle_workers_ < jobs_.size() && workers_.size() < max_workers_) {
+        auto &worker = workers_.emplace_back(std::make_unique<Worker>());
+        worker->thread = std::jthread([this, &self = *worker](const std::stop_token &stop_token) {
+            work(self, stop_token);
+        });
+        worker_count_.store(workers_.size(), std::memory_order_relaxed);
+        SPDLOG_DEBUG("Resolver engine started worker #{}", workers_.size());
+        return;
+    }
+    jobs_cv_.notify_one();
+}
+
+void ResolverEngine::Impl::cancel_job(QueryId id) noexcept {
+    std::lock_guard lock(jobs_mtx_);
+    if (const auto queued = std::ranges::find(jobs_, id, &Job::id); queued != jobs_.end()) {
+        jobs_.erase(queued);
+        return;
+    }
+
+    for (const auto &worker: workers_) {
+        if (worker->running == id && !worker->cancelled) {
+            worker->cancelled = true;
+            worker->cancel.trigger();
+            return;
+        }
+    }
+}
+
+void ResolverEngine::Impl::work(Worker &self, const std::stop_token &stop_token) {
+    const auto token = self.cancel.token();
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(jobs_mtx_);
+            ++idle_workers_;
+            const bool has_job = jobs_cv_.wait(lock, stop_token, [this] { return !jobs_.empty(); });
+            --idle_workers_;
+            if (!has_job) {
+                return;
+            }
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            self.running = job.id;
+            self.cancelled = false;
+        }
+
+        auto raw = run_blocking(*job.resolver, job.host, job.type, token);
+
+        {
+            std::lock_guard lock(jobs_mtx_);
+            self.running.reset();
+            // Clear a cancellation the resolver did not consume, so it does
+            // not abort the next job on this pipe.
+            if (self.cancelled && self.cancel.is_triggered()) {
+                token.drain();
+            }
+        }
+
+        reactor_.post([this, id = job.id, raw = std::move(raw)]() mutable { complete(id, std::move(raw)); });
+    }
+}
+
+// ===========================================================================
+//  ResolverEngine public API — thin delegation to Impl
+// ===========================================================================
+
+ResolverEngine::ResolverEngine(std::size_t max_workers) : impl_(std::make_unique<Impl>(max_workers)) {
+}
+
+ResolverEngine::~ResolverEngine() = default;
+
+void ResolverEngine::post(std::function<void()> task) {
+    impl_->reactor_.post(std::move(task));
+}
+
+const Utils::Executor &ResolverEngine::executor() const noexcept {
+    return impl_->executor_;
+}
+
+bool ResolverEngine::on_engine_thread() const noexcept {
+    return impl_->loop_.get_id() == std::this_thread::get_id();
+}
+
+std::size_t ResolverEngine::worker_count() const noexcept {
+    return impl_->worker_count_.load(std::memory_order_relaxed);
+}
+
+Reactor &ResolverEngine::reactor() noexcept {
+    return impl_->reactor_;
+}
+
+ResolverEngine::QueryId ResolverEngine::start(const ResolverBase &resolver, const std::string &host, RecordKind type,
+                                              Callback on_done) {
+    return impl_->start(resolver, host, type, std::move(on_done));
+}
+
+void ResolverEngine::cancel(QueryId id) noexcept {
+    impl_->cancel(id);
+}
+
+std::size_t ResolverEngine::pending_count() const noexcept {
+    return impl_->queries_.size();
+}
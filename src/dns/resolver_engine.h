@@ -0,0 +1,139 @@
+//
+// Created by Kotarou on 2026/7/29.
+//
+
+#ifndef YADDNSC_DNS_RESOLVER_ENGINE_H
+#define YADDNSC_DNS_RESOLVER_ENGINE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "mixin.h"
+#include "record_kind.h"
+#include "dns/dns_error_info.h"
+#include "network/inet_address.h"
+#include "network/reactor.h"
+#include "util/task.hpp"
+
+class ResolverBase;
+
+/// ResolverEngine — runs DNS queries for a ResolverDispatcher on one
+///                  persistent reactor thread.
+///
+/// Resolvers that support ResolverBase::start_query() (the native classic
+/// resolver) are driven entirely by the engine's reactor: sending to every
+/// resolver of a batch and multiplexing their replies happens on that one
+/// thread, in one poll / epoll / kqueue set.  Resolvers that can only block
+/// (DoH, DoT, test doubles) run on a small set of persistent worker
+/// threads, each with a long-lived cancellation pipe, and post their result
+/// back to the reactor.  No thread or pipe is created per query.
+///
+/// Results are parsed and classified by RCODE before they are delivered,
+/// so callers see the records (with their TTL) or a categorised
+/// DnsErrorInfo.
+///
+/// @note post(), executor() and schedule() are thread-safe; every other
+///       method must be called on the engine thread (see schedule()).
+class ResolverEngine {
+public:
+    /// The records of an answer, and how long it may be cached.
+    struct Answer {
+        std::vector<std::string> records;
+        /// The A and AAAA records among them; see DNS::FormattedResponse::addresses.
+        AddressList addresses;
+        /// Seconds; see DNS::FormattedResponse::ttl.
+        std::uint32_t ttl{0};
+    };
+
+    /// An Answer, or the categorised failure; a NX_DOMAIN or NODATA error
+    /// carries its negative TTL (DnsErrorInfo::ttl).
+    using Result = std::expected<Answer, DnsErrorInfo>;
+
+    using Callback = std::function<void(Result)>;
+
+    using QueryId = std::uint64_t;
+
+    /// Upper bound on worker threads for blocking resolvers; queries beyond
+    /// it wait for a worker to become free.
+    static constexpr std::size_t DEFAULT_MAX_WORKERS = 16;
+
+    /// Start the engine thread.  Workers are spawned on demand.
+    /// @throws std::runtime_error if the reactor cannot be created.
+    explicit ResolverEngine(std::size_t max_workers = DEFAULT_MAX_WORKERS);
+
+    /// Stop the engine and join its threads.  Queries still in flight are
+    /// abandoned; their callbacks are never called.
+    ~ResolverEngine();
+
+    // ---- thread-safe -------------------------------------------------------
+
+    /// Run @p task on the engine thread.
+    void post(std::function<void()> task);
+
+    /// An Executor that runs its work on the engine thread.
+    [[nodiscard]] const Utils::Executor &executor() const noexcept;
+
+    /// co_await to continue on the engine thread.
+    [[nodiscard]] auto schedule() const noexcept { return Utils::schedule(executor()); }
+
+    /// Whether the caller is running on the engine thread.
+    [[nodiscard]] bool on_engine_thread() const noexcept;
+
+    /// Number of worker threads spawned so far.
+    [[nodiscard]] std::size_t worker_count() const noexcept;
+
+    // ---- engine thread only ------------------------------------------------
+
+    /// The reactor that drives non-blocking queries and timers.
+    [[nodiscard]] Reactor &reactor() noexcept;
+
+    /// Query @p resolver for @p host.
+    ///
+    /// @p resolver must stay alive until the callback has run or the query
+    /// has been cancelled.
+    /// @param on_done  Called once on the engine thread, never from within
+    ///                 start(), unless the query is cancelled first.
+    /// @return An id for cancel().
+    QueryId start(const ResolverBase &resolver, const std::string &host, RecordKind type, Callback on_done);
+
+    /// Abandon a query: its callback will not be called.  A blocking
+    /// resolver's worker is woken through its cancellation pipe.  A no-op
+    /// if the query has already completed.
+    void cancel(QueryId id) noexcept;
+
+    /// Number of queries started and not yet completed or cancelled.
+    [[nodiscard]] std::size_t pending_count() const noexcept;
+
+    /// co_await start().
+    /// @return The classified result of the query.
+    [[nodiscard]] auto query(const ResolverBase &resolver, const std::string &host, RecordKind type) {
+        return Utils::await_callback<Result>([this, &resolver, &host, type](auto on_done) -> std::optional<Result> {
+            start(resolver, host, type, std::move(on_done));
+            return std::nullopt;
+        });
+    }
+
+    /// co_await a timer on the engine's reactor.
+    [[nodiscard]] auto sleep_for(std::chrono::milliseconds delay) {
+        return Utils::await_callback<bool>([this, delay](auto on_fired) -> std::optional<bool> {
+            [[maybe_unused]] auto id = reactor().add_timer(delay, [on_fired = std::move(on_fired)] { on_fired(true); });
+            return std::nullopt;
+        });
+    }
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_DNS_RESOLVER_ENGINE_H
@@ -0,0 +1,77 @@
+//
+// Created by Kotarou on 2026/8/24.
+//
+
+#include "dns/resolver_health.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "util/random.hpp"
+
+void ResolverHealth::record_success(std::uint64_t resolver_id, std::chrono::microseconds rtt) {
+    auto &[stats, recent, next] = entries_[resolver_id];
+
+    // RFC 6298 §2: SRTT <- 7/8 * SRTT + 1/8 * R', seeded by the first sample.
+    stats.srtt = stats.samples == 0 ? rtt : stats.srtt + (rtt - stats.srtt) / 8;
+    stats.error_rate *= 1.0 - ERROR_GAIN;
+    ++stats.samples;
+
+    recent[next] = rtt;
+    next = (next + 1) % WINDOW;
+}
+
+void ResolverHealth::record_failure(std::uint64_t resolver_id) {
+    auto &stats = entries_[resolver_id].stats;
+    stats.error_rate += (1.0 - stats.error_rate) * ERROR_GAIN;
+}
+
+std::optional<ResolverHealth::Stats> ResolverHealth::stats(std::uint64_t resolver_id) const {
+    const auto it = entries_.find(resolver_id);
+    if (it == entries_.end()) {
+        return std::nullopt;
+    }
+    return it->second.stats;
+}
+
+double ResolverHealth::score(std::uint64_t resolver_id) const {
+    const auto it = entries_.find(resolver_id);
+    if (it == entries_.end()) {
+        return 0.0;
+    }
+
+    const auto &stats = it->second.stats;
+    // A resolver that has only ever failed is as slow as a hedge can wait.
+    const auto rtt = stats.samples > 0
+                         ? std::chrono::duration<double, std::milli>(stats.srtt)
+                         : std::chrono::duration<double, std::milli>(MAX_HEDGE_DELAY);
+    return rtt.count() * (1.0 + ERROR_PENALTY * stats.error_rate);
+}
+
+std::chrono::milliseconds ResolverHealth::hedge_delay(std::uint64_t resolver_id) const {
+    const auto it = entries_.find(resolver_id);
+    if (it == entries_.end() || it->second.stats.samples < MIN_SAMPLES) {
+        return DEFAULT_HEDGE_DELAY;
+    }
+
+    const auto count = std::min(it->second.stats.samples, WINDOW);
+    std::array<std::chrono::microseconds, WINDOW> rtts{};
+    std::copy_n(it->second.recent.begin(), count, rtts.begin());
+
+    const auto rank = static_cast<std::size_t>(std::ceil(HEDGE_PERCENTILE * static_cast<double>(count))) - 1;
+    std::nth_element(rtts.begin(), rtts.begin() + static_cast<std::ptrdiff_t>(rank),
+                     rtts.begin() + static_cast<std::ptrdiff_t>(count));
+
+    return std::clamp(std::chrono::ceil<std::chrono::milliseconds>(rtts[rank]), MIN_HEDGE_DELAY, MAX_HEDGE_DELAY);
+}
+
+std::vector<std::size_t> ResolverHealth::rank(std::span<const std::uint64_t> resolver_ids) const {
+    std::vector<std::size_t> order(resolver_ids.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+
+    // Shuffle first so ties spread the load instead of favouring config order.
+    std::shuffle(order.begin(), order.end(), Utils::Random::engine());
+    std::ranges::stable_sort(order, {}, [this, resolver_ids](std::size_t idx) { return score(resolver_ids[idx]); });
+    return order;
+}
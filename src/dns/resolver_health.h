@@ -0,0 +1,90 @@
+//
+// Created by Kotarou on 2026/8/24.
+//
+
+#ifndef YADDNSC_DNS_RESOLVER_HEALTH_H
+#define YADDNSC_DNS_RESOLVER_HEALTH_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+/// ResolverHealth — how fast and how reliable each resolver has recently
+/// been, keyed by ResolverBase::get_id().
+///
+/// A resolver's RTT is smoothed as in RFC 6298 (gain 1/8), and its error
+/// rate is an exponentially weighted average of its outcomes.  Its score is
+/// the smoothed RTT inflated by the error rate: the lower, the better.  A
+/// resolver that has never answered scores 0 so that it gets measured.
+///
+/// The last WINDOW RTTs are kept as well: the hedge delay of a resolver —
+/// how long to wait for it before asking the next one — is the
+/// HEDGE_PERCENTILE of those, so hedges go out only for its slowest answers.
+///
+/// @note Not thread-safe; the dispatcher uses it on its engine thread only.
+class ResolverHealth {
+public:
+    /// Number of recent RTTs the hedge delay is taken from.
+    static constexpr std::size_t WINDOW = 32;
+
+    /// RTTs needed before the hedge delay follows the percentile rather than
+    /// DEFAULT_HEDGE_DELAY.
+    static constexpr std::size_t MIN_SAMPLES = 4;
+
+    /// Percentile of the recent RTTs that the hedge delay is set to.
+    static constexpr double HEDGE_PERCENTILE = 0.95;
+
+    static constexpr std::chrono::milliseconds DEFAULT_HEDGE_DELAY{100};
+    static constexpr std::chrono::milliseconds MIN_HEDGE_DELAY{5};
+    static constexpr std::chrono::milliseconds MAX_HEDGE_DELAY{1000};
+
+    /// Weight of the latest outcome in the error rate.
+    static constexpr double ERROR_GAIN = 0.2;
+
+    /// How much a resolver that always fails is penalised: its score is its
+    /// RTT times (1 + ERROR_PENALTY * error rate).
+    static constexpr double ERROR_PENALTY = 10.0;
+
+    struct Stats {
+        std::chrono::microseconds srtt{0};
+        double error_rate{0.0};
+        /// Number of RTTs measured so far.
+        std::size_t samples{0};
+    };
+
+    /// Record an answer (including NXDOMAIN and NODATA) that took @p rtt.
+    void record_success(std::uint64_t resolver_id, std::chrono::microseconds rtt);
+
+    /// Record a query that failed without an answer (timeout, SERVFAIL, ...).
+    void record_failure(std::uint64_t resolver_id);
+
+    /// The stats of a resolver, or std::nullopt if nothing is recorded.
+    [[nodiscard]] std::optional<Stats> stats(std::uint64_t resolver_id) const;
+
+    /// Expected cost of querying a resolver, in milliseconds; lower is better.
+    [[nodiscard]] double score(std::uint64_t resolver_id) const;
+
+    /// How long to wait for a resolver before hedging to the next one.
+    [[nodiscard]] std::chrono::milliseconds hedge_delay(std::uint64_t resolver_id) const;
+
+    /// Indices into @p resolver_ids, best score first.  Resolvers with equal
+    /// scores (e.g. all unmeasured) come in random order.
+    [[nodiscard]] std::vector<std::size_t> rank(std::span<const std::uint64_t> resolver_ids) const;
+
+private:
+    struct Entry {
+        Stats stats;
+        /// Ring buffer of the last WINDOW RTTs.
+        std::array<std::chrono::microseconds, WINDOW> recent{};
+        std::size_t next{0};
+    };
+
+    std::unordered_map<std::uint64_t, Entry> entries_;
+};
+
+#endif // YADDNSC_DNS_RESOLVER_HEALTH_H
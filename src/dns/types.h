@@ -10,6 +10,8 @@
 #include <string>
 #include <vector>
 
+#include "network/inet_address.h"
+
 namespace DNS {
     // =============================================================================
     // DNS wire-format type constants (RFC 1035, RFC 6891)
@@ -18,6 +20,10 @@ namespace DNS {
     /// Size of the DNS header in wire format (RFC 1035 §4.1.1).
     constexpr size_t HEADER_SIZE = 12;
 
+    /// Size of the length prefix of a message sent over TCP (RFC 1035
+    /// §4.2.2) or TLS (RFC 7858 §3.3).
+    constexpr size_t LENGTH_PREFIX_SIZE = 2;
+
     /// DNS record types.
     enum class RecordType : std::uint16_t {
         A = 1,
@@ -131,6 +137,8 @@ namespace DNS {
     struct ParsedResponse {
         Rcode rcode{Rcode::NOERROR};
         std::vector<ResourceRecord> answers;
+        /// Seconds the response may be cached; see FormattedResponse::ttl.
+        std::uint32_t ttl{0};
     };
 
     /// Convenience result from RecordParser::parse_strings, with
@@ -138,6 +146,14 @@ namespace DNS {
     struct FormattedResponse {
         Rcode rcode{Rcode::NOERROR};
         std::vector<std::string> records;
+        /// The A and AAAA records among them, decoded from their RDATA.
+        AddressList addresses;
+        /// Seconds the response may be cached: the lowest TTL of the answer
+        /// records or, for NXDOMAIN and NODATA, the negative TTL of the SOA
+        /// in the authority section (RFC 2308 §5).  0 when it must not be
+        /// cached (an error RCODE, or a negative answer without an SOA).
+        /// The deprecated system parser always leaves it 0.
+        std::uint32_t ttl{0};
     };
 } // namespace DNS
 
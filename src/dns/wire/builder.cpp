@@ -4,10 +4,13 @@
 
 #include "dns/wire/builder.h"
 
+#include "dns/wire/name.h"
+#include "util/bytes.hpp"
 #include "util/random.hpp"
 
 #include "exception/dns_packet.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "fmt.hpp"
@@ -18,83 +21,40 @@ namespace DNS {
     // ===========================================================================
 
     namespace {
+        // Writes a message front to back into a buffer sized for it up front
+        // (QueryBuilder::size()), so no write is bounds-checked.
         class WireWriter {
         public:
-            WireWriter() {
-                buf_.reserve(512);
+            explicit WireWriter(std::span<std::uint8_t> out) noexcept : out_(out) {
             }
 
-            void write_uint16(std::uint16_t v) {
-                buf_.push_back(static_cast<std::uint8_t>(v >> 8));
-                buf_.push_back(static_cast<std::uint8_t>(v & 0xFF));
+            void write_uint16(std::uint16_t v) noexcept {
+                Utils::Bytes::write_u16_be(out_.data() + pos_, v);
+                pos_ += 2;
             }
 
-            void write_uint32(std::uint32_t v) {
-                buf_.push_back(static_cast<std::uint8_t>(v >> 24));
-                buf_.push_back(static_cast<std::uint8_t>(v >> 16));
-                buf_.push_back(static_cast<std::uint8_t>(v >> 8));
-                buf_.push_back(static_cast<std::uint8_t>(v & 0xFF));
+            void write_uint32(std::uint32_t v) noexcept {
+                Utils::Bytes::write_u32_be(out_.data() + pos_, v);
+                pos_ += 4;
             }
 
             // Encode a domain name into DNS label sequence (RFC 1035 §4.1.2).
             //
-            // Throws DnsLookupException if:
+            // Throws DnsPacketException if:
             //   - any label exceeds 63 octets
             //   - the encoded name exceeds 255 octets
             void encode_name(std::string_view name) {
-                if (name.empty() || name == ".") {
-                    // Root label only — empty name or bare dot represents the root.
-                    buf_.push_back(0);
-                    return;
-                }
-
-                // Pre-compute the total encoded length to validate early.
-                // Encoded size = sum(label_len + 1) per label + 1 (terminating zero).
-                // For names without a trailing dot this equals name.size() + 2;
-                // for names with a trailing dot it equals name.size() + 1 (the trailing
-                // dot is consumed and its length byte coincides with the terminator).
-                const bool trailing_dot = name.back() == '.';
-                const size_t encoded_size = name.size() + (trailing_dot ? 1 : 2);
-                if (encoded_size > 255) {
-                    throw DnsPacketException(
-                        fmt::format("Domain name \"{}\" is too long ({} octets, max 255)", name, encoded_size)
-                    );
-                }
-
-                size_t pos = 0;
-                while (pos < name.size()) {
-                    auto dot = name.find('.', pos);
-                    if (dot == std::string::npos) {
-                        dot = name.size();
-                    }
-
-                    const auto label_len = static_cast<std::uint8_t>(dot - pos);
-                    if (label_len > 63) {
-                        throw DnsPacketException(
-                            fmt::format("Label too long in domain name \"{}\" at offset {}", name, pos)
-                        );
-                    }
-
-                    buf_.push_back(label_len);
-                    for (size_t i = 0; i < label_len; ++i) {
-                        buf_.push_back(static_cast<std::uint8_t>(name[pos + i]));
-                    }
-                    pos = dot + 1;
-                }
-
-                buf_.push_back(0); // Root label (terminator).
+                pos_ += DNS::encode_name(name, out_.subspan(pos_));
             }
 
-            void write_bytes(std::span<const std::uint8_t> bytes) {
-                buf_.insert(buf_.end(), bytes.begin(), bytes.end());
-            }
-
-            [[nodiscard]] std::vector<std::uint8_t> finish() && {
-                return std::move(buf_);
+            void write_bytes(std::span<const std::uint8_t> bytes) noexcept {
+                std::ranges::copy(bytes, out_.begin() + static_cast<std::ptrdiff_t>(pos_));
+                pos_ += bytes.size();
             }
 
         private:
-            std::vector<std::uint8_t> buf_;
+            std::span<std::uint8_t> out_;
+            std::size_t pos_{0};
         };
 
         // Bit positions in the 16-bit DNS flags field (RFC 1035 §4.1.1).
@@ -107,6 +67,15 @@ namespace DNS {
         // EDNS0 OPT record constants (RFC 6891).
         constexpr std::uint16_t OPT_RR_TYPE = 41;
 
+        // QTYPE (2) + QCLASS (2), after the QNAME.
+        constexpr std::size_t QUESTION_FIXED_SIZE = 4;
+
+        // Root NAME (1) + TYPE (2) + CLASS (2) + TTL (4) + RDLENGTH (2).
+        constexpr std::size_t OPT_FIXED_SIZE = 11;
+
+        // OPTION-CODE (2) + OPTION-LENGTH (2), ahead of each option's data.
+        constexpr std::size_t OPTION_HEADER_SIZE = 4;
+
         /// Build the 16-bit DNS header flags field (RFC 1035 §4.1.1).
         /// @param qr      QR flag (0 = query, 1 = response).
         /// @param opcode  Operation code (4 bits, typically 0 = QUERY).
@@ -204,11 +173,66 @@ namespace DNS {
     }
 
     std::vector<std::uint8_t> QueryBuilder::build() const {
+        std::vector<std::uint8_t> packet(size());
+        static_cast<void>(build_into(packet));
+        return packet;
+    }
+
+    std::size_t QueryBuilder::size() const noexcept {
+        std::size_t size = HEADER_SIZE;
+        for (const auto &q: questions_) {
+            size += encoded_name_size(q.qname) + QUESTION_FIXED_SIZE;
+        }
+        if (edns_.has_value()) {
+            size += OPT_FIXED_SIZE;
+            for (const auto &opt: edns_->options) {
+                size += OPTION_HEADER_SIZE + opt.data.size();
+            }
+        }
+        return size;
+    }
+
+    std::span<std::uint8_t> QueryBuilder::build_into(std::span<std::uint8_t> out, Framing framing) const {
         if (questions_.empty()) {
             throw DnsPacketException("Query must have at least one question");
         }
 
-        WireWriter w;
+        if (edns_.has_value()) {
+            // RFC 6891 §4: EDNS version MUST be 0.
+            if (edns_->version != 0) {
+                throw DnsPacketException(
+                    fmt::format("EDNS version {} is not supported (only version 0 is valid)",
+                                static_cast<unsigned>(edns_->version))
+                );
+            }
+
+            // RFC 6891 §6.1: UDP payload size MUST be ≥ 512.
+            if (edns_->udp_payload_size < 512) {
+                throw DnsPacketException(
+                    fmt::format("EDNS UDP payload size {} is too small (minimum 512)", edns_->udp_payload_size)
+                );
+            }
+        }
+
+        const auto message_size = size();
+        const auto prefix_size = framing == Framing::LENGTH_PREFIXED ? LENGTH_PREFIX_SIZE : 0;
+        if (prefix_size != 0 && message_size > 0xFFFF) {
+            throw DnsPacketException(
+                fmt::format("Message of {} octets is too long for a length prefix", message_size)
+            );
+        }
+        if (out.size() < prefix_size + message_size) {
+            throw DnsPacketException(
+                fmt::format("Buffer of {} octets is too small for a {}-octet message", out.size(),
+                            prefix_size + message_size)
+            );
+        }
+
+        out = out.first(prefix_size + message_size);
+        if (prefix_size != 0) {
+            Utils::Bytes::write_u16_be(out, static_cast<std::uint16_t>(message_size));
+        }
+        WireWriter w(out.subspan(prefix_size));
 
         const auto qdcount = static_cast<std::uint16_t>(questions_.size());
         const auto arcount = edns_.has_value() ? static_cast<std::uint16_t>(1) : std::uint16_t{0};
@@ -232,21 +256,6 @@ namespace DNS {
         if (edns_.has_value()) {
             const auto &edns = *edns_;
 
-            // RFC 6891 §4: EDNS version MUST be 0.
-            if (edns.version != 0) {
-                throw DnsPacketException(
-                    fmt::format("EDNS version {} is not supported (only version 0 is valid)",
-                                static_cast<unsigned>(edns.version))
-                );
-            }
-
-            // RFC 6891 §6.1: UDP payload size MUST be ≥ 512.
-            if (edns.udp_payload_size < 512) {
-                throw DnsPacketException(
-                    fmt::format("EDNS UDP payload size {} is too small (minimum 512)", edns.udp_payload_size)
-                );
-            }
-
             // Name: root (single zero byte).
             w.encode_name("");
 
@@ -271,7 +280,7 @@ namespace DNS {
             // Compute total option data size.
             std::uint16_t rdlength = 0;
             for (const auto &opt: edns.options) {
-                rdlength += static_cast<std::uint16_t>(4 + opt.data.size());
+                rdlength += static_cast<std::uint16_t>(OPTION_HEADER_SIZE + opt.data.size());
             }
             w.write_uint16(rdlength);
 
@@ -283,6 +292,31 @@ namespace DNS {
             }
         }
 
-        return std::move(w).finish();
+        return out;
+    }
+
+    // ===========================================================================
+    //  Name encoding errors (dns/wire/name.h)
+    // ===========================================================================
+
+    void detail::throw_name_too_long(std::string_view name, std::size_t encoded_size) {
+        throw DnsPacketException(
+            fmt::format("Domain name \"{}\" is too long ({} octets, max {})", name, encoded_size, MAX_NAME_SIZE)
+        );
+    }
+
+    void detail::throw_empty_label(std::string_view name, std::size_t offset) {
+        throw DnsPacketException(fmt::format("Empty label in domain name \"{}\" at offset {}", name, offset));
+    }
+
+    void detail::throw_label_too_long(std::string_view name, std::size_t offset) {
+        throw DnsPacketException(fmt::format("Label too long in domain name \"{}\" at offset {}", name, offset));
+    }
+
+    void detail::throw_name_buffer_too_small(std::string_view name, std::size_t encoded_size, std::size_t available) {
+        throw DnsPacketException(
+            fmt::format("Buffer of {} octets is too small for domain name \"{}\" ({} octets)", available, name,
+                        encoded_size)
+        );
     }
 } // namespace DNS
@@ -5,6 +5,7 @@
 #ifndef YADDNSC_DNS_WIRE_BUILDER_H
 #define YADDNSC_DNS_WIRE_BUILDER_H
 
+#include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <span>
@@ -15,6 +16,15 @@
 #include "dns/types.h"
 
 namespace DNS {
+    /// How a message is laid out in the buffer it is built into.
+    enum class Framing : std::uint8_t {
+        /// The message alone, as sent over UDP or HTTPS.
+        NONE,
+        /// The message preceded by its 2-octet length, as sent over TCP
+        /// (RFC 1035 §4.2.2) or TLS (RFC 7858 §3.3).
+        LENGTH_PREFIXED,
+    };
+
     /// Fluent DNS packet builder (wire format, RFC 1035).
     ///
     /// Constructs arbitrary DNS query/update packets with full control over
@@ -29,6 +39,14 @@ namespace DNS {
     ///       .build();
     /// @endcode
     ///
+    /// Or, with no allocation, into a caller buffer behind a TCP length prefix:
+    /// @code
+    ///   std::array<std::uint8_t, 512> buf;
+    ///   auto framed = QueryBuilder{}
+    ///       .add_question("example.com", RecordType::A)
+    ///       .build_into(buf, Framing::LENGTH_PREFIXED);
+    /// @endcode
+    ///
     /// For full control:
     /// @code
     ///   auto packet = QueryBuilder{}
@@ -117,6 +135,22 @@ namespace DNS {
         ///         EDNS version != 0, UDP payload size < 512).
         [[nodiscard]] std::vector<std::uint8_t> build() const;
 
+        /// Size of the message build() produces, in octets, without the
+        /// length prefix of Framing::LENGTH_PREFIXED.  The names are not
+        /// validated.
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /// Write the message to the front of @p out, behind a 2-octet
+        /// length prefix if @p framing asks for one.
+        ///
+        /// Nothing is allocated: a caller-owned (e.g. stack) buffer can be
+        /// handed straight to the transport.
+        ///
+        /// @return The octets written, prefix included.
+        /// @throws DnsPacketException as build() does, or if @p out is
+        ///         shorter than size() (plus LENGTH_PREFIX_SIZE if framed).
+        std::span<std::uint8_t> build_into(std::span<std::uint8_t> out, Framing framing = Framing::NONE) const;
+
     private:
         struct EdnsConfig {
             std::uint16_t udp_payload_size;
@@ -0,0 +1,143 @@
+//
+// Created by Kotarou on 2026/9/2.
+//
+
+#ifndef YADDNSC_DNS_WIRE_NAME_H
+#define YADDNSC_DNS_WIRE_NAME_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "util/byte_scan.hpp"
+
+namespace DNS {
+    // =============================================================================
+    // Domain name encoding (RFC 1035 §3.1, §4.1.2)
+    // =============================================================================
+
+    /// Longest encoded domain name, terminator included (RFC 1035 §2.3.4).
+    constexpr std::size_t MAX_NAME_SIZE = 255;
+
+    /// Longest label (RFC 1035 §2.3.4).
+    constexpr std::size_t MAX_LABEL_SIZE = 63;
+
+    namespace detail {
+        /// Throw DnsPacketException for a name longer than MAX_NAME_SIZE.
+        [[noreturn]] void throw_name_too_long(std::string_view name, std::size_t encoded_size);
+
+        /// Throw DnsPacketException for an empty label ("a..b", ".a").
+        [[noreturn]] void throw_empty_label(std::string_view name, std::size_t offset);
+
+        /// Throw DnsPacketException for a label longer than MAX_LABEL_SIZE.
+        [[noreturn]] void throw_label_too_long(std::string_view name, std::size_t offset);
+
+        /// Throw DnsPacketException for an output buffer too small for the name.
+        [[noreturn]] void throw_name_buffer_too_small(std::string_view name, std::size_t encoded_size,
+                                                      std::size_t available);
+    } // namespace detail
+
+    /// Size of @p name once encoded as a label sequence, terminator included.
+    ///
+    /// An empty name and a bare dot are the root (one octet).  Otherwise a
+    /// name takes one length octet per label plus the terminator, which is
+    /// name.size() + 2, or name.size() + 1 with a trailing dot (its length
+    /// octet is the terminator).  The name is not validated.
+    [[nodiscard]] constexpr std::size_t encoded_name_size(std::string_view name) noexcept {
+        if (name.empty() || name == ".") {
+            return 1;
+        }
+        return name.size() + (name.back() == '.' ? 1 : 2);
+    }
+
+    /// Encode @p name as a label sequence at the front of @p out.
+    ///
+    /// The dots are found with Utils::ByteScan, a block of bytes at a time,
+    /// and each label is then copied whole.  Usable in constant expressions
+    /// (byte by byte): an invalid name then fails to compile.
+    ///
+    /// @return The encoded_name_size(name) octets written.
+    /// @throws DnsPacketException if the name exceeds MAX_NAME_SIZE octets, a
+    ///         label is empty or exceeds MAX_LABEL_SIZE, or @p out is too small.
+    constexpr std::size_t encode_name(std::string_view name, std::span<std::uint8_t> out) {
+        const auto encoded_size = encoded_name_size(name);
+        if (encoded_size > MAX_NAME_SIZE) {
+            detail::throw_name_too_long(name, encoded_size);
+        }
+        if (out.size() < encoded_size) {
+            detail::throw_name_buffer_too_small(name, encoded_size, out.size());
+        }
+        if (encoded_size == 1) {
+            out[0] = 0;
+            return 1;
+        }
+
+        // Where each label ends: at a dot, or at the end of the name.
+        std::array<std::uint16_t, MAX_NAME_SIZE> ends;
+        std::size_t count = 0;
+        if consteval {
+            count = Utils::ByteScan::Scalar::find_all(name, '.', ends);
+        } else {
+            count = Utils::ByteScan::find_all(name, '.', ends);
+        }
+        if (name.back() != '.') {
+            ends[count++] = static_cast<std::uint16_t>(name.size());
+        }
+
+        std::size_t written = 0;
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t label_len = ends[i] - pos;
+            if (label_len == 0) {
+                detail::throw_empty_label(name, pos);
+            }
+            if (label_len > MAX_LABEL_SIZE) {
+                detail::throw_label_too_long(name, pos);
+            }
+
+            out[written++] = static_cast<std::uint8_t>(label_len);
+            if consteval {
+                for (std::size_t j = 0; j < label_len; ++j) {
+                    out[written + j] = static_cast<std::uint8_t>(name[pos + j]);
+                }
+            } else {
+                std::memcpy(out.data() + written, name.data() + pos, label_len);
+            }
+            written += label_len;
+            pos = ends[i] + 1;
+        }
+
+        out[written++] = 0; // Root label (terminator).
+        return written;
+    }
+
+    /// A domain name encoded at compile time; see encode_name_literal().
+    template<std::size_t Capacity>
+    struct EncodedName {
+        std::array<std::uint8_t, Capacity> octets{};
+        std::size_t size{0};
+
+        /// The encoded label sequence.
+        [[nodiscard]] constexpr std::span<const std::uint8_t> bytes() const noexcept {
+            return std::span(octets).first(size);
+        }
+    };
+
+    /// Encode a string literal name at compile time.
+    ///
+    /// @code
+    ///   constexpr auto name = DNS::encode_name_literal("example.com");
+    ///   static_assert(name.size == 13);
+    /// @endcode
+    template<std::size_t N>
+    consteval EncodedName<N + 1> encode_name_literal(const char (&name)[N]) {
+        EncodedName<N + 1> encoded;
+        encoded.size = encode_name(std::string_view(name, N - 1), encoded.octets);
+        return encoded;
+    }
+} // namespace DNS
+
+#endif  // YADDNSC_DNS_WIRE_NAME_H
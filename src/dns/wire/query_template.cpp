@@ -0,0 +1,122 @@
+//
+// Created by Kotarou on 2026/8/31.
+//
+
+#include "dns/wire/query_template.h"
+
+#include <algorithm>
+
+#include "exception/dns_packet.h"
+#include "util/bytes.hpp"
+#include "util/random.hpp"
+
+#include "fmt.hpp"
+
+namespace {
+    /// EDNS0 Padding option code (RFC 7830 §4).
+    constexpr std::uint16_t PADDING_OPTION_CODE = 12;
+
+    /// OPTION-CODE (2) + OPTION-LENGTH (2), ahead of the padding octets.
+    constexpr std::size_t PADDING_OPTION_HEADER = 4;
+} // anonymous namespace
+
+// =============================================================================
+// QueryTemplate
+// =============================================================================
+
+DNS::QueryTemplate::QueryTemplate(std::string_view host, RecordType type) : QueryTemplate(host, type, Layout{}) {
+}
+
+DNS::QueryTemplate::QueryTemplate(std::string_view host, RecordType type, const Layout &layout)
+    : wire_(QueryBuilder{}.id(0).add_question(host, type).add_edns(layout.udp_payload_size).build()) {
+    if (layout.pad_block == 0) {
+        return;
+    }
+
+    // The OPT record comes last and has no options yet, so its RDLENGTH is
+    // the final two octets: the padding option is appended after them.
+    padding_ = layout.pad_block - (wire_.size() + PADDING_OPTION_HEADER) % layout.pad_block;
+    const auto rdlength = wire_.size() - 2;
+    Utils::Bytes::write_u16_be(wire_, rdlength, static_cast<std::uint16_t>(PADDING_OPTION_HEADER + padding_));
+
+    wire_.reserve(wire_.size() + PADDING_OPTION_HEADER + padding_);
+    wire_.resize(wire_.size() + PADDING_OPTION_HEADER);
+    Utils::Bytes::write_u16_be(wire_, wire_.size() - 4, PADDING_OPTION_CODE);
+    Utils::Bytes::write_u16_be(wire_, wire_.size() - 2, static_cast<std::uint16_t>(padding_));
+    wire_.resize(wire_.size() + padding_, 0);
+}
+
+std::span<std::uint8_t> DNS::QueryTemplate::write_to(std::span<std::uint8_t> out, std::uint16_t id,
+                                                     Framing framing) const {
+    const auto prefix_size = framing == Framing::LENGTH_PREFIXED ? LENGTH_PREFIX_SIZE : 0;
+    if (out.size() < prefix_size + wire_.size()) {
+        throw DnsPacketException(
+            fmt::format("Buffer of {} octets is too small for a {}-octet query", out.size(),
+                        prefix_size + wire_.size())
+        );
+    }
+
+    out = out.first(prefix_size + wire_.size());
+    if (prefix_size != 0) {
+        Utils::Bytes::write_u16_be(out, static_cast<std::uint16_t>(wire_.size()));
+    }
+    const auto message = out.subspan(prefix_size);
+    std::ranges::copy(wire_, message.begin());
+    Utils::Bytes::write_u16_be(message, id);
+
+    // Padding octets SHOULD be unpredictable (RFC 7830 §3); four per draw.
+    auto &engine = Utils::Random::engine();
+    const auto padding = message.last(padding_);
+    std::uint32_t bits = 0;
+    for (std::size_t i = 0; i < padding.size(); ++i) {
+        if (i % 4 == 0) {
+            bits = engine();
+        }
+        padding[i] = static_cast<std::uint8_t>(bits >> (8 * (i % 4)));
+    }
+    return out;
+}
+
+std::span<std::uint8_t> DNS::QueryTemplate::write_to(std::span<std::uint8_t> out, Framing framing) const {
+    return write_to(out, static_cast<std::uint16_t>(Utils::Random::engine()() & 0xFFFF), framing);
+}
+
+std::vector<std::uint8_t> DNS::QueryTemplate::build() const {
+    std::vector<std::uint8_t> packet(wire_.size());
+    static_cast<void>(write_to(packet));
+    return packet;
+}
+
+// =============================================================================
+// QueryTemplateCache
+// =============================================================================
+
+std::shared_ptr<const DNS::QueryTemplate> DNS::QueryTemplateCache::get(const std::string &host, RecordType type) {
+    std::lock_guard lock(mutex_);
+    const auto it = templates_.find(host);
+    if (it != templates_.end()) {
+        for (const auto &[cached_type, cached]: it->second) {
+            if (cached_type == type) {
+                return cached;
+            }
+        }
+    }
+
+    auto built = std::make_shared<const QueryTemplate>(host, type, layout_);
+    if (size_ < MAX_ENTRIES) {
+        templates_[host].emplace_back(type, built);
+        ++size_;
+    }
+    return built;
+}
+
+std::size_t DNS::QueryTemplateCache::size() const {
+    std::lock_guard lock(mutex_);
+    return size_;
+}
+
+void DNS::QueryTemplateCache::clear() {
+    std::lock_guard lock(mutex_);
+    templates_.clear();
+    size_ = 0;
+}
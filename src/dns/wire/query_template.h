@@ -0,0 +1,158 @@
+//
+// Created by Kotarou on 2026/8/31.
+//
+
+#ifndef YADDNSC_DNS_WIRE_QUERY_TEMPLATE_H
+#define YADDNSC_DNS_WIRE_QUERY_TEMPLATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "dns/types.h"
+#include "dns/wire/builder.h"
+#include "dns/wire/name.h"
+
+namespace DNS {
+    // =============================================================================
+    // QueryTemplate — a query encoded once, sent many times
+    // =============================================================================
+
+    /// A standard recursive query for one name and record type, with EDNS0
+    /// (RFC 6891) and optionally EDNS0 padding (RFC 7830), encoded once.
+    ///
+    /// Queries for the same name and type differ only in their transaction
+    /// ID and, when padded, in the padding octets.  The template holds the
+    /// encoded message and stamps out each query by copying it and patching
+    /// those two fields, so the name is validated and label-encoded once
+    /// rather than on every lookup.
+    ///
+    /// The message is the one QueryBuilder produces for
+    /// @code
+    ///   QueryBuilder{}
+    ///       .add_question(host, type)
+    ///       .add_edns(layout.udp_payload_size, 0, false, padding)
+    ///       .build();
+    /// @endcode
+    /// with padding sized to bring the message to the next multiple of
+    /// layout.pad_block octets.
+    class QueryTemplate {
+    public:
+        /// What besides the question the query carries.
+        struct Layout {
+            /// EDNS0 UDP payload size (RFC 6891 §6.2.3).  1232 is the value
+            /// RFC 9267 §2 recommends; see build_query().
+            std::uint16_t udp_payload_size{1232};
+
+            /// Pad the message to a multiple of this many octets with the
+            /// EDNS0 Padding option (RFC 7830); 0 for no padding.  A message
+            /// that is already a multiple gains a whole block, as the option
+            /// always carries at least one octet.
+            std::size_t pad_block{0};
+
+            bool operator==(const Layout &) const = default;
+        };
+
+        /// Encode the query for @p host and @p type, unpadded, with the
+        /// default UDP payload size.
+        /// @throws DnsPacketException if @p host is not a valid domain name.
+        QueryTemplate(std::string_view host, RecordType type);
+
+        /// Encode the query for @p host and @p type as @p layout says.
+        /// @throws DnsPacketException if @p host is not a valid domain name.
+        QueryTemplate(std::string_view host, RecordType type, const Layout &layout);
+
+        /// Size of every query made from the template, in octets.
+        [[nodiscard]] std::size_t size() const noexcept {
+            return wire_.size();
+        }
+
+        /// Number of padding octets at the end of the message.
+        [[nodiscard]] std::size_t padding() const noexcept {
+            return padding_;
+        }
+
+        /// Write the query, with transaction ID @p id and fresh random padding
+        /// octets, to the front of @p out, behind a 2-octet length prefix if
+        /// @p framing asks for one.
+        /// @return The octets written, prefix included.
+        /// @throws DnsPacketException if @p out is shorter than size() (plus
+        ///         LENGTH_PREFIX_SIZE if framed).
+        std::span<std::uint8_t> write_to(std::span<std::uint8_t> out, std::uint16_t id,
+                                         Framing framing = Framing::NONE) const;
+
+        /// write_to() with a random transaction ID.
+        std::span<std::uint8_t> write_to(std::span<std::uint8_t> out, Framing framing = Framing::NONE) const;
+
+        /// Largest size() of a template made with @p layout, that of the
+        /// longest name: a buffer this large (plus LENGTH_PREFIX_SIZE if
+        /// framed) takes any query with that layout.
+        [[nodiscard]] static constexpr std::size_t max_size(const Layout &layout) noexcept {
+            // Header, question with the longest QNAME, then an option-less OPT.
+            constexpr std::size_t unpadded = HEADER_SIZE + MAX_NAME_SIZE + 4 + 11;
+            if (layout.pad_block == 0) {
+                return unpadded;
+            }
+            // The Padding option header, then at least one padding octet.
+            return ((unpadded + 4) / layout.pad_block + 1) * layout.pad_block;
+        }
+
+        /// The query, with a random transaction ID, in a new buffer.
+        [[nodiscard]] std::vector<std::uint8_t> build() const;
+
+    private:
+        /// The message with ID 0 and zeroed padding.
+        std::vector<std::uint8_t> wire_;
+        std::size_t padding_{0};
+    };
+
+    // =============================================================================
+    // QueryTemplateCache — templates by name and type
+    // =============================================================================
+
+    /// The QueryTemplate of each name and record type a resolver is asked
+    /// for, built on first use.
+    ///
+    /// The names a DDNS client looks up are fixed by its configuration, so
+    /// the cache quickly holds all of them.  Beyond MAX_ENTRIES templates
+    /// (a CLI lookup of arbitrary names, say) new ones are built for one
+    /// query and not kept.
+    ///
+    /// @note Thread-safe.  A template stays valid for as long as the caller
+    ///       holds it, even once the cache is cleared.
+    class QueryTemplateCache {
+    public:
+        static constexpr std::size_t MAX_ENTRIES = 256;
+
+        explicit QueryTemplateCache(QueryTemplate::Layout layout = {}) : layout_(layout) {
+        }
+
+        /// The template for @p host and @p type.
+        /// @throws DnsPacketException if @p host is not a valid domain name.
+        [[nodiscard]] std::shared_ptr<const QueryTemplate> get(const std::string &host, RecordType type);
+
+        /// Number of templates kept.
+        [[nodiscard]] std::size_t size() const;
+
+        /// Drop every template.
+        void clear();
+
+    private:
+        QueryTemplate::Layout layout_;
+
+        mutable std::mutex mutex_;
+        // By host, then by type: a lookup needs no key built from the two.
+        std::unordered_map<std::string, std::vector<std::pair<RecordType, std::shared_ptr<const QueryTemplate> > > >
+        templates_;
+        std::size_t size_{0};
+    };
+} // namespace DNS
+
+#endif  // YADDNSC_DNS_WIRE_QUERY_TEMPLATE_H
@@ -0,0 +1,475 @@
+//
+// Created by Kotarou on 2026/8/9.
+//
+#include "hpack.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace {
+
+using Http::Error;
+using Http::Hpack::Header;
+
+// ── Static table (RFC 7541 Appendix A) ──
+
+struct StaticEntry {
+    std::string_view name;
+    std::string_view value;
+};
+
+constexpr std::array<StaticEntry, 61> STATIC_TABLE{{
+    {":authority", ""},
+    {":method", "GET"},
+    {":method", "POST"},
+    {":path", "/"},
+    {":path", "/index.html"},
+    {":scheme", "http"},
+    {":scheme", "https"},
+    {":status", "200"},
+    {":status", "204"},
+    {":status", "206"},
+    {":status", "304"},
+    {":status", "400"},
+    {":status", "404"},
+    {":status", "500"},
+    {"accept-charset", ""},
+    {"accept-encoding", "gzip, deflate"},
+    {"accept-language", ""},
+    {"accept-ranges", ""},
+    {"accept", ""},
+    {"access-control-allow-origin", ""},
+    {"age", ""},
+    {"allow", ""},
+    {"authorization", ""},
+    {"cache-control", ""},
+    {"content-disposition", ""},
+    {"content-encoding", ""},
+    {"content-language", ""},
+    {"content-length", ""},
+    {"content-location", ""},
+    {"content-range", ""},
+    {"content-type", ""},
+    {"cookie", ""},
+    {"date", ""},
+    {"etag", ""},
+    {"expect", ""},
+    {"expires", ""},
+    {"from", ""},
+    {"host", ""},
+    {"if-match", ""},
+    {"if-modified-since", ""},
+    {"if-none-match", ""},
+    {"if-range", ""},
+    {"if-unmodified-since", ""},
+    {"last-modified", ""},
+    {"link", ""},
+    {"location", ""},
+    {"max-forwards", ""},
+    {"proxy-authenticate", ""},
+    {"proxy-authorization", ""},
+    {"range", ""},
+    {"referer", ""},
+    {"refresh", ""},
+    {"retry-after", ""},
+    {"server", ""},
+    {"set-cookie", ""},
+    {"strict-transport-security", ""},
+    {"transfer-encoding", ""},
+    {"user-agent", ""},
+    {"via", ""},
+    {"www-authenticate", ""},
+}};
+
+/// Static entries as Header values, so lookup() can hand out pointers to
+/// either table alike.
+const std::array<Header, STATIC_TABLE.size()> &static_headers() {
+    static const auto headers = [] {
+        std::array<Header, STATIC_TABLE.size()> out;
+        for (std::size_t i = 0; i < STATIC_TABLE.size(); ++i) {
+            out[i] = Header{std::string(STATIC_TABLE[i].name), std::string(STATIC_TABLE[i].value)};
+        }
+        return out;
+    }();
+    return headers;
+}
+
+/// Per-entry overhead counted towards the table size (RFC 7541 §4.1).
+constexpr std::size_t ENTRY_OVERHEAD = 32;
+
+/// Limit on a decoded header list, counted as the dynamic table counts
+/// entries (RFC 9113 §6.5.2): a small block may index large entries many
+/// times over.
+constexpr std::size_t MAX_HEADER_LIST_SIZE = 65536;
+
+/// Largest integer accepted (§5.1 leaves the limit to the implementation).
+constexpr std::uint64_t MAX_INTEGER = std::numeric_limits<std::uint32_t>::max();
+
+// ── Huffman code (RFC 7541 Appendix B) ──
+
+struct HuffmanCode {
+    std::uint32_t code;
+    std::uint8_t bits;
+};
+
+/// Codes of symbols 0-255, right-aligned.  EOS (256) is 30 one-bits.
+constexpr std::array<HuffmanCode, 256> HUFFMAN_CODES{{
+        {0x00001ff8, 13}, {0x007fffd8, 23}, {0x0fffffe2, 28}, {0x0fffffe3, 28},
+        {0x0fffffe4, 28}, {0x0fffffe5, 28}, {0x0fffffe6, 28}, {0x0fffffe7, 28},
+        {0x0fffffe8, 28}, {0x00ffffea, 24}, {0x3ffffffc, 30}, {0x0fffffe9, 28},
+        {0x0fffffea, 28}, {0x3ffffffd, 30}, {0x0fffffeb, 28}, {0x0fffffec, 28},
+        {0x0fffffed, 28}, {0x0fffffee, 28}, {0x0fffffef, 28}, {0x0ffffff0, 28},
+        {0x0ffffff1, 28}, {0x0ffffff2, 28}, {0x3ffffffe, 30}, {0x0ffffff3, 28},
+        {0x0ffffff4, 28}, {0x0ffffff5, 28}, {0x0ffffff6, 28}, {0x0ffffff7, 28},
+        {0x0ffffff8, 28}, {0x0ffffff9, 28}, {0x0ffffffa, 28}, {0x0ffffffb, 28},
+        {0x00000014,  6}, {0x000003f8, 10}, {0x000003f9, 10}, {0x00000ffa, 12},
+        {0x00001ff9, 13}, {0x00000015,  6}, {0x000000f8,  8}, {0x000007fa, 11},
+        {0x000003fa, 10}, {0x000003fb, 10}, {0x000000f9,  8}, {0x000007fb, 11},
+        {0x000000fa,  8}, {0x00000016,  6}, {0x00000017,  6}, {0x00000018,  6},
+        {0x00000000,  5}, {0x00000001,  5}, {0x00000002,  5}, {0x00000019,  6},
+        {0x0000001a,  6}, {0x0000001b,  6}, {0x0000001c,  6}, {0x0000001d,  6},
+        {0x0000001e,  6}, {0x0000001f,  6}, {0x0000005c,  7}, {0x000000fb,  8},
+        {0x00007ffc, 15}, {0x00000020,  6}, {0x00000ffb, 12}, {0x000003fc, 10},
+        {0x00001ffa, 13}, {0x00000021,  6}, {0x0000005d,  7}, {0x0000005e,  7},
+        {0x0000005f,  7}, {0x00000060,  7}, {0x00000061,  7}, {0x00000062,  7},
+        {0x00000063,  7}, {0x00000064,  7}, {0x00000065,  7}, {0x00000066,  7},
+        {0x00000067,  7}, {0x00000068,  7}, {0x00000069,  7}, {0x0000006a,  7},
+        {0x0000006b,  7}, {0x0000006c,  7}, {0x0000006d,  7}, {0x0000006e,  7},
+        {0x0000006f,  7}, {0x00000070,  7}, {0x00000071,  7}, {0x00000072,  7},
+        {0x000000fc,  8}, {0x00000073,  7}, {0x000000fd,  8}, {0x00001ffb, 13},
+        {0x0007fff0, 19}, {0x00001ffc, 13}, {0x00003ffc, 14}, {0x00000022,  6},
+        {0x00007ffd, 15}, {0x00000003,  5}, {0x00000023,  6}, {0x00000004,  5},
+        {0x00000024,  6}, {0x00000005,  5}, {0x00000025,  6}, {0x00000026,  6},
+        {0x00000027,  6}, {0x00000006,  5}, {0x00000074,  7}, {0x00000075,  7},
+        {0x00000028,  6}, {0x00000029,  6}, {0x0000002a,  6}, {0x00000007,  5},
+        {0x0000002b,  6}, {0x00000076,  7}, {0x0000002c,  6}, {0x00000008,  5},
+        {0x00000009,  5}, {0x0000002d,  6}, {0x00000077,  7}, {0x00000078,  7},
+        {0x00000079,  7}, {0x0000007a,  7}, {0x0000007b,  7}, {0x00007ffe, 15},
+        {0x000007fc, 11}, {0x00003ffd, 14}, {0x00001ffd, 13}, {0x0ffffffc, 28},
+        {0x000fffe6, 20}, {0x003fffd2, 22}, {0x000fffe7, 20}, {0x000fffe8, 20},
+        {0x003fffd3, 22}, {0x003fffd4, 22}, {0x003fffd5, 22}, {0x007fffd9, 23},
+        {0x003fffd6, 22}, {0x007fffda, 23}, {0x007fffdb, 23}, {0x007fffdc, 23},
+        {0x007fffdd, 23}, {0x007fffde, 23}, {0x00ffffeb, 24}, {0x007fffdf, 23},
+        {0x00ffffec, 24}, {0x00ffffed, 24}, {0x003fffd7, 22}, {0x007fffe0, 23},
+        {0x00ffffee, 24}, {0x007fffe1, 23}, {0x007fffe2, 23}, {0x007fffe3, 23},
+        {0x007fffe4, 23}, {0x001fffdc, 21}, {0x003fffd8, 22}, {0x007fffe5, 23},
+        {0x003fffd9, 22}, {0x007fffe6, 23}, {0x007fffe7, 23}, {0x00ffffef, 24},
+        {0x003fffda, 22}, {0x001fffdd, 21}, {0x000fffe9, 20}, {0x003fffdb, 22},
+        {0x003fffdc, 22}, {0x007fffe8, 23}, {0x007fffe9, 23}, {0x001fffde, 21},
+        {0x007fffea, 23}, {0x003fffdd, 22}, {0x003fffde, 22}, {0x00fffff0, 24},
+        {0x001fffdf, 21}, {0x003fffdf, 22}, {0x007fffeb, 23}, {0x007fffec, 23},
+        {0x001fffe0, 21}, {0x001fffe1, 21}, {0x003fffe0, 22}, {0x001fffe2, 21},
+        {0x007fffed, 23}, {0x003fffe1, 22}, {0x007fffee, 23}, {0x007fffef, 23},
+        {0x000fffea, 20}, {0x003fffe2, 22}, {0x003fffe3, 22}, {0x003fffe4, 22},
+        {0x007ffff0, 23}, {0x003fffe5, 22}, {0x003fffe6, 22}, {0x007ffff1, 23},
+        {0x03ffffe0, 26}, {0x03ffffe1, 26}, {0x000fffeb, 20}, {0x0007fff1, 19},
+        {0x003fffe7, 22}, {0x007ffff2, 23}, {0x003fffe8, 22}, {0x01ffffec, 25},
+        {0x03ffffe2, 26}, {0x03ffffe3, 26}, {0x03ffffe4, 26}, {0x07ffffde, 27},
+        {0x07ffffdf, 27}, {0x03ffffe5, 26}, {0x00fffff1, 24}, {0x01ffffed, 25},
+        {0x0007fff2, 19}, {0x001fffe3, 21}, {0x03ffffe6, 26}, {0x07ffffe0, 27},
+        {0x07ffffe1, 27}, {0x03ffffe7, 26}, {0x07ffffe2, 27}, {0x00fffff2, 24},
+        {0x001fffe4, 21}, {0x001fffe5, 21}, {0x03ffffe8, 26}, {0x03ffffe9, 26},
+        {0x0ffffffd, 28}, {0x07ffffe3, 27}, {0x07ffffe4, 27}, {0x07ffffe5, 27},
+        {0x000fffec, 20}, {0x00fffff3, 24}, {0x000fffed, 20}, {0x001fffe6, 21},
+        {0x003fffe9, 22}, {0x001fffe7, 21}, {0x001fffe8, 21}, {0x007ffff3, 23},
+        {0x003fffea, 22}, {0x003fffeb, 22}, {0x01ffffee, 25}, {0x01ffffef, 25},
+        {0x00fffff4, 24}, {0x00fffff5, 24}, {0x03ffffea, 26}, {0x007ffff4, 23},
+        {0x03ffffeb, 26}, {0x07ffffe6, 27}, {0x03ffffec, 26}, {0x03ffffed, 26},
+        {0x07ffffe7, 27}, {0x07ffffe8, 27}, {0x07ffffe9, 27}, {0x07ffffea, 27},
+        {0x07ffffeb, 27}, {0x0ffffffe, 28}, {0x07ffffec, 27}, {0x07ffffed, 27},
+        {0x07ffffee, 27}, {0x07ffffef, 27}, {0x07fffff0, 27}, {0x03ffffee, 26},
+}};
+
+constexpr std::uint8_t HUFFMAN_MAX_BITS = 30;
+
+/// Canonical decoding tables: the codes of each length are consecutive
+/// values, so a code of length L is symbols[offset[L] + code - first[L]].
+struct HuffmanTables {
+    std::array<std::uint32_t, HUFFMAN_MAX_BITS + 1> first{};
+    std::array<std::uint16_t, HUFFMAN_MAX_BITS + 1> count{};
+    std::array<std::uint16_t, HUFFMAN_MAX_BITS + 1> offset{};
+    std::array<std::uint8_t, 256> symbols{};
+};
+
+const HuffmanTables &huffman_tables() {
+    static const auto tables = [] {
+        HuffmanTables t;
+        std::array<std::uint16_t, 256> order{};
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<std::uint16_t>(i);
+        }
+        std::ranges::sort(order, [](std::uint16_t a, std::uint16_t b) {
+            const auto &ca = HUFFMAN_CODES[a];
+            const auto &cb = HUFFMAN_CODES[b];
+            return ca.bits != cb.bits ? ca.bits < cb.bits : ca.code < cb.code;
+        });
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const auto &code = HUFFMAN_CODES[order[i]];
+            if (t.count[code.bits]++ == 0) {
+                t.first[code.bits] = code.code;
+                t.offset[code.bits] = static_cast<std::uint16_t>(i);
+            }
+            t.symbols[i] = static_cast<std::uint8_t>(order[i]);
+        }
+        return t;
+    }();
+    return tables;
+}
+
+/// Read an integer with an @p prefix_bits-bit prefix (RFC 7541 §5.1).
+[[nodiscard]] std::expected<std::uint64_t, Error> read_integer(std::span<const std::uint8_t> data, std::size_t &pos,
+                                                               int prefix_bits) {
+    const std::uint8_t mask = static_cast<std::uint8_t>((1U << prefix_bits) - 1);
+    std::uint64_t value = data[pos++] & mask;
+    if (value < mask) {
+        return value;
+    }
+    for (int shift = 0;; shift += 7) {
+        if (pos >= data.size() || shift > 28) {
+            return std::unexpected(Error::COMPRESSION_FAILED);
+        }
+        const auto byte = data[pos++];
+        value += static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    if (value > MAX_INTEGER) {
+        return std::unexpected(Error::COMPRESSION_FAILED);
+    }
+    return value;
+}
+
+/// Read a string literal (RFC 7541 §5.2).
+[[nodiscard]] std::expected<std::string, Error> read_string(std::span<const std::uint8_t> data, std::size_t &pos) {
+    if (pos >= data.size()) {
+        return std::unexpected(Error::COMPRESSION_FAILED);
+    }
+    const bool huffman = (data[pos] & 0x80) != 0;
+    const auto length = read_integer(data, pos, 7);
+    if (!length) {
+        return std::unexpected(length.error());
+    }
+    if (*length > data.size() - pos) {
+        return std::unexpected(Error::COMPRESSION_FAILED);
+    }
+    const auto bytes = data.subspan(pos, static_cast<std::size_t>(*length));
+    pos += bytes.size();
+    if (huffman) {
+        return Http::Hpack::huffman_decode(bytes);
+    }
+    return std::string(bytes.begin(), bytes.end());
+}
+
+/// Append an integer with an @p prefix_bits-bit prefix, the bits above
+/// the prefix in the first byte set to @p flags.
+void write_integer(std::vector<std::uint8_t> &out, std::uint8_t flags, int prefix_bits, std::size_t value) {
+    const std::size_t mask = (std::size_t{1} << prefix_bits) - 1;
+    if (value < mask) {
+        out.push_back(static_cast<std::uint8_t>(flags | value));
+        return;
+    }
+    out.push_back(static_cast<std::uint8_t>(flags | mask));
+    value -= mask;
+    while (value >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+/// Append a string literal, not Huffman-coded.
+void write_string(std::vector<std::uint8_t> &out, std::string_view s) {
+    write_integer(out, 0x00, 7, s.size());
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+}  // anonymous namespace
+
+namespace Http::Hpack {
+
+// ===========================================================================
+//  Encoding
+// ===========================================================================
+
+void encode(std::vector<std::uint8_t> &out, std::string_view name, std::string_view value) {
+    std::size_t name_index = 0;
+    for (std::size_t i = 0; i < STATIC_TABLE.size(); ++i) {
+        if (STATIC_TABLE[i].name != name) {
+            continue;
+        }
+        if (STATIC_TABLE[i].value == value) {
+            // Indexed header field (§6.1).
+            write_integer(out, 0x80, 7, i + 1);
+            return;
+        }
+        if (name_index == 0) {
+            name_index = i + 1;
+        }
+    }
+
+    // Literal header field without indexing (§6.2.2).
+    write_integer(out, 0x00, 4, name_index);
+    if (name_index == 0) {
+        write_string(out, name);
+    }
+    write_string(out, value);
+}
+
+// ===========================================================================
+//  Huffman decoding
+// ===========================================================================
+
+std::expected<std::string, Error> huffman_decode(std::span<const std::uint8_t> data) {
+    const auto &tables = huffman_tables();
+    std::string out;
+    out.reserve(data.size() * 8 / 5);
+
+    std::uint32_t code = 0;
+    std::uint8_t bits = 0;
+    for (const auto byte: data) {
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1U);
+            ++bits;
+            if (tables.count[bits] != 0 && code >= tables.first[bits] &&
+                code - tables.first[bits] < tables.count[bits]) {
+                out.push_back(static_cast<char>(tables.symbols[tables.offset[bits] + code - tables.first[bits]]));
+                code = 0;
+                bits = 0;
+            } else if (bits == HUFFMAN_MAX_BITS) {
+                // EOS, or no code at all.
+                return std::unexpected(Error::COMPRESSION_FAILED);
+            }
+        }
+    }
+
+    // Padding: the most significant bits of EOS, fewer than 8 (§5.2).
+    if (bits > 7 || code != (std::uint32_t{1} << bits) - 1) {
+        return std::unexpected(Error::COMPRESSION_FAILED);
+    }
+    return out;
+}
+
+// ===========================================================================
+//  Decoder
+// ===========================================================================
+
+Decoder::Decoder(std::size_t max_table_size) noexcept
+    : capacity_(max_table_size), max_capacity_(max_table_size) {
+}
+
+std::expected<std::vector<Header>, Error> Decoder::decode(std::span<const std::uint8_t> block) {
+    std::vector<Header> headers;
+    std::size_t list_size = 0;
+    std::size_t pos = 0;
+
+    while (pos < block.size()) {
+        const auto first = block[pos];
+
+        if ((first & 0xE0) == 0x20) {
+            // Dynamic table size update (§6.3): only before the first field.
+            if (!headers.empty()) {
+                return std::unexpected(Error::COMPRESSION_FAILED);
+            }
+            const auto size = read_integer(block, pos, 5);
+            if (!size) {
+                return std::unexpected(size.error());
+            }
+            if (*size > max_capacity_) {
+                return std::unexpected(Error::COMPRESSION_FAILED);
+            }
+            capacity_ = static_cast<std::size_t>(*size);
+            evict_to(capacity_);
+            continue;
+        }
+
+        Header header;
+        if ((first & 0x80) != 0) {
+            // Indexed header field (§6.1).
+            const auto index = read_integer(block, pos, 7);
+            if (!index) {
+                return std::unexpected(index.error());
+            }
+            const auto *entry = lookup(*index);
+            if (entry == nullptr) {
+                return std::unexpected(Error::COMPRESSION_FAILED);
+            }
+            header = *entry;
+        } else {
+            // Literal header field (§6.2): with incremental indexing
+            // (01xxxxxx), without indexing (0000xxxx) or never indexed
+            // (0001xxxx).
+            const bool indexing = (first & 0xC0) == 0x40;
+            const auto name_index = read_integer(block, pos, indexing ? 6 : 4);
+            if (!name_index) {
+                return std::unexpected(name_index.error());
+            }
+            if (*name_index != 0) {
+                const auto *entry = lookup(*name_index);
+                if (entry == nullptr) {
+                    return std::unexpected(Error::COMPRESSION_FAILED);
+                }
+                header.name = entry->name;
+            } else {
+                auto name = read_string(block, pos);
+                if (!name) {
+                    return std::unexpected(name.error());
+                }
+                header.name = std::move(*name);
+            }
+            auto value = read_string(block, pos);
+            if (!value) {
+                return std::unexpected(value.error());
+            }
+            header.value = std::move(*value);
+            if (indexing) {
+                insert(header);
+            }
+        }
+
+        list_size += header.name.size() + header.value.size() + ENTRY_OVERHEAD;
+        if (list_size > MAX_HEADER_LIST_SIZE) {
+            return std::unexpected(Error::HEADERS_TOO_LARGE);
+        }
+        headers.push_back(std::move(header));
+    }
+
+    return headers;
+}
+
+const Header *Decoder::lookup(std::uint64_t index) const noexcept {
+    if (index == 0) {
+        return nullptr;
+    }
+    if (index <= STATIC_TABLE.size()) {
+        return &static_headers()[static_cast<std::size_t>(index - 1)];
+    }
+    const auto dynamic = static_cast<std::size_t>(index - STATIC_TABLE.size() - 1);
+    return dynamic < table_.size() ? &table_[dynamic] : nullptr;
+}
+
+void Decoder::insert(Header header) {
+    const auto entry_size = header.name.size() + header.value.size() + ENTRY_OVERHEAD;
+    if (entry_size > capacity_) {
+        // Larger than the whole table: empties it (§4.4).
+        evict_to(0);
+        return;
+    }
+    evict_to(capacity_ - entry_size);
+    size_ += entry_size;
+    table_.push_front(std::move(header));
+}
+
+void Decoder::evict_to(std::size_t limit) noexcept {
+    while (size_ > limit && !table_.empty()) {
+        const auto &oldest = table_.back();
+        size_ -= oldest.name.size() + oldest.value.size() + ENTRY_OVERHEAD;
+        table_.pop_back();
+    }
+}
+
+}  // namespace Http::Hpack
@@ -0,0 +1,94 @@
+//
+// Created by Kotarou on 2026/8/9.
+//
+
+#ifndef YADDNSC_HTTP_HPACK_H
+#define YADDNSC_HTTP_HPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "http/types.h"
+
+/// HPACK header compression for HTTP/2 (RFC 7541).
+namespace Http::Hpack {
+
+/// Default (and our advertised) SETTINGS_HEADER_TABLE_SIZE.
+inline constexpr std::size_t DEFAULT_TABLE_SIZE = 4096;
+
+/// A header field.
+struct Header {
+    std::string name;
+    std::string value;
+
+    bool operator==(const Header &) const = default;
+};
+
+/// Append the representation of the field @p name: @p value to @p out.
+///
+/// Stateless: a field found whole in the static table is indexed, any
+/// other is a literal without indexing (RFC 7541 §6.2.2), naming the
+/// static entry when there is one.  Strings are not Huffman-coded.  The
+/// peer's dynamic table is never touched, so the encoder needs no state
+/// and is valid for any SETTINGS_HEADER_TABLE_SIZE.
+///
+/// @p name must be lower case (RFC 9113 §8.2.1).
+void encode(std::vector<std::uint8_t> &out, std::string_view name, std::string_view value);
+
+/// Decode a Huffman-coded string (RFC 7541 §5.2, Appendix B).
+/// @return The string, or COMPRESSION_FAILED on an invalid code, EOS, or
+///         padding that is not a prefix of EOS or exceeds 7 bits.
+[[nodiscard]] std::expected<std::string, Error> huffman_decode(std::span<const std::uint8_t> data);
+
+/// Decoder — the receiving side of one HPACK context (one per connection).
+///
+/// Keeps the dynamic table the peer's encoder builds, so every header
+/// block received on the connection must be decoded, in order, even those
+/// of streams nobody waits for anymore.
+///
+/// @note Not thread-safe.
+class Decoder {
+public:
+    /// @param max_table_size  The SETTINGS_HEADER_TABLE_SIZE we advertised:
+    ///                        the limit on the peer's table size updates.
+    explicit Decoder(std::size_t max_table_size = DEFAULT_TABLE_SIZE) noexcept;
+
+    /// Decode a complete header block (HEADERS + CONTINUATION fragments).
+    /// @return The header list, or COMPRESSION_FAILED — a connection error
+    ///         (RFC 7541 §2.3.3): the context cannot be used afterwards.
+    [[nodiscard]] std::expected<std::vector<Header>, Error> decode(std::span<const std::uint8_t> block);
+
+    /// Current size of the dynamic table, as RFC 7541 §4.1 counts it.
+    [[nodiscard]] std::size_t table_size() const noexcept { return size_; }
+
+    /// Number of entries in the dynamic table.
+    [[nodiscard]] std::size_t table_entries() const noexcept { return table_.size(); }
+
+private:
+    /// Entry @p index of the combined static + dynamic index space.
+    [[nodiscard]] const Header *lookup(std::uint64_t index) const noexcept;
+
+    /// Add an entry, evicting the oldest ones to make room (§4.4).
+    void insert(Header header);
+
+    /// Evict entries until the table fits in @p limit.
+    void evict_to(std::size_t limit) noexcept;
+
+    /// Newest entry first, as dynamic indexes count.
+    std::deque<Header> table_;
+    std::size_t size_{0};
+    /// Current maximum size, as last set by the peer.
+    std::size_t capacity_;
+    /// The most the peer may set it to.
+    std::size_t max_capacity_;
+};
+
+}  // namespace Http::Hpack
+
+#endif  // YADDNSC_HTTP_HPACK_H
@@ -0,0 +1,624 @@
+//
+// Created by Kotarou on 2026/8/9.
+//
+#include "http2.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <optional>
+#include <string>
+
+#include "network/transport/stream.h"
+#include "util/bytes.hpp"
+#include "util/cancellation_token.hpp"
+
+#include <magic_enum/magic_enum.hpp>
+
+#include "string_util.hpp"
+
+namespace {
+
+// ── Connection preface (RFC 9113 §3.4) ──
+constexpr std::string_view PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+// ── Frames (RFC 9113 §4.1, §6) ──
+constexpr std::size_t FRAME_HEADER_SIZE = 9;
+
+enum FrameType : std::uint8_t {
+    DATA = 0x0,
+    HEADERS = 0x1,
+    PRIORITY = 0x2,
+    RST_STREAM = 0x3,
+    SETTINGS = 0x4,
+    PUSH_PROMISE = 0x5,
+    PING = 0x6,
+    GOAWAY = 0x7,
+    WINDOW_UPDATE = 0x8,
+    CONTINUATION = 0x9,
+};
+
+constexpr std::uint8_t FLAG_END_STREAM = 0x1;
+constexpr std::uint8_t FLAG_ACK = 0x1;
+constexpr std::uint8_t FLAG_END_HEADERS = 0x4;
+constexpr std::uint8_t FLAG_PADDED = 0x8;
+constexpr std::uint8_t FLAG_PRIORITY = 0x20;
+
+// ── Error codes (RFC 9113 §7) ──
+constexpr std::uint32_t PROTOCOL_ERROR = 0x1;
+constexpr std::uint32_t FLOW_CONTROL_ERROR = 0x3;
+constexpr std::uint32_t FRAME_SIZE_ERROR = 0x6;
+constexpr std::uint32_t CANCEL = 0x8;
+constexpr std::uint32_t COMPRESSION_ERROR = 0x9;
+constexpr std::uint32_t ENHANCE_YOUR_CALM = 0xb;
+
+// ── Settings (RFC 9113 §6.5.2) ──
+constexpr std::uint16_t SETTINGS_HEADER_TABLE_SIZE = 0x1;
+constexpr std::uint16_t SETTINGS_ENABLE_PUSH = 0x2;
+constexpr std::uint16_t SETTINGS_MAX_CONCURRENT_STREAMS = 0x3;
+constexpr std::uint16_t SETTINGS_INITIAL_WINDOW_SIZE = 0x4;
+constexpr std::uint16_t SETTINGS_MAX_FRAME_SIZE = 0x5;
+constexpr std::uint16_t SETTINGS_MAX_HEADER_LIST_SIZE = 0x6;
+
+constexpr std::size_t DEFAULT_MAX_FRAME_SIZE = 16384;
+constexpr std::size_t MAX_MAX_FRAME_SIZE = 16777215;
+constexpr std::int64_t DEFAULT_WINDOW = 65535;
+constexpr std::int64_t MAX_WINDOW = 2147483647;
+constexpr std::uint32_t MAX_STREAM_ID = 2147483647;
+
+/// Largest header block we accept, as advertised in SETTINGS_MAX_HEADER_LIST_SIZE.
+/// The limit counts decoded fields plus 32 octets each (§6.5.2), which no
+/// compliant encoding exceeds, so it caps the encoded block too.  A DoH
+/// response carries a few hundred octets of headers.
+constexpr std::size_t MAX_HEADER_LIST_SIZE = 16384;
+
+/// Streams assumed allowed until the server's SETTINGS say otherwise; the
+/// smallest value RFC 9113 §6.5.2 recommends servers allow.
+constexpr std::size_t INITIAL_MAX_CONCURRENT_STREAMS = 100;
+
+/// Bytes read from the transport per read_some().
+constexpr std::size_t READ_CHUNK_SIZE = 16384;
+
+/// Header fields connection-specific to HTTP/1.1 (RFC 9113 §8.2.2).
+constexpr std::array<std::string_view, 6> CONNECTION_HEADERS{
+    "connection", "keep-alive", "proxy-connection", "transfer-encoding", "upgrade", "host",
+};
+
+/// Map a transport IoError to an HTTP Error.
+[[nodiscard]] Http::Error map_io_error(Transport::IoError e) noexcept {
+    switch (e) {
+        case Transport::IoError::TIMEOUT:
+            return Http::Error::TIMEOUT;
+        case Transport::IoError::CANCELLED:
+            return Http::Error::CANCELLED;
+        case Transport::IoError::CONNECTION_FAILED:
+            return Http::Error::CONNECTION_FAILED;
+    }
+    return Http::Error::CONNECTION_FAILED;
+}
+
+[[nodiscard]] std::uint32_t read_u24_be(const std::uint8_t *buf) noexcept {
+    return (static_cast<std::uint32_t>(buf[0]) << 16) | (static_cast<std::uint32_t>(buf[1]) << 8) | buf[2];
+}
+
+/// Strip the padding of a PADDED frame (RFC 9113 §6.1).
+/// @return The payload without it, or nothing if the padding is too long.
+[[nodiscard]] std::optional<std::span<const std::uint8_t>> unpad(std::uint8_t flags,
+                                                                 std::span<const std::uint8_t> payload) noexcept {
+    if ((flags & FLAG_PADDED) == 0) {
+        return payload;
+    }
+    if (payload.empty() || payload[0] >= payload.size()) {
+        return std::nullopt;
+    }
+    return payload.subspan(1, payload.size() - 1 - payload[0]);
+}
+
+}  // anonymous namespace
+
+namespace Http::H2 {
+
+Session::Session(Transport::Stream &stream)
+    : stream_(stream),
+      max_concurrent_streams_(INITIAL_MAX_CONCURRENT_STREAMS),
+      max_frame_size_(DEFAULT_MAX_FRAME_SIZE),
+      initial_window_(DEFAULT_WINDOW),
+      send_window_(DEFAULT_WINDOW) {
+}
+
+Session::~Session() = default;
+
+// ===========================================================================
+//  Requests
+// ===========================================================================
+
+std::expected<void, Error> Session::start() {
+    out_.assign(PREFACE.begin(), PREFACE.end());
+
+    // Our SETTINGS: no server push, and a bounded header list.  Everything
+    // else keeps its default, in particular the 4096-byte HPACK table and
+    // 65535-byte windows.
+    put_frame_header(12, SETTINGS, 0, 0);
+    const auto offset = out_.size();
+    out_.resize(offset + 12);
+    Utils::Bytes::write_u16_be(out_.data() + offset, SETTINGS_ENABLE_PUSH);
+    Utils::Bytes::write_u32_be(out_.data() + offset + 2, 0);
+    Utils::Bytes::write_u16_be(out_.data() + offset + 6, SETTINGS_MAX_HEADER_LIST_SIZE);
+    Utils::Bytes::write_u32_be(out_.data() + offset + 8, MAX_HEADER_LIST_SIZE);
+
+    return flush();
+}
+
+bool Session::can_open() const noexcept {
+    return usable() && streams_.size() < max_concurrent_streams_;
+}
+
+bool Session::usable() const noexcept {
+    return !failed_ && !going_away_ && next_stream_id_ <= MAX_STREAM_ID;
+}
+
+std::expected<std::uint32_t, Error> Session::submit(std::string_view path, const HttpRequest &req,
+                                                    std::string_view authority, std::string_view user_agent) {
+    if (failed_) {
+        return std::unexpected(Error::CONNECTION_FAILED);
+    }
+
+    const std::size_t body_size = req.body ? req.body->size() : 0;
+    if (static_cast<std::int64_t>(body_size) > std::min(send_window_, initial_window_) ||
+        body_size > max_frame_size_) {
+        return std::unexpected(Error::BODY_TOO_LARGE);
+    }
+
+    // ── Header block (RFC 9113 §8.3.1) ──
+    std::vector<std::uint8_t> block;
+    block.reserve(256);
+    auto method = magic_enum::enum_name(req.method);
+    Hpack::encode(block, ":method", req.method == HttpMethod::DEL ? "DELETE" : method);
+    Hpack::encode(block, ":scheme", "https");
+    Hpack::encode(block, ":authority", authority);
+    Hpack::encode(block, ":path", path);
+    if (!req.content_type.empty()) {
+        Hpack::encode(block, "content-type", req.content_type);
+    }
+    if (req.body) {
+        Hpack::encode(block, "content-length", std::to_string(body_size));
+    }
+    Hpack::encode(block, "user-agent", user_agent);
+    for (const auto &[key, value]: req.headers) {
+        auto name = StringUtil::to_lower_copy(key);
+        if (std::ranges::find(CONNECTION_HEADERS, name) != CONNECTION_HEADERS.end()) {
+            continue;
+        }
+        Hpack::encode(block, name, value);
+    }
+
+    const auto stream_id = next_stream_id_;
+    next_stream_id_ += 2;
+
+    // HEADERS, then CONTINUATION frames if the block exceeds a frame.
+    const auto end_stream = body_size == 0 ? FLAG_END_STREAM : 0;
+    std::size_t sent = 0;
+    do {
+        const auto chunk = std::min(block.size() - sent, max_frame_size_);
+        const auto last = sent + chunk == block.size();
+        put_frame_header(chunk, sent == 0 ? HEADERS : CONTINUATION,
+                         static_cast<std::uint8_t>((sent == 0 ? end_stream : 0) | (last ? FLAG_END_HEADERS : 0)),
+                         stream_id);
+        out_.insert(out_.end(), block.begin() + static_cast<std::ptrdiff_t>(sent),
+                    block.begin() + static_cast<std::ptrdiff_t>(sent + chunk));
+        sent += chunk;
+    } while (sent < block.size());
+
+    if (body_size != 0) {
+        put_frame_header(body_size, DATA, FLAG_END_STREAM, stream_id);
+        out_.insert(out_.end(), req.body->begin(), req.body->end());
+        send_window_ -= static_cast<std::int64_t>(body_size);
+    }
+
+    StreamState state;
+    state.window = static_cast<std::size_t>(DEFAULT_WINDOW);
+    streams_.emplace(stream_id, std::move(state));
+    if (auto status = flush(); !status) {
+        return std::unexpected(status.error());
+    }
+    return stream_id;
+}
+
+void Session::reset(std::uint32_t stream_id) {
+    if (streams_.erase(stream_id) == 0 || failed_) {
+        return;
+    }
+    put_frame_header(4, RST_STREAM, 0, stream_id);
+    const auto offset = out_.size();
+    out_.resize(offset + 4);
+    Utils::Bytes::write_u32_be(out_.data() + offset, CANCEL);
+    // A failed write fails the session; the owner learns of it on the next
+    // receive() or submit().
+    [[maybe_unused]] auto _ = flush();
+}
+
+// ===========================================================================
+//  Frames
+// ===========================================================================
+
+std::expected<void, Error> Session::receive(const StreamSink &sink) {
+    if (failed_) {
+        return std::unexpected(Error::CONNECTION_FAILED);
+    }
+
+    std::array<std::uint8_t, READ_CHUNK_SIZE> buffer{};
+    const auto received = stream_.read_some(buffer, {});
+    if (!received || *received == 0) {
+        failed_ = true;
+        return std::unexpected(received ? Error::CONNECTION_FAILED : map_io_error(received.error()));
+    }
+    in_.insert(in_.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(*received));
+
+    std::size_t offset = 0;
+    std::expected<void, Error> status;
+    while (status && in_.size() - offset >= FRAME_HEADER_SIZE) {
+        const auto *header = in_.data() + offset;
+        const auto length = read_u24_be(header);
+        if (length > DEFAULT_MAX_FRAME_SIZE) {
+            // Larger than our SETTINGS_MAX_FRAME_SIZE (§4.2).
+            status = std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+            break;
+        }
+        if (in_.size() - offset - FRAME_HEADER_SIZE < length) {
+            break;
+        }
+        const auto type = header[3];
+        const auto flags = header[4];
+        const auto stream_id = Utils::Bytes::read_u32_be(header + 5) & MAX_STREAM_ID;
+        status = on_frame(type, flags, stream_id,
+                          std::span{in_}.subspan(offset + FRAME_HEADER_SIZE, length), sink);
+        offset += FRAME_HEADER_SIZE + length;
+    }
+    in_.erase(in_.begin(), in_.begin() + static_cast<std::ptrdiff_t>(offset));
+    if (!status) {
+        return status;
+    }
+
+    // Keep the connection window open (§6.9): what was read is consumed.
+    if (recv_consumed_ >= static_cast<std::size_t>(DEFAULT_WINDOW / 2)) {
+        put_frame_header(4, WINDOW_UPDATE, 0, 0);
+        const auto at = out_.size();
+        out_.resize(at + 4);
+        Utils::Bytes::write_u32_be(out_.data() + at, static_cast<std::uint32_t>(recv_consumed_));
+        recv_consumed_ = 0;
+    }
+    return flush();
+}
+
+std::expected<void, Error> Session::on_frame(std::uint8_t type, std::uint8_t flags, std::uint32_t stream_id,
+                                             std::span<const std::uint8_t> payload, const StreamSink &sink) {
+    // A header block must continue uninterrupted (§6.10).
+    if (header_stream_ != 0 && (type != CONTINUATION || stream_id != header_stream_)) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+
+    switch (type) {
+        case DATA:
+            return on_data(flags, stream_id, payload, sink);
+
+        case HEADERS:
+            return on_headers(flags, stream_id, payload, sink);
+
+        case CONTINUATION:
+            if (header_stream_ == 0) {
+                return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+            }
+            if (payload.size() > MAX_HEADER_LIST_SIZE - header_block_.size()) {
+                return std::unexpected(fail(ENHANCE_YOUR_CALM, Error::HEADERS_TOO_LARGE));
+            }
+            header_block_.insert(header_block_.end(), payload.begin(), payload.end());
+            if ((flags & FLAG_END_HEADERS) == 0) {
+                return {};
+            }
+            header_stream_ = 0;
+            return on_header_block(stream_id, header_end_stream_, sink);
+
+        case RST_STREAM:
+            if (stream_id == 0 || payload.size() != 4) {
+                return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+            }
+            finish(stream_id, std::unexpected(Error::STREAM_RESET), sink);
+            return {};
+
+        case SETTINGS:
+            return on_settings(flags, stream_id, payload);
+
+        case PUSH_PROMISE:
+            // We sent SETTINGS_ENABLE_PUSH = 0 (§8.4).
+            return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+
+        case PING:
+            if (stream_id != 0 || payload.size() != 8) {
+                return std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+            }
+            if ((flags & FLAG_ACK) == 0) {
+                put_frame_header(8, PING, FLAG_ACK, 0);
+                out_.insert(out_.end(), payload.begin(), payload.end());
+            }
+            return {};
+
+        case GOAWAY:
+            return on_goaway(stream_id, payload, sink);
+
+        case WINDOW_UPDATE:
+            return on_window_update(stream_id, payload);
+
+        default:
+            // PRIORITY is advisory; unknown types are ignored (§4.1).
+            return {};
+    }
+}
+
+std::expected<void, Error> Session::on_data(std::uint8_t flags, std::uint32_t stream_id,
+                                            std::span<const std::uint8_t> payload, const StreamSink &sink) {
+    if (stream_id == 0 || !opened(stream_id)) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+
+    // The whole frame, padding included, counts against the windows (§6.9).
+    recv_consumed_ += payload.size();
+    if (recv_consumed_ > static_cast<std::size_t>(DEFAULT_WINDOW)) {
+        return std::unexpected(fail(FLOW_CONTROL_ERROR, Error::PROTOCOL_ERROR));
+    }
+
+    const auto data = unpad(flags, payload);
+    if (!data) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+
+    const auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+        // Reset by us, or ended by the server earlier.
+        return {};
+    }
+    auto &state = it->second;
+    if (!state.has_headers) {
+        return fail_stream(stream_id, PROTOCOL_ERROR, Error::PROTOCOL_ERROR, sink);
+    }
+    if (payload.size() > state.window) {
+        return fail_stream(stream_id, FLOW_CONTROL_ERROR, Error::BODY_TOO_LARGE, sink);
+    }
+    state.window -= payload.size();
+    state.response.body.insert(state.response.body.end(), data->begin(), data->end());
+
+    if ((flags & FLAG_END_STREAM) != 0) {
+        auto response = std::move(state.response);
+        finish(stream_id, std::move(response), sink);
+    }
+    return {};
+}
+
+std::expected<void, Error> Session::on_headers(std::uint8_t flags, std::uint32_t stream_id,
+                                               std::span<const std::uint8_t> payload, const StreamSink &sink) {
+    if (stream_id == 0 || !opened(stream_id)) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    auto fragment = unpad(flags, payload);
+    if (!fragment) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    if ((flags & FLAG_PRIORITY) != 0) {
+        if (fragment->size() < 5) {
+            return std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+        }
+        *fragment = fragment->subspan(5);
+    }
+
+    if (fragment->size() > MAX_HEADER_LIST_SIZE) {
+        return std::unexpected(fail(ENHANCE_YOUR_CALM, Error::HEADERS_TOO_LARGE));
+    }
+    header_block_.assign(fragment->begin(), fragment->end());
+    header_end_stream_ = (flags & FLAG_END_STREAM) != 0;
+    if ((flags & FLAG_END_HEADERS) == 0) {
+        header_stream_ = stream_id;
+        return {};
+    }
+    return on_header_block(stream_id, header_end_stream_, sink);
+}
+
+std::expected<void, Error> Session::on_header_block(std::uint32_t stream_id, bool end_stream,
+                                                    const StreamSink &sink) {
+    // Decoded even for a stream nobody waits for: the HPACK context is
+    // shared by the whole connection.
+    auto headers = decoder_.decode(header_block_);
+    header_block_.clear();
+    if (!headers) {
+        return std::unexpected(fail(COMPRESSION_ERROR, Error::COMPRESSION_FAILED));
+    }
+
+    const auto it = streams_.find(stream_id);
+    if (it == streams_.end()) {
+        return {};
+    }
+    auto &state = it->second;
+
+    if (!state.has_headers) {
+        // Response header block: ":status" first (§8.3.2).
+        if (headers->empty() || headers->front().name != ":status") {
+            return fail_stream(stream_id, PROTOCOL_ERROR, Error::PROTOCOL_ERROR, sink);
+        }
+        const auto &value = headers->front().value;
+        int status = 0;
+        const auto [end, ec] = std::from_chars(value.data(), value.data() + value.size(), status);
+        if (ec != std::errc{} || end != value.data() + value.size() || status < 100 || status > 999) {
+            return fail_stream(stream_id, PROTOCOL_ERROR, Error::PROTOCOL_ERROR, sink);
+        }
+        if (status < 200) {
+            // Informational: the final response follows (§8.1).
+            return end_stream ? fail_stream(stream_id, PROTOCOL_ERROR, Error::PROTOCOL_ERROR, sink)
+                              : std::expected<void, Error>{};
+        }
+        state.response.status_code = status;
+        state.has_headers = true;
+    } else if (!end_stream) {
+        // Trailers must end the stream.
+        return fail_stream(stream_id, PROTOCOL_ERROR, Error::PROTOCOL_ERROR, sink);
+    }
+
+    if (end_stream) {
+        auto response = std::move(state.response);
+        finish(stream_id, std::move(response), sink);
+    }
+    return {};
+}
+
+std::expected<void, Error> Session::on_settings(std::uint8_t flags, std::uint32_t stream_id,
+                                                std::span<const std::uint8_t> payload) {
+    if (stream_id != 0) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    if ((flags & FLAG_ACK) != 0) {
+        if (!payload.empty()) {
+            return std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+        }
+        return {};
+    }
+    if (payload.size() % 6 != 0) {
+        return std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+    }
+
+    for (std::size_t offset = 0; offset < payload.size(); offset += 6) {
+        const auto id = Utils::Bytes::read_u16_be(payload, offset);
+        const auto value = Utils::Bytes::read_u32_be(payload, offset + 2);
+        switch (id) {
+            case SETTINGS_ENABLE_PUSH:
+                if (value > 1) {
+                    return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+                }
+                break;
+            case SETTINGS_MAX_CONCURRENT_STREAMS:
+                max_concurrent_streams_ = value;
+                break;
+            case SETTINGS_INITIAL_WINDOW_SIZE:
+                if (value > MAX_WINDOW) {
+                    return std::unexpected(fail(FLOW_CONTROL_ERROR, Error::PROTOCOL_ERROR));
+                }
+                initial_window_ = value;
+                break;
+            case SETTINGS_MAX_FRAME_SIZE:
+                if (value < DEFAULT_MAX_FRAME_SIZE || value > MAX_MAX_FRAME_SIZE) {
+                    return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+                }
+                max_frame_size_ = value;
+                break;
+            case SETTINGS_HEADER_TABLE_SIZE:
+                // Bounds the encoder's dynamic table, which ours never uses.
+            default:
+                break;
+        }
+    }
+
+    put_frame_header(0, SETTINGS, FLAG_ACK, 0);
+    return {};
+}
+
+std::expected<void, Error> Session::on_goaway(std::uint32_t stream_id, std::span<const std::uint8_t> payload,
+                                              const StreamSink &sink) {
+    if (stream_id != 0 || payload.size() < 8) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    going_away_ = true;
+
+    // Streams above the last one the server processes never will be, and
+    // are safe to retry elsewhere (§6.8).
+    const auto last_stream_id = Utils::Bytes::read_u32_be(payload, 0) & MAX_STREAM_ID;
+    std::vector<std::uint32_t> refused;
+    for (const auto &[id, state]: streams_) {
+        if (id > last_stream_id) {
+            refused.push_back(id);
+        }
+    }
+    for (const auto id: refused) {
+        finish(id, std::unexpected(Error::STREAM_RESET), sink);
+    }
+    return {};
+}
+
+std::expected<void, Error> Session::on_window_update(std::uint32_t stream_id,
+                                                     std::span<const std::uint8_t> payload) {
+    if (payload.size() != 4) {
+        return std::unexpected(fail(FRAME_SIZE_ERROR, Error::PROTOCOL_ERROR));
+    }
+    const auto increment = Utils::Bytes::read_u32_be(payload, 0) & MAX_STREAM_ID;
+    if (stream_id != 0) {
+        // Our bodies are sent whole on submit(): stream windows never limit
+        // us past that.
+        return {};
+    }
+    if (increment == 0) {
+        return std::unexpected(fail(PROTOCOL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    send_window_ += increment;
+    if (send_window_ > MAX_WINDOW) {
+        return std::unexpected(fail(FLOW_CONTROL_ERROR, Error::PROTOCOL_ERROR));
+    }
+    return {};
+}
+
+// ===========================================================================
+//  Helpers
+// ===========================================================================
+
+void Session::finish(std::uint32_t stream_id, Result result, const StreamSink &sink) {
+    if (streams_.erase(stream_id) != 0) {
+        sink(stream_id, std::move(result));
+    }
+}
+
+std::expected<void, Error> Session::fail_stream(std::uint32_t stream_id, std::uint32_t code, Error error,
+                                                const StreamSink &sink) {
+    put_frame_header(4, RST_STREAM, 0, stream_id);
+    const auto offset = out_.size();
+    out_.resize(offset + 4);
+    Utils::Bytes::write_u32_be(out_.data() + offset, code);
+    finish(stream_id, std::unexpected(error), sink);
+    return {};
+}
+
+Error Session::fail(std::uint32_t code, Error error) {
+    const auto last_stream_id = 0U;  // we accept no server-initiated streams
+    put_frame_header(8, GOAWAY, 0, 0);
+    const auto offset = out_.size();
+    out_.resize(offset + 8);
+    Utils::Bytes::write_u32_be(out_.data() + offset, last_stream_id);
+    Utils::Bytes::write_u32_be(out_.data() + offset + 4, code);
+    [[maybe_unused]] auto _ = flush();
+    failed_ = true;
+    return error;
+}
+
+bool Session::opened(std::uint32_t stream_id) const noexcept {
+    return stream_id % 2 == 1 && stream_id < next_stream_id_;
+}
+
+void Session::put_frame_header(std::size_t length, std::uint8_t type, std::uint8_t flags, std::uint32_t stream_id) {
+    const auto offset = out_.size();
+    out_.resize(offset + FRAME_HEADER_SIZE);
+    auto *header = out_.data() + offset;
+    header[0] = static_cast<std::uint8_t>(length >> 16);
+    header[1] = static_cast<std::uint8_t>(length >> 8);
+    header[2] = static_cast<std::uint8_t>(length);
+    header[3] = type;
+    header[4] = flags;
+    Utils::Bytes::write_u32_be(header + 5, stream_id);
+}
+
+std::expected<void, Error> Session::flush() {
+    if (out_.empty()) {
+        return {};
+    }
+    auto status = stream_.send_all(out_, {});
+    out_.clear();
+    if (!status) {
+        failed_ = true;
+        return std::unexpected(map_io_error(status.error()));
+    }
+    return {};
+}
+
+}  // namespace Http::H2
@@ -0,0 +1,191 @@
+//
+// Created by Kotarou on 2026/8/9.
+//
+
+#ifndef YADDNSC_HTTP2_H
+#define YADDNSC_HTTP2_H
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "http/hpack.h"
+#include "http/types.h"
+#include "http_type.h"
+
+namespace Transport { class Stream; }
+
+/// HTTP/2 client (RFC 9113), for servers that negotiate ALPN "h2".
+namespace Http::H2 {
+
+/// The outcome of one stream: its response, or the error that ended it.
+using Result = std::expected<Response, Error>;
+
+/// Receives each stream that ends, with its outcome.
+using StreamSink = std::function<void(std::uint32_t stream_id, Result result)>;
+
+/// Session — the client side of one HTTP/2 connection over a
+/// @ref Transport::Stream.
+///
+/// Any number of requests (up to the server's SETTINGS_MAX_CONCURRENT_STREAMS)
+/// are open at once, each on its own stream.  The frames of their responses
+/// arrive interleaved, and each response is handed over as soon as its
+/// stream ends, whatever the order the requests were sent in.
+///
+/// The session never waits by itself: the owner decides when the transport
+/// has something to read and calls receive(), which also answers the
+/// connection-level frames (SETTINGS, PING) and keeps the receive window
+/// open.  I/O is never cancelled: a frame cut short would corrupt the
+/// connection for every stream on it.
+///
+/// Responses are limited to one flow-control window (65535 bytes, which
+/// any DNS message fits in); request bodies must fit in the server's
+/// initial window and maximum frame size.  Server push is disabled.
+///
+/// @par Thread Safety
+/// **Not thread-safe.**  All calls, like all use of the stream, must be
+/// serialised by the owner.
+class Session {
+public:
+    /// @param stream  The connection, after the TLS handshake negotiated
+    ///                "h2".  Must outlive the session.
+    explicit Session(Transport::Stream &stream);
+
+    ~Session();
+
+    Session(const Session &) = delete;
+
+    Session &operator=(const Session &) = delete;
+
+    /// Send the connection preface and our SETTINGS (RFC 9113 §3.4).
+    /// Requests may follow at once, before the server's SETTINGS arrive.
+    [[nodiscard]] std::expected<void, Error> start();
+
+    /// Whether a request may be submitted now.
+    [[nodiscard]] bool can_open() const noexcept;
+
+    /// Whether the session may ever take another request: false once the
+    /// connection failed, the server sent GOAWAY, or stream IDs ran out.
+    [[nodiscard]] bool usable() const noexcept;
+
+    /// Whether a read or write error, or a protocol violation, ended the
+    /// connection.
+    [[nodiscard]] bool failed() const noexcept { return failed_; }
+
+    /// Number of requests awaiting their response.
+    [[nodiscard]] std::size_t open_streams() const noexcept { return streams_.size(); }
+
+    /// Open a stream and send the request on it.
+    ///
+    /// The request-target is https://@p authority@p path.  Headers in
+    /// @p req that HTTP/2 forbids (Connection, Keep-Alive, ...) are dropped.
+    /// @return The stream ID, or BODY_TOO_LARGE if the body does not fit in
+    ///         the windows, or the write error (which fails the session).
+    /// @pre can_open().
+    [[nodiscard]] std::expected<std::uint32_t, Error> submit(std::string_view path,
+                                                             const HttpRequest &req,
+                                                             std::string_view authority,
+                                                             std::string_view user_agent);
+
+    /// Read what the stream holds (blocking until at least one byte), and
+    /// process every complete frame.
+    ///
+    /// Each stream that ends — with its response, or reset by the server,
+    /// or refused by its GOAWAY — is passed to @p sink and forgotten.
+    /// @return A connection error: the session has failed, and the streams
+    ///         still open are not passed to @p sink but have failed with it.
+    [[nodiscard]] std::expected<void, Error> receive(const StreamSink &sink);
+
+    /// Give up on stream @p stream_id: it is reset (RST_STREAM CANCEL) and
+    /// whatever arrives for it is discarded.
+    void reset(std::uint32_t stream_id);
+
+private:
+    /// A request awaiting its response.
+    struct StreamState {
+        Response response;
+        /// A final (non-1xx) header block was received.
+        bool has_headers{false};
+        /// Receive window left.
+        std::size_t window{0};
+    };
+
+    /// Process one frame.  @return A connection error.
+    [[nodiscard]] std::expected<void, Error> on_frame(std::uint8_t type, std::uint8_t flags, std::uint32_t stream_id,
+                                                      std::span<const std::uint8_t> payload, const StreamSink &sink);
+
+    [[nodiscard]] std::expected<void, Error> on_data(std::uint8_t flags, std::uint32_t stream_id,
+                                                     std::span<const std::uint8_t> payload, const StreamSink &sink);
+
+    [[nodiscard]] std::expected<void, Error> on_headers(std::uint8_t flags, std::uint32_t stream_id,
+                                                        std::span<const std::uint8_t> payload, const StreamSink &sink);
+
+    /// A complete header block for @p stream_id.
+    [[nodiscard]] std::expected<void, Error> on_header_block(std::uint32_t stream_id, bool end_stream,
+                                                             const StreamSink &sink);
+
+    [[nodiscard]] std::expected<void, Error> on_settings(std::uint8_t flags, std::uint32_t stream_id,
+                                                         std::span<const std::uint8_t> payload);
+
+    [[nodiscard]] std::expected<void, Error> on_goaway(std::uint32_t stream_id, std::span<const std::uint8_t> payload,
+                                                       const StreamSink &sink);
+
+    [[nodiscard]] std::expected<void, Error> on_window_update(std::uint32_t stream_id,
+                                                              std::span<const std::uint8_t> payload);
+
+    /// End a stream of ours with @p result.
+    void finish(std::uint32_t stream_id, Result result, const StreamSink &sink);
+
+    /// End a stream with an error of ours, telling the server too.
+    [[nodiscard]] std::expected<void, Error> fail_stream(std::uint32_t stream_id, std::uint32_t code, Error error,
+                                                         const StreamSink &sink);
+
+    /// Fail the connection: GOAWAY with @p code, if it can still be sent.
+    [[nodiscard]] Error fail(std::uint32_t code, Error error);
+
+    /// Whether @p stream_id is one we opened (whether or not still open).
+    [[nodiscard]] bool opened(std::uint32_t stream_id) const noexcept;
+
+    /// Queue a frame header for @p length bytes of payload.
+    void put_frame_header(std::size_t length, std::uint8_t type, std::uint8_t flags, std::uint32_t stream_id);
+
+    /// Send what is queued.
+    [[nodiscard]] std::expected<void, Error> flush();
+
+    Transport::Stream &stream_;
+    Hpack::Decoder decoder_;
+
+    std::unordered_map<std::uint32_t, StreamState> streams_;
+    std::uint32_t next_stream_id_{1};
+
+    /// Bytes read, not yet forming a complete frame.
+    std::vector<std::uint8_t> in_;
+    /// Frames waiting to be sent.
+    std::vector<std::uint8_t> out_;
+
+    /// Header block being received in HEADERS + CONTINUATION frames.
+    std::vector<std::uint8_t> header_block_;
+    std::uint32_t header_stream_{0};
+    bool header_end_stream_{false};
+
+    // ── Server's settings, and windows for what we send ──
+    std::size_t max_concurrent_streams_;
+    std::size_t max_frame_size_;
+    std::int64_t initial_window_;
+    std::int64_t send_window_;
+
+    /// Connection receive window bytes consumed since the last update.
+    std::size_t recv_consumed_{0};
+
+    bool failed_{false};
+    bool going_away_{false};
+};
+
+}  // namespace Http::H2
+
+#endif  // YADDNSC_HTTP2_H
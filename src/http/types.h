@@ -43,6 +43,11 @@ enum class Error {
     // ── HTTP body reading ──
     BODY_TOO_LARGE,      ///< Body size exceeds maximum allowed size.
     CHUNK_PARSE_FAILED,  ///< Malformed chunked transfer encoding.
+
+    // ── HTTP/2 ──
+    PROTOCOL_ERROR,      ///< The peer broke HTTP/2 framing or stream rules.
+    COMPRESSION_FAILED,  ///< Malformed HPACK header block.
+    STREAM_RESET,        ///< The server reset the stream, or went away before processing it.
 };
 
 /// Return a human-readable name for an HTTP error code.
@@ -68,6 +73,12 @@ enum class Error {
             return "BODY_TOO_LARGE"sv;
         case Error::CHUNK_PARSE_FAILED:
             return "CHUNK_PARSE_FAILED"sv;
+        case Error::PROTOCOL_ERROR:
+            return "PROTOCOL_ERROR"sv;
+        case Error::COMPRESSION_FAILED:
+            return "COMPRESSION_FAILED"sv;
+        case Error::STREAM_RESET:
+            return "STREAM_RESET"sv;
     }
 
     return "UNKNOWN"sv;
@@ -5,8 +5,10 @@
 #include "iface_util.h"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <stdexcept>
+#include <utility>
 
 #include "network/inet_address.h"
 #include "network/net_devices.h"
@@ -21,7 +23,14 @@
 namespace {
     using InterfaceMap = std::map<std::string, std::vector<InetAddress> >;
 
+    /// Live table, when the Manager runs an AddressMonitor.
+    std::atomic<const NetDevices::AddressMonitor *> attached_monitor{nullptr};
+
     [[nodiscard]] InterfaceMap get_cached_interfaces() {
+        if (const auto *monitor = attached_monitor.load(std::memory_order_acquire)) {
+            return monitor->snapshot();
+        }
+
         static Utils::Cache::TtlCache<std::monostate, InterfaceMap> cache(std::chrono::seconds(5));
         return cache.get_or_compute(std::monostate{}, [] { return NetDevices::enumerate_interfaces(); });
     }
@@ -40,9 +49,20 @@ std::vector<std::string> InterfaceUtil::get_interfaces() {
 }
 
 std::vector<InetAddress> InterfaceUtil::get_addresses(const std::string &interface_name) {
+    if (const auto *monitor = attached_monitor.load(std::memory_order_acquire)) {
+        if (auto addresses = monitor->get_addresses(interface_name)) {
+            return std::move(*addresses);
+        }
+        throw std::runtime_error(fmt::format("Interface {} not found", interface_name));
+    }
+
     auto all = get_cached_interfaces();
     if (const auto it = all.find(interface_name); it != all.end()) {
         return it->second;
     }
     throw std::runtime_error(fmt::format("Interface {} not found", interface_name));
 }
+
+void InterfaceUtil::attach_monitor(const NetDevices::AddressMonitor *monitor) noexcept {
+    attached_monitor.store(monitor, std::memory_order_release);
+}
@@ -10,12 +10,17 @@
 
 class InetAddress;
 
+namespace NetDevices {
+    class AddressMonitor;
+}
+
 /// InterfaceUtil — low-level utility for enumerating local network interfaces
 ///                 and their IP addresses.
 ///
 /// Encapsulates the getifaddrs() call with a short-lived TTL cache so that
 /// multiple callers (InterfaceIpSource, ConfigValidator, CLI) share the same
-/// snapshot without hammering the kernel.
+/// snapshot without hammering the kernel.  While an AddressMonitor is
+/// attached, lookups are served from its live table instead.
 ///
 /// @note Thread-safe: all public functions are guarded by an internal mutex.
 namespace InterfaceUtil {
@@ -29,6 +34,11 @@ namespace InterfaceUtil {
     /// @return                IP addresses assigned to the interface.
     /// @throws std::runtime_error  If the interface does not exist.
     [[nodiscard]] std::vector<InetAddress> get_addresses(const std::string &interface_name);
+
+    /// Serve lookups from a live AddressMonitor instead of the TTL cache.
+    /// @param monitor  Non-owning; pass nullptr to detach.  The caller must
+    ///                 detach before destroying the monitor.
+    void attach_monitor(const NetDevices::AddressMonitor *monitor) noexcept;
 } // namespace InterfaceUtil
 
 #endif // YADDNSC_INTERFACE_UTIL_H
@@ -0,0 +1,89 @@
+//
+// Created by Kotarou on 2026/7/14.
+//
+
+#include "registry.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "util/cache.hpp"
+
+#include "base.h"
+
+// ===========================================================================
+// IpSourceKey
+// ===========================================================================
+
+IpSourceKey IpSourceKey::from(const Config::SubdomainConfig &cfg) {
+    return IpSourceKey{
+        .source = cfg.ip_source,
+        .param = cfg.ip_source_param,
+        .interface = cfg.interface,
+        .type = cfg.type,
+    };
+}
+
+std::size_t std::hash<IpSourceKey>::operator()(const IpSourceKey &key) const noexcept {
+    auto seed = std::hash<std::string>{}(key.param);
+    const auto mix = [&seed](std::size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    };
+    mix(std::hash<std::string>{}(key.interface));
+    mix(static_cast<std::size_t>(key.source));
+    mix(static_cast<std::size_t>(key.type));
+    return seed;
+}
+
+// ===========================================================================
+// IpSourceRegistry::Impl
+// ===========================================================================
+
+struct IpSourceRegistry::Impl {
+    Impl(Factory factory, std::chrono::nanoseconds ttl) : factory_(std::move(factory)), results_(ttl) {
+    }
+
+    /// Return the shared source for a key, creating it on first use.
+    [[nodiscard]] const IpSourceBase &source_for(const IpSourceKey &key, const Config::SubdomainConfig &cfg);
+
+    Factory factory_;
+
+    mutable std::mutex sources_mtx_;
+    std::unordered_map<IpSourceKey, std::unique_ptr<IpSourceBase> > sources_;
+
+    Utils::Cache::TtlCache<IpSourceKey, std::vector<InetAddress> > results_;
+};
+
+const IpSourceBase &IpSourceRegistry::Impl::source_for(const IpSourceKey &key, const Config::SubdomainConfig &cfg) {
+    std::lock_guard lock(sources_mtx_);
+    auto &source = sources_[key];
+    if (!source) {
+        source = factory_(cfg);
+    }
+    return *source;
+}
+
+// ===========================================================================
+// IpSourceRegistry public API
+// ===========================================================================
+
+IpSourceRegistry::IpSourceRegistry(Factory factory, std::chrono::nanoseconds ttl)
+    : impl_(std::make_unique<Impl>(std::move(factory), ttl)) {
+}
+
+IpSourceRegistry::~IpSourceRegistry() = default;
+
+std::vector<InetAddress> IpSourceRegistry::resolve(const Config::SubdomainConfig &cfg) const {
+    auto key = IpSourceKey::from(cfg);
+    if (cfg.ip_source == Config::IpSource::INTERFACE) {
+        return impl_->source_for(key, cfg).resolve();
+    }
+
+    return impl_->results_.get_or_compute(key, [&] { return impl_->source_for(key, cfg).resolve(); });
+}
+
+std::size_t IpSourceRegistry::source_count() const {
+    std::lock_guard lock(impl_->sources_mtx_);
+    return impl_->sources_.size();
+}
@@ -0,0 +1,88 @@
+//
+// Created by Kotarou on 2026/7/14.
+//
+
+#ifndef YADDNSC_IP_SOURCE_REGISTRY_H
+#define YADDNSC_IP_SOURCE_REGISTRY_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "network/inet_address.h"
+#include "record_kind.h"
+
+#include "mixin.h"
+
+class IpSourceBase;
+
+/// Identity of an IP source: two subdomains with equal keys observe the same
+/// address, so they can share one source instance and one resolve() result.
+///
+/// The record type stands in for the address family because it is what the
+/// factory derives the family (and, for mDNS, the query type) from.
+struct IpSourceKey {
+    Config::IpSource source{};
+    std::string param;
+    std::string interface;
+    RecordKind type{};
+
+    [[nodiscard]] static IpSourceKey from(const Config::SubdomainConfig &cfg);
+
+    bool operator==(const IpSourceKey &) const = default;
+};
+
+template<>
+struct std::hash<IpSourceKey> {
+    std::size_t operator()(const IpSourceKey &key) const noexcept;
+};
+
+/// IpSourceRegistry — long-lived, shared IP sources with single-flight
+///                    resolution.
+///
+/// Keeps one IpSourceBase per IpSourceKey for the lifetime of the registry
+/// (so e.g. an HttpIpSource keeps its keep-alive connection), and serves
+/// resolve() results from a short TTL cache.  Concurrent callers that miss
+/// the same key wait for a single in-flight resolve() instead of issuing
+/// their own; failures are propagated to every waiter and not cached.
+///
+/// Interface sources bypass the result cache: they read a local table that
+/// the AddressMonitor keeps current, and a stale cached copy would delay
+/// the update an address-change event just triggered.
+///
+/// @note Thread-safe.  A cached source's resolve() never runs concurrently
+///       with itself, because every resolve of its key goes through the
+///       single-flight cache; interface sources are stateless.
+class IpSourceRegistry {
+public:
+    using Factory = std::function<std::unique_ptr<IpSourceBase>(const Config::SubdomainConfig &)>;
+
+    /// How long a resolved address list is shared between tasks.
+    static constexpr auto DEFAULT_TTL = std::chrono::seconds(5);
+
+    /// @param factory  Creates the source for a key on first use.
+    /// @param ttl      Lifetime of a cached resolve() result.
+    explicit IpSourceRegistry(Factory factory, std::chrono::nanoseconds ttl = DEFAULT_TTL);
+
+    ~IpSourceRegistry();
+
+    /// Resolve the addresses for a subdomain's IP source.
+    /// @throws std::runtime_error  Whatever the underlying source throws.
+    [[nodiscard]] std::vector<InetAddress> resolve(const Config::SubdomainConfig &cfg) const;
+
+    /// Number of distinct source instances created so far.
+    [[nodiscard]] std::size_t source_count() const;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif  // YADDNSC_IP_SOURCE_REGISTRY_H
@@ -0,0 +1,82 @@
+//
+// Created by Kotarou on 2026/7/27.
+//
+
+#ifndef YADDNSC_NETWORK_AWAITABLE_H
+#define YADDNSC_NETWORK_AWAITABLE_H
+
+#include <chrono>
+#include <expected>
+#include <optional>
+#include <utility>
+
+#include "network/reactor.h"
+#include "network/socket.h"
+#include "network/tls_connection.h"
+#include "util/task.hpp"
+
+/// Coroutine wrappers over the Reactor-driven operations of the network
+/// layer, for use with Utils::Task.
+///
+///     const auto connected = co_await Async::connect(reactor, socket, addr, 5s);
+///     const auto revents = co_await Async::wait(reactor, socket, POLLIN, 5s);
+///
+/// Each awaitable registers its operation with the reactor on suspension
+/// and resumes the coroutine on the reactor thread; it must therefore be
+/// awaited on the reactor thread, like every other non-thread-safe Reactor
+/// call.  Failures are returned, never thrown, matching the Socket /
+/// TlsConnection methods they wrap.
+namespace Async {
+    /// co_await Socket::async_connect().
+    /// @return The connect outcome.
+    [[nodiscard]] inline auto connect(Reactor &reactor, Socket &socket, const SocketAddr &addr,
+                                      std::chrono::milliseconds timeout) {
+        using Result = std::expected<void, ConnectError>;
+        return Utils::await_callback<Result>([&reactor, &socket, addr, timeout](auto on_done) -> std::optional<Result> {
+            socket.async_connect(reactor, addr, timeout, std::move(on_done));
+            return std::nullopt;
+        });
+    }
+
+    /// co_await Socket::async_wait().
+    /// @return The ready events, 0 on timeout, or errno if the socket cannot
+    ///         be registered.
+    [[nodiscard]] inline auto wait(Reactor &reactor, const Socket &socket, short events,
+                                   std::chrono::milliseconds timeout) {
+        using Result = std::expected<short, int>;
+        return Utils::await_callback<Result>([&reactor, &socket, events, timeout](auto on_ready) -> std::optional<Result> {
+            auto registered = socket.async_wait(reactor, events, timeout,
+                                                [on_ready = std::move(on_ready)](short revents) { on_ready(revents); });
+            if (!registered) {
+                return std::unexpected(registered.error());
+            }
+            return std::nullopt;
+        });
+    }
+
+    /// co_await TlsConnection::async_wait(), between OpenSSL retries.
+    /// @return OK (retry the SSL call), TIMEOUT or ERROR.
+    [[nodiscard]] inline auto wait(Reactor &reactor, const TlsConnection &connection, short default_events,
+                                   std::chrono::milliseconds timeout) {
+        using Result = TlsConnection::IoStatus;
+        return Utils::await_callback<Result>(
+            [&reactor, &connection, default_events, timeout](auto on_ready) -> std::optional<Result> {
+                auto registered = connection.async_wait(reactor, default_events, timeout, std::move(on_ready));
+                if (!registered) {
+                    return registered.error();
+                }
+                return std::nullopt;
+            });
+    }
+
+    /// co_await a Reactor timer.
+    /// @return true, once @p delay has elapsed.
+    [[nodiscard]] inline auto sleep_for(Reactor &reactor, std::chrono::milliseconds delay) {
+        return Utils::await_callback<bool>([&reactor, delay](auto on_fired) -> std::optional<bool> {
+            [[maybe_unused]] auto id = reactor.add_timer(delay, [on_fired = std::move(on_fired)] { on_fired(true); });
+            return std::nullopt;
+        });
+    }
+} // namespace Async
+
+#endif // YADDNSC_NETWORK_AWAITABLE_H
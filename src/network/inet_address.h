@@ -14,6 +14,7 @@
 #include <variant>
 
 #include "address_family.h"
+#include "util/small_vector.hpp"
 
 // ---------------------------------------------------------------------------
 // Inet4Address — lightweight IPv4 address value type.
@@ -261,4 +262,9 @@ private:
     variant_type addr_;
 };
 
+// ---------------------------------------------------------------------------
+// AddressList — the handful of addresses a lookup returns, stored inline.
+// ---------------------------------------------------------------------------
+using AddressList = Utils::SmallVector<InetAddress, 4>;
+
 #endif  // YADDNSC_NETWORK_INET_ADDRESS_H
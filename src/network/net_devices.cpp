@@ -7,12 +7,32 @@
 #include <net/if.h>
 #include <ifaddrs.h>
 #include <netinet/in.h>
+#include <poll.h>
 #include <sys/socket.h>
 
+#ifdef __linux__
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
 #include <span>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <stdexcept>
+#include <string_view>
 #include <cstdint>
+#include <thread>
+#include <utility>
+
+#include "util/fd.hpp"
+
+#include <spdlog/spdlog.h>
 
 // ===========================================================================
 // Internal helpers
@@ -30,19 +50,35 @@ namespace {
 
         return {ifa, &freeifaddrs};
     }
-} // anonymous namespace
 
-// ===========================================================================
-// NetDevices::enumerate_interfaces
-// ===========================================================================
+    using InterfaceMap = NetDevices::AddressMonitor::InterfaceMap;
 
-namespace NetDevices {
-    std::map<std::string, std::vector<InetAddress> > enumerate_interfaces() {
-        std::map<std::string, std::vector<InetAddress> > result;
+    /// Names of the interfaces whose address list differs between two
+    /// snapshots (present in only one of them, or with different contents).
+    [[nodiscard]] std::vector<std::string> diff_interfaces(const InterfaceMap &before, const InterfaceMap &after) {
+        std::vector<std::string> changed;
+        for (const auto &[name, addresses]: before) {
+            const auto it = after.find(name);
+            if (it == after.end() || it->second != addresses) {
+                changed.push_back(name);
+            }
+        }
+        for (const auto &[name, _]: after) {
+            if (!before.contains(name)) {
+                changed.push_back(name);
+            }
+        }
+        return changed;
+    }
+
+    /// Addresses of every interface, in getifaddrs() order, or of just
+    /// @p only when it is non-empty.
+    [[nodiscard]] InterfaceMap collect_addresses(std::string_view only = {}) {
+        InterfaceMap result;
         auto ifaddrs = query_ifaddrs();
 
         for (auto *ifa = ifaddrs.get(); ifa != nullptr; ifa = ifa->ifa_next) {
-            if (ifa->ifa_addr == nullptr) {
+            if (ifa->ifa_addr == nullptr || (!only.empty() && only != ifa->ifa_name)) {
                 continue;
             }
 
@@ -69,6 +105,16 @@ namespace NetDevices {
 
         return result;
     }
+} // anonymous namespace
+
+// ===========================================================================
+// NetDevices::enumerate_interfaces
+// ===========================================================================
+
+namespace NetDevices {
+    std::map<std::string, std::vector<InetAddress> > enumerate_interfaces() {
+        return collect_addresses();
+    }
 
     std::vector<Ipv4Subnet> get_ipv4_subnets(const std::string &iface_name) {
         std::vector<Ipv4Subnet> result;
@@ -141,4 +187,299 @@ namespace NetDevices {
         }
         return {};
     }
+
+    // =======================================================================
+    // AddressMonitor
+    // =======================================================================
+
+    struct AddressMonitor::Impl {
+        Impl(ChangeCallback on_change, std::chrono::milliseconds poll_interval);
+
+        /// Replace the table with a fresh enumeration and notify every
+        /// interface that changed.  Used by the polling fallback and to
+        /// recover from a netlink receive-buffer overrun.
+        void resync();
+
+        /// Fallback loop: re-enumerate every poll interval.
+        void poll_loop(const std::stop_token &st);
+
+        void notify(const std::vector<std::string> &names) const;
+
+#ifdef __linux__
+        /// Open and bind the rtnetlink socket.  Leaves netlink_fd_ closed on
+        /// failure so the caller can fall back to polling.
+        void open_netlink();
+
+        /// Event loop: wait for netlink datagrams and apply them.
+        void netlink_loop(const std::stop_token &st);
+
+        /// Apply one RTM_NEWADDR / RTM_DELADDR message to the table.
+        /// @return The name of the interface that changed, if any.
+        [[nodiscard]] std::optional<std::string> apply(const nlmsghdr *header);
+
+        Utils::UniqueFd netlink_fd_;
+        std::map<unsigned int, std::string> index_names_; ///< ifindex → name, survives link removal
+#endif
+
+        ChangeCallback on_change_;
+        std::chrono::milliseconds poll_interval_;
+
+        mutable std::mutex mtx_;
+        std::condition_variable_any cv_;
+        InterfaceMap table_;
+
+        std::jthread worker_; // declared last: joined before the state above is destroyed
+    };
+
+    AddressMonitor::Impl::Impl(ChangeCallback on_change, std::chrono::milliseconds poll_interval)
+        : on_change_(std::move(on_change)), poll_interval_(poll_interval) {
+#ifdef __linux__
+        // Subscribe before seeding, so no event between the two is lost.
+        open_netlink();
+#endif
+        table_ = enumerate_interfaces();
+
+#ifdef __linux__
+        if (netlink_fd_) {
+            for (const auto &[name, _]: table_) {
+                if (const auto index = name_to_index(name); index != 0) {
+                    index_names_[index] = name;
+                }
+            }
+            // NOLINTNEXTLINE(performance-unnecessary-value-param) — std::stop_token must be by-value for jthread
+            worker_ = std::jthread([this](std::stop_token st) { netlink_loop(st); });
+            return;
+        }
+#endif
+        // NOLINTNEXTLINE(performance-unnecessary-value-param) — std::stop_token must be by-value for jthread
+        worker_ = std::jthread([this](std::stop_token st) { poll_loop(st); });
+    }
+
+    void AddressMonitor::Impl::resync() {
+        auto fresh = enumerate_interfaces();
+
+        std::vector<std::string> changed;
+        {
+            std::lock_guard lock(mtx_);
+            changed = diff_interfaces(table_, fresh);
+            table_ = std::move(fresh);
+#ifdef __linux__
+            for (const auto &[name, _]: table_) {
+                if (const auto index = name_to_index(name); index != 0) {
+                    index_names_[index] = name;
+                }
+            }
+#endif
+        }
+
+        notify(changed);
+    }
+
+    void AddressMonitor::Impl::poll_loop(const std::stop_token &st) {
+        while (!st.stop_requested()) {
+            {
+                std::unique_lock lock(mtx_);
+                if (cv_.wait_for(lock, st, poll_interval_, [] { return false; }) || st.stop_requested()) {
+                    break;
+                }
+            }
+
+            try {
+                resync();
+            } catch (const std::exception &e) {
+                SPDLOG_WARN("Interface re-enumeration failed: {}", e.what());
+            }
+        }
+    }
+
+    void AddressMonitor::Impl::notify(const std::vector<std::string> &names) const {
+        if (!on_change_) {
+            return;
+        }
+
+        for (const auto &name: names) {
+            SPDLOG_DEBUG("Addresses of interface {} changed", name);
+            on_change_(name);
+        }
+    }
+
+#ifdef __linux__
+    void AddressMonitor::Impl::open_netlink() {
+        Utils::UniqueFd fd(::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE));
+        if (!fd) {
+            SPDLOG_WARN("rtnetlink socket unavailable (errno {}), polling interfaces instead", errno);
+            return;
+        }
+
+        sockaddr_nl local{};
+        local.nl_family = AF_NETLINK;
+        local.nl_groups = RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR;
+        if (::bind(fd.get(), reinterpret_cast<const sockaddr *>(&local), sizeof(local)) != 0) {
+            SPDLOG_WARN("rtnetlink bind failed (errno {}), polling interfaces instead", errno);
+            return;
+        }
+
+        netlink_fd_ = std::move(fd);
+    }
+
+    void AddressMonitor::Impl::netlink_loop(const std::stop_token &st) {
+        // Short poll timeout so a stop request is noticed promptly without a
+        // separate wake-up descriptor.
+        constexpr int POLL_TIMEOUT_MS = 200;
+        alignas(nlmsghdr) std::array<char, 16384> buffer{};
+
+        while (!st.stop_requested()) {
+            pollfd pfd{.fd = netlink_fd_.get(), .events = POLLIN, .revents = 0};
+            const auto ready = ::poll(&pfd, 1, POLL_TIMEOUT_MS);
+            if (ready <= 0) {
+                continue;
+            }
+
+            while (true) {
+                const auto len = ::recv(netlink_fd_.get(), buffer.data(), buffer.size(), 0);
+                if (len < 0) {
+                    if (errno == ENOBUFS) {
+                        // The kernel dropped events; the table may be stale.
+                        SPDLOG_WARN("rtnetlink receive buffer overrun, re-enumerating interfaces");
+                        try {
+                            resync();
+                        } catch (const std::exception &e) {
+                            SPDLOG_WARN("Interface re-enumeration failed: {}", e.what());
+                        }
+                        continue;
+                    }
+                    break; // EAGAIN: drained
+                }
+
+                std::set<std::string> changed;
+                auto remaining = static_cast<unsigned int>(len);
+                for (auto *header = reinterpret_cast<const nlmsghdr *>(buffer.data()); NLMSG_OK(header, remaining);
+                     header = NLMSG_NEXT(header, remaining)) {
+                    if (auto name = apply(header)) {
+                        changed.insert(std::move(*name));
+                    }
+                }
+
+                notify(std::vector<std::string>(changed.begin(), changed.end()));
+            }
+        }
+    }
+
+    std::optional<std::string> AddressMonitor::Impl::apply(const nlmsghdr *header) {
+        if (header->nlmsg_type != RTM_NEWADDR && header->nlmsg_type != RTM_DELADDR) {
+            return std::nullopt;
+        }
+
+        const auto *ifa = static_cast<const ifaddrmsg *>(NLMSG_DATA(header));
+        if (ifa->ifa_family != AF_INET && ifa->ifa_family != AF_INET6) {
+            return std::nullopt;
+        }
+
+        // For IPv4, IFA_LOCAL is the interface's own address; IFA_ADDRESS is
+        // the peer on point-to-point links such as PPPoE.
+        const rtattr *address = nullptr;
+        const rtattr *local = nullptr;
+        auto attr_len = static_cast<int>(IFA_PAYLOAD(header));
+        for (auto *rta = IFA_RTA(ifa); RTA_OK(rta, attr_len); rta = RTA_NEXT(rta, attr_len)) {
+            if (rta->rta_type == IFA_ADDRESS) {
+                address = rta;
+            } else if (rta->rta_type == IFA_LOCAL) {
+                local = rta;
+            }
+        }
+
+        const auto *attr = ifa->ifa_family == AF_INET && local != nullptr ? local : address;
+        if (attr == nullptr) {
+            return std::nullopt;
+        }
+
+        const auto bytes = std::span{static_cast<const std::uint8_t *>(RTA_DATA(attr)), RTA_PAYLOAD(attr)};
+        auto parsed = InetAddress::from_bytes(bytes);
+        if (!parsed) {
+            return std::nullopt;
+        }
+
+        std::lock_guard lock(mtx_);
+
+        auto name = index_to_name(ifa->ifa_index);
+        if (name.empty()) {
+            // The link is already gone (RTM_DELADDR on interface removal).
+            const auto it = index_names_.find(ifa->ifa_index);
+            if (it == index_names_.end()) {
+                return std::nullopt;
+            }
+            name = it->second;
+        } else {
+            index_names_[ifa->ifa_index] = name;
+        }
+
+        // Match getifaddrs(): only link-local IPv6 addresses carry a scope.
+        if (parsed->is_link_local()) {
+            parsed->visit([&](auto &addr) {
+                if constexpr (requires { addr.set_scope_id(0U); }) {
+                    addr.set_scope_id(ifa->ifa_index);
+                }
+            });
+        }
+
+        auto &addresses = table_[name];
+        const auto existing = std::ranges::find(addresses, *parsed);
+        if (header->nlmsg_type == RTM_NEWADDR) {
+            if (existing != addresses.end()) {
+                return std::nullopt; // lifetime refresh, address unchanged
+            }
+            // getifaddrs() lists a new address ahead of older ones of the same
+            // scope, and the first candidate is the one published; re-read the
+            // interface so the table keeps the kernel's order, as resync() does.
+            try {
+                auto fresh = collect_addresses(name);
+                if (const auto it = fresh.find(name); it != fresh.end()) {
+                    addresses = std::move(it->second);
+                } else {
+                    table_.erase(name); // removed again before we looked
+                }
+            } catch (const std::exception &e) {
+                SPDLOG_WARN("Interface re-enumeration failed: {}", e.what());
+                addresses.push_back(*parsed);
+            }
+        } else {
+            if (existing == addresses.end()) {
+                return std::nullopt;
+            }
+            addresses.erase(existing);
+            if (addresses.empty()) {
+                table_.erase(name);
+            }
+        }
+
+        return name;
+    }
+#endif
+
+    AddressMonitor::AddressMonitor(ChangeCallback on_change, std::chrono::milliseconds poll_interval)
+        : impl_(std::make_unique<Impl>(std::move(on_change), poll_interval)) {
+    }
+
+    AddressMonitor::~AddressMonitor() = default;
+
+    std::optional<std::vector<InetAddress> > AddressMonitor::get_addresses(const std::string &name) const {
+        std::lock_guard lock(impl_->mtx_);
+        if (const auto it = impl_->table_.find(name); it != impl_->table_.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    AddressMonitor::InterfaceMap AddressMonitor::snapshot() const {
+        std::lock_guard lock(impl_->mtx_);
+        return impl_->table_;
+    }
+
+    bool AddressMonitor::is_event_driven() const noexcept {
+#ifdef __linux__
+        return static_cast<bool>(impl_->netlink_fd_);
+#else
+        return false;
+#endif
+    }
 } // namespace NetDevices
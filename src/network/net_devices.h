@@ -7,7 +7,11 @@
 
 #include <sys/socket.h>
 
+#include <chrono>
+#include <functional>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -75,6 +79,58 @@ namespace NetDevices {
     /// FreeBSD/macOS) by scanning getifaddrs() for the IFF_LOOPBACK flag.
     /// @return  Loopback interface name, or empty string if none is found.
     [[nodiscard]] std::string loopback_name();
+
+    // -----------------------------------------------------------------------
+    //  Address change monitoring
+    // -----------------------------------------------------------------------
+
+    /// AddressMonitor — live interface → addresses table.
+    ///
+    /// Seeded with enumerate_interfaces() and then kept current by a
+    /// background thread:
+    ///   - Linux:  an rtnetlink socket subscribed to RTM_NEWADDR /
+    ///             RTM_DELADDR patches the table per event, so a PPPoE or
+    ///             DHCP address change is seen within milliseconds.
+    ///   - Others (or if the netlink socket cannot be opened): the table is
+    ///             re-enumerated every poll interval and diffed.
+    ///
+    /// Either way, @p on_change is invoked with the name of every interface
+    /// whose address list changed.
+    ///
+    /// @note Thread-safe.  The callback runs on the monitor thread and must
+    ///       not block.
+    class AddressMonitor {
+    public:
+        using InterfaceMap = std::map<std::string, std::vector<InetAddress> >;
+        using ChangeCallback = std::function<void(const std::string &interface_name)>;
+
+        /// Seed the table and start the monitor thread.
+        /// @param on_change      Called with the name of each changed interface.
+        /// @param poll_interval  Re-enumeration period of the polling fallback.
+        /// @throws std::runtime_error  If the initial enumeration fails.
+        explicit AddressMonitor(ChangeCallback on_change,
+                                std::chrono::milliseconds poll_interval = std::chrono::seconds(5));
+
+        ~AddressMonitor();
+
+        AddressMonitor(const AddressMonitor &) = delete;
+
+        AddressMonitor &operator=(const AddressMonitor &) = delete;
+
+        /// Current addresses of one interface, or std::nullopt if the
+        /// interface has no address.
+        [[nodiscard]] std::optional<std::vector<InetAddress> > get_addresses(const std::string &name) const;
+
+        /// Copy of the whole table.
+        [[nodiscard]] InterfaceMap snapshot() const;
+
+        /// True when changes arrive as kernel events rather than by polling.
+        [[nodiscard]] bool is_event_driven() const noexcept;
+
+    private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
 } // namespace NetDevices
 
 #endif  // YADDNSC_NETWORK_NET_DEVICES_H
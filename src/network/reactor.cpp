@@ -0,0 +1,634 @@
+//
+// Created by Kotarou on 2026/7/24.
+//
+
+#include "network/reactor.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "config_cmake.h"
+#include "util/fd.hpp"
+
+#ifdef HAVE_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifdef HAVE_KQUEUE
+#include <sys/types.h>
+#include <sys/event.h>
+#include <sys/time.h>
+#endif
+
+// ===========================================================================
+//  Pollers — one per kernel interface, behind a common shape
+// ===========================================================================
+
+namespace {
+    /// One readiness report.  @c tag identifies the registration the event
+    /// belongs to, so an event for an fd that was removed and re-added in
+    /// the same round is not delivered to the new watch.
+    struct ReadyEvent {
+        int fd;
+        std::uint32_t tag;
+        short revents;
+    };
+
+    [[nodiscard]] std::system_error system_error(int error, const char *what) {
+        return {error, std::generic_category(), what};
+    }
+
+    class Poller {
+    public:
+        virtual ~Poller() = default;
+
+        [[nodiscard]] virtual std::expected<void, int> add(int fd, short events, std::uint32_t tag) = 0;
+
+        [[nodiscard]] virtual std::expected<void, int> modify(int fd, short events, std::uint32_t tag) = 0;
+
+        virtual void remove(int fd) noexcept = 0;
+
+        /// Append the ready fds to @p out, waiting at most @p timeout_ms.
+        /// EINTR counts as an empty round.
+        [[nodiscard]] virtual std::expected<void, int> wait(std::vector<ReadyEvent> &out, int timeout_ms) = 0;
+    };
+
+#ifdef HAVE_EPOLL
+    class EpollPoller final : public Poller {
+    public:
+        EpollPoller() : epfd_(::epoll_create1(EPOLL_CLOEXEC)) {
+            if (!epfd_) {
+                throw system_error(errno, "epoll_create1");
+            }
+        }
+
+        std::expected<void, int> add(int fd, short events, std::uint32_t tag) override {
+            return control(EPOLL_CTL_ADD, fd, events, tag);
+        }
+
+        std::expected<void, int> modify(int fd, short events, std::uint32_t tag) override {
+            return control(EPOLL_CTL_MOD, fd, events, tag);
+        }
+
+        void remove(int fd) noexcept override {
+            ::epoll_ctl(epfd_.get(), EPOLL_CTL_DEL, fd, nullptr);
+        }
+
+        std::expected<void, int> wait(std::vector<ReadyEvent> &out, int timeout_ms) override {
+            const int n = ::epoll_wait(epfd_.get(), buffer_.data(), static_cast<int>(buffer_.size()), timeout_ms);
+            if (n < 0) {
+                return errno == EINTR ? std::expected<void, int>{} : std::unexpected(errno);
+            }
+
+            for (int i = 0; i < n; ++i) {
+                const auto &ev = buffer_[i];
+                out.push_back(ReadyEvent{
+                    .fd = static_cast<int>(ev.data.u64 & 0xFFFFFFFFU),
+                    .tag = static_cast<std::uint32_t>(ev.data.u64 >> 32),
+                    .revents = from_epoll(ev.events),
+                });
+            }
+            return {};
+        }
+
+    private:
+        [[nodiscard]] std::expected<void, int> control(int op, int fd, short events, std::uint32_t tag) const {
+            epoll_event ev{};
+            ev.events = to_epoll(events);
+            ev.data.u64 = (static_cast<std::uint64_t>(tag) << 32) | static_cast<std::uint32_t>(fd);
+            if (::epoll_ctl(epfd_.get(), op, fd, &ev) < 0) {
+                return std::unexpected(errno);
+            }
+            return {};
+        }
+
+        [[nodiscard]] static std::uint32_t to_epoll(short events) noexcept {
+            std::uint32_t out = 0;
+            if (events & POLLIN) out |= EPOLLIN;
+            if (events & POLLOUT) out |= EPOLLOUT;
+            if (events & POLLPRI) out |= EPOLLPRI;
+            return out;
+        }
+
+        [[nodiscard]] static short from_epoll(std::uint32_t events) noexcept {
+            short out = 0;
+            if (events & EPOLLIN) out |= POLLIN;
+            if (events & EPOLLOUT) out |= POLLOUT;
+            if (events & EPOLLPRI) out |= POLLPRI;
+            if (events & EPOLLERR) out |= POLLERR;
+            if (events & EPOLLHUP) out |= POLLHUP;
+            return out;
+        }
+
+        Utils::UniqueFd epfd_;
+        std::array<epoll_event, 256> buffer_{};
+    };
+#endif
+
+#ifdef HAVE_KQUEUE
+    class KqueuePoller final : public Poller {
+    public:
+        KqueuePoller() : kq_(::kqueue()) {
+            if (!kq_) {
+                throw system_error(errno, "kqueue");
+            }
+            ::fcntl(kq_.get(), F_SETFD, FD_CLOEXEC);
+        }
+
+        std::expected<void, int> add(int fd, short events, std::uint32_t tag) override {
+            if (auto result = apply(fd, 0, events, tag); !result) {
+                return result;
+            }
+            events_[fd] = events;
+            return {};
+        }
+
+        std::expected<void, int> modify(int fd, short events, std::uint32_t tag) override {
+            const auto it = events_.find(fd);
+            if (it == events_.end()) {
+                return std::unexpected(ENOENT);
+            }
+            if (auto result = apply(fd, it->second, events, tag); !result) {
+                return result;
+            }
+            it->second = events;
+            return {};
+        }
+
+        void remove(int fd) noexcept override {
+            const auto it = events_.find(fd);
+            if (it == events_.end()) {
+                return;
+            }
+            [[maybe_unused]] auto _ = apply(fd, it->second, 0, 0);
+            events_.erase(it);
+        }
+
+        std::expected<void, int> wait(std::vector<ReadyEvent> &out, int timeout_ms) override {
+            timespec ts{};
+            const timespec *timeout = nullptr;
+            if (timeout_ms >= 0) {
+                ts.tv_sec = timeout_ms / 1000;
+                ts.tv_nsec = static_cast<long>(timeout_ms % 1000) * 1'000'000L;
+                timeout = &ts;
+            }
+
+            const int n = ::kevent(kq_.get(), nullptr, 0, buffer_.data(), static_cast<int>(buffer_.size()), timeout);
+            if (n < 0) {
+                return errno == EINTR ? std::expected<void, int>{} : std::unexpected(errno);
+            }
+
+            for (int i = 0; i < n; ++i) {
+                const auto &ev = buffer_[i];
+                short revents = ev.filter == EVFILT_READ ? POLLIN : POLLOUT;
+                if (ev.flags & EV_EOF) revents |= POLLHUP;
+                if (ev.flags & EV_ERROR) revents = POLLERR;
+                out.push_back(ReadyEvent{
+                    .fd = static_cast<int>(ev.ident),
+                    .tag = static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(ev.udata)),
+                    .revents = revents,
+                });
+            }
+            return {};
+        }
+
+    private:
+        /// Add, re-tag or delete the read and write filters to go from
+        /// @p from to @p to.
+        [[nodiscard]] std::expected<void, int> apply(int fd, short from, short to, std::uint32_t tag) const {
+            std::array<struct kevent, 2> changes{};
+            int count = 0;
+            for (const auto [bit, filter]: {std::pair{POLLIN, EVFILT_READ}, std::pair{POLLOUT, EVFILT_WRITE}}) {
+                if (to & bit) {
+                    EV_SET(&changes[count++], fd, filter, EV_ADD | EV_ENABLE, 0, 0,
+                           reinterpret_cast<void *>(static_cast<std::uintptr_t>(tag)));
+                } else if (from & bit) {
+                    EV_SET(&changes[count++], fd, filter, EV_DELETE, 0, 0, nullptr);
+                }
+            }
+
+            if (count > 0 && ::kevent(kq_.get(), changes.data(), count, nullptr, 0, nullptr) < 0) {
+                return std::unexpected(errno);
+            }
+            return {};
+        }
+
+        Utils::UniqueFd kq_;
+        std::unordered_map<int, short> events_;
+        std::array<struct kevent, 256> buffer_{};
+    };
+#endif
+
+    class PollPoller final : public Poller {
+    public:
+        std::expected<void, int> add(int fd, short events, std::uint32_t tag) override {
+            fds_.push_back(pollfd{.fd = fd, .events = events, .revents = 0});
+            tags_.push_back(tag);
+            return {};
+        }
+
+        std::expected<void, int> modify(int fd, short events, std::uint32_t tag) override {
+            const auto idx = find(fd);
+            if (idx == fds_.size()) {
+                return std::unexpected(ENOENT);
+            }
+            fds_[idx].events = events;
+            tags_[idx] = tag;
+            return {};
+        }
+
+        void remove(int fd) noexcept override {
+            const auto idx = find(fd);
+            if (idx == fds_.size()) {
+                return;
+            }
+            fds_[idx] = fds_.back();
+            tags_[idx] = tags_.back();
+            fds_.pop_back();
+            tags_.pop_back();
+        }
+
+        std::expected<void, int> wait(std::vector<ReadyEvent> &out, int timeout_ms) override {
+            const int n = ::poll(fds_.data(), static_cast<nfds_t>(fds_.size()), timeout_ms);
+            if (n < 0) {
+                return errno == EINTR ? std::expected<void, int>{} : std::unexpected(errno);
+            }
+
+            int found = 0;
+            for (std::size_t i = 0; i < fds_.size() && found < n; ++i) {
+                auto revents = fds_[i].revents;
+                if (revents == 0) {
+                    continue;
+                }
+                ++found;
+                if (revents & POLLNVAL) {
+                    revents = static_cast<short>((revents & ~POLLNVAL) | POLLERR);
+                }
+                out.push_back(ReadyEvent{.fd = fds_[i].fd, .tag = tags_[i], .revents = revents});
+            }
+            return {};
+        }
+
+    private:
+        [[nodiscard]] std::size_t find(int fd) const noexcept {
+            const auto it = std::ranges::find(fds_, fd, &pollfd::fd);
+            return static_cast<std::size_t>(it - fds_.begin());
+        }
+
+        std::vector<pollfd> fds_;
+        std::vector<std::uint32_t> tags_; // parallel to fds_
+    };
+
+    [[nodiscard]] std::unique_ptr<Poller> make_poller(Reactor::Backend backend) {
+        switch (backend) {
+#ifdef HAVE_EPOLL
+            case Reactor::Backend::EPOLL:
+                return std::make_unique<EpollPoller>();
+#endif
+#ifdef HAVE_KQUEUE
+            case Reactor::Backend::KQUEUE:
+                return std::make_unique<KqueuePoller>();
+#endif
+            case Reactor::Backend::POLL:
+                return std::make_unique<PollPoller>();
+            default:
+                throw std::runtime_error("Reactor backend is not available on this platform");
+        }
+    }
+
+    /// Tag reserved for the wake-up pipe; watch tags start at 1.
+    constexpr std::uint32_t WAKE_TAG = 0;
+} // anonymous namespace
+
+// ===========================================================================
+//  Reactor::Impl
+// ===========================================================================
+
+struct Reactor::Impl {
+    struct Watch {
+        std::uint32_t tag;
+        /// Shared so that a callback can remove its own watch while running.
+        std::shared_ptr<IoCallback> callback;
+    };
+
+    struct TimerEntry {
+        Clock::time_point deadline;
+        TimerId id;
+
+        bool operator>(const TimerEntry &other) const noexcept {
+            return deadline != other.deadline ? deadline > other.deadline : id > other.id;
+        }
+    };
+
+    explicit Impl(Backend backend);
+
+    /// Milliseconds the next kernel wait may block for.
+    [[nodiscard]] int wait_timeout(std::chrono::milliseconds max_wait);
+
+    std::size_t dispatch_io();
+
+    std::size_t dispatch_timers();
+
+    std::size_t dispatch_posted();
+
+    void drain_wake_pipe() const noexcept;
+
+    Backend backend_;
+    std::unique_ptr<Poller> poller_;
+
+    // ---- fd watches --------------------------------------------------------
+    std::unordered_map<int, Watch> watches_;
+    std::uint32_t next_tag_{WAKE_TAG};
+    std::vector<ReadyEvent> ready_;
+
+    // ---- timers (cancelled entries are skipped lazily) ---------------------
+    std::priority_queue<TimerEntry, std::vector<TimerEntry>, std::greater<> > timer_queue_;
+    std::unordered_map<TimerId, TimerCallback> timers_;
+    TimerId next_timer_{0};
+
+    // ---- cross-thread ------------------------------------------------------
+    std::mutex posted_mtx_;
+    std::vector<std::function<void()> > posted_;
+    Utils::UniqueFd wake_read_;
+    Utils::UniqueFd wake_write_;
+};
+
+Reactor::Impl::Impl(Backend backend) : backend_(backend), poller_(make_poller(backend)) {
+    auto [read_end, write_end] = Utils::make_pipe();
+    if (!read_end || !write_end) {
+        throw system_error(errno, "pipe");
+    }
+    ::fcntl(read_end.get(), F_SETFL, ::fcntl(read_end.get(), F_GETFL) | O_NONBLOCK);
+    ::fcntl(write_end.get(), F_SETFL, ::fcntl(write_end.get(), F_GETFL) | O_NONBLOCK);
+    wake_read_ = std::move(read_end);
+    wake_write_ = std::move(write_end);
+
+    if (auto added = poller_->add(wake_read_.get(), POLLIN, WAKE_TAG); !added) {
+        throw system_error(added.error(), "register wake-up pipe");
+    }
+}
+
+int Reactor::Impl::wait_timeout(std::chrono::milliseconds max_wait) {
+    {
+        std::lock_guard lock(posted_mtx_);
+        if (!posted_.empty()) {
+            return 0;
+        }
+    }
+
+    while (!timer_queue_.empty() && !timers_.contains(timer_queue_.top().id)) {
+        timer_queue_.pop();
+    }
+
+    auto timeout = std::max(max_wait, std::chrono::milliseconds::zero());
+    if (!timer_queue_.empty()) {
+        const auto until_timer =
+                std::chrono::ceil<std::chrono::milliseconds>(timer_queue_.top().deadline - Clock::now());
+        timeout = std::clamp(until_timer, std::chrono::milliseconds::zero(), timeout);
+    }
+    return static_cast<int>(std::min<std::chrono::milliseconds::rep>(timeout.count(), std::numeric_limits<int>::max()));
+}
+
+std::size_t Reactor::Impl::dispatch_io() {
+    std::size_t count = 0;
+    for (const auto &[fd, tag, revents]: ready_) {
+        if (tag == WAKE_TAG) {
+            drain_wake_pipe();
+            continue;
+        }
+
+        const auto it = watches_.find(fd);
+        if (it == watches_.end() || it->second.tag != tag) {
+            continue; // removed (or replaced) by an earlier callback of this round
+        }
+
+        const auto callback = it->second.callback;
+        (*callback)(revents);
+        ++count;
+    }
+    return count;
+}
+
+std::size_t Reactor::Impl::dispatch_timers() {
+    // Timers added by a callback of this round are due no earlier than the
+    // next round, so a zero-delay timer cannot starve fd watches.
+    const auto now = Clock::now();
+    std::size_t count = 0;
+    while (!timer_queue_.empty() && timer_queue_.top().deadline <= now) {
+        const auto id = timer_queue_.top().id;
+        timer_queue_.pop();
+
+        auto node = timers_.extract(id);
+        if (node.empty()) {
+            continue; // cancelled
+        }
+        node.mapped()();
+        ++count;
+    }
+    return count;
+}
+
+std::size_t Reactor::Impl::dispatch_posted() {
+    std::vector<std::function<void()> > tasks;
+    {
+        std::lock_guard lock(posted_mtx_);
+        tasks.swap(posted_);
+    }
+
+    for (const auto &task: tasks) {
+        task();
+    }
+    return tasks.size();
+}
+
+void Reactor::Impl::drain_wake_pipe() const noexcept {
+    std::array<char, 64> buf{};
+    while (::read(wake_read_.get(), buf.data(), buf.size()) > 0) {
+    }
+}
+
+// ===========================================================================
+//  Reactor public API
+// ===========================================================================
+
+Reactor::Reactor() : Reactor(default_backend()) {
+}
+
+Reactor::Reactor(Backend backend) : impl_(std::make_unique<Impl>(backend)) {
+}
+
+Reactor::~Reactor() = default;
+
+std::expected<void, int> Reactor::add(int fd, short events, IoCallback callback) {
+    if (fd < 0 || fd == impl_->wake_read_.get()) {
+        return std::unexpected(EBADF);
+    }
+    if (impl_->watches_.contains(fd)) {
+        return std::unexpected(EEXIST);
+    }
+
+    // Skip WAKE_TAG when the counter wraps.
+    auto tag = ++impl_->next_tag_;
+    if (tag == WAKE_TAG) {
+        tag = ++impl_->next_tag_;
+    }
+
+    if (auto added = impl_->poller_->add(fd, events, tag); !added) {
+        return added;
+    }
+
+    impl_->watches_.emplace(fd, Impl::Watch{
+                                .tag = tag,
+                                .callback = std::make_shared<IoCallback>(std::move(callback)),
+                            });
+    return {};
+}
+
+std::expected<void, int> Reactor::modify(int fd, short events) {
+    const auto it = impl_->watches_.find(fd);
+    if (it == impl_->watches_.end()) {
+        return std::unexpected(ENOENT);
+    }
+
+    return impl_->poller_->modify(fd, events, it->second.tag);
+}
+
+void Reactor::remove(int fd) noexcept {
+    const auto it = impl_->watches_.find(fd);
+    if (it == impl_->watches_.end()) {
+        return;
+    }
+
+    impl_->poller_->remove(fd);
+    impl_->watches_.erase(it);
+}
+
+std::expected<void, int> Reactor::wait_once(int fd, short events, std::chrono::milliseconds timeout,
+                                            IoCallback callback) {
+    auto shared = std::make_shared<IoCallback>(std::move(callback));
+
+    std::optional<TimerId> timer;
+    if (timeout >= std::chrono::milliseconds::zero()) {
+        timer = add_timer(timeout, [this, fd, shared] {
+            remove(fd);
+            (*shared)(0);
+        });
+    }
+
+    auto added = add(fd, events, [this, fd, timer, shared](short revents) {
+        if (timer) {
+            cancel_timer(*timer);
+        }
+        remove(fd);
+        (*shared)(revents);
+    });
+
+    if (!added && timer) {
+        cancel_timer(*timer);
+    }
+    return added;
+}
+
+Reactor::TimerId Reactor::add_timer(std::chrono::milliseconds delay, TimerCallback callback) {
+    const auto id = ++impl_->next_timer_;
+    impl_->timers_.emplace(id, std::move(callback));
+    impl_->timer_queue_.push(Impl::TimerEntry{.deadline = Clock::now() + delay, .id = id});
+    return id;
+}
+
+bool Reactor::cancel_timer(TimerId id) noexcept {
+    return impl_->timers_.erase(id) > 0;
+}
+
+void Reactor::post(std::function<void()> task) {
+    {
+        std::lock_guard lock(impl_->posted_mtx_);
+        impl_->posted_.push_back(std::move(task));
+    }
+    wakeup();
+}
+
+void Reactor::wakeup() noexcept {
+    // A full pipe already guarantees a wake-up, so EAGAIN is fine.
+    constexpr char byte = 1;
+    [[maybe_unused]] auto _ = ::write(impl_->wake_write_.get(), &byte, 1);
+}
+
+std::size_t Reactor::run_once(std::chrono::milliseconds max_wait) {
+    auto &impl = *impl_;
+
+    impl.ready_.clear();
+    if (auto waited = impl.poller_->wait(impl.ready_, impl.wait_timeout(max_wait)); !waited) {
+        throw system_error(waited.error(), "reactor wait");
+    }
+
+    auto count = impl.dispatch_io();
+    count += impl.dispatch_timers();
+    count += impl.dispatch_posted();
+    return count;
+}
+
+void Reactor::run(std::stop_token stop_token) {
+    std::stop_callback on_stop(stop_token, [this] { wakeup(); });
+    while (!stop_token.stop_requested()) {
+        run_once(std::chrono::minutes(1));
+    }
+}
+
+Reactor::Backend Reactor::backend() const noexcept {
+    return impl_->backend_;
+}
+
+std::size_t Reactor::watch_count() const noexcept {
+    return impl_->watches_.size();
+}
+
+std::size_t Reactor::timer_count() const noexcept {
+    return impl_->timers_.size();
+}
+
+Reactor::Backend Reactor::default_backend() noexcept {
+#if defined(HAVE_EPOLL)
+    return Backend::EPOLL;
+#elif defined(HAVE_KQUEUE)
+    return Backend::KQUEUE;
+#else
+    return Backend::POLL;
+#endif
+}
+
+bool Reactor::is_available(Backend backend) noexcept {
+    switch (backend) {
+        case Backend::EPOLL:
+#ifdef HAVE_EPOLL
+            return true;
+#else
+            return false;
+#endif
+        case Backend::KQUEUE:
+#ifdef HAVE_KQUEUE
+            return true;
+#else
+            return false;
+#endif
+        case Backend::POLL:
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,144 @@
+//
+// Created by Kotarou on 2026/7/24.
+//
+
+#ifndef YADDNSC_NETWORK_REACTOR_H
+#define YADDNSC_NETWORK_REACTOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <stop_token>
+
+#include "mixin.h"
+
+/// Single-threaded I/O reactor: readiness callbacks for file descriptors,
+/// plus one-shot timers.
+///
+/// Instead of blocking a thread in poll() per operation, an operation
+/// registers its fd with the reactor and returns; the reactor thread calls
+/// back when the fd becomes ready.  One thread can thus drive any number of
+/// concurrent DNS queries, TLS handshakes or HTTP exchanges.
+///
+/// Readiness is level-triggered and expressed with the poll(2) event bits
+/// (POLLIN, POLLOUT, POLLERR, POLLHUP), the same bits Socket::wait_for()
+/// takes.  The kernel interface is chosen at construction:
+///   - EPOLL   Linux epoll(7)
+///   - KQUEUE  BSD / macOS kqueue(2)
+///   - POLL    portable poll(2) fallback, O(n) per wait
+///
+/// Callbacks run on the thread that calls run_once() / run(), and may
+/// freely add, modify or remove watches and timers (including their own).
+///
+/// @note Only post() and wakeup() are thread-safe; every other method must
+///       be called on the reactor thread (or before it starts).
+class Reactor {
+public:
+    /// Kernel readiness interface.
+    enum class Backend {
+        EPOLL,
+        KQUEUE,
+        POLL,
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Called with the ready events (a subset of the watched events, plus
+    /// POLLERR / POLLHUP which are always reported).
+    using IoCallback = std::function<void(short revents)>;
+
+    using TimerCallback = std::function<void()>;
+
+    using TimerId = std::uint64_t;
+
+    /// Construct with the best backend available on this platform.
+    /// @throws std::runtime_error if the kernel object cannot be created.
+    Reactor();
+
+    /// Construct with an explicit backend.
+    /// @throws std::runtime_error if @p backend is unavailable here or its
+    ///         kernel object cannot be created.
+    explicit Reactor(Backend backend);
+
+    ~Reactor();
+
+    // ---- fd watches --------------------------------------------------------
+
+    /// Start watching @p fd.  The fd must not already be watched.
+    /// @return errno on failure.
+    [[nodiscard]] std::expected<void, int> add(int fd, short events, IoCallback callback);
+
+    /// Change the events watched on @p fd.
+    /// @return errno on failure (ENOENT if @p fd is not watched).
+    [[nodiscard]] std::expected<void, int> modify(int fd, short events);
+
+    /// Stop watching @p fd.  Must be called before the fd is closed.
+    /// A no-op if @p fd is not watched.
+    void remove(int fd) noexcept;
+
+    /// Wait once for @p events on @p fd, or until @p timeout elapses.
+    ///
+    /// The watch and its timer are removed before @p callback runs, which
+    /// receives the ready events, or 0 on timeout.
+    /// @return errno on failure to register (the callback is not called).
+    [[nodiscard]] std::expected<void, int> wait_once(int fd, short events, std::chrono::milliseconds timeout,
+                                                     IoCallback callback);
+
+    // ---- timers ------------------------------------------------------------
+
+    /// Call @p callback once, @p delay from now.
+    [[nodiscard]] TimerId add_timer(std::chrono::milliseconds delay, TimerCallback callback);
+
+    /// Cancel a pending timer.
+    /// @return false if the timer already fired or was cancelled.
+    bool cancel_timer(TimerId id) noexcept;
+
+    // ---- cross-thread ------------------------------------------------------
+
+    /// Queue @p task to run on the reactor thread and wake it.  Thread-safe.
+    void post(std::function<void()> task);
+
+    /// Interrupt a blocked run_once().  Thread-safe.
+    void wakeup() noexcept;
+
+    // ---- loop --------------------------------------------------------------
+
+    /// Wait for at most @p max_wait (less if a timer is due sooner), then
+    /// dispatch every ready watch, due timer and posted task.
+    /// @return Number of callbacks invoked.
+    /// @throws std::runtime_error if the kernel wait fails; exceptions from
+    ///         callbacks propagate (the remaining events of the round are
+    ///         dropped and reported again by the next call).
+    std::size_t run_once(std::chrono::milliseconds max_wait);
+
+    /// Dispatch until @p stop_token is triggered.
+    void run(std::stop_token stop_token);
+
+    // ---- introspection -----------------------------------------------------
+
+    [[nodiscard]] Backend backend() const noexcept;
+
+    /// Number of watched fds.
+    [[nodiscard]] std::size_t watch_count() const noexcept;
+
+    /// Number of pending timers.
+    [[nodiscard]] std::size_t timer_count() const noexcept;
+
+    /// The backend picked by Reactor().
+    [[nodiscard]] static Backend default_backend() noexcept;
+
+    /// Whether @p backend is compiled in on this platform.
+    [[nodiscard]] static bool is_available(Backend backend) noexcept;
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_NETWORK_REACTOR_H
@@ -139,6 +139,19 @@ namespace {
                 return ConnectError::INTERNAL;
         }
     }
+
+    /// Outcome of a non-blocking connect whose fd has become writable.
+    [[nodiscard]] std::expected<void, ConnectError> pending_connect_result(int fd) noexcept {
+        int error = 0;
+        socklen_t elen = sizeof(error);
+        if (::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &elen) < 0) {
+            return std::unexpected(ConnectError::INTERNAL);
+        }
+        if (error != 0) {
+            return std::unexpected(to_connect_error(error));
+        }
+        return {};
+    }
 } // anonymous namespace
 
 // ===========================================================================
@@ -342,13 +355,8 @@ std::expected<void, ConnectError> Socket::connect(const SocketAddr &addr, int ti
     }
 
     // Check socket error status.
-    int error = 0;
-    socklen_t elen = sizeof(error);
-    if (::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &elen) < 0) {
-        return std::unexpected(ConnectError::INTERNAL);
-    }
-    if (error != 0) {
-        return std::unexpected(to_connect_error(error));
+    if (auto result = pending_connect_result(fd_); !result) {
+        return result;
     }
 
     // Restore original flags.
@@ -359,6 +367,45 @@ std::expected<void, ConnectError> Socket::connect(const SocketAddr &addr, int ti
     return {};
 }
 
+void Socket::async_connect(Reactor &reactor, const SocketAddr &addr, std::chrono::milliseconds timeout,
+                           ConnectCallback on_done) {
+    // Every outcome is delivered from the reactor thread, never from here.
+    const auto complete_later = [&reactor, &on_done](std::expected<void, ConnectError> result) {
+        reactor.post([on_done = std::move(on_done), result] { on_done(result); });
+    };
+
+    if (!set_nonblocking(true)) {
+        complete_later(std::unexpected(ConnectError::INTERNAL));
+        return;
+    }
+
+    int rc;
+    do {
+        rc = ::connect(fd_, addr.raw(), addr.raw_len());
+    } while (rc < 0 && errno == EINTR);
+
+    if (rc == 0) {
+        complete_later({});
+        return;
+    }
+
+    if (errno != EINPROGRESS) {
+        complete_later(std::unexpected(to_connect_error(errno)));
+        return;
+    }
+
+    const auto registered = reactor.wait_once(fd_, POLLOUT, timeout, [fd = fd_, on_done](short revents) {
+        if (revents == 0) {
+            on_done(std::unexpected(ConnectError::TIMED_OUT));
+            return;
+        }
+        on_done(pending_connect_result(fd));
+    });
+    if (!registered) {
+        complete_later(std::unexpected(ConnectError::INTERNAL));
+    }
+}
+
 // ===========================================================================
 //  Listening + accept
 // ===========================================================================
@@ -549,6 +596,11 @@ void Socket::close() noexcept {
     [[maybe_unused]] auto _ = ::close(fd);
 }
 
+std::expected<void, int> Socket::async_wait(Reactor &reactor, short events, std::chrono::milliseconds timeout,
+                                           Reactor::IoCallback on_ready) const {
+    return reactor.wait_once(fd_, events, timeout, std::move(on_ready));
+}
+
 std::expected<int, int> Socket::wait_for(short events, int timeout_ms) const noexcept {
     return wait_for(events, timeout_ms, {});
 }
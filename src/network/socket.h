@@ -6,10 +6,13 @@
 #define YADDNSC_NETWORK_SOCKET_H
 
 #include <cerrno>
+#include <chrono>
 #include <cstddef>
 #include <expected>
+#include <functional>
 #include <span>
 
+#include "network/reactor.h"
 #include "network/socket_addr.h"
 
 #include "mixin.h"
@@ -119,6 +122,8 @@ public:
 //   - Setup/control (bind, set_nonblocking, wait_for):  return std::expected<void, int> or std::expected<int, int>, do NOT throw.
 //   - listen:  throw SocketException.
 //   - Destructor and close():  noexcept (errors silently ignored).
+//   - async_connect / async_wait:  report through the callback (or, for
+//     async_wait, a failed registration as std::expected), do NOT throw.
 //
 // Thread-safety: a single Socket object must not be used from multiple threads
 // simultaneously.  Distinct Socket objects are independent.
@@ -169,6 +174,16 @@ public:
     [[nodiscard]] std::expected<void, ConnectError> connect(
         const SocketAddr &addr, int timeout_sec = -1) override;
 
+    using ConnectCallback = std::function<void(std::expected<void, ConnectError>)>;
+
+    /// Connect without blocking: the connect is started here and completed
+    /// by @p reactor, which calls @p on_done with the outcome on its own
+    /// thread (also when the connect succeeds or fails immediately).
+    /// Leaves the socket non-blocking.  The socket must stay open until
+    /// @p on_done has run.
+    void async_connect(Reactor &reactor, const SocketAddr &addr, std::chrono::milliseconds timeout,
+                       ConnectCallback on_done);
+
     // ---- Listening + accept (server) ---------------------------------------
 
     void listen(int backlog = SOMAXCONN) const;
@@ -226,6 +241,13 @@ public:
     [[nodiscard]] std::expected<int, int> wait_for(short events, int timeout_ms,
                                                    const Utils::CancellationToken &cancel_token) const noexcept override;
 
+    /// Reactor counterpart of wait_for(): returns at once, and @p reactor
+    /// later calls @p on_ready with the ready events, or 0 on timeout.
+    /// @return errno if the socket cannot be registered.
+    [[nodiscard]] std::expected<void, int> async_wait(Reactor &reactor, short events,
+                                                      std::chrono::milliseconds timeout,
+                                                      Reactor::IoCallback on_ready) const;
+
     // ---- Accessors ---------------------------------------------------------
 
     [[nodiscard]] int native_handle() const noexcept override {
@@ -10,13 +10,18 @@
 #include <cerrno>
 #include <chrono>
 #include <cstring>
+#include <exception>
 #include <expected>
+#include <memory>
 #include <source_location>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "config_cmake.h"
 #include "exception/tls.h"
 #include "network/inet_address.h"
+#include "network/tls_session_cache.h"
 #include "util/cert_util.h"
 #include "util/validation.hpp"
 
@@ -25,9 +30,80 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <poll.h>
+#include <pthread.h>
+#include <signal.h>
 #include <spdlog/spdlog.h>
 #include <sys/socket.h>
 
+// ===========================================================================
+//  SIGPIPE suppression
+//
+//  OpenSSL writes to the socket with write(2), which takes no MSG_NOSIGNAL:
+//  a write after the peer reset the connection (a request on a connection
+//  the server just closed, or the close_notify sent when closing it) would
+//  kill the process.  Where MSG_NOSIGNAL exists (Linux), SIGPIPE is blocked
+//  in the writing thread instead, and one raised meanwhile is consumed
+//  before it is unblocked.  Elsewhere SO_NOSIGPIPE is set on the socket
+//  once connected, as socket.cpp does.
+// ===========================================================================
+
+namespace {
+
+class SigpipeGuard {
+public:
+    SigpipeGuard() noexcept {
+#ifdef HAVE_MSG_NOSIGNAL
+        sigset_t pending;
+        sigemptyset(&pending);
+        sigpending(&pending);
+        // One already pending belongs to someone else: leave it be.
+        already_pending_ = sigismember(&pending, SIGPIPE) == 1;
+
+        sigset_t block;
+        sigemptyset(&block);
+        sigaddset(&block, SIGPIPE);
+        blocked_ = pthread_sigmask(SIG_BLOCK, &block, &previous_) == 0;
+#endif
+    }
+
+    ~SigpipeGuard() {
+#ifdef HAVE_MSG_NOSIGNAL
+        if (!blocked_) {
+            return;
+        }
+        const auto saved_errno = errno;
+        if (!already_pending_) {
+            sigset_t pending;
+            sigemptyset(&pending);
+            sigpending(&pending);
+            if (sigismember(&pending, SIGPIPE) == 1) {
+                sigset_t sigpipe;
+                sigemptyset(&sigpipe);
+                sigaddset(&sigpipe, SIGPIPE);
+                const timespec no_wait{};
+                while (sigtimedwait(&sigpipe, nullptr, &no_wait) < 0 && errno == EINTR) {
+                }
+            }
+        }
+        pthread_sigmask(SIG_SETMASK, &previous_, nullptr);
+        errno = saved_errno;
+#endif
+    }
+
+    SigpipeGuard(const SigpipeGuard &) = delete;
+
+    SigpipeGuard &operator=(const SigpipeGuard &) = delete;
+
+private:
+#ifdef HAVE_MSG_NOSIGNAL
+    sigset_t previous_{};
+    bool blocked_{false};
+    bool already_pending_{false};
+#endif
+};
+
+}  // anonymous namespace
+
 // ===========================================================================
 //  RAII deleter implementations
 // ===========================================================================
@@ -62,6 +138,43 @@ namespace {
     }
 } // anonymous namespace
 
+// ===========================================================================
+//  Session resumption
+//
+//  Connections on the shared default SSL_CTX save their sessions in
+//  TlsSessionCache and offer them again on the next connect().  Each SSL
+//  carries its cache key as ex_data, for the new-session callback: a TLS 1.2
+//  session arrives at the end of the handshake, TLS 1.3 tickets after it,
+//  while reading.
+// ===========================================================================
+
+namespace {
+    void free_session_key(void *, void *ptr, CRYPTO_EX_DATA *, int, long, void *) {
+        delete static_cast<std::string *>(ptr);
+    }
+
+    /// ex_data index of the cache key (a heap-allocated std::string) on an SSL.
+    [[nodiscard]] int session_key_index() {
+        static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, free_session_key);
+        return index;
+    }
+
+    int on_new_session(SSL *ssl, SSL_SESSION *session) {
+        const auto *key = static_cast<const std::string *>(SSL_get_ex_data(ssl, session_key_index()));
+        if (!key) {
+            return 0;
+        }
+        // From here on the session is ours (return 1), cached or not.
+        SslSessionPtr owned(session);
+        try {
+            TlsSessionCache::instance().put(*key, std::move(owned));
+        } catch (const std::exception &e) {
+            SPDLOG_WARN("Failed to cache TLS session: {}", e.what());
+        }
+        return 1;
+    }
+} // anonymous namespace
+
 // ===========================================================================
 //  Construction / destruction
 // ===========================================================================
@@ -70,14 +183,18 @@ TlsConnection::TlsConnection(std::string server, std::uint16_t port, TlsOptions
     : server_(std::move(server)), port_(port), sni_hostname_(std::move(opts.sni_hostname)),
       connect_timeout_(opts.connect_timeout), read_timeout_ms_(opts.read_timeout),
       write_timeout_ms_(opts.write_timeout), alpn_proto_(opts.alpn_proto.begin(), opts.alpn_proto.end()),
-      context_factory_(std::move(context_factory)) {
+      context_factory_(std::move(context_factory)), early_data_(opts.early_data) {
     // Validate server address eagerly so the caller gets a clear error.
     if (!InetAddress::parse(server_).has_value() && !Utils::is_valid_domain(server_)) {
         throw TlsException(fmt::format(R"(Invalid server address: "{}" (not a valid IP or domain name))", server_));
     }
 }
 
-TlsConnection::~TlsConnection() = default;
+TlsConnection::~TlsConnection() {
+    // Freeing the BIO sends close_notify.
+    SigpipeGuard guard;
+    bio_.reset();
+}
 
 
 // ===========================================================================
@@ -86,6 +203,8 @@ TlsConnection::~TlsConnection() = default;
 
 std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
     close();
+    // The handshake writes too.
+    SigpipeGuard guard;
 
     // Resolve the SSL_CTX: custom factory or shared default.
     SSL_CTX *ctx;
@@ -111,6 +230,10 @@ std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
 
     const auto target = fmt::format("{}:{}", server_, port_);
 
+    session_key_.clear();
+    early_limit_ = 0;
+    SslSessionPtr offered;
+
     SSL *ssl = nullptr;
     BIO_get_ssl(bio.get(), &ssl);
     if (ssl) {
@@ -129,6 +252,31 @@ std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
                 return std::unexpected(log_ssl_error("SSL_set_alpn_protos"));
             }
         }
+
+        // A custom context may verify differently: a session it accepted
+        // must not be resumed under another, nor the other way round.
+        if (!context_factory_) {
+            session_key_ = TlsSessionCache::make_key(server_, port_, effective_hostname, alpn_proto_);
+            auto key = std::make_unique<std::string>(session_key_);
+            if (SSL_set_ex_data(ssl, session_key_index(), key.get()) == 1) {
+                key.release();
+                offered = TlsSessionCache::instance().take(session_key_);
+                if (offered && SSL_set_session(ssl, offered.get()) != 1) {
+                    ERR_clear_error();
+                    offered.reset();
+                }
+            } else {
+                session_key_.clear();
+            }
+        }
+
+        if (early_data_ && offered && SSL_SESSION_get_max_early_data(offered.get()) > 0) {
+            early_limit_ = SSL_SESSION_get_max_early_data(offered.get());
+            const unsigned char *alpn = nullptr;
+            std::size_t alpn_len = 0;
+            SSL_SESSION_get0_alpn_selected(offered.get(), &alpn, &alpn_len);
+            early_alpn_.assign(reinterpret_cast<const char *>(alpn), alpn_len);
+        }
     }
 
     if (BIO_set_conn_hostname(bio.get(), target.c_str()) != 1) {
@@ -140,18 +288,27 @@ std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
 
     const auto deadline = std::chrono::steady_clock::now() + connect_timeout_;
 
+    // With early data, only the TCP connection (the connect BIO under the
+    // SSL BIO): the handshake starts with the first send_all().
+    const bool defer_handshake = early_limit_ > 0;
+    BIO *const connecting = defer_handshake ? BIO_next(bio.get()) : bio.get();
+
     for (;;) {
         // Clear retry flags before each attempt so that BIO_should_retry
         // reflects the result of this call, not a stale value from a prior
         // iteration.  (OpenSSL internally clears flags for ssl BIO in
         // non-blocking mode, but being explicit here is defensive.)
-        BIO_clear_retry_flags(bio.get());
+        BIO_clear_retry_flags(connecting);
 
-        const auto ret = BIO_do_connect(bio.get());
+        const auto ret = BIO_do_connect(connecting);
         if (ret == 1)
             break;
 
-        if (!BIO_should_retry(bio.get())) {
+        if (!BIO_should_retry(connecting)) {
+            if (offered) {
+                // Do not offer it again, in case it is why.
+                TlsSessionCache::instance().remove(session_key_);
+            }
             return std::unexpected(log_ssl_error(fmt::format(R"(TLS connect/handshake failed for "{}")", target)));
         }
 
@@ -162,7 +319,7 @@ std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
 
         const auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
 
-        const auto pstatus = poll_bio(bio.get(), POLLOUT, {}, remaining_ms);
+        const auto pstatus = poll_bio(connecting, POLLOUT, {}, remaining_ms);
         if (pstatus == IoStatus::TIMEOUT) {
             return std::unexpected(IoStatus::TIMEOUT);
         }
@@ -181,18 +338,35 @@ std::expected<void, TlsConnection::IoStatus> TlsConnection::connect() {
         if (::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) < 0) {
             SPDLOG_WARN(R"(Failed to set TCP_NODELAY on TLS socket to "{}": {})", target, std::strerror(errno));
         }
+#if !defined(HAVE_MSG_NOSIGNAL) && defined(SO_NOSIGPIPE)
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+    }
+
+    if (defer_handshake) {
+        SPDLOG_TRACE(R"(TCP connection established to "{}", TLS handshake deferred for early data)", target);
+        handshake_pending_ = true;
+        bio_ = std::move(bio);
+        return {};
     }
 
     SSL *connected_ssl = nullptr;
     BIO_get_ssl(bio.get(), &connected_ssl);
-    SPDLOG_TRACE(R"(TLS connection established to "{}" (tls_version: {}))", target,
-                 connected_ssl ? SSL_get_version(connected_ssl) : "?");
+    [[maybe_unused]] const bool resumed = count_handshake(connected_ssl);
+    SPDLOG_TRACE(R"(TLS connection established to "{}" (tls_version: {}, resumed: {}))", target,
+                 connected_ssl ? SSL_get_version(connected_ssl) : "?", resumed);
 
     bio_ = std::move(bio);
     return {};
 }
 
 void TlsConnection::close() noexcept {
+    handshake_pending_ = false;
+    early_sent_.clear();
+    early_data_accepted_ = false;
+
+    // Freeing the BIO sends close_notify.
+    SigpipeGuard guard;
     bio_.reset();
 }
 
@@ -229,6 +403,17 @@ bool TlsConnection::is_healthy() const noexcept {
     return n > 0; // n == 0 means EOF.
 }
 
+int TlsConnection::native_fd() const noexcept {
+    if (!bio_)
+        return -1;
+    return static_cast<int>(BIO_get_fd(bio_.get(), nullptr));
+}
+
+bool TlsConnection::has_pending() const noexcept {
+    auto *ssl = get_ssl();
+    return ssl && (SSL_pending(ssl) > 0 || SSL_has_pending(ssl) == 1);
+}
+
 // ===========================================================================
 //  I/O
 // ===========================================================================
@@ -243,6 +428,19 @@ TlsConnection::send_all(std::span<const std::uint8_t> data, const Utils::Cancell
     if (!bio_)
         return std::unexpected(IoStatus::ERROR);
 
+    SigpipeGuard guard;
+    if (handshake_pending_) {
+        if (early_sent_.size() + data.size() <= early_limit_) {
+            return send_early(data, cancel_token);
+        }
+        if (auto done = finish_handshake(cancel_token); !done) {
+            return done;
+        }
+    }
+
+    // A read that timed out left its retry direction behind, which says
+    // nothing about this write.
+    BIO_clear_retry_flags(bio_.get());
     while (!data.empty()) {
         const auto status = poll_bio(bio_.get(), POLLOUT, cancel_token, write_timeout_ms_);
         if (status != IoStatus::OK)
@@ -269,6 +467,9 @@ TlsConnection::read_exact(std::span<std::uint8_t> buf, const Utils::Cancellation
     if (!bio_)
         return std::unexpected(IoStatus::ERROR);
 
+    if (auto done = finish_handshake(cancel_token); !done)
+        return done;
+
     auto *ssl = get_ssl();
 
     while (!buf.empty()) {
@@ -295,7 +496,8 @@ TlsConnection::read_exact(std::span<std::uint8_t> buf, const Utils::Cancellation
 
 std::expected<void, TlsConnection::IoStatus> TlsConnection::shutdown() {
     auto *ssl = get_ssl();
-    if (!ssl)
+    // Nothing to close before the handshake.
+    if (!ssl || handshake_pending_)
         return std::unexpected(IoStatus::ERROR);
 
     bool first = true;
@@ -328,6 +530,9 @@ TlsConnection::read_some(std::span<std::uint8_t> buf, const Utils::CancellationT
     if (!bio_)
         return std::unexpected(IoStatus::ERROR);
 
+    if (auto done = finish_handshake(cancel_token); !done)
+        return std::unexpected(done.error());
+
     auto *ssl = get_ssl();
 
     for (;;) {
@@ -353,6 +558,10 @@ std::string TlsConnection::negotiated_alpn() const noexcept {
     if (!ssl)
         return {};
 
+    // The server must choose the same protocol to accept the early data.
+    if (handshake_pending_)
+        return early_alpn_;
+
     const unsigned char *data = nullptr;
     unsigned int len = 0;
     SSL_get0_alpn_selected(ssl, &data, &len);
@@ -364,16 +573,113 @@ void TlsConnection::set_sni_hostname(std::string hostname) {
 }
 
 // ===========================================================================
-//  Internals
+//  Early data
+//
+//  SSL_write_early_data() sends the ClientHello with the first write, and
+//  SSL_connect() completes the handshake.  Data the server rejected was
+//  skipped by it, as if never sent, and goes out again as ordinary data.
 // ===========================================================================
 
-TlsConnection::IoStatus TlsConnection::poll_bio(BIO *bio, short default_events,
-                                                const Utils::CancellationToken &cancel_token,
-                                                std::chrono::milliseconds timeout) {
-    const int fd = static_cast<int>(BIO_get_fd(bio, nullptr));
-    if (fd < 0)
-        return IoStatus::ERROR;
+std::expected<void, TlsConnection::IoStatus>
+TlsConnection::send_early(std::span<const std::uint8_t> data, const Utils::CancellationToken &cancel_token) {
+    auto *ssl = get_ssl();
+    if (!ssl)
+        return std::unexpected(IoStatus::ERROR);
 
+    for (;;) {
+        ERR_clear_error();
+        std::size_t written = 0;
+        const int ret = SSL_write_early_data(ssl, data.data(), data.size(), &written);
+        if (ret == 1)
+            break;
+        if (auto status = wait_ssl(ssl, ret, cancel_token, write_timeout_ms_); !status)
+            return status;
+    }
+
+    early_sent_.insert(early_sent_.end(), data.begin(), data.end());
+    return {};
+}
+
+std::expected<void, TlsConnection::IoStatus>
+TlsConnection::finish_handshake(const Utils::CancellationToken &cancel_token) {
+    if (!handshake_pending_)
+        return {};
+
+    auto *ssl = get_ssl();
+    if (!ssl)
+        return std::unexpected(IoStatus::ERROR);
+
+    SigpipeGuard guard;
+    const auto deadline = std::chrono::steady_clock::now() + connect_timeout_;
+    for (;;) {
+        ERR_clear_error();
+        const int ret = SSL_connect(ssl);
+        if (ret == 1)
+            break;
+
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return std::unexpected(IoStatus::TIMEOUT);
+        const auto remaining_ms = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+        if (auto status = wait_ssl(ssl, ret, cancel_token, remaining_ms); !status)
+            return status;
+    }
+
+    handshake_pending_ = false;
+    early_data_accepted_ = SSL_get_early_data_status(ssl) == SSL_EARLY_DATA_ACCEPTED;
+    [[maybe_unused]] const bool resumed = count_handshake(ssl);
+    SPDLOG_TRACE(R"(TLS handshake with "{}:{}" completed (tls_version: {}, resumed: {}, early data: {}))", server_,
+                 port_, SSL_get_version(ssl), resumed, early_sent_.empty() ? "none" :
+                                                       early_data_accepted_ ? "accepted" : "rejected");
+
+    const auto sent = std::exchange(early_sent_, {});
+    if (sent.empty() || early_data_accepted_)
+        return {};
+
+    // It was written for the protocol of the offered session.
+    if (negotiated_alpn() != early_alpn_) {
+        SPDLOG_DEBUG(R"(Server "{}:{}" rejected early data and changed ALPN protocol, dropping connection)",
+                     server_, port_);
+        return std::unexpected(IoStatus::ERROR);
+    }
+    return send_all(sent, cancel_token);
+}
+
+std::expected<void, TlsConnection::IoStatus> TlsConnection::wait_ssl(SSL *ssl, int ret,
+                                                                     const Utils::CancellationToken &cancel_token,
+                                                                     std::chrono::milliseconds timeout) {
+    short events;
+    switch (SSL_get_error(ssl, ret)) {
+        case SSL_ERROR_WANT_READ:
+            events = POLLIN;
+            break;
+        case SSL_ERROR_WANT_WRITE:
+            events = POLLOUT;
+            break;
+        default:
+            return std::unexpected(log_ssl_error(fmt::format(R"(TLS handshake failed for "{}:{}")", server_, port_)));
+    }
+
+    // The SSL object does its I/O on the connect BIO directly.
+    const auto status = poll_bio(BIO_next(bio_.get()), events, cancel_token, timeout);
+    if (status != IoStatus::OK)
+        return std::unexpected(status);
+    return {};
+}
+
+bool TlsConnection::count_handshake(SSL *ssl) const noexcept {
+    const bool resumed = ssl && SSL_session_reused(ssl) == 1;
+    if (!session_key_.empty()) {
+        TlsSessionCache::instance().record(resumed);
+    }
+    return resumed;
+}
+
+// ===========================================================================
+//  Internals
+// ===========================================================================
+
+short TlsConnection::bio_events(BIO *bio, short default_events) noexcept {
     // Combine BIO's need flags with the caller's default:
     // - If OpenSSL has pending handshake/renegotiation work, it tells us
     //   which direction(s) it needs via BIO_should_read / BIO_should_write.
@@ -386,6 +692,30 @@ TlsConnection::IoStatus TlsConnection::poll_bio(BIO *bio, short default_events,
         events |= POLLOUT;
     if (events == 0)
         events = default_events;
+    return events;
+}
+
+TlsConnection::IoStatus TlsConnection::readiness_status(short revents, short events) noexcept {
+    // Requested events ready → OK (even if POLLHUP is also set, data is still
+    // readable/writable). Let the subsequent BIO_read/BIO_write handle any
+    // underlying connection issues, which gives us a more accurate error.
+    if (revents & events) {
+        return IoStatus::OK;
+    }
+
+    // Pure error/hangup with no data ready → ERROR.  Anything else (no
+    // matching event) should not normally happen and is treated the same.
+    return IoStatus::ERROR;
+}
+
+TlsConnection::IoStatus TlsConnection::poll_bio(BIO *bio, short default_events,
+                                                const Utils::CancellationToken &cancel_token,
+                                                std::chrono::milliseconds timeout) {
+    const int fd = static_cast<int>(BIO_get_fd(bio, nullptr));
+    if (fd < 0)
+        return IoStatus::ERROR;
+
+    const short events = bio_events(bio, default_events);
 
     const int cancel_fd = cancel_token.native_handle();
 
@@ -414,20 +744,29 @@ TlsConnection::IoStatus TlsConnection::poll_bio(BIO *bio, short default_events,
         return IoStatus::CANCELLED;
     }
 
-    // Requested events ready → OK (even if POLLHUP is also set, data is still
-    // readable/writable). Let the subsequent BIO_read/BIO_write handle any
-    // underlying connection issues, which gives us a more accurate error.
-    if (fds[0].revents & fds[0].events) {
-        return IoStatus::OK;
+    return readiness_status(fds[0].revents, events);
+}
+
+std::expected<void, TlsConnection::IoStatus> TlsConnection::async_wait(Reactor &reactor, short default_events,
+                                                                       std::chrono::milliseconds timeout,
+                                                                       std::function<void(IoStatus)> on_ready) const {
+    if (!bio_) {
+        return std::unexpected(IoStatus::ERROR);
     }
 
-    // Pure error/hangup with no data ready → ERROR.
-    if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
-        return IoStatus::ERROR;
+    const int fd = static_cast<int>(BIO_get_fd(bio_.get(), nullptr));
+    if (fd < 0) {
+        return std::unexpected(IoStatus::ERROR);
     }
 
-    // poll() returned but no matching event — should not normally happen.
-    return IoStatus::ERROR;
+    const short events = bio_events(bio_.get(), default_events);
+    const auto on_wait = [events, on_ready = std::move(on_ready)](short revents) {
+        on_ready(revents == 0 ? IoStatus::TIMEOUT : readiness_status(revents, events));
+    };
+    if (!reactor.wait_once(fd, events, timeout, on_wait)) {
+        return std::unexpected(IoStatus::ERROR);
+    }
+    return {};
 }
 
 SSL *TlsConnection::get_ssl() const noexcept {
@@ -456,6 +795,11 @@ SslCtxPtr TlsConnection::create_default_ssl_ctx() {
 
     SSL_CTX_set_verify(ctx.get(), SSL_VERIFY_PEER, nullptr);
 
+    // Sessions are cached per destination in TlsSessionCache; the context's
+    // own cache is looked up by session ID, which only a server knows.
+    SSL_CTX_set_session_cache_mode(ctx.get(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(ctx.get(), on_new_session);
+
     // Four-tier discovery: SSL_CERT_FILE → ./ca.pem → OpenSSL default → hardcoded paths
     if (auto ca_path = Utils::Cert::discover_ca_bundle(); ca_path) {
         if (SSL_CTX_load_verify_locations(ctx.get(), ca_path->c_str(), nullptr) != 1) {
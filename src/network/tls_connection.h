@@ -18,6 +18,8 @@
 #include <openssl/bio.h>
 #include <openssl/ssl.h>
 
+#include "network/reactor.h"
+
 // ── Forward declarations ──
 
 namespace Utils {
@@ -63,6 +65,12 @@ struct TlsOptions {
 
     /// Timeout for each individual @c poll() call during writes.
     std::chrono::milliseconds write_timeout{1500};
+
+    /// Send the first writes of a resumed connection as TLS 1.3 early data
+    /// (0-RTT, RFC 8446 §2.3) when the cached session allows it; see
+    /// @ref TlsConnection::connect().  Early data can be replayed by an
+    /// attacker: enable it only for idempotent requests.
+    bool early_data{false};
 };
 
 // ── TlsConnectionBase ──
@@ -113,6 +121,14 @@ public:
     /// Quick health check — returns false if the peer has closed the connection.
     [[nodiscard]] virtual bool is_healthy() const noexcept = 0;
 
+    /// The underlying socket, for poll()ing it alongside other fds, or -1 if
+    /// there is none.  All I/O must still go through this object.
+    [[nodiscard]] virtual int native_fd() const noexcept = 0;
+
+    /// Whether received data is buffered in the TLS layer, where a poll()
+    /// on native_fd() cannot see it.
+    [[nodiscard]] virtual bool has_pending() const noexcept = 0;
+
     // ── I/O (all variants accept an optional cancellation token) ──
 
     /// Send all bytes in @p data.
@@ -155,6 +171,10 @@ public:
 /// passed to the constructor to override this — useful for custom certificate
 /// verification, client certificates, or other per-connection SSL configuration.
 ///
+/// Connections on the default context resume the TLS session of an earlier
+/// connection to the same server, port, SNI and ALPN when one is cached
+/// (see @ref TlsSessionCache), saving a round trip and the key exchange.
+///
 /// Thread safety: distinct `TlsConnection` objects are independent. A single
 /// object is **not** thread-safe; external synchronisation is required if
 /// shared across threads.
@@ -194,12 +214,24 @@ public:
     /// Open (or re-establish) the TLS connection.
     ///
     /// If already connected, the old connection is closed first.
+    ///
+    /// With @ref TlsOptions::early_data, when the cached session allows
+    /// early data, only the TCP connection is made: the handshake starts
+    /// with the first send_all(), whose data goes out with the ClientHello,
+    /// and completes on the first read (or a write beyond the server's early
+    /// data limit).  If the server rejects the early data, it is sent again
+    /// once the handshake completes.  async_wait() does not complete the
+    /// handshake: callers using it must not enable early data.
     /// @return  std::expected<void, IoStatus> — empty on success, error on failure.
     [[nodiscard]] std::expected<void, IoStatus> connect() override;
 
     /// Close the connection.
     void close() noexcept override;
 
+    /// Whether the server accepted the early data of this connection: false
+    /// if none was sent, or the handshake is still to complete.
+    [[nodiscard]] bool early_data_accepted() const noexcept { return early_data_accepted_; }
+
     /// Whether the underlying BIO is currently valid.
     [[nodiscard]] bool is_connected() const noexcept override { return bio_ != nullptr; }
 
@@ -208,6 +240,12 @@ public:
     /// readable data as a closed connection).
     [[nodiscard]] bool is_healthy() const noexcept override;
 
+    /// The socket under the BIO, or -1 if not connected.
+    [[nodiscard]] int native_fd() const noexcept override;
+
+    /// Whether decrypted or unprocessed TLS data is buffered in OpenSSL.
+    [[nodiscard]] bool has_pending() const noexcept override;
+
     /// Set the timeout for read operations (including shutdown).
     /// The default is 5 seconds.  Pass 0ms for fully non-blocking behaviour.
     void set_read_timeout(std::chrono::milliseconds timeout) noexcept { read_timeout_ms_ = timeout; }
@@ -261,6 +299,21 @@ public:
     /// @return  std::expected<void, IoStatus> — empty on success, error code on failure.
     [[nodiscard]] std::expected<void, IoStatus> shutdown() override;
 
+    // ── Reactor ──
+
+    /// Reactor counterpart of the poll() that the blocking I/O methods run
+    /// between OpenSSL retries: returns at once, and @p reactor later calls
+    /// @p on_ready with OK (retry the SSL call), TIMEOUT or ERROR.
+    ///
+    /// The direction is the one OpenSSL asked for on the last retry
+    /// (BIO_should_read / BIO_should_write), or @p default_events
+    /// (POLLIN / POLLOUT) if it asked for none.  The connection must stay
+    /// open until @p on_ready has run.
+    /// @return ERROR if there is no connection or it cannot be registered.
+    [[nodiscard]] std::expected<void, IoStatus> async_wait(Reactor &reactor, short default_events,
+                                                           std::chrono::milliseconds timeout,
+                                                           std::function<void(IoStatus)> on_ready) const;
+
     // ── SNI / certificate hostname ──
 
     /// Override the hostname used for both TLS SNI and certificate
@@ -289,6 +342,29 @@ private:
     [[nodiscard]] IoStatus poll_bio(BIO *bio, short default_events, const Utils::CancellationToken &cancel_token,
                                     std::chrono::milliseconds timeout);
 
+    /// poll() events to wait for before retrying an SSL call on @p bio.
+    [[nodiscard]] static short bio_events(BIO *bio, short default_events) noexcept;
+
+    /// Map the ready events of a wait for @p events to an IoStatus.
+    [[nodiscard]] static IoStatus readiness_status(short revents, short events) noexcept;
+
+    /// Wait for what the SSL call on @p ssl that returned @p ret needs.
+    [[nodiscard]] std::expected<void, IoStatus> wait_ssl(SSL *ssl, int ret,
+                                                         const Utils::CancellationToken &cancel_token,
+                                                         std::chrono::milliseconds timeout);
+
+    /// Write @p data as early data.
+    [[nodiscard]] std::expected<void, IoStatus> send_early(std::span<const std::uint8_t> data,
+                                                           const Utils::CancellationToken &cancel_token);
+
+    /// Complete a handshake that connect() left to the first I/O, and send
+    /// again the early data if the server rejected it.
+    [[nodiscard]] std::expected<void, IoStatus> finish_handshake(const Utils::CancellationToken &cancel_token);
+
+    /// Count the completed handshake in the session cache statistics.
+    /// @return Whether the session was resumed.
+    bool count_handshake(SSL *ssl) const noexcept;
+
     [[nodiscard]] static SslCtxPtr create_default_ssl_ctx();
 
     [[nodiscard]] static SSL_CTX *get_shared_ssl_ctx();
@@ -301,6 +377,21 @@ private:
     std::chrono::milliseconds write_timeout_ms_;
     std::vector<unsigned char> alpn_proto_;
     ContextFactory context_factory_;
+    bool early_data_;
+
+    /// TlsSessionCache key of the connection; empty if it does not use the cache.
+    std::string session_key_;
+
+    // ── Early data ──
+    /// connect() left the handshake to the first I/O.
+    bool handshake_pending_{false};
+    /// Early data the offered session allows; 0 if none is to be sent.
+    std::size_t early_limit_{0};
+    /// ALPN protocol of the offered session, which early data is written for.
+    std::string early_alpn_;
+    /// Early data sent, until the handshake completes.
+    std::vector<std::uint8_t> early_sent_;
+    bool early_data_accepted_{false};
 
     SslCtxPtr custom_ctx_; ///< Cached result of context_factory_ (can be null).
     BioPtr bio_;
@@ -0,0 +1,122 @@
+//
+// Created by Kotarou on 2026/8/16.
+//
+
+#include "network/tls_session_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "fmt.hpp"
+
+void SSLSessionDeleter::operator()(SSL_SESSION *session) const noexcept {
+    SSL_SESSION_free(session);
+}
+
+namespace {
+    /// Whether @p session can still be offered.
+    [[nodiscard]] bool resumable(const SSL_SESSION *session) noexcept {
+        if (SSL_SESSION_is_resumable(session) != 1) {
+            return false;
+        }
+        const auto expires = SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session);
+        return std::time(nullptr) < expires;
+    }
+} // anonymous namespace
+
+struct TlsSessionCache::Impl {
+    struct Entry {
+        SslSessionPtr session;
+        /// Insertion order, for evicting the oldest entry.
+        std::uint64_t seq;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    std::uint64_t next_seq_{0};
+
+    std::atomic<std::uint64_t> hits_{0};
+    std::atomic<std::uint64_t> misses_{0};
+};
+
+TlsSessionCache::TlsSessionCache() : impl_(std::make_unique<Impl>()) {
+}
+
+TlsSessionCache::~TlsSessionCache() = default;
+
+TlsSessionCache &TlsSessionCache::instance() {
+    static TlsSessionCache cache;
+    return cache;
+}
+
+std::string TlsSessionCache::make_key(std::string_view server, std::uint16_t port, std::string_view sni,
+                                      std::span<const unsigned char> alpn) {
+    return fmt::format("{}:{}|{}|{:02x}", server, port, sni, fmt::join(alpn, ""));
+}
+
+SslSessionPtr TlsSessionCache::take(const std::string &key) {
+    std::lock_guard lock(impl_->mutex_);
+    const auto it = impl_->entries_.find(key);
+    if (it == impl_->entries_.end()) {
+        return nullptr;
+    }
+
+    auto *session = it->second.session.get();
+    if (!resumable(session)) {
+        impl_->entries_.erase(it);
+        return nullptr;
+    }
+
+    // A TLS 1.3 ticket must not be offered twice (RFC 8446 §C.4).
+    if (SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION) {
+        auto taken = std::move(it->second.session);
+        impl_->entries_.erase(it);
+        return taken;
+    }
+
+    SSL_SESSION_up_ref(session);
+    return SslSessionPtr(session);
+}
+
+void TlsSessionCache::put(const std::string &key, SslSessionPtr session) {
+    if (!session) {
+        return;
+    }
+
+    std::lock_guard lock(impl_->mutex_);
+    impl_->entries_.insert_or_assign(key, Impl::Entry{std::move(session), impl_->next_seq_++});
+
+    if (impl_->entries_.size() > MAX_ENTRIES) {
+        const auto oldest = std::ranges::min_element(impl_->entries_, {},
+                                                     [](const auto &entry) { return entry.second.seq; });
+        impl_->entries_.erase(oldest);
+    }
+}
+
+void TlsSessionCache::remove(const std::string &key) {
+    std::lock_guard lock(impl_->mutex_);
+    impl_->entries_.erase(key);
+}
+
+void TlsSessionCache::clear() {
+    std::lock_guard lock(impl_->mutex_);
+    impl_->entries_.clear();
+}
+
+void TlsSessionCache::record(bool resumed) noexcept {
+    (resumed ? impl_->hits_ : impl_->misses_).fetch_add(1, std::memory_order_relaxed);
+}
+
+TlsSessionCache::Stats TlsSessionCache::stats() const noexcept {
+    return {.hits = impl_->hits_.load(std::memory_order_relaxed),
+            .misses = impl_->misses_.load(std::memory_order_relaxed)};
+}
+
+std::size_t TlsSessionCache::size() const {
+    std::lock_guard lock(impl_->mutex_);
+    return impl_->entries_.size();
+}
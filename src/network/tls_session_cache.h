@@ -0,0 +1,91 @@
+//
+// Created by Kotarou on 2026/8/16.
+//
+
+#ifndef YADDNSC_NETWORK_TLS_SESSION_CACHE_H
+#define YADDNSC_NETWORK_TLS_SESSION_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <openssl/ssl.h>
+
+#include "mixin.h"
+
+struct SSLSessionDeleter {
+    void operator()(SSL_SESSION *session) const noexcept;
+};
+
+using SslSessionPtr = std::unique_ptr<SSL_SESSION, SSLSessionDeleter>;
+
+/// TlsSessionCache — the TLS sessions of past connections, kept for the
+/// process so a new connection to the same destination can resume one
+/// instead of running a full handshake.
+///
+/// Sessions are keyed by destination (server, port, SNI and ALPN; see
+/// make_key()).  A TLS 1.2 session ID may be offered again and again until
+/// it expires; a TLS 1.3 ticket is handed out once (RFC 8446 §C.4), and its
+/// connection receives a fresh one from the server.  Expired sessions are
+/// dropped on lookup, and the oldest entry when MAX_ENTRIES is exceeded.
+///
+/// @ref TlsConnection fills and uses the cache for connections on the
+/// shared default SSL_CTX; those with a custom context do not take part.
+///
+/// @note Thread-safe.
+class TlsSessionCache {
+public:
+    /// Handshakes of connections that could have resumed a session.
+    struct Stats {
+        /// Handshakes that resumed a cached session.
+        std::uint64_t hits{0};
+        /// Full handshakes: nothing was cached, or the server declined it.
+        std::uint64_t misses{0};
+    };
+
+    static constexpr std::size_t MAX_ENTRIES = 32;
+
+    /// The process-wide cache.
+    [[nodiscard]] static TlsSessionCache &instance();
+
+    /// The key of a destination.
+    [[nodiscard]] static std::string make_key(std::string_view server, std::uint16_t port, std::string_view sni,
+                                              std::span<const unsigned char> alpn);
+
+    /// A session to offer for @p key, or null if none is cached (or it has
+    /// expired).  A TLS 1.3 session is removed from the cache.
+    [[nodiscard]] SslSessionPtr take(const std::string &key);
+
+    /// Cache @p session for @p key, replacing the one there.
+    void put(const std::string &key, SslSessionPtr session);
+
+    /// Forget the session cached for @p key.
+    void remove(const std::string &key);
+
+    /// Forget every session (the counters are kept).
+    void clear();
+
+    /// Count a handshake that offered what take() returned.
+    void record(bool resumed) noexcept;
+
+    [[nodiscard]] Stats stats() const noexcept;
+
+    /// Number of sessions cached.
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    TlsSessionCache();
+
+    ~TlsSessionCache();
+
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+
+    [[maybe_unused, no_unique_address]] NoCopy no_copy_;
+    [[maybe_unused, no_unique_address]] NoMove no_move_;
+};
+
+#endif // YADDNSC_NETWORK_TLS_SESSION_CACHE_H
@@ -0,0 +1,444 @@
+//
+// Created by Kotarou on 2026/9/3.
+//
+
+#ifndef YADDNSC_UTIL_BYTE_SCAN_H
+#define YADDNSC_UTIL_BYTE_SCAN_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define YADDNSC_BYTE_SCAN_X86 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define YADDNSC_BYTE_SCAN_NEON 1
+#endif
+
+/// Scans over domain names, 16 or 32 bytes at a time.
+///
+/// Each kernel has a scalar version and, where the target has them, SSE2
+/// and AVX2 (x86-64) or NEON (AArch64) versions.  SSE2 and NEON are part
+/// of the x86-64 and AArch64 base instruction sets; AVX2 is used when the
+/// CPU running the program has it.  The functions at namespace scope
+/// dispatch to the best version; the ones in Sse2, Avx2 and Neon are there
+/// for tests and benchmarks, and the constexpr ones in Scalar for constant
+/// evaluation too.
+///
+/// Every version gives the same result for the same input, and none reads
+/// past the end of its input: the last partial block is done byte by byte.
+namespace Utils::ByteScan {
+    /// Instruction set a kernel runs on.
+    enum class Isa : std::uint8_t {
+        SCALAR,
+        SSE2,
+        AVX2,
+        NEON,
+    };
+
+    // =============================================================================
+    // Scalar — the reference versions, and the tail of every other
+    // =============================================================================
+
+    namespace Scalar {
+        /// Whether @p c is a letter, digit or hyphen (RFC 1123 §2.1).
+        [[nodiscard]] constexpr bool is_ldh(char c) noexcept {
+            const auto u = static_cast<unsigned char>(c);
+            return static_cast<unsigned char>((u | 0x20) - 'a') < 26 || static_cast<unsigned char>(u - '0') < 10 ||
+                   u == '-';
+        }
+
+        [[nodiscard]] constexpr char to_lower(char c) noexcept {
+            return static_cast<unsigned char>(c - 'A') < 26 ? static_cast<char>(c + 0x20) : c;
+        }
+
+        /// Store the offset of every @p c in @p s, from @p from on, in @p out
+        /// after the @p found already there.
+        /// @return The number of offsets in @p out, at most out.size().
+        constexpr std::size_t find_all(std::string_view s, char c, std::span<std::uint16_t> out, std::size_t from = 0,
+                                       std::size_t found = 0) noexcept {
+            for (auto i = from; i < s.size() && found < out.size(); ++i) {
+                if (s[i] == c) {
+                    out[found++] = static_cast<std::uint16_t>(i);
+                }
+            }
+            return found;
+        }
+
+        [[nodiscard]] constexpr bool is_ldh(std::string_view s, std::size_t from = 0) noexcept {
+            for (auto i = from; i < s.size(); ++i) {
+                if (!is_ldh(s[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        constexpr void to_lower(std::span<char> s, std::size_t from = 0) noexcept {
+            for (auto i = from; i < s.size(); ++i) {
+                s[i] = to_lower(s[i]);
+            }
+        }
+
+        /// Whether @p a and @p b, of the same size, are equal but for ASCII case.
+        [[nodiscard]] constexpr bool iequals(std::string_view a, std::string_view b, std::size_t from = 0) noexcept {
+            for (auto i = from; i < a.size(); ++i) {
+                if (to_lower(a[i]) != to_lower(b[i])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    } // namespace Scalar
+
+#if YADDNSC_BYTE_SCAN_X86
+    // =============================================================================
+    // SSE2 — 16 bytes at a time
+    // =============================================================================
+
+    namespace Sse2 {
+        constexpr std::size_t WIDTH = 16;
+        constexpr unsigned ALL_LANES = 0xFFFF;
+
+        [[nodiscard]] inline __m128i load(const char *p) noexcept {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        /// Lanes of @p v in [lo, lo + n), unsigned, set to 0xFF.  SSE2 only
+        /// compares signed bytes, so both sides are shifted by 128.
+        [[nodiscard]] inline __m128i in_range(__m128i v, unsigned char lo, unsigned char n) noexcept {
+            const auto shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+            return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(n - 0x80)));
+        }
+
+        [[nodiscard]] inline __m128i to_lower(__m128i v) noexcept {
+            return _mm_add_epi8(v, _mm_and_si128(in_range(v, 'A', 26), _mm_set1_epi8(0x20)));
+        }
+
+        [[nodiscard]] inline unsigned mask(__m128i v) noexcept {
+            return static_cast<unsigned>(_mm_movemask_epi8(v));
+        }
+
+        inline std::size_t find_all(std::string_view s, char c, std::span<std::uint16_t> out, std::size_t from = 0,
+                                    std::size_t found = 0) noexcept {
+            const auto needle = _mm_set1_epi8(c);
+            auto i = from;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                for (auto bits = mask(_mm_cmpeq_epi8(load(s.data() + i), needle)); bits != 0; bits &= bits - 1) {
+                    if (found == out.size()) {
+                        return found;
+                    }
+                    out[found++] = static_cast<std::uint16_t>(i + std::countr_zero(bits));
+                }
+            }
+            return Scalar::find_all(s, c, out, i, found);
+        }
+
+        [[nodiscard]] inline bool is_ldh(std::string_view s, std::size_t from = 0) noexcept {
+            auto i = from;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                const auto v = load(s.data() + i);
+                const auto alpha = in_range(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 26);
+                const auto digit = in_range(v, '0', 10);
+                const auto hyphen = _mm_cmpeq_epi8(v, _mm_set1_epi8('-'));
+                if (mask(_mm_or_si128(_mm_or_si128(alpha, digit), hyphen)) != ALL_LANES) {
+                    return false;
+                }
+            }
+            return Scalar::is_ldh(s, i);
+        }
+
+        inline void to_lower(std::span<char> s, std::size_t from = 0) noexcept {
+            auto i = from;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(s.data() + i), to_lower(load(s.data() + i)));
+            }
+            Scalar::to_lower(s, i);
+        }
+
+        [[nodiscard]] inline bool iequals(std::string_view a, std::string_view b, std::size_t from = 0) noexcept {
+            auto i = from;
+            for (; i + WIDTH <= a.size(); i += WIDTH) {
+                const auto eq = _mm_cmpeq_epi8(to_lower(load(a.data() + i)), to_lower(load(b.data() + i)));
+                if (mask(eq) != ALL_LANES) {
+                    return false;
+                }
+            }
+            return Scalar::iequals(a, b, i);
+        }
+    } // namespace Sse2
+
+    // =============================================================================
+    // AVX2 — 32 bytes at a time, then SSE2 for the rest
+    // =============================================================================
+
+    namespace Avx2 {
+        constexpr std::size_t WIDTH = 32;
+        constexpr unsigned ALL_LANES = 0xFFFFFFFF;
+
+        [[nodiscard]] __attribute__((target("avx2"))) inline __m256i load(const char *p) noexcept {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        }
+
+        /// Lanes of @p v in [lo, lo + n), unsigned; see Sse2::in_range().
+        [[nodiscard]] __attribute__((target("avx2"))) inline __m256i
+        in_range(__m256i v, unsigned char lo, unsigned char n) noexcept {
+            const auto shifted = _mm256_add_epi8(v, _mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+            return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(n - 0x80)), shifted);
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) inline __m256i to_lower(__m256i v) noexcept {
+            return _mm256_add_epi8(v, _mm256_and_si256(in_range(v, 'A', 26), _mm256_set1_epi8(0x20)));
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) inline unsigned mask(__m256i v) noexcept {
+            return static_cast<unsigned>(_mm256_movemask_epi8(v));
+        }
+
+        __attribute__((target("avx2"))) inline std::size_t
+        find_all(std::string_view s, char c, std::span<std::uint16_t> out) noexcept {
+            const auto needle = _mm256_set1_epi8(c);
+            std::size_t found = 0;
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                for (auto bits = mask(_mm256_cmpeq_epi8(load(s.data() + i), needle)); bits != 0; bits &= bits - 1) {
+                    if (found == out.size()) {
+                        return found;
+                    }
+                    out[found++] = static_cast<std::uint16_t>(i + std::countr_zero(bits));
+                }
+            }
+            return Sse2::find_all(s, c, out, i, found);
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) inline bool is_ldh(std::string_view s) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                const auto v = load(s.data() + i);
+                const auto alpha = in_range(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 26);
+                const auto digit = in_range(v, '0', 10);
+                const auto hyphen = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('-'));
+                if (mask(_mm256_or_si256(_mm256_or_si256(alpha, digit), hyphen)) != ALL_LANES) {
+                    return false;
+                }
+            }
+            return Sse2::is_ldh(s, i);
+        }
+
+        __attribute__((target("avx2"))) inline void to_lower(std::span<char> s) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(s.data() + i), to_lower(load(s.data() + i)));
+            }
+            Sse2::to_lower(s, i);
+        }
+
+        [[nodiscard]] __attribute__((target("avx2"))) inline bool
+        iequals(std::string_view a, std::string_view b) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= a.size(); i += WIDTH) {
+                const auto eq = _mm256_cmpeq_epi8(to_lower(load(a.data() + i)), to_lower(load(b.data() + i)));
+                if (mask(eq) != ALL_LANES) {
+                    return false;
+                }
+            }
+            return Sse2::iequals(a, b, i);
+        }
+    } // namespace Avx2
+#endif
+
+#if YADDNSC_BYTE_SCAN_NEON
+    // =============================================================================
+    // NEON — 16 bytes at a time
+    // =============================================================================
+
+    namespace Neon {
+        constexpr std::size_t WIDTH = 16;
+
+        [[nodiscard]] inline uint8x16_t load(const char *p) noexcept {
+            return vld1q_u8(reinterpret_cast<const std::uint8_t *>(p));
+        }
+
+        /// Lanes of @p v in [lo, lo + n), set to 0xFF.
+        [[nodiscard]] inline uint8x16_t in_range(uint8x16_t v, std::uint8_t lo, std::uint8_t n) noexcept {
+            return vcltq_u8(vsubq_u8(v, vdupq_n_u8(lo)), vdupq_n_u8(n));
+        }
+
+        [[nodiscard]] inline uint8x16_t to_lower(uint8x16_t v) noexcept {
+            return vaddq_u8(v, vandq_u8(in_range(v, 'A', 26), vdupq_n_u8(0x20)));
+        }
+
+        /// Four bits per lane, in lane order: NEON has no byte movemask.
+        [[nodiscard]] inline std::uint64_t mask(uint8x16_t v) noexcept {
+            return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(v), 4)), 0);
+        }
+
+        [[nodiscard]] inline bool all(uint8x16_t v) noexcept {
+            return vminvq_u8(v) == 0xFF;
+        }
+
+        inline std::size_t find_all(std::string_view s, char c, std::span<std::uint16_t> out) noexcept {
+            const auto needle = vdupq_n_u8(static_cast<std::uint8_t>(c));
+            std::size_t found = 0;
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                for (auto bits = mask(vceqq_u8(load(s.data() + i), needle)); bits != 0;) {
+                    if (found == out.size()) {
+                        return found;
+                    }
+                    const auto bit = std::countr_zero(bits);
+                    out[found++] = static_cast<std::uint16_t>(i + bit / 4);
+                    bits &= ~(std::uint64_t{0xF} << bit);
+                }
+            }
+            return Scalar::find_all(s, c, out, i, found);
+        }
+
+        [[nodiscard]] inline bool is_ldh(std::string_view s) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                const auto v = load(s.data() + i);
+                const auto alpha = in_range(vorrq_u8(v, vdupq_n_u8(0x20)), 'a', 26);
+                const auto digit = in_range(v, '0', 10);
+                const auto hyphen = vceqq_u8(v, vdupq_n_u8('-'));
+                if (!all(vorrq_u8(vorrq_u8(alpha, digit), hyphen))) {
+                    return false;
+                }
+            }
+            return Scalar::is_ldh(s, i);
+        }
+
+        inline void to_lower(std::span<char> s) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= s.size(); i += WIDTH) {
+                vst1q_u8(reinterpret_cast<std::uint8_t *>(s.data() + i), to_lower(load(s.data() + i)));
+            }
+            Scalar::to_lower(s, i);
+        }
+
+        [[nodiscard]] inline bool iequals(std::string_view a, std::string_view b) noexcept {
+            std::size_t i = 0;
+            for (; i + WIDTH <= a.size(); i += WIDTH) {
+                if (!all(vceqq_u8(to_lower(load(a.data() + i)), to_lower(load(b.data() + i))))) {
+                    return false;
+                }
+            }
+            return Scalar::iequals(a, b, i);
+        }
+    } // namespace Neon
+#endif
+
+    // =============================================================================
+    // Dispatch
+    // =============================================================================
+
+    /// The best instruction set of this CPU, detected once.
+    [[nodiscard]] inline Isa isa() noexcept {
+        static const Isa best = [] {
+#if YADDNSC_BYTE_SCAN_X86
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? Isa::AVX2 : Isa::SSE2;
+#elif YADDNSC_BYTE_SCAN_NEON
+            return Isa::NEON;
+#else
+            return Isa::SCALAR;
+#endif
+        }();
+        return best;
+    }
+
+    /// Inputs shorter than this are scanned byte by byte: they fill no block.
+    constexpr std::size_t MIN_VECTOR_SIZE = 16;
+
+    /// Store the offset of every @p c in @p s, in order, in @p out.
+    /// @pre s.size() <= 65535.
+    /// @return The number of offsets stored, at most out.size().
+    inline std::size_t find_all(std::string_view s, char c, std::span<std::uint16_t> out) noexcept {
+        if (s.size() >= MIN_VECTOR_SIZE) {
+            switch (isa()) {
+#if YADDNSC_BYTE_SCAN_X86
+                case Isa::AVX2:
+                    return Avx2::find_all(s, c, out);
+                case Isa::SSE2:
+                    return Sse2::find_all(s, c, out);
+#elif YADDNSC_BYTE_SCAN_NEON
+                case Isa::NEON:
+                    return Neon::find_all(s, c, out);
+#endif
+                default:
+                    break;
+            }
+        }
+        return Scalar::find_all(s, c, out);
+    }
+
+    /// Whether every byte of @p s is a letter, digit or hyphen (RFC 1123 §2.1).
+    [[nodiscard]] inline bool is_ldh(std::string_view s) noexcept {
+        if (s.size() >= MIN_VECTOR_SIZE) {
+            switch (isa()) {
+#if YADDNSC_BYTE_SCAN_X86
+                case Isa::AVX2:
+                    return Avx2::is_ldh(s);
+                case Isa::SSE2:
+                    return Sse2::is_ldh(s);
+#elif YADDNSC_BYTE_SCAN_NEON
+                case Isa::NEON:
+                    return Neon::is_ldh(s);
+#endif
+                default:
+                    break;
+            }
+        }
+        return Scalar::is_ldh(s);
+    }
+
+    /// Lower-case the ASCII letters of @p s in place; other bytes are kept.
+    inline void to_lower(std::span<char> s) noexcept {
+        if (s.size() >= MIN_VECTOR_SIZE) {
+            switch (isa()) {
+#if YADDNSC_BYTE_SCAN_X86
+                case Isa::AVX2:
+                    return Avx2::to_lower(s);
+                case Isa::SSE2:
+                    return Sse2::to_lower(s);
+#elif YADDNSC_BYTE_SCAN_NEON
+                case Isa::NEON:
+                    return Neon::to_lower(s);
+#endif
+                default:
+                    break;
+            }
+        }
+        Scalar::to_lower(s);
+    }
+
+    /// Whether @p a and @p b are equal but for ASCII case, as DNS names
+    /// compare (RFC 4343 §3).
+    [[nodiscard]] inline bool iequals(std::string_view a, std::string_view b) noexcept {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        if (a.size() >= MIN_VECTOR_SIZE) {
+            switch (isa()) {
+#if YADDNSC_BYTE_SCAN_X86
+                case Isa::AVX2:
+                    return Avx2::iequals(a, b);
+                case Isa::SSE2:
+                    return Sse2::iequals(a, b);
+#elif YADDNSC_BYTE_SCAN_NEON
+                case Isa::NEON:
+                    return Neon::iequals(a, b);
+#endif
+                default:
+                    break;
+            }
+        }
+        return Scalar::iequals(a, b);
+    }
+} // namespace Utils::ByteScan
+
+#endif // YADDNSC_UTIL_BYTE_SCAN_H
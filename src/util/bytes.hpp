@@ -50,6 +50,14 @@ namespace Utils::Bytes {
         buf[1] = static_cast<std::uint8_t>(value);
     }
 
+    /// Write a 32-bit big-endian value to a raw pointer.
+    inline void write_u32_be(std::uint8_t *buf, std::uint32_t value) noexcept {
+        buf[0] = static_cast<std::uint8_t>(value >> 24);
+        buf[1] = static_cast<std::uint8_t>(value >> 16);
+        buf[2] = static_cast<std::uint8_t>(value >> 8);
+        buf[3] = static_cast<std::uint8_t>(value);
+    }
+
     /// Write a 16-bit big-endian value to the start of a span.
     inline void write_u16_be(std::span<std::uint8_t> buf, std::uint16_t value) noexcept {
         write_u16_be(buf.data(), value);
@@ -0,0 +1,175 @@
+//
+// Created by Kotarou on 2026/8/30.
+//
+
+#ifndef YADDNSC_UTIL_SMALL_VECTOR_H
+#define YADDNSC_UTIL_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+    /// A vector that keeps its first N elements inline, allocating only when
+    /// it grows past them.
+    ///
+    /// Meant for short lists of small value types, such as the addresses of
+    /// a DNS answer: the elements live in a std::array until the N+1-th is
+    /// added, then all of them move into a std::vector.  Elements can be
+    /// appended and read, not erased.
+    ///
+    /// @tparam T  Element type; must be default-constructible (the inline
+    ///            slots are value-initialised).
+    /// @tparam N  Inline capacity.
+    template<typename T, std::size_t N>
+        requires std::default_initializable<T> && (N > 0)
+    class SmallVector {
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using iterator = T *;
+        using const_iterator = const T *;
+
+        static constexpr size_type INLINE_CAPACITY = N;
+
+        SmallVector() = default;
+
+        SmallVector(std::initializer_list<T> init) {
+            for (const auto &value: init) {
+                push_back(value);
+            }
+        }
+
+        SmallVector(const SmallVector &) = default;
+
+        SmallVector &operator=(const SmallVector &) = default;
+
+        // The moved-from vector is left empty, not with a stale size.
+        SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+            : inline_(std::move(other.inline_)), heap_(std::move(other.heap_)), size_(std::exchange(other.size_, 0)) {
+            other.heap_.clear();
+        }
+
+        SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            inline_ = std::move(other.inline_);
+            heap_ = std::move(other.heap_);
+            other.heap_.clear();
+            size_ = std::exchange(other.size_, 0);
+            return *this;
+        }
+
+        ~SmallVector() = default;
+
+        void push_back(const T &value) {
+            emplace_back(value);
+        }
+
+        void push_back(T &&value) {
+            emplace_back(std::move(value));
+        }
+
+        template<typename... Args>
+        T &emplace_back(Args &&... args) {
+            if (!spilled() && size_ < N) {
+                inline_[size_] = T(std::forward<Args>(args)...);
+                return inline_[size_++];
+            }
+            if (!spilled()) {
+                // Build the element before the inline ones are moved from:
+                // args may refer to one of them, as in v.push_back(v[0]).
+                T value(std::forward<Args>(args)...);
+                heap_.reserve(2 * N);
+                std::ranges::move(std::span(inline_).first(size_), std::back_inserter(heap_));
+                heap_.push_back(std::move(value));
+                ++size_;
+                return heap_.back();
+            }
+            auto &value = heap_.emplace_back(std::forward<Args>(args)...);
+            ++size_;
+            return value;
+        }
+
+        void clear() {
+            if (!spilled()) {
+                // Release what the inline elements hold.
+                for (auto &value: std::span(inline_).first(size_)) {
+                    value = T{};
+                }
+            }
+            heap_.clear();
+            size_ = 0;
+        }
+
+        [[nodiscard]] size_type size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        /// Whether the elements have outgrown the inline storage.
+        [[nodiscard]] bool spilled() const noexcept {
+            return !heap_.empty();
+        }
+
+        [[nodiscard]] T *data() noexcept {
+            return spilled() ? heap_.data() : inline_.data();
+        }
+
+        [[nodiscard]] const T *data() const noexcept {
+            return spilled() ? heap_.data() : inline_.data();
+        }
+
+        [[nodiscard]] iterator begin() noexcept {
+            return data();
+        }
+
+        [[nodiscard]] iterator end() noexcept {
+            return data() + size_;
+        }
+
+        [[nodiscard]] const_iterator begin() const noexcept {
+            return data();
+        }
+
+        [[nodiscard]] const_iterator end() const noexcept {
+            return data() + size_;
+        }
+
+        [[nodiscard]] T &operator[](size_type index) noexcept {
+            return data()[index];
+        }
+
+        [[nodiscard]] const T &operator[](size_type index) const noexcept {
+            return data()[index];
+        }
+
+        [[nodiscard]] T &front() noexcept {
+            return data()[0];
+        }
+
+        [[nodiscard]] const T &front() const noexcept {
+            return data()[0];
+        }
+
+        friend bool operator==(const SmallVector &lhs, const SmallVector &rhs) {
+            return std::ranges::equal(lhs, rhs);
+        }
+
+    private:
+        std::array<T, N> inline_{};
+        // Every element, once there are more than N.
+        std::vector<T> heap_;
+        size_type size_{0};
+    };
+} // namespace Utils
+
+#endif // YADDNSC_UTIL_SMALL_VECTOR_H
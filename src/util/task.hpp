@@ -0,0 +1,456 @@
+//
+// Created by Kotarou on 2026/7/27.
+//
+
+#ifndef YADDNSC_UTIL_TASK_H
+#define YADDNSC_UTIL_TASK_H
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Utils {
+
+/// Where a blocking operation is run: the executor is handed the work and
+/// runs it, now or later, on some thread.  A null Executor runs it inline.
+using Executor = std::function<void(std::function<void()>)>;
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+    /// Resumes the awaiting coroutine (if any) when a Task finishes.
+    struct FinalAwaiter {
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            if (auto continuation = self.promise().continuation) {
+                return continuation;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    struct PromiseBase {
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        void rethrow_if_failed() const {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+    };
+
+    template<typename T>
+    struct Promise : PromiseBase {
+        Task<T> get_return_object() noexcept;
+
+        template<typename U>
+        void return_value(U &&value) {
+            result.emplace(std::forward<U>(value));
+        }
+
+        T take() {
+            rethrow_if_failed();
+            return std::move(*result);
+        }
+
+        std::optional<T> result;
+    };
+
+    template<>
+    struct Promise<void> : PromiseBase {
+        Task<> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        void take() const { rethrow_if_failed(); }
+    };
+
+    /// Eagerly started, self-destroying coroutine used to drive a Task from
+    /// plain code.  Its body must not throw.
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const noexcept { return {}; }
+
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+
+            std::suspend_never final_suspend() const noexcept { return {}; }
+
+            void return_void() const noexcept {}
+
+            [[noreturn]] void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    /// Join point of when_all(): counts the children still running, plus
+    /// one for the parent until it has finished starting them, so a child
+    /// that completes synchronously never resumes a parent that has not
+    /// suspended yet.
+    class WhenAllLatch {
+    public:
+        explicit WhenAllLatch(std::size_t children) noexcept : pending_(children + 1) {}
+
+        /// Start the children through @p start, then suspend unless they
+        /// have all finished already.
+        template<typename Start>
+        [[nodiscard]] auto wait(Start start) noexcept {
+            struct Awaiter {
+                [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+                bool await_suspend(std::coroutine_handle<> parent) noexcept {
+                    latch.continuation_ = parent;
+                    start();
+                    return latch.pending_.fetch_sub(1, std::memory_order_acq_rel) > 1;
+                }
+
+                void await_resume() const noexcept {}
+
+                WhenAllLatch &latch;
+                Start start;
+            };
+            return Awaiter{*this, std::move(start)};
+        }
+
+        /// Called by each child when it finishes; the last one resumes the parent.
+        void arrive() noexcept {
+            if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                continuation_.resume();
+            }
+        }
+
+    private:
+        std::atomic<std::size_t> pending_;
+        std::coroutine_handle<> continuation_;
+    };
+
+    template<typename T>
+    Detached when_all_child(Task<T> task, WhenAllLatch &latch, std::optional<T> &result, std::exception_ptr &error) {
+        try {
+            result.emplace(co_await std::move(task));
+        } catch (...) {
+            error = std::current_exception();
+        }
+        latch.arrive();
+    }
+
+    template<typename Fn>
+    class OffloadAwaiter {
+    public:
+        using Result = std::invoke_result_t<Fn &>;
+
+        OffloadAwaiter(const Executor &executor, Fn fn) : executor_(executor), fn_(std::move(fn)) {}
+
+        /// Without an executor the work runs in await_resume(), inline.
+        [[nodiscard]] bool await_ready() const noexcept { return !executor_; }
+
+        void await_suspend(std::coroutine_handle<> awaiting) {
+            executor_([this, awaiting] {
+                try {
+                    if constexpr (std::is_void_v<Result>) {
+                        fn_();
+                    } else {
+                        result_.emplace(fn_());
+                    }
+                } catch (...) {
+                    error_ = std::current_exception();
+                }
+                awaiting.resume();
+            });
+        }
+
+        Result await_resume() {
+            if (!executor_) {
+                return fn_();
+            }
+            if (error_) {
+                std::rethrow_exception(error_);
+            }
+            if constexpr (!std::is_void_v<Result>) {
+                return std::move(*result_);
+            }
+        }
+
+    private:
+        struct Empty {};
+
+        const Executor &executor_;
+        Fn fn_;
+        std::conditional_t<std::is_void_v<Result>, Empty, std::optional<Result>> result_;
+        std::exception_ptr error_;
+    };
+
+    /// Suspends until a callback delivers a Result.
+    ///
+    /// @p start registers the callback it is given and returns an
+    /// immediate Result when registration fails (the callback is then
+    /// never called and the coroutine is not suspended).
+    template<typename Result, typename Start>
+    class CallbackAwaiter {
+    public:
+        explicit CallbackAwaiter(Start start) : start_(std::move(start)) {}
+
+        [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) {
+            // The callback may resume (and destroy) this awaiter before
+            // start_() returns, so only the local is read afterwards.
+            auto failed = start_([this, awaiting](Result result) {
+                result_.emplace(std::move(result));
+                awaiting.resume();
+            });
+            if (!failed) {
+                return true;
+            }
+            result_.emplace(std::move(*failed));
+            return false;
+        }
+
+        Result await_resume() { return std::move(*result_); }
+
+    private:
+        Start start_;
+        std::optional<Result> result_;
+    };
+
+    struct ScheduleAwaiter {
+        /// Without an executor there is nowhere to go; carry on inline.
+        [[nodiscard]] bool await_ready() const noexcept { return !executor; }
+
+        void await_suspend(std::coroutine_handle<> awaiting) const {
+            executor([awaiting] { awaiting.resume(); });
+        }
+
+        void await_resume() const noexcept {}
+
+        const Executor &executor;
+    };
+} // namespace detail
+
+/// Lazily started coroutine producing a T.
+///
+/// The body does not run until the Task is co_awaited (or handed to
+/// sync_wait() / start_detached()); the awaiting coroutine is resumed
+/// directly (symmetric transfer) on whichever thread the Task finishes.
+/// Exceptions thrown by the body are rethrown by co_await.
+///
+/// Move-only; destroying an unstarted Task destroys its frame.
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+
+    Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            if (handle_) {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+
+    Task &operator=(const Task &) = delete;
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            [[nodiscard]] bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().take(); }
+
+            std::coroutine_handle<promise_type> handle;
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    friend promise_type;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace detail {
+    template<typename T>
+    Task<T> Promise<T>::get_return_object() noexcept {
+        return Task<T>(std::coroutine_handle<Promise>::from_promise(*this));
+    }
+
+    inline Task<> Promise<void>::get_return_object() noexcept {
+        return Task<>(std::coroutine_handle<Promise>::from_promise(*this));
+    }
+} // namespace detail
+
+/// Run @p fn on @p executor and resume the awaiting coroutine on the thread
+/// that ran it.  This is how blocking calls join a coroutine pipeline
+/// without holding up the caller: with a thread-pool executor the awaiting
+/// coroutine gives up its thread until the call returns.
+///
+/// @param executor  Must outlive the co_await; a null executor runs @p fn
+///                  inline.
+/// @return An awaitable yielding fn()'s result; exceptions thrown by @p fn
+///         are rethrown by co_await.
+template<typename Fn>
+[[nodiscard]] auto offload(const Executor &executor, Fn fn) {
+    return detail::OffloadAwaiter<Fn>(executor, std::move(fn));
+}
+
+/// Resume the awaiting coroutine on @p executor.  Used to move back onto
+/// a pool after an awaitable that resumes on some other thread.
+///
+/// @param executor  Must outlive the co_await; a null executor does not
+///                  suspend.
+[[nodiscard]] inline auto schedule(const Executor &executor) noexcept {
+    return detail::ScheduleAwaiter{executor};
+}
+
+/// Bridge a callback-style API into a coroutine.
+///
+///     auto n = co_await Utils::await_callback<int>([&](auto on_done) -> std::optional<int> {
+///         api.start(std::move(on_done));
+///         return std::nullopt;
+///     });
+///
+/// @p start is called on suspension with a callable taking a Result; it
+/// returns std::nullopt once that callable is registered (the coroutine
+/// resumes on whichever thread calls it), or a Result to resume at once
+/// without ever calling it.
+template<typename Result, typename Start>
+[[nodiscard]] auto await_callback(Start start) {
+    return detail::CallbackAwaiter<Result, Start>(std::move(start));
+}
+
+/// Run two tasks concurrently and wait for both.
+///
+/// Both tasks are started before either is awaited, so they overlap as far
+/// as their own suspension points allow.  If either throws, the first
+/// exception (in argument order) is rethrown once both have finished.
+template<typename A, typename B>
+Task<std::pair<A, B>> when_all(Task<A> first, Task<B> second) {
+    std::optional<A> first_result;
+    std::optional<B> second_result;
+    std::exception_ptr first_error;
+    std::exception_ptr second_error;
+
+    detail::WhenAllLatch latch(2);
+    co_await latch.wait([&] {
+        detail::when_all_child(std::move(first), latch, first_result, first_error);
+        detail::when_all_child(std::move(second), latch, second_result, second_error);
+    });
+
+    if (first_error) {
+        std::rethrow_exception(first_error);
+    }
+    if (second_error) {
+        std::rethrow_exception(second_error);
+    }
+    co_return std::pair<A, B>{std::move(*first_result), std::move(*second_result)};
+}
+
+/// Run every task of @p tasks concurrently and wait for all of them.
+/// @return The results, in the order of @p tasks; the first exception (in
+///         that order) is rethrown once every task has finished.
+template<typename T>
+Task<std::vector<T>> when_all(std::vector<Task<T>> tasks) {
+    std::vector<std::optional<T>> results(tasks.size());
+    std::vector<std::exception_ptr> errors(tasks.size());
+
+    detail::WhenAllLatch latch(tasks.size());
+    co_await latch.wait([&] {
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            detail::when_all_child(std::move(tasks[i]), latch, results[i], errors[i]);
+        }
+    });
+
+    for (const auto &error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::vector<T> out;
+    out.reserve(results.size());
+    for (auto &result: results) {
+        out.push_back(std::move(*result));
+    }
+    co_return out;
+}
+
+/// Block the calling thread until @p task has finished.
+/// @return The task's result; its exception, if any, is rethrown.
+template<typename T>
+T sync_wait(Task<T> task) {
+    struct Outcome {
+        std::conditional_t<std::is_void_v<T>, bool, std::optional<T>> value{};
+        std::exception_ptr error;
+    };
+
+    std::binary_semaphore done(0);
+    Outcome outcome;
+
+    // Captureless, so the references live in the coroutine frame.
+    [](Task<T> awaited, std::binary_semaphore &finished, Outcome &out) -> detail::Detached {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await std::move(awaited);
+            } else {
+                out.value.emplace(co_await std::move(awaited));
+            }
+        } catch (...) {
+            out.error = std::current_exception();
+        }
+        finished.release();
+    }(std::move(task), done, outcome);
+
+    done.acquire();
+    if (outcome.error) {
+        std::rethrow_exception(outcome.error);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*outcome.value);
+    }
+}
+
+/// Start @p task and return at its first suspension point, without waiting
+/// for it to finish.  The task owns its state; it must not throw (an
+/// escaping exception terminates the program).
+inline void start_detached(Task<> task) {
+    [](Task<> detached) -> detail::Detached { co_await std::move(detached); }(std::move(task));
+}
+
+} // namespace Utils
+
+#endif // YADDNSC_UTIL_TASK_H
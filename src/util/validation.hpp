@@ -5,13 +5,40 @@
 #ifndef YADDNSC_UTIL_VALIDATION_H
 #define YADDNSC_UTIL_VALIDATION_H
 
-#include <regex>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
+#include "util/byte_scan.hpp"
+
 namespace Utils {
     /// Maximum length of a fully qualified domain name (RFC 1035).
     static constexpr int DOMAIN_NAME_MAX_LEN = 253;
 
+    namespace detail {
+        /// A host name label (RFC 1123 §2.1): 1–63 letters, digits and
+        /// hyphens, starting and ending with a letter or digit.
+        [[nodiscard]] inline bool is_valid_label(std::string_view label) {
+            return !label.empty() && label.size() <= 63 && label.front() != '-' && label.back() != '-' &&
+                   ByteScan::is_ldh(label);
+        }
+
+        /// A top-level label: 2–63 letters, or a punycode label (xn--...).
+        [[nodiscard]] inline bool is_valid_tld(std::string_view tld) {
+            if (tld.size() > 63) {
+                return false;
+            }
+            if (tld.size() > 4 && ByteScan::iequals(tld.substr(0, 4), "xn--")) {
+                return is_valid_label(tld.substr(4));
+            }
+            return tld.size() >= 2 && std::ranges::all_of(tld, [](char c) {
+                return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+            });
+        }
+    } // namespace detail
+
     /// Check whether a string is a valid fully-qualified domain name.
     ///
     /// Validates against RFC 1035 / RFC 1123 rules:
@@ -24,39 +51,33 @@ namespace Utils {
     ///     or a valid punycode label (xn--...).
     ///   - Total encoded length must not exceed 253 characters.
     ///
+    /// The dots are found and the labels checked with Utils::ByteScan, a
+    /// block of bytes at a time.
+    ///
     /// @param domain  The domain name string to validate.
     /// @return        true if the domain name is syntactically valid.
     [[nodiscard]] inline bool is_valid_domain(std::string_view domain) {
-        // Label pattern (RFC 1035 §2.3.1 + RFC 1123 §2.1):
-        //   [a-z0-9]          — first character must be alphanumeric
-        //   ([a-z0-9-]{0,61}[a-z0-9])?  — optional middle (0–61) + ending alphanumeric
-        //   Total: 1 + (0–61 middle + 1 ending) = 1–63 characters.
-        //   Hyphens are allowed in the middle but NOT at the start or end.
-        //
-        // Full regex:
-        //   ^(label\.)+            — one or more subdomain labels each followed by a dot
-        //    (TLD)\.?$             — final label (TLD) with optional trailing dot
-        //
-        // TLD alternatives:
-        //   [a-z]{2,}              — at least 2 alpha characters (e.g. "com", "io", "travel")
-        //   xn--...                — punycode-encoded internationalised TLD
-        const static std::regex DOMAIN_REGEX(
-            R"(^([a-z0-9]([a-z0-9-]{0,61}[a-z0-9])?\.)+([a-z]{2,}|xn--[a-z0-9]([a-z0-9-]{0,59}[a-z0-9])?)\.?$)",
-            std::regex::icase
-        );
-
         if (domain.length() > DOMAIN_NAME_MAX_LEN) {
             return false;
         }
+        if (domain.ends_with('.')) {
+            domain.remove_suffix(1);
+        }
 
-        if (domain.find('.') != std::string_view::npos) {
-            std::match_results<std::string_view::const_iterator> match;
-            std::regex_match(domain.begin(), domain.end(), match, DOMAIN_REGEX);
-
-            return !match.empty();
+        std::array<std::uint16_t, DOMAIN_NAME_MAX_LEN> dots;
+        const auto count = ByteScan::find_all(domain, '.', dots);
+        if (count == 0) {
+            return false;
         }
 
-        return false;
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!detail::is_valid_label(domain.substr(pos, dots[i] - pos))) {
+                return false;
+            }
+            pos = dots[i] + 1;
+        }
+        return detail::is_valid_tld(domain.substr(pos));
     }
 } // namespace Utils
 
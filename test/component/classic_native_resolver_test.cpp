@@ -11,6 +11,7 @@
 // =============================================================================
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstdlib>
@@ -18,6 +19,7 @@
 #include <deque>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
 #include <thread>
 #include <vector>
@@ -46,6 +48,7 @@
 
 #include "config/dns_config.h"
 #include "dns/resolver/classic.h"
+#include "network/reactor.h"
 #include "dns/resolver_registry.h"
 #include "dns/dns_error_info.h"
 #include "record_kind.h"
@@ -307,6 +310,41 @@ TEST_F(ClassicNativeResolverTest, ConnectionRefused_ReturnsError) {
     ASSERT_FALSE(result.has_value());
 }
 
+TEST_F(ClassicNativeResolverTest, ConnectionRefused_FailsWithoutTimeout) {
+	// The pooled UDP socket is connected, so ICMP port-unreachable surfaces
+	// as ECONNREFUSED instead of waiting out the UDP timeout.
+	Config::DnsServer server;
+	server.address = "127.0.0.1";
+	server.port = 1;
+
+	auto bad_resolver = std::make_unique<ClassicResolver>(std::move(server));
+	Utils::CancellationToken cancel;
+	const auto start = std::chrono::steady_clock::now();
+	auto result = bad_resolver->query("yaddnsc.test", RecordKind::A, cancel);
+
+	ASSERT_FALSE(result.has_value());
+	EXPECT_EQ(result.error().code, DnsError::CONNECTION);
+	EXPECT_LT(std::chrono::steady_clock::now() - start, 500ms);
+}
+
+TEST_F(ClassicNativeResolverTest, ConcurrentQueriesShareTheSocketPool) {
+	constexpr int THREADS = 8;
+	constexpr int QUERIES = 16;
+	std::atomic<int> succeeded = 0;
+	{
+		std::vector<std::jthread> threads;
+		for (int t = 0; t < THREADS; ++t) {
+			threads.emplace_back([&succeeded] {
+				Utils::CancellationToken cancel;
+				for (int i = 0; i < QUERIES; ++i) {
+					succeeded += global_resolver->query("yaddnsc.test", RecordKind::A, cancel).has_value();
+				}
+			});
+		}
+	}
+	EXPECT_EQ(succeeded, THREADS * QUERIES);
+}
+
 TEST_F(ClassicNativeResolverTest, MalformedResponse_ValidatorRejects) {
 	// Query a host that makes the server return garbage.
 	// The response validator should reject it.
@@ -338,6 +376,29 @@ TEST_F(ClassicNativeResolverTest, UdpTimeout_ReturnsRetryError) {
 	ASSERT_FALSE(result.has_value());
 }
 
+TEST_F(ClassicNativeResolverTest, UdpLostQuery_IsRetransmittedAfterTheRto) {
+	// The server drops the first query for this host and answers the second.
+	// Loopback answers teach the resolver a short RTO, so the retransmission
+	// goes out long before the initial one-second timeout.
+	Utils::CancellationToken cancel;
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(global_resolver->query("yaddnsc.test", RecordKind::A, cancel).has_value());
+	}
+
+	const auto started = std::chrono::steady_clock::now();
+	auto result = global_resolver->query("lossy.yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	EXPECT_LT(std::chrono::steady_clock::now() - started, 900ms);
+}
+
+TEST_F(ClassicNativeResolverTest, UdpRetransmission_HasANewTransactionId) {
+	// The server never answers the ID of the query it dropped, so the
+	// lookup succeeds only if the retransmission was renumbered.
+	Utils::CancellationToken cancel;
+	auto result = global_resolver->query("renumber.yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+}
+
 TEST_F(ClassicNativeResolverTest, TcpConnectionReset_ReturnsError) {
 	// UDP returns TC=1, then TCP connection is immediately closed.
 	Utils::CancellationToken cancel;
@@ -405,11 +466,11 @@ TEST_F(ClassicNativeResolverTest, TcpGarbageResponse_ValidatorRejects) {
 }
 
 TEST_F(ClassicNativeResolverTest, TcpResponseLengthTooLarge_ReturnsError) {
-	// UDP returns TC=1, TCP returns length prefix > 4096.
+	// UDP returns TC=1, TCP sends length prefix 5000 and closes before the body.
 	Utils::CancellationToken cancel;
 	auto result = global_resolver->query("tcplarge.yaddnsc.test", RecordKind::A, cancel);
 
-	// Should fail — invalid response length.
+	// Should fail — the message is cut short.
 	ASSERT_FALSE(result.has_value());
 }
 
@@ -508,4 +569,226 @@ TEST_F(ClassicNativeResolverTest, TcpConnectFailureAfterTruncatedUdp) {
 	::waitpid(udp_only_pid, nullptr, 0);
 }
 
+// ===========================================================================
+// "transport": "tcp" — every query over the persistent TCP connection
+// ===========================================================================
+
+/// A resolver for the test server that never uses UDP.
+std::unique_ptr<ClassicResolver> make_tcp_only_resolver() {
+	Config::DnsServer server;
+	server.address = "127.0.0.1";
+	server.port = DNS_PORT;
+	server.transport = Config::DnsTransport::TCP;
+	return std::make_unique<ClassicResolver>(std::move(server));
+}
+
+TEST_F(ClassicNativeResolverTest, TcpOnly_SkipsUdp) {
+	// The server ignores this host on UDP only: an answer proves TCP was used
+	// from the start.
+	auto resolver = make_tcp_only_resolver();
+	Utils::CancellationToken cancel;
+	const auto start = std::chrono::steady_clock::now();
+	auto result = resolver->query("timeout.yaddnsc.test", RecordKind::A, cancel);
+
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	EXPECT_TRUE((*result)[2] & 0x80) << "QR bit not set in response";
+	EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST_F(ClassicNativeResolverTest, TcpOnly_SequentialQueries) {
+	auto resolver = make_tcp_only_resolver();
+	Utils::CancellationToken cancel;
+	for (int i = 0; i < 10; ++i) {
+		auto result = resolver->query("yaddnsc.test", i % 2 ? RecordKind::AAAA : RecordKind::A, cancel);
+		ASSERT_TRUE(result.has_value()) << result.error().message;
+	}
+}
+
+TEST_F(ClassicNativeResolverTest, TcpOnly_ReconnectsAfterServerClose) {
+	// The server drops the connection on this host; the next query opens a
+	// new one.
+	auto resolver = make_tcp_only_resolver();
+	Utils::CancellationToken cancel;
+	ASSERT_TRUE(resolver->query("yaddnsc.test", RecordKind::A, cancel).has_value());
+
+	auto reset = resolver->query("tcpreset.yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_FALSE(reset.has_value());
+
+	auto result = resolver->query("yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+}
+
+TEST_F(ClassicNativeResolverTest, TcpOnly_RecoversFromStuckConnection) {
+	// The server hangs on this host, holding up the connection: the query
+	// times out, and the next one must not wait behind it.
+	auto resolver = make_tcp_only_resolver();
+	Utils::CancellationToken cancel;
+	auto stuck = resolver->query("tcptimeout.yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_FALSE(stuck.has_value());
+	EXPECT_EQ(stuck.error().code, DnsError::RETRY);
+
+	auto result = resolver->query("yaddnsc.test", RecordKind::A, cancel);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+}
+
+TEST_F(ClassicNativeResolverTest, TcpOnly_ConcurrentQueriesArePipelined) {
+	constexpr int THREADS = 8;
+	auto resolver = make_tcp_only_resolver();
+	std::atomic<int> succeeded = 0;
+	{
+		std::vector<std::jthread> threads;
+		for (int i = 0; i < THREADS; ++i) {
+			threads.emplace_back([&] {
+				Utils::CancellationToken cancel;
+				succeeded += resolver->query("yaddnsc.test", RecordKind::A, cancel).has_value();
+			});
+		}
+	}
+	EXPECT_EQ(succeeded, THREADS);
+}
+
+// ===========================================================================
+// start_query() — the non-blocking exchange driven by a Reactor
+// ===========================================================================
+
+/// Run one start_query() on a private reactor until its callback fires.
+ResolverBase::QueryResult query_async(const ClassicResolver &resolver, const std::string &host, RecordKind type) {
+	Reactor reactor;
+	std::optional<ResolverBase::QueryResult> result;
+	auto pending = resolver.start_query(reactor, host, type, [&result](ResolverBase::QueryResult raw) {
+		result = std::move(raw);
+	});
+	EXPECT_NE(pending, nullptr);
+	EXPECT_FALSE(result.has_value()) << "callback must not run within start_query()";
+
+	const auto deadline = std::chrono::steady_clock::now() + 30s;
+	while (!result && std::chrono::steady_clock::now() < deadline) {
+		reactor.run_once(100ms);
+	}
+	pending.reset();
+	EXPECT_EQ(reactor.watch_count(), 0u);
+	EXPECT_EQ(reactor.timer_count(), 0u);
+
+	if (!result) {
+		return std::unexpected(DnsErrorInfo{DnsError::UNKNOWN, "callback never ran"});
+	}
+	return std::move(*result);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncResolveARecord) {
+	auto result = query_async(*global_resolver, "yaddnsc.test", RecordKind::A);
+
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	ASSERT_GE(result->size(), 12);
+	EXPECT_TRUE((*result)[2] & 0x80) << "QR bit not set in response";
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncTruncatedResponse_FallsBackToTcp) {
+	auto result = query_async(*global_resolver, "truncate.yaddnsc.test", RecordKind::A);
+
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	EXPECT_GT(result->size(), 12);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncUdpTimeout_ReturnsRetryError) {
+	auto result = query_async(*global_resolver, "timeout.yaddnsc.test", RecordKind::A);
+
+	ASSERT_FALSE(result.has_value());
+	EXPECT_EQ(result.error().code, DnsError::RETRY);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncUdpLostQuery_IsRetransmittedAfterTheRto) {
+	for (int i = 0; i < 4; ++i) {
+		ASSERT_TRUE(query_async(*global_resolver, "yaddnsc.test", RecordKind::A).has_value());
+	}
+
+	const auto started = std::chrono::steady_clock::now();
+	auto result = query_async(*global_resolver, "lossy.yaddnsc.test", RecordKind::A);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	EXPECT_LT(std::chrono::steady_clock::now() - started, 900ms);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncUdpRetransmission_HasANewTransactionId) {
+	auto result = query_async(*global_resolver, "renumber.yaddnsc.test", RecordKind::A);
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncTcpGarbageResponse_ValidatorRejects) {
+	auto result = query_async(*global_resolver, "tcpgarbage.yaddnsc.test", RecordKind::A);
+
+	ASSERT_FALSE(result.has_value());
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncQueriesShareOneReactor) {
+	// Many exchanges in flight at once on a single thread.
+	constexpr int QUERIES = 32;
+	Reactor reactor;
+	int succeeded = 0;
+	int completed = 0;
+	std::vector<std::unique_ptr<PendingQuery> > pending;
+	for (int i = 0; i < QUERIES; ++i) {
+		pending.push_back(global_resolver->start_query(reactor, "yaddnsc.test", RecordKind::A,
+		                                               [&](const ResolverBase::QueryResult &raw) {
+			                                               ++completed;
+			                                               succeeded += raw.has_value();
+		                                               }));
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + 30s;
+	while (completed < QUERIES && std::chrono::steady_clock::now() < deadline) {
+		reactor.run_once(100ms);
+	}
+	EXPECT_EQ(completed, QUERIES);
+	EXPECT_EQ(succeeded, QUERIES);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncAbandonReleasesSocketAndTimer) {
+	Reactor reactor;
+	bool called = false;
+	auto pending = global_resolver->start_query(reactor, "timeout.yaddnsc.test", RecordKind::A,
+	                                            [&called](const ResolverBase::QueryResult &) { called = true; });
+	reactor.run_once(10ms);
+
+	pending.reset();
+	EXPECT_EQ(reactor.watch_count(), 0u);
+	EXPECT_EQ(reactor.timer_count(), 0u);
+	reactor.run_once(10ms);
+	EXPECT_FALSE(called);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncTcpOnly_SkipsUdp) {
+	auto resolver = make_tcp_only_resolver();
+	auto result = query_async(*resolver, "timeout.yaddnsc.test", RecordKind::A);
+
+	ASSERT_TRUE(result.has_value()) << result.error().message;
+	EXPECT_GT(result->size(), 12);
+}
+
+TEST_F(ClassicNativeResolverTest, AsyncTcpOnly_QueriesShareOneReactor) {
+	constexpr int QUERIES = 32;
+	auto resolver = make_tcp_only_resolver();
+	Reactor reactor;
+	int succeeded = 0;
+	int completed = 0;
+	std::vector<std::unique_ptr<PendingQuery> > pending;
+	for (int i = 0; i < QUERIES; ++i) {
+		pending.push_back(resolver->start_query(reactor, "yaddnsc.test", RecordKind::A,
+		                                        [&](const ResolverBase::QueryResult &raw) {
+			                                        ++completed;
+			                                        succeeded += raw.has_value();
+		                                        }));
+	}
+
+	const auto deadline = std::chrono::steady_clock::now() + 30s;
+	while (completed < QUERIES && std::chrono::steady_clock::now() < deadline) {
+		reactor.run_once(100ms);
+	}
+	EXPECT_EQ(completed, QUERIES);
+	EXPECT_EQ(succeeded, QUERIES);
+
+	pending.clear();
+	EXPECT_EQ(reactor.watch_count(), 0u);
+	EXPECT_EQ(reactor.timer_count(), 0u);
+}
+
 } // anonymous namespace
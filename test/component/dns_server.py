@@ -11,6 +11,9 @@ Built-in records:
     yaddnsc.test          AAAA 2001:db8::42
     truncate.yaddnsc.test A    198.51.100.99   (UDP: TC=1, TCP: normal)
     malformed.yaddnsc.test A   —               (returns garbage)
+    lossy.yaddnsc.test    A    198.51.100.1    (UDP: every other query dropped)
+    renumber.yaddnsc.test A    —               (UDP: a retransmission with its
+                                            first query's ID is dropped)
 """
 
 import asyncio
@@ -31,8 +34,10 @@ TCP_ERROR_HOST = "tcperror.yaddnsc.test"   # UDP: TC=1, TCP: invalid length (0)
 TCP_RESET_HOST = "tcpreset.yaddnsc.test"   # UDP: TC=1, TCP: close immediately
 TCP_TIMEOUT_HOST = "tcptimeout.yaddnsc.test"  # UDP: TC=1, TCP: accept but hang
 TCP_GARBAGE_HOST = "tcpgarbage.yaddnsc.test"  # UDP: TC=1, TCP: garbage response
-TCP_LARGE_HOST = "tcplarge.yaddnsc.test"     # UDP: TC=1, TCP: length > 4096
+TCP_LARGE_HOST = "tcplarge.yaddnsc.test"     # UDP: TC=1, TCP: length, then close
 TCP_CONNECT_FAIL_HOST = "tcpconnectfail.yaddnsc.test"  # UDP: TC=1, TCP: no listener
+LOSSY_HOST = "lossy.yaddnsc.test"          # UDP: first of every two queries dropped
+RENUMBER_HOST = "renumber.yaddnsc.test"    # UDP: first query dropped, its ID never answered
 
 HOST = "127.0.0.1"
 TYPE_MAP = {1: "A", 28: "AAAA"}
@@ -178,6 +183,8 @@ class DNSProtocol(asyncio.DatagramProtocol):
     def __init__(self, records: dict) -> None:
         self.records = records
         self.transport: asyncio.DatagramTransport | None = None
+        self.lossy_queries = 0
+        self.renumber_lost_id: int | None = None
 
     def connection_made(self, transport: asyncio.DatagramTransport) -> None:
         self.transport = transport
@@ -187,6 +194,20 @@ class DNSProtocol(asyncio.DatagramProtocol):
             ident, qname, qtype_str, question = parse_query(data)
             if not qname:
                 return
+            if qname == LOSSY_HOST:
+                # Lose the query, then answer its retransmission.
+                self.lossy_queries += 1
+                if self.lossy_queries % 2 == 1:
+                    return
+            if qname == RENUMBER_HOST:
+                # Lose the query, then answer only a retransmission with an ID
+                # of its own, whose reply cannot be mistaken for the first's.
+                if self.renumber_lost_id is None:
+                    self.renumber_lost_id = ident
+                    return
+                if ident == self.renumber_lost_id:
+                    return
+                self.renumber_lost_id = None
             response = build_response(ident, question, qname, qtype_str,
                                       self.records, is_udp=True)
             if response is not None:
@@ -221,49 +242,52 @@ async def create_udp_endpoint(host: str, port: int, records: dict) -> asyncio.Da
 async def handle_tcp_client(reader: asyncio.StreamReader,
                             writer: asyncio.StreamWriter,
                             records: dict) -> None:
-    """Handle a single TCP DNS connection."""
+    """Handle a TCP DNS connection, answering queries until the client
+    closes it (RFC 7766 persistent connection)."""
     try:
-        raw_len = await reader.readexactly(2)
-        msg_len = struct.unpack("!H", raw_len)[0]
-        data = await reader.readexactly(msg_len)
-
-        ident, qname, qtype_str, question = parse_query(data)
-
-        # ── TCP error hosts ──────────────────────────────────────────────
-        if qname == TCP_RESET_HOST:
-            # Close immediately — resolver sees connection reset.
-            return
-
-        if qname == TCP_TIMEOUT_HOST:
-            # Accept connection but never respond — resolver times out and closes.
-            await asyncio.sleep(30)  # Much longer than resolver's 1s TCP timeout
-            return
-
-        if qname == TCP_ERROR_HOST:
-            # Send invalid length prefix (0) — resolver rejects.
-            writer.write(struct.pack("!H", 0))
-            await writer.drain()
-            return
-
-        if qname == TCP_LARGE_HOST:
-            # Send length prefix > 4096 — resolver rejects.
-            writer.write(struct.pack("!H", 5000))
-            await writer.drain()
-            return
-
-        if qname == TCP_GARBAGE_HOST:
-            # Send garbage — validator rejects the TCP response.
-            writer.write(struct.pack("!H", 16) + b"\x00" * 16)
-            await writer.drain()
-            return
-
-        # ── Normal TCP response ──────────────────────────────────────────
-        response = build_response(ident, question, qname, qtype_str,
-                                  records, is_udp=False)
-
-        if response is not None:
-            writer.write(struct.pack("!H", len(response)) + response)
-            await writer.drain()
+        while True:
+            raw_len = await reader.readexactly(2)
+            msg_len = struct.unpack("!H", raw_len)[0]
+            data = await reader.readexactly(msg_len)
+
+            ident, qname, qtype_str, question = parse_query(data)
+
+            # ── TCP error hosts ──────────────────────────────────────────
+            if qname == TCP_RESET_HOST:
+                # Close immediately — resolver sees connection reset.
+                return
+
+            if qname == TCP_TIMEOUT_HOST:
+                # Never respond — resolver times out and abandons the
+                # connection.
+                await asyncio.sleep(30)  # Much longer than resolver's TCP timeout
+                return
+
+            if qname == TCP_ERROR_HOST:
+                # Send invalid length prefix (0) — resolver rejects.
+                writer.write(struct.pack("!H", 0))
+                await writer.drain()
+                return
+
+            if qname == TCP_LARGE_HOST:
+                # Send a length prefix, then close before the body.
+                writer.write(struct.pack("!H", 5000))
+                await writer.drain()
+                return
+
+            if qname == TCP_GARBAGE_HOST:
+                # Send garbage — validator rejects the TCP response.
+                writer.write(struct.pack("!H", 16) + b"\x00" * 16)
+                await writer.drain()
+                return
+
+            # ── Normal TCP response ──────────────────────────────────────
+            response = build_response(ident, question, qname, qtype_str,
+                                      records, is_udp=False)
+
+            if response is not None:
+                writer.write(struct.pack("!H", len(response)) + response)
+                await writer.drain()
     except asyncio.IncompleteReadError:
         pass
     except Exception:
@@ -0,0 +1,368 @@
+//
+// Component tests for src/dns/resolver/doh.cpp — DNS-over-HTTPS over HTTP/2
+//
+// Starts a Python HTTP/2 DoH server on loopback (ALPN "h2" only), generates
+// a self-signed certificate, and exercises DohResolver::query() with its
+// requests multiplexed on one connection.
+//
+// The DoH server is started once per test suite (SetUpTestSuite) and
+// stopped after all tests (TearDownTestSuite).
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver/doh.h"
+#include "dns_error.h"
+#include "record_kind.h"
+#include "util/cancellation_token.hpp"
+#include "fmt.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr int DOH_PORT = 21444;
+static pid_t server_pid = -1;
+static bool server_started = false;
+static std::string cert_path;
+static std::string key_path;
+static std::string server_log;
+
+/// Format a DnsError code for diagnostic messages.
+[[nodiscard]] std::string_view dns_error_name(DnsError code) {
+    switch (code) {
+    case DnsError::NX_DOMAIN:    return "NX_DOMAIN";
+    case DnsError::RETRY:        return "RETRY";
+    case DnsError::NODATA:       return "NODATA";
+    case DnsError::PARSE:        return "PARSE";
+    case DnsError::CONNECTION:   return "CONNECTION";
+    case DnsError::CONFIG:       return "CONFIG";
+    case DnsError::CANCELLED:    return "CANCELLED";
+    case DnsError::SERVER_REFUSED: return "SERVER_REFUSED";
+    case DnsError::UNKNOWN:      return "UNKNOWN";
+    }
+    return "?";
+}
+
+/// Generate a self-signed certificate and key for testing.
+void generate_cert() {
+    char dir_template[] = "/tmp/yaddnsc_doh_h2_test_XXXXXX";
+    auto *dir = ::mkdtemp(dir_template);
+    ASSERT_NE(dir, nullptr) << "mkdtemp failed";
+
+    cert_path = std::string(dir) + "/cert.pem";
+    key_path = std::string(dir) + "/key.pem";
+
+    auto cmd = fmt::format(
+        "openssl req -x509 -newkey rsa:2048 -keyout {} -out {} -days 1 -nodes "
+        "-subj /CN=127.0.0.1 "
+        "-addext subjectAltName=IP:127.0.0.1 "
+        "-addext basicConstraints=critical,CA:TRUE 2>/dev/null",
+        key_path, cert_path);
+
+    int ret = ::system(cmd.c_str());
+    if (ret != 0) {
+        GTEST_SKIP() << "Failed to generate TLS certificate (openssl returned " << ret << ")";
+    }
+
+    // Point SSL_CERT_FILE to our generated cert so OpenSSL trusts it.
+    ::setenv("SSL_CERT_FILE", cert_path.c_str(), 1);
+}
+
+void start_doh_server() {
+    generate_cert();
+
+    server_log = "/tmp/yaddnsc-doh-h2-server.log";
+
+    server_pid = ::fork();
+    ASSERT_NE(server_pid, -1) << "fork() failed";
+
+    if (server_pid == 0) {
+        ::setpgid(0, 0);
+#ifdef __linux__
+        ::prctl(PR_SET_PDEATHSIG, SIGTERM);
+#endif
+        int log_fd = ::open(server_log.c_str(),
+                            O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (log_fd >= 0) {
+            ::dup2(log_fd, STDOUT_FILENO);
+            ::dup2(log_fd, STDERR_FILENO);
+            ::close(log_fd);
+        }
+        // Try venv python first, then system.
+        ::execlp("python3", "python3", TEST_DATA_DIR "/doh_h2_server.py",
+                 fmt::format("{}", DOH_PORT).c_str(),
+                 cert_path.c_str(), key_path.c_str(), nullptr);
+        ::execl("/tmp/sim-venv/bin/python3", "python3", TEST_DATA_DIR "/doh_h2_server.py",
+                fmt::format("{}", DOH_PORT).c_str(),
+                cert_path.c_str(), key_path.c_str(), nullptr);
+        ::_exit(127);
+    }
+
+    // Wait for server to become reachable via TCP.
+    auto deadline = std::chrono::steady_clock::now() + 10s;
+    bool ready = false;
+
+    while (!ready && std::chrono::steady_clock::now() < deadline) {
+        int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) break;
+
+        struct sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<std::uint16_t>(DOH_PORT));
+        ::inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) == 0) {
+            ready = true;
+        }
+        ::close(fd);
+        if (!ready) std::this_thread::sleep_for(100ms);
+    }
+
+    if (!ready) {
+        ::kill(server_pid, SIGTERM);
+        ::waitpid(server_pid, nullptr, 0);
+        server_pid = -1;
+        GTEST_SKIP() << "HTTP/2 DoH server did not start within 10s.\n"
+                     << "Log: " << server_log;
+        return;
+    }
+
+    server_started = true;
+}
+
+void stop_doh_server() {
+    if (server_pid > 0) {
+        ::kill(server_pid, SIGTERM);
+        ::waitpid(server_pid, nullptr, 0);
+        server_pid = -1;
+    }
+    server_started = false;
+}
+
+// ===========================================================================
+// Test fixture
+// ===========================================================================
+
+class DohH2ResolverTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        start_doh_server();
+    }
+
+    static void TearDownTestSuite() {
+        stop_doh_server();
+    }
+
+    void SetUp() override {
+        if (!server_started) {
+            GTEST_SKIP() << "DoH server not available";
+        }
+    }
+};
+
+// ===========================================================================
+// Test cases
+// ===========================================================================
+
+TEST_F(DohH2ResolverTest, Resolve_A_Record) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_TRUE(result.has_value()) << "DoH A query failed: "
+                                    << dns_error_name(result.error().code);
+    // RDATA starts at 42, as in doh_resolver_test.cpp.
+    ASSERT_GE(result->size(), 46U);
+    EXPECT_EQ((*result)[42], 198);
+    EXPECT_EQ((*result)[43], 51);
+    EXPECT_EQ((*result)[44], 100);
+    EXPECT_EQ((*result)[45], 42);
+}
+
+TEST_F(DohH2ResolverTest, Resolve_AAAA_Record) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("yaddnsc.test", RecordKind::AAAA, cancel);
+
+    ASSERT_TRUE(result.has_value()) << "DoH AAAA query failed: "
+                                    << dns_error_name(result.error().code);
+    ASSERT_GT(result->size(), 12U);
+}
+
+TEST_F(DohH2ResolverTest, SequentialQueries_ShareOneConnection) {
+    // From the second response on, the server refers to the content-type
+    // in its HPACK dynamic table: decoding it needs the same connection.
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-seq");
+    Utils::CancellationToken cancel;
+
+    for (int i = 0; i < 5; ++i) {
+        auto result = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+        ASSERT_TRUE(result.has_value()) << "query " << i << ": " << dns_error_name(result.error().code);
+    }
+}
+
+TEST_F(DohH2ResolverTest, ConcurrentQueries_AllAnswered) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-concurrent");
+    std::atomic<int> answered{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&resolver, &answered, i] {
+            Utils::CancellationToken cancel;
+            auto result = resolver.query("yaddnsc.test", i % 2 == 0 ? RecordKind::A : RecordKind::AAAA, cancel);
+            if (result.has_value()) {
+                ++answered;
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(answered.load(), 16);
+}
+
+TEST_F(DohH2ResolverTest, SlowQuery_DoesNotHoldUpOthers) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-slow");
+
+    // Open the connection, so both queries below share it.
+    Utils::CancellationToken warmup;
+    ASSERT_TRUE(resolver.query("yaddnsc.test", RecordKind::A, warmup).has_value());
+
+    std::chrono::steady_clock::duration slow_took{};
+    std::thread slow([&resolver, &slow_took] {
+        Utils::CancellationToken cancel;
+        const auto start = std::chrono::steady_clock::now();
+        auto result = resolver.query("doh-slow.yaddnsc.test", RecordKind::A, cancel);
+        slow_took = std::chrono::steady_clock::now() - start;
+        EXPECT_TRUE(result.has_value()) << dns_error_name(result.error().code);
+    });
+
+    // Give the slow query time to be sent first.
+    std::this_thread::sleep_for(50ms);
+
+    Utils::CancellationToken cancel;
+    const auto start = std::chrono::steady_clock::now();
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    const auto fast_took = std::chrono::steady_clock::now() - start;
+    slow.join();
+
+    ASSERT_TRUE(result.has_value()) << dns_error_name(result.error().code);
+    // Answered on its own stream: the fast query does not wait for the slow one.
+    EXPECT_LT(fast_took, 200ms);
+    EXPECT_GE(slow_took, 250ms);
+}
+
+TEST_F(DohH2ResolverTest, Http404_ReturnsServerRefused) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-404");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("doh-404.yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::SERVER_REFUSED);
+
+    // The error ended one stream, not the connection.
+    auto next = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    EXPECT_TRUE(next.has_value()) << dns_error_name(next.error().code);
+}
+
+TEST_F(DohH2ResolverTest, Http500_ReturnsRetry) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-500");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("doh-500.yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::RETRY);
+}
+
+TEST_F(DohH2ResolverTest, WrongContentType_ReturnsParseError) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-wrong-ct");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("doh-malformed.yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::PARSE);
+}
+
+TEST_F(DohH2ResolverTest, StreamReset_ReturnsRetry) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-reset");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("doh-reset.yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::RETRY);
+
+    auto next = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    EXPECT_TRUE(next.has_value()) << dns_error_name(next.error().code);
+}
+
+TEST_F(DohH2ResolverTest, Goaway_ReconnectsTransparently) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-goaway");
+    Utils::CancellationToken cancel;
+
+    // Answered, then the server sends GOAWAY and closes the connection.
+    auto r1 = resolver.query("doh-goaway.yaddnsc.test", RecordKind::A, cancel);
+    ASSERT_TRUE(r1.has_value()) << dns_error_name(r1.error().code);
+
+    auto r2 = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    ASSERT_TRUE(r2.has_value()) << dns_error_name(r2.error().code);
+}
+
+TEST_F(DohH2ResolverTest, TimeoutHost_ReturnsRetry) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-timeout");
+    Utils::CancellationToken cancel;
+    auto result = resolver.query("doh-timeout.yaddnsc.test", RecordKind::A, cancel);
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::RETRY)
+        << "Expected RETRY, got " << dns_error_name(result.error().code);
+
+    // The stalled connection is replaced.
+    auto next = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    EXPECT_TRUE(next.has_value()) << dns_error_name(next.error().code);
+}
+
+TEST_F(DohH2ResolverTest, Cancelled_WhileWaiting) {
+    DohResolver resolver("127.0.0.1", DOH_PORT, "/dns-query", "test-doh-h2-cancel");
+    Utils::CancellationSource source;
+
+    std::thread canceller([&source] {
+        std::this_thread::sleep_for(100ms);
+        source.trigger();
+    });
+    auto result = resolver.query("doh-slow.yaddnsc.test", RecordKind::A, source.token());
+    canceller.join();
+
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::CANCELLED);
+
+    // The abandoned stream is reset; the connection carries on.
+    Utils::CancellationToken cancel;
+    auto next = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    EXPECT_TRUE(next.has_value()) << dns_error_name(next.error().code);
+}
+
+} // anonymous namespace
@@ -0,0 +1,327 @@
+#!/usr/bin/env python3
+"""HTTP/2 DoH server for component tests — fully async.
+
+Usage:
+    doh_h2_server.py <port> <cert_pem> <key_pem>
+
+Listens on 127.0.0.1:<port> for DNS-over-HTTPS (RFC 8484) connections over
+HTTP/2 (RFC 9113), negotiated with ALPN "h2".  A minimal stand-in for a real
+h2 server: enough framing and HPACK to answer POST requests, with every
+response sent as soon as it is ready, so responses may come out of order.
+
+Built-in records (same as doh_server.py):
+    yaddnsc.test            A    198.51.100.42
+    yaddnsc.test            AAAA 2001:db8::42
+    doh-slow.yaddnsc.test     —  answer after 300 ms, while answering
+                                 later requests at once
+    doh-timeout.yaddnsc.test  —  never answer
+    doh-404.yaddnsc.test      —  return HTTP 404
+    doh-500.yaddnsc.test      —  return HTTP 500
+    doh-malformed.yaddnsc.test  —  return wrong Content-Type
+    doh-reset.yaddnsc.test    —  reset the stream (RST_STREAM)
+    doh-goaway.yaddnsc.test   —  answer, then GOAWAY and close the connection
+
+Response headers are HPACK-coded the way real servers do it: the
+content-type is added to the dynamic table on first use and indexed from
+then on, and DATA is padded and split over two frames.
+"""
+
+import asyncio
+import signal
+import ssl
+import struct
+import sys
+
+from doh_server import build_dns_response, parse_dns_query
+
+HOST = "127.0.0.1"
+
+SLOW_HOST = "doh-slow.yaddnsc.test"
+SLOW_DELAY = 0.3
+TIMEOUT_HOST = "doh-timeout.yaddnsc.test"
+HTTP_404_HOST = "doh-404.yaddnsc.test"
+HTTP_500_HOST = "doh-500.yaddnsc.test"
+MALFORMED_HOST = "doh-malformed.yaddnsc.test"
+RESET_HOST = "doh-reset.yaddnsc.test"
+GOAWAY_HOST = "doh-goaway.yaddnsc.test"
+
+PREFACE = b"PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"
+
+DATA, HEADERS, PRIORITY, RST_STREAM, SETTINGS = 0x0, 0x1, 0x2, 0x3, 0x4
+PUSH_PROMISE, PING, GOAWAY, WINDOW_UPDATE, CONTINUATION = 0x5, 0x6, 0x7, 0x8, 0x9
+
+END_STREAM, ACK, END_HEADERS, PADDED, PRIORITY_FLAG = 0x1, 0x1, 0x4, 0x8, 0x20
+
+INTERNAL_ERROR = 0x2
+
+# RFC 7541 Appendix A, names only: requests are decoded by name.
+STATIC_NAMES = [
+    ":authority", ":method", ":method", ":path", ":path", ":scheme", ":scheme",
+    ":status", ":status", ":status", ":status", ":status", ":status", ":status",
+    "accept-charset", "accept-encoding", "accept-language", "accept-ranges",
+    "accept", "access-control-allow-origin", "age", "allow", "authorization",
+    "cache-control", "content-disposition", "content-encoding",
+    "content-language", "content-length", "content-location", "content-range",
+    "content-type", "cookie", "date", "etag", "expect", "expires", "from",
+    "host", "if-match", "if-modified-since", "if-none-match", "if-range",
+    "if-unmodified-since", "last-modified", "link", "location", "max-forwards",
+    "proxy-authenticate", "proxy-authorization", "range", "referer", "refresh",
+    "retry-after", "server", "set-cookie", "strict-transport-security",
+    "transfer-encoding", "user-agent", "vary", "via", "www-authenticate",
+]
+STATIC_VALUES = {2: "GET", 3: "POST", 4: "/", 5: "/index.html", 6: "http", 7: "https",
+                 8: "200", 9: "204", 10: "206", 11: "304", 12: "400", 13: "404",
+                 14: "500", 16: "gzip, deflate"}
+
+
+def frame(ftype: int, flags: int, stream_id: int, payload: bytes = b"") -> bytes:
+    return struct.pack("!I", len(payload))[1:] + bytes([ftype, flags]) + \
+        struct.pack("!I", stream_id) + payload
+
+
+def read_int(data: bytes, pos: int, prefix: int) -> tuple[int, int]:
+    mask = (1 << prefix) - 1
+    value = data[pos] & mask
+    pos += 1
+    if value < mask:
+        return value, pos
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        value += (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, pos
+
+
+def write_int(value: int, prefix: int, first: int) -> bytes:
+    mask = (1 << prefix) - 1
+    if value < mask:
+        return bytes([first | value])
+    out = [first | mask]
+    value -= mask
+    while value >= 0x80:
+        out.append((value & 0x7F) | 0x80)
+        value >>= 7
+    out.append(value)
+    return bytes(out)
+
+
+def write_str(text: str) -> bytes:
+    raw = text.encode()
+    return write_int(len(raw), 7, 0) + raw
+
+
+def decode_headers(block: bytes) -> dict:
+    """Decode a request header block.  The client under test never adds to
+    the dynamic table and never Huffman-codes, so neither is supported."""
+    headers = {}
+    pos = 0
+
+    def read_str(at: int) -> tuple[str, int]:
+        if block[at] & 0x80:
+            raise ValueError("Huffman-coded string")
+        length, at = read_int(block, at, 7)
+        return block[at:at + length].decode(), at + length
+
+    while pos < len(block):
+        byte = block[pos]
+        if byte & 0x80:
+            index, pos = read_int(block, pos, 7)
+            headers[STATIC_NAMES[index - 1]] = STATIC_VALUES.get(index, "")
+            continue
+        if byte & 0xE0 == 0x20:
+            _, pos = read_int(block, pos, 5)
+            continue
+        prefix = 6 if byte & 0x40 else 4
+        index, pos = read_int(block, pos, prefix)
+        if index:
+            name = STATIC_NAMES[index - 1]
+        else:
+            name, pos = read_str(pos)
+        value, pos = read_str(pos)
+        headers[name] = value
+    return headers
+
+
+class Connection:
+    """One client connection: its streams and HPACK encoder state."""
+
+    def __init__(self, writer: asyncio.StreamWriter):
+        self.writer = writer
+        self.streams = {}    # stream_id -> [header block, body]
+        self.tasks = {}      # stream_id -> answer_later task
+        self.content_type_indexed = False
+
+    def send(self, data: bytes) -> None:
+        if not self.writer.is_closing():
+            self.writer.write(data)
+
+    def response_headers(self, status: int, content_type: str, length: int) -> bytes:
+        block = write_int(8, 7, 0x80) if status == 200 else \
+            write_int(8, 4, 0x00) + write_str(str(status))
+        if content_type == "application/dns-message":
+            if self.content_type_indexed:
+                block += bytes([0xBE])  # dynamic index 62
+            else:
+                block += write_int(31, 6, 0x40) + write_str(content_type)
+                self.content_type_indexed = True
+        else:
+            block += write_int(31, 4, 0x00) + write_str(content_type)
+        block += write_int(28, 4, 0x00) + write_str(str(length))
+        return block
+
+    def respond(self, stream_id: int, status: int, content_type: str, body: bytes) -> None:
+        block = self.response_headers(status, content_type, len(body))
+        # Header block split over HEADERS + CONTINUATION.
+        half = len(block) // 2
+        out = frame(HEADERS, 0, stream_id, block[:half])
+        out += frame(CONTINUATION, END_HEADERS, stream_id, block[half:])
+        # Padded first DATA frame, the rest in a second.
+        half = len(body) // 2
+        out += frame(DATA, PADDED, stream_id, bytes([4]) + body[:half] + bytes(4))
+        out += frame(DATA, END_STREAM, stream_id, body[half:])
+        self.send(out)
+
+    async def answer_later(self, stream_id: int, body: bytes) -> None:
+        await asyncio.sleep(SLOW_DELAY)
+        self.respond(stream_id, 200, "application/dns-message", body)
+        self.tasks.pop(stream_id, None)
+
+    def on_request(self, stream_id: int, headers: dict, body: bytes) -> bool:
+        """Answer a complete request.  @return False to close the connection."""
+        if headers.get(":method") != "POST" or headers.get(":path") != "/dns-query":
+            self.respond(stream_id, 404, "text/plain", b"not found")
+            return True
+
+        ident, qname, qtype_str, question = parse_dns_query(body)
+        dns_body = build_dns_response(ident, question, qname, qtype_str)
+
+        if qname == TIMEOUT_HOST:
+            return True
+        if qname == SLOW_HOST:
+            self.tasks[stream_id] = asyncio.create_task(self.answer_later(stream_id, dns_body))
+            return True
+        if qname == RESET_HOST:
+            self.send(frame(RST_STREAM, 0, stream_id, struct.pack("!I", INTERNAL_ERROR)))
+            return True
+        if qname == HTTP_404_HOST:
+            self.respond(stream_id, 404, "application/dns-message", dns_body)
+        elif qname == HTTP_500_HOST:
+            self.respond(stream_id, 500, "application/dns-message", dns_body)
+        elif qname == MALFORMED_HOST:
+            self.respond(stream_id, 200, "text/html", b"<html>not dns</html>")
+        else:
+            self.respond(stream_id, 200, "application/dns-message", dns_body)
+
+        if qname == GOAWAY_HOST:
+            self.send(frame(GOAWAY, 0, 0, struct.pack("!II", stream_id, 0)))
+            return False
+        return True
+
+    def on_frame(self, ftype: int, flags: int, stream_id: int, payload: bytes) -> bool:
+        """@return False to close the connection."""
+        if ftype == SETTINGS:
+            if not flags & ACK:
+                self.send(frame(SETTINGS, ACK, 0))
+        elif ftype == PING:
+            if not flags & ACK:
+                self.send(frame(PING, ACK, 0, payload))
+        elif ftype == GOAWAY:
+            return False
+        elif ftype == RST_STREAM:
+            self.streams.pop(stream_id, None)
+            task = self.tasks.pop(stream_id, None)
+            if task:
+                task.cancel()
+        elif ftype == HEADERS:
+            if flags & PADDED:
+                payload = payload[1:len(payload) - payload[0]]
+            if flags & PRIORITY_FLAG:
+                payload = payload[5:]
+            self.streams[stream_id] = [payload, b"", bool(flags & END_HEADERS)]
+            if flags & END_STREAM:
+                return self.end_stream(stream_id)
+        elif ftype == CONTINUATION:
+            state = self.streams[stream_id]
+            state[0] += payload
+            state[2] = bool(flags & END_HEADERS)
+        elif ftype == DATA:
+            if flags & PADDED:
+                payload = payload[1:len(payload) - payload[0]]
+            self.streams[stream_id][1] += payload
+            if flags & END_STREAM:
+                return self.end_stream(stream_id)
+        return True
+
+    def end_stream(self, stream_id: int) -> bool:
+        block, body, _ = self.streams.pop(stream_id)
+        return self.on_request(stream_id, decode_headers(block), body)
+
+
+async def handle_h2_client(reader: asyncio.StreamReader,
+                           writer: asyncio.StreamWriter) -> None:
+    conn = Connection(writer)
+    try:
+        if await reader.readexactly(len(PREFACE)) != PREFACE:
+            return
+        # SETTINGS_MAX_CONCURRENT_STREAMS = 100.
+        conn.send(frame(SETTINGS, 0, 0, struct.pack("!HI", 0x3, 100)))
+
+        while True:
+            header = await reader.readexactly(9)
+            length = struct.unpack("!I", b"\x00" + header[:3])[0]
+            ftype, flags = header[3], header[4]
+            stream_id = struct.unpack("!I", header[5:9])[0] & 0x7FFFFFFF
+            payload = await reader.readexactly(length)
+            if not conn.on_frame(ftype, flags, stream_id, payload):
+                await writer.drain()
+                return
+            await writer.drain()
+
+    except asyncio.IncompleteReadError:
+        pass
+    except Exception:
+        pass
+    finally:
+        for task in conn.tasks.values():
+            task.cancel()
+        writer.close()
+        try:
+            await writer.wait_closed()
+        except (BrokenPipeError, ConnectionResetError, ssl.SSLError):
+            pass
+
+
+async def main() -> None:
+    port = int(sys.argv[1])
+    cert_pem = sys.argv[2]
+    key_pem = sys.argv[3]
+
+    ssl_ctx = ssl.create_default_context(ssl.Purpose.CLIENT_AUTH)
+    ssl_ctx.load_cert_chain(cert_pem, key_pem)
+    ssl_ctx.set_alpn_protocols(["h2"])
+
+    shutdown_event = asyncio.Event()
+
+    def handle_sig() -> None:
+        shutdown_event.set()
+
+    loop = asyncio.get_running_loop()
+    for sig in (signal.SIGTERM, signal.SIGINT):
+        loop.add_signal_handler(sig, handle_sig)
+
+    server = await asyncio.start_server(
+        handle_h2_client, HOST, port, ssl=ssl_ctx,
+        reuse_address=True,
+    )
+
+    print(f"READY port={port} cert={cert_pem}", flush=True)
+
+    async with server:
+        await shutdown_event.wait()
+
+
+if __name__ == "__main__":
+    asyncio.run(main())
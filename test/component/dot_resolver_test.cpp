@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <thread>
@@ -275,4 +276,66 @@ TEST_F(DotResolverTest, NonExistentDomain_FallsBackToDefault) {
     EXPECT_EQ((*result)[57], 1);
 }
 
+TEST_F(DotResolverTest, SequentialQueries_ShareOneConnection) {
+    DotResolver resolver("127.0.0.1", DOT_PORT, "test-dot");
+    Utils::CancellationToken cancel;
+
+    for (int i = 0; i < 5; ++i) {
+        auto result = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+        ASSERT_TRUE(result.has_value()) << "query " << i << ": " << dns_error_name(result.error().code);
+    }
+}
+
+TEST_F(DotResolverTest, ConcurrentQueries_AllAnswered) {
+    DotResolver resolver("127.0.0.1", DOT_PORT, "test-dot");
+    std::atomic<int> answered{0};
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.emplace_back([&resolver, &answered, i] {
+            Utils::CancellationToken cancel;
+            auto result = resolver.query("yaddnsc.test", i % 2 == 0 ? RecordKind::A : RecordKind::AAAA, cancel);
+            if (result.has_value()) {
+                ++answered;
+            }
+        });
+    }
+    for (auto &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(answered.load(), 8);
+}
+
+TEST_F(DotResolverTest, SlowQuery_DoesNotHoldUpOthers) {
+    DotResolver resolver("127.0.0.1", DOT_PORT, "test-dot");
+
+    // Open the connection, so both queries below share it.
+    Utils::CancellationToken warmup;
+    ASSERT_TRUE(resolver.query("yaddnsc.test", RecordKind::A, warmup).has_value());
+
+    std::chrono::steady_clock::duration slow_took{};
+    std::thread slow([&resolver, &slow_took] {
+        Utils::CancellationToken cancel;
+        const auto start = std::chrono::steady_clock::now();
+        auto result = resolver.query("dot-slow.yaddnsc.test", RecordKind::A, cancel);
+        slow_took = std::chrono::steady_clock::now() - start;
+        EXPECT_TRUE(result.has_value()) << dns_error_name(result.error().code);
+    });
+
+    // Give the slow query time to be written first.
+    std::this_thread::sleep_for(50ms);
+
+    Utils::CancellationToken cancel;
+    const auto start = std::chrono::steady_clock::now();
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, cancel);
+    const auto fast_took = std::chrono::steady_clock::now() - start;
+    slow.join();
+
+    ASSERT_TRUE(result.has_value()) << dns_error_name(result.error().code);
+    // Answered out of order: the fast query does not wait for the slow one.
+    EXPECT_LT(fast_took, 200ms);
+    EXPECT_GE(slow_took, 250ms);
+}
+
 } // anonymous namespace
@@ -13,6 +13,12 @@ Built-in records (same as dns_server.py):
     dot-reset.yaddnsc.test    —  close immediately after accepting
     dot-malformed.yaddnsc.test  —  return garbage response
     dot-zerolength.yaddnsc.test —  return 2-byte length prefix of 0
+    dot-slow.yaddnsc.test     —  answer after 300 ms, while answering
+                                 later queries at once
+
+A connection serves any number of queries (RFC 7858 §3.3), each answered
+as soon as it is ready, so responses may come out of order.  The special
+hosts other than dot-slow close the connection.
 """
 
 import asyncio
@@ -32,6 +38,8 @@ TIMEOUT_HOST = "dot-timeout.yaddnsc.test"
 RESET_HOST = "dot-reset.yaddnsc.test"
 MALFORMED_HOST = "dot-malformed.yaddnsc.test"
 ZERO_LENGTH_HOST = "dot-zerolength.yaddnsc.test"
+SLOW_HOST = "dot-slow.yaddnsc.test"
+SLOW_DELAY = 0.3
 
 TYPE_MAP = {1: "A", 28: "AAAA"}
 
@@ -149,46 +157,65 @@ def build_response(ident: int, question: bytes, qname: str, qtype_str: str,
         return header + question
 
 
+async def answer_later(writer: asyncio.StreamWriter, response: bytes) -> None:
+    """Write @response after SLOW_DELAY, without holding up the connection."""
+    await asyncio.sleep(SLOW_DELAY)
+    if not writer.is_closing():
+        writer.write(struct.pack("!H", len(response)) + response)
+        await writer.drain()
+
+
 async def handle_dot_client(reader: asyncio.StreamReader,
                             writer: asyncio.StreamWriter) -> None:
-    """Handle a single DoT (TLS + DNS) connection."""
+    """Handle a DoT (TLS + DNS) connection, serving queries until EOF."""
+    pending = set()
     try:
-        # Read 2-byte big-endian length prefix (RFC 7858 §3.3)
-        raw_len = await reader.readexactly(2)
-        msg_len = struct.unpack("!H", raw_len)[0]
-
-        if msg_len == 0:
-            return
-
-        data = await reader.readexactly(msg_len)
-        ident, qname, qtype_str, question = parse_query(data)
-        if not qname:
-            return
-
-        response = build_response(ident, question, qname, qtype_str, DEFAULT_RECORDS)
-
-        if response is None:
-            # Timeout host: never respond
-            return
-
-        if response == b"":
-            # Reset host: close immediately
-            return
-
-        if response == b"\x00\x00":
-            # Zero-length: write 2-byte 0 length prefix
-            writer.write(b"\x00\x00")
+        while True:
+            # Read 2-byte big-endian length prefix (RFC 7858 §3.3)
+            raw_len = await reader.readexactly(2)
+            msg_len = struct.unpack("!H", raw_len)[0]
+
+            if msg_len == 0:
+                return
+
+            data = await reader.readexactly(msg_len)
+            ident, qname, qtype_str, question = parse_query(data)
+            if not qname:
+                return
+
+            response = build_response(ident, question, qname, qtype_str, DEFAULT_RECORDS)
+
+            if response is None:
+                # Timeout host: never respond
+                return
+
+            if response == b"":
+                # Reset host: close immediately
+                return
+
+            if response == b"\x00\x00":
+                # Zero-length: write 2-byte 0 length prefix
+                writer.write(b"\x00\x00")
+                await writer.drain()
+                return
+
+            if qname == SLOW_HOST:
+                task = asyncio.create_task(answer_later(writer, response))
+                pending.add(task)
+                task.add_done_callback(pending.discard)
+                continue
+
+            writer.write(struct.pack("!H", len(response)) + response)
             await writer.drain()
-            return
-
-        writer.write(struct.pack("!H", len(response)) + response)
-        await writer.drain()
 
     except asyncio.IncompleteReadError:
         pass
     except Exception:
         pass
     finally:
+        # Let delayed answers go out before closing.
+        if pending:
+            await asyncio.gather(*pending, return_exceptions=True)
         writer.close()
         try:
             await writer.wait_closed()
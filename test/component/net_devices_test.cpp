@@ -6,8 +6,15 @@
 //
 // =============================================================================
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
@@ -157,3 +164,113 @@ TEST(NetDevicesTest, DefaultInterface_RoundTrip) {
     }
     // If index == 0 (minimal container), the test is vacuously true.
 }
+
+// ===========================================================================
+// AddressMonitor
+// ===========================================================================
+
+TEST(NetDevicesTest, AddressMonitor_SeedMatchesEnumeration) {
+    NetDevices::AddressMonitor monitor(nullptr);
+
+    const auto snapshot = monitor.snapshot();
+    EXPECT_TRUE(snapshot.contains(LOOPBACK));
+
+    const auto addresses = monitor.get_addresses(LOOPBACK);
+    ASSERT_TRUE(addresses.has_value());
+    EXPECT_EQ(*addresses, NetDevices::enumerate_interfaces().at(LOOPBACK));
+
+    EXPECT_FALSE(monitor.get_addresses("yaddnsc-nonexistent0").has_value());
+}
+
+TEST(NetDevicesTest, AddressMonitor_EventDrivenOnLinux) {
+    NetDevices::AddressMonitor monitor(nullptr);
+#ifdef __linux__
+    EXPECT_TRUE(monitor.is_event_driven());
+#else
+    EXPECT_FALSE(monitor.is_event_driven());
+#endif
+}
+
+TEST(NetDevicesTest, AddressMonitor_ReportsAddressOnDummyInterface) {
+    // Needs CAP_NET_ADMIN, e.g. `unshare -rn ctest -R net_devices`.  Creating
+    // a dummy link in the test's network namespace keeps the host untouched.
+    constexpr auto IFACE = "yaddnsc-mon0";
+    if (std::system("ip link add yaddnsc-mon0 type dummy 2>/dev/null") != 0) {
+        GTEST_SKIP() << "Cannot create a dummy interface (needs CAP_NET_ADMIN)";
+    }
+    struct LinkCleanup {
+        ~LinkCleanup() {
+            [[maybe_unused]] auto _ = std::system("ip link del yaddnsc-mon0 2>/dev/null");
+        }
+    } cleanup;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::set<std::string> changed;
+    NetDevices::AddressMonitor monitor([&](const std::string &name) {
+        std::lock_guard lock(mtx);
+        changed.insert(name);
+        cv.notify_all();
+    });
+
+    const auto wait_for_change = [&] {
+        std::unique_lock lock(mtx);
+        const auto seen = cv.wait_for(lock, std::chrono::seconds(5), [&] { return changed.contains(IFACE); });
+        changed.clear();
+        return seen;
+    };
+
+    ASSERT_EQ(std::system("ip link set yaddnsc-mon0 up && ip addr add 198.51.100.7/32 dev yaddnsc-mon0"), 0);
+    EXPECT_TRUE(wait_for_change());
+
+    const auto addresses = monitor.get_addresses(IFACE);
+    ASSERT_TRUE(addresses.has_value());
+    EXPECT_NE(std::ranges::find(*addresses, InetAddress(*Inet4Address::parse("198.51.100.7"))), addresses->end());
+
+    ASSERT_EQ(std::system("ip addr del 198.51.100.7/32 dev yaddnsc-mon0"), 0);
+    EXPECT_TRUE(wait_for_change());
+    const auto after = monitor.get_addresses(IFACE).value_or(std::vector<InetAddress>{});
+    EXPECT_EQ(std::ranges::find(after, InetAddress(*Inet4Address::parse("198.51.100.7"))), after.end());
+}
+
+TEST(NetDevicesTest, AddressMonitor_KeepsKernelOrderOnDummyInterface) {
+    // The updater publishes the first address of an interface, so the monitor
+    // must list them in the same order as a fresh getifaddrs() enumeration.
+    constexpr auto IFACE = "yaddnsc-mon1";
+    if (std::system("ip link add yaddnsc-mon1 type dummy 2>/dev/null") != 0) {
+        GTEST_SKIP() << "Cannot create a dummy interface (needs CAP_NET_ADMIN)";
+    }
+    struct LinkCleanup {
+        ~LinkCleanup() {
+            [[maybe_unused]] auto _ = std::system("ip link del yaddnsc-mon1 2>/dev/null");
+        }
+    } cleanup;
+
+    NetDevices::AddressMonitor monitor(nullptr);
+
+    const auto wait_for_address = [&](const std::string &address) {
+        const auto wanted = *InetAddress::parse(address);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            const auto current = monitor.get_addresses(IFACE).value_or(std::vector<InetAddress>{});
+            if (std::ranges::find(current, wanted) != current.end()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    };
+
+    ASSERT_EQ(std::system("ip link set yaddnsc-mon1 addrgenmode none && ip link set yaddnsc-mon1 up"), 0);
+    if (std::system("ip -6 addr add 2001:db8:1::1/64 dev yaddnsc-mon1 nodad 2>/dev/null") != 0) {
+        GTEST_SKIP() << "IPv6 is disabled on this host";
+    }
+    ASSERT_TRUE(wait_for_address("2001:db8:1::1"));
+
+    ASSERT_EQ(std::system("ip -6 addr add 2001:db8:1::2/64 dev yaddnsc-mon1 nodad"), 0);
+    ASSERT_TRUE(wait_for_address("2001:db8:1::2"));
+
+    const auto addresses = monitor.get_addresses(IFACE);
+    ASSERT_TRUE(addresses.has_value());
+    EXPECT_EQ(*addresses, NetDevices::enumerate_interfaces().at(IFACE));
+}
@@ -0,0 +1,304 @@
+//
+// Component tests for the Reactor — readiness callbacks on real pipes,
+// timers and cross-thread wake-ups, run against every backend that is
+// compiled in on this platform.
+//
+// =============================================================================
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "network/reactor.h"
+#include "util/fd.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// A non-blocking pipe.
+struct Pipe {
+    Pipe() {
+        std::tie(read_end, write_end) = Utils::make_pipe();
+        ::fcntl(read_end.get(), F_SETFL, O_NONBLOCK);
+        ::fcntl(write_end.get(), F_SETFL, O_NONBLOCK);
+    }
+
+    void write(char byte = 'x') const {
+        ASSERT_EQ(::write(write_end.get(), &byte, 1), 1);
+    }
+
+    void drain() const {
+        char buf[64];
+        while (::read(read_end.get(), buf, sizeof(buf)) > 0) {
+        }
+    }
+
+    Utils::UniqueFd read_end;
+    Utils::UniqueFd write_end;
+};
+
+std::vector<Reactor::Backend> available_backends() {
+    std::vector<Reactor::Backend> out;
+    for (const auto backend: {Reactor::Backend::EPOLL, Reactor::Backend::KQUEUE, Reactor::Backend::POLL}) {
+        if (Reactor::is_available(backend)) {
+            out.push_back(backend);
+        }
+    }
+    return out;
+}
+
+std::string backend_name(const testing::TestParamInfo<Reactor::Backend> &info) {
+    switch (info.param) {
+        case Reactor::Backend::EPOLL:
+            return "Epoll";
+        case Reactor::Backend::KQUEUE:
+            return "Kqueue";
+        case Reactor::Backend::POLL:
+            return "Poll";
+    }
+    return "Unknown";
+}
+
+class ReactorTest : public testing::TestWithParam<Reactor::Backend> {
+protected:
+    Reactor reactor{GetParam()};
+};
+
+} // namespace
+
+TEST(ReactorDefaults, DefaultBackendIsAvailable) {
+    EXPECT_TRUE(Reactor::is_available(Reactor::default_backend()));
+    EXPECT_TRUE(Reactor::is_available(Reactor::Backend::POLL));
+
+    const Reactor reactor;
+    EXPECT_EQ(reactor.backend(), Reactor::default_backend());
+}
+
+// ── fd watches ──────────────────────────────────────────────────────────────
+
+TEST_P(ReactorTest, ReadableFdFiresCallback) {
+    Pipe pipe;
+    short seen = 0;
+    ASSERT_TRUE(reactor.add(pipe.read_end.get(), POLLIN, [&](short revents) { seen = revents; }));
+
+    EXPECT_EQ(reactor.run_once(0ms), 0u);
+    EXPECT_EQ(seen, 0);
+
+    pipe.write();
+    EXPECT_EQ(reactor.run_once(1s), 1u);
+    EXPECT_TRUE(seen & POLLIN);
+}
+
+TEST_P(ReactorTest, WatchesAreLevelTriggered) {
+    Pipe pipe;
+    int calls = 0;
+    ASSERT_TRUE(reactor.add(pipe.read_end.get(), POLLIN, [&](short) { ++calls; }));
+
+    pipe.write();
+    reactor.run_once(1s);
+    reactor.run_once(1s);
+    EXPECT_EQ(calls, 2);
+
+    pipe.drain();
+    reactor.run_once(0ms);
+    EXPECT_EQ(calls, 2);
+}
+
+TEST_P(ReactorTest, ModifyChangesWatchedEvents) {
+    Pipe pipe;
+    short seen = 0;
+    ASSERT_TRUE(reactor.add(pipe.write_end.get(), POLLIN, [&](short revents) { seen = revents; }));
+
+    reactor.run_once(0ms);
+    EXPECT_EQ(seen, 0);
+
+    ASSERT_TRUE(reactor.modify(pipe.write_end.get(), POLLOUT));
+    reactor.run_once(1s);
+    EXPECT_TRUE(seen & POLLOUT);
+}
+
+TEST_P(ReactorTest, AddTwiceAndModifyUnknownFail) {
+    Pipe pipe;
+    ASSERT_TRUE(reactor.add(pipe.read_end.get(), POLLIN, [](short) {}));
+
+    const auto again = reactor.add(pipe.read_end.get(), POLLIN, [](short) {});
+    ASSERT_FALSE(again);
+    EXPECT_EQ(again.error(), EEXIST);
+
+    const auto unknown = reactor.modify(pipe.write_end.get(), POLLOUT);
+    ASSERT_FALSE(unknown);
+    EXPECT_EQ(unknown.error(), ENOENT);
+}
+
+TEST_P(ReactorTest, CallbackMayRemoveItsOwnWatch) {
+    Pipe pipe;
+    int calls = 0;
+    const int fd = pipe.read_end.get();
+    ASSERT_TRUE(reactor.add(fd, POLLIN, [&](short) {
+        ++calls;
+        reactor.remove(fd);
+    }));
+
+    pipe.write();
+    reactor.run_once(1s);
+    reactor.run_once(0ms);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(reactor.watch_count(), 0u);
+}
+
+TEST_P(ReactorTest, WatchRemovedByEarlierCallbackIsSkipped) {
+    Pipe first;
+    Pipe second;
+    int calls = 0;
+    const int first_fd = first.read_end.get();
+    const int second_fd = second.read_end.get();
+    // Whichever fires first removes the other, so exactly one runs.
+    ASSERT_TRUE(reactor.add(first_fd, POLLIN, [&](short) {
+        ++calls;
+        reactor.remove(second_fd);
+    }));
+    ASSERT_TRUE(reactor.add(second_fd, POLLIN, [&](short) {
+        ++calls;
+        reactor.remove(first_fd);
+    }));
+
+    first.write();
+    second.write();
+    reactor.run_once(1s);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(reactor.watch_count(), 1u);
+}
+
+TEST_P(ReactorTest, ManyConcurrentWatchesOnOneThread) {
+    constexpr std::size_t count = 500;
+    std::vector<Pipe> pipes(count);
+    std::size_t done = 0;
+    for (auto &pipe: pipes) {
+        ASSERT_TRUE(reactor.wait_once(pipe.read_end.get(), POLLIN, 5s, [&](short revents) {
+            if (revents & POLLIN) {
+                ++done;
+            }
+        }));
+    }
+
+    for (const auto &pipe: pipes) {
+        pipe.write();
+    }
+    for (int round = 0; round < 100 && done < count; ++round) {
+        reactor.run_once(1s);
+    }
+
+    EXPECT_EQ(done, count);
+    EXPECT_EQ(reactor.watch_count(), 0u);
+    EXPECT_EQ(reactor.timer_count(), 0u);
+}
+
+// ── wait_once ───────────────────────────────────────────────────────────────
+
+TEST_P(ReactorTest, WaitOnceReportsReadinessOnce) {
+    Pipe pipe;
+    std::vector<short> seen;
+    ASSERT_TRUE(reactor.wait_once(pipe.read_end.get(), POLLIN, 5s, [&](short revents) { seen.push_back(revents); }));
+
+    pipe.write();
+    reactor.run_once(1s);
+    reactor.run_once(0ms);
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_TRUE(seen.front() & POLLIN);
+    EXPECT_EQ(reactor.watch_count(), 0u);
+    EXPECT_EQ(reactor.timer_count(), 0u);
+}
+
+TEST_P(ReactorTest, WaitOnceTimesOutWithZeroEvents) {
+    Pipe pipe;
+    std::vector<short> seen;
+    ASSERT_TRUE(reactor.wait_once(pipe.read_end.get(), POLLIN, 20ms, [&](short revents) { seen.push_back(revents); }));
+
+    for (int round = 0; round < 10 && seen.empty(); ++round) {
+        reactor.run_once(1s);
+    }
+    ASSERT_EQ(seen.size(), 1u);
+    EXPECT_EQ(seen.front(), 0);
+    EXPECT_EQ(reactor.watch_count(), 0u);
+
+    // Late readiness is not reported.
+    pipe.write();
+    reactor.run_once(0ms);
+    EXPECT_EQ(seen.size(), 1u);
+}
+
+// ── timers ──────────────────────────────────────────────────────────────────
+
+TEST_P(ReactorTest, TimersFireInDeadlineOrder) {
+    std::vector<int> order;
+    [[maybe_unused]] auto late = reactor.add_timer(30ms, [&] { order.push_back(3); });
+    [[maybe_unused]] auto early = reactor.add_timer(0ms, [&] { order.push_back(1); });
+    [[maybe_unused]] auto middle = reactor.add_timer(10ms, [&] { order.push_back(2); });
+
+    for (int round = 0; round < 20 && order.size() < 3; ++round) {
+        reactor.run_once(1s);
+    }
+    EXPECT_EQ(order, (std::vector{1, 2, 3}));
+    EXPECT_EQ(reactor.timer_count(), 0u);
+}
+
+TEST_P(ReactorTest, CancelledTimerDoesNotFire) {
+    bool fired = false;
+    const auto id = reactor.add_timer(0ms, [&] { fired = true; });
+    EXPECT_TRUE(reactor.cancel_timer(id));
+    EXPECT_FALSE(reactor.cancel_timer(id));
+
+    reactor.run_once(10ms);
+    EXPECT_FALSE(fired);
+}
+
+TEST_P(ReactorTest, RunOnceSleepsUntilNextTimer) {
+    bool fired = false;
+    [[maybe_unused]] auto id = reactor.add_timer(20ms, [&] { fired = true; });
+
+    const auto start = Reactor::Clock::now();
+    reactor.run_once(5s);
+    EXPECT_TRUE(fired);
+    EXPECT_LT(Reactor::Clock::now() - start, 2s);
+}
+
+// ── cross-thread ────────────────────────────────────────────────────────────
+
+TEST_P(ReactorTest, PostFromAnotherThreadWakesTheLoop) {
+    bool ran = false;
+    std::jthread poster([this, &ran] {
+        std::this_thread::sleep_for(20ms);
+        reactor.post([&ran] { ran = true; });
+    });
+
+    const auto start = Reactor::Clock::now();
+    for (int round = 0; round < 5 && !ran; ++round) {
+        reactor.run_once(10s);
+    }
+    EXPECT_TRUE(ran);
+    EXPECT_LT(Reactor::Clock::now() - start, 5s);
+}
+
+TEST_P(ReactorTest, RunReturnsWhenStopRequested) {
+    std::stop_source stop;
+    std::jthread loop([this, token = stop.get_token()] { reactor.run(token); });
+
+    std::this_thread::sleep_for(20ms);
+    stop.request_stop();
+    loop.join();
+    SUCCEED();
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, ReactorTest, testing::ValuesIn(available_backends()), backend_name);
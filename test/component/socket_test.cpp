@@ -6,17 +6,23 @@
 //
 // =============================================================================
 
+#include <chrono>
 #include <cstddef>
 #include <cstring>
+#include <expected>
+#include <optional>
 #include <span>
 
 #include <poll.h>
 
 #include <gtest/gtest.h>
 
+#include "network/awaitable.h"
+#include "network/reactor.h"
 #include "network/socket.h"
 #include "network/socket_addr.h"
 #include "network/inet_address.h"
+#include "util/task.hpp"
 
 // ===========================================================================
 // Basic Socket operations
@@ -475,3 +481,118 @@ TEST(SocketTest, SendRecvWithFlags) {
     EXPECT_EQ(received, static_cast<ssize_t>(msg.size()));
     EXPECT_EQ(std::string(reinterpret_cast<const char *>(buf.data()), msg.size()), msg);
 }
+
+// ===========================================================================
+// Reactor-driven connect / wait
+// ===========================================================================
+
+TEST(SocketTest, AsyncConnectOnLoopback) {
+    auto loopback = InetAddress::parse("127.0.0.1");
+    ASSERT_TRUE(loopback.has_value());
+
+    Socket server(AF_INET, SOCK_STREAM);
+    server.set_reuseaddr(true).value();
+    auto addr = SocketAddr::from_inet(*loopback, 0);
+    ASSERT_TRUE(addr.has_value());
+    server.bind(*addr).value();
+    server.listen(1);
+
+    auto client_target = SocketAddr::from_inet(*loopback, server.get_sockname().port());
+    ASSERT_TRUE(client_target.has_value());
+
+    Reactor reactor;
+    Socket client(AF_INET, SOCK_STREAM);
+    std::optional<std::expected<void, ConnectError>> outcome;
+    client.async_connect(reactor, *client_target, std::chrono::seconds(5),
+                         [&](std::expected<void, ConnectError> result) { outcome = result; });
+
+    for (int round = 0; round < 10 && !outcome; ++round) {
+        reactor.run_once(std::chrono::seconds(1));
+    }
+    ASSERT_TRUE(outcome.has_value());
+    EXPECT_TRUE(outcome->has_value());
+    EXPECT_EQ(reactor.watch_count(), 0u);
+
+    // The server side sees the connection, and the client is told when the
+    // greeting arrives.
+    auto accepted = server.accept();
+    ASSERT_TRUE(accepted.has_value());
+
+    short ready = 0;
+    ASSERT_TRUE(client.async_wait(reactor, POLLIN, std::chrono::seconds(5),
+                                  [&](short revents) { ready = revents; }));
+    reactor.run_once(std::chrono::milliseconds(0));
+    EXPECT_EQ(ready, 0);
+
+    const std::byte greeting[] = {std::byte{'h'}, std::byte{'i'}};
+    ASSERT_EQ(accepted->send(std::span<const std::byte>{greeting}), 2);
+    reactor.run_once(std::chrono::seconds(1));
+    EXPECT_TRUE(ready & POLLIN);
+}
+
+TEST(SocketTest, AsyncConnectRefused) {
+    auto loopback = InetAddress::parse("127.0.0.1");
+    ASSERT_TRUE(loopback.has_value());
+    auto target = SocketAddr::from_inet(*loopback, 1);
+    ASSERT_TRUE(target.has_value());
+
+    Reactor reactor;
+    Socket sock(AF_INET, SOCK_STREAM);
+    std::optional<std::expected<void, ConnectError>> outcome;
+    sock.async_connect(reactor, *target, std::chrono::seconds(5),
+                       [&](std::expected<void, ConnectError> result) { outcome = result; });
+
+    // The outcome is never delivered from inside async_connect itself.
+    EXPECT_FALSE(outcome.has_value());
+
+    for (int round = 0; round < 10 && !outcome; ++round) {
+        reactor.run_once(std::chrono::seconds(1));
+    }
+    ASSERT_TRUE(outcome.has_value());
+    ASSERT_FALSE(outcome->has_value());
+    EXPECT_EQ(outcome->error(), ConnectError::REFUSED);
+}
+
+TEST(SocketTest, AwaitableConnectAndWait) {
+    auto loopback = InetAddress::parse("127.0.0.1");
+    ASSERT_TRUE(loopback.has_value());
+
+    Socket server(AF_INET, SOCK_STREAM);
+    server.set_reuseaddr(true).value();
+    auto addr = SocketAddr::from_inet(*loopback, 0);
+    ASSERT_TRUE(addr.has_value());
+    server.bind(*addr).value();
+    server.listen(1);
+
+    auto client_target = SocketAddr::from_inet(*loopback, server.get_sockname().port());
+    ASSERT_TRUE(client_target.has_value());
+
+    Reactor reactor;
+    Socket client(AF_INET, SOCK_STREAM);
+    bool connected = false;
+    short revents = 0;
+    bool done = false;
+    Utils::start_detached([](Reactor &r, Socket &sock, SocketAddr target, bool &ok, short &ready,
+                             bool &finished) -> Utils::Task<> {
+        ok = (co_await Async::connect(r, sock, target, std::chrono::seconds(5))).has_value();
+        co_await Async::sleep_for(r, std::chrono::milliseconds(1));
+        ready = (co_await Async::wait(r, sock, POLLIN, std::chrono::seconds(5))).value_or(-1);
+        finished = true;
+    }(reactor, client, *client_target, connected, revents, done));
+
+    for (int round = 0; round < 10 && !connected; ++round) {
+        reactor.run_once(std::chrono::seconds(1));
+    }
+    ASSERT_TRUE(connected);
+
+    auto accepted = server.accept();
+    ASSERT_TRUE(accepted.has_value());
+    const std::byte greeting[] = {std::byte{'h'}, std::byte{'i'}};
+    ASSERT_EQ(accepted->send(std::span<const std::byte>{greeting}), 2);
+
+    for (int round = 0; round < 10 && !done; ++round) {
+        reactor.run_once(std::chrono::seconds(1));
+    }
+    ASSERT_TRUE(done);
+    EXPECT_TRUE(revents & POLLIN);
+}
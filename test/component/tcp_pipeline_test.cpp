@@ -0,0 +1,482 @@
+//
+// Component tests for TcpPipeline — a persistent TCP connection carrying
+// pipelined queries, against an in-process loopback responder.
+//
+// Verifies:
+//   - The connection is kept open and reused across queries.
+//   - Pipelined queries are all written on one connection, and replies are
+//     routed to their query whatever the order they arrive in, across
+//     threads and reactors.
+//   - Length-prefixed framing survives replies split across reads, several
+//     replies per read, and replies larger than a UDP payload.
+//   - A broken frame, a server close and a refused connect fail the
+//     queries; the next query opens a new connection.
+//   - A connection closed by the server while idle, or left stuck by an
+//     unanswered query, is replaced before it is reused.
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver/tcp_pipeline.h"
+#include "network/inet_address.h"
+#include "network/reactor.h"
+#include "network/socket.h"
+#include "network/socket_addr.h"
+#include "util/cancellation_token.hpp"
+
+#include "dns_error.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// A query for @p name (type A), with transaction ID @p id.
+std::vector<std::uint8_t> make_query(const std::string &name, std::uint16_t id) {
+    std::vector<std::uint8_t> packet{
+        static_cast<std::uint8_t>(id >> 8), static_cast<std::uint8_t>(id), 0x01, 0x00,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    std::size_t start = 0;
+    while (start <= name.size()) {
+        const auto dot = std::min(name.find('.', start), name.size());
+        packet.push_back(static_cast<std::uint8_t>(dot - start));
+        packet.insert(packet.end(), name.begin() + static_cast<std::ptrdiff_t>(start),
+                      name.begin() + static_cast<std::ptrdiff_t>(dot));
+        start = dot + 1;
+    }
+    packet.insert(packet.end(), {0x00, 0x00, 0x01, 0x00, 0x01});
+    return packet;
+}
+
+// The query echoed back as a response.
+std::vector<std::uint8_t> answer(std::vector<std::uint8_t> query) {
+    query[2] |= 0x80;
+    return query;
+}
+
+// The first label of the question, e.g. "close" for "close.test".
+std::string first_label(const std::vector<std::uint8_t> &query) {
+    return {query.begin() + 13, query.begin() + 13 + query[12]};
+}
+
+// @p message with its 2-byte length prefix.
+std::vector<std::uint8_t> framed(const std::vector<std::uint8_t> &message) {
+    std::vector<std::uint8_t> frame{static_cast<std::uint8_t>(message.size() >> 8),
+                                    static_cast<std::uint8_t>(message.size())};
+    frame.insert(frame.end(), message.begin(), message.end());
+    return frame;
+}
+
+SocketAddr loopback(std::uint16_t port) {
+    return *SocketAddr::from_inet(*InetAddress::parse("127.0.0.1"), port);
+}
+
+// Loopback TCP responder: accepts any number of connections and runs
+// @p handler for every framed query, on its own thread.
+class Responder {
+public:
+    using Handler = std::function<void(Responder &, int conn, std::vector<std::uint8_t> query)>;
+
+    explicit Responder(Handler handler) : handler_(std::move(handler)) {
+        if (!listener_.set_reuseaddr(true) || !listener_.bind(loopback(0))) {
+            throw std::runtime_error("bind failed");
+        }
+        listener_.listen();
+        address_ = listener_.get_sockname();
+        thread_ = std::jthread([this](const std::stop_token &stop_token) { serve(stop_token); });
+    }
+
+    ~Responder() {
+        thread_.request_stop();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    [[nodiscard]] const SocketAddr &address() const noexcept { return address_; }
+
+    // Write raw bytes to connection @p conn.
+    static void write(int conn, const std::vector<std::uint8_t> &bytes) {
+        [[maybe_unused]] auto _ = ::send(conn, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+    }
+
+    static void reply(int conn, const std::vector<std::uint8_t> &message) { write(conn, framed(message)); }
+
+    // Close connection @p conn once the handler returns.
+    void close(int conn) { closing_.push_back(conn); }
+
+    std::atomic<int> accepted{0};
+
+private:
+    struct Connection {
+        Socket sock;
+        std::vector<std::uint8_t> in;
+    };
+
+    void serve(const std::stop_token &stop_token) {
+        while (!stop_token.stop_requested()) {
+            std::vector<pollfd> fds{{listener_.native_handle(), POLLIN, 0}};
+            for (const auto &conn: connections_) {
+                fds.push_back({conn.sock.native_handle(), POLLIN, 0});
+            }
+            if (::poll(fds.data(), fds.size(), 20) <= 0) {
+                continue;
+            }
+            if (fds[0].revents != 0) {
+                if (auto accepted_sock = listener_.accept()) {
+                    connections_.push_back({std::move(*accepted_sock), {}});
+                    ++accepted;
+                }
+            }
+            for (std::size_t i = 1; i < fds.size(); ++i) {
+                if (fds[i].revents != 0) {
+                    read(connections_[i - 1]);
+                }
+            }
+            std::erase_if(connections_, [this](const Connection &conn) {
+                return std::ranges::find(closing_, conn.sock.native_handle()) != closing_.end();
+            });
+            closing_.clear();
+        }
+    }
+
+    void read(Connection &conn) {
+        std::vector<std::uint8_t> buffer(65536);
+        const auto n = conn.sock.recv(std::as_writable_bytes(std::span{buffer}));
+        if (n <= 0) {
+            close(conn.sock.native_handle());
+            return;
+        }
+        conn.in.insert(conn.in.end(), buffer.begin(), buffer.begin() + n);
+        while (conn.in.size() >= 2) {
+            const std::size_t length = (static_cast<std::size_t>(conn.in[0]) << 8) | conn.in[1];
+            if (conn.in.size() < 2 + length) {
+                break;
+            }
+            std::vector<std::uint8_t> query(conn.in.begin() + 2, conn.in.begin() + static_cast<std::ptrdiff_t>(2 + length));
+            conn.in.erase(conn.in.begin(), conn.in.begin() + static_cast<std::ptrdiff_t>(2 + length));
+            handler_(*this, conn.sock.native_handle(), std::move(query));
+        }
+    }
+
+    Socket listener_{AF_INET, SOCK_STREAM};
+    SocketAddr address_;
+    Handler handler_;
+    std::vector<Connection> connections_;
+    std::vector<int> closing_;
+    std::jthread thread_;
+};
+
+// Answers every query at once, except:
+//   - "close.*"  closes the connection instead,
+//   - "stuck.*"  is never answered,
+//   - "zero.*"   gets a zero length prefix.
+Responder::Handler echo() {
+    return [](Responder &self, int conn, std::vector<std::uint8_t> query) {
+        const auto label = first_label(query);
+        if (label == "close") {
+            self.close(conn);
+        } else if (label == "zero") {
+            Responder::write(conn, {0x00, 0x00});
+        } else if (label != "stuck") {
+            Responder::reply(conn, answer(std::move(query)));
+        }
+    };
+}
+
+// Holds @p count queries, then answers them in reverse order, all in one
+// write.
+Responder::Handler reverse_after(std::size_t count) {
+    auto held = std::make_shared<std::vector<std::vector<std::uint8_t> > >();
+    return [held, count](Responder &, int conn, std::vector<std::uint8_t> query) {
+        held->push_back(std::move(query));
+        if (held->size() < count) {
+            return;
+        }
+        std::vector<std::uint8_t> bytes;
+        for (auto it = held->rbegin(); it != held->rend(); ++it) {
+            const auto frame = framed(answer(*it));
+            bytes.insert(bytes.end(), frame.begin(), frame.end());
+        }
+        Responder::write(conn, bytes);
+        held->clear();
+    };
+}
+
+// Run @p reactor until @p done, for at most 5s.
+void run_until(Reactor &reactor, const std::function<bool()> &done) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        reactor.run_once(20ms);
+    }
+}
+
+} // namespace
+
+// ── exchange() ───────────────────────────────────────────────────────────────
+
+TEST(TcpPipelineTest, ExchangeReturnsReply) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 0x1234);
+    const auto reply = pipeline.exchange(query, 1s, {});
+
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(*reply, answer(query));
+}
+
+TEST(TcpPipelineTest, ConnectionIsReused) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    for (std::uint16_t i = 0; i < 5; ++i) {
+        auto query = make_query("yaddnsc.test", i);
+        ASSERT_TRUE(pipeline.exchange(query, 1s, {}).has_value());
+    }
+
+    EXPECT_EQ(pipeline.connections_opened(), 1u);
+    EXPECT_EQ(responder.accepted, 1);
+}
+
+TEST(TcpPipelineTest, PipelinedRepliesReachTheirThreadsOutOfOrder) {
+    constexpr std::size_t THREADS = 8;
+    Responder responder(reverse_after(THREADS));
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    std::vector<std::optional<bool> > matched(THREADS);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < THREADS; ++i) {
+            threads.emplace_back([&, i] {
+                auto query = make_query("host" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i));
+                const auto reply = pipeline.exchange(query, 5s, {});
+                matched[i] = reply && *reply == answer(query);
+            });
+        }
+    }
+
+    for (const auto &ok: matched) {
+        EXPECT_EQ(ok, true);
+    }
+    // Every query went out before the first reply came back.
+    EXPECT_EQ(responder.accepted, 1);
+}
+
+TEST(TcpPipelineTest, LargeReplySplitAcrossReads) {
+    Responder responder([](Responder &, int conn, std::vector<std::uint8_t> query) {
+        auto response = answer(std::move(query));
+        response.resize(20000, 0xAB);
+        const auto frame = framed(response);
+        const auto half = frame.begin() + 7;
+        Responder::write(conn, {frame.begin(), half});
+        std::this_thread::sleep_for(20ms);
+        Responder::write(conn, {half, frame.end()});
+    });
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 3);
+    const auto reply = pipeline.exchange(query, 1s, {});
+
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(reply->size(), 20000u);
+}
+
+TEST(TcpPipelineTest, ZeroLengthFailsWithParse) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto query = make_query("zero.test", 1);
+    const auto reply = pipeline.exchange(query, 1s, {});
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::PARSE);
+}
+
+TEST(TcpPipelineTest, ServerCloseFailsQueryAndNextQueryReconnects) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto closed = make_query("close.test", 1);
+    const auto failed = pipeline.exchange(closed, 1s, {});
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error().code, DnsError::CONNECTION);
+
+    auto query = make_query("yaddnsc.test", 2);
+    const auto reply = pipeline.exchange(query, 1s, {});
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(pipeline.connections_opened(), 2u);
+}
+
+TEST(TcpPipelineTest, IdleConnectionClosedByServerIsReplaced) {
+    // Answers, then closes: the next query must not be sent on the dead
+    // connection.
+    Responder responder([](Responder &self, int conn, std::vector<std::uint8_t> query) {
+        Responder::reply(conn, answer(std::move(query)));
+        self.close(conn);
+    });
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto first = make_query("yaddnsc.test", 1);
+    ASSERT_TRUE(pipeline.exchange(first, 1s, {}).has_value());
+    std::this_thread::sleep_for(100ms);
+
+    auto second = make_query("yaddnsc.test", 2);
+    const auto reply = pipeline.exchange(second, 1s, {});
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(pipeline.connections_opened(), 2u);
+}
+
+TEST(TcpPipelineTest, TimeoutRetiresStuckConnection) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    auto stuck = make_query("stuck.test", 1);
+    const auto timed_out = pipeline.exchange(stuck, 50ms, {});
+    ASSERT_FALSE(timed_out.has_value());
+    EXPECT_EQ(timed_out.error().code, DnsError::RETRY);
+
+    auto query = make_query("yaddnsc.test", 2);
+    ASSERT_TRUE(pipeline.exchange(query, 1s, {}).has_value());
+    EXPECT_EQ(pipeline.connections_opened(), 2u);
+}
+
+TEST(TcpPipelineTest, CancelReturnsCancelled) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+    const Utils::CancellationSource cancel;
+    cancel.trigger();
+
+    auto query = make_query("stuck.test", 1);
+    const auto reply = pipeline.exchange(query, 5s, cancel.token());
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::CANCELLED);
+}
+
+TEST(TcpPipelineTest, RefusedConnectFailsFast) {
+    // A port that was just free: the connect is refused at once.
+    SocketAddr closed;
+    {
+        Socket probe(AF_INET, SOCK_STREAM);
+        ASSERT_TRUE(probe.bind(loopback(0)));
+        closed = probe.get_sockname();
+    }
+    TcpPipeline pipeline(closed, AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 1);
+    const auto start = std::chrono::steady_clock::now();
+    const auto reply = pipeline.exchange(query, 5s, {});
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::CONNECTION);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+// ── send_async() ─────────────────────────────────────────────────────────────
+
+TEST(TcpPipelineTest, AsyncPipelinedRepliesAreRoutedOnTheReactor) {
+    constexpr std::size_t QUERIES = 8;
+    Responder responder(reverse_after(QUERIES));
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+    Reactor reactor;
+
+    std::vector<std::vector<std::uint8_t> > queries;
+    std::vector<TcpPipeline::Ticket> tickets;
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < QUERIES; ++i) {
+        queries.push_back(make_query("host" + std::to_string(i) + ".test", 9));
+    }
+    // All are written while the connection is still being established.
+    for (auto &query: queries) {
+        auto ticket = pipeline.send_async(reactor, query, [&matched, &query](const TcpPipeline::Reply &reply) {
+            matched += reply && *reply == answer(query);
+        });
+        ASSERT_TRUE(ticket.has_value()) << ticket.error().message;
+        tickets.push_back(std::move(*ticket));
+    }
+
+    run_until(reactor, [&] { return matched == QUERIES; });
+    EXPECT_EQ(matched, QUERIES);
+    EXPECT_EQ(responder.accepted, 1);
+
+    tickets.clear();
+    EXPECT_EQ(reactor.watch_count(), 0u);
+}
+
+TEST(TcpPipelineTest, ExpiredTicketRetiresConnection) {
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+    Reactor reactor;
+
+    auto stuck = make_query("stuck.test", 1);
+    auto ticket = pipeline.send_async(reactor, stuck, [](const TcpPipeline::Reply &) {
+        ADD_FAILURE() << "expired query called back";
+    });
+    ASSERT_TRUE(ticket.has_value());
+    reactor.run_once(50ms);
+    ticket->expire();
+
+    auto query = make_query("yaddnsc.test", 2);
+    bool answered = false;
+    auto next = pipeline.send_async(reactor, query, [&answered](const TcpPipeline::Reply &reply) {
+        answered = reply.has_value();
+    });
+    ASSERT_TRUE(next.has_value());
+    run_until(reactor, [&] { return answered; });
+
+    EXPECT_TRUE(answered);
+    EXPECT_EQ(pipeline.connections_opened(), 2u);
+}
+
+TEST(TcpPipelineTest, BlockingAndAsyncQueriesShareTheConnection) {
+    constexpr std::size_t EACH = 32;
+    Responder responder(echo());
+    TcpPipeline pipeline(responder.address(), AF_INET, 1);
+
+    std::atomic<std::size_t> blocking_ok = 0;
+    std::jthread blocking([&] {
+        for (std::size_t i = 0; i < EACH; ++i) {
+            auto query = make_query("blocking" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i));
+            const auto reply = pipeline.exchange(query, 5s, {});
+            blocking_ok += reply && *reply == answer(query);
+        }
+    });
+
+    Reactor reactor;
+    std::vector<std::vector<std::uint8_t> > queries;
+    for (std::size_t i = 0; i < EACH; ++i) {
+        queries.push_back(make_query("async" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i)));
+    }
+    std::vector<TcpPipeline::Ticket> tickets;
+    std::size_t async_ok = 0;
+    for (auto &query: queries) {
+        auto ticket = pipeline.send_async(reactor, query, [&async_ok, &query](const TcpPipeline::Reply &reply) {
+            async_ok += reply && *reply == answer(query);
+        });
+        ASSERT_TRUE(ticket.has_value());
+        tickets.push_back(std::move(*ticket));
+    }
+    run_until(reactor, [&] { return async_ok == EACH; });
+    blocking.join();
+
+    EXPECT_EQ(async_ok, EACH);
+    EXPECT_EQ(blocking_ok, EACH);
+    EXPECT_EQ(pipeline.connections_opened(), 1u);
+}
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <vector>
 
@@ -34,6 +35,7 @@
 #include <openssl/ssl.h>
 
 #include "network/tls_connection.h"
+#include "network/tls_session_cache.h"
 #include "exception/tls.h"
 #include "util/cancellation_token.hpp"
 #include "fmt.hpp"
@@ -367,4 +369,80 @@ TEST_F(TlsConnectionTest, ConnectWithSystemCaBundle) {
     }
 }
 
+/// Send one length-prefixed message and read its echo.  Reading also
+/// processes the TLS 1.3 session tickets the server sent after the handshake.
+void echo_round_trip(TlsConnection &conn, std::string_view payload) {
+    std::vector<std::uint8_t> send_buf;
+    uint32_t be_len = htonl(static_cast<uint32_t>(payload.size()));
+    send_buf.insert(send_buf.end(),
+                    reinterpret_cast<std::uint8_t *>(&be_len),
+                    reinterpret_cast<std::uint8_t *>(&be_len) + 4);
+    send_buf.insert(send_buf.end(), payload.begin(), payload.end());
+
+    Utils::CancellationToken cancel;
+    ASSERT_TRUE(conn.send_all(send_buf, cancel).has_value()) << "send_all failed";
+    std::vector<std::uint8_t> recv_buf(send_buf.size());
+    ASSERT_TRUE(conn.read_exact(recv_buf, cancel).has_value()) << "read_exact failed";
+    EXPECT_EQ(recv_buf, send_buf);
+}
+
+TEST_F(TlsConnectionTest, DefaultContext_ResumesSessionOfEarlierConnection) {
+    const auto *old_env = std::getenv("SSL_CERT_FILE");
+    ::setenv("SSL_CERT_FILE", cert_path.c_str(), 1);
+
+    auto &cache = TlsSessionCache::instance();
+    cache.clear();
+    const auto before = cache.stats();
+
+    TlsOptions opts;
+    opts.connect_timeout = 5s;
+    opts.read_timeout = 5s;
+    opts.write_timeout = 5s;
+
+    TlsConnection first("127.0.0.1", TLS_PORT, opts);
+    ASSERT_TRUE(first.connect().has_value()) << "first connect failed";
+    EXPECT_EQ(SSL_session_reused(first.native_ssl()), 0);
+    echo_round_trip(first, "first");
+    first.close();
+    EXPECT_EQ(cache.size(), 1U);
+
+    TlsConnection second("127.0.0.1", TLS_PORT, opts);
+    ASSERT_TRUE(second.connect().has_value()) << "second connect failed";
+    EXPECT_EQ(SSL_session_reused(second.native_ssl()), 1);
+    echo_round_trip(second, "second");
+
+    const auto after = cache.stats();
+    EXPECT_EQ(after.hits - before.hits, 1U);
+    EXPECT_EQ(after.misses - before.misses, 1U);
+
+    if (old_env) {
+        ::setenv("SSL_CERT_FILE", old_env, 1);
+    } else {
+        ::unsetenv("SSL_CERT_FILE");
+    }
+}
+
+TEST_F(TlsConnectionTest, CustomContext_DoesNotUseSessionCache) {
+    auto &cache = TlsSessionCache::instance();
+    cache.clear();
+    const auto before = cache.stats();
+
+    TlsOptions opts;
+    opts.connect_timeout = 5s;
+    opts.read_timeout = 5s;
+    opts.write_timeout = 5s;
+
+    for (auto payload: {"one", "two"}) {
+        TlsConnection conn("127.0.0.1", TLS_PORT, opts, make_test_ssl_ctx);
+        ASSERT_TRUE(conn.connect().has_value()) << "connect failed";
+        EXPECT_EQ(SSL_session_reused(conn.native_ssl()), 0);
+        echo_round_trip(conn, payload);
+    }
+
+    const auto after = cache.stats();
+    EXPECT_EQ(after.hits, before.hits);
+    EXPECT_EQ(after.misses, before.misses);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
 } // anonymous namespace
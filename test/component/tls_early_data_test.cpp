@@ -0,0 +1,368 @@
+//
+// Component tests for TLS 1.3 early data (0-RTT) in
+// src/network/tls_connection.cpp, against an in-process OpenSSL echo
+// server on loopback.
+//
+// Verifies:
+//   - A first connection, with no session to resume, runs a full handshake
+//     and sends nothing early.
+//   - A resumed connection with TlsOptions::early_data sends its first
+//     write as early data, and the server accepts it.
+//   - Early data the server rejects is sent again after the handshake.
+//   - Without the option, or beyond the server's early data limit, the
+//     data waits for the handshake.
+// =============================================================================
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <openssl/ssl.h>
+
+#include "network/tls_connection.h"
+#include "network/tls_session_cache.h"
+#include "util/cancellation_token.hpp"
+#include "fmt.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string cert_path;
+std::string key_path;
+
+constexpr std::array<unsigned char, 4> ALPN_DOT = {3, 'd', 'o', 't'};
+
+/// What the server saw of one connection.
+struct ServerRecord {
+    bool resumed{false};
+    int early_status{SSL_EARLY_DATA_NOT_SENT};
+    std::size_t early_bytes{0};
+};
+
+/// EarlyDataServer — TLS 1.3 echo server on an ephemeral loopback port.
+///
+/// Each message is a 4-byte big-endian length and that many bytes, and is
+/// echoed back.  Tickets allow @p max_early_data bytes of early data, which
+/// is read if @p accept_early, and otherwise rejected.
+class EarlyDataServer {
+public:
+    EarlyDataServer(bool accept_early, std::uint32_t max_early_data = 16384) : accept_early_(accept_early) {
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_3_VERSION);
+        SSL_CTX_use_certificate_file(ctx_, cert_path.c_str(), SSL_FILETYPE_PEM);
+        SSL_CTX_use_PrivateKey_file(ctx_, key_path.c_str(), SSL_FILETYPE_PEM);
+        SSL_CTX_set_max_early_data(ctx_, max_early_data);
+        SSL_CTX_set_alpn_select_cb(ctx_, select_alpn, nullptr);
+
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ::bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 8);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        acceptor_ = std::jthread([this](std::stop_token stop) { accept_loop(stop); });
+    }
+
+    ~EarlyDataServer() {
+        acceptor_.request_stop();
+        acceptor_.join();
+        for (auto &thread: connections_) {
+            thread.join();
+        }
+        ::close(listen_fd_);
+        SSL_CTX_free(ctx_);
+    }
+
+    [[nodiscard]] std::uint16_t port() const { return port_; }
+
+    /// The records of the connections served so far, in order.
+    [[nodiscard]] std::vector<ServerRecord> records() {
+        std::lock_guard lock(mutex_);
+        return records_;
+    }
+
+private:
+    static int select_alpn(SSL *, const unsigned char **out, unsigned char *outlen, const unsigned char *in,
+                           unsigned int inlen, void *) {
+        if (inlen == 0) {
+            return SSL_TLSEXT_ERR_NOACK;
+        }
+        *outlen = in[0];
+        *out = in + 1;
+        return SSL_TLSEXT_ERR_OK;
+    }
+
+    void accept_loop(const std::stop_token &stop) {
+        while (!stop.stop_requested()) {
+            pollfd pfd{.fd = listen_fd_, .events = POLLIN, .revents = 0};
+            if (::poll(&pfd, 1, 50) <= 0) {
+                continue;
+            }
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd >= 0) {
+                connections_.emplace_back([this, fd] { serve(fd); });
+            }
+        }
+    }
+
+    void serve(int fd) {
+        SSL *ssl = SSL_new(ctx_);
+        SSL_set_fd(ssl, fd);
+
+        std::string in;
+        bool ok = true;
+        if (accept_early_) {
+            for (;;) {
+                std::array<char, 4096> buf{};
+                std::size_t n = 0;
+                const int ret = SSL_read_early_data(ssl, buf.data(), buf.size(), &n);
+                if (ret == SSL_READ_EARLY_DATA_ERROR) {
+                    ok = false;
+                    break;
+                }
+                in.append(buf.data(), n);
+                if (ret == SSL_READ_EARLY_DATA_FINISH) {
+                    break;
+                }
+            }
+        }
+        if (ok && SSL_accept(ssl) == 1) {
+            {
+                std::lock_guard lock(mutex_);
+                records_.push_back({.resumed = SSL_session_reused(ssl) == 1,
+                                    .early_status = SSL_get_early_data_status(ssl),
+                                    .early_bytes = in.size()});
+            }
+            echo(ssl, in);
+            // Otherwise the session is dropped from the server's cache.
+            SSL_shutdown(ssl);
+        }
+
+        SSL_free(ssl);
+        ::close(fd);
+    }
+
+    static void echo(SSL *ssl, std::string &in) {
+        for (;;) {
+            while (in.size() >= 4) {
+                const auto len = (std::uint32_t{static_cast<unsigned char>(in[0])} << 24) |
+                                 (std::uint32_t{static_cast<unsigned char>(in[1])} << 16) |
+                                 (std::uint32_t{static_cast<unsigned char>(in[2])} << 8) |
+                                 std::uint32_t{static_cast<unsigned char>(in[3])};
+                if (in.size() < 4 + len) {
+                    break;
+                }
+                SSL_write(ssl, in.data(), static_cast<int>(4 + len));
+                in.erase(0, 4 + len);
+            }
+            std::array<char, 4096> buf{};
+            const int n = SSL_read(ssl, buf.data(), static_cast<int>(buf.size()));
+            if (n <= 0) {
+                return;
+            }
+            in.append(buf.data(), static_cast<std::size_t>(n));
+        }
+    }
+
+    const bool accept_early_;
+    SSL_CTX *ctx_{nullptr};
+    int listen_fd_{-1};
+    std::uint16_t port_{0};
+
+    std::mutex mutex_;
+    std::vector<ServerRecord> records_;
+    std::vector<std::thread> connections_;
+    std::jthread acceptor_;
+};
+
+/// @p payload with its 4-byte length prefix.
+std::vector<std::uint8_t> framed(std::string_view payload) {
+    const auto len = static_cast<std::uint32_t>(payload.size());
+    std::vector<std::uint8_t> frame{static_cast<std::uint8_t>(len >> 24), static_cast<std::uint8_t>(len >> 16),
+                                    static_cast<std::uint8_t>(len >> 8), static_cast<std::uint8_t>(len)};
+    frame.insert(frame.end(), payload.begin(), payload.end());
+    return frame;
+}
+
+/// Send one message on @p conn and check its echo.
+void echo_round_trip(TlsConnection &conn, std::string_view payload) {
+    const auto frame = framed(payload);
+    Utils::CancellationToken cancel;
+    ASSERT_TRUE(conn.send_all(frame, cancel).has_value()) << "send_all failed";
+    std::vector<std::uint8_t> echo(frame.size());
+    ASSERT_TRUE(conn.read_exact(echo, cancel).has_value()) << "read_exact failed";
+    EXPECT_EQ(echo, frame);
+}
+
+TlsOptions options(bool early_data) {
+    return TlsOptions{.alpn_proto = ALPN_DOT, .connect_timeout = 5s, .read_timeout = 5s, .write_timeout = 5s,
+                      .early_data = early_data};
+}
+
+class TlsEarlyDataTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        char dir_template[] = "/tmp/yaddnsc_tls_early_XXXXXX";
+        const auto *dir = ::mkdtemp(dir_template);
+        ASSERT_NE(dir, nullptr) << "mkdtemp failed";
+        cert_path = std::string(dir) + "/cert.pem";
+        key_path = std::string(dir) + "/key.pem";
+
+        const auto cmd = fmt::format(
+            "openssl req -x509 -newkey rsa:2048 -keyout {} -out {} -days 1 -nodes "
+            "-subj /CN=127.0.0.1 -addext subjectAltName=IP:127.0.0.1 "
+            "-addext basicConstraints=critical,CA:TRUE 2>/dev/null",
+            key_path, cert_path);
+        cert_ready_ = ::system(cmd.c_str()) == 0;
+
+        // The shared default context, which the session cache serves, loads
+        // its CA bundle from here when first used.
+        ::setenv("SSL_CERT_FILE", cert_path.c_str(), 1);
+    }
+
+    void SetUp() override {
+        if (!cert_ready_) {
+            GTEST_SKIP() << "Failed to generate TLS certificate";
+        }
+        TlsSessionCache::instance().clear();
+    }
+
+    /// Connect once to @p server, so that the next connection can resume.
+    static void prime(const EarlyDataServer &server) {
+        TlsConnection first("127.0.0.1", server.port(), options(true));
+        ASSERT_TRUE(first.connect().has_value()) << "first connect failed";
+        echo_round_trip(first, "prime");
+    }
+
+    static inline bool cert_ready_ = false;
+};
+
+TEST_F(TlsEarlyDataTest, FirstConnection_FullHandshake) {
+    EarlyDataServer server(true);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(true));
+    ASSERT_TRUE(conn.connect().has_value());
+    echo_round_trip(conn, "hello");
+    EXPECT_FALSE(conn.early_data_accepted());
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 1U);
+    EXPECT_FALSE(records[0].resumed);
+    EXPECT_EQ(records[0].early_status, SSL_EARLY_DATA_NOT_SENT);
+}
+
+TEST_F(TlsEarlyDataTest, ResumedConnection_SendsFirstWriteAsEarlyData) {
+    EarlyDataServer server(true);
+    prime(server);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(true));
+    ASSERT_TRUE(conn.connect().has_value());
+    // Before the handshake: the protocol of the resumed session.
+    EXPECT_EQ(conn.negotiated_alpn(), "dot");
+    echo_round_trip(conn, "early query");
+    EXPECT_TRUE(conn.early_data_accepted());
+    EXPECT_EQ(conn.negotiated_alpn(), "dot");
+    // Later writes are ordinary data.
+    echo_round_trip(conn, "second query");
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_TRUE(records[1].resumed);
+    EXPECT_EQ(records[1].early_status, SSL_EARLY_DATA_ACCEPTED);
+    EXPECT_EQ(records[1].early_bytes, framed("early query").size());
+}
+
+TEST_F(TlsEarlyDataTest, RejectedEarlyData_IsSentAgain) {
+    EarlyDataServer server(false);
+    prime(server);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(true));
+    ASSERT_TRUE(conn.connect().has_value());
+    echo_round_trip(conn, "early query");
+    EXPECT_FALSE(conn.early_data_accepted());
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_TRUE(records[1].resumed);
+    EXPECT_EQ(records[1].early_status, SSL_EARLY_DATA_REJECTED);
+    EXPECT_EQ(records[1].early_bytes, 0U);
+}
+
+TEST_F(TlsEarlyDataTest, OptionOff_WaitsForHandshake) {
+    EarlyDataServer server(true);
+    prime(server);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(false));
+    ASSERT_TRUE(conn.connect().has_value());
+    echo_round_trip(conn, "query");
+    EXPECT_FALSE(conn.early_data_accepted());
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_TRUE(records[1].resumed);
+    EXPECT_EQ(records[1].early_status, SSL_EARLY_DATA_NOT_SENT);
+}
+
+TEST_F(TlsEarlyDataTest, WriteBeyondLimit_WaitsForHandshake) {
+    EarlyDataServer server(true, 64);
+    prime(server);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(true));
+    ASSERT_TRUE(conn.connect().has_value());
+    echo_round_trip(conn, std::string(200, 'x'));
+    EXPECT_FALSE(conn.early_data_accepted());
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_TRUE(records[1].resumed);
+    EXPECT_EQ(records[1].early_status, SSL_EARLY_DATA_NOT_SENT);
+}
+
+TEST_F(TlsEarlyDataTest, ReadFirst_CompletesHandshakeWithoutEarlyData) {
+    EarlyDataServer server(true);
+    prime(server);
+
+    TlsConnection conn("127.0.0.1", server.port(), options(true));
+    ASSERT_TRUE(conn.connect().has_value());
+    // Nothing to read: the handshake completes, then the read times out.
+    conn.set_read_timeout(100ms);
+    std::array<std::uint8_t, 1> byte{};
+    const auto read = conn.read_some(byte, {});
+    ASSERT_FALSE(read.has_value());
+    EXPECT_EQ(read.error(), TlsConnection::IoStatus::TIMEOUT);
+    conn.set_read_timeout(5s);
+    echo_round_trip(conn, "query");
+    conn.close();
+
+    const auto records = server.records();
+    ASSERT_EQ(records.size(), 2U);
+    EXPECT_TRUE(records[1].resumed);
+    EXPECT_EQ(records[1].early_status, SSL_EARLY_DATA_NOT_SENT);
+}
+
+} // anonymous namespace
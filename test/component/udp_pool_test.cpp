@@ -0,0 +1,390 @@
+//
+// Component tests for UdpSocketPool — pooled, connected UDP sockets shared
+// by concurrent queries, against an in-process loopback responder.
+//
+// Verifies:
+//   - Replies are routed to their query by ID and question, whatever the
+//     order they arrive in and whichever thread reads them.
+//   - Unmatched and foreign replies are dropped.
+//   - Colliding transaction IDs are rewritten.
+//   - Timeout, cancellation and ICMP port-unreachable are reported.
+//   - Sockets rotate after MAX_QUERIES_PER_SOCKET queries.
+// =============================================================================
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver/udp_pool.h"
+#include "network/inet_address.h"
+#include "network/reactor.h"
+#include "network/socket.h"
+#include "network/socket_addr.h"
+#include "util/cancellation_token.hpp"
+
+#include "dns_error.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// A query for @p name (type A), with transaction ID @p id.
+std::vector<std::uint8_t> make_query(const std::string &name, std::uint16_t id) {
+    std::vector<std::uint8_t> packet{
+        static_cast<std::uint8_t>(id >> 8), static_cast<std::uint8_t>(id), 0x01, 0x00,
+        0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+    std::size_t start = 0;
+    while (start <= name.size()) {
+        const auto dot = std::min(name.find('.', start), name.size());
+        packet.push_back(static_cast<std::uint8_t>(dot - start));
+        packet.insert(packet.end(), name.begin() + static_cast<std::ptrdiff_t>(start),
+                      name.begin() + static_cast<std::ptrdiff_t>(dot));
+        start = dot + 1;
+    }
+    packet.insert(packet.end(), {0x00, 0x00, 0x01, 0x00, 0x01});
+    return packet;
+}
+
+// The query echoed back as a response.
+std::vector<std::uint8_t> answer(std::vector<std::uint8_t> query) {
+    query[2] |= 0x80;
+    return query;
+}
+
+std::uint16_t id_of(const std::vector<std::uint8_t> &packet) {
+    return static_cast<std::uint16_t>((packet[0] << 8) | packet[1]);
+}
+
+SocketAddr loopback(std::uint16_t port) {
+    return *SocketAddr::from_inet(*InetAddress::parse("127.0.0.1"), port);
+}
+
+// Loopback UDP responder: runs @p handler for every datagram on its own
+// thread.
+class Responder {
+public:
+    using Handler = std::function<void(Responder &, std::vector<std::uint8_t>, const SocketAddr &)>;
+
+    explicit Responder(Handler handler) : handler_(std::move(handler)) {
+        if (!sock_.bind(loopback(0))) {
+            throw std::runtime_error("bind failed");
+        }
+        address_ = sock_.get_sockname();
+        thread_ = std::jthread([this](const std::stop_token &stop_token) { serve(stop_token); });
+    }
+
+    ~Responder() {
+        stop();
+    }
+
+    // Join the responder thread.
+    void stop() {
+        thread_.request_stop();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    [[nodiscard]] const SocketAddr &address() const noexcept { return address_; }
+
+    void send(const std::vector<std::uint8_t> &packet, const SocketAddr &to) const {
+        [[maybe_unused]] auto _ = sock_.send_to(std::as_bytes(std::span{packet}), to);
+    }
+
+    // Source ports seen so far.  Read after stop().
+    std::set<std::uint16_t> ports;
+
+private:
+    void serve(const std::stop_token &stop_token) {
+        std::vector<std::uint8_t> buffer(4096);
+        while (!stop_token.stop_requested()) {
+            if (const auto ready = sock_.wait_for(POLLIN, 20); !ready || *ready == 0) {
+                continue;
+            }
+            SocketAddr from;
+            const auto n = sock_.recv_from(std::as_writable_bytes(std::span{buffer}), &from);
+            if (n <= 0) {
+                continue;
+            }
+            ports.insert(from.port());
+            handler_(*this, {buffer.begin(), buffer.begin() + n}, from);
+        }
+    }
+
+    Socket sock_{AF_INET, SOCK_DGRAM};
+    SocketAddr address_;
+    Handler handler_;
+    std::jthread thread_;
+};
+
+Responder::Handler echo() {
+    return [](Responder &self, std::vector<std::uint8_t> query, const SocketAddr &from) {
+        self.send(answer(std::move(query)), from);
+    };
+}
+
+// Holds @p count queries, then answers them in reverse order.
+Responder::Handler reverse_after(std::size_t count) {
+    auto held = std::make_shared<std::vector<std::pair<std::vector<std::uint8_t>, SocketAddr> > >();
+    return [held, count](Responder &self, std::vector<std::uint8_t> query, const SocketAddr &from) {
+        held->emplace_back(std::move(query), from);
+        if (held->size() < count) {
+            return;
+        }
+        for (auto it = held->rbegin(); it != held->rend(); ++it) {
+            self.send(answer(it->first), it->second);
+        }
+        held->clear();
+    };
+}
+
+Responder::Handler ignore() {
+    return [](Responder &, std::vector<std::uint8_t>, const SocketAddr &) {
+    };
+}
+
+// Run @p reactor until @p done, for at most 5s.
+void run_until(Reactor &reactor, const std::function<bool()> &done) {
+    const auto deadline = std::chrono::steady_clock::now() + 5s;
+    while (!done() && std::chrono::steady_clock::now() < deadline) {
+        reactor.run_once(20ms);
+    }
+}
+
+} // namespace
+
+// ── exchange() ───────────────────────────────────────────────────────────────
+
+TEST(UdpSocketPoolTest, ExchangeReturnsReply) {
+    Responder responder(echo());
+    UdpSocketPool pool(responder.address(), AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 0x1234);
+    const auto reply = pool.exchange(query, 1s, {});
+
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(*reply, answer(query));
+}
+
+TEST(UdpSocketPoolTest, OutOfOrderRepliesReachTheirThreads) {
+    constexpr std::size_t THREADS = 8;
+    Responder responder(reverse_after(THREADS));
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+
+    std::vector<std::optional<bool> > matched(THREADS);
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < THREADS; ++i) {
+            threads.emplace_back([&, i] {
+                auto query = make_query("host" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i));
+                const auto reply = pool.exchange(query, 5s, {});
+                matched[i] = reply && *reply == answer(query);
+            });
+        }
+    }
+
+    for (const auto &ok: matched) {
+        EXPECT_EQ(ok, true);
+    }
+}
+
+TEST(UdpSocketPoolTest, UnmatchedAndForeignRepliesAreDropped) {
+    Responder responder([](Responder &self, std::vector<std::uint8_t> query, const SocketAddr &from) {
+        auto wrong_id = answer(query);
+        wrong_id[1] ^= 0xFF;
+        self.send(wrong_id, from);
+        auto foreign = answer(make_query("other.test", id_of(query)));
+        self.send(foreign, from);
+        self.send(answer(std::move(query)), from);
+    });
+    UdpSocketPool pool(responder.address(), AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 7);
+    const auto reply = pool.exchange(query, 1s, {});
+
+    ASSERT_TRUE(reply.has_value()) << reply.error().message;
+    EXPECT_EQ(*reply, answer(query));
+}
+
+TEST(UdpSocketPoolTest, CollidingIdsAreRewritten) {
+    Responder responder(reverse_after(2));
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+
+    auto first = make_query("yaddnsc.test", 42);
+    auto second = first;
+    std::optional<bool> first_ok;
+    std::optional<bool> second_ok;
+    {
+        std::jthread a([&] {
+            const auto reply = pool.exchange(first, 5s, {});
+            first_ok = reply && *reply == answer(first);
+        });
+        std::jthread b([&] {
+            const auto reply = pool.exchange(second, 5s, {});
+            second_ok = reply && *reply == answer(second);
+        });
+    }
+
+    EXPECT_EQ(first_ok, true);
+    EXPECT_EQ(second_ok, true);
+    EXPECT_NE(id_of(first), id_of(second));
+}
+
+TEST(UdpSocketPoolTest, TimeoutReturnsRetry) {
+    Responder responder(ignore());
+    UdpSocketPool pool(responder.address(), AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 1);
+    const auto reply = pool.exchange(query, 50ms, {});
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::RETRY);
+}
+
+TEST(UdpSocketPoolTest, CancelReturnsCancelled) {
+    Responder responder(ignore());
+    UdpSocketPool pool(responder.address(), AF_INET, 1);
+    const Utils::CancellationSource cancel;
+    cancel.trigger();
+
+    auto query = make_query("yaddnsc.test", 1);
+    const auto reply = pool.exchange(query, 5s, cancel.token());
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::CANCELLED);
+}
+
+TEST(UdpSocketPoolTest, PortUnreachableFailsFast) {
+    // A port that was just free: ICMP port-unreachable comes back at once.
+    SocketAddr closed;
+    {
+        Socket probe(AF_INET, SOCK_DGRAM);
+        ASSERT_TRUE(probe.bind(loopback(0)));
+        closed = probe.get_sockname();
+    }
+    UdpSocketPool pool(closed, AF_INET, 1);
+
+    auto query = make_query("yaddnsc.test", 1);
+    const auto start = std::chrono::steady_clock::now();
+    const auto reply = pool.exchange(query, 5s, {});
+
+    ASSERT_FALSE(reply.has_value());
+    EXPECT_EQ(reply.error().code, DnsError::CONNECTION);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST(UdpSocketPoolTest, SocketsRotate) {
+    Responder responder(echo());
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+
+    for (std::size_t i = 0; i <= UdpSocketPool::MAX_QUERIES_PER_SOCKET; ++i) {
+        auto query = make_query("yaddnsc.test", static_cast<std::uint16_t>(i));
+        ASSERT_TRUE(pool.exchange(query, 1s, {}).has_value());
+    }
+
+    EXPECT_EQ(pool.socket_count(), 1u);
+    responder.stop();
+    EXPECT_EQ(responder.ports.size(), 2u);
+}
+
+// ── send_async() ─────────────────────────────────────────────────────────────
+
+TEST(UdpSocketPoolTest, AsyncRepliesAreRoutedOnTheReactor) {
+    constexpr std::size_t QUERIES = 8;
+    Responder responder(reverse_after(QUERIES));
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+    Reactor reactor;
+
+    std::vector<std::vector<std::uint8_t> > queries;
+    std::vector<UdpSocketPool::Ticket> tickets;
+    std::size_t matched = 0;
+    for (std::size_t i = 0; i < QUERIES; ++i) {
+        queries.push_back(make_query("host" + std::to_string(i) + ".test", 9));
+    }
+    for (auto &query: queries) {
+        auto ticket = pool.send_async(reactor, query, [&matched, &query](const UdpSocketPool::Reply &reply) {
+            matched += reply && *reply == answer(query);
+        });
+        ASSERT_TRUE(ticket.has_value()) << ticket.error().message;
+        tickets.push_back(std::move(*ticket));
+    }
+
+    run_until(reactor, [&] { return matched == QUERIES; });
+    EXPECT_EQ(matched, QUERIES);
+
+    tickets.clear();
+    EXPECT_EQ(reactor.watch_count(), 0u);
+}
+
+TEST(UdpSocketPoolTest, ResetTicketWithdrawsQuery) {
+    Responder responder(reverse_after(2));
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+    Reactor reactor;
+
+    auto withdrawn_query = make_query("withdrawn.test", 1);
+    auto kept_query = make_query("kept.test", 2);
+    bool withdrawn_called = false;
+    bool kept_called = false;
+    auto withdrawn = pool.send_async(reactor, withdrawn_query, [&](const UdpSocketPool::Reply &) {
+        withdrawn_called = true;
+    });
+    ASSERT_TRUE(withdrawn.has_value());
+    withdrawn->reset();
+    auto kept = pool.send_async(reactor, kept_query, [&](const UdpSocketPool::Reply &) { kept_called = true; });
+    ASSERT_TRUE(kept.has_value());
+
+    run_until(reactor, [&] { return kept_called; });
+    EXPECT_TRUE(kept_called);
+    EXPECT_FALSE(withdrawn_called);
+}
+
+TEST(UdpSocketPoolTest, BlockingAndAsyncQueriesShareASocket) {
+    constexpr std::size_t EACH = 32;
+    Responder responder(echo());
+    UdpSocketPool pool(responder.address(), AF_INET, 1, 1);
+
+    std::atomic<std::size_t> blocking_ok = 0;
+    std::jthread blocking([&] {
+        for (std::size_t i = 0; i < EACH; ++i) {
+            auto query = make_query("blocking" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i));
+            const auto reply = pool.exchange(query, 5s, {});
+            blocking_ok += reply && *reply == answer(query);
+        }
+    });
+
+    Reactor reactor;
+    std::vector<std::vector<std::uint8_t> > queries;
+    for (std::size_t i = 0; i < EACH; ++i) {
+        queries.push_back(make_query("async" + std::to_string(i) + ".test", static_cast<std::uint16_t>(i)));
+    }
+    std::vector<UdpSocketPool::Ticket> tickets;
+    std::size_t async_ok = 0;
+    for (auto &query: queries) {
+        auto ticket = pool.send_async(reactor, query, [&async_ok, &query](const UdpSocketPool::Reply &reply) {
+            async_ok += reply && *reply == answer(query);
+        });
+        ASSERT_TRUE(ticket.has_value());
+        tickets.push_back(std::move(*ticket));
+    }
+    run_until(reactor, [&] { return async_ok == EACH; });
+    blocking.join();
+
+    EXPECT_EQ(async_ok, EACH);
+    EXPECT_EQ(blocking_ok, EACH);
+}
@@ -7,18 +7,24 @@
 //   - parse_config<T>() throws ParamParseException on malformed JSON.
 //   - get_abi_version() returns a non-zero, sane constant.
 //   - BaseDriver can be inherited and used as the default Driver interface.
+//   - execute_batch() falls back to one execute() per item.
+//   - prepare() keeps the raw JSON for BaseDriver, and parses it once into
+//     the typed params for TypedDriver.
 // =============================================================================
 
 #include <string>
 #include <optional>
 #include <type_traits>
+#include <vector>
 
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <glaze/glaze.hpp>
 
 #include "driver/base.h"
 #include "driver/exceptions.h"
 #include "interface/abi_version.h"
+#include "mocks/mock_http_client.h"
 
 // ── Test fixture: a minimal concrete subclass of BaseDriver ──────────────────
 
@@ -63,6 +69,25 @@ struct glz::meta<TestConfig> {
     );
 };
 
+// ── Test fixture: a TypedDriver that puts the parsed params into the URL ─────
+
+class TestTypedDriver final : public TypedDriver<TestConfig> {
+public:
+    [[nodiscard]] DriverRequestContext build_request(
+        const TestConfig &params, const DriverUpdateParams &ctx
+    ) const override {
+        return {.url = params.endpoint + "?key=" + params.api_key + "&ip=" + ctx.ip_addr, .request = {}};
+    }
+
+    [[nodiscard]] bool check_response(const HttpResponse &response) const override {
+        return response.status_code >= 200 && response.status_code < 300;
+    }
+
+    [[nodiscard]] DriverDetail get_detail() const noexcept override {
+        return {.name = "typed", .description = "Typed test driver", .author = "test", .version = "1.0.0"};
+    }
+};
+
 // ── Tests ──────────────────────────────────────────────────────────────────
 
 TEST(BaseDriverTest, GetAbiVersion_ReturnsNonZeroVersion) {
@@ -183,3 +208,102 @@ TEST(BaseDriverTest, Execute_RequiresHttpClient) {
     // but we can verify the signature compiles and that the method exists.
     SUCCEED();
 }
+
+// ── Default execute_batch flow ─────────────────────────────────────────────
+
+TEST(BaseDriverTest, ExecuteBatch_FallsBackToOneExchangePerItem) {
+    using ::testing::Return;
+
+    TestDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange)
+        .WillOnce(Return(HttpResponse{.status_code = 200, .body = "ok"}))
+        .WillOnce(Return(HttpResponse{.status_code = 500, .body = "fail"}));
+
+    const std::vector<DriverBatchItem> items{
+        {.config = "{}", .ctx = {.ip_addr = "1.2.3.4", .rd_type = "A", .domain = "example.com",
+                                 .subdomain = "a", .fqdn = "a.example.com"}},
+        {.config = "{}", .ctx = {.ip_addr = "1.2.3.4", .rd_type = "A", .domain = "example.com",
+                                 .subdomain = "b", .fqdn = "b.example.com"}},
+    };
+
+    const auto results = driver.execute_batch(items, http);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_FALSE(results[1]);
+}
+
+// ── Prepared handles ───────────────────────────────────────────────────────
+
+namespace {
+    DriverUpdateParams make_ctx(std::string subdomain) {
+        return {.ip_addr = "1.2.3.4", .rd_type = "A", .domain = "example.com", .subdomain = subdomain,
+                .fqdn = subdomain + ".example.com"};
+    }
+}
+
+TEST(BaseDriverTest, ExecutePrepared_ForwardsRawConfigToExecute) {
+    using ::testing::Return;
+
+    TestDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange("https://example.com/update", ::testing::_))
+        .WillOnce(Return(HttpResponse{.status_code = 200, .body = "ok"}));
+
+    const auto handle = driver.prepare("{}");
+    ASSERT_NE(handle, nullptr);
+    EXPECT_TRUE(driver.execute_prepared(*handle, make_ctx("a"), http));
+}
+
+TEST(TypedDriverTest, Prepare_InvalidConfig_ThrowsParamParseException) {
+    TestTypedDriver driver;
+    EXPECT_THROW(
+        { [[maybe_unused]] auto _ = driver.prepare(R"({"api_key":"abc123"})"); },
+        ParamParseException
+    );
+}
+
+TEST(TypedDriverTest, ExecutePrepared_UsesParsedParams) {
+    using ::testing::Return;
+
+    TestTypedDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange("https://api.example.com?key=abc123&ip=1.2.3.4", ::testing::_))
+        .Times(2)
+        .WillRepeatedly(Return(HttpResponse{.status_code = 200, .body = "ok"}));
+
+    // One handle serves any number of updates.
+    const auto handle = driver.prepare(R"({"api_key":"abc123","endpoint":"https://api.example.com"})");
+    EXPECT_TRUE(driver.execute_prepared(*handle, make_ctx("a"), http));
+    EXPECT_TRUE(driver.execute_prepared(*handle, make_ctx("b"), http));
+}
+
+TEST(TypedDriverTest, ExecuteBatchPrepared_FallsBackToOneExchangePerItem) {
+    using ::testing::Return;
+
+    TestTypedDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange("https://a.example.com?key=a&ip=1.2.3.4", ::testing::_))
+        .WillOnce(Return(HttpResponse{.status_code = 200, .body = "ok"}));
+    EXPECT_CALL(http, exchange("https://b.example.com?key=b&ip=1.2.3.4", ::testing::_))
+        .WillOnce(Return(HttpResponse{.status_code = 500, .body = "fail"}));
+
+    const auto first = driver.prepare(R"({"api_key":"a","endpoint":"https://a.example.com"})");
+    const auto second = driver.prepare(R"({"api_key":"b","endpoint":"https://b.example.com"})");
+    const std::vector<DriverPreparedItem> items{
+        {.handle = *first, .ctx = make_ctx("a")},
+        {.handle = *second, .ctx = make_ctx("b")},
+    };
+
+    const auto results = driver.execute_batch_prepared(items, http);
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_FALSE(results[1]);
+}
+
+TEST(TypedDriverTest, GenerateRequest_ParsesStringConfig) {
+    TestTypedDriver driver;
+    const auto generated = driver.generate_request(
+        R"({"api_key":"abc123","endpoint":"https://api.example.com"})", make_ctx("a"));
+    EXPECT_EQ(generated.url, "https://api.example.com?key=abc123&ip=1.2.3.4");
+}
@@ -11,14 +11,19 @@
 //   - check_response() returns true for success=true with result.
 //   - check_response() returns false for success=false with errors.
 //   - check_response() returns false for unparseable response.
+//   - execute_batch() sends one batch request per zone.
 // =============================================================================
 
+#include <vector>
+
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "cloudflare.h"
 #include "config.hpp"
 #include "response.hpp"
 #include "factory_test_helpers.h"
+#include "mocks/mock_http_client.h"
 
 // ── Helper: build a minimal success response ─────────────────────────────────
 std::string make_success_response(std::string_view type, std::string_view name,
@@ -186,3 +191,87 @@ TEST(CloudflareDriverTest, FactoryCreateDestroy) { test_factory_create_destroy()
 TEST(CloudflareDriverTest, FactoryMagic) { test_factory_magic(); }
 TEST(CloudflareDriverTest, FactoryBuildId) { test_factory_build_id(); }
 TEST(CloudflareDriverTest, FactoryCompilerIdHash) { test_factory_compiler_id_hash(); }
+
+// ── Batch updates ──────────────────────────────────────────────────────────
+
+namespace {
+    DriverBatchItem make_batch_item(std::string_view zone, std::string_view record, std::string_view sub) {
+        return {
+            .config = fmt::format(R"({{"zone_id":"{}","record_id":"{}","token":"tok"}})", zone, record),
+            .ctx = {.ip_addr = "1.2.3.4", .rd_type = "A", .domain = "example.com",
+                    .subdomain = std::string(sub), .fqdn = fmt::format("{}.example.com", sub)},
+        };
+    }
+
+    constexpr std::string_view BATCH_SUCCESS =
+        R"({"success":true,"errors":[],"messages":[],"result":{"deletes":[],"patches":[],"posts":[],"puts":[]}})";
+}
+
+TEST(CloudflareDriverTest, ExecuteBatch_SameZone_SendsSingleBatchRequest) {
+    using ::testing::_;
+    using ::testing::Return;
+
+    CloudflareDriver driver;
+    MockHttpClient http;
+
+    std::string captured_url;
+    std::string captured_body;
+    EXPECT_CALL(http, exchange(_, _))
+        .WillOnce([&](std::string_view url, const HttpRequest &req) -> HttpResult {
+            captured_url = std::string(url);
+            captured_body = req.body.value_or("");
+            EXPECT_EQ(req.method, DriverHttpMethod::POST);
+            return HttpResponse{.status_code = 200, .body = std::string(BATCH_SUCCESS)};
+        });
+
+    const std::vector items{make_batch_item("z1", "r1", "a"), make_batch_item("z1", "r2", "b")};
+    const auto results = driver.execute_batch(items, http);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[1]);
+    EXPECT_EQ(captured_url, "https://api.cloudflare.com/client/v4/zones/z1/dns_records/batch");
+    EXPECT_NE(captured_body.find(R"("puts":[)"), std::string::npos);
+    EXPECT_NE(captured_body.find(R"("id":"r1")"), std::string::npos);
+    EXPECT_NE(captured_body.find(R"("id":"r2")"), std::string::npos);
+}
+
+TEST(CloudflareDriverTest, ExecuteBatch_Rejected_FailsEveryRecordOfZone) {
+    using ::testing::Return;
+
+    CloudflareDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(HttpResponse{
+        .status_code = 400,
+        .body = R"({"success":false,"errors":[{"code":1004,"message":"DNS Validation Error"}],"messages":[]})"}));
+
+    const std::vector items{make_batch_item("z1", "r1", "a"), make_batch_item("z1", "r2", "b")};
+    const auto results = driver.execute_batch(items, http);
+
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0]);
+    EXPECT_FALSE(results[1]);
+}
+
+TEST(CloudflareDriverTest, ExecuteBatch_DifferentZones_OneRequestPerZone) {
+    using ::testing::_;
+    using ::testing::Return;
+
+    CloudflareDriver driver;
+    MockHttpClient http;
+    // Zone z1 has two records (batch endpoint), zone z2 a single one (PUT).
+    EXPECT_CALL(http, exchange(::testing::HasSubstr("/zones/z1/dns_records/batch"), _))
+        .WillOnce(Return(HttpResponse{.status_code = 200, .body = std::string(BATCH_SUCCESS)}));
+    EXPECT_CALL(http, exchange(::testing::HasSubstr("/zones/z2/dns_records/r3"), _))
+        .WillOnce(Return(HttpResponse{.status_code = 200,
+                                      .body = make_success_response("A", "c", "1.2.3.4", 30, false)}));
+
+    const std::vector items{make_batch_item("z1", "r1", "a"), make_batch_item("z2", "r3", "c"),
+                            make_batch_item("z1", "r2", "b")};
+    const auto results = driver.execute_batch(items, http);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[1]);
+    EXPECT_TRUE(results[2]);
+}
@@ -14,13 +14,18 @@
 //   - check_response() returns false for non-200 status.
 //   - check_response() returns false for malformed XML.
 //   - check_response() returns false for empty body.
+//   - execute_batch() puts all records of a hosted zone into one ChangeBatch.
 // =============================================================================
 
+#include <vector>
+
+#include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include "route53.h"
 #include "config.hpp"
 #include "factory_test_helpers.h"
+#include "mocks/mock_http_client.h"
 
 namespace {
 
@@ -51,6 +56,25 @@ std::string make_error_xml(std::string_view code, std::string_view message) {
 </ErrorResponse>)", code, message);
 }
 
+/// Build a batch item for hosted zone @p zone_id.
+DriverBatchItem make_batch_item(std::string_view zone_id, std::string_view sub, std::string_view ip) {
+    return {
+        .config = fmt::format(R"({{"access_key_id":"AKID","secret_access_key":"secret","hosted_zone_id":"{}",)"
+                              R"("region":"us-east-1","record_name":"{}"}})", zone_id, sub),
+        .ctx = {.ip_addr = std::string(ip), .rd_type = "A", .domain = "example.com",
+                .subdomain = std::string(sub), .fqdn = fmt::format("{}.example.com", sub)},
+    };
+}
+
+/// Count non-overlapping occurrences of @p needle in @p haystack.
+std::size_t count_of(std::string_view haystack, std::string_view needle) {
+    std::size_t count = 0;
+    for (auto pos = haystack.find(needle); pos != std::string_view::npos; pos = haystack.find(needle, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
 } // anonymous namespace
 
 TEST(Route53DriverTest, GetDetail_ReturnsExpectedMetadata) {
@@ -265,3 +289,55 @@ TEST(Route53DriverTest, FactoryCreateDestroy) { test_factory_create_destroy(); }
 TEST(Route53DriverTest, FactoryMagic) { test_factory_magic(); }
 TEST(Route53DriverTest, FactoryBuildId) { test_factory_build_id(); }
 TEST(Route53DriverTest, FactoryCompilerIdHash) { test_factory_compiler_id_hash(); }
+
+// ── Batch updates ──────────────────────────────────────────────────────────
+
+TEST(Route53DriverTest, ExecuteBatch_SameZone_SendsSingleChangeBatch) {
+    using ::testing::_;
+
+    Route53Driver driver;
+    MockHttpClient http;
+
+    std::string captured_body;
+    EXPECT_CALL(http, exchange(_, _))
+        .WillOnce([&](std::string_view url, const HttpRequest &req) -> HttpResult {
+            EXPECT_EQ(url, "https://route53.amazonaws.com/2013-04-01/hostedzone/Z1/rrset");
+            captured_body = req.body.value_or("");
+            return HttpResponse{.status_code = 200, .body = make_success_xml("PENDING")};
+        });
+
+    const std::vector items{make_batch_item("Z1", "a", "1.2.3.4"), make_batch_item("Z1", "b", "5.6.7.8"),
+                            make_batch_item("Z1", "c", "9.9.9.9")};
+    const auto results = driver.execute_batch(items, http);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_TRUE(results[1]);
+    EXPECT_TRUE(results[2]);
+    EXPECT_EQ(count_of(captured_body, "<Change>"), 3u);
+    EXPECT_EQ(count_of(captured_body, "<ChangeBatch>"), 1u);
+    EXPECT_NE(captured_body.find("a.example.com."), std::string::npos);
+    EXPECT_NE(captured_body.find("5.6.7.8"), std::string::npos);
+}
+
+TEST(Route53DriverTest, ExecuteBatch_DifferentZones_OneRequestPerZone) {
+    using ::testing::_;
+    using ::testing::HasSubstr;
+    using ::testing::Return;
+
+    Route53Driver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange(HasSubstr("/hostedzone/Z1/"), _))
+        .WillOnce(Return(HttpResponse{.status_code = 200, .body = make_success_xml("PENDING")}));
+    EXPECT_CALL(http, exchange(HasSubstr("/hostedzone/Z2/"), _))
+        .WillOnce(Return(HttpResponse{.status_code = 400, .body = make_error_xml("InvalidChangeBatch", "bad")}));
+
+    const std::vector items{make_batch_item("Z1", "a", "1.2.3.4"), make_batch_item("Z2", "b", "5.6.7.8"),
+                            make_batch_item("Z1", "c", "9.9.9.9")};
+    const auto results = driver.execute_batch(items, http);
+
+    ASSERT_EQ(results.size(), 3u);
+    EXPECT_TRUE(results[0]);
+    EXPECT_FALSE(results[1]);
+    EXPECT_TRUE(results[2]);
+}
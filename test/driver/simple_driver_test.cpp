@@ -5,6 +5,7 @@
 //   - get_detail() returns expected metadata.
 //   - generate_request() substitutes URL template variables correctly.
 //   - generate_request() with missing config throws ParamParseException.
+//   - prepare() rejects a missing or unparsable "url" at startup.
 //   - check_response() accepts 2xx with non-empty body.
 //   - check_response() rejects 3xx/4xx/5xx status codes.
 //   - check_response() rejects empty body.
@@ -128,6 +129,28 @@ TEST(SimpleDriverTest, GenerateRequest_EmptyConfig_ThrowsParamParseException) {
     EXPECT_THROW({ driver.generate_request(config, ctx); }, ParamParseException);
 }
 
+TEST(SimpleDriverTest, Prepare_MissingUrl_ThrowsParamParseException) {
+    SimpleDriver driver;
+    EXPECT_THROW({ [[maybe_unused]] auto _ = driver.prepare(R"({"not_url": "value"})"); }, ParamParseException);
+    EXPECT_THROW({ [[maybe_unused]] auto _ = driver.prepare(R"({"url": 42})"); }, ParamParseException);
+}
+
+TEST(SimpleDriverTest, Prepare_UnparsableUrl_ThrowsParamParseException) {
+    SimpleDriver driver;
+    // No host.
+    EXPECT_THROW({ [[maybe_unused]] auto _ = driver.prepare(R"({"url": "/update?ip={ip_addr}"})"); },
+                 ParamParseException);
+    // Unclosed IPv6 literal.
+    EXPECT_THROW({ [[maybe_unused]] auto _ = driver.prepare(R"({"url": "https://[::1/update"})"); },
+                 ParamParseException);
+}
+
+TEST(SimpleDriverTest, Prepare_ValidUrl_ReturnsHandle) {
+    SimpleDriver driver;
+    const auto handle = driver.prepare(R"({"url": "https://{subdomain}.dns.example.com/update?ip={ip_addr}"})");
+    EXPECT_NE(handle, nullptr);
+}
+
 TEST(SimpleDriverTest, CheckResponse_2xxWithBody_ReturnsTrue) {
     SimpleDriver driver;
     HttpResponse resp{200, "update successful", {}};
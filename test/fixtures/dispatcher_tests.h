@@ -3,7 +3,7 @@
 //
 // This header is included by two translation units that compile against
 // different DNS backends:
-//   - test/unit/dispatcher.cpp        (YADDNSC_USE_NATIVE_DNS=1, jthread-based, default)
+//   - test/unit/dispatcher.cpp        (YADDNSC_USE_NATIVE_DNS=1, ResolverEngine-based, default)
 //   - test/unit/dispatcher_system.cpp (libresolv-based legacy backend, DEPRECATED)
 //
 // The two backends share identical dispatch *logic* but diverge in how they
@@ -38,7 +38,9 @@
 #include "dns_error.h"
 #include "exception/dns_lookup.h"
 #include "mocks/mock_resolver.h"
+#include "network/inet_address.h"
 #include "record_kind.h"
+#include "util/task.hpp"
 
 #if YADDNSC_USE_NATIVE_DNS
 #  define YADDNSC_NATIVE_DISPATCHER 1
@@ -217,6 +219,19 @@ std::vector<std::uint8_t> make_multi_a_response(std::uint16_t txid) {
     return buf;
 }
 
+// A response whose answer is a CNAME to "cdn.example.net", then that name's
+// A record (192.168.1.1).
+std::vector<std::uint8_t> make_cname_a_response(std::uint16_t txid) {
+    auto buf = make_header_response(txid, 0x80, 2);
+    buf.insert(buf.end(), {0xC0, 0x0C, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x2C, 0x00, 0x00});
+    const auto target = buf.size();
+    const auto target_len = encode_name(buf, "cdn.example.net");
+    write_u16_be(buf, target - 2, static_cast<std::uint16_t>(target_len));
+    buf.insert(buf.end(), {0xC0, static_cast<std::uint8_t>(target), 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x2C,
+                           0x00, 0x04, 192, 168, 1, 1});
+    return buf;
+}
+
 // Truncated packet — both parsers must reject it (PARSE).
 std::vector<std::uint8_t> make_malformed_response() {
     return std::vector<std::uint8_t>{0x12, 0x34, 0x81, 0x80, 0x00, 0x01};
@@ -737,4 +752,113 @@ TEST(Dispatcher, MoveConstructible) {
     EXPECT_EQ((*result)[0], "192.168.1.1");
 }
 
+// =============================================================================
+//  resolve_async
+// =============================================================================
+
+TEST(DispatcherAsync, ResolveAsyncMatchesResolve) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(ok_a()));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto task = disp.resolve_async("example.com", RecordKind::A, 1, 1);
+    auto result = Utils::sync_wait(std::move(task));
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 1U);
+    EXPECT_EQ((*result)[0], "192.168.1.1");
+}
+
+// Many lookups in flight on one dispatcher at once.
+TEST(DispatcherAsync, OverlappingLookupsAllComplete) {
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    for (int i = 0; i < 3; ++i) {
+        auto r = make_mock();
+        ON_CALL(*r, query(_, _, _)).WillByDefault(Return(ok_a()));
+        resolvers.push_back(std::move(r));
+    }
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    std::vector<Utils::Task<std::expected<std::vector<std::string>, DnsErrorInfo>>> lookups;
+    for (int i = 0; i < 32; ++i) {
+        lookups.push_back(disp.resolve_async("example.com", RecordKind::A, 1, 1));
+    }
+    for (const auto &result: Utils::sync_wait(Utils::when_all(std::move(lookups)))) {
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ((*result)[0], "192.168.1.1");
+    }
+}
+
+// =============================================================================
+//  resolve_addresses
+// =============================================================================
+
+TEST(DispatcherAddresses, A_ReturnsIpv4Address) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(ok_a()));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto result = disp.resolve_addresses("example.com", RecordKind::A, 5, 1);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 1U);
+    EXPECT_EQ((*result)[0], InetAddress(Inet4Address::from_bytes({192, 168, 1, 1})));
+}
+
+TEST(DispatcherAddresses, Aaaa_ComparesEqualToAnyTextualForm) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(ok_aaaa()));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto result = disp.resolve_addresses("example.com", RecordKind::AAAA, 5, 1);
+    ASSERT_TRUE(result.has_value());
+    ASSERT_EQ(result->size(), 1U);
+    EXPECT_EQ((*result)[0], InetAddress::parse("2001:0DB8:0:0::0001"));
+}
+
+TEST(DispatcherAddresses, MultipleRecords_ReturnsAllInOrder) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(make_multi_a_response(0x1234)));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto result = disp.resolve_addresses("example.com", RecordKind::A, 5, 1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, (AddressList{Inet4Address::from_bytes({192, 168, 1, 1}),
+                                    Inet4Address::from_bytes({192, 168, 1, 2})}));
+}
+
+TEST(DispatcherAddresses, Cname_IsLeftOut) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(make_cname_a_response(0x1234)));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto records = disp.resolve("example.com", RecordKind::A, 5, 1);
+    ASSERT_TRUE(records.has_value());
+    EXPECT_EQ(*records, (std::vector<std::string>{"cdn.example.net", "192.168.1.1"}));
+
+    auto result = disp.resolve_addresses("example.com", RecordKind::A, 5, 1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, AddressList{Inet4Address::from_bytes({192, 168, 1, 1})});
+}
+
+TEST(DispatcherAddresses, AsyncMatchesSync) {
+    auto r = make_mock();
+    ON_CALL(*r, query(_, _, _)).WillByDefault(Return(ok_a()));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
+
+    auto result = Utils::sync_wait(disp.resolve_addresses_async("example.com", RecordKind::A, 1, 1));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, disp.resolve_addresses("example.com", RecordKind::A, 1, 1).value());
+}
+
 #endif // YADDNSC_TEST_FIXTURES_DISPATCHER_TESTS_H
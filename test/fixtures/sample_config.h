@@ -35,9 +35,10 @@ inline constexpr std::string_view FULL_CONFIG = R"({
         "use_custom_server": true,
         "servers": [
             {"address": "1.1.1.1", "port": 53},
-            {"address": "8.8.8.8", "port": 53}
+            {"address": "8.8.8.8", "port": 53, "transport": "tcp"}
         ],
-        "strategy": "fallback"
+        "strategy": "fallback",
+        "cache": true
     },
     "domains": [
         {
@@ -53,6 +54,54 @@ inline constexpr std::string_view FULL_CONFIG = R"({
     ]
 })";
 
+// ── Config with scheduler load-spreading settings ───────────────────────────
+
+inline constexpr std::string_view SCHEDULER_CONFIG = R"({
+    "driver": { "auto_discover": true },
+    "resolver": { "use_custom_server": false },
+    "scheduler": {
+        "startup_spread": 120,
+        "jitter": 10,
+        "max_dispatch_rate": 4
+    },
+    "domains": []
+})";
+
+// ── Config with a persistent runtime state file ─────────────────────────────
+
+inline constexpr std::string_view STATE_FILE_CONFIG = R"({
+    "driver": { "auto_discover": true },
+    "resolver": { "use_custom_server": false },
+    "state_file": "/var/lib/yaddnsc/state",
+    "domains": []
+})";
+
+// ── Config with the hedged resolver strategy ─────────────────────────────────
+
+inline constexpr std::string_view HEDGED_STRATEGY_CONFIG = R"({
+    "driver": { "auto_discover": true },
+    "resolver": { "use_custom_server": true, "strategy": "hedged" },
+    "domains": []
+})";
+
+// ── Config with a published-state verification interval ─────────────────────
+
+inline constexpr std::string_view VERIFY_INTERVAL_CONFIG = R"({
+    "driver": { "auto_discover": true },
+    "resolver": { "use_custom_server": false },
+    "domains": [
+        {
+            "name": "example.com",
+            "update_interval": 60,
+            "verify_interval": 3600,
+            "driver": "simple",
+            "subdomains": [
+                {"name": "@", "type": "a", "ip_source": "http", "ip_source_param": "https://api.ipify.org"}
+            ]
+        }
+    ]
+})";
+
 // ── Config with mDNS IP source ───────────────────────────────────────────────
 
 inline constexpr std::string_view MDNS_CONFIG = R"({
@@ -9,7 +9,11 @@
 #ifndef YADDNSC_TEST_MOCKS_MOCK_DRIVER_H
 #define YADDNSC_TEST_MOCKS_MOCK_DRIVER_H
 
+#include <memory>
+#include <span>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include <gmock/gmock.h>
 
@@ -38,6 +42,44 @@ public:
         }
         return check_response(*response);
     }
+
+    // Default execute_batch models BaseDriver's fallback: one execute() per item.
+    std::vector<bool> execute_batch(std::span<const DriverBatchItem> items, HttpClient& http) const override {
+        std::vector<bool> results;
+        results.reserve(items.size());
+        for (const auto& [config, ctx] : items) {
+            results.push_back(execute(config, ctx, http));
+        }
+        return results;
+    }
+
+    // Default prepare / execute_prepared / execute_batch_prepared model
+    // BaseDriver's fallback: the handle keeps the raw JSON, which is passed
+    // to execute() / execute_batch() above.
+    DriverHandlePtr prepare(const DriverConfig& config) const override {
+        return std::make_shared<const RawConfig>(config);
+    }
+
+    bool execute_prepared(const DriverHandle& handle, const DriverUpdateParams& ctx, HttpClient& http) const override {
+        return execute(static_cast<const RawConfig&>(handle).config, ctx, http);
+    }
+
+    std::vector<bool> execute_batch_prepared(std::span<const DriverPreparedItem> items,
+                                             HttpClient& http) const override {
+        std::vector<DriverBatchItem> raw;
+        raw.reserve(items.size());
+        for (const auto& [handle, ctx] : items) {
+            raw.push_back(DriverBatchItem{static_cast<const RawConfig&>(handle).config, ctx});
+        }
+        return execute_batch(raw, http);
+    }
+
+private:
+    struct RawConfig final : DriverHandle {
+        explicit RawConfig(DriverConfig value) : config(std::move(value)) {}
+
+        const DriverConfig config;
+    };
 };
 
 // ── Helper: create a DriverDetail with the given name ─────────────────────────
@@ -34,6 +34,11 @@ class MockTlsConnection : public TlsConnectionBase {
 public:
     using IoStatus = TlsConnectionBase::IoStatus;
 
+    /// No pollable socket by default: readers go straight to read_exact().
+    MockTlsConnection() {
+        ON_CALL(*this, native_fd()).WillByDefault(testing::Return(-1));
+    }
+
     // ── EXPECT_CALL mode ──
     // NOTE: Return types with commas must be wrapped in extra parentheses.
 
@@ -41,6 +46,8 @@ public:
     MOCK_METHOD(void, close, (), (noexcept, override));
     MOCK_METHOD(bool, is_connected, (), (const, noexcept, override));
     MOCK_METHOD(bool, is_healthy, (), (const, noexcept, override));
+    MOCK_METHOD(int, native_fd, (), (const, noexcept, override));
+    MOCK_METHOD(bool, has_pending, (), (const, noexcept, override));
 
     MOCK_METHOD((std::expected<void, IoStatus>), send_all,
                 (std::span<const std::uint8_t> data,
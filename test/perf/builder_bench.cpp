@@ -1,16 +1,25 @@
 //
-// Benchmarks for DNS wire-format QueryBuilder.
+// Benchmarks for DNS wire-format QueryBuilder and QueryTemplate, and the
+// Utils::ByteScan kernels that name encoding and validation run on.
 // =============================================================================
 
 #include <benchmark/benchmark.h>
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <string>
+#include <span>
 #include <string_view>
 #include <vector>
 
 #include "dns/types.h"
 #include "dns/wire/builder.h"
+#include "dns/wire/name.h"
+#include "dns/wire/query_template.h"
+#include "dns/wire/query_util.h"
+#include "util/byte_scan.hpp"
+#include "util/validation.hpp"
 
 // =============================================================================
 // QueryBuilder — simple single-question query
@@ -90,3 +99,211 @@ static void BM_QueryBuilderFullConfig(benchmark::State &state) {
     }
 }
 BENCHMARK(BM_QueryBuilderFullConfig);
+
+// =============================================================================
+// QueryBuilder::build_into — stack buffer, behind a TCP length prefix
+// =============================================================================
+
+static void BM_QueryBuilderBuildIntoFramed(benchmark::State &state) {
+    std::array<std::uint8_t, 512> buf{};
+    for (auto _ : state) {
+        auto framed = DNS::QueryBuilder{}
+            .add_question("www.example.com", DNS::RecordType::A)
+            .add_edns(1232)
+            .build_into(buf, DNS::Framing::LENGTH_PREFIXED);
+        benchmark::DoNotOptimize(framed);
+    }
+}
+BENCHMARK(BM_QueryBuilderBuildIntoFramed);
+
+// =============================================================================
+// encode_name — runtime name vs. a literal encoded at compile time
+// =============================================================================
+
+static void BM_EncodeNameRuntime(benchmark::State &state) {
+    const std::string name = "www.example.com";
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (auto _ : state) {
+        auto size = DNS::encode_name(name, buf);
+        benchmark::DoNotOptimize(size);
+        benchmark::DoNotOptimize(buf);
+    }
+}
+BENCHMARK(BM_EncodeNameRuntime);
+
+static void BM_EncodeNameLiteral(benchmark::State &state) {
+    static constexpr auto name = DNS::encode_name_literal("www.example.com");
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (auto _ : state) {
+        std::ranges::copy(name.bytes(), buf.begin());
+        benchmark::DoNotOptimize(buf);
+    }
+}
+BENCHMARK(BM_EncodeNameLiteral);
+
+// =============================================================================
+// encode_name — a long CDN-style name, dots found a block at a time
+// =============================================================================
+
+namespace {
+    constexpr std::string_view LONG_NAME =
+        "edge-0-a-very-long-geographic-region-label-prod.customer-assets-distribution."
+        "cdn-provider-network.a-very-long-subdomain-name.that-exceeds-the-typical-length."
+        "example-with-many-labels.example.net";
+
+    /// Label-at-a-time encoding with a byte-by-byte search for each dot, as
+    /// encode_name() did before it used Utils::ByteScan; for comparison.
+    std::size_t encode_name_bytewise(std::string_view name, std::span<std::uint8_t> out) {
+        std::size_t written = 0;
+        std::size_t pos = 0;
+        while (pos < name.size()) {
+            auto dot = name.find('.', pos);
+            if (dot == std::string_view::npos) {
+                dot = name.size();
+            }
+            out[written++] = static_cast<std::uint8_t>(dot - pos);
+            for (auto i = pos; i < dot; ++i) {
+                out[written++] = static_cast<std::uint8_t>(name[i]);
+            }
+            pos = dot + 1;
+        }
+        out[written++] = 0;
+        return written;
+    }
+} // anonymous namespace
+
+static void BM_EncodeNameLong(benchmark::State &state) {
+    const std::string name(LONG_NAME);
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (auto _ : state) {
+        auto size = DNS::encode_name(name, buf);
+        benchmark::DoNotOptimize(size);
+        benchmark::DoNotOptimize(buf);
+    }
+}
+BENCHMARK(BM_EncodeNameLong);
+
+static void BM_EncodeNameLongBytewise(benchmark::State &state) {
+    const std::string name(LONG_NAME);
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (auto _ : state) {
+        auto size = encode_name_bytewise(name, buf);
+        benchmark::DoNotOptimize(size);
+        benchmark::DoNotOptimize(buf);
+    }
+}
+BENCHMARK(BM_EncodeNameLongBytewise);
+
+// =============================================================================
+// Utils::ByteScan — scalar vs. the dispatched (SIMD) kernels on a long name
+// =============================================================================
+
+static void BM_ByteScanFindDotsScalar(benchmark::State &state) {
+    std::array<std::uint16_t, DNS::MAX_NAME_SIZE> dots{};
+    for (auto _ : state) {
+        auto count = Utils::ByteScan::Scalar::find_all(LONG_NAME, '.', dots);
+        benchmark::DoNotOptimize(count);
+        benchmark::DoNotOptimize(dots);
+    }
+}
+BENCHMARK(BM_ByteScanFindDotsScalar);
+
+static void BM_ByteScanFindDots(benchmark::State &state) {
+    std::array<std::uint16_t, DNS::MAX_NAME_SIZE> dots{};
+    for (auto _ : state) {
+        auto count = Utils::ByteScan::find_all(LONG_NAME, '.', dots);
+        benchmark::DoNotOptimize(count);
+        benchmark::DoNotOptimize(dots);
+    }
+}
+BENCHMARK(BM_ByteScanFindDots);
+
+static void BM_ByteScanIequalsScalar(benchmark::State &state) {
+    const std::string upper = [] {
+        std::string s(LONG_NAME);
+        std::ranges::transform(s, s.begin(), [](char c) { return c >= 'a' && c <= 'z' ? c - 0x20 : c; });
+        return s;
+    }();
+    for (auto _ : state) {
+        auto equal = Utils::ByteScan::Scalar::iequals(LONG_NAME, upper);
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_ByteScanIequalsScalar);
+
+static void BM_ByteScanIequals(benchmark::State &state) {
+    const std::string upper = [] {
+        std::string s(LONG_NAME);
+        std::ranges::transform(s, s.begin(), [](char c) { return c >= 'a' && c <= 'z' ? c - 0x20 : c; });
+        return s;
+    }();
+    for (auto _ : state) {
+        auto equal = Utils::ByteScan::iequals(LONG_NAME, upper);
+        benchmark::DoNotOptimize(equal);
+    }
+}
+BENCHMARK(BM_ByteScanIequals);
+
+static void BM_IsValidDomainLong(benchmark::State &state) {
+    for (auto _ : state) {
+        auto valid = Utils::is_valid_domain(LONG_NAME);
+        benchmark::DoNotOptimize(valid);
+    }
+}
+BENCHMARK(BM_IsValidDomainLong);
+
+// =============================================================================
+// build_query — the per-lookup query the resolvers used to build
+// =============================================================================
+
+static void BM_BuildQuery(benchmark::State &state) {
+    for (auto _ : state) {
+        auto packet = DNS::build_query("www.example.com", DNS::RecordType::A);
+        benchmark::DoNotOptimize(packet);
+    }
+}
+BENCHMARK(BM_BuildQuery);
+
+// =============================================================================
+// QueryTemplate — same query, stamped into a stack buffer
+// =============================================================================
+
+static void BM_QueryTemplateWrite(benchmark::State &state) {
+    const DNS::QueryTemplate tmpl("www.example.com", DNS::RecordType::A);
+    std::array<std::uint8_t, 512> buf{};
+    std::uint16_t id = 0;
+    for (auto _ : state) {
+        auto packet = tmpl.write_to(buf, ++id);
+        benchmark::DoNotOptimize(packet);
+    }
+}
+BENCHMARK(BM_QueryTemplateWrite);
+
+// =============================================================================
+// QueryTemplate — padded to 128 octets (DoT), random padding per query
+// =============================================================================
+
+static void BM_QueryTemplateWritePadded(benchmark::State &state) {
+    const DNS::QueryTemplate tmpl("www.example.com", DNS::RecordType::A, {.udp_payload_size = 512, .pad_block = 128});
+    std::array<std::uint8_t, 512> buf{};
+    std::uint16_t id = 0;
+    for (auto _ : state) {
+        auto packet = tmpl.write_to(buf, ++id);
+        benchmark::DoNotOptimize(packet);
+    }
+}
+BENCHMARK(BM_QueryTemplateWritePadded);
+
+// =============================================================================
+// QueryTemplateCache — lookup plus build(), as a resolver does per query
+// =============================================================================
+
+static void BM_QueryTemplateCacheBuild(benchmark::State &state) {
+    DNS::QueryTemplateCache cache;
+    const std::string host = "www.example.com";
+    for (auto _ : state) {
+        auto packet = cache.get(host, DNS::RecordType::A)->build();
+        benchmark::DoNotOptimize(packet);
+    }
+}
+BENCHMARK(BM_QueryTemplateCacheBuild);
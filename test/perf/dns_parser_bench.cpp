@@ -2,20 +2,92 @@
 // Benchmarks for DNS response packet parsing (native parser).
 //
 // Constructs wire-format DNS response packets for common record types
-// (A, AAAA, TXT, CNAME) and measures the throughput of RecordParser.
+// (A, AAAA, TXT, CNAME, and long CDN-style CNAME chains) and measures the
+// throughput of RecordParser and, with the native backend, of the zero-copy
+// MessageView.  Every benchmark also reports heap allocations per iteration
+// ("allocs").
 // =============================================================================
 
 #include <benchmark/benchmark.h>
 
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <new>
 #include <span>
 #include <string>
 #include <vector>
 
 #include "dns/parser/parser.h"
 
+#if YADDNSC_USE_NATIVE_DNS
+#  include "dns/parser/message_view.h"
+#endif
+
+// =============================================================================
+// Allocation counting — replaces the global operator new for this binary
+// =============================================================================
+namespace {
+    std::atomic<std::size_t> allocations{0};
+
+    /// Counts the allocations made while it is alive and reports them per
+    /// iteration when it goes out of scope (after the benchmark loop).
+    class AllocationCounter {
+    public:
+        explicit AllocationCounter(benchmark::State &state) : state_(state), start_(allocations.load()) {
+        }
+
+        ~AllocationCounter() {
+            state_.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations.load() - start_),
+                                                           benchmark::Counter::kAvgIterations);
+        }
+
+        AllocationCounter(const AllocationCounter &) = delete;
+
+        AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+    private:
+        benchmark::State &state_;
+        std::size_t start_;
+    };
+} // anonymous namespace
+
+// GCC pairs the malloc() in the replacement operator new with the free() in
+// operator delete once both are inlined, and warns that they are mismatched.
+#if defined(__GNUC__) && !defined(__clang__)
+#  pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void *operator new(std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    ::operator delete(ptr);
+}
+
 // =============================================================================
 // Helpers — minimal DNS wire-format construction
 // =============================================================================
@@ -146,6 +218,52 @@ std::vector<std::uint8_t> make_cname_response(std::string_view qname, std::strin
     return buf;
 }
 
+/// Names along a CDN-style CNAME chain from @p qname: each target is well
+/// over 32 bytes, with labels long enough to fill whole SIMD blocks.
+std::vector<std::string> cname_chain_names(std::string_view qname, int hops) {
+    std::vector<std::string> names{std::string(qname)};
+    for (int i = 0; i < hops; ++i) {
+        names.push_back("edge-" + std::to_string(i) + "-a-very-long-geographic-region-label-prod."
+                        "customer-assets-distribution.cdn-provider-network.example.net");
+    }
+    return names;
+}
+
+/// Response with a chain of @p hops CNAMEs from @p qname, then an A record.
+/// Each owner name is a pointer to the previous target, as servers send them.
+std::vector<std::uint8_t> make_cname_chain_response(std::string_view qname, int hops) {
+    const auto names = cname_chain_names(qname, hops);
+
+    std::vector<std::uint8_t> buf;
+    buf.push_back(0x12); buf.push_back(0x34);
+    buf.push_back(0x80); buf.push_back(0x80);
+    write_u16_be(buf, 1); write_u16_be(buf, static_cast<std::uint16_t>(hops + 1));
+    write_u16_be(buf, 0); write_u16_be(buf, 0);
+
+    encode_name(buf, qname);
+    write_u16_be(buf, 1);  // QTYPE A
+    write_u16_be(buf, 1);
+
+    size_t owner_offset = 12;  // the question name
+    for (int i = 0; i <= hops; ++i) {
+        buf.push_back(static_cast<std::uint8_t>(0xC0 | (owner_offset >> 8)));
+        buf.push_back(static_cast<std::uint8_t>(owner_offset & 0xff));
+        write_u16_be(buf, i < hops ? 5 : 1);  // TYPE CNAME, then A
+        write_u16_be(buf, 1);
+        write_u16_be(buf, 0); write_u16_be(buf, 300);
+
+        if (i == hops) {
+            write_u16_be(buf, 4);
+            buf.push_back(192); buf.push_back(168); buf.push_back(1); buf.push_back(1);
+            break;
+        }
+        write_u16_be(buf, static_cast<std::uint16_t>(names[i + 1].size() + 2));  // RDLENGTH
+        owner_offset = buf.size();
+        encode_name(buf, names[i + 1]);
+    }
+    return buf;
+}
+
 }  // anonymous namespace
 
 // =============================================================================
@@ -154,6 +272,7 @@ std::vector<std::uint8_t> make_cname_response(std::string_view qname, std::strin
 
 static void BM_DnsParseA(benchmark::State &state) {
     auto response = make_a_response("example.com");
+    const AllocationCounter counter(state);
     for (auto _ : state) {
         auto parsed = DNS::RecordParser::parse_strings(response);
         benchmark::DoNotOptimize(parsed);
@@ -163,6 +282,7 @@ BENCHMARK(BM_DnsParseA);
 
 static void BM_DnsParseAAAA(benchmark::State &state) {
     auto response = make_aaaa_response("example.com");
+    const AllocationCounter counter(state);
     for (auto _ : state) {
         auto parsed = DNS::RecordParser::parse_strings(response);
         benchmark::DoNotOptimize(parsed);
@@ -172,6 +292,7 @@ BENCHMARK(BM_DnsParseAAAA);
 
 static void BM_DnsParseTXT(benchmark::State &state) {
     auto response = make_txt_response("example.com", "v=spf1 include:_spf.example.com ~all");
+    const AllocationCounter counter(state);
     for (auto _ : state) {
         auto parsed = DNS::RecordParser::parse_strings(response);
         benchmark::DoNotOptimize(parsed);
@@ -181,6 +302,7 @@ BENCHMARK(BM_DnsParseTXT);
 
 static void BM_DnsParseCNAME(benchmark::State &state) {
     auto response = make_cname_response("www.example.com", "www-behind-cdn.example.com");
+    const AllocationCounter counter(state);
     for (auto _ : state) {
         auto parsed = DNS::RecordParser::parse_strings(response);
         benchmark::DoNotOptimize(parsed);
@@ -188,9 +310,22 @@ static void BM_DnsParseCNAME(benchmark::State &state) {
 }
 BENCHMARK(BM_DnsParseCNAME);
 
+static void BM_DnsParseCNAMEChain(benchmark::State &state) {
+    // Every target is decompressed into a string: long names, many labels.
+    auto response = make_cname_chain_response("www.example.com", static_cast<int>(state.range(0)));
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        auto parsed = DNS::RecordParser::parse_strings(response);
+        benchmark::DoNotOptimize(parsed);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * response.size()));
+}
+BENCHMARK(BM_DnsParseCNAMEChain)->Arg(4)->Arg(16);
+
 static void BM_DnsParseMultiQuestion(benchmark::State &state) {
     // Build a response with 1 answer record from a single-question query.
     auto response = make_a_response("example.com");
+    const AllocationCounter counter(state);
     for (auto _ : state) {
         DNS::RecordParser parser(response);
         auto count = parser.record_count();
@@ -200,3 +335,91 @@ static void BM_DnsParseMultiQuestion(benchmark::State &state) {
 BENCHMARK(BM_DnsParseMultiQuestion);
 
 
+
+// =============================================================================
+// MessageView — zero-copy, allocation-free (native backend only)
+// =============================================================================
+
+#if YADDNSC_USE_NATIVE_DNS
+
+static void BM_DnsViewA(benchmark::State &state) {
+    auto response = make_a_response("example.com");
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        auto rdata = view.answers()[0].rdata;
+        benchmark::DoNotOptimize(rdata);
+    }
+}
+BENCHMARK(BM_DnsViewA);
+
+static void BM_DnsViewAAAA(benchmark::State &state) {
+    auto response = make_aaaa_response("example.com");
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        auto rdata = view.answers()[0].rdata;
+        benchmark::DoNotOptimize(rdata);
+    }
+}
+BENCHMARK(BM_DnsViewAAAA);
+
+static void BM_DnsViewNameEquals(benchmark::State &state) {
+    // Matching the owner name against the query follows its pointer in place.
+    auto response = make_a_response("example.com");
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        auto matched = view.answers()[0].name.equals("example.com");
+        benchmark::DoNotOptimize(matched);
+    }
+}
+BENCHMARK(BM_DnsViewNameEquals);
+
+static void BM_DnsViewCNAME(benchmark::State &state) {
+    // Decompressing the target on request is the one step that allocates.
+    auto response = make_cname_response("www.example.com", "www-behind-cdn.example.com");
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        auto target = DNS::NameView(response, view.answers()[0].rdata_offset).to_string();
+        benchmark::DoNotOptimize(target);
+    }
+}
+BENCHMARK(BM_DnsViewCNAME);
+
+static void BM_DnsViewCNAMEChainEquals(benchmark::State &state) {
+    // Following the chain: each owner name is matched against the previous
+    // target, in place, long labels a block at a time.
+    const auto hops = static_cast<int>(state.range(0));
+    auto response = make_cname_chain_response("www.example.com", hops);
+    const auto names = cname_chain_names("WWW.Example.COM", hops);
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        size_t matched = 0;
+        for (size_t i = 0; i < view.answers().size(); ++i) {
+            matched += view.answers()[i].name.equals(names[i]) ? 1 : 0;
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+}
+BENCHMARK(BM_DnsViewCNAMEChainEquals)->Arg(4)->Arg(16);
+
+static void BM_DnsViewCNAMEChainToString(benchmark::State &state) {
+    // Decompressing every target: one allocation each, at its final size.
+    auto response = make_cname_chain_response("www.example.com", static_cast<int>(state.range(0)));
+    const AllocationCounter counter(state);
+    for (auto _ : state) {
+        const DNS::MessageView view(response);
+        for (const auto &answer: view.answers()) {
+            if (answer.type == 5) {
+                auto target = DNS::NameView(response, answer.rdata_offset).to_string();
+                benchmark::DoNotOptimize(target);
+            }
+        }
+    }
+}
+BENCHMARK(BM_DnsViewCNAMEChainToString)->Arg(4)->Arg(16);
+
+#endif
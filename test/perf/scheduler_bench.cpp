@@ -0,0 +1,95 @@
+//
+// Benchmarks for the Scheduler timer queue: idle ticks and ticks where every
+// task is due, across a range of task counts.
+// =============================================================================
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <stop_token>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "config/config.h"
+#include "core/scheduler.h"
+#include "core/update_task.h"
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+constexpr int SUBDOMAINS_PER_DOMAIN = 8;
+
+// Build an AppConfig with `tasks` subdomains spread over domains of
+// SUBDOMAINS_PER_DOMAIN each, all sharing the given update interval.
+[[nodiscard]] Config::AppConfig make_config(std::int64_t tasks, int update_interval) {
+    Config::AppConfig cfg{};
+    for (std::int64_t i = 0; i < tasks; ++i) {
+        if (i % SUBDOMAINS_PER_DOMAIN == 0) {
+            cfg.domains.push_back(Config::DomainConfig{
+                .name = "example" + std::to_string(i / SUBDOMAINS_PER_DOMAIN) + ".com",
+                .update_interval = update_interval,
+                .force_update = 3600,
+                .driver = "cloudflare",
+                .subdomains = {},
+            });
+        }
+        Config::SubdomainConfig subdomain{};
+        subdomain.name = "host" + std::to_string(i);
+        subdomain.ip_source_param = "https://api.ipify.org";
+        cfg.domains.back().subdomains.push_back(std::move(subdomain));
+    }
+    return cfg;
+}
+
+} // namespace
+
+// =============================================================================
+// Idle tick — nothing is due, the heap top is inspected and the call returns
+// =============================================================================
+
+static void BM_SchedulerIdleTick(benchmark::State &state) {
+    spdlog::set_level(spdlog::level::off);
+    std::stop_source stop;
+    Scheduler scheduler(make_config(state.range(0), 600), stop.get_token());
+
+    std::vector<DueTask> due;
+    scheduler.pop_all_due(due); // move every deadline into the future
+    for (auto _ : state) {
+        scheduler.pop_all_due(due);
+        benchmark::DoNotOptimize(due.data());
+    }
+}
+BENCHMARK(BM_SchedulerIdleTick)->RangeMultiplier(4)->Range(16, 4096);
+
+// =============================================================================
+// All-due tick — a zero interval makes every task due on every call
+// =============================================================================
+
+static void BM_SchedulerAllDueTick(benchmark::State &state) {
+    spdlog::set_level(spdlog::level::off);
+    std::stop_source stop;
+    Scheduler scheduler(make_config(state.range(0), 0), stop.get_token());
+
+    std::vector<DueTask> due;
+    for (auto _ : state) {
+        scheduler.pop_all_due(due);
+        benchmark::DoNotOptimize(due.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SchedulerAllDueTick)->RangeMultiplier(4)->Range(16, 4096);
+
+static void BM_SchedulerAllDueTickFreshVector(benchmark::State &state) {
+    spdlog::set_level(spdlog::level::off);
+    std::stop_source stop;
+    Scheduler scheduler(make_config(state.range(0), 0), stop.get_token());
+
+    for (auto _ : state) {
+        auto due = scheduler.pop_all_due();
+        benchmark::DoNotOptimize(due.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SchedulerAllDueTickFreshVector)->RangeMultiplier(4)->Range(16, 4096);
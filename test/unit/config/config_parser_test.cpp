@@ -83,9 +83,12 @@ TEST(ConfigParserTest, FullConfig_ParsesAllFields) {
     ASSERT_EQ(cfg.resolver.servers.size(), 2U);
     EXPECT_EQ(cfg.resolver.servers[0].address, "1.1.1.1");
     EXPECT_EQ(cfg.resolver.servers[0].port, 53);
+    EXPECT_EQ(cfg.resolver.servers[0].transport, Config::DnsTransport::UDP);
     EXPECT_EQ(cfg.resolver.servers[1].address, "8.8.8.8");
     EXPECT_EQ(cfg.resolver.servers[1].port, 53);
+    EXPECT_EQ(cfg.resolver.servers[1].transport, Config::DnsTransport::TCP);
     EXPECT_EQ(cfg.resolver.strategy, Config::ResolverStrategy::FALLBACK);
+    EXPECT_TRUE(cfg.resolver.cache);
 
     // Domains
     ASSERT_EQ(cfg.domains.size(), 1U);
@@ -125,6 +128,7 @@ TEST(ConfigParserTest, BackwardCompat_Keys_AreAccepted) {
     EXPECT_EQ(cfg.resolver.address, "9.9.9.9");
     EXPECT_EQ(cfg.resolver.port, 53);
     EXPECT_EQ(cfg.resolver.strategy, Config::ResolverStrategy::CONCURRENT);
+    EXPECT_FALSE(cfg.resolver.cache);
 
     // "url" alias for IP source = HTTP
     ASSERT_EQ(cfg.domains.size(), 1U);
@@ -199,6 +203,64 @@ TEST(ConfigParserTest, EmptyDomains_ParsesSuccessfully) {
     EXPECT_TRUE(cfg.domains.empty());
 }
 
+// ===========================================================================
+// Scheduler section
+// ===========================================================================
+
+TEST(ConfigParserTest, SchedulerConfig_ParsesAllFields) {
+    auto result = parse_config(Fixtures::SCHEDULER_CONFIG);
+    ASSERT_TRUE(result.ok);
+
+    const auto& scheduler = result.value.scheduler;
+    EXPECT_EQ(scheduler.startup_spread, 120);
+    EXPECT_EQ(scheduler.jitter, 10);
+    EXPECT_EQ(scheduler.max_dispatch_rate, 4);
+}
+
+TEST(ConfigParserTest, SchedulerConfig_DefaultsWhenOmitted) {
+    auto result = parse_config(Fixtures::MINIMAL_CONFIG);
+    ASSERT_TRUE(result.ok);
+
+    const auto& scheduler = result.value.scheduler;
+    EXPECT_EQ(scheduler.startup_spread, 0);
+    EXPECT_EQ(scheduler.jitter, 0);
+    EXPECT_EQ(scheduler.max_dispatch_rate, 0);
+}
+
+TEST(ConfigParserTest, StateFile_Parsed) {
+    auto result = parse_config(Fixtures::STATE_FILE_CONFIG);
+    ASSERT_TRUE(result.ok);
+    ASSERT_TRUE(result.value.state_file.has_value());
+    EXPECT_EQ(*result.value.state_file, "/var/lib/yaddnsc/state");
+}
+
+TEST(ConfigParserTest, StateFile_AbsentByDefault) {
+    auto result = parse_config(Fixtures::MINIMAL_CONFIG);
+    ASSERT_TRUE(result.ok);
+    EXPECT_FALSE(result.value.state_file.has_value());
+}
+
+TEST(ConfigParserTest, HedgedStrategy_Parsed) {
+    auto result = parse_config(Fixtures::HEDGED_STRATEGY_CONFIG);
+    ASSERT_TRUE(result.ok);
+    EXPECT_EQ(result.value.resolver.strategy, Config::ResolverStrategy::HEDGED);
+}
+
+TEST(ConfigParserTest, VerifyInterval_Parsed) {
+    auto result = parse_config(Fixtures::VERIFY_INTERVAL_CONFIG);
+    ASSERT_TRUE(result.ok);
+    ASSERT_EQ(result.value.domains.size(), 1u);
+    EXPECT_EQ(result.value.domains[0].verify_interval, 3600);
+}
+
+TEST(ConfigParserTest, VerifyInterval_DefaultsToZero) {
+    auto result = parse_config(Fixtures::MINIMAL_CONFIG);
+    ASSERT_TRUE(result.ok);
+    for (const auto& domain : result.value.domains) {
+        EXPECT_EQ(domain.verify_interval, 0);
+    }
+}
+
 // ===========================================================================
 // Error paths
 // ===========================================================================
@@ -8,6 +8,8 @@
 //       .local suffix, non-A/AAAA type).
 //   - detail::validate_resolver_address — DoH/DoT URIs, plain IPs,
 //       invalid addresses.
+//   - detail::validate_resolver_transport — TCP-only plain servers, and
+//       transports rejected on DoH/DoT servers.
 //   - ConfigValidator::validate — parameterized tests covering driver
 //       availability, update intervals, resolver addresses, and interface
 //       existence checks.
@@ -279,6 +281,27 @@ TEST(ConfigValidatorDetailTest, ValidateResolverAddress_DoHEmptyPort_Throws) {
     EXPECT_THROW(detail::validate_resolver_address("https://dns.example.com:0/dns-query"), ConfigVerificationException);
 }
 
+// ===========================================================================
+// detail::validate_resolver_transport
+// ===========================================================================
+
+TEST(ConfigValidatorDetailTest, ValidateResolverTransport_PlainTcp_Ok) {
+    EXPECT_NO_THROW(detail::validate_resolver_transport(
+        Config::DnsServer{.address = "1.1.1.1", .port = 53, .transport = Config::DnsTransport::TCP}));
+}
+
+TEST(ConfigValidatorDetailTest, ValidateResolverTransport_DefaultOnDoH_Ok) {
+    EXPECT_NO_THROW(detail::validate_resolver_transport(
+        Config::DnsServer{.address = "https://dns.cloudflare.com/dns-query", .port = 443}));
+}
+
+TEST(ConfigValidatorDetailTest, ValidateResolverTransport_TcpOnDoT_Throws) {
+    EXPECT_THROW(detail::validate_resolver_transport(
+                     Config::DnsServer{.address = "tls://1.1.1.1:853", .port = 853,
+                                       .transport = Config::DnsTransport::TCP}),
+                 ConfigVerificationException);
+}
+
 // ===========================================================================
 // ConfigValidator::validate()  —  parameterized tests
 // ===========================================================================
@@ -649,6 +672,48 @@ Config::AppConfig build_subdomain_empty_interface_non_ip_source() {
     };
 }
 
+Config::AppConfig build_scheduler_spreading() {
+    auto cfg = make_domain_config();
+    cfg.scheduler = {.startup_spread = 300, .jitter = 10, .max_dispatch_rate = 5};
+    return cfg;
+}
+
+Config::AppConfig build_scheduler_jitter_too_high() {
+    auto cfg = make_domain_config();
+    cfg.scheduler.jitter = 51;
+    return cfg;
+}
+
+Config::AppConfig build_scheduler_negative_rate() {
+    auto cfg = make_domain_config();
+    cfg.scheduler.max_dispatch_rate = -1;
+    return cfg;
+}
+
+Config::AppConfig build_verify_interval() {
+    auto cfg = make_domain_config();
+    cfg.domains[0].verify_interval = 3600;
+    return cfg;
+}
+
+Config::AppConfig build_state_file() {
+    auto cfg = make_domain_config();
+    cfg.state_file = "/var/lib/yaddnsc/state";
+    return cfg;
+}
+
+Config::AppConfig build_state_file_empty() {
+    auto cfg = make_domain_config();
+    cfg.state_file = "";
+    return cfg;
+}
+
+Config::AppConfig build_verify_interval_negative() {
+    auto cfg = make_domain_config();
+    cfg.domains[0].verify_interval = -1;
+    return cfg;
+}
+
 } // anonymous namespace
 
 // ── Helpers for building interface lists ────────────────────────────────────
@@ -726,7 +791,14 @@ INSTANTIATE_TEST_SUITE_P(
         ValidateCase{"InterfaceExists",            {"test_driver"},  ifaces({"eth0"}),                  60, false, &build_interface_exists},
         ValidateCase{"InterfaceNotFound",          {"test_driver"},  ifaces({"eth1"}),                  60, true,  &build_interface_not_found},
         ValidateCase{"ForceUpdateGreaterThanUpdate",{"test_driver"},        {},  60, false, &build_force_update_greater_than_update},
-        ValidateCase{"SubdomainEmptyInterfaceNonIpSource",{"test_driver"},  {},  60, false, &build_subdomain_empty_interface_non_ip_source}
+        ValidateCase{"SubdomainEmptyInterfaceNonIpSource",{"test_driver"},  {},  60, false, &build_subdomain_empty_interface_non_ip_source},
+        ValidateCase{"SchedulerSpreading",         {"test_driver"},        {},  60, false, &build_scheduler_spreading},
+        ValidateCase{"SchedulerJitterTooHigh",     {"test_driver"},        {},  60, true,  &build_scheduler_jitter_too_high},
+        ValidateCase{"SchedulerNegativeRate",      {"test_driver"},        {},  60, true,  &build_scheduler_negative_rate},
+        ValidateCase{"VerifyInterval",             {"test_driver"},        {},  60, false, &build_verify_interval},
+        ValidateCase{"VerifyIntervalNegative",     {"test_driver"},        {},  60, true,  &build_verify_interval_negative},
+        ValidateCase{"StateFile",                  {"test_driver"},        {},  60, false, &build_state_file},
+        ValidateCase{"StateFileEmpty",             {"test_driver"},        {},  60, true,  &build_state_file_empty}
     ),
     [](const ::testing::TestParamInfo<ValidateCase>& info) {
         return std::string(info.param.name);
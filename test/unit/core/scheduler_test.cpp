@@ -3,15 +3,22 @@
 // the stop_token wakeup path.
 //
 
+#include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <stdexcept>
 #include <stop_token>
 #include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 #include "core/scheduler.h"
+#include "core/state_store.h"
 #include "core/update_task.h"
 
 #include "config/config.h"
@@ -38,6 +45,30 @@ namespace {
     return n;
 }
 
+// A unique temporary state file, removed again at scope exit.
+class TempStateFile {
+public:
+    TempStateFile() {
+        char template_path[] = "/tmp/yaddnsc_test_state_XXXXXX";
+        const int fd = ::mkstemp(template_path);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create temp file");
+        }
+        ::close(fd);
+        path_ = template_path;
+    }
+
+    ~TempStateFile() {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
 } // namespace
 
 // ── Construction & initial population ────────────────────────────────────────
@@ -265,3 +296,214 @@ TEST(Scheduler, WaitForNextWithEmptyHeapBlocksUntilStop) {
     EXPECT_TRUE(returned.load());
     waiter.join();
 }
+
+// ── Task arena & handles ────────────────────────────────────────────────────
+
+TEST(Scheduler, HandlesPointIntoStableArena) {
+    // With a zero interval every task is due again on the next pop; the
+    // handles must point at the same arena entries both times.
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    for (auto &domain: cfg.domains) {
+        domain.update_interval = 0;
+        for (auto &subdomain: domain.subdomains) {
+            subdomain.update_interval = 0;
+        }
+    }
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    const auto first = scheduler.pop_all_due();
+    const auto second = scheduler.pop_all_due();
+    ASSERT_EQ(first.size(), subdomain_count(cfg));
+    ASSERT_EQ(second.size(), first.size());
+
+    std::vector<const UpdateTask *> a, b;
+    for (const auto &due: first) {
+        a.push_back(due.task);
+    }
+    for (const auto &due: second) {
+        b.push_back(due.task);
+    }
+    std::ranges::sort(a);
+    std::ranges::sort(b);
+    EXPECT_EQ(a, b);
+}
+
+TEST(Scheduler, ZeroIntervalPopsEachTaskOncePerCall) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    for (auto &domain: cfg.domains) {
+        domain.update_interval = 0;
+        for (auto &subdomain: domain.subdomains) {
+            subdomain.update_interval = 0;
+        }
+    }
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    // Re-queued deadlines are still "now", but the pop must terminate and
+    // report every task exactly once.
+    EXPECT_EQ(scheduler.pop_all_due().size(), subdomain_count(cfg));
+}
+
+TEST(Scheduler, BufferOverloadClearsAndReusesStorage) {
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    std::vector<DueTask> due;
+    scheduler.pop_all_due(due);
+    ASSERT_EQ(due.size(), subdomain_count(cfg));
+    const auto capacity = due.capacity();
+
+    scheduler.pop_all_due(due);
+    EXPECT_TRUE(due.empty());
+    EXPECT_EQ(due.capacity(), capacity);
+}
+
+// ── Load spreading ──────────────────────────────────────────────────────────
+
+TEST(Scheduler, StartupSpreadDelaysFirstRun) {
+    // Both FULL_CONFIG subdomains hash to a non-zero phase within 300 s, so
+    // nothing is due straight after construction.
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    cfg.scheduler.startup_spread = 300;
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    EXPECT_TRUE(scheduler.has_pending());
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+}
+
+TEST(Scheduler, MaxDispatchRateCapsTasksPerWindow) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    cfg.scheduler.max_dispatch_rate = 1;
+    ASSERT_GT(subdomain_count(cfg), 1U);
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    EXPECT_EQ(scheduler.pop_all_due().size(), 1U);
+    // The remaining task is still due, but the window is exhausted.
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+}
+
+TEST(Scheduler, MaxDispatchRateReleasesRestInNextWindow) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    cfg.scheduler.max_dispatch_rate = 1;
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    ASSERT_EQ(scheduler.pop_all_due().size(), 1U);
+
+    // wait_for_next() sleeps until the rate window rolls over instead of
+    // returning immediately for the already-passed deadline.
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(scheduler.wait_for_next());
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+
+    EXPECT_EQ(scheduler.pop_all_due().size(), 1U);
+}
+
+// ── Interface change wake-up ────────────────────────────────────────────────
+
+TEST(Scheduler, InterfaceChangeRequeuesOnlyMatchingTasks) {
+    // FULL_CONFIG: "www" reads from interface eth0, "@" uses the HTTP source.
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    scheduler.complete(scheduler.pop_all_due());
+    ASSERT_TRUE(scheduler.pop_all_due().empty());
+
+    scheduler.notify_interface_changed("eth1");
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+
+    scheduler.notify_interface_changed("eth0");
+    const auto due = scheduler.pop_all_due();
+    ASSERT_EQ(due.size(), 1U);
+    EXPECT_EQ(due.front().task->fqdn, "www.example.com");
+}
+
+TEST(Scheduler, InterfaceChangeWakesWaitForNext) {
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    scheduler.complete(scheduler.pop_all_due());
+
+    std::thread notifier([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        scheduler.notify_interface_changed("eth0");
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(scheduler.wait_for_next());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    notifier.join();
+
+    EXPECT_EQ(scheduler.pop_all_due().size(), 1U);
+}
+
+TEST(Scheduler, InterfaceChangesDuringARunAreDeferredUntilItCompletes) {
+    // A PPPoE reconnect: the old address goes, the new one comes, both while
+    // the record's previous update is still running.
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    std::stop_source stop;
+    Scheduler scheduler(cfg, stop.get_token());
+
+    const auto running = scheduler.pop_all_due();
+    ASSERT_EQ(running.size(), subdomain_count(cfg));
+
+    scheduler.notify_interface_changed("eth0");
+    scheduler.notify_interface_changed("eth0");
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+
+    // Once the run ends, the two changes make the task due exactly once.
+    std::thread completer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        scheduler.complete(running);
+    });
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(scheduler.wait_for_next());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    completer.join();
+
+    const auto due = scheduler.pop_all_due();
+    ASSERT_EQ(due.size(), 1U);
+    EXPECT_EQ(due.front().task->fqdn, "www.example.com");
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+
+    // Its completion with no change meanwhile re-arms nothing.
+    scheduler.complete(due);
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+}
+
+// ── Persistent state ─────────────────────────────────────────────────────────
+
+TEST(Scheduler, StateStoreResumesSavedSchedule) {
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    TempStateFile file;
+    std::stop_source stop;
+
+    {
+        StateStore store(file.path());
+        Scheduler scheduler(cfg, stop.get_token(), &store);
+        EXPECT_EQ(scheduler.pop_all_due().size(), subdomain_count(cfg));
+    }
+
+    // After a "restart" every task resumes its saved deadline, one interval
+    // out, instead of running again at once.
+    StateStore store(file.path());
+    Scheduler scheduler(cfg, stop.get_token(), &store);
+    EXPECT_TRUE(scheduler.has_pending());
+    EXPECT_TRUE(scheduler.pop_all_due().empty());
+}
+
+TEST(Scheduler, StateStoreWithoutSavedScheduleStartsFresh) {
+    const auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    TempStateFile file;
+    StateStore store(file.path());
+    std::stop_source stop;
+
+    Scheduler scheduler(cfg, stop.get_token(), &store);
+    EXPECT_EQ(scheduler.pop_all_due().size(), subdomain_count(cfg));
+}
@@ -0,0 +1,293 @@
+//
+// StateStore unit tests — round-trips through a real temporary file, torn
+// tails, foreign files and compaction.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "core/state_store.h"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+// A unique, initially empty file that is removed again at scope exit.
+class TempStateFile {
+public:
+    TempStateFile() {
+        char template_path[] = "/tmp/yaddnsc_test_state_XXXXXX";
+        const int fd = ::mkstemp(template_path);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create temp file");
+        }
+        ::close(fd);
+        path_ = template_path;
+    }
+
+    ~TempStateFile() {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+        std::filesystem::remove(std::filesystem::path(path_) += ".tmp", ec);
+    }
+
+    [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
+// Whole-second wall-clock time, which survives the millisecond encoding exactly.
+[[nodiscard]] StateStore::WallClock::time_point at(std::chrono::seconds since_epoch) {
+    return StateStore::WallClock::time_point(since_epoch);
+}
+
+[[nodiscard]] StateStore::Published published(std::string ip, std::chrono::seconds when = 1'700'000'000s) {
+    return StateStore::Published{
+        .fqdn = "www.example.com",
+        .type = RecordKind::A,
+        .ip_addr = std::move(ip),
+        .confirmed_at = at(when),
+    };
+}
+
+} // namespace
+
+TEST(StateStore, EmptyFileHasNoState) {
+    TempStateFile file;
+    StateStore store(file.path());
+
+    EXPECT_FALSE(store.published("www.example.com", RecordKind::A).has_value());
+    EXPECT_FALSE(store.schedule("www.example.com", RecordKind::A).has_value());
+    EXPECT_TRUE(store.all_published().empty());
+}
+
+TEST(StateStore, RoundTripsAcrossReopen) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        store.put_published(published("192.0.2.1"));
+        store.put_schedule(StateStore::Schedule{
+            .fqdn = "www.example.com",
+            .type = RecordKind::AAAA,
+            .last_force_update = at(1'700'000'100s),
+            .next_deadline = at(1'700'000'400s),
+        });
+    }
+
+    StateStore store(file.path());
+    const auto pub = store.published("www.example.com", RecordKind::A);
+    ASSERT_TRUE(pub.has_value());
+    EXPECT_EQ(pub->ip_addr, "192.0.2.1");
+    EXPECT_EQ(pub->confirmed_at, at(1'700'000'000s));
+
+    const auto sched = store.schedule("www.example.com", RecordKind::AAAA);
+    ASSERT_TRUE(sched.has_value());
+    EXPECT_EQ(sched->last_force_update, at(1'700'000'100s));
+    EXPECT_EQ(sched->next_deadline, at(1'700'000'400s));
+
+    // Keys include the record kind.
+    EXPECT_FALSE(store.published("www.example.com", RecordKind::AAAA).has_value());
+    EXPECT_FALSE(store.schedule("www.example.com", RecordKind::A).has_value());
+}
+
+TEST(StateStore, LatestRecordWins) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        store.put_published(published("192.0.2.1"));
+        store.put_published(published("198.51.100.1"));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "198.51.100.1");
+    EXPECT_EQ(store.all_published().size(), 1u);
+}
+
+TEST(StateStore, TornTailIsDroppedAndAppendsResume) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        store.put_published(published("192.0.2.1"));
+    }
+    const auto intact_size = std::filesystem::file_size(file.path());
+
+    // Simulate a crash in the middle of writing the next record.
+    {
+        std::ofstream out(file.path(), std::ios::binary | std::ios::app);
+        out.write("\x00\x00\x00\x30\xde\xad", 6);
+    }
+
+    {
+        StateStore store(file.path());
+        EXPECT_EQ(std::filesystem::file_size(file.path()), intact_size);
+        EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "192.0.2.1");
+        store.put_published(published("198.51.100.1"));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "198.51.100.1");
+}
+
+TEST(StateStore, CorruptRecordEndsTheLog) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        store.put_published(published("192.0.2.1"));
+        store.put_published(published("198.51.100.1"));
+    }
+
+    // Flip the last byte, which belongs to the second record's payload.
+    {
+        std::fstream io(file.path(), std::ios::binary | std::ios::in | std::ios::out);
+        io.seekg(-1, std::ios::end);
+        const auto last = static_cast<char>(io.get());
+        io.seekp(-1, std::ios::end);
+        io.put(static_cast<char>(last ^ 0xFF));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "192.0.2.1");
+}
+
+TEST(StateStore, UnknownRecordTypeIsSkipped) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        store.put_published(published("192.0.2.1"));
+    }
+
+    // An intact record of a type from a newer version: tag 0x7f.
+    {
+        const std::vector<std::uint8_t> payload{0x7f, 0x01, 0x02, 0x03};
+        std::uint32_t hash = 0x811c9dc5U;
+        for (const auto byte: payload) {
+            hash ^= byte;
+            hash *= 0x01000193U;
+        }
+        std::vector<std::uint8_t> frame;
+        for (const auto value: {static_cast<std::uint32_t>(payload.size()), hash}) {
+            for (int shift = 24; shift >= 0; shift -= 8) {
+                frame.push_back(static_cast<std::uint8_t>(value >> shift));
+            }
+        }
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        std::ofstream out(file.path(), std::ios::binary | std::ios::app);
+        out.write(reinterpret_cast<const char *>(frame.data()), static_cast<std::streamsize>(frame.size()));
+    }
+
+    const auto with_unknown = std::filesystem::file_size(file.path());
+
+    // The unknown record is not truncated away, and the records on either
+    // side of it are read.
+    {
+        StateStore store(file.path());
+        EXPECT_EQ(std::filesystem::file_size(file.path()), with_unknown);
+        EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "192.0.2.1");
+        store.put_published(published("198.51.100.1"));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "198.51.100.1");
+    EXPECT_GT(std::filesystem::file_size(file.path()), with_unknown);
+}
+
+TEST(StateStore, ForeignFileThrowsAndIsLeftUntouched) {
+    TempStateFile file;
+    const std::string contents = R"({"not": "a state file"})";
+    {
+        std::ofstream out(file.path(), std::ios::binary | std::ios::trunc);
+        out << contents;
+    }
+
+    EXPECT_THROW(StateStore{file.path()}, std::runtime_error);
+
+    std::ifstream in(file.path(), std::ios::binary);
+    const std::string after((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(after, contents);
+}
+
+TEST(StateStore, MagicCutShortIsInitialised) {
+    TempStateFile file;
+    {
+        // A crash while the magic of a new file was being written.
+        std::ofstream out(file.path(), std::ios::binary | std::ios::trunc);
+        out << "YDNS";
+    }
+
+    {
+        StateStore store(file.path());
+        EXPECT_TRUE(store.all_published().empty());
+        store.put_published(published("192.0.2.1"));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "192.0.2.1");
+}
+
+TEST(StateStore, PutSchedulesAppendsABatch) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        const std::vector<StateStore::Schedule> batch{
+            {.fqdn = "a.example.com", .type = RecordKind::A, .last_force_update = at(1'700'000'000s),
+             .next_deadline = at(1'700'000'300s)},
+            {.fqdn = "b.example.com", .type = RecordKind::AAAA, .last_force_update = at(1'700'000'010s),
+             .next_deadline = at(1'700'000'310s)},
+        };
+        store.put_schedules(batch);
+        store.put_schedules({});
+        EXPECT_EQ(store.schedule("b.example.com", RecordKind::AAAA)->next_deadline, at(1'700'000'310s));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.schedule("a.example.com", RecordKind::A)->next_deadline, at(1'700'000'300s));
+    EXPECT_EQ(store.schedule("b.example.com", RecordKind::AAAA)->last_force_update, at(1'700'000'010s));
+}
+
+TEST(StateStore, CompactKeepsOnlyLiveState) {
+    TempStateFile file;
+    {
+        StateStore store(file.path());
+        for (int i = 0; i < 100; ++i) {
+            store.put_published(published("192.0.2." + std::to_string(i)));
+        }
+        const auto before = std::filesystem::file_size(file.path());
+        store.compact();
+        EXPECT_LT(std::filesystem::file_size(file.path()), before);
+
+        // Appends after compaction go to the new file.
+        store.put_published(published("198.51.100.1"));
+    }
+
+    StateStore store(file.path());
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "198.51.100.1");
+    EXPECT_FALSE(std::filesystem::exists(std::filesystem::path(file.path()) += ".tmp"));
+}
+
+TEST(StateStore, CompactsAutomaticallyWhenMostlySuperseded) {
+    TempStateFile file;
+    StateStore store(file.path());
+    for (int i = 0; i < 1000; ++i) {
+        store.put_published(published("192.0.2.1"));
+    }
+
+    // 1000 appends of one live record would take ~48 kB without compaction.
+    EXPECT_LT(std::filesystem::file_size(file.path()), 16'384u);
+    EXPECT_EQ(store.published("www.example.com", RecordKind::A)->ip_addr, "192.0.2.1");
+}
+
+TEST(StateStore, UnopenablePathThrows) {
+    EXPECT_THROW(StateStore("/nonexistent-dir/yaddnsc/state"), std::runtime_error);
+}
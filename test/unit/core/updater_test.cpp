@@ -4,17 +4,29 @@
 // and MockHttpClient.
 //
 
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
 #include <glaze/glaze.hpp>
 
+#include "core/state_store.h"
 #include "core/updater.h"
 #include "core/update_task.h"
 #include "dns/dispatcher.h"
@@ -22,6 +34,7 @@
 #include "interface/driver.h"
 #include "ip_source/base.h"
 #include "network/inet_address.h"
+#include "util/task.hpp"
 
 #include "config/config.h"
 #include "config/parser.hpp"
@@ -51,6 +64,9 @@ public:
 
     std::vector<InetAddress> resolve() const override { return *addrs_; }
 
+    // Replace the address list seen by this source and all of its copies.
+    void set(std::vector<InetAddress> addrs) { *addrs_ = std::move(addrs); }
+
 private:
     std::shared_ptr<std::vector<InetAddress>> addrs_;
 };
@@ -91,16 +107,20 @@ private:
     };
 }
 
+// A DNS response carrying a single A record (192.0.2.1).
+[[nodiscard]] std::vector<std::uint8_t> fixed_a_response() {
+    return {
+        0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+        0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x03, 'c', 'o', 'm', 0x00,
+        0x00, 0x01, 0x00, 0x01, 0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01,
+        0x00, 0x00, 0x01, 0x2C, 0x00, 0x04, 0xC0, 0x00, 0x02, 0x01};
+}
+
 // A MockResolver that returns a fixed A record (192.0.2.1) for any query.
 class FixedAResolver : public MockResolver {
 public:
     FixedAResolver() {
-        ON_CALL(*this, query(_, _, _))
-            .WillByDefault(Return(std::vector<std::uint8_t>{
-                0x12, 0x34, 0x81, 0x80, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
-                0x07, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0x03, 'c', 'o', 'm', 0x00,
-                0x00, 0x01, 0x00, 0x01, 0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01,
-                0x00, 0x00, 0x01, 0x2C, 0x00, 0x04, 0xC0, 0x00, 0x02, 0x01}));
+        ON_CALL(*this, query(_, _, _)).WillByDefault(Return(fixed_a_response()));
         ON_CALL(*this, get_type()).WillByDefault(Return("Mock"));
     }
 };
@@ -125,6 +145,30 @@ public:
     return ResolverDispatcher(std::move(resolvers), Config::ResolverStrategy::CONCURRENT);
 }
 
+// A unique temporary state file, removed again at scope exit.
+class TempStateFile {
+public:
+    TempStateFile() {
+        char template_path[] = "/tmp/yaddnsc_test_state_XXXXXX";
+        const int fd = ::mkstemp(template_path);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to create temp file");
+        }
+        ::close(fd);
+        path_ = template_path;
+    }
+
+    ~TempStateFile() {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    [[nodiscard]] const std::filesystem::path &path() const noexcept { return path_; }
+
+private:
+    std::filesystem::path path_;
+};
+
 // A successful HTTP exchange returning 200.
 HttpResult ok_response() {
     return HttpResponse{.status_code = 200, .body = "ok"};
@@ -172,6 +216,159 @@ TEST(Updater, UpdatesWhenIpChanged) {
     updater.process(task, driver, http);
 }
 
+// ── Round-robin record → unchanged if any address matches ────────────────────
+
+TEST(Updater, SkipsUpdateWhenAnyDnsAddressMatches) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+
+    // Two A records, 198.51.100.1 and then the local IP (192.0.2.1).
+    auto response = fixed_a_response();
+    response[7] = 0x02; // ANCOUNT
+    response.erase(response.end() - 4, response.end());
+    response.insert(response.end(), {198, 51, 100, 1});
+    response.insert(response.end(), {0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x04});
+    response.insert(response.end(), {0xC0, 0x00, 0x02, 0x01});
+
+    auto resolver = std::make_unique<FixedAResolver>();
+    ON_CALL(*resolver, query(_, _, _)).WillByDefault(Return(response));
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(driver, generate_request).Times(0);
+    EXPECT_CALL(http, exchange).Times(0);
+
+    updater.process(task, driver, http);
+}
+
+// ── verify_interval → recently confirmed address skips the DNS lookup ───────
+
+TEST(Updater, VerifyIntervalSkipsRepeatedDnsLookup) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+    task.verify_interval = 3600;
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto resolver = std::make_unique<FixedAResolver>();
+    // Only the first cycle verifies against DNS; the second trusts the cache.
+    EXPECT_CALL(*resolver, query).Times(1);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(driver, generate_request).Times(0);
+    EXPECT_CALL(http, exchange).Times(0);
+
+    updater.process(task, driver, http);
+    updater.process(task, driver, http);
+}
+
+TEST(Updater, VerifyIntervalTrustsSuccessfulPush) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+    task.verify_interval = 3600;
+
+    // DNS still serves the old record (192.0.2.1) after the push, as a
+    // recursive resolver would until the old TTL runs out.
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({198, 51, 100, 1})});
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(1);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request).WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    updater.process(task, driver, http);
+    updater.process(task, driver, http);
+}
+
+TEST(Updater, VerifyIntervalRecheckedWhenLocalIpChanges) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+    task.verify_interval = 3600;
+    // Interface sources are never cached by the IP source registry, so the
+    // second cycle sees the new address immediately.
+    task.config.ip_source = Config::IpSource::INTERFACE;
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(2);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request).WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    updater.process(task, driver, http);
+    ip->set({Inet4Address::from_bytes({198, 51, 100, 1})});
+    updater.process(task, driver, http);
+}
+
+TEST(Updater, WithoutVerifyIntervalEveryCycleChecksDns) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(2);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(driver, generate_request).Times(0);
+
+    updater.process(task, driver, http);
+    updater.process(task, driver, http);
+}
+
+TEST(Updater, PublishedStateSurvivesRestart) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+    task.verify_interval = 3600;
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    TempStateFile file;
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(driver, generate_request).Times(0);
+
+    {
+        StateStore store(file.path());
+        auto resolver = std::make_unique<FixedAResolver>();
+        EXPECT_CALL(*resolver, query).Times(1);
+        auto dispatcher = make_dispatcher(std::move(resolver));
+        Updater updater(dispatcher, FakeIpSourceFactory(ip), &store);
+        updater.process(task, driver, http);
+    }
+
+    // A new process trusts the address confirmed by the previous one.
+    StateStore store(file.path());
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(0);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip), &store);
+    updater.process(task, driver, http);
+}
+
 // ── force_update → DNS comparison skipped ─────────────────────────────────────
 
 TEST(Updater, ForceUpdateSkipsDnsComparison) {
@@ -451,3 +648,343 @@ TEST(Updater, MultipleIpCandidates_PicksFirstMatching) {
 
     updater.process(task, driver, http);
 }
+
+// ── Driver handles: prepared once at startup, reused by every update ─────────
+
+namespace {
+
+// MockDriver that counts prepare() calls and records the handle passed to
+// every execute_prepared() call.
+class HandleTrackingDriver : public MockDriver {
+public:
+    DriverHandlePtr prepare(const DriverConfig &config) const override {
+        ++prepare_calls;
+        return MockDriver::prepare(config);
+    }
+
+    bool execute_prepared(const DriverHandle &handle, const DriverUpdateParams &ctx,
+                          HttpClient &http) const override {
+        executed_with.push_back(&handle);
+        return MockDriver::execute_prepared(handle, ctx, http);
+    }
+
+    mutable int prepare_calls{0};
+    mutable std::vector<const DriverHandle *> executed_with;
+};
+
+} // namespace
+
+TEST(Updater, UsesTaskDriverHandle) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({198, 51, 100, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    HandleTrackingDriver driver;
+    task.driver_handle = driver.prepare("{}");
+    driver.prepare_calls = 0;
+
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).Times(2).WillRepeatedly(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .Times(2)
+        .WillRepeatedly(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).Times(2).WillRepeatedly(Return(true));
+
+    updater.process(task, driver, http);
+    updater.process(task, driver, http);
+
+    EXPECT_EQ(driver.prepare_calls, 0);
+    ASSERT_EQ(driver.executed_with.size(), 2u);
+    EXPECT_EQ(driver.executed_with[0], task.driver_handle.get());
+    EXPECT_EQ(driver.executed_with[1], task.driver_handle.get());
+}
+
+TEST(Updater, PreparesDriverHandleWhenTaskHasNone) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto task = make_task(cfg);
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({198, 51, 100, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    HandleTrackingDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    updater.process(task, driver, http);
+
+    EXPECT_EQ(driver.prepare_calls, 1);
+    EXPECT_EQ(driver.executed_with.size(), 1u);
+}
+
+// ── process_batch → one execute_batch call with only the changed tasks ───────
+
+namespace {
+
+// MockDriver that records the size of every execute_batch() call.
+class RecordingBatchDriver : public MockDriver {
+public:
+    std::vector<bool> execute_batch(std::span<const DriverBatchItem> items, HttpClient &http) const override {
+        batch_sizes.push_back(items.size());
+        return MockDriver::execute_batch(items, http);
+    }
+
+    mutable std::vector<std::size_t> batch_sizes;
+};
+
+} // namespace
+
+TEST(Updater, ProcessBatch_SendsChangedTasksInOneBatch) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto first = make_task(cfg);
+    auto second = make_task(cfg);
+    second.fqdn = "api.example.com";
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({198, 51, 100, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    RecordingBatchDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).Times(2).WillRepeatedly(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .Times(2)
+        .WillRepeatedly(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).Times(2).WillRepeatedly(Return(true));
+
+    const std::vector<DueTask> tasks{{.task = &first}, {.task = &second}};
+    updater.process_batch(tasks, driver, http);
+
+    ASSERT_EQ(driver.batch_sizes.size(), 1u);
+    EXPECT_EQ(driver.batch_sizes.front(), 2u);
+}
+
+TEST(Updater, ProcessBatch_SkipsDriverWhenNothingChanged) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto first = make_task(cfg);
+    const auto second = make_task(cfg);
+    const std::vector<DueTask> tasks{{.task = &first}, {.task = &second}};
+
+    // Local IP equals the DNS record for every task.
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    RecordingBatchDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).Times(0);
+
+    updater.process_batch(tasks, driver, http);
+
+    EXPECT_TRUE(driver.batch_sizes.empty());
+}
+
+TEST(Updater, ProcessBatch_FailingTaskDoesNotDropOthers) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto good = make_task(cfg);
+    auto bad = make_task(cfg);
+    bad.fqdn = "broken.example.com";
+    bad.config.ip_source_param = "throw";
+
+    class SelectiveIpSource : public IpSourceBase {
+    public:
+        explicit SelectiveIpSource(bool fail) : fail_(fail) {}
+
+        std::vector<InetAddress> resolve() const override {
+            if (fail_) {
+                throw std::runtime_error("interface not found");
+            }
+            return {Inet4Address::from_bytes({198, 51, 100, 1})};
+        }
+
+    private:
+        bool fail_;
+    };
+    auto factory = [](const Config::SubdomainConfig &c) {
+        return std::make_unique<SelectiveIpSource>(c.ip_source_param == "throw");
+    };
+
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, factory);
+
+    RecordingBatchDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    const std::vector<DueTask> tasks{{.task = &bad}, {.task = &good}};
+    EXPECT_NO_THROW(updater.process_batch(tasks, driver, http));
+
+    ASSERT_EQ(driver.batch_sizes.size(), 1u);
+    EXPECT_EQ(driver.batch_sizes.front(), 1u);
+}
+
+TEST(Updater, ProcessBatch_HonoursPerHandleForceUpdate) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto unchanged = make_task(cfg);
+    auto forced = make_task(cfg);
+    forced.fqdn = "api.example.com";
+
+    // Local IP equals the DNS record, so only the forced handle is sent.
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    RecordingBatchDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    const std::vector<DueTask> tasks{{.task = &unchanged}, {.task = &forced, .force_update = true}};
+    updater.process_batch(tasks, driver, http);
+
+    ASSERT_EQ(driver.batch_sizes.size(), 1u);
+    EXPECT_EQ(driver.batch_sizes.front(), 1u);
+}
+
+// ── process_async → stages on an executor, IP source overlapped with DNS ────
+
+namespace {
+
+// Runs every job on a new thread.
+class ThreadExecutor {
+public:
+    ~ThreadExecutor() { threads_.clear(); }
+
+    [[nodiscard]] Utils::Executor executor() {
+        return [this](std::function<void()> job) {
+            std::lock_guard lock(mutex_);
+            threads_.emplace_back(std::move(job));
+        };
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::jthread> threads_;
+};
+
+// An IP source that waits (up to 5 s) for the DNS lookup to start before
+// returning, and records whether it did.
+class WaitForDnsIpSource : public IpSourceBase {
+public:
+    WaitForDnsIpSource(std::shared_future<void> dns_started, std::shared_ptr<bool> overlapped)
+        : dns_started_(std::move(dns_started)), overlapped_(std::move(overlapped)) {}
+
+    std::vector<InetAddress> resolve() const override {
+        *overlapped_ = dns_started_.wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+        return {Inet4Address::from_bytes({198, 51, 100, 1})};
+    }
+
+private:
+    std::shared_future<void> dns_started_;
+    std::shared_ptr<bool> overlapped_;
+};
+
+} // namespace
+
+TEST(Updater, ProcessAsync_OverlapsIpSourceAndDnsLookup) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto task = make_task(cfg);
+
+    std::promise<void> dns_started;
+    auto overlapped = std::make_shared<bool>(false);
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).WillOnce([&](auto &&...) -> std::expected<std::vector<std::uint8_t>, DnsErrorInfo> {
+        dns_started.set_value();
+        return fixed_a_response();
+    });
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, [future = dns_started.get_future().share(), overlapped](const auto &) {
+        return std::make_unique<WaitForDnsIpSource>(future, overlapped);
+    });
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).WillOnce(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .WillOnce(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).WillOnce(Return(true));
+
+    ThreadExecutor threads;
+    Utils::sync_wait(updater.process_async(task, driver, http, threads.executor()));
+
+    EXPECT_TRUE(*overlapped);
+}
+
+TEST(Updater, ProcessAsync_NoEarlyLookupWhenRecentlyConfirmed) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    auto task = make_task(cfg);
+    task.verify_interval = 3600;
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({192, 0, 2, 1})});
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(1);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(driver, generate_request).Times(0);
+
+    ThreadExecutor threads;
+    Utils::sync_wait(updater.process_async(task, driver, http, threads.executor()));
+    Utils::sync_wait(updater.process_async(task, driver, http, threads.executor()));
+}
+
+TEST(Updater, ProcessWithoutExecutorLooksUpOnlyAfterIpSource) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto task = make_task(cfg);
+
+    auto ip = std::make_shared<FakeIpSource>(std::vector<InetAddress>{});
+    auto resolver = std::make_unique<FixedAResolver>();
+    EXPECT_CALL(*resolver, query).Times(0);
+    auto dispatcher = make_dispatcher(std::move(resolver));
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    MockDriver driver;
+    MockHttpClient http;
+    updater.process(task, driver, http);
+}
+
+TEST(Updater, ProcessBatchAsync_SendsOneBatchFromExecutor) {
+    auto cfg = parse_cfg(Fixtures::FULL_CONFIG);
+    const auto first = make_task(cfg);
+    auto second = make_task(cfg);
+    second.fqdn = "api.example.com";
+
+    auto ip = std::make_shared<FakeIpSource>(
+        std::vector<InetAddress>{Inet4Address::from_bytes({198, 51, 100, 1})});
+    auto dispatcher = make_dispatcher(std::make_unique<FixedAResolver>());
+    Updater updater(dispatcher, FakeIpSourceFactory(ip));
+
+    RecordingBatchDriver driver;
+    MockHttpClient http;
+    EXPECT_CALL(http, exchange).Times(2).WillRepeatedly(Return(ok_response()));
+    EXPECT_CALL(driver, generate_request)
+        .Times(2)
+        .WillRepeatedly(Return(DriverRequestContext{.url = "https://api.example.com/update", .request = {}}));
+    EXPECT_CALL(driver, check_response).Times(2).WillRepeatedly(Return(true));
+
+    const std::vector<DueTask> tasks{{.task = &first}, {.task = &second}};
+    ThreadExecutor threads;
+    Utils::sync_wait(updater.process_batch_async(tasks, driver, http, threads.executor()));
+
+    ASSERT_EQ(driver.batch_sizes.size(), 1u);
+    EXPECT_EQ(driver.batch_sizes.front(), 2u);
+}
@@ -0,0 +1,134 @@
+//
+// Unit tests for src/dns/answer_cache.cpp — per-answer TTL expiry, negative
+// answers (RFC 2308), epochs and eviction.  Time is driven by a fake clock.
+// =============================================================================
+
+#include <chrono>
+#include <expected>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dns/answer_cache.h"
+#include "dns_error.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+const AnswerCache::Result ANSWER{std::vector<std::string>{"192.0.2.1"}};
+
+[[nodiscard]] AnswerCache::Result failure(DnsError code) {
+    return std::unexpected(DnsErrorInfo{code, "failed"});
+}
+
+class AnswerCacheTest : public ::testing::Test {
+protected:
+    AnswerCache::Clock::time_point now{};
+    AnswerCache cache{[this] { return now; }};
+    const std::string key = AnswerCache::make_key("example.com", RecordKind::A);
+};
+
+TEST_F(AnswerCacheTest, MakeKey_IgnoresCaseAndTrailingDot) {
+    EXPECT_EQ(key, AnswerCache::make_key("Example.COM.", RecordKind::A));
+    EXPECT_NE(key, AnswerCache::make_key("example.com", RecordKind::AAAA));
+    EXPECT_NE(key, AnswerCache::make_key("www.example.com", RecordKind::A));
+}
+
+TEST_F(AnswerCacheTest, Find_Missing_ReturnsNothing) {
+    EXPECT_FALSE(cache.find(key).has_value());
+}
+
+TEST_F(AnswerCacheTest, Answer_LivesForItsTtl) {
+    cache.store(key, ANSWER, 30, cache.epoch());
+
+    now += 29s;
+    ASSERT_TRUE(cache.find(key).has_value());
+    EXPECT_EQ(cache.find(key)->value(), ANSWER.value());
+
+    now += 1s;
+    EXPECT_FALSE(cache.find(key).has_value());
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST_F(AnswerCacheTest, ZeroTtl_IsNotCached) {
+    cache.store(key, ANSWER, 0, cache.epoch());
+    EXPECT_FALSE(cache.find(key).has_value());
+}
+
+TEST_F(AnswerCacheTest, NegativeAnswers_AreCached) {
+    const auto nodata = AnswerCache::make_key("example.com", RecordKind::AAAA);
+    cache.store(key, failure(DnsError::NX_DOMAIN), 60, cache.epoch());
+    cache.store(nodata, failure(DnsError::NODATA), 60, cache.epoch());
+
+    ASSERT_TRUE(cache.find(key).has_value());
+    EXPECT_EQ(cache.find(key)->error().code, DnsError::NX_DOMAIN);
+    ASSERT_TRUE(cache.find(nodata).has_value());
+    EXPECT_EQ(cache.find(nodata)->error().code, DnsError::NODATA);
+}
+
+TEST_F(AnswerCacheTest, OtherFailures_AreNotCached) {
+    for (const auto code: {DnsError::RETRY, DnsError::CONNECTION, DnsError::SERVER_REFUSED, DnsError::PARSE,
+                           DnsError::UNKNOWN, DnsError::CANCELLED}) {
+        cache.store(key, failure(code), 60, cache.epoch());
+        EXPECT_FALSE(cache.find(key).has_value()) << error_to_str(code);
+    }
+}
+
+TEST_F(AnswerCacheTest, Ttl_IsCapped) {
+    cache.store(key, ANSWER, 7 * AnswerCache::MAX_TTL, cache.epoch());
+    now += std::chrono::seconds(AnswerCache::MAX_TTL);
+    EXPECT_FALSE(cache.find(key).has_value());
+
+    cache.store(key, failure(DnsError::NX_DOMAIN), AnswerCache::MAX_TTL, cache.epoch());
+    now += std::chrono::seconds(AnswerCache::MAX_NEGATIVE_TTL);
+    EXPECT_FALSE(cache.find(key).has_value());
+}
+
+TEST_F(AnswerCacheTest, Invalidate_ForgetsEveryTypeOfTheHost) {
+    const auto aaaa = AnswerCache::make_key("example.com", RecordKind::AAAA);
+    const auto other = AnswerCache::make_key("example.org", RecordKind::A);
+    cache.store(key, ANSWER, 60, cache.epoch());
+    cache.store(aaaa, ANSWER, 60, cache.epoch());
+    cache.store(other, ANSWER, 60, cache.epoch());
+
+    cache.invalidate("EXAMPLE.com");
+
+    EXPECT_FALSE(cache.find(key).has_value());
+    EXPECT_FALSE(cache.find(aaaa).has_value());
+    EXPECT_TRUE(cache.find(other).has_value());
+}
+
+TEST_F(AnswerCacheTest, StoreFromEarlierEpoch_IsDropped) {
+    const auto epoch = cache.epoch();
+    cache.invalidate("example.com");
+
+    cache.store(key, ANSWER, 60, epoch);
+    EXPECT_FALSE(cache.find(key).has_value());
+
+    cache.store(key, ANSWER, 60, cache.epoch());
+    EXPECT_TRUE(cache.find(key).has_value());
+}
+
+TEST_F(AnswerCacheTest, Clear_ForgetsEverything) {
+    cache.store(key, ANSWER, 60, cache.epoch());
+    const auto epoch = cache.epoch();
+    cache.clear();
+
+    EXPECT_EQ(cache.size(), 0U);
+    EXPECT_NE(cache.epoch(), epoch);
+}
+
+TEST_F(AnswerCacheTest, OverCapacity_EvictsWhatExpiresFirst) {
+    cache.store(key, ANSWER, 10, cache.epoch());
+    for (std::size_t i = 0; i < AnswerCache::MAX_ENTRIES; ++i) {
+        cache.store("host" + std::to_string(i), ANSWER, 600, cache.epoch());
+    }
+
+    EXPECT_EQ(cache.size(), AnswerCache::MAX_ENTRIES);
+    EXPECT_FALSE(cache.find(key).has_value());
+    EXPECT_TRUE(cache.find("host0").has_value());
+}
+
+} // anonymous namespace
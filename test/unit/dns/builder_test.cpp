@@ -5,11 +5,14 @@
 //   - Header field encoding (ID, flags, counts)
 //   - Question section (single, multiple, QTYPE, QCLASS)
 //   - Domain name encoding (single label, multi-label, root, edge cases)
-//   - Input validation (empty questions, label > 63, name > 255)
+//   - Input validation (empty questions, empty label, label > 63, name > 255)
 //   - EDNS0 OPT record (basic, options, validation)
 //   - Raw QCLASS (mDNS QU bit)
+//   - build_into a caller buffer, with and without a length prefix
+//   - Compile-time name encoding (dns/wire/name.h)
 // =============================================================================
 
+#include <array>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,6 +21,7 @@
 #include <gtest/gtest.h>
 
 #include "dns/wire/builder.h"
+#include "dns/wire/name.h"
 #include "exception/dns_packet.h"
 
 // ===========================================================================
@@ -614,3 +618,154 @@ TEST(QueryBuilderTest, EdnsEmptyExplicitOptions) {
     size_t opt_offset = 29;
     EXPECT_EQ(read_u16(packet, opt_offset + 9), 0);
 }
+
+// ===========================================================================
+//  build_into — caller buffer
+// ===========================================================================
+
+TEST(QueryBuilderTest, BuildIntoMatchesBuild) {
+    const auto builder = DNS::QueryBuilder{}
+        .id(0x1234)
+        .add_question("www.example.com", DNS::RecordType::AAAA)
+        .add_edns(1232, 0, true);
+    const auto packet = builder.build();
+
+    std::array<std::uint8_t, 512> buf{};
+    const auto written = builder.build_into(buf);
+
+    EXPECT_EQ(builder.size(), packet.size());
+    EXPECT_EQ(written.data(), buf.data());
+    EXPECT_EQ(std::vector<std::uint8_t>(written.begin(), written.end()), packet);
+}
+
+TEST(QueryBuilderTest, BuildIntoLengthPrefixed) {
+    const auto builder = DNS::QueryBuilder{}
+        .id(0x1234)
+        .add_question("example.com", DNS::RecordType::A);
+    const auto packet = builder.build();
+
+    std::array<std::uint8_t, 512> buf{};
+    const auto framed = builder.build_into(buf, DNS::Framing::LENGTH_PREFIXED);
+
+    ASSERT_EQ(framed.size(), DNS::LENGTH_PREFIX_SIZE + packet.size());
+    EXPECT_EQ(read_u16(std::vector<std::uint8_t>(framed.begin(), framed.end()), 0), packet.size());
+    EXPECT_EQ(std::vector<std::uint8_t>(framed.begin() + 2, framed.end()), packet);
+}
+
+TEST(QueryBuilderTest, BuildIntoExactFit) {
+    const auto builder = DNS::QueryBuilder{}.add_question("example.com", DNS::RecordType::A);
+
+    std::vector<std::uint8_t> exact(builder.size() + DNS::LENGTH_PREFIX_SIZE);
+    EXPECT_EQ(builder.build_into(exact, DNS::Framing::LENGTH_PREFIXED).size(), exact.size());
+}
+
+TEST(QueryBuilderTest, BuildIntoThrowsOnUndersizedBuffer) {
+    const auto builder = DNS::QueryBuilder{}.add_question("example.com", DNS::RecordType::A);
+
+    std::vector<std::uint8_t> plain(builder.size() - 1);
+    EXPECT_THROW(static_cast<void>(builder.build_into(plain)), DnsPacketException);
+
+    // Room for the message but not its length prefix.
+    std::vector<std::uint8_t> unframed(builder.size());
+    EXPECT_THROW(static_cast<void>(builder.build_into(unframed, DNS::Framing::LENGTH_PREFIXED)),
+                 DnsPacketException);
+}
+
+TEST(QueryBuilderTest, SizeCountsQuestionsAndOptions) {
+    const std::vector<DNS::EdnsOption> opts = {{10, {1, 2, 3, 4, 5, 6, 7, 8}}};
+    const auto builder = DNS::QueryBuilder{}
+        .add_question("example.com", DNS::RecordType::A)
+        .add_question("example.org.", DNS::RecordType::AAAA)
+        .add_edns(1232, 0, false, opts);
+
+    // Header + 2 × (13-octet name + 4) + OPT (11) + option (4 + 8).
+    EXPECT_EQ(builder.size(), 12U + 2 * (13 + 4) + 11 + 12);
+    EXPECT_EQ(builder.build().size(), builder.size());
+}
+
+// ===========================================================================
+//  Name encoding (dns/wire/name.h)
+// ===========================================================================
+
+TEST(NameEncodingTest, LiteralIsEncodedAtCompileTime) {
+    static constexpr auto name = DNS::encode_name_literal("www.example.com");
+    static_assert(name.size == 17);
+    static_assert(name.octets[0] == 3 && name.octets[4] == 7 && name.octets[12] == 3 && name.octets[16] == 0);
+
+    const std::vector<std::uint8_t> expected = {
+        3, 'w', 'w', 'w', 7, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 3, 'c', 'o', 'm', 0,
+    };
+    EXPECT_EQ(std::vector<std::uint8_t>(name.bytes().begin(), name.bytes().end()), expected);
+}
+
+TEST(NameEncodingTest, LiteralRootAndTrailingDot) {
+    static constexpr auto root = DNS::encode_name_literal("");
+    static_assert(root.size == 1 && root.octets[0] == 0);
+
+    static constexpr auto dot = DNS::encode_name_literal(".");
+    static_assert(dot.size == 1 && dot.octets[0] == 0);
+
+    static constexpr auto fqdn = DNS::encode_name_literal("example.com.");
+    static constexpr auto relative = DNS::encode_name_literal("example.com");
+    static_assert(fqdn.size == relative.size);
+    EXPECT_TRUE(std::ranges::equal(fqdn.bytes(), relative.bytes()));
+}
+
+TEST(NameEncodingTest, RuntimeMatchesQuestionEncoding) {
+    const auto packet = DNS::QueryBuilder{}
+        .add_question("mail.example.org", DNS::RecordType::A)
+        .build();
+
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    const auto size = DNS::encode_name("mail.example.org", buf);
+
+    ASSERT_EQ(size, DNS::encoded_name_size("mail.example.org"));
+    EXPECT_TRUE(std::ranges::equal(std::span(buf).first(size),
+                                   std::span(packet).subspan(DNS::HEADER_SIZE, size)));
+}
+
+TEST(NameEncodingTest, RuntimeThrowsOnInvalidName) {
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    EXPECT_THROW(static_cast<void>(DNS::encode_name(std::string(64, 'a') + ".com", buf)), DnsPacketException);
+
+    std::string too_long;
+    for (int i = 0; i < 51; ++i) {
+        too_long += "abcd.";
+    }
+    too_long += "com";
+    EXPECT_THROW(static_cast<void>(DNS::encode_name(too_long, buf)), DnsPacketException);
+
+    std::array<std::uint8_t, 4> small{};
+    EXPECT_THROW(static_cast<void>(DNS::encode_name("example.com", small)), DnsPacketException);
+}
+
+TEST(NameEncodingTest, RuntimeThrowsOnEmptyLabel) {
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (const std::string_view name: {"a..b", ".example.com", "example.com..", ".."}) {
+        EXPECT_THROW(static_cast<void>(DNS::encode_name(name, buf)), DnsPacketException) << name;
+    }
+}
+
+TEST(NameEncodingTest, RuntimeEncodesLongNames) {
+    // Long enough for the dots to be found a whole block at a time.
+    std::string name;
+    std::vector<std::uint8_t> expected;
+    for (int i = 0; i < 20; ++i) {
+        const std::string label(1 + i % 9, static_cast<char>('a' + i));
+        name += label + ".";
+        expected.push_back(static_cast<std::uint8_t>(label.size()));
+        expected.insert(expected.end(), label.begin(), label.end());
+    }
+    name += "example";
+    expected.insert(expected.end(), {7, 'e', 'x', 'a', 'm', 'p', 'l', 'e', 0});
+
+    std::array<std::uint8_t, DNS::MAX_NAME_SIZE> buf{};
+    for (const auto &n: {name, name + "."}) {
+        const auto size = DNS::encode_name(n, buf);
+        EXPECT_EQ(std::vector<std::uint8_t>(buf.begin(), buf.begin() + size), expected) << n;
+    }
+
+    // A label over MAX_LABEL_SIZE in the middle of a long name.
+    EXPECT_THROW(static_cast<void>(DNS::encode_name(name.substr(0, 30) + std::string(64, 'x') + ".com", buf)),
+                 DnsPacketException);
+}
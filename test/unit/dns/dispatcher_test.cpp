@@ -1,8 +1,286 @@
 //
 // ResolverDispatcher unit tests — native backend (YADDNSC_USE_NATIVE_DNS=1).
 //
-// Compiled with the jthread-based dispatcher.cpp.  See
-// test/fixtures/dispatcher_tests.h for the shared test bodies.
+// Compiled with the ResolverEngine-based dispatcher.cpp.  See
+// test/fixtures/dispatcher_tests.h for the shared test bodies; the answer
+// cache and hedged strategy tests below exist for this backend only.
 // =============================================================================
 
+#include <atomic>
+#include <chrono>
+#include <thread>
+
 #include "fixtures/dispatcher_tests.h"
+
+// =============================================================================
+//  Answer cache (native backend only)
+// =============================================================================
+
+namespace {
+
+// NXDOMAIN for "example.com" with the zone's SOA in the authority section,
+// so the answer carries a negative TTL of `minimum` seconds (RFC 2308).
+std::vector<std::uint8_t> make_nxdomain_with_soa(std::uint32_t minimum = 60) {
+    auto buf = make_header_response(0x1234, 0x83, 0);
+    write_u16_be(buf, 8, 1); // NSCOUNT
+    buf.insert(buf.end(), {0xC0, 0x0C, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x0E, 0x10, 0x00, 0x00});
+    const auto rdata_at = buf.size();
+    encode_name(buf, "ns.example.com");
+    encode_name(buf, "admin.example.com");
+    for (const std::uint32_t value: {1U, 7200U, 3600U, 1209600U, minimum}) {
+        for (const int shift: {24, 16, 8, 0}) {
+            buf.push_back(static_cast<std::uint8_t>(value >> shift));
+        }
+    }
+    write_u16_be(buf, rdata_at - 2, static_cast<std::uint16_t>(buf.size() - rdata_at));
+    return buf;
+}
+
+// A dispatcher with the answer cache over `resolver`.
+ResolverDispatcher make_caching_dispatcher(std::unique_ptr<ResolverBase> resolver) {
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(resolver));
+    return ResolverDispatcher(std::move(resolvers), Config::ResolverStrategy::CONCURRENT, true);
+}
+
+} // namespace
+
+TEST(DispatcherCache, DisabledByDefault_EveryLookupQueries) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(2).WillRepeatedly(Return(ok_a()));
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(r));
+    const ResolverDispatcher disp(std::move(resolvers));
+
+    EXPECT_TRUE(disp.resolve("example.com", RecordKind::A).has_value());
+    EXPECT_TRUE(disp.resolve("example.com", RecordKind::A).has_value());
+}
+
+TEST(DispatcherCache, RepeatedLookup_IsAnsweredFromCache) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(1).WillOnce(Return(ok_a()));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    for (int i = 0; i < 3; ++i) {
+        const auto result = disp.resolve("example.com", RecordKind::A);
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, (std::vector<std::string>{"192.168.1.1"}));
+    }
+    const auto async = Utils::sync_wait(disp.resolve_async("EXAMPLE.com.", RecordKind::A));
+    ASSERT_TRUE(async.has_value());
+    EXPECT_EQ(*async, (std::vector<std::string>{"192.168.1.1"}));
+}
+
+TEST(DispatcherCache, Addresses_AreCachedWithTheRecords) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(1).WillOnce(Return(ok_a()));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    ASSERT_TRUE(disp.resolve("example.com", RecordKind::A).has_value());
+    const auto addresses = disp.resolve_addresses("example.com", RecordKind::A);
+    ASSERT_TRUE(addresses.has_value());
+    EXPECT_EQ(*addresses, AddressList{Inet4Address::from_bytes({192, 168, 1, 1})});
+}
+
+TEST(DispatcherCache, RecordTypes_AreCachedSeparately) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, RecordKind::A, _)).Times(1).WillOnce(Return(ok_a()));
+    EXPECT_CALL(*r, query(_, RecordKind::AAAA, _)).Times(1).WillOnce(Return(ok_aaaa()));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(disp.resolve("example.com", RecordKind::A).value().front(), "192.168.1.1");
+        EXPECT_EQ(disp.resolve("example.com", RecordKind::AAAA).value().front(), "2001:db8::1");
+    }
+}
+
+TEST(DispatcherCache, NxdomainWithSoa_IsCached) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(1).WillOnce(Return(make_nxdomain_with_soa()));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    for (int i = 0; i < 2; ++i) {
+        expect_single_resolver_failure(disp.resolve("example.com", RecordKind::A), DnsError::NX_DOMAIN);
+    }
+}
+
+TEST(DispatcherCache, NxdomainWithoutSoa_IsNotCached) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(2).WillRepeatedly(Return(make_rcode_response(0x83)));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    for (int i = 0; i < 2; ++i) {
+        expect_single_resolver_failure(disp.resolve("example.com", RecordKind::A), DnsError::NX_DOMAIN);
+    }
+}
+
+TEST(DispatcherCache, TransientFailure_IsNotCached) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(2).WillRepeatedly(Return(err(DnsError::RETRY, "retry")));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    for (int i = 0; i < 2; ++i) {
+        expect_transient_failure(disp.resolve("example.com", RecordKind::A, 0));
+    }
+}
+
+TEST(DispatcherCache, Invalidate_ForcesANewLookup) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _))
+        .Times(2)
+        .WillOnce(Return(ok_a({192, 168, 1, 1})))
+        .WillOnce(Return(ok_a({192, 168, 1, 2})));
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    EXPECT_EQ(disp.resolve("example.com", RecordKind::A).value().front(), "192.168.1.1");
+    disp.invalidate("example.com");
+    EXPECT_EQ(disp.resolve("example.com", RecordKind::A).value().front(), "192.168.1.2");
+    EXPECT_EQ(disp.resolve("example.com", RecordKind::A).value().front(), "192.168.1.2");
+}
+
+TEST(DispatcherCache, ConcurrentLookups_ShareOneQuery) {
+    auto r = make_mock();
+    EXPECT_CALL(*r, query(_, _, _)).Times(1).WillOnce([](auto &&...) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        return ok_a();
+    });
+    const auto disp = make_caching_dispatcher(std::move(r));
+
+    std::vector<std::expected<std::vector<std::string>, DnsErrorInfo>> results(8);
+    {
+        std::vector<std::jthread> threads;
+        for (auto &result: results) {
+            threads.emplace_back([&disp, &result] { result = disp.resolve("example.com", RecordKind::A); });
+        }
+    }
+
+    for (const auto &result: results) {
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(*result, (std::vector<std::string>{"192.168.1.1"}));
+    }
+}
+
+// =============================================================================
+//  Hedged strategy (native backend only)
+// =============================================================================
+
+namespace {
+
+using ::testing::AtLeast;
+using ::testing::AtMost;
+
+// Answers at once until stalled, then blocks until cancelled (or 3 s pass).
+class StallingResolver : public ResolverBase {
+public:
+    [[nodiscard]] std::expected<std::vector<std::uint8_t>, DnsErrorInfo>
+    query(const std::string &, RecordKind, const Utils::CancellationToken &cancel_token) const override {
+        if (stalled && cancel_token) {
+            ::pollfd pfd{cancel_token.native_handle(), POLLIN, 0};
+            if (::poll(&pfd, 1, 3000) > 0) {
+                cancel_token.drain();
+                return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "cancelled by winner"});
+            }
+        }
+        return ok_a();
+    }
+
+    [[nodiscard]] std::string_view get_type() const noexcept override { return "Stalling"; }
+
+    std::atomic<bool> stalled{false};
+};
+
+} // namespace
+
+TEST(DispatcherHedged, AnySucceeds_ReturnsRecords) {
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    for (int i = 0; i < 2; ++i) {
+        auto r = make_mock();
+        ON_CALL(*r, query(_, _, _)).WillByDefault(Return(err(DnsError::RETRY, "r")));
+        resolvers.push_back(std::move(r));
+    }
+    auto winner = make_mock();
+    ON_CALL(*winner, query(_, _, _)).WillByDefault(Return(ok_a()));
+    resolvers.push_back(std::move(winner));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::HEDGED);
+
+    auto result = disp.resolve("example.com", RecordKind::A, 1, 1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ((*result)[0], "192.168.1.1");
+}
+
+TEST(DispatcherHedged, NxDomain_StopsTheLookup) {
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    for (int i = 0; i < 3; ++i) {
+        auto r = make_mock();
+        EXPECT_CALL(*r, query(_, _, _)).Times(AtMost(1)).WillRepeatedly(Return(make_rcode_response(0x83)));
+        resolvers.push_back(std::move(r));
+    }
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::HEDGED);
+
+    expect_unexpected(disp.resolve("example.com", RecordKind::A, 1, 1), DnsError::NX_DOMAIN);
+}
+
+TEST(DispatcherHedged, AllRetryable_QueriesEachOnce) {
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    for (int i = 0; i < 3; ++i) {
+        auto r = make_mock();
+        EXPECT_CALL(*r, query(_, _, _)).Times(1).WillOnce(Return(err(DnsError::RETRY, "r")));
+        resolvers.push_back(std::move(r));
+    }
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::HEDGED);
+
+    auto result = disp.resolve("example.com", RecordKind::A, 1, 1);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::RETRY);
+}
+
+// Once both are measured, the fast resolver is asked first and answers well
+// within its hedge delay, so the slow one is left alone.  Only the very
+// first lookup may go to the slow resolver.
+TEST(DispatcherHedged, PrefersTheFastestResolver) {
+    auto slow = make_mock();
+    EXPECT_CALL(*slow, query(_, _, _)).Times(AtMost(1)).WillRepeatedly([](auto &&...) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        return ok_a({192, 168, 1, 2});
+    });
+    auto fast = make_mock();
+    EXPECT_CALL(*fast, query(_, _, _)).Times(AtLeast(9)).WillRepeatedly(Return(ok_a()));
+
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(slow));
+    resolvers.push_back(std::move(fast));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::HEDGED);
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(disp.resolve("example.com", RecordKind::A, 1, 1).has_value());
+    }
+}
+
+// The preferred resolver stops answering: the hedge to the next one answers
+// the lookup after a delay learnt from the preferred one's past answers,
+// long before the stalled query would have.
+TEST(DispatcherHedged, StalledResolver_IsHedged) {
+    auto stalling = std::make_unique<StallingResolver>();
+    auto *preferred = stalling.get();
+    auto backup = make_mock();
+    ON_CALL(*backup, query(_, _, _)).WillByDefault([](auto &&...) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return ok_a({192, 168, 1, 2});
+    });
+
+    std::vector<std::unique_ptr<ResolverBase>> resolvers;
+    resolvers.push_back(std::move(stalling));
+    resolvers.push_back(std::move(backup));
+    ResolverDispatcher disp(std::move(resolvers), Config::ResolverStrategy::HEDGED);
+
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_TRUE(disp.resolve("example.com", RecordKind::A, 1, 1).has_value());
+    }
+
+    preferred->stalled = true;
+    const auto started = std::chrono::steady_clock::now();
+    const auto result = disp.resolve("example.com", RecordKind::A, 1, 1);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->front(), "192.168.1.2");
+    EXPECT_LT(std::chrono::steady_clock::now() - started, std::chrono::seconds(1));
+}
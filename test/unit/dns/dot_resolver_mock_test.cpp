@@ -2,15 +2,26 @@
 // DotResolver mock tests — TLS error paths via MockTlsConnection.
 //
 // Verifies that DotResolver::Impl correctly handles:
-//   - send_query failures (CANCELLED, CONNECTION)
+//   - send failures (CANCELLED, CONNECTION)
 //   - read_response failures (CANCELLED, CONNECTION, zero-length)
 //   - ensure_connection (connect timeout, connect failure)
+//   - pipelining over FakeDotConnection: queries in flight together on one
+//     connection, out-of-order responses, unsolicited responses, and late
+//     responses to abandoned queries
 // =============================================================================
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <unistd.h>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -18,9 +29,12 @@
 #include "mocks/mock_tls_connection.h"
 
 #include "util/cancellation_token.hpp"
+#include "util/fd.hpp"
 
 namespace {
 
+using namespace std::chrono_literals;
+
 using ::testing::_;
 using ::testing::Return;
 using IoStatus = TlsConnectionBase::IoStatus;
@@ -32,6 +46,119 @@ using IoStatus = TlsConnectionBase::IoStatus;
 /// A CancellationToken that is never triggered.
 static Utils::CancellationToken no_cancel;
 
+/// An in-memory DoT server behind the TlsConnectionBase interface.
+///
+/// Every query written is passed to the handler, which may queue responses
+/// at once or later from any thread.  native_fd() is readable while
+/// responses are queued, as a socket would be.
+class FakeDotConnection final : public TlsConnectionBase {
+public:
+    using Handler = std::function<void(FakeDotConnection &, std::vector<std::uint8_t> query)>;
+
+    explicit FakeDotConnection(Handler handler) : handler_(std::move(handler)) {
+        auto [read_end, write_end] = Utils::make_pipe();
+        readable_read_ = std::move(read_end);
+        readable_write_ = std::move(write_end);
+    }
+
+    std::expected<void, IoStatus> connect() override {
+        std::lock_guard lock(mutex_);
+        ++connects;
+        connected_ = true;
+        // A new connection starts a new stream.
+        if (!buffer_.empty()) {
+            buffer_.clear();
+            drain();
+        }
+        return {};
+    }
+
+    void close() noexcept override {
+        std::lock_guard lock(mutex_);
+        connected_ = false;
+    }
+
+    bool is_connected() const noexcept override {
+        std::lock_guard lock(mutex_);
+        return connected_;
+    }
+
+    bool is_healthy() const noexcept override { return true; }
+
+    int native_fd() const noexcept override { return readable_read_.get(); }
+
+    bool has_pending() const noexcept override { return false; }
+
+    std::expected<void, IoStatus> send_all(std::span<const std::uint8_t> data,
+                                           const Utils::CancellationToken &) override {
+        // The resolver writes one whole length-prefixed message at a time.
+        handler_(*this, {data.begin() + 2, data.end()});
+        return {};
+    }
+
+    std::expected<void, IoStatus> read_exact(std::span<std::uint8_t> buf,
+                                             const Utils::CancellationToken &) override {
+        std::lock_guard lock(mutex_);
+        if (buffer_.size() < buf.size()) {
+            return std::unexpected(IoStatus::ERROR);
+        }
+        std::copy_n(buffer_.begin(), buf.size(), buf.begin());
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(buf.size()));
+        if (buffer_.empty()) {
+            drain();
+        }
+        return {};
+    }
+
+    std::expected<size_t, IoStatus> read_some(std::span<std::uint8_t>, const Utils::CancellationToken &) override {
+        return std::unexpected(IoStatus::ERROR);
+    }
+
+    std::expected<void, IoStatus> shutdown() override { return {}; }
+
+    std::string negotiated_alpn() const noexcept override { return "dot"; }
+
+    void set_sni_hostname(std::string) override {}
+
+    /// Queue @p message, length-prefixed.
+    void respond(const std::vector<std::uint8_t> &message) {
+        std::lock_guard lock(mutex_);
+        if (buffer_.empty()) {
+            const std::uint8_t byte = 1;
+            [[maybe_unused]] auto written = ::write(readable_write_.get(), &byte, sizeof(byte));
+        }
+        buffer_.push_back(static_cast<std::uint8_t>(message.size() >> 8));
+        buffer_.push_back(static_cast<std::uint8_t>(message.size()));
+        buffer_.insert(buffer_.end(), message.begin(), message.end());
+    }
+
+    std::atomic<int> connects{0};
+
+private:
+    void drain() {
+        std::uint8_t byte = 0;
+        [[maybe_unused]] auto drained = ::read(readable_read_.get(), &byte, sizeof(byte));
+    }
+
+    Handler handler_;
+    mutable std::mutex mutex_;
+    bool connected_{false};
+    std::vector<std::uint8_t> buffer_;
+    Utils::UniqueFd readable_read_;
+    Utils::UniqueFd readable_write_;
+};
+
+/// The query echoed back as its response.
+std::vector<std::uint8_t> answer(std::vector<std::uint8_t> query) {
+    query[2] |= 0x80;
+    return query;
+}
+
+/// The first label of the question, e.g. "held" for "held.test".
+std::string first_label(const std::vector<std::uint8_t> &query) {
+    return {query.begin() + 13, query.begin() + 13 + query[12]};
+}
+
 // ---------------------------------------------------------------------------
 //  send_query error paths
 // ---------------------------------------------------------------------------
@@ -204,4 +331,138 @@ TEST(DotResolverMockTest, ConnectError_ReturnsConnection) {
     EXPECT_EQ(result.error().code, DnsError::CONNECTION);
 }
 
+// ---------------------------------------------------------------------------
+//  Pipelining
+// ---------------------------------------------------------------------------
+
+TEST(DotResolverPipelineTest, QueriesAreInFlightTogetherAndAnsweredOutOfOrder) {
+    // Nothing is answered until every query has been written, then all are
+    // answered in reverse order: only a pipelining resolver gets through.
+    constexpr std::size_t THREADS = 8;
+    std::vector<std::vector<std::uint8_t> > held;
+    auto conn = std::make_unique<FakeDotConnection>(
+        [&held](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+            held.push_back(std::move(query));
+            if (held.size() == THREADS) {
+                for (auto it = held.rbegin(); it != held.rend(); ++it) {
+                    self.respond(answer(*it));
+                }
+            }
+        });
+    auto &fake = *conn;
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    std::atomic<std::size_t> succeeded = 0;
+    {
+        std::vector<std::jthread> threads;
+        for (std::size_t i = 0; i < THREADS; ++i) {
+            threads.emplace_back([&, i] {
+                succeeded += resolver.query("host" + std::to_string(i) + ".test", RecordKind::A, no_cancel)
+                        .has_value();
+            });
+        }
+    }
+
+    EXPECT_EQ(succeeded, THREADS);
+    EXPECT_EQ(fake.connects, 1);
+}
+
+TEST(DotResolverPipelineTest, ConnectionIsReused) {
+    auto conn = std::make_unique<FakeDotConnection>([](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+        self.respond(answer(std::move(query)));
+    });
+    auto &fake = *conn;
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(resolver.query("yaddnsc.test", RecordKind::A, no_cancel).has_value());
+    }
+    EXPECT_EQ(fake.connects, 1);
+}
+
+TEST(DotResolverPipelineTest, UnsolicitedResponse_ReturnsParseAndReconnects) {
+    auto conn = std::make_unique<FakeDotConnection>([](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+        auto response = answer(std::move(query));
+        response[1] ^= 0x01; // some other transaction ID
+        self.respond(response);
+    });
+    auto &fake = *conn;
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, no_cancel);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::PARSE);
+    // The retry ran on a new connection.
+    EXPECT_EQ(fake.connects, 2);
+}
+
+TEST(DotResolverPipelineTest, ForeignQuestion_ReturnsParse) {
+    auto conn = std::make_unique<FakeDotConnection>([](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+        auto response = answer(std::move(query));
+        response[13] ^= 0x20; // same ID, another name
+        self.respond(response);
+    });
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, no_cancel);
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::PARSE);
+}
+
+TEST(DotResolverPipelineTest, UnansweredQueryDoesNotHoldUpOthers) {
+    auto conn = std::make_unique<FakeDotConnection>([](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+        if (first_label(query) != "stuck") {
+            self.respond(answer(std::move(query)));
+        }
+    });
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    std::jthread stuck([&resolver] {
+        auto result = resolver.query("stuck.test", RecordKind::A, no_cancel);
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error().code, DnsError::RETRY);
+    });
+    std::this_thread::sleep_for(50ms);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(resolver.query("yaddnsc.test", RecordKind::A, no_cancel).has_value());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 1s);
+}
+
+TEST(DotResolverPipelineTest, LateResponseToCancelledQueryIsDropped) {
+    // "held" is answered only after the next query arrives, just before it.
+    std::vector<std::uint8_t> held;
+    std::atomic<bool> held_sent = false;
+    auto conn = std::make_unique<FakeDotConnection>(
+        [&](FakeDotConnection &self, std::vector<std::uint8_t> query) {
+            if (first_label(query) == "held") {
+                held = std::move(query);
+                held_sent = true;
+                return;
+            }
+            self.respond(answer(held));
+            self.respond(answer(std::move(query)));
+        });
+    auto &fake = *conn;
+    DotResolver resolver("127.0.0.1", 1853, "fake:1853", std::move(conn));
+
+    const Utils::CancellationSource cancel;
+    std::jthread cancelled([&] {
+        auto result = resolver.query("held.test", RecordKind::A, cancel.token());
+        ASSERT_FALSE(result.has_value());
+        EXPECT_EQ(result.error().code, DnsError::CANCELLED);
+    });
+    while (!held_sent) {
+        std::this_thread::sleep_for(1ms);
+    }
+    cancel.trigger();
+    cancelled.join();
+
+    auto result = resolver.query("yaddnsc.test", RecordKind::A, no_cancel);
+    ASSERT_TRUE(result.has_value()) << result.error().message;
+    EXPECT_EQ(fake.connects, 1);
+}
+
 } // anonymous namespace
@@ -0,0 +1,305 @@
+//
+// Unit tests for src/dns/parser/message_view.cpp — zero-copy message views,
+// lazy name decompression, inline-capacity limits, and parse_strings (its
+// addresses, and its fallback for messages that exceed the limits).
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dns/parser/message_view.h"
+#include "dns/parser/parser.h"
+#include "exception/dns_lookup.h"
+#include "network/inet_address.h"
+
+namespace {
+    void put_u16(std::vector<std::uint8_t> &buf, std::uint16_t v) {
+        buf.push_back(static_cast<std::uint8_t>(v >> 8));
+        buf.push_back(static_cast<std::uint8_t>(v & 0xFF));
+    }
+
+    void put_u32(std::vector<std::uint8_t> &buf, std::uint32_t v) {
+        put_u16(buf, static_cast<std::uint16_t>(v >> 16));
+        put_u16(buf, static_cast<std::uint16_t>(v & 0xFFFF));
+    }
+
+    void encode_name(std::vector<std::uint8_t> &buf, std::string_view name) {
+        size_t pos = 0;
+        while (pos < name.size()) {
+            auto dot = name.find('.', pos);
+            if (dot == std::string_view::npos) dot = name.size();
+            buf.push_back(static_cast<std::uint8_t>(dot - pos));
+            buf.insert(buf.end(), name.begin() + static_cast<std::ptrdiff_t>(pos),
+                       name.begin() + static_cast<std::ptrdiff_t>(dot));
+            pos = dot + 1;
+        }
+        buf.push_back(0);
+    }
+
+    // Response to "WWW.Example.com" A with `count` A answers (192.0.2.1, ...),
+    // each named by a pointer to the question, and a trailing CNAME answer
+    // whose target is compressed against the question name.
+    std::vector<std::uint8_t> make_response(std::uint16_t count, std::uint8_t rcode = 0) {
+        std::vector<std::uint8_t> buf;
+        put_u16(buf, 0xBEEF);
+        buf.push_back(0x85); // QR, AA, RD
+        buf.push_back(static_cast<std::uint8_t>(0x80 | rcode)); // RA
+        put_u16(buf, 1);
+        put_u16(buf, static_cast<std::uint16_t>(count + 1));
+        put_u16(buf, 0);
+        put_u16(buf, 0);
+
+        encode_name(buf, "WWW.Example.com");
+        put_u16(buf, 1);
+        put_u16(buf, 1);
+
+        for (std::uint16_t i = 0; i < count; ++i) {
+            buf.insert(buf.end(), {0xC0, 0x0C});
+            put_u16(buf, 1);
+            put_u16(buf, 1);
+            put_u32(buf, 300U + i);
+            put_u16(buf, 4);
+            buf.insert(buf.end(), {192, 0, 2, static_cast<std::uint8_t>(i + 1)});
+        }
+
+        // CNAME "cdn.example.com": a label, then a pointer to "Example.com".
+        buf.insert(buf.end(), {0xC0, 0x0C});
+        put_u16(buf, 5);
+        put_u16(buf, 1);
+        put_u32(buf, 60);
+        put_u16(buf, 6);
+        buf.insert(buf.end(), {3, 'c', 'd', 'n', 0xC0, 0x10});
+        return buf;
+    }
+
+    // Header-only message with an EDNS0 OPT record carrying `extended_rcode`.
+    std::vector<std::uint8_t> make_edns_response(std::uint8_t extended_rcode) {
+        std::vector<std::uint8_t> buf;
+        put_u16(buf, 0x1234);
+        buf.push_back(0x81);
+        buf.push_back(0x80);
+        put_u16(buf, 0);
+        put_u16(buf, 0);
+        put_u16(buf, 0);
+        put_u16(buf, 1);
+        buf.push_back(0); // root NAME
+        put_u16(buf, 41); // OPT
+        put_u16(buf, 1232); // UDP payload size
+        put_u32(buf, static_cast<std::uint32_t>(extended_rcode) << 24);
+        put_u16(buf, 0);
+        return buf;
+    }
+} // anonymous namespace
+
+// ===========================================================================
+// MessageView
+// ===========================================================================
+
+TEST(MessageViewTest, Header_IsParsed) {
+    const auto response = make_response(1);
+    const DNS::MessageView view(response);
+
+    EXPECT_EQ(view.id(), 0xBEEF);
+    EXPECT_TRUE(view.qr());
+    EXPECT_TRUE(view.aa());
+    EXPECT_FALSE(view.tc());
+    EXPECT_TRUE(view.ra());
+    EXPECT_EQ(view.rcode(), DNS::Rcode::NOERROR);
+    EXPECT_EQ(view.wire().data(), response.data());
+}
+
+TEST(MessageViewTest, Sections_PointIntoTheWireBuffer) {
+    const auto response = make_response(2);
+    const DNS::MessageView view(response);
+
+    ASSERT_EQ(view.questions().size(), 1U);
+    EXPECT_EQ(view.questions()[0].qtype, 1);
+    EXPECT_EQ(view.questions()[0].qclass, 1);
+    EXPECT_EQ(view.questions()[0].qname.offset(), DNS::HEADER_SIZE);
+
+    ASSERT_EQ(view.answers().size(), 3U);
+    EXPECT_TRUE(view.authorities().empty());
+    EXPECT_TRUE(view.additionals().empty());
+
+    const auto &second = view.answers()[1];
+    EXPECT_EQ(second.type, 1);
+    EXPECT_EQ(second.ttl, 301U);
+    ASSERT_EQ(second.rdata.size(), 4U);
+    EXPECT_EQ(second.rdata.data(), response.data() + second.rdata_offset);
+    EXPECT_EQ(second.rdata[3], 2);
+}
+
+TEST(MessageViewTest, Names_AreDecompressedOnRequest) {
+    const auto response = make_response(1);
+    const DNS::MessageView view(response);
+
+    EXPECT_EQ(view.questions()[0].qname.to_string(), "WWW.Example.com");
+    EXPECT_EQ(view.answers()[0].name.to_string(), "WWW.Example.com");
+
+    const auto &cname = view.answers()[1];
+    EXPECT_EQ(DNS::NameView(response, cname.rdata_offset).to_string(), "cdn.Example.com");
+}
+
+TEST(MessageViewTest, NameEquals_IgnoresCaseAndTrailingDot) {
+    const auto response = make_response(1);
+    const auto name = DNS::MessageView(response).answers()[0].name;
+
+    EXPECT_TRUE(name.equals("www.example.com"));
+    EXPECT_TRUE(name.equals("WWW.EXAMPLE.COM."));
+    EXPECT_FALSE(name.equals("www.example.co"));
+    EXPECT_FALSE(name.equals("www.example.com.au"));
+    EXPECT_FALSE(name.equals("wwwexample.com"));
+    EXPECT_FALSE(name.equals("example.com"));
+    EXPECT_FALSE(name.equals(""));
+}
+
+TEST(MessageViewTest, LongLabels_AreDecompressedAndCompared) {
+    // Labels long enough to be compared a whole block at a time.
+    const std::string name = std::string(40, 'A') + "." + std::string(17, 'b') + ".Example.com";
+    std::vector<std::uint8_t> wire;
+    encode_name(wire, name);
+    const DNS::NameView view(wire, 0);
+
+    EXPECT_EQ(view.to_string(), name);
+    EXPECT_TRUE(view.equals(std::string(40, 'a') + "." + std::string(17, 'B') + ".example.com."));
+
+    auto differs = std::string(40, 'a') + "." + std::string(17, 'b') + ".example.com";
+    differs[35] = '@';
+    EXPECT_FALSE(view.equals(differs));
+}
+
+TEST(MessageViewTest, OverlongName_Throws) {
+    // 128 one-octet labels: 257 octets, over the 255-octet limit on a name.
+    std::vector<std::uint8_t> wire;
+    for (int i = 0; i < 128; ++i) {
+        wire.insert(wire.end(), {1, 'a'});
+    }
+    wire.push_back(0);
+    EXPECT_THROW(static_cast<void>(DNS::NameView(wire, 0).to_string()), DnsLookupException);
+
+    // 127 labels, 255 octets: the longest name there is.
+    wire.erase(wire.begin(), wire.begin() + 2);
+    EXPECT_EQ(DNS::NameView(wire, 0).to_string().size(), 253U);
+}
+
+TEST(MessageViewTest, RootName_IsEmpty) {
+    const std::vector<std::uint8_t> wire{0};
+    const DNS::NameView root(wire, 0);
+
+    EXPECT_EQ(root.to_string(), "");
+    EXPECT_TRUE(root.equals("."));
+    EXPECT_FALSE(root.equals("com"));
+    EXPECT_EQ(DNS::NameView::skip(wire, 0), 1U);
+}
+
+TEST(MessageViewTest, Skip_StopsAfterTheFirstPointer) {
+    const std::vector<std::uint8_t> wire{3, 'w', 'w', 'w', 0xC0, 0x00};
+    EXPECT_EQ(DNS::NameView::skip(wire, 0), 6U);
+}
+
+TEST(MessageViewTest, Skip_PointerPastWireEnd_Throws) {
+    const std::vector<std::uint8_t> wire{3, 'w', 'w', 'w', 0xC0, 0x40};
+    EXPECT_THROW(static_cast<void>(DNS::NameView::skip(wire, 0)), DnsLookupException);
+}
+
+TEST(MessageViewTest, PointerCycle_ThrowsOnlyWhenTheNameIsRead) {
+    auto response = make_response(1);
+    // Point the answer's owner name at itself.
+    const auto answer_name = DNS::MessageView(response).answers()[0].name.offset();
+    response[answer_name + 1] = static_cast<std::uint8_t>(answer_name);
+
+    const DNS::MessageView view(response);
+    EXPECT_EQ(view.answers()[0].rdata[3], 1);
+    EXPECT_THROW(static_cast<void>(view.answers()[0].name.to_string()), DnsLookupException);
+    EXPECT_THROW(static_cast<void>(view.answers()[0].name.equals("www.example.com")), DnsLookupException);
+}
+
+TEST(MessageViewTest, Edns0_ExtendedRcodeIsFoldedIn) {
+    const auto response = make_edns_response(1);
+    const DNS::MessageView view(response);
+
+    const auto opt = view.opt();
+    ASSERT_TRUE(opt.has_value());
+    EXPECT_EQ(opt->qclass, 1232);
+    EXPECT_EQ(view.rcode(), DNS::Rcode::BADVERS);
+}
+
+TEST(MessageViewTest, NoOpt_IsNullopt) {
+    const auto response = make_response(1);
+    EXPECT_FALSE(DNS::MessageView(response).opt().has_value());
+}
+
+TEST(MessageViewTest, TooShort_Throws) {
+    const std::vector<std::uint8_t> too_short(DNS::HEADER_SIZE - 1, 0);
+    EXPECT_THROW(DNS::MessageView{too_short}, DnsLookupException);
+}
+
+TEST(MessageViewTest, TruncatedRdata_Throws) {
+    auto response = make_response(1);
+    response.pop_back();
+    EXPECT_THROW(DNS::MessageView{response}, DnsLookupException);
+}
+
+TEST(MessageViewTest, TooManyRecords_DoesNotFit) {
+    const auto fits = make_response(DNS::MessageView::MAX_RECORDS - 1);
+    EXPECT_TRUE(DNS::MessageView::fits(fits));
+    EXPECT_NO_THROW(DNS::MessageView{fits});
+
+    const auto too_many = make_response(DNS::MessageView::MAX_RECORDS);
+    EXPECT_FALSE(DNS::MessageView::fits(too_many));
+    EXPECT_THROW(DNS::MessageView{too_many}, DnsLookupException);
+}
+
+// ===========================================================================
+// RecordParser::parse_strings — view fast path and fallback
+// ===========================================================================
+
+TEST(MessageViewTest, ParseStrings_MatchesFullParser) {
+    const auto response = make_response(3);
+    const auto parsed = DNS::RecordParser::parse_strings(response);
+
+    const DNS::RecordParser parser(response);
+    ASSERT_EQ(parsed.records.size(), parser.record_count());
+    for (size_t i = 0; i < parsed.records.size(); ++i) {
+        EXPECT_EQ(parsed.records[i], parser.parse_record(i));
+    }
+    EXPECT_EQ(parsed.records.back(), "cdn.Example.com");
+    EXPECT_EQ(parsed.ttl, 60U);
+}
+
+TEST(MessageViewTest, ParseStrings_TooManyRecords_FallsBackToFullParser) {
+    const auto response = make_response(DNS::MessageView::MAX_RECORDS + 8);
+    const auto parsed = DNS::RecordParser::parse_strings(response);
+
+    ASSERT_EQ(parsed.records.size(), DNS::MessageView::MAX_RECORDS + 9);
+    EXPECT_EQ(parsed.records[0], "192.0.2.1");
+    EXPECT_EQ(parsed.records[DNS::MessageView::MAX_RECORDS + 7], "192.0.2.40");
+    EXPECT_EQ(parsed.ttl, 60U);
+}
+
+TEST(MessageViewTest, ParseStrings_DecodesAddressesFromRdata) {
+    const auto parsed = DNS::RecordParser::parse_strings(make_response(2));
+
+    // The trailing CNAME has no address.
+    ASSERT_EQ(parsed.addresses.size(), 2U);
+    EXPECT_EQ(parsed.addresses[0], InetAddress(Inet4Address::from_bytes({192, 0, 2, 1})));
+    EXPECT_EQ(parsed.addresses[1], InetAddress(Inet4Address::from_bytes({192, 0, 2, 2})));
+}
+
+TEST(MessageViewTest, ParseStrings_Fallback_DecodesAddressesFromRdata) {
+    const auto parsed = DNS::RecordParser::parse_strings(make_response(DNS::MessageView::MAX_RECORDS + 8));
+
+    ASSERT_EQ(parsed.addresses.size(), DNS::MessageView::MAX_RECORDS + 8);
+    EXPECT_TRUE(parsed.addresses.spilled());
+    EXPECT_EQ(parsed.addresses.front(), InetAddress(Inet4Address::from_bytes({192, 0, 2, 1})));
+    EXPECT_EQ(parsed.addresses[DNS::MessageView::MAX_RECORDS + 7],
+              InetAddress(Inet4Address::from_bytes({192, 0, 2, 40})));
+}
+
+TEST(MessageViewTest, ParseStrings_ExtendedRcode) {
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_edns_response(1)).rcode, DNS::Rcode::BADVERS);
+}
@@ -8,6 +8,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <initializer_list>
 #include <string>
 #include <string_view>
 
@@ -1078,6 +1079,131 @@ TEST(DnsParserTest, ZeroAnswerCount_ReturnsEmptyResults) {
     EXPECT_EQ(parsed.rcode, DNS::Rcode::NOERROR);
 }
 
+// ===========================================================================
+// Cache TTL — lowest answer TTL, or the SOA negative TTL (RFC 2308 §5)
+// ===========================================================================
+
+namespace {
+    // "example.com" response with one A answer per TTL in `ttls`.
+    std::vector<std::uint8_t> make_a_answers(std::initializer_list<std::uint32_t> ttls) {
+        std::vector<std::uint8_t> buf;
+        buf.resize(12, 0);
+        write_u16_be(buf, 0, 0x1234);
+        buf[2] = 0x81;
+        buf[3] = 0x80;
+        write_u16_be(buf, 4, 1);
+        write_u16_be(buf, 6, static_cast<std::uint16_t>(ttls.size()));
+        encode_name(buf, "example.com");
+        buf.insert(buf.end(), {0x00, 0x01, 0x00, 0x01});
+        std::uint8_t last_octet = 1;
+        for (const auto ttl: ttls) {
+            buf.insert(buf.end(), {0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01});
+            write_u32_be_bytes(buf, ttl);
+            buf.insert(buf.end(), {0x00, 0x04, 192, 0, 2, last_octet++});
+        }
+        return buf;
+    }
+
+    // Negative "example.com" response (NXDOMAIN or NODATA) whose authority
+    // section holds the zone's SOA, unless `with_soa` is false.
+    std::vector<std::uint8_t> make_negative_response(std::uint8_t rcode, std::uint32_t soa_ttl,
+                                                     std::uint32_t minimum, bool with_soa = true) {
+        std::vector<std::uint8_t> buf;
+        buf.resize(12, 0);
+        write_u16_be(buf, 0, 0x1234);
+        buf[2] = 0x81;
+        buf[3] = static_cast<std::uint8_t>(0x80 | rcode);
+        write_u16_be(buf, 4, 1);
+        write_u16_be(buf, 8, with_soa ? 1 : 0);
+        encode_name(buf, "example.com");
+        buf.insert(buf.end(), {0x00, 0x01, 0x00, 0x01});
+        if (!with_soa) {
+            return buf;
+        }
+
+        buf.insert(buf.end(), {0xC0, 0x0C, 0x00, 0x06, 0x00, 0x01});
+        write_u32_be_bytes(buf, soa_ttl);
+        const auto rdlength_at = buf.size();
+        buf.insert(buf.end(), {0x00, 0x00});
+        const auto rdata_at = buf.size();
+        encode_name(buf, "ns.example.com");
+        encode_name(buf, "admin.example.com");
+        for (const std::uint32_t value: {2026081801U, 7200U, 3600U, 1209600U}) {
+            write_u32_be_bytes(buf, value);
+        }
+        write_u32_be_bytes(buf, minimum);
+        write_u16_be(buf, rdlength_at, static_cast<std::uint16_t>(buf.size() - rdata_at));
+        return buf;
+    }
+} // anonymous namespace
+
+TEST(DnsParserTest, Ttl_IsLowestAnswerTtl) {
+    const auto response = make_a_answers({600, 120, 3600});
+
+    EXPECT_EQ(DNS::RecordParser::parse_strings(response).ttl, 120U);
+    EXPECT_EQ(DNS::RecordParser::parse_response(response).ttl, 120U);
+}
+
+TEST(DnsParserTest, Ttl_Nxdomain_IsSoaNegativeTtl) {
+    // min(SOA TTL, SOA MINIMUM), whichever is lower.
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_negative_response(3, 3600, 60)).ttl, 60U);
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_negative_response(3, 30, 600)).ttl, 30U);
+    EXPECT_EQ(DNS::RecordParser::parse_response(make_negative_response(3, 3600, 60)).ttl, 60U);
+}
+
+TEST(DnsParserTest, Ttl_Nodata_IsSoaNegativeTtl) {
+    const auto parsed = DNS::RecordParser::parse_strings(make_negative_response(0, 900, 300));
+    EXPECT_TRUE(parsed.records.empty());
+    EXPECT_EQ(parsed.ttl, 300U);
+}
+
+TEST(DnsParserTest, Ttl_NegativeWithoutSoa_IsZero) {
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_negative_response(3, 0, 0, false)).ttl, 0U);
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_negative_response(0, 0, 0, false)).ttl, 0U);
+}
+
+TEST(DnsParserTest, Ttl_Servfail_IsZero) {
+    // An SOA does not make a server failure cacheable.
+    EXPECT_EQ(DNS::RecordParser::parse_strings(make_negative_response(2, 3600, 60)).ttl, 0U);
+}
+
+TEST(DnsParserTest, Ttl_TruncatedSoa_IsZeroAndKeepsRcode) {
+    auto response = make_negative_response(3, 3600, 60);
+    // Drop MINIMUM, keeping RDLENGTH consistent with the packet.
+    response.erase(response.end() - 4, response.end());
+    // Header, question, then NAME, TYPE, CLASS and TTL of the SOA.
+    const std::size_t rdlength_at = 12 + 13 + 4 + 2 + 2 + 2 + 4;
+    write_u16_be(response, rdlength_at, static_cast<std::uint16_t>(response.size() - rdlength_at - 2));
+
+    const auto parsed = DNS::RecordParser::parse_strings(response);
+    EXPECT_EQ(parsed.rcode, DNS::Rcode::NXDOMAIN);
+    EXPECT_EQ(parsed.ttl, 0U);
+    EXPECT_EQ(DNS::RecordParser::parse_response(response).rcode, DNS::Rcode::NXDOMAIN);
+}
+
+TEST(DnsParserTest, Ttl_ShortSoaRdata_IsZero) {
+    // MINIMUM lies past RDLENGTH, even though the packet holds the bytes.
+    auto response = make_negative_response(0, 3600, 60);
+    const std::size_t rdlength_at = 12 + 13 + 4 + 2 + 2 + 2 + 4;
+    write_u16_be(response, rdlength_at, static_cast<std::uint16_t>(response.size() - rdlength_at - 2 - 4));
+
+    const auto parsed = DNS::RecordParser::parse_strings(response);
+    EXPECT_EQ(parsed.rcode, DNS::Rcode::NOERROR);
+    EXPECT_EQ(parsed.ttl, 0U);
+}
+
+TEST(DnsParserTest, Ttl_SoaWithBadName_IsZeroAndKeepsRcode) {
+    auto response = make_negative_response(3, 3600, 60);
+    // Turn MNAME into a compression pointer past the end of the packet.
+    const std::size_t mname_at = 12 + 13 + 4 + 2 + 2 + 2 + 4 + 2;
+    response[mname_at] = 0xFF;
+    response[mname_at + 1] = 0xFF;
+
+    const auto parsed = DNS::RecordParser::parse_strings(response);
+    EXPECT_EQ(parsed.rcode, DNS::Rcode::NXDOMAIN);
+    EXPECT_EQ(parsed.ttl, 0U);
+}
+
 // ===========================================================================
 // parse_response with NOERROR but actual answers
 // ===========================================================================
@@ -0,0 +1,212 @@
+//
+// Unit tests for dns/wire/query_template.h — DNS::QueryTemplate and
+// DNS::QueryTemplateCache.
+//
+// Tests cover:
+//   - A template writes the message QueryBuilder builds, with the given ID
+//   - EDNS0 padding to a block multiple (RFC 7830), option layout
+//   - Writing behind a TCP/DoT length prefix; max_size()
+//   - Undersized output buffers and invalid names are rejected
+//   - The cache reuses templates per name and type, up to MAX_ENTRIES
+// =============================================================================
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dns/wire/builder.h"
+#include "dns/wire/query_template.h"
+#include "exception/dns_packet.h"
+
+namespace {
+
+    [[nodiscard]] std::uint16_t read_u16(std::span<const std::uint8_t> buf, size_t offset) {
+        return static_cast<std::uint16_t>((buf[offset] << 8) | buf[offset + 1]);
+    }
+
+    [[nodiscard]] std::vector<std::uint8_t> expected_query(const std::string &host, DNS::RecordType type,
+                                                           std::uint16_t id, std::uint16_t payload_size = 1232) {
+        return DNS::QueryBuilder{}.id(id).add_question(host, type).add_edns(payload_size).build();
+    }
+
+} // anonymous namespace
+
+// ===========================================================================
+//  QueryTemplate
+// ===========================================================================
+
+TEST(QueryTemplateTest, WritesTheBuilderQueryWithTheGivenId) {
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::AAAA);
+    const auto expected = expected_query("example.com", DNS::RecordType::AAAA, 0xBEEF);
+
+    std::array<std::uint8_t, 512> buf{};
+    const auto written = tmpl.write_to(buf, 0xBEEF);
+
+    EXPECT_EQ(tmpl.size(), expected.size());
+    EXPECT_EQ(tmpl.padding(), 0U);
+    EXPECT_EQ(written.data(), buf.data());
+    EXPECT_EQ(std::vector<std::uint8_t>(written.begin(), written.end()), expected);
+}
+
+TEST(QueryTemplateTest, WriteToReplacesOnlyTheId) {
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::A, {.udp_payload_size = 4096});
+
+    std::array<std::uint8_t, 512> first{};
+    std::array<std::uint8_t, 512> second{};
+    const auto a = tmpl.write_to(first, 0x0001);
+    const auto b = tmpl.write_to(second, 0xFFFF);
+
+    EXPECT_EQ(read_u16(a, 0), 0x0001);
+    EXPECT_EQ(read_u16(b, 0), 0xFFFF);
+    EXPECT_TRUE(std::ranges::equal(a.subspan(2), b.subspan(2)));
+    EXPECT_EQ(std::vector<std::uint8_t>(b.begin(), b.end()),
+              expected_query("example.com", DNS::RecordType::A, 0xFFFF, 4096));
+}
+
+TEST(QueryTemplateTest, WritesBehindALengthPrefix) {
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::A, {.udp_payload_size = 512, .pad_block = 128});
+
+    std::array<std::uint8_t, 512> buf{};
+    const auto framed = tmpl.write_to(buf, 0x4242, DNS::Framing::LENGTH_PREFIXED);
+
+    ASSERT_EQ(framed.size(), DNS::LENGTH_PREFIX_SIZE + tmpl.size());
+    EXPECT_EQ(read_u16(framed, 0), tmpl.size());
+    EXPECT_EQ(read_u16(framed, 2), 0x4242);
+
+    // Room for the message but not its prefix.
+    std::vector<std::uint8_t> unframed(tmpl.size());
+    EXPECT_THROW(static_cast<void>(tmpl.write_to(unframed, 1, DNS::Framing::LENGTH_PREFIXED)), DnsPacketException);
+}
+
+TEST(QueryTemplateTest, MaxSizeFitsTheLongestName) {
+    std::string longest;
+    for (int i = 0; i < 63; ++i) {
+        longest += "abc.";
+    }
+    longest += "x";
+    ASSERT_EQ(DNS::encoded_name_size(longest), DNS::MAX_NAME_SIZE);
+
+    for (const DNS::QueryTemplate::Layout layout: {DNS::QueryTemplate::Layout{},
+                                                   DNS::QueryTemplate::Layout{.udp_payload_size = 512,
+                                                                              .pad_block = 128}}) {
+        const DNS::QueryTemplate tmpl(longest, DNS::RecordType::AAAA, layout);
+        EXPECT_EQ(tmpl.size(), DNS::QueryTemplate::max_size(layout));
+    }
+    static_assert(DNS::QueryTemplate::max_size({.udp_payload_size = 512, .pad_block = 128}) == 384);
+}
+
+TEST(QueryTemplateTest, BuildMatchesTheBuilderApartFromTheId) {
+    const DNS::QueryTemplate tmpl("sub.example.org", DNS::RecordType::A);
+    const auto expected = expected_query("sub.example.org", DNS::RecordType::A, 0);
+
+    const auto packet = tmpl.build();
+    ASSERT_EQ(packet.size(), expected.size());
+    EXPECT_TRUE(std::ranges::equal(std::span(packet).subspan(2), std::span(expected).subspan(2)));
+}
+
+TEST(QueryTemplateTest, PadsToABlockMultiple) {
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::A, {.udp_payload_size = 512, .pad_block = 128});
+    const auto unpadded = expected_query("example.com", DNS::RecordType::A, 0, 512);
+
+    ASSERT_EQ(tmpl.size() % 128, 0U);
+    ASSERT_EQ(tmpl.size(), unpadded.size() + 4 + tmpl.padding());
+
+    const auto packet = tmpl.build();
+    ASSERT_EQ(packet.size(), tmpl.size());
+
+    // The OPT record's RDLENGTH now covers the Padding option ...
+    const auto rdlength_offset = unpadded.size() - 2;
+    EXPECT_EQ(read_u16(packet, rdlength_offset), 4 + tmpl.padding());
+
+    // ... which follows it: OPTION-CODE 12, OPTION-LENGTH, then the padding.
+    EXPECT_EQ(read_u16(packet, unpadded.size()), 12);
+    EXPECT_EQ(read_u16(packet, unpadded.size() + 2), tmpl.padding());
+
+    // Everything before the option but the ID and RDLENGTH is unchanged.
+    EXPECT_TRUE(std::ranges::equal(std::span(packet).subspan(2, rdlength_offset - 2),
+                                   std::span(unpadded).subspan(2, rdlength_offset - 2)));
+}
+
+TEST(QueryTemplateTest, PaddingAlwaysCarriesAtLeastOneOctet) {
+    const auto unpadded = expected_query("example.com", DNS::RecordType::A, 0, 512);
+
+    // A block the option would exactly fill still gains a whole block.
+    const auto block = unpadded.size() + 4;
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::A, {.udp_payload_size = 512, .pad_block = block});
+
+    EXPECT_EQ(tmpl.padding(), block);
+    EXPECT_EQ(tmpl.size(), 2 * block);
+}
+
+TEST(QueryTemplateTest, ThrowsOnUndersizedBuffer) {
+    const DNS::QueryTemplate tmpl("example.com", DNS::RecordType::A);
+
+    std::vector<std::uint8_t> buf(tmpl.size() - 1);
+    EXPECT_THROW(static_cast<void>(tmpl.write_to(buf, 1)), DnsPacketException);
+}
+
+TEST(QueryTemplateTest, ThrowsOnInvalidName) {
+    const std::string long_label(64, 'a');
+    EXPECT_THROW(DNS::QueryTemplate(long_label + ".com", DNS::RecordType::A), DnsPacketException);
+}
+
+// ===========================================================================
+//  QueryTemplateCache
+// ===========================================================================
+
+TEST(QueryTemplateCacheTest, ReusesTemplatesPerNameAndType) {
+    DNS::QueryTemplateCache cache;
+
+    const auto a = cache.get("example.com", DNS::RecordType::A);
+    const auto aaaa = cache.get("example.com", DNS::RecordType::AAAA);
+    const auto other = cache.get("example.org", DNS::RecordType::A);
+
+    EXPECT_EQ(cache.get("example.com", DNS::RecordType::A), a);
+    EXPECT_NE(a, aaaa);
+    EXPECT_NE(a, other);
+    EXPECT_EQ(cache.size(), 3U);
+}
+
+TEST(QueryTemplateCacheTest, AppliesTheLayout) {
+    DNS::QueryTemplateCache cache({.udp_payload_size = 512, .pad_block = 128});
+
+    const auto tmpl = cache.get("example.com", DNS::RecordType::A);
+    EXPECT_EQ(tmpl->size() % 128, 0U);
+    EXPECT_GT(tmpl->padding(), 0U);
+}
+
+TEST(QueryTemplateCacheTest, StopsKeepingTemplatesAtMaxEntries) {
+    DNS::QueryTemplateCache cache;
+    for (std::size_t i = 0; i < DNS::QueryTemplateCache::MAX_ENTRIES; ++i) {
+        static_cast<void>(cache.get("host" + std::to_string(i) + ".example.com", DNS::RecordType::A));
+    }
+    ASSERT_EQ(cache.size(), DNS::QueryTemplateCache::MAX_ENTRIES);
+
+    // Still usable past the limit, just not kept.
+    const auto first = cache.get("extra.example.com", DNS::RecordType::A);
+    const auto second = cache.get("extra.example.com", DNS::RecordType::A);
+    ASSERT_NE(first, nullptr);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first->size(), second->size());
+    EXPECT_EQ(cache.size(), DNS::QueryTemplateCache::MAX_ENTRIES);
+}
+
+TEST(QueryTemplateCacheTest, ClearDropsTemplatesButNotHeldOnes) {
+    DNS::QueryTemplateCache cache;
+    const auto held = cache.get("example.com", DNS::RecordType::A);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0U);
+    EXPECT_EQ(held->build().size(), held->size());
+    EXPECT_NE(cache.get("example.com", DNS::RecordType::A), held);
+}
+
+TEST(QueryTemplateCacheTest, InvalidNameThrowsAndIsNotKept) {
+    DNS::QueryTemplateCache cache;
+    EXPECT_THROW(static_cast<void>(cache.get(std::string(64, 'a') + ".com", DNS::RecordType::A)),
+                 DnsPacketException);
+    EXPECT_EQ(cache.size(), 0U);
+}
@@ -0,0 +1,352 @@
+//
+// Unit tests for ResolverEngine — the persistent query engine behind the
+// native ResolverDispatcher.
+//
+// Verifies:
+//   - Resolvers with start_query() run on the engine thread only, with no
+//     worker threads, however many queries are in flight.
+//   - Blocking resolvers share a capped set of persistent workers.
+//   - Results are classified by RCODE before delivery.
+//   - cancel() abandons reactor-driven queries and wakes blocked workers,
+//     and a worker's cancellation pipe is clean for its next job.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver/base.h"
+#include "dns/resolver_engine.h"
+#include "dns_error.h"
+#include "network/reactor.h"
+#include "record_kind.h"
+#include "util/cancellation_token.hpp"
+#include "util/task.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// "example.com" A 192.168.1.1, with the RCODE in the low nibble of byte 3.
+std::vector<std::uint8_t> make_response(std::uint8_t rcode = 0, bool with_answer = true) {
+    std::vector<std::uint8_t> buf{0x12, 0x34, 0x81, static_cast<std::uint8_t>(0x80 | rcode),
+                                  0x00, 0x01, 0x00, static_cast<std::uint8_t>(with_answer ? 1 : 0),
+                                  0x00, 0x00, 0x00, 0x00};
+    for (const std::string_view label: {"example", "com"}) {
+        buf.push_back(static_cast<std::uint8_t>(label.size()));
+        buf.insert(buf.end(), label.begin(), label.end());
+    }
+    buf.insert(buf.end(), {0x00, 0x00, 0x01, 0x00, 0x01});
+    if (with_answer) {
+        buf.insert(buf.end(), {0xC0, 0x0C, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x01, 0x2C, 0x00, 0x04,
+                               192, 168, 1, 1});
+    }
+    return buf;
+}
+
+// Answers from a reactor timer, like the native classic resolver does from
+// socket readiness.
+class ReactorResolver : public ResolverBase {
+public:
+    explicit ReactorResolver(std::chrono::milliseconds delay = 1ms, std::vector<std::uint8_t> response = make_response())
+        : delay_(delay), response_(std::move(response)) {}
+
+    [[nodiscard]] QueryResult query(const std::string &, RecordKind, const Utils::CancellationToken &) const override {
+        ADD_FAILURE() << "blocking query() used for a reactor-driven resolver";
+        return std::unexpected(DnsErrorInfo{DnsError::UNKNOWN, "blocking"});
+    }
+
+    [[nodiscard]] std::unique_ptr<PendingQuery> start_query(Reactor &reactor, const std::string &, RecordKind,
+                                                            QueryCallback on_done) const override {
+        {
+            std::lock_guard lock(mutex_);
+            threads_.insert(std::this_thread::get_id());
+        }
+        ++started_;
+        const auto timer = reactor.add_timer(delay_, [on_done = std::move(on_done), response = response_] {
+            on_done(response);
+        });
+        return std::make_unique<Pending>(reactor, timer, abandoned_);
+    }
+
+    [[nodiscard]] std::string_view get_type() const noexcept override { return "Reactor"; }
+
+    [[nodiscard]] std::set<std::thread::id> threads() const {
+        std::lock_guard lock(mutex_);
+        return threads_;
+    }
+
+    [[nodiscard]] int started() const noexcept { return started_; }
+
+    [[nodiscard]] int abandoned() const noexcept { return abandoned_; }
+
+private:
+    class Pending final : public PendingQuery {
+    public:
+        Pending(Reactor &reactor, Reactor::TimerId timer, std::atomic<int> &abandoned)
+            : reactor_(reactor), timer_(timer), abandoned_(abandoned) {}
+
+        ~Pending() override {
+            if (reactor_.cancel_timer(timer_)) {
+                ++abandoned_;
+            }
+        }
+
+    private:
+        Reactor &reactor_;
+        Reactor::TimerId timer_;
+        std::atomic<int> &abandoned_;
+    };
+
+    std::chrono::milliseconds delay_;
+    std::vector<std::uint8_t> response_;
+    mutable std::mutex mutex_;
+    mutable std::set<std::thread::id> threads_;
+    mutable std::atomic<int> started_{0};
+    mutable std::atomic<int> abandoned_{0};
+};
+
+// Blocks in query() until cancelled through its token or @p wait elapses.
+class BlockingResolver : public ResolverBase {
+public:
+    explicit BlockingResolver(std::chrono::milliseconds wait = 0ms) : wait_(wait) {}
+
+    [[nodiscard]] QueryResult query(const std::string &, RecordKind,
+                                    const Utils::CancellationToken &cancel_token) const override {
+        ++started_;
+        ::pollfd pfd{cancel_token.native_handle(), POLLIN, 0};
+        if (::poll(&pfd, 1, static_cast<int>(wait_.count())) > 0) {
+            ++cancelled_;
+            return std::unexpected(DnsErrorInfo{DnsError::CANCELLED, "cancelled"});
+        }
+        return make_response();
+    }
+
+    [[nodiscard]] std::string_view get_type() const noexcept override { return "Blocking"; }
+
+    [[nodiscard]] int started() const noexcept { return started_; }
+
+    [[nodiscard]] int cancelled() const noexcept { return cancelled_; }
+
+private:
+    std::chrono::milliseconds wait_;
+    mutable std::atomic<int> started_{0};
+    mutable std::atomic<int> cancelled_{0};
+};
+
+class ThrowingResolver : public ResolverBase {
+public:
+    [[nodiscard]] QueryResult query(const std::string &, RecordKind, const Utils::CancellationToken &) const override {
+        throw std::runtime_error("boom");
+    }
+
+    [[nodiscard]] std::unique_ptr<PendingQuery> start_query(Reactor &, const std::string &, RecordKind,
+                                                            QueryCallback) const override {
+        throw std::runtime_error("boom");
+    }
+
+    [[nodiscard]] std::string_view get_type() const noexcept override { return "Throwing"; }
+};
+
+Utils::Task<ResolverEngine::Result> query_on(ResolverEngine &engine, const ResolverBase &resolver) {
+    co_await engine.schedule();
+    EXPECT_TRUE(engine.on_engine_thread());
+    const std::string host = "example.com";
+    co_return co_await engine.query(resolver, host, RecordKind::A);
+}
+
+// Run @p fn on the engine thread and wait for it.
+template<typename Fn>
+auto on_engine(ResolverEngine &engine, Fn fn) {
+    std::packaged_task<std::invoke_result_t<Fn &>()> task(std::move(fn));
+    auto result = task.get_future();
+    engine.post([&task] { task(); });
+    return result.get();
+}
+
+// Poll @p done until it holds or @p limit elapses.
+bool eventually(const std::function<bool()> &done, std::chrono::milliseconds limit = 2s) {
+    const auto deadline = std::chrono::steady_clock::now() + limit;
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+} // namespace
+
+// ── Reactor-driven resolvers ─────────────────────────────────────────────────
+
+TEST(ResolverEngineTest, ReactorQueriesShareTheEngineThread) {
+    ResolverEngine engine;
+    const ReactorResolver resolver(5ms);
+
+    std::vector<Utils::Task<ResolverEngine::Result> > queries;
+    for (int i = 0; i < 100; ++i) {
+        queries.push_back(query_on(engine, resolver));
+    }
+    const auto results = Utils::sync_wait(Utils::when_all(std::move(queries)));
+
+    ASSERT_EQ(results.size(), 100U);
+    for (const auto &result: results) {
+        ASSERT_TRUE(result.has_value());
+        EXPECT_EQ(result->records, (std::vector<std::string>{"192.168.1.1"}));
+    }
+    EXPECT_EQ(resolver.started(), 100);
+    ASSERT_EQ(resolver.threads().size(), 1U);
+    EXPECT_NE(*resolver.threads().begin(), std::this_thread::get_id());
+    EXPECT_EQ(engine.worker_count(), 0U);
+    EXPECT_FALSE(engine.on_engine_thread());
+}
+
+TEST(ResolverEngineTest, ResultIsClassifiedByRcode) {
+    ResolverEngine engine;
+    const ReactorResolver nxdomain(1ms, make_response(3, false));
+    const ReactorResolver nodata(1ms, make_response(0, false));
+
+    const auto nx = Utils::sync_wait(query_on(engine, nxdomain));
+    ASSERT_FALSE(nx.has_value());
+    EXPECT_EQ(nx.error().code, DnsError::NX_DOMAIN);
+
+    const auto empty = Utils::sync_wait(query_on(engine, nodata));
+    ASSERT_FALSE(empty.has_value());
+    EXPECT_EQ(empty.error().code, DnsError::NODATA);
+}
+
+TEST(ResolverEngineTest, AnswerCarriesTheRecordTtl) {
+    ResolverEngine engine;
+    const ReactorResolver resolver;
+
+    const auto result = Utils::sync_wait(query_on(engine, resolver));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->ttl, 300U);
+}
+
+TEST(ResolverEngineTest, CancelAbandonsReactorQuery) {
+    ResolverEngine engine;
+    const ReactorResolver resolver(10s);
+    std::atomic<bool> called = false;
+
+    on_engine(engine, [&] {
+        const auto id = engine.start(resolver, "example.com", RecordKind::A, [&](auto) { called = true; });
+        EXPECT_EQ(engine.pending_count(), 1U);
+        engine.cancel(id);
+        engine.cancel(id);
+        EXPECT_EQ(engine.pending_count(), 0U);
+    });
+
+    EXPECT_EQ(resolver.abandoned(), 1);
+    EXPECT_FALSE(called);
+}
+
+TEST(ResolverEngineTest, StartQueryExceptionIsReported) {
+    ResolverEngine engine;
+    const ThrowingResolver resolver;
+
+    const auto result = Utils::sync_wait(query_on(engine, resolver));
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::UNKNOWN);
+}
+
+// ── Blocking resolvers ───────────────────────────────────────────────────────
+
+TEST(ResolverEngineTest, BlockingQueriesReuseAPersistentWorker) {
+    ResolverEngine engine;
+    const BlockingResolver resolver;
+
+    for (int i = 0; i < 20; ++i) {
+        const auto result = Utils::sync_wait(query_on(engine, resolver));
+        ASSERT_TRUE(result.has_value());
+    }
+    EXPECT_EQ(resolver.started(), 20);
+    EXPECT_EQ(engine.worker_count(), 1U);
+}
+
+TEST(ResolverEngineTest, WorkerCountIsCapped) {
+    ResolverEngine engine(2);
+    const BlockingResolver resolver(20ms);
+
+    std::vector<Utils::Task<ResolverEngine::Result> > queries;
+    for (int i = 0; i < 6; ++i) {
+        queries.push_back(query_on(engine, resolver));
+    }
+    for (const auto &result: Utils::sync_wait(Utils::when_all(std::move(queries)))) {
+        EXPECT_TRUE(result.has_value());
+    }
+    EXPECT_EQ(engine.worker_count(), 2U);
+}
+
+TEST(ResolverEngineTest, CancelWakesBlockedWorkerAndLeavesItClean) {
+    ResolverEngine engine(1);
+    const BlockingResolver slow(10s);
+    std::atomic<bool> called = false;
+
+    const auto id = on_engine(engine, [&] {
+        return engine.start(slow, "example.com", RecordKind::A, [&](auto) { called = true; });
+    });
+    ASSERT_TRUE(eventually([&] { return slow.started() == 1; }));
+
+    const auto start = std::chrono::steady_clock::now();
+    on_engine(engine, [&] { engine.cancel(id); });
+    ASSERT_TRUE(eventually([&] { return slow.cancelled() == 1; }));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+
+    // The same worker runs the next job without a stale cancellation.
+    const BlockingResolver next(50ms);
+    const auto result = Utils::sync_wait(query_on(engine, next));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(next.cancelled(), 0);
+    EXPECT_EQ(engine.worker_count(), 1U);
+    EXPECT_FALSE(called);
+}
+
+TEST(ResolverEngineTest, BlockingQueryExceptionIsReported) {
+    ResolverEngine engine;
+
+    class ThrowingBlockingResolver : public ThrowingResolver {
+    public:
+        [[nodiscard]] std::unique_ptr<PendingQuery> start_query(Reactor &, const std::string &, RecordKind,
+                                                                QueryCallback) const override {
+            return nullptr;
+        }
+    };
+    const ThrowingBlockingResolver resolver;
+
+    const auto result = Utils::sync_wait(query_on(engine, resolver));
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error().code, DnsError::UNKNOWN);
+    EXPECT_EQ(engine.worker_count(), 1U);
+}
+
+// ── Lifetime ─────────────────────────────────────────────────────────────────
+
+TEST(ResolverEngineTest, DestroyWithQueriesInFlight) {
+    const ReactorResolver reactor_resolver(10s);
+    const BlockingResolver blocking(10s);
+    {
+        ResolverEngine engine;
+        on_engine(engine, [&] {
+            [[maybe_unused]] auto a = engine.start(reactor_resolver, "example.com", RecordKind::A, [](auto) {});
+            [[maybe_unused]] auto b = engine.start(blocking, "example.com", RecordKind::A, [](auto) {});
+        });
+        ASSERT_TRUE(eventually([&] { return blocking.started() == 1; }));
+    }
+    EXPECT_EQ(reactor_resolver.abandoned(), 1);
+    EXPECT_EQ(blocking.cancelled(), 1);
+}
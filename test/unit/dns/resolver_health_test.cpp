@@ -0,0 +1,136 @@
+//
+// Unit tests for src/dns/resolver_health.cpp — smoothed RTT, error rate,
+// scoring and ranking of resolvers, and the percentile hedge delay.
+// =============================================================================
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver_health.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+TEST(ResolverHealthTest, Unknown_HasNoStatsAndScoresZero) {
+    const ResolverHealth health;
+    EXPECT_FALSE(health.stats(1).has_value());
+    EXPECT_EQ(health.score(1), 0.0);
+    EXPECT_EQ(health.hedge_delay(1), ResolverHealth::DEFAULT_HEDGE_DELAY);
+}
+
+TEST(ResolverHealthTest, FirstSample_SeedsSmoothedRtt) {
+    ResolverHealth health;
+    health.record_success(1, 40ms);
+
+    const auto stats = health.stats(1);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->srtt, 40ms);
+    EXPECT_EQ(stats->samples, 1U);
+    EXPECT_EQ(stats->error_rate, 0.0);
+}
+
+TEST(ResolverHealthTest, LaterSamples_MoveRttByOneEighth) {
+    ResolverHealth health;
+    health.record_success(1, 40ms);
+    health.record_success(1, 120ms);
+
+    EXPECT_EQ(health.stats(1)->srtt, 50ms);
+}
+
+TEST(ResolverHealthTest, Failures_RaiseErrorRateAndScore) {
+    ResolverHealth health;
+    health.record_success(1, 10ms);
+    health.record_success(2, 10ms);
+    health.record_failure(2);
+
+    EXPECT_NEAR(health.stats(2)->error_rate, ResolverHealth::ERROR_GAIN, 1e-9);
+    EXPECT_GT(health.score(2), health.score(1));
+
+    // Successes let the error rate decay again.
+    health.record_success(2, 10ms);
+    EXPECT_LT(health.stats(2)->error_rate, ResolverHealth::ERROR_GAIN);
+}
+
+TEST(ResolverHealthTest, OnlyFailures_ScoresWorseThanASlowResolver) {
+    ResolverHealth health;
+    health.record_failure(1);
+    health.record_success(2, 500ms);
+
+    EXPECT_GT(health.score(1), health.score(2));
+}
+
+TEST(ResolverHealthTest, Rank_PutsFastestFirstAndUnmeasuredBeforeAll) {
+    ResolverHealth health;
+    health.record_success(10, 200ms);
+    health.record_success(20, 5ms);
+    health.record_success(30, 50ms);
+
+    const std::array<std::uint64_t, 4> ids{10, 20, 30, 40};
+    EXPECT_EQ(health.rank(ids), (std::vector<std::size_t>{3, 1, 2, 0}));
+}
+
+TEST(ResolverHealthTest, Rank_ShufflesTies) {
+    const ResolverHealth health;
+    const std::array<std::uint64_t, 4> ids{1, 2, 3, 4};
+
+    // 4! orders; the chance of 64 identical draws is negligible.
+    const auto first = health.rank(ids);
+    bool varied = false;
+    for (int i = 0; i < 64 && !varied; ++i) {
+        varied = health.rank(ids) != first;
+    }
+    EXPECT_TRUE(varied);
+}
+
+TEST(ResolverHealthTest, HedgeDelay_DefaultUntilEnoughSamples) {
+    ResolverHealth health;
+    for (std::size_t i = 1; i < ResolverHealth::MIN_SAMPLES; ++i) {
+        health.record_success(1, 20ms);
+    }
+    EXPECT_EQ(health.hedge_delay(1), ResolverHealth::DEFAULT_HEDGE_DELAY);
+
+    health.record_success(1, 20ms);
+    EXPECT_EQ(health.hedge_delay(1), 20ms);
+}
+
+TEST(ResolverHealthTest, HedgeDelay_IsHighPercentileOfRecentRtts) {
+    ResolverHealth health;
+    // 19 fast answers and one slow one: the 95th percentile is still fast.
+    for (int i = 0; i < 19; ++i) {
+        health.record_success(1, 10ms);
+    }
+    health.record_success(1, 400ms);
+    EXPECT_EQ(health.hedge_delay(1), 10ms);
+
+    // A second slow answer moves it to the slow tail.
+    health.record_success(1, 400ms);
+    EXPECT_EQ(health.hedge_delay(1), 400ms);
+}
+
+TEST(ResolverHealthTest, HedgeDelay_ForgetsSamplesOutsideTheWindow) {
+    ResolverHealth health;
+    for (std::size_t i = 0; i < ResolverHealth::WINDOW; ++i) {
+        health.record_success(1, 800ms);
+    }
+    for (std::size_t i = 0; i < ResolverHealth::WINDOW; ++i) {
+        health.record_success(1, 30ms);
+    }
+    EXPECT_EQ(health.hedge_delay(1), 30ms);
+}
+
+TEST(ResolverHealthTest, HedgeDelay_IsClamped) {
+    ResolverHealth health;
+    for (std::size_t i = 0; i < ResolverHealth::MIN_SAMPLES; ++i) {
+        health.record_success(1, 100us);
+        health.record_success(2, 5s);
+    }
+    EXPECT_EQ(health.hedge_delay(1), ResolverHealth::MIN_HEDGE_DELAY);
+    EXPECT_EQ(health.hedge_delay(2), ResolverHealth::MAX_HEDGE_DELAY);
+}
+
+} // anonymous namespace
@@ -0,0 +1,99 @@
+//
+// Unit tests for src/dns/resolver/rtt_estimator.cpp — RFC 6298 SRTT, RTTVAR
+// and RTO from RTT samples, clamping, and backoff on timeouts.
+// =============================================================================
+
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "dns/resolver/rtt_estimator.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+TEST(RttEstimatorTest, NoSamples_UsesInitialRto) {
+    const RttEstimator rtt;
+    EXPECT_EQ(rtt.rto(), RttEstimator::INITIAL_RTO);
+    EXPECT_FALSE(rtt.srtt().has_value());
+}
+
+TEST(RttEstimatorTest, FirstSample_SetsSrttAndHalfOfItAsVariance) {
+    RttEstimator rtt;
+    rtt.sample(100ms);
+
+    EXPECT_EQ(rtt.srtt(), 100ms);
+    // SRTT + 4 * RTTVAR = 100 + 4 * 50.
+    EXPECT_EQ(rtt.rto(), 300ms);
+}
+
+TEST(RttEstimatorTest, SteadySamples_ShrinkTheVariance) {
+    RttEstimator rtt;
+    rtt.sample(100ms);
+    rtt.sample(100ms);
+
+    EXPECT_EQ(rtt.srtt(), 100ms);
+    // RTTVAR = 3/4 * 50 + 1/4 * 0.
+    EXPECT_EQ(rtt.rto(), 250ms);
+}
+
+TEST(RttEstimatorTest, LaterSamples_MoveSrttByOneEighth) {
+    RttEstimator rtt;
+    rtt.sample(80ms);
+    rtt.sample(160ms);
+
+    EXPECT_EQ(rtt.srtt(), 90ms);
+}
+
+TEST(RttEstimatorTest, LanServer_IsClampedToMinimum) {
+    RttEstimator rtt;
+    for (int i = 0; i < 8; ++i) {
+        rtt.sample(300us);
+    }
+    EXPECT_EQ(rtt.rto(), RttEstimator::MIN_RTO);
+}
+
+TEST(RttEstimatorTest, SlowLink_IsClampedToMaximum) {
+    RttEstimator rtt;
+    rtt.sample(700ms);
+    EXPECT_EQ(rtt.rto(), RttEstimator::MAX_RTO);
+
+    // A steady 700 ms link settles well above its RTT.
+    for (int i = 0; i < 32; ++i) {
+        rtt.sample(700ms);
+    }
+    EXPECT_GT(rtt.rto(), 700ms);
+    EXPECT_LT(rtt.rto(), RttEstimator::MAX_RTO);
+}
+
+TEST(RttEstimatorTest, Backoff_DoublesTheExpiredTimeout) {
+    RttEstimator rtt;
+    rtt.sample(100ms);
+    ASSERT_EQ(rtt.rto(), 300ms);
+
+    rtt.backoff(300ms);
+    EXPECT_EQ(rtt.rto(), 600ms);
+
+    // Another query sent with the old RTO timing out too backs off no further.
+    rtt.backoff(300ms);
+    EXPECT_EQ(rtt.rto(), 600ms);
+
+    rtt.backoff(600ms);
+    EXPECT_EQ(rtt.rto(), 1200ms);
+
+    rtt.backoff(1200ms);
+    EXPECT_EQ(rtt.rto(), RttEstimator::MAX_RTO);
+}
+
+TEST(RttEstimatorTest, Sample_ReplacesBackedOffRto) {
+    RttEstimator rtt;
+    rtt.sample(100ms);
+    rtt.backoff(300ms);
+    ASSERT_EQ(rtt.rto(), 600ms);
+
+    rtt.sample(100ms);
+    EXPECT_EQ(rtt.rto(), 250ms);
+}
+
+} // anonymous namespace
@@ -0,0 +1,250 @@
+//
+// Unit tests for src/http/hpack.cpp — HPACK header compression (RFC 7541).
+//
+// Decoding is checked against the header block examples of RFC 7541
+// Appendix C, which carry state through the dynamic table from one block to
+// the next; encoding by round-tripping through the decoder.
+// =============================================================================
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "http/hpack.h"
+
+namespace {
+
+using Http::Hpack::Decoder;
+using Http::Hpack::Header;
+
+[[nodiscard]] std::vector<std::uint8_t> from_hex(std::string_view hex) {
+    std::vector<std::uint8_t> out;
+    for (std::size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<std::uint8_t>(std::stoi(std::string(hex.substr(i, 2)), nullptr, 16)));
+    }
+    return out;
+}
+
+// =============================================================================
+//  RFC 7541 C.3 / C.4 — requests, without and with Huffman coding
+// =============================================================================
+
+TEST(HpackDecoderTest, Rfc7541_C3_RequestsWithoutHuffman) {
+    Decoder decoder;
+
+    auto first = decoder.decode(from_hex("828684410f7777772e6578616d706c652e636f6d"));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, (std::vector<Header>{
+        {":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"}}));
+    EXPECT_EQ(decoder.table_size(), 57U);
+
+    auto second = decoder.decode(from_hex("828684be58086e6f2d6361636865"));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(*second, (std::vector<Header>{
+        {":method", "GET"}, {":scheme", "http"}, {":path", "/"}, {":authority", "www.example.com"},
+        {"cache-control", "no-cache"}}));
+    EXPECT_EQ(decoder.table_size(), 110U);
+
+    auto third = decoder.decode(from_hex("828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565"));
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(*third, (std::vector<Header>{
+        {":method", "GET"}, {":scheme", "https"}, {":path", "/index.html"}, {":authority", "www.example.com"},
+        {"custom-key", "custom-value"}}));
+    EXPECT_EQ(decoder.table_size(), 164U);
+    EXPECT_EQ(decoder.table_entries(), 3U);
+}
+
+TEST(HpackDecoderTest, Rfc7541_C4_RequestsWithHuffman) {
+    Decoder decoder;
+
+    auto first = decoder.decode(from_hex("828684418cf1e3c2e5f23a6ba0ab90f4ff"));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->back(), (Header{":authority", "www.example.com"}));
+    EXPECT_EQ(decoder.table_size(), 57U);
+
+    auto second = decoder.decode(from_hex("828684be5886a8eb10649cbf"));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->back(), (Header{"cache-control", "no-cache"}));
+    EXPECT_EQ(decoder.table_size(), 110U);
+
+    auto third = decoder.decode(from_hex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf"));
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(third->back(), (Header{"custom-key", "custom-value"}));
+    EXPECT_EQ(decoder.table_size(), 164U);
+}
+
+// =============================================================================
+//  RFC 7541 C.6 — responses with Huffman coding and eviction
+// =============================================================================
+
+TEST(HpackDecoderTest, Rfc7541_C6_ResponsesWithEviction) {
+    Decoder decoder(256);
+
+    auto first = decoder.decode(from_hex(
+        "488264025885aec3771a4b6196d07abe941054d444a8200595040b8166e082a62d1bff"
+        "6e919d29ad171863c78f0b97c8e9ae82ae43d3"));
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(*first, (std::vector<Header>{
+        {":status", "302"}, {"cache-control", "private"}, {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}}));
+    EXPECT_EQ(decoder.table_size(), 222U);
+
+    // ":status 307" evicts ":status 302".
+    auto second = decoder.decode(from_hex("4883640effc1c0bf"));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(*second, (std::vector<Header>{
+        {":status", "307"}, {"cache-control", "private"}, {"date", "Mon, 21 Oct 2013 20:13:21 GMT"},
+        {"location", "https://www.example.com"}}));
+    EXPECT_EQ(decoder.table_size(), 222U);
+
+    auto third = decoder.decode(from_hex(
+        "88c16196d07abe941054d444a8200595040b8166e084a62d1bffc05a839bd9ab77ad94e7821dd7f2e6c7b335dfdfcd5b3960"
+        "d5af27087f3672c1ab270fb5291f9587316065c003ed4ee5b1063d5007"));
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(*third, (std::vector<Header>{
+        {":status", "200"}, {"cache-control", "private"}, {"date", "Mon, 21 Oct 2013 20:13:22 GMT"},
+        {"location", "https://www.example.com"}, {"content-encoding", "gzip"},
+        {"set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1"}}));
+    EXPECT_EQ(decoder.table_size(), 215U);
+    EXPECT_EQ(decoder.table_entries(), 3U);
+}
+
+// =============================================================================
+//  Table size updates
+// =============================================================================
+
+TEST(HpackDecoderTest, TableSizeUpdate_EvictsEntries) {
+    Decoder decoder;
+    ASSERT_TRUE(decoder.decode(from_hex("828684410f7777772e6578616d706c652e636f6d")).has_value());
+    ASSERT_EQ(decoder.table_entries(), 1U);
+
+    // Size 0, then a field: the table is emptied.
+    auto result = decoder.decode(from_hex("2082"));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(decoder.table_entries(), 0U);
+    EXPECT_EQ(decoder.table_size(), 0U);
+}
+
+TEST(HpackDecoderTest, TableSizeUpdate_AboveLimit_Fails) {
+    Decoder decoder(256);
+    // 5-bit prefix integer 4096 = 3f e1 1f.
+    auto result = decoder.decode(from_hex("3fe11f82"));
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), Http::Error::COMPRESSION_FAILED);
+}
+
+TEST(HpackDecoderTest, TableSizeUpdate_AfterField_Fails) {
+    Decoder decoder;
+    auto result = decoder.decode(from_hex("8220"));
+    ASSERT_FALSE(result.has_value());
+    EXPECT_EQ(result.error(), Http::Error::COMPRESSION_FAILED);
+}
+
+// =============================================================================
+//  Malformed blocks
+// =============================================================================
+
+TEST(HpackDecoderTest, IndexZero_Fails) {
+    Decoder decoder;
+    EXPECT_FALSE(decoder.decode(from_hex("80")).has_value());
+}
+
+TEST(HpackDecoderTest, IndexBeyondTables_Fails) {
+    Decoder decoder;
+    // 62 is the first dynamic index, and the table is empty.
+    EXPECT_FALSE(decoder.decode(from_hex("be")).has_value());
+}
+
+TEST(HpackDecoderTest, TruncatedString_Fails) {
+    Decoder decoder;
+    // Literal, new name of 15 bytes with only 3 present.
+    EXPECT_FALSE(decoder.decode(from_hex("000f616263")).has_value());
+}
+
+TEST(HpackDecoderTest, TruncatedInteger_Fails) {
+    Decoder decoder;
+    EXPECT_FALSE(decoder.decode(from_hex("ff")).has_value());
+}
+
+TEST(HpackDecoderTest, OverlongInteger_Fails) {
+    Decoder decoder;
+    EXPECT_FALSE(decoder.decode(from_hex("ffffffffffffff7f")).has_value());
+}
+
+// =============================================================================
+//  Huffman decoding
+// =============================================================================
+
+TEST(HpackHuffmanTest, DecodesRfcExample) {
+    auto result = Http::Hpack::huffman_decode(from_hex("f1e3c2e5f23a6ba0ab90f4ff"));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(*result, "www.example.com");
+}
+
+TEST(HpackHuffmanTest, EmptyInput_DecodesEmpty) {
+    auto result = Http::Hpack::huffman_decode({});
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(result->empty());
+}
+
+TEST(HpackHuffmanTest, PaddingNotOnes_Fails) {
+    // '0' is 00000; the 3 padding bits must be ones.
+    EXPECT_FALSE(Http::Hpack::huffman_decode(from_hex("00")).has_value());
+    EXPECT_TRUE(Http::Hpack::huffman_decode(from_hex("07")).has_value());
+}
+
+TEST(HpackHuffmanTest, PaddingOfWholeByte_Fails) {
+    // "0" followed by a full byte of ones: more than 7 bits of padding.
+    EXPECT_FALSE(Http::Hpack::huffman_decode(from_hex("07ff")).has_value());
+}
+
+TEST(HpackHuffmanTest, Eos_Fails) {
+    EXPECT_FALSE(Http::Hpack::huffman_decode(from_hex("ffffffff")).has_value());
+}
+
+// =============================================================================
+//  Encoding
+// =============================================================================
+
+TEST(HpackEncoderTest, StaticFieldIsIndexed) {
+    std::vector<std::uint8_t> out;
+    Http::Hpack::encode(out, ":method", "POST");
+    Http::Hpack::encode(out, ":scheme", "https");
+    EXPECT_EQ(out, (std::vector<std::uint8_t>{0x83, 0x87}));
+}
+
+TEST(HpackEncoderTest, StaticNameIsReferenced) {
+    std::vector<std::uint8_t> out;
+    Http::Hpack::encode(out, ":path", "/dns-query");
+    // Literal without indexing, name index 4, 10-byte raw value.
+    ASSERT_GE(out.size(), 2U);
+    EXPECT_EQ(out[0], 0x04);
+    EXPECT_EQ(out[1], 10);
+    EXPECT_EQ(out.size(), 12U);
+}
+
+TEST(HpackEncoderTest, RoundTripsThroughDecoder) {
+    const std::vector<Header> headers{
+        {":method", "POST"},
+        {":scheme", "https"},
+        {":authority", "dns.example:8443"},
+        {":path", "/dns-query"},
+        {"content-type", "application/dns-message"},
+        {"x-custom", std::string(300, 'v')},  // multi-byte length
+    };
+    std::vector<std::uint8_t> out;
+    for (const auto &[name, value]: headers) {
+        Http::Hpack::encode(out, name, value);
+    }
+
+    Decoder decoder;
+    auto decoded = decoder.decode(out);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(*decoded, headers);
+    // The encoder never adds to the peer's table.
+    EXPECT_EQ(decoder.table_entries(), 0U);
+}
+
+} // anonymous namespace
@@ -0,0 +1,489 @@
+//
+// Unit tests for src/http/http2.cpp — HTTP/2 client session (RFC 9113).
+//
+// Drives Http::H2::Session over a scripted Transport::Stream: the frames
+// the server would send are queued as reads, and what the session writes
+// is parsed back into frames for inspection.
+// =============================================================================
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "http/hpack.h"
+#include "http/http2.h"
+#include "http_type.h"
+#include "network/transport/stream.h"
+
+namespace {
+
+constexpr std::uint8_t DATA = 0x0;
+constexpr std::uint8_t HEADERS = 0x1;
+constexpr std::uint8_t RST_STREAM = 0x3;
+constexpr std::uint8_t SETTINGS = 0x4;
+constexpr std::uint8_t PUSH_PROMISE = 0x5;
+constexpr std::uint8_t PING = 0x6;
+constexpr std::uint8_t GOAWAY = 0x7;
+constexpr std::uint8_t CONTINUATION = 0x9;
+
+constexpr std::uint8_t END_STREAM = 0x1;
+constexpr std::uint8_t ACK = 0x1;
+constexpr std::uint8_t END_HEADERS = 0x4;
+constexpr std::uint8_t PADDED = 0x8;
+
+constexpr std::string_view PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+
+/// ":status: 200", indexed.
+const std::vector<std::uint8_t> STATUS_200{0x88};
+
+/// A stream whose reads are scripted, recording what is sent.
+class ScriptedStream : public Transport::Stream {
+public:
+    /// Queue @p bytes to be returned by one read_some().
+    void feed(std::vector<std::uint8_t> bytes) { reads_.push_back(std::move(bytes)); }
+
+    std::expected<size_t, Transport::IoError> read_some(std::span<std::uint8_t> buf,
+                                                        const Utils::CancellationToken &) override {
+        if (reads_.empty()) {
+            return size_t{0};  // EOF
+        }
+        auto &front = reads_.front();
+        const auto n = std::min(buf.size(), front.size());
+        std::copy_n(front.begin(), n, buf.begin());
+        front.erase(front.begin(), front.begin() + static_cast<std::ptrdiff_t>(n));
+        if (front.empty()) {
+            reads_.pop_front();
+        }
+        return n;
+    }
+
+    std::expected<void, Transport::IoError> read_exact(std::span<std::uint8_t>,
+                                                       const Utils::CancellationToken &) override {
+        return std::unexpected(Transport::IoError::CONNECTION_FAILED);
+    }
+
+    std::expected<void, Transport::IoError> send_all(std::span<const std::uint8_t> data,
+                                                     const Utils::CancellationToken &) override {
+        sent.insert(sent.end(), data.begin(), data.end());
+        return {};
+    }
+
+    std::vector<std::uint8_t> sent;
+
+private:
+    std::deque<std::vector<std::uint8_t>> reads_;
+};
+
+struct Frame {
+    std::uint8_t type;
+    std::uint8_t flags;
+    std::uint32_t stream_id;
+    std::vector<std::uint8_t> payload;
+};
+
+[[nodiscard]] std::vector<std::uint8_t> frame(std::uint8_t type, std::uint8_t flags, std::uint32_t stream_id,
+                                              const std::vector<std::uint8_t> &payload = {}) {
+    std::vector<std::uint8_t> out{
+        static_cast<std::uint8_t>(payload.size() >> 16), static_cast<std::uint8_t>(payload.size() >> 8),
+        static_cast<std::uint8_t>(payload.size()), type, flags,
+        static_cast<std::uint8_t>(stream_id >> 24), static_cast<std::uint8_t>(stream_id >> 16),
+        static_cast<std::uint8_t>(stream_id >> 8), static_cast<std::uint8_t>(stream_id),
+    };
+    out.insert(out.end(), payload.begin(), payload.end());
+    return out;
+}
+
+[[nodiscard]] std::vector<std::uint8_t> concat(std::initializer_list<std::vector<std::uint8_t>> parts) {
+    std::vector<std::uint8_t> out;
+    for (const auto &part: parts) {
+        out.insert(out.end(), part.begin(), part.end());
+    }
+    return out;
+}
+
+[[nodiscard]] std::vector<std::uint8_t> bytes(std::string_view text) {
+    return {text.begin(), text.end()};
+}
+
+[[nodiscard]] std::vector<std::uint8_t> u32(std::uint32_t value) {
+    return {static_cast<std::uint8_t>(value >> 24), static_cast<std::uint8_t>(value >> 16),
+            static_cast<std::uint8_t>(value >> 8), static_cast<std::uint8_t>(value)};
+}
+
+/// Split what the session sent into frames, after the preface.
+[[nodiscard]] std::vector<Frame> sent_frames(const ScriptedStream &stream) {
+    std::vector<Frame> frames;
+    std::size_t offset = stream.sent.size() >= PREFACE.size() &&
+                         std::equal(PREFACE.begin(), PREFACE.end(), stream.sent.begin())
+                             ? PREFACE.size()
+                             : 0;
+    while (offset + 9 <= stream.sent.size()) {
+        const auto *h = stream.sent.data() + offset;
+        const std::size_t length = (std::size_t{h[0]} << 16) | (std::size_t{h[1]} << 8) | h[2];
+        const std::uint32_t id = (std::uint32_t{h[5]} << 24) | (std::uint32_t{h[6]} << 16) |
+                                 (std::uint32_t{h[7]} << 8) | h[8];
+        frames.push_back({h[3], h[4], id, {h + 9, h + 9 + length}});
+        offset += 9 + length;
+    }
+    return frames;
+}
+
+[[nodiscard]] HttpRequest dns_request(std::string body = "query") {
+    HttpRequest req;
+    req.method = HttpMethod::POST;
+    req.content_type = "application/dns-message";
+    req.headers.emplace("Accept", "application/dns-message");
+    req.headers.emplace("Connection", "keep-alive");
+    req.body = std::move(body);
+    return req;
+}
+
+/// Collects the streams a session ends.
+struct Collected {
+    std::map<std::uint32_t, Http::H2::Result> results;
+    std::vector<std::uint32_t> order;
+
+    [[nodiscard]] Http::H2::StreamSink sink() {
+        return [this](std::uint32_t id, Http::H2::Result result) {
+            order.push_back(id);
+            results.emplace(id, std::move(result));
+        };
+    }
+};
+
+class Http2SessionTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        ASSERT_TRUE(session.start().has_value());
+        stream.sent.clear();
+    }
+
+    std::uint32_t submit(std::string body = "query") {
+        auto id = session.submit("/dns-query", dns_request(std::move(body)), "dns.example", "test-agent");
+        EXPECT_TRUE(id.has_value());
+        return id.value_or(0);
+    }
+
+    ScriptedStream stream;
+    Http::H2::Session session{stream};
+    Collected collected;
+};
+
+// =============================================================================
+//  Connection setup and requests
+// =============================================================================
+
+TEST(Http2SessionStartTest, SendsPrefaceAndSettings) {
+    ScriptedStream stream;
+    Http::H2::Session session(stream);
+    ASSERT_TRUE(session.start().has_value());
+
+    ASSERT_GE(stream.sent.size(), PREFACE.size());
+    EXPECT_TRUE(std::equal(PREFACE.begin(), PREFACE.end(), stream.sent.begin()));
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, SETTINGS);
+    EXPECT_EQ(frames[0].stream_id, 0U);
+    // SETTINGS_ENABLE_PUSH = 0, SETTINGS_MAX_HEADER_LIST_SIZE = 16384.
+    EXPECT_EQ(frames[0].payload, (std::vector<std::uint8_t>{0, 2, 0, 0, 0, 0, 0, 6, 0, 0, 0x40, 0}));
+}
+
+TEST_F(Http2SessionTest, Submit_SendsHeadersThenData) {
+    EXPECT_EQ(submit("body"), 1U);
+    EXPECT_EQ(submit(), 3U);
+    EXPECT_EQ(session.open_streams(), 2U);
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 4U);
+    EXPECT_EQ(frames[0].type, HEADERS);
+    EXPECT_EQ(frames[0].flags, END_HEADERS);
+    EXPECT_EQ(frames[0].stream_id, 1U);
+    EXPECT_EQ(frames[1].type, DATA);
+    EXPECT_EQ(frames[1].flags, END_STREAM);
+    EXPECT_EQ(frames[1].payload, bytes("body"));
+    EXPECT_EQ(frames[2].stream_id, 3U);
+
+    Http::Hpack::Decoder decoder;
+    auto headers = decoder.decode(frames[0].payload);
+    ASSERT_TRUE(headers.has_value());
+    const std::vector<Http::Hpack::Header> expected{
+        {":method", "POST"},
+        {":scheme", "https"},
+        {":authority", "dns.example"},
+        {":path", "/dns-query"},
+        {"content-type", "application/dns-message"},
+        {"content-length", "4"},
+        {"user-agent", "test-agent"},
+        {"accept", "application/dns-message"},
+    };
+    // "Connection" is dropped (RFC 9113 §8.2.2).
+    EXPECT_EQ(*headers, expected);
+}
+
+TEST_F(Http2SessionTest, Submit_BodyBeyondFrameSize_Fails) {
+    auto id = session.submit("/dns-query", dns_request(std::string(20000, 'x')), "dns.example", "test-agent");
+    ASSERT_FALSE(id.has_value());
+    EXPECT_EQ(id.error(), Http::Error::BODY_TOO_LARGE);
+    EXPECT_TRUE(session.usable());
+}
+
+// =============================================================================
+//  Responses
+// =============================================================================
+
+TEST_F(Http2SessionTest, Responses_DeliveredAsStreamsEnd) {
+    const auto first = submit();
+    const auto second = submit();
+
+    // The second request is answered first.
+    stream.feed(concat({
+        frame(HEADERS, END_HEADERS, second, STATUS_200),
+        frame(HEADERS, END_HEADERS, first, STATUS_200),
+        frame(DATA, END_STREAM, second, bytes("two")),
+        frame(DATA, END_STREAM, first, bytes("one")),
+    }));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    EXPECT_EQ(collected.order, (std::vector<std::uint32_t>{second, first}));
+    ASSERT_TRUE(collected.results.at(first).has_value());
+    EXPECT_EQ(collected.results.at(first)->status_code, 200);
+    EXPECT_EQ(collected.results.at(first)->body, bytes("one"));
+    EXPECT_EQ(collected.results.at(second)->body, bytes("two"));
+    EXPECT_EQ(session.open_streams(), 0U);
+}
+
+TEST_F(Http2SessionTest, FrameSplitAcrossReads_IsReassembled) {
+    const auto id = submit();
+    const auto wire = concat({frame(HEADERS, END_HEADERS, id, STATUS_200), frame(DATA, END_STREAM, id, bytes("ok"))});
+    stream.feed({wire.begin(), wire.begin() + 5});
+    stream.feed({wire.begin() + 5, wire.end() - 1});
+    stream.feed({wire.end() - 1, wire.end()});
+
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+    EXPECT_TRUE(collected.results.empty());
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+    ASSERT_EQ(collected.results.size(), 1U);
+    EXPECT_EQ(collected.results.at(id)->body, bytes("ok"));
+}
+
+TEST_F(Http2SessionTest, ContinuationAndPadding_AreHandled) {
+    const auto id = submit();
+    // ":status: 404" (literal, name index 8), split across two frames.
+    stream.feed(concat({
+        frame(HEADERS, PADDED, id, {2, 0x08, 0x03, '4', 0, 0}),
+        frame(CONTINUATION, END_HEADERS, id, {'0', '4'}),
+        frame(DATA, PADDED, id, {3, 'a', 'b', 0, 0, 0}),
+        frame(DATA, END_STREAM, id, bytes("c")),
+    }));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    ASSERT_TRUE(collected.results.at(id).has_value());
+    EXPECT_EQ(collected.results.at(id)->status_code, 404);
+    EXPECT_EQ(collected.results.at(id)->body, bytes("abc"));
+}
+
+TEST_F(Http2SessionTest, InformationalResponse_IsSkipped) {
+    const auto id = submit();
+    // ":status: 103", then the final response with no body.
+    stream.feed(concat({
+        frame(HEADERS, END_HEADERS, id, {0x08, 0x03, '1', '0', '3'}),
+        frame(HEADERS, END_HEADERS | END_STREAM, id, STATUS_200),
+    }));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    ASSERT_TRUE(collected.results.at(id).has_value());
+    EXPECT_EQ(collected.results.at(id)->status_code, 200);
+    EXPECT_TRUE(collected.results.at(id)->body.empty());
+}
+
+TEST_F(Http2SessionTest, MissingStatus_ResetsStream) {
+    const auto id = submit();
+    stream.sent.clear();
+    // "content-type: ..." first: no ":status".
+    stream.feed(frame(HEADERS, END_HEADERS | END_STREAM, id, {0x0f, 0x10, 0x01, 'x'}));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    ASSERT_FALSE(collected.results.at(id).has_value());
+    EXPECT_EQ(collected.results.at(id).error(), Http::Error::PROTOCOL_ERROR);
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, RST_STREAM);
+    EXPECT_TRUE(session.usable());
+}
+
+// =============================================================================
+//  Stream and connection control
+// =============================================================================
+
+TEST_F(Http2SessionTest, RstStream_EndsStreamWithReset) {
+    const auto id = submit();
+    stream.feed(frame(RST_STREAM, 0, id, u32(0x2)));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    ASSERT_FALSE(collected.results.at(id).has_value());
+    EXPECT_EQ(collected.results.at(id).error(), Http::Error::STREAM_RESET);
+    EXPECT_TRUE(session.can_open());
+}
+
+TEST_F(Http2SessionTest, Reset_SendsCancelAndDiscardsResponse) {
+    const auto abandoned = submit();
+    const auto kept = submit();
+    stream.sent.clear();
+    session.reset(abandoned);
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, RST_STREAM);
+    EXPECT_EQ(frames[0].stream_id, abandoned);
+    EXPECT_EQ(frames[0].payload, u32(0x8));  // CANCEL
+
+    // The discarded response adds "content-type: a" to the HPACK table;
+    // the kept one refers to it by index 62.
+    stream.feed(concat({
+        frame(HEADERS, END_HEADERS | END_STREAM, abandoned, {0x88, 0x5f, 0x01, 'a'}),
+        frame(HEADERS, END_HEADERS | END_STREAM, kept, {0x88, 0xbe}),
+    }));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+    EXPECT_EQ(collected.order, (std::vector<std::uint32_t>{kept}));
+    EXPECT_TRUE(collected.results.at(kept).has_value());
+}
+
+TEST_F(Http2SessionTest, Settings_AreAppliedAndAcked) {
+    // SETTINGS_MAX_CONCURRENT_STREAMS = 1.
+    stream.feed(frame(SETTINGS, 0, 0, {0, 3, 0, 0, 0, 1}));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, SETTINGS);
+    EXPECT_EQ(frames[0].flags, ACK);
+    EXPECT_TRUE(frames[0].payload.empty());
+
+    EXPECT_TRUE(session.can_open());
+    submit();
+    EXPECT_FALSE(session.can_open());
+    EXPECT_TRUE(session.usable());
+}
+
+TEST_F(Http2SessionTest, Ping_IsAcked) {
+    const std::vector<std::uint8_t> opaque{1, 2, 3, 4, 5, 6, 7, 8};
+    stream.feed(frame(PING, 0, 0, opaque));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, PING);
+    EXPECT_EQ(frames[0].flags, ACK);
+    EXPECT_EQ(frames[0].payload, opaque);
+}
+
+TEST_F(Http2SessionTest, Goaway_RefusesLaterStreams) {
+    const auto first = submit();
+    const auto second = submit();
+    // Last stream processed: the first.
+    stream.feed(frame(GOAWAY, 0, 0, concat({u32(first), u32(0)})));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+
+    EXPECT_EQ(collected.order, (std::vector<std::uint32_t>{second}));
+    EXPECT_EQ(collected.results.at(second).error(), Http::Error::STREAM_RESET);
+    EXPECT_FALSE(session.usable());
+    EXPECT_FALSE(session.failed());
+
+    // The first is still answered.
+    stream.feed(frame(HEADERS, END_HEADERS | END_STREAM, first, STATUS_200));
+    ASSERT_TRUE(session.receive(collected.sink()).has_value());
+    EXPECT_TRUE(collected.results.at(first).has_value());
+}
+
+// =============================================================================
+//  Connection errors
+// =============================================================================
+
+TEST_F(Http2SessionTest, PushPromise_FailsConnection) {
+    submit();
+    stream.sent.clear();
+    stream.feed(frame(PUSH_PROMISE, END_HEADERS, 1, concat({u32(2), STATUS_200})));
+
+    auto status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::PROTOCOL_ERROR);
+    EXPECT_TRUE(session.failed());
+    EXPECT_FALSE(session.usable());
+    EXPECT_TRUE(collected.results.empty());
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, GOAWAY);
+}
+
+TEST_F(Http2SessionTest, InterruptedHeaderBlock_FailsConnection) {
+    const auto id = submit();
+    stream.feed(concat({frame(HEADERS, 0, id, STATUS_200), frame(DATA, 0, id, bytes("x"))}));
+
+    auto status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::PROTOCOL_ERROR);
+}
+
+TEST_F(Http2SessionTest, OversizedHeaderBlock_FailsConnection) {
+    const auto id = submit();
+    stream.sent.clear();
+    // Each CONTINUATION is within the frame size; together they are not.
+    const std::vector<std::uint8_t> filler(16000, 0x88);
+    stream.feed(concat({
+        frame(HEADERS, 0, id, STATUS_200),
+        frame(CONTINUATION, 0, id, filler),
+        frame(CONTINUATION, END_HEADERS, id, filler),
+    }));
+
+    // One read_some() takes 16 KiB: the block overflows on the second.
+    auto status = session.receive(collected.sink());
+    ASSERT_TRUE(status.has_value());
+    status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::HEADERS_TOO_LARGE);
+    EXPECT_TRUE(session.failed());
+    EXPECT_TRUE(collected.results.empty());
+
+    auto frames = sent_frames(stream);
+    ASSERT_EQ(frames.size(), 1U);
+    EXPECT_EQ(frames[0].type, GOAWAY);
+}
+
+TEST_F(Http2SessionTest, BadHpack_FailsConnection) {
+    const auto id = submit();
+    stream.feed(frame(HEADERS, END_HEADERS, id, {0x80}));  // index 0
+
+    auto status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::COMPRESSION_FAILED);
+    EXPECT_TRUE(session.failed());
+}
+
+TEST_F(Http2SessionTest, DataOnUnopenedStream_FailsConnection) {
+    stream.feed(frame(DATA, END_STREAM, 5, bytes("x")));
+
+    auto status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::PROTOCOL_ERROR);
+}
+
+TEST_F(Http2SessionTest, Eof_FailsConnection) {
+    submit();
+    auto status = session.receive(collected.sink());
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error(), Http::Error::CONNECTION_FAILED);
+    EXPECT_TRUE(session.failed());
+    EXPECT_FALSE(session.can_open());
+
+    auto id = session.submit("/dns-query", dns_request(), "dns.example", "test-agent");
+    ASSERT_FALSE(id.has_value());
+    EXPECT_EQ(id.error(), Http::Error::CONNECTION_FAILED);
+}
+
+} // anonymous namespace
@@ -0,0 +1,171 @@
+//
+// Unit tests for ip_source/registry.h — IpSourceRegistry.
+//
+// Verifies:
+//   - One source instance per distinct key, shared across subdomains.
+//   - Results are shared within the TTL and refreshed after it.
+//   - Concurrent misses on one key run a single resolve() (single-flight).
+//   - Failures reach every caller and are not cached.
+//   - Interface sources bypass the result cache.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "config/config.h"
+#include "ip_source/base.h"
+#include "ip_source/registry.h"
+#include "network/inet_address.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Counters {
+    std::atomic<int> created{0};
+    std::atomic<int> resolved{0};
+    std::atomic<bool> fail{false};
+    std::chrono::milliseconds delay{0};
+};
+
+class CountingIpSource : public IpSourceBase {
+public:
+    explicit CountingIpSource(Counters &counters) : counters_(counters) {}
+
+    std::vector<InetAddress> resolve() const override {
+        ++counters_.resolved;
+        std::this_thread::sleep_for(counters_.delay);
+        if (counters_.fail) {
+            throw std::runtime_error("echo service unavailable");
+        }
+        return {Inet4Address::from_bytes({198, 51, 100, 1})};
+    }
+
+private:
+    Counters &counters_;
+};
+
+[[nodiscard]] IpSourceRegistry::Factory counting_factory(Counters &counters) {
+    return [&counters](const Config::SubdomainConfig &) {
+        ++counters.created;
+        return std::make_unique<CountingIpSource>(counters);
+    };
+}
+
+[[nodiscard]] Config::SubdomainConfig http_subdomain(std::string name, std::string url = "https://api.ipify.org") {
+    return Config::SubdomainConfig{
+        .name = std::move(name),
+        .type = RecordKind::A,
+        .ip_source = Config::IpSource::HTTP,
+        .ip_source_param = std::move(url),
+    };
+}
+
+} // namespace
+
+// ── Source sharing ───────────────────────────────────────────────────────────
+
+TEST(IpSourceRegistryTest, SameSettingsShareOneSourceAndResult) {
+    Counters counters;
+    const IpSourceRegistry registry(counting_factory(counters), 1h);
+
+    for (int i = 0; i < 200; ++i) {
+        const auto addresses = registry.resolve(http_subdomain("host" + std::to_string(i)));
+        ASSERT_EQ(addresses.size(), 1U);
+    }
+
+    EXPECT_EQ(counters.created, 1);
+    EXPECT_EQ(counters.resolved, 1);
+    EXPECT_EQ(registry.source_count(), 1U);
+}
+
+TEST(IpSourceRegistryTest, DifferentSettingsGetSeparateSources) {
+    Counters counters;
+    const IpSourceRegistry registry(counting_factory(counters), 1h);
+
+    auto v6 = http_subdomain("www");
+    v6.type = RecordKind::AAAA;
+    auto bound = http_subdomain("www");
+    bound.interface = "eth0";
+
+    [[maybe_unused]] auto a = registry.resolve(http_subdomain("www"));
+    [[maybe_unused]] auto b = registry.resolve(http_subdomain("www", "https://ifconfig.co"));
+    [[maybe_unused]] auto c = registry.resolve(v6);
+    [[maybe_unused]] auto d = registry.resolve(bound);
+
+    EXPECT_EQ(registry.source_count(), 4U);
+    EXPECT_EQ(counters.resolved, 4);
+}
+
+// ── TTL ──────────────────────────────────────────────────────────────────────
+
+TEST(IpSourceRegistryTest, ResultRefreshedAfterTtlButSourceKept) {
+    Counters counters;
+    const IpSourceRegistry registry(counting_factory(counters), 20ms);
+
+    [[maybe_unused]] auto first = registry.resolve(http_subdomain("www"));
+    std::this_thread::sleep_for(40ms);
+    [[maybe_unused]] auto second = registry.resolve(http_subdomain("www"));
+
+    EXPECT_EQ(counters.resolved, 2);
+    EXPECT_EQ(counters.created, 1);
+}
+
+// ── Single-flight ────────────────────────────────────────────────────────────
+
+TEST(IpSourceRegistryTest, ConcurrentMissesResolveOnce) {
+    Counters counters;
+    counters.delay = 50ms;
+    const IpSourceRegistry registry(counting_factory(counters), 1h);
+
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < 16; ++i) {
+        threads.emplace_back([&registry, i] {
+            EXPECT_EQ(registry.resolve(http_subdomain("host" + std::to_string(i))).size(), 1U);
+        });
+    }
+    threads.clear();
+
+    EXPECT_EQ(counters.resolved, 1);
+}
+
+// ── Failures ─────────────────────────────────────────────────────────────────
+
+TEST(IpSourceRegistryTest, FailureIsPropagatedAndNotCached) {
+    Counters counters;
+    counters.fail = true;
+    const IpSourceRegistry registry(counting_factory(counters), 1h);
+
+    EXPECT_THROW([[maybe_unused]] auto _ = registry.resolve(http_subdomain("www")), std::runtime_error);
+
+    counters.fail = false;
+    EXPECT_EQ(registry.resolve(http_subdomain("www")).size(), 1U);
+    EXPECT_EQ(counters.resolved, 2);
+    EXPECT_EQ(counters.created, 1);
+}
+
+// ── Interface sources ────────────────────────────────────────────────────────
+
+TEST(IpSourceRegistryTest, InterfaceSourceBypassesResultCache) {
+    Counters counters;
+    const IpSourceRegistry registry(counting_factory(counters), 1h);
+
+    const Config::SubdomainConfig iface{
+        .name = "www",
+        .type = RecordKind::A,
+        .interface = "eth0",
+        .ip_source = Config::IpSource::INTERFACE,
+    };
+
+    [[maybe_unused]] auto first = registry.resolve(iface);
+    [[maybe_unused]] auto second = registry.resolve(iface);
+
+    EXPECT_EQ(counters.resolved, 2);
+    EXPECT_EQ(counters.created, 1);
+}
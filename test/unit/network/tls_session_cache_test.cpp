@@ -0,0 +1,132 @@
+//
+// Unit tests for src/network/tls_session_cache.cpp — the process-wide TLS
+// session cache: per-destination keys, single-use TLS 1.3 tickets, expiry
+// and eviction.  Sessions are built by hand; no handshake is involved.
+// =============================================================================
+
+#include <array>
+#include <ctime>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <openssl/ssl.h>
+
+#include "network/tls_session_cache.h"
+
+namespace {
+
+/// A session that looks resumable: it has an ID and a fresh lifetime.
+[[nodiscard]] SslSessionPtr make_session(int version, long timeout = 300) {
+    SslSessionPtr session(SSL_SESSION_new());
+    static constexpr std::array<unsigned char, 4> id{1, 2, 3, 4};
+    SSL_SESSION_set1_id(session.get(), id.data(), static_cast<unsigned>(id.size()));
+    SSL_SESSION_set_protocol_version(session.get(), version);
+    SSL_SESSION_set_time(session.get(), static_cast<long>(std::time(nullptr)));
+    SSL_SESSION_set_timeout(session.get(), timeout);
+    return session;
+}
+
+class TlsSessionCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override { cache.clear(); }
+
+    void TearDown() override { cache.clear(); }
+
+    TlsSessionCache &cache = TlsSessionCache::instance();
+};
+
+TEST_F(TlsSessionCacheTest, MakeKey_DistinguishesEveryPart) {
+    static constexpr std::array<unsigned char, 3> h2{2, 'h', '2'};
+    static constexpr std::array<unsigned char, 4> dot{3, 'd', 'o', 't'};
+
+    const auto key = TlsSessionCache::make_key("1.1.1.1", 853, "one.one.one.one", dot);
+    EXPECT_EQ(key, TlsSessionCache::make_key("1.1.1.1", 853, "one.one.one.one", dot));
+    EXPECT_NE(key, TlsSessionCache::make_key("1.0.0.1", 853, "one.one.one.one", dot));
+    EXPECT_NE(key, TlsSessionCache::make_key("1.1.1.1", 443, "one.one.one.one", dot));
+    EXPECT_NE(key, TlsSessionCache::make_key("1.1.1.1", 853, "cloudflare-dns.com", dot));
+    EXPECT_NE(key, TlsSessionCache::make_key("1.1.1.1", 853, "one.one.one.one", h2));
+    EXPECT_NE(key, TlsSessionCache::make_key("1.1.1.1", 853, "one.one.one.one", {}));
+}
+
+TEST_F(TlsSessionCacheTest, Take_Missing_ReturnsNull) {
+    EXPECT_EQ(cache.take("nowhere:853||"), nullptr);
+}
+
+TEST_F(TlsSessionCacheTest, Tls12Session_IsOfferedRepeatedly) {
+    auto session = make_session(TLS1_2_VERSION);
+    auto *raw = session.get();
+    cache.put("k", std::move(session));
+
+    auto first = cache.take("k");
+    auto second = cache.take("k");
+    EXPECT_EQ(first.get(), raw);
+    EXPECT_EQ(second.get(), raw);
+    EXPECT_EQ(cache.size(), 1U);
+}
+
+TEST_F(TlsSessionCacheTest, Tls13Ticket_IsOfferedOnce) {
+    auto session = make_session(TLS1_3_VERSION);
+    auto *raw = session.get();
+    cache.put("k", std::move(session));
+
+    EXPECT_EQ(cache.take("k").get(), raw);
+    EXPECT_EQ(cache.take("k"), nullptr);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST_F(TlsSessionCacheTest, Put_ReplacesSessionForKey) {
+    cache.put("k", make_session(TLS1_2_VERSION));
+    auto newer = make_session(TLS1_2_VERSION);
+    auto *raw = newer.get();
+    cache.put("k", std::move(newer));
+
+    EXPECT_EQ(cache.size(), 1U);
+    EXPECT_EQ(cache.take("k").get(), raw);
+}
+
+TEST_F(TlsSessionCacheTest, ExpiredSession_IsDropped) {
+    auto session = make_session(TLS1_2_VERSION, 10);
+    SSL_SESSION_set_time(session.get(), static_cast<long>(std::time(nullptr)) - 60);
+    cache.put("k", std::move(session));
+
+    EXPECT_EQ(cache.take("k"), nullptr);
+    EXPECT_EQ(cache.size(), 0U);
+}
+
+TEST_F(TlsSessionCacheTest, SessionWithoutId_IsNotOffered) {
+    SslSessionPtr session(SSL_SESSION_new());
+    SSL_SESSION_set_protocol_version(session.get(), TLS1_2_VERSION);
+    cache.put("k", std::move(session));
+
+    EXPECT_EQ(cache.take("k"), nullptr);
+}
+
+TEST_F(TlsSessionCacheTest, Remove_ForgetsSession) {
+    cache.put("k", make_session(TLS1_2_VERSION));
+    cache.remove("k");
+    EXPECT_EQ(cache.take("k"), nullptr);
+}
+
+TEST_F(TlsSessionCacheTest, OverCapacity_EvictsOldest) {
+    for (std::size_t i = 0; i <= TlsSessionCache::MAX_ENTRIES; ++i) {
+        cache.put("k" + std::to_string(i), make_session(TLS1_2_VERSION));
+    }
+
+    EXPECT_EQ(cache.size(), TlsSessionCache::MAX_ENTRIES);
+    EXPECT_EQ(cache.take("k0"), nullptr);
+    EXPECT_NE(cache.take("k1"), nullptr);
+    EXPECT_NE(cache.take("k" + std::to_string(TlsSessionCache::MAX_ENTRIES)), nullptr);
+}
+
+TEST_F(TlsSessionCacheTest, Record_CountsHitsAndMisses) {
+    const auto before = cache.stats();
+    cache.record(true);
+    cache.record(false);
+    cache.record(false);
+
+    const auto after = cache.stats();
+    EXPECT_EQ(after.hits - before.hits, 1U);
+    EXPECT_EQ(after.misses - before.misses, 2U);
+}
+
+} // anonymous namespace
@@ -0,0 +1,197 @@
+//
+// Unit tests for util/byte_scan.hpp — Utils::ByteScan.
+//
+// Verifies:
+//   - Every kernel version this CPU runs agrees with the scalar one, for
+//     inputs of every length across the 16- and 32-byte block boundaries.
+//   - Matches and mismatches in the last, partial block are found.
+//   - find_all() stops when its output is full.
+// =============================================================================
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/byte_scan.hpp"
+
+namespace {
+    /// One version of each kernel, by instruction set.
+    struct Kernels {
+        const char *name;
+        std::function<std::size_t(std::string_view, char, std::span<std::uint16_t>)> find_all;
+        std::function<bool(std::string_view)> is_ldh;
+        std::function<void(std::span<char>)> to_lower;
+        std::function<bool(std::string_view, std::string_view)> iequals;
+    };
+
+    /// The dispatched kernels and every version this CPU can run.
+    std::vector<Kernels> available_kernels() {
+        using namespace Utils::ByteScan;
+        std::vector<Kernels> kernels;
+        kernels.push_back({
+            "dispatched",
+            [](auto s, auto c, auto out) { return find_all(s, c, out); },
+            [](auto s) { return is_ldh(s); },
+            [](auto s) { to_lower(s); },
+            [](auto a, auto b) { return iequals(a, b); },
+        });
+#if YADDNSC_BYTE_SCAN_X86
+        kernels.push_back({
+            "sse2",
+            [](auto s, auto c, auto out) { return Sse2::find_all(s, c, out); },
+            [](auto s) { return Sse2::is_ldh(s); },
+            [](auto s) { Sse2::to_lower(s); },
+            [](auto a, auto b) { return Sse2::iequals(a, b); },
+        });
+        if (isa() == Isa::AVX2) {
+            kernels.push_back({
+                "avx2",
+                [](auto s, auto c, auto out) { return Avx2::find_all(s, c, out); },
+                [](auto s) { return Avx2::is_ldh(s); },
+                [](auto s) { Avx2::to_lower(s); },
+                [](auto a, auto b) { return Avx2::iequals(a, b); },
+            });
+        }
+#elif YADDNSC_BYTE_SCAN_NEON
+        kernels.push_back({
+            "neon",
+            [](auto s, auto c, auto out) { return Neon::find_all(s, c, out); },
+            [](auto s) { return Neon::is_ldh(s); },
+            [](auto s) { Neon::to_lower(s); },
+            [](auto a, auto b) { return Neon::iequals(a, b); },
+        });
+#endif
+        return kernels;
+    }
+
+    /// A string of @p size bytes drawn from a name-like alphabet, with the
+    /// odd byte that is not a letter, digit or hyphen.
+    std::string random_name_bytes(std::mt19937 &rng, std::size_t size) {
+        static constexpr std::string_view ALPHABET = "abcXYZ019-..-_ \x80\xff";
+        std::uniform_int_distribution<std::size_t> pick(0, ALPHABET.size() - 1);
+        std::string s(size, '\0');
+        for (auto &c: s) {
+            c = ALPHABET[pick(rng)];
+        }
+        return s;
+    }
+
+    std::vector<std::uint16_t> scalar_find_all(std::string_view s, char c) {
+        std::vector<std::uint16_t> out(s.size());
+        out.resize(Utils::ByteScan::Scalar::find_all(s, c, out));
+        return out;
+    }
+} // anonymous namespace
+
+TEST(ByteScanTest, FindAll_AgreesWithScalar) {
+    std::mt19937 rng(1);
+    for (const auto &k: available_kernels()) {
+        for (std::size_t size = 0; size <= 100; ++size) {
+            const auto s = random_name_bytes(rng, size);
+            std::vector<std::uint16_t> out(size);
+            out.resize(k.find_all(s, '.', out));
+            EXPECT_EQ(out, scalar_find_all(s, '.')) << k.name << " size " << size;
+        }
+    }
+}
+
+TEST(ByteScanTest, FindAll_StopsWhenOutputIsFull) {
+    const std::string dots(40, '.');
+    for (const auto &k: available_kernels()) {
+        std::array<std::uint16_t, 5> out{};
+        EXPECT_EQ(k.find_all(dots, '.', out), 5U) << k.name;
+        EXPECT_EQ(out, (std::array<std::uint16_t, 5>{0, 1, 2, 3, 4})) << k.name;
+    }
+}
+
+TEST(ByteScanTest, IsLdh_AgreesWithScalar) {
+    std::mt19937 rng(2);
+    for (const auto &k: available_kernels()) {
+        for (std::size_t size = 0; size <= 100; ++size) {
+            // Mostly valid, so that the result is not always false.
+            std::string s(size, 'a');
+            for (std::size_t i = 0; i < size; ++i) {
+                s[i] = "aZ9-"[i % 4];
+            }
+            EXPECT_TRUE(k.is_ldh(s)) << k.name << " size " << size;
+
+            // One invalid byte, anywhere.
+            for (std::size_t i = 0; i < size; ++i) {
+                auto bad = s;
+                bad[i] = "._ @[`{/:\x80"[rng() % 10];
+                EXPECT_FALSE(k.is_ldh(bad)) << k.name << " size " << size << " at " << i;
+            }
+        }
+    }
+}
+
+TEST(ByteScanTest, IsLdh_EveryByteValue) {
+    for (const auto &k: available_kernels()) {
+        for (int b = 0; b < 256; ++b) {
+            const std::string s(33, static_cast<char>(b));
+            EXPECT_EQ(k.is_ldh(s), Utils::ByteScan::Scalar::is_ldh(static_cast<char>(b))) << k.name << " byte " << b;
+        }
+    }
+}
+
+TEST(ByteScanTest, ToLower_AgreesWithScalar) {
+    std::mt19937 rng(3);
+    for (const auto &k: available_kernels()) {
+        for (std::size_t size = 0; size <= 100; ++size) {
+            auto s = random_name_bytes(rng, size);
+            auto expected = s;
+            Utils::ByteScan::Scalar::to_lower(expected);
+            k.to_lower(s);
+            EXPECT_EQ(s, expected) << k.name << " size " << size;
+        }
+    }
+}
+
+TEST(ByteScanTest, ToLower_OnlyAsciiLetters) {
+    for (const auto &k: available_kernels()) {
+        std::string s(256, '\0');
+        for (int b = 0; b < 256; ++b) {
+            s[b] = static_cast<char>(b);
+        }
+        k.to_lower(s);
+        for (int b = 0; b < 256; ++b) {
+            const auto expected = b >= 'A' && b <= 'Z' ? b + 32 : b;
+            EXPECT_EQ(static_cast<unsigned char>(s[b]), expected) << k.name << " byte " << b;
+        }
+    }
+}
+
+TEST(ByteScanTest, Iequals_AgreesWithScalar) {
+    std::mt19937 rng(4);
+    for (const auto &k: available_kernels()) {
+        for (std::size_t size = 0; size <= 100; ++size) {
+            const auto a = random_name_bytes(rng, size);
+            auto b = a;
+            for (auto &c: b) {
+                if (c >= 'a' && c <= 'z' && rng() % 2 == 0) {
+                    c = static_cast<char>(c - 32);
+                }
+            }
+            EXPECT_TRUE(k.iequals(a, b)) << k.name << " size " << size;
+
+            // A difference other than case, anywhere.
+            for (std::size_t i = 0; i < size; ++i) {
+                auto diff = b;
+                diff[i] = diff[i] == '.' ? '-' : '.';
+                EXPECT_FALSE(k.iequals(a, diff)) << k.name << " size " << size << " at " << i;
+            }
+        }
+    }
+}
+
+TEST(ByteScanTest, Iequals_LettersOnlyFoldAsciiCase) {
+    // '@' and '`' differ by 0x20 but are not letters.
+    EXPECT_FALSE(Utils::ByteScan::iequals(std::string(20, '@'), std::string(20, '`')));
+    EXPECT_FALSE(Utils::ByteScan::iequals("example.com", "example.co"));
+    EXPECT_TRUE(Utils::ByteScan::iequals("", ""));
+}
@@ -0,0 +1,107 @@
+//
+// Unit tests for util/small_vector.hpp — Utils::SmallVector.
+//
+// Verifies:
+//   - Elements stay inline up to the inline capacity.
+//   - Growing past it moves every element to the heap, in order.
+//   - Appending one of its own elements works across the spill.
+//   - Copies, moves and equality in both states.
+// =============================================================================
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/small_vector.hpp"
+
+TEST(SmallVectorTest, Default_Empty) {
+    const Utils::SmallVector<int, 4> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.size(), 0U);
+    EXPECT_EQ(v.begin(), v.end());
+    EXPECT_FALSE(v.spilled());
+}
+
+TEST(SmallVectorTest, UpToInlineCapacity_StaysInline) {
+    Utils::SmallVector<int, 4> v;
+    for (int i = 0; i < 4; ++i) {
+        v.push_back(i);
+    }
+
+    EXPECT_EQ(v.size(), 4U);
+    EXPECT_FALSE(v.spilled());
+    EXPECT_EQ(v.front(), 0);
+    EXPECT_EQ(v[3], 3);
+}
+
+TEST(SmallVectorTest, PastInlineCapacity_SpillsInOrder) {
+    Utils::SmallVector<std::string, 2> v{"a", "b"};
+    v.emplace_back(3, 'c');
+    v.push_back("d");
+
+    EXPECT_TRUE(v.spilled());
+    EXPECT_EQ(std::vector<std::string>(v.begin(), v.end()), (std::vector<std::string>{"a", "b", "ccc", "d"}));
+}
+
+TEST(SmallVectorTest, PushBackOwnElement_AcrossTheSpill) {
+    // The new element is copied before the inline ones are moved out.
+    Utils::SmallVector<std::string, 2> v{"first", "second"};
+    v.push_back(v[0]);
+    v.emplace_back(v[1]);
+    v.push_back(v[2]);
+
+    EXPECT_TRUE(v.spilled());
+    EXPECT_EQ(std::vector<std::string>(v.begin(), v.end()),
+              (std::vector<std::string>{"first", "second", "first", "second", "first"}));
+}
+
+TEST(SmallVectorTest, MoveOnlyElements) {
+    Utils::SmallVector<std::unique_ptr<int>, 1> v;
+    v.push_back(std::make_unique<int>(1));
+    v.push_back(std::make_unique<int>(2));
+
+    ASSERT_EQ(v.size(), 2U);
+    EXPECT_EQ(*v[0], 1);
+    EXPECT_EQ(*v[1], 2);
+}
+
+TEST(SmallVectorTest, Clear_ReturnsToInlineStorage) {
+    Utils::SmallVector<int, 2> v{1, 2, 3};
+    ASSERT_TRUE(v.spilled());
+
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_FALSE(v.spilled());
+
+    v.push_back(4);
+    EXPECT_EQ(v.size(), 1U);
+    EXPECT_EQ(v.front(), 4);
+    EXPECT_FALSE(v.spilled());
+}
+
+TEST(SmallVectorTest, CopyAndMove_KeepTheElements) {
+    const Utils::SmallVector<int, 2> inline_v{1, 2};
+    const Utils::SmallVector<int, 2> spilled_v{1, 2, 3};
+
+    auto inline_copy = inline_v;
+    auto spilled_copy = spilled_v;
+    EXPECT_EQ(inline_copy, inline_v);
+    EXPECT_EQ(spilled_copy, spilled_v);
+
+    const auto inline_moved = std::move(inline_copy);
+    const auto spilled_moved = std::move(spilled_copy);
+    EXPECT_EQ(inline_moved, inline_v);
+    EXPECT_EQ(spilled_moved, spilled_v);
+}
+
+TEST(SmallVectorTest, Equality_ComparesElementsNotStorage) {
+    Utils::SmallVector<int, 2> spilled{1, 2, 3};
+    spilled.clear();
+    spilled.push_back(1);
+
+    EXPECT_EQ(spilled, (Utils::SmallVector<int, 2>{1}));
+    EXPECT_NE(spilled, (Utils::SmallVector<int, 2>{2}));
+    EXPECT_NE(spilled, (Utils::SmallVector<int, 2>{1, 2}));
+}
@@ -0,0 +1,222 @@
+//
+// Created by Kotarou on 2026/7/27.
+//
+// Unit tests for util/task.hpp — Utils::Task and its combinators.
+//
+// Verifies:
+//   - Tasks are lazy, return values and propagate exceptions.
+//   - offload() runs inline without an executor, and on the executor's
+//     thread with one.
+//   - when_all() overlaps its children and joins their results/errors.
+//   - start_detached() runs a task to completion without a waiter.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/task.hpp"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// Runs every job on a new thread.
+class ThreadExecutor {
+public:
+    ~ThreadExecutor() { threads_.clear(); }
+
+    [[nodiscard]] Utils::Executor executor() {
+        return [this](std::function<void()> job) {
+            std::lock_guard lock(mutex_);
+            threads_.emplace_back(std::move(job));
+        };
+    }
+
+private:
+    std::mutex mutex_;
+    std::vector<std::jthread> threads_;
+};
+
+Utils::Task<int> answer() {
+    co_return 42;
+}
+
+Utils::Task<int> twice(Utils::Task<int> inner) {
+    co_return 2 * co_await std::move(inner);
+}
+
+Utils::Task<int> failing() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+} // namespace
+
+// ── Task ─────────────────────────────────────────────────────────────────────
+
+TEST(TaskTest, SyncWaitReturnsValue) {
+    EXPECT_EQ(Utils::sync_wait(answer()), 42);
+    EXPECT_EQ(Utils::sync_wait(twice(answer())), 84);
+}
+
+TEST(TaskTest, IsLazy) {
+    bool started = false;
+    auto task = [](bool &flag) -> Utils::Task<> {
+        flag = true;
+        co_return;
+    }(started);
+
+    EXPECT_FALSE(started);
+    Utils::sync_wait(std::move(task));
+    EXPECT_TRUE(started);
+}
+
+TEST(TaskTest, ExceptionPropagatesThroughCoAwait) {
+    EXPECT_THROW(Utils::sync_wait(twice(failing())), std::runtime_error);
+}
+
+TEST(TaskTest, UnstartedTaskIsDestroyed) {
+    auto owned = std::make_shared<int>(1);
+    {
+        auto task = [](std::shared_ptr<int> held) -> Utils::Task<int> { co_return *held; }(owned);
+        EXPECT_EQ(owned.use_count(), 2);
+    }
+    EXPECT_EQ(owned.use_count(), 1);
+}
+
+TEST(TaskTest, MoveOnlyResult) {
+    auto task = []() -> Utils::Task<std::unique_ptr<int> > { co_return std::make_unique<int>(7); }();
+    EXPECT_EQ(*Utils::sync_wait(std::move(task)), 7);
+}
+
+// ── offload ──────────────────────────────────────────────────────────────────
+
+TEST(TaskTest, OffloadWithoutExecutorRunsInline) {
+    const Utils::Executor inline_executor;
+    const auto caller = std::this_thread::get_id();
+    auto task = [](const Utils::Executor &executor) -> Utils::Task<std::thread::id> {
+        co_return co_await Utils::offload(executor, [] { return std::this_thread::get_id(); });
+    }(inline_executor);
+
+    EXPECT_EQ(Utils::sync_wait(std::move(task)), caller);
+}
+
+TEST(TaskTest, OffloadRunsOnExecutorAndResumesThere) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+    const auto caller = std::this_thread::get_id();
+    auto task = [](const Utils::Executor &exec) -> Utils::Task<std::pair<std::thread::id, std::thread::id> > {
+        const auto worker = co_await Utils::offload(exec, [] { return std::this_thread::get_id(); });
+        co_return std::pair{worker, std::this_thread::get_id()};
+    }(executor);
+
+    const auto [worker, resumed_on] = Utils::sync_wait(std::move(task));
+    EXPECT_NE(worker, caller);
+    EXPECT_EQ(resumed_on, worker);
+}
+
+TEST(TaskTest, OffloadRethrows) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+    auto task = [](const Utils::Executor &exec) -> Utils::Task<> {
+        co_await Utils::offload(exec, [] { throw std::runtime_error("stage failed"); });
+    }(executor);
+
+    EXPECT_THROW(Utils::sync_wait(std::move(task)), std::runtime_error);
+}
+
+// ── when_all ─────────────────────────────────────────────────────────────────
+
+TEST(TaskTest, WhenAllOverlapsChildren) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+
+    // Each child waits for the other to have started, so running them one
+    // after the other would never finish.
+    std::latch both_started(2);
+    const auto rendezvous = [&](int value) {
+        both_started.arrive_and_wait();
+        return value;
+    };
+    auto child = [](const Utils::Executor &exec, std::function<int()> fn) -> Utils::Task<int> {
+        co_return co_await Utils::offload(exec, std::move(fn));
+    };
+
+    auto joined = Utils::when_all(child(executor, [&] { return rendezvous(1); }),
+                                  child(executor, [&] { return rendezvous(2); }));
+    auto result = std::async(std::launch::async, [&] { return Utils::sync_wait(std::move(joined)); });
+
+    ASSERT_EQ(result.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(result.get(), (std::pair{1, 2}));
+}
+
+TEST(TaskTest, WhenAllWithoutSuspensionCompletesInline) {
+    auto [a, b] = Utils::sync_wait(Utils::when_all(answer(), twice(answer())));
+    EXPECT_EQ(a, 42);
+    EXPECT_EQ(b, 84);
+}
+
+TEST(TaskTest, WhenAllRethrowsAfterBothFinish) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+    std::atomic<bool> slow_done = false;
+    auto slow = [](const Utils::Executor &exec, std::atomic<bool> &done) -> Utils::Task<int> {
+        co_return co_await Utils::offload(exec, [&done] {
+            std::this_thread::sleep_for(20ms);
+            done = true;
+            return 1;
+        });
+    };
+
+    EXPECT_THROW(Utils::sync_wait(Utils::when_all(failing(), slow(executor, slow_done))), std::runtime_error);
+    EXPECT_TRUE(slow_done);
+}
+
+TEST(TaskTest, WhenAllVectorKeepsOrder) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+    auto delayed = [](const Utils::Executor &exec, int value) -> Utils::Task<int> {
+        co_return co_await Utils::offload(exec, [value] {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5 * (4 - value)));
+            return value;
+        });
+    };
+
+    std::vector<Utils::Task<int> > tasks;
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back(delayed(executor, i));
+    }
+    EXPECT_EQ(Utils::sync_wait(Utils::when_all(std::move(tasks))), (std::vector{0, 1, 2, 3}));
+}
+
+TEST(TaskTest, WhenAllEmptyVector) {
+    EXPECT_TRUE(Utils::sync_wait(Utils::when_all(std::vector<Utils::Task<int> >{})).empty());
+}
+
+// ── start_detached ───────────────────────────────────────────────────────────
+
+TEST(TaskTest, StartDetachedRunsToCompletion) {
+    ThreadExecutor threads;
+    const auto executor = threads.executor();
+    std::promise<int> finished;
+    Utils::start_detached([](Utils::Executor exec, std::promise<int> &done) -> Utils::Task<> {
+        const int value = co_await Utils::offload(exec, [] { return 5; });
+        done.set_value(value);
+    }(executor, finished));
+
+    auto result = finished.get_future();
+    ASSERT_EQ(result.wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(result.get(), 5);
+}
@@ -6,9 +6,10 @@
 // Verifies:
 //   - Valid domain names pass.
 //   - Invalid domain names (empty, no dots, too long) are rejected.
-//   - Edge cases: trailing dot, single-label, TLD-only.
+//   - Edge cases: trailing dot, single-label, TLD-only, TLD length, punycode.
 // =============================================================================
 
+#include <string>
 #include <string_view>
 
 #include <gtest/gtest.h>
@@ -153,3 +154,26 @@ TEST(DomainValidationTest, TwoTrailingDots_Rejected) {
     // Two trailing dots is not valid
     EXPECT_FALSE(Utils::is_valid_domain("example.com.."));
 }
+
+TEST(DomainValidationTest, TLDLabelTooLong_Rejected) {
+    // The TLD is a label too: at most 63 characters, punycode or not.
+    EXPECT_TRUE(Utils::is_valid_domain("example." + std::string(63, 'a')));
+    EXPECT_FALSE(Utils::is_valid_domain("example." + std::string(64, 'a')));
+    EXPECT_FALSE(Utils::is_valid_domain("example.xn--" + std::string(60, 'a')));
+}
+
+TEST(DomainValidationTest, PunycodeTLD_CaseInsensitive) {
+    EXPECT_TRUE(Utils::is_valid_domain("EXAMPLE.XN--FIQS8S"));
+    EXPECT_FALSE(Utils::is_valid_domain("example.xn--"));
+    EXPECT_FALSE(Utils::is_valid_domain("example.xn---a"));
+}
+
+TEST(DomainValidationTest, InvalidCharacterInLongLabel_Rejected) {
+    // Long enough for the label to be checked a whole block at a time.
+    std::string label(40, 'a');
+    EXPECT_TRUE(Utils::is_valid_domain(label + ".com"));
+    for (const char c: {'_', ' ', '@', '\x80'}) {
+        label[33] = c;
+        EXPECT_FALSE(Utils::is_valid_domain(label + ".com")) << c;
+    }
+}